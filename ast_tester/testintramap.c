@@ -0,0 +1,160 @@
+#include "ast.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NPOINT 10000
+#define NBATCH 100
+
+static int ncall;
+static int maxpoint;
+static int aliased;
+
+void quiet( int status_value, const char *message );
+
+/* Scale the input values by a factor read from the IntraFlag attribute
+   of the IntraMap. Points passed in a batch that is too large are set
+   bad. Used with AST__REENT, so it keeps no static state. */
+void scale( AstMapping *this, int npoint, int ncoord_in,
+            const double *ptr_in[], int forward, int ncoord_out,
+            double *ptr_out[] ) {
+   double fac;
+   int i;
+
+   fac = atof( astGetC( this, "IntraFlag" ) );
+   if( !forward ) fac = 1.0/fac;
+   for( i = 0; i < npoint; i++ ) {
+      ptr_out[ 0 ][ i ] = ( npoint > NBATCH ) ? AST__BAD :
+                                                fac*ptr_in[ 0 ][ i ];
+   }
+}
+
+/* Swap two axis values, recording the number of invocations, the
+   largest number of points passed in one invocation, and whether the
+   output arrays are the input arrays. */
+void swap( AstMapping *this, int npoint, int ncoord_in,
+           const double *ptr_in[], int forward, int ncoord_out,
+           double *ptr_out[] ) {
+   int i;
+
+   ncall++;
+   if( npoint > maxpoint ) maxpoint = npoint;
+   if( ptr_out[ 0 ] == ptr_in[ 0 ] ) aliased = 1;
+
+   for( i = 0; i < npoint; i++ ) {
+      ptr_out[ 0 ][ i ] = ptr_in[ 1 ][ i ];
+      ptr_out[ 1 ][ i ] = ptr_in[ 0 ][ i ];
+   }
+}
+
+int main(){
+   AstIntraMap *map;
+   double x[ NPOINT ];
+   double y[ NPOINT ];
+   double z[ NPOINT ];
+   int i;
+
+   astBegin;
+
+   for( i = 0; i < NPOINT; i++ ) {
+      x[ i ] = i;
+      y[ i ] = -i;
+   }
+
+/* Points are passed to the transformation function in batches. */
+   astIntraRegBatch( "swap", 2, 2, swap, 0, 1050, "Swap axes", "-", "-" );
+   map = astIntraMap( "swap", 2, 2, " " );
+   ncall = 0;
+   maxpoint = 0;
+   astTran2( map, 2500, x, y, 1, z, z + 2500 );
+   if( astOK && ( ncall != 3 || maxpoint != 1050 ) ) {
+      astError( AST__INTER, "Error 1: %d %d\n", ncall, maxpoint );
+   }
+   for( i = 0; i < 2500 && astOK; i++ ) {
+      if( z[ i ] != y[ i ] || z[ i + 2500 ] != x[ i ] ) {
+         astError( AST__INTER, "Error 2: %d\n", i );
+      }
+   }
+
+/* Without AST__INPLACE, the function is given a copy of the input
+   values if the output arrays are the input arrays. */
+   for( i = 0; i < 2500; i++ ) {
+      z[ i ] = i;
+      z[ i + 2500 ] = -i;
+   }
+   aliased = 0;
+   astTran2( map, 2500, z, z + 2500, 1, z, z + 2500 );
+   if( astOK && aliased ) astError( AST__INTER, "Error 3\n" );
+   for( i = 0; i < 2500 && astOK; i++ ) {
+      if( z[ i ] != -i || z[ i + 2500 ] != i ) {
+         astError( AST__INTER, "Error 4: %d\n", i );
+      }
+   }
+
+/* With AST__INPLACE, the function is given the output arrays as its
+   input arrays. */
+   astIntraReg( "swapip", 2, 2, swap, AST__INPLACE, "Swap axes", "-", "-" );
+   map = astIntraMap( "swapip", 2, 2, " " );
+   aliased = 0;
+   ncall = 0;
+   astTran2( map, 2500, z, z + 2500, 1, z, z + 2500 );
+   if( astOK && ( !aliased || ncall != 1 ) ) {
+      astError( AST__INTER, "Error 5: %d %d\n", aliased, ncall );
+   }
+
+/* A re-entrant function that uses batches may be invoked in parallel
+   if AST_NTHREAD is set. Each invocation should get an IntraMap with the
+   correct IntraFlag, and no more than NBATCH points. */
+   astIntraRegBatch( "scale", 1, 1, scale, AST__REENT, NBATCH, "Scale",
+                     "-", "-" );
+   map = astIntraMap( "scale", 1, 1, "IntraFlag=4.0" );
+   astTran1( map, NPOINT, x, 1, y );
+   for( i = 0; i < NPOINT && astOK; i++ ) {
+      if( y[ i ] != 4.0*x[ i ] ) {
+         astError( AST__INTER, "Error 6: %d %g\n", i, y[ i ] );
+      }
+   }
+
+   astTran1( map, NPOINT, y, 0, y );
+   for( i = 0; i < NPOINT && astOK; i++ ) {
+      if( y[ i ] != x[ i ] ) {
+         astError( AST__INTER, "Error 7: %d %g\n", i, y[ i ] );
+      }
+   }
+
+/* A negative batch size should be rejected. Suppress the expected error
+   messages. */
+   astSetPutErr( quiet );
+   if( astOK ) {
+      astIntraRegBatch( "neg", 1, 1, scale, 0, -1, "Scale", "-", "-" );
+      if( astStatus == AST__NPTIN ) {
+         astClearStatus;
+      } else if( astOK ) {
+         astError( AST__INTER, "Error 8\n" );
+      }
+   }
+
+/* Registering a function again with a different batch size should be
+   rejected. */
+   if( astOK ) {
+      astIntraRegBatch( "scale", 1, 1, scale, AST__REENT, 2*NBATCH,
+                        "Scale", "-", "-" );
+      if( astStatus == AST__MRITF ) {
+         astClearStatus;
+      } else if( astOK ) {
+         astError( AST__INTER, "Error 9\n" );
+      }
+   }
+   astSetPutErr( NULL );
+
+   astEnd;
+
+   if( astOK ) {
+      printf(" All IntraMap tests passed\n");
+   } else {
+      printf("IntraMap tests failed\n");
+   }
+}
+
+void quiet( int status_value, const char *message ) {
+}
@@ -5,7 +5,8 @@
       include 'SAE_PAR'
 
       integer lm, status, i
-      double precision lut1( 10 ), x( 7 ), y(7)
+      double precision lut1( 10 ), x( 7 ), y(7), lut2( 1000 ),
+     :                 x2( 999 ), y2( 999 )
 
       status = sai__ok
       call err_mark( status )
@@ -133,6 +134,36 @@
       end do
 
 
+*  Test the inverse transformation of a large non-uniform table. This
+*  uses a bucket index to find the bracketing table entries.
+      do i = 1, 1000
+         lut2( i ) = 0.001D0*( i - 1 )**2 + ( i - 1 )
+      end do
+      lm = ast_lutmap( 1000, lut2, 1.0D0, 1.0D0, ' ', status )
+
+      do i = 1, 999
+         x2( i ) = 0.5D0*( lut2( i ) + lut2( i + 1 ) )
+      end do
+
+      call ast_tran1( lm, 999, x2, .FALSE., y2, status )
+
+      do i = 1, 999
+         if( abs( y2( i ) - ( i + ( x2( i ) - lut2( i ) )/
+     :                        ( lut2( i + 1 ) - lut2( i ) ) ) )
+     :       .gt. 1.0D-9 ) then
+            call stopit( status, "Error 13" );
+         end if
+      end do
+
+      call ast_tran1( lm, 999, lut2, .FALSE., y2, status )
+
+      do i = 1, 999
+         if( abs( y2( i ) - i ) .gt. 1.0D-9 ) then
+            call stopit( status, "Error 14" );
+         end if
+      end do
+
+
 
 
 
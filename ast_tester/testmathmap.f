@@ -0,0 +1,160 @@
+      program testmathmap
+      implicit none
+
+      include 'AST_PAR'
+      include 'SAE_PAR'
+
+      integer status
+
+      status = sai__ok
+      call ast_begin( status )
+
+      call checkequal( status )
+      call checkrandom( status )
+
+      call ast_end( status )
+
+c      call ast_activememory( 'testmathmap' )
+      call ast_flushmemory( 1 )
+
+      if( status .eq. sai__ok ) then
+         write(*,*) 'All MathMap tests passed'
+      else
+         write(*,*) 'MathMap tests failed'
+      end if
+
+      end
+
+
+
+      subroutine checkequal( status )
+      implicit none
+
+      include 'AST_PAR'
+      include 'SAE_PAR'
+
+      integer status, mm1, mm2
+      character fwd(2)*40, inv(2)*40
+
+      if( status .ne. sai__ok ) return
+
+*  Expressions that are compiled into fused operations must compare all
+*  the constants (and variable indices) used by the fused operations.
+      mm1 = ast_mathmap( 1, 1, 1, 'y=x*2+3', 1, 'x=(y-3)/2', ' ',
+     :                   status )
+      mm2 = ast_mathmap( 1, 1, 1, 'y=x*5+7', 1, 'x=(y-3)/2', ' ',
+     :                   status )
+      if( ast_equal( mm1, mm2, status ) ) then
+         call stopit( status, 'Error 1' )
+      else if( .not. ast_equal( mm1, ast_copy( mm1, status ),
+     :                          status ) ) then
+         call stopit( status, 'Error 2' )
+      end if
+
+      mm1 = ast_mathmap( 1, 1, 1, 'y=sin(x*2)', 1, 'x', ' ', status )
+      mm2 = ast_mathmap( 1, 1, 1, 'y=sin(x*9)', 1, 'x', ' ', status )
+      if( ast_equal( mm1, mm2, status ) ) then
+         call stopit( status, 'Error 3' )
+      end if
+
+      fwd(1) = 'r=sqrt(x*x+y*y)'
+      fwd(2) = 'a=atan2(y,x)'
+      inv(1) = 'x=r*cos(a)'
+      inv(2) = 'y=r*sin(a)'
+      mm1 = ast_mathmap( 2, 2, 2, fwd, 2, inv, ' ', status )
+      fwd(1) = 'r=sqrt(x*x+y*y)'
+      fwd(2) = 'a=atan2(x,y)'
+      mm2 = ast_mathmap( 2, 2, 2, fwd, 2, inv, ' ', status )
+      if( ast_equal( mm1, mm2, status ) ) then
+         call stopit( status, 'Error 4' )
+      end if
+
+      fwd(2) = 'a=atan2(y,x)'
+      mm2 = ast_mathmap( 2, 2, 2, fwd, 2, inv, ' ', status )
+      if( .not. ast_equal( mm1, mm2, status ) ) then
+         call stopit( status, 'Error 5' )
+      end if
+
+*  The last opcode in each function must be compared.
+      mm1 = ast_mathmap( 1, 1, 1, 'y=x+1', 1, 'x', ' ', status )
+      mm2 = ast_mathmap( 1, 1, 1, 'y=x-1', 1, 'x', ' ', status )
+      if( ast_equal( mm1, mm2, status ) ) then
+         call stopit( status, 'Error 6' )
+      end if
+
+      end
+
+
+
+      subroutine checkrandom( status )
+      implicit none
+
+      include 'AST_PAR'
+      include 'SAE_PAR'
+
+      integer status, mm1, mm2, i
+      double precision in(3000), out1(3000), out2(3000), out3(3000)
+
+      if( status .ne. sai__ok ) return
+
+*  MathMaps that use random numbers are only equal if they have the same
+*  Seed and IndexedRand values.
+      mm1 = ast_mathmap( 1, 1, 1, 'y=x+rand(0,1)+gauss(0,1)', 1, 'x',
+     :                   'Seed=10,IndexedRand=1', status )
+      mm2 = ast_copy( mm1, status )
+      if( .not. ast_equal( mm1, mm2, status ) ) then
+         call stopit( status, 'Error 7' )
+      end if
+
+      call ast_setl( mm2, 'IndexedRand', .false., status )
+      if( ast_equal( mm1, mm2, status ) ) then
+         call stopit( status, 'Error 8' )
+      end if
+
+      call ast_setl( mm2, 'IndexedRand', .true., status )
+      call ast_seti( mm2, 'Seed', 11, status )
+      if( ast_equal( mm1, mm2, status ) ) then
+         call stopit( status, 'Error 9' )
+      end if
+
+*  With IndexedRand set, transforming enough points to be evaluated in
+*  several tiles must give the same values as transforming fewer points
+*  in a single tile, and repeating the transformation must give the same
+*  values again.
+      do i = 1, 3000
+         in(i) = i
+      end do
+
+      call ast_tran1( mm1, 3000, in, .true., out1, status )
+      call ast_tran1( mm1, 1000, in, .true., out2, status )
+      call ast_tran1( mm1, 3000, in, .true., out3, status )
+
+      do i = 1, 3000
+         if( i .le. 1000 .and. out1(i) .ne. out2(i) ) then
+            call stopit( status, 'Error 10' )
+            return
+         else if( out1(i) .ne. out3(i) ) then
+            call stopit( status, 'Error 11' )
+            return
+         end if
+      end do
+
+      if( out1(1) - in(1) .eq. out1(2000) - in(2000) ) then
+         call stopit( status, 'Error 12' )
+      end if
+
+      end
+
+
+
+      subroutine stopit( status, text )
+      implicit none
+      include 'SAE_PAR'
+      integer status
+      character text*(*)
+
+      if( status .ne. sai__ok ) return
+      status = sai__error
+      write(*,*) text
+
+      end
@@ -0,0 +1,428 @@
+      program testmoc
+      implicit none
+
+      include 'AST_PAR'
+      include 'AST_ERR'
+      include 'SAE_PAR'
+
+      integer status, sky, cira, cirb, moca, mocb, moc, big, order,
+     :        poly, i
+      integer*8 npix
+      double precision cena(2), cenb(2), ra, rb, rbig, area, pi, lon(2),
+     :                 lat(2), xout(2), yout(2), pts(4,2)
+
+      status = sai__ok
+      call ast_begin( status )
+
+      pi = 4.0D0*atan( 1.0D0 )
+
+*  Two overlapping Circles in ICRS.
+      sky = ast_skyframe( 'System=ICRS', status )
+      cena(1) = 1.0D0
+      cena(2) = 0.5D0
+      ra = 0.1D0
+      cira = ast_circle( sky, 1, cena, ra, AST__NULL, ' ', status )
+
+      cenb(1) = 1.12D0
+      cenb(2) = 0.5D0
+      rb = 0.08D0
+      cirb = ast_circle( sky, 1, cenb, rb, AST__NULL, ' ', status )
+
+*  Rasterise the first Circle at order 10, and check that every point
+*  inside the Circle is inside the Moc, and every point well outside the
+*  Circle is outside the Moc.
+      moca = ast_moc( 'MaxOrder=10', status )
+      call ast_addregion( moca, AST__OR, cira, status )
+      call tstpts( moca, sky, cena, ra, cenb, rb, 0, 'Error 1',
+     :             status )
+
+*  Check the area. The boundary cells add about 2% at this order.
+      area = 2.0D0*pi*( 1.0D0 - cos( ra ) )*( 10800.0D0/pi )**2
+      if( abs( ast_getd( moca, 'MocArea', status ) - area ) .gt.
+     :    0.05D0*area ) then
+         write(*,*) ast_getd( moca, 'MocArea', status ), area
+         call stopit( status, 'Error 2' )
+      end if
+
+*  Union and intersection with the second Circle, both as a Region and
+*  as a Moc.
+      mocb = ast_moc( 'MaxOrder=10', status )
+      call ast_addregion( mocb, AST__OR, cirb, status )
+      call tstpts( mocb, sky, cenb, rb, cena, ra, 0, 'Error 3',
+     :             status )
+
+      moc = ast_copy( moca, status )
+      call ast_addregion( moc, AST__OR, mocb, status )
+      call tstpts( moc, sky, cena, ra, cenb, rb, 1, 'Error 4',
+     :             status )
+
+      moc = ast_copy( moca, status )
+      call ast_addregion( moc, AST__OR, cirb, status )
+      call tstpts( moc, sky, cena, ra, cenb, rb, 1, 'Error 5',
+     :             status )
+
+      moc = ast_copy( moca, status )
+      call ast_addregion( moc, AST__AND, mocb, status )
+      call tstpts( moc, sky, cena, ra, cenb, rb, 2, 'Error 6',
+     :             status )
+
+      moc = ast_copy( moca, status )
+      call ast_addregion( moc, AST__AND, cirb, status )
+      call tstpts( moc, sky, cena, ra, cenb, rb, 2, 'Error 7',
+     :             status )
+
+*  Negation.
+      moc = ast_copy( moca, status )
+      call ast_negate( moc, status )
+      call tstpts( moc, sky, cena, ra, cenb, rb, 3, 'Error 8',
+     :             status )
+
+*  Adding a Region to a negated Moc combines it with the area actually
+*  covered by the Moc. The union of NOT A with A is the whole sky.
+      call ast_addregion( moc, AST__OR, cira, status )
+      if( ast_getl( moc, 'Negated', status ) ) then
+         call stopit( status, 'Error 9' )
+      else if( abs( ast_getd( moc, 'MocArea', status ) -
+     :              4.0D0*pi*( 10800.0D0/pi )**2 ) .gt. 1.0D0 ) then
+         write(*,*) ast_getd( moc, 'MocArea', status )
+         call stopit( status, 'Error 10' )
+      end if
+
+*  Single cells. The four order 1 children of base cell 4 merge into a
+*  single order 0 cell.
+      moc = ast_moc( ' ', status )
+      do npix = 16, 19
+         call ast_addcell( moc, AST__OR, 1, npix, status )
+      end do
+      if( ast_geti( moc, 'MocLength', status ) .ne. 1 ) then
+         call stopit( status, 'Error 11' )
+      else
+         call ast_getcell( moc, 1, order, npix, status )
+         if( order .ne. 0 .or. npix .ne. 4 ) then
+            write(*,*) order, npix
+            call stopit( status, 'Error 12' )
+         end if
+      end if
+
+*  Base cell 4 is centred on RA=0, Dec=0, and does not reach RA=PI.
+      lon(1) = 0.0D0
+      lat(1) = 0.0D0
+      lon(2) = pi
+      lat(2) = 0.0D0
+      call ast_tran2( moc, 2, lon, lat, .true., xout, yout, status )
+      if( xout(1) .eq. AST__BAD .or. xout(2) .ne. AST__BAD ) then
+         call stopit( status, 'Error 13' )
+      end if
+
+*  Intersect with one of its children.
+      npix = 17
+      call ast_addcell( moc, AST__AND, 1, npix, status )
+      call ast_getcell( moc, 1, order, npix, status )
+      if( ast_geti( moc, 'MocLength', status ) .ne. 1 .or.
+     :    order .ne. 1 .or. npix .ne. 17 ) then
+         write(*,*) ast_geti( moc, 'MocLength', status ), order, npix
+         call stopit( status, 'Error 14' )
+      end if
+
+*  Write the Mocs to a Channel and read them back.
+      call checkdump( moca, 'Error 15', status )
+      moc = ast_copy( moca, status )
+      call ast_addregion( moc, AST__AND, mocb, status )
+      call ast_negate( moc, status )
+      call checkdump( moc, 'Error 16', status )
+
+*  A large Region cannot be rasterised at a high order, since the mesh
+*  needed to find all the boundary cells would be too large. Check that
+*  an error is reported.
+      if( status .eq. sai__ok ) then
+         rbig = 1.3D0
+         big = ast_circle( sky, 1, cena, rbig, AST__NULL, ' ', status )
+         moc = ast_moc( 'MaxOrder=17', status )
+         call err_mark
+         call ast_addregion( moc, AST__OR, big, status )
+         if( status .eq. AST__BDPAR ) then
+            call err_annul( status )
+         else
+            call stopit( status, 'Error 17' )
+         end if
+         call err_rlse
+
+*  The same Region can be rasterised at a lower order.
+         call ast_seti( moc, 'MaxOrder', 10, status )
+         call ast_addregion( moc, AST__OR, big, status )
+         call tstpts( moc, sky, cena, rbig, cenb, rb, 0, 'Error 18',
+     :                status )
+      end if
+
+*  Polygons with edges that cross the edges of the HEALPix base faces
+*  close to their corners. Four faces meet at RA=PI/4, Dec=0, and three
+*  at RA=0, Dec=asin(2/3). Every point on the boundary of each Polygon
+*  should be inside the Moc, including points in cells where the
+*  boundary cuts off the corner of a cell in a neighbouring face.
+      do i = 1, 2
+         if( i .eq. 1 ) then
+            pts(1,1) = 0.7640D0
+            pts(1,2) = -0.0563D0
+            pts(2,1) = 0.7569D0
+            pts(2,2) = 0.0149D0
+            pts(3,1) = 0.8031D0
+            pts(3,2) = 0.0471D0
+            pts(4,1) = 0.8407D0
+            pts(4,2) = 0.0076D0
+         else
+            pts(1,1) = 0.0096D0
+            pts(1,2) = 0.6912D0
+            pts(2,1) = -0.0792D0
+            pts(2,2) = 0.6986D0
+            pts(3,1) = 0.0004D0
+            pts(3,2) = 0.7878D0
+            pts(4,1) = 0.0325D0
+            pts(4,2) = 0.7196D0
+         end if
+         poly = ast_polygon( sky, 4, 4, pts, AST__NULL, ' ', status )
+         moc = ast_moc( 'MaxOrder=7', status )
+         call ast_addregion( moc, AST__OR, poly, status )
+         call tstbnd( moc, poly, 'Error 19', status )
+      end do
+
+      call ast_end( status )
+
+      if( status .eq. sai__ok ) then
+         write(*,*) 'All Moc tests passed'
+      else
+         write(*,*) 'Moc tests failed'
+      end if
+
+      end
+
+
+
+*  Test a grid of points against a Moc. "oper" indicates the expected
+*  coverage: 0 - circle A, 1 - A OR B, 2 - A AND B, 3 - NOT A. Points
+*  close to the boundary of either circle are not checked.
+      subroutine tstpts( moc, sky, cena, ra, cenb, rb, oper, text,
+     :                   status )
+      implicit none
+      include 'AST_PAR'
+      include 'SAE_PAR'
+
+      integer nlon, nlat, np
+      parameter( nlon = 101, nlat = 61, np = nlon*nlat )
+
+      integer moc, sky, oper, status, i, j, ip
+      character text*(*)
+      double precision cena(2), ra, cenb(2), rb, in(np,2), out(np,2),
+     :                 p(2), da, db, marg
+      logical ina, outa, inb, outb, yes, no, got
+
+      if( status .ne. sai__ok ) return
+
+*  Boundary cells at order 10 are about 1E-3 radians across.
+      marg = 5.0D-3
+
+      ip = 0
+      do j = 1, nlat
+         do i = 1, nlon
+            ip = ip + 1
+            in(ip,1) = cena(1) - 0.5D0 + 0.01D0*( i - 1 )
+            in(ip,2) = cena(2) - 0.3D0 + 0.01D0*( j - 1 )
+         end do
+      end do
+
+      call ast_trann( moc, np, 2, np, in, .true., 2, np, out, status )
+      if( status .ne. sai__ok ) return
+
+      do ip = 1, np
+         p(1) = in(ip,1)
+         p(2) = in(ip,2)
+         da = ast_distance( sky, cena, p, status )
+         db = ast_distance( sky, cenb, p, status )
+         ina = ( da .lt. ra )
+         outa = ( da .gt. ra + marg )
+         inb = ( db .lt. rb )
+         outb = ( db .gt. rb + marg )
+
+         if( oper .eq. 0 ) then
+            yes = ina
+            no = outa
+         else if( oper .eq. 1 ) then
+            yes = ina .or. inb
+            no = outa .and. outb
+         else if( oper .eq. 2 ) then
+            yes = ina .and. inb
+            no = outa .or. outb
+         else
+            yes = outa
+            no = ina
+         end if
+
+         got = ( out(ip,1) .ne. AST__BAD )
+         if( ( yes .and. .not. got ) .or. ( no .and. got ) ) then
+            write(*,*) ip, in(ip,1), in(ip,2), da, db, got
+            call stopit( status, text )
+            return
+         end if
+      end do
+
+      end
+
+
+
+*  Test a dense mesh of points on the boundary of a Region against a Moc
+*  created from the Region. Every point should be inside the Moc.
+      subroutine tstbnd( moc, reg, text, status )
+      implicit none
+      include 'AST_PAR'
+      include 'SAE_PAR'
+
+      integer mxp
+      parameter( mxp = 20000 )
+
+      integer moc, reg, status, ip, np
+      character text*(*)
+      double precision in(mxp,2), out(mxp,2)
+
+      if( status .ne. sai__ok ) return
+
+      call ast_seti( reg, 'MeshSize', 10000, status )
+      call ast_getregionmesh( reg, .true., mxp, 2, np, in, status )
+      call ast_trann( moc, np, 2, mxp, in, .true., 2, mxp, out,
+     :                status )
+      if( status .ne. sai__ok ) return
+
+      do ip = 1, np
+         if( out(ip,1) .eq. AST__BAD ) then
+            write(*,*) ip, in(ip,1), in(ip,2)
+            call stopit( status, text )
+            return
+         end if
+      end do
+
+      end
+
+
+
+      subroutine checkdump( obj, text, status )
+      implicit none
+      include 'SAE_PAR'
+      include 'AST_PAR'
+      character text*(*)
+      integer obj, status, next, end, ch, result, ll, i, o1, o2
+      integer*8 n1, n2
+      external mysource, mysink
+      character buf*400000
+
+      common /ss1/ buf
+      common /ss2/ next, end, ll
+
+      if( status .ne. sai__ok ) return
+
+*  Create a Channel which reads and writes to an internal string buffer.
+      ch = ast_channel( mysource, mysink, ' ', status )
+
+*  Write the supplied Moc out to this Channel.
+      ll = 80
+      next = 1
+      if( ast_write( ch, obj, status ) .ne.1 ) then
+         call stopit( status, text )
+         return
+      end if
+
+*  Read an Object back from this Channel, and check it describes the
+*  same cells.
+      next = 1
+      result = ast_read( ch, status )
+      if( result .eq. AST__NULL ) then
+         call stopit( status, text )
+      else if( .not. ast_isamoc( result, status ) .or.
+     :         .not. ast_equal( obj, result, status ) .or.
+     :         ast_getl( obj, 'Negated', status ) .neqv.
+     :         ast_getl( result, 'Negated', status ) .or.
+     :         ast_geti( obj, 'MocLength', status ) .ne.
+     :         ast_geti( result, 'MocLength', status ) ) then
+         call stopit( status, text )
+      else
+         do i = 1, ast_geti( obj, 'MocLength', status )
+            call ast_getcell( obj, i, o1, n1, status )
+            call ast_getcell( result, i, o2, n2, status )
+            if( o1 .ne. o2 .or. n1 .ne. n2 ) then
+               write(*,*) i, o1, n1, o2, n2
+               call stopit( status, text )
+               return
+            end if
+         end do
+      end if
+
+      end
+
+      subroutine mysource( status )
+      implicit none
+      include 'SAE_PAR'
+      include 'AST_PAR'
+      integer status, next, end, ll
+      character buf*400000
+
+      common /ss1/ buf
+      common /ss2/ next, end, ll
+
+      if( status .ne. sai__ok ) return
+
+      if( next .ge. end ) then
+         call ast_putline( buf, -1, status )
+      else
+         call ast_putline( buf( next : ), ll, status )
+      endif
+
+      next = next + ll
+
+      end
+
+      subroutine mysink( status )
+      implicit none
+      include 'SAE_PAR'
+      include 'AST_PAR'
+      integer status, next, end, f, l, ll
+      character buf*400000
+      character line*1000
+
+      common /ss1/ buf
+      common /ss2/ next, end, ll
+
+      if( status .ne. sai__ok ) return
+
+      line = ' '
+      call ast_getline( line, l, status )
+      call chr_fandl( line( : l ), f, l )
+      buf( next : ) = line( f : l )
+      l = l - f + 1
+
+      if( next + ll - 1 .ge. 400000 ) then
+         write(*,*)
+         call stopit( status, 'Buffer overflow in mysink!!' )
+      else if( l .gt. ll ) then
+         write(*,*)
+         write(*,*) buf( next : next + l)
+         write(*,*) 'Line length ',l,' greater than ',ll
+         call stopit( status, 'Line overflow in mysink!!' )
+      else
+         end = next + l
+         buf( end : next + ll - 1 ) = ' '
+      endif
+
+      next = next + ll
+
+      end
+
+
+
+      subroutine stopit( status, text )
+      implicit none
+      include 'SAE_PAR'
+      integer status
+      character text*(*)
+
+      if( status .ne. sai__ok ) return
+      status = sai__error
+      write(*,*) text
+
+      end
@@ -6,7 +6,7 @@
 
       integer status, m, outp(4), inp(4), c1, c2, c3, c4
       double precision at(4), r, mat(4), b1(2), b2(2), a1(2),
-     :                 a2(4)
+     :                 a2(4), pcof(16)
 
       status = sai__ok
 
@@ -320,6 +320,99 @@
       r = ast_rate( m, at, 3, 4, status )
       if( r .ne. 0.0D0 ) call stopit( 70, r, status )
 
+*  PolyMap: y1 = 1 + 2*x1 + 3*x1**2*x2,  y2 = x2**3
+      pcof(1) = 1.0D0
+      pcof(2) = 1.0D0
+      pcof(3) = 0.0D0
+      pcof(4) = 0.0D0
+      pcof(5) = 2.0D0
+      pcof(6) = 1.0D0
+      pcof(7) = 1.0D0
+      pcof(8) = 0.0D0
+      pcof(9) = 3.0D0
+      pcof(10) = 1.0D0
+      pcof(11) = 2.0D0
+      pcof(12) = 1.0D0
+      pcof(13) = 1.0D0
+      pcof(14) = 2.0D0
+      pcof(15) = 0.0D0
+      pcof(16) = 3.0D0
+      m = ast_polymap( 2, 2, 4, pcof, 0, pcof, ' ', status )
+
+      at(1) = 1.0D0
+      at(2) = 2.0D0
+      r = ast_rate( m, at, 1, 1, status )
+      if( r .ne. 14.0D0 ) call stopit( 71, r, status )
+      r = ast_rate( m, at, 1, 2, status )
+      if( r .ne. 3.0D0 ) call stopit( 72, r, status )
+      r = ast_rate( m, at, 2, 1, status )
+      if( r .ne. 0.0D0 ) call stopit( 73, r, status )
+      r = ast_rate( m, at, 2, 2, status )
+      if( r .ne. 12.0D0 ) call stopit( 74, r, status )
+
+*  ChebyMap: y = T2(x) = 2*x**2 - 1 on [-1,1]
+      pcof(1) = 1.0D0
+      pcof(2) = 1.0D0
+      pcof(3) = 2.0D0
+      b1(1) = -1.0D0
+      b2(1) = 1.0D0
+      m = ast_chebymap( 1, 1, 1, pcof, 0, pcof, b1, b2, b1, b2, ' ',
+     :                  status )
+
+      at(1) = 0.5D0
+      r = ast_rate( m, at, 1, 1, status )
+      if( r .ne. 2.0D0 ) call stopit( 75, r, status )
+
+*  SphMap
+      m = ast_sphmap( ' ', status )
+
+      at(1) = 1.0D0
+      at(2) = 1.0D0
+      at(3) = 0.0D0
+      r = ast_rate( m, at, 1, 1, status )
+      if( r .ne. -0.5D0 ) call stopit( 76, r, status )
+      r = ast_rate( m, at, 1, 2, status )
+      if( r .ne. 0.5D0 ) call stopit( 77, r, status )
+      r = ast_rate( m, at, 2, 3, status )
+      if( abs( r - sqrt( 0.5D0 ) ) .gt. 1.0D-12 )
+     :                            call stopit( 78, r, status )
+
+      call ast_invert( m, status )
+      at(1) = 0.0D0
+      at(2) = 0.0D0
+      r = ast_rate( m, at, 2, 1, status )
+      if( r .ne. 1.0D0 ) call stopit( 79, r, status )
+      r = ast_rate( m, at, 3, 2, status )
+      if( r .ne. 1.0D0 ) call stopit( 80, r, status )
+
+*  WcsMaps. The analytic rates should agree with numerical estimates in
+*  both directions, and for a projection (AIT) that has no analytic
+*  rates.
+      call tstwcs( AST__TAN, 0.0D0, 0.0D0, 1.1D0, 81, status )
+      call tstwcs( AST__SIN, 0.1D0, -0.2D0, 1.1D0, 82, status )
+      call tstwcs( AST__ARC, 0.0D0, 0.0D0, 1.1D0, 83, status )
+      call tstwcs( AST__ZEA, 0.0D0, 0.0D0, 1.1D0, 84, status )
+      call tstwcs( AST__CAR, 0.0D0, 0.0D0, 0.3D0, 85, status )
+      call tstwcs( AST__CEA, 0.7D0, 0.0D0, 0.3D0, 86, status )
+      call tstwcs( AST__MER, 0.0D0, 0.0D0, 0.3D0, 87, status )
+      call tstwcs( AST__AIT, 0.0D0, 0.0D0, 0.3D0, 88, status )
+
+*  A WcsMap with a third axis, and the longitude on the second axis.
+      m = ast_wcsmap( 3, AST__TAN, 2, 3, ' ', status )
+      at(1) = 5.0D0
+      at(2) = 0.4D0
+      at(3) = 1.1D0
+      r = ast_rate( m, at, 1, 1, status )
+      if( r .ne. 1.0D0 ) call stopit( 89, r, status )
+      r = ast_rate( m, at, 2, 1, status )
+      if( r .ne. 0.0D0 ) call stopit( 90, r, status )
+      r = ast_rate( m, at, 2, 2, status )
+      if( abs( r - cos( 0.4D0 )/tan( 1.1D0 ) ) .gt. 1.0D-12 )
+     :                            call stopit( 91, r, status )
+      r = ast_rate( m, at, 3, 3, status )
+      if( abs( r - cos( 0.4D0 )/sin( 1.1D0 )**2 ) .gt. 1.0D-12 )
+     :                            call stopit( 92, r, status )
+
 
 
 
@@ -332,6 +425,66 @@
       end
 
 
+*  Compare the rates of a 2D WcsMap, in both directions, with central
+*  differences. "lat" is the native latitude at which the rates are
+*  found, and "pv1" and "pv2" give the first two projection parameters
+*  on the latitude axis (if non-zero).
+      subroutine tstwcs( type, pv1, pv2, lat, itest, status )
+      implicit none
+      include 'SAE_PAR'
+      include 'AST_PAR'
+      integer type, itest, status, m, dir, ax1, ax2
+      double precision pv1, pv2, lat, sky(2), xy(2), at(2), a(2), b(2),
+     :                 oa(2), ob(2), r, est, h
+
+      if( status .ne. sai__ok ) return
+
+      m = ast_wcsmap( 2, type, 1, 2, ' ', status )
+      if( pv1 .ne. 0.0D0 ) call ast_setd( m, 'PV2_1', pv1, status )
+      if( pv2 .ne. 0.0D0 ) call ast_setd( m, 'PV2_2', pv2, status )
+
+      sky(1) = 0.4D0
+      sky(2) = lat
+      call ast_trann( m, 1, 2, 1, sky, .true., 2, 1, xy, status )
+
+      h = 1.0D-6
+      do dir = 1, 2
+         if( dir .eq. 1 ) then
+            at(1) = sky(1)
+            at(2) = sky(2)
+         else
+            call ast_invert( m, status )
+            at(1) = xy(1)
+            at(2) = xy(2)
+         end if
+
+         do ax2 = 1, 2
+            a(1) = at(1)
+            a(2) = at(2)
+            b(1) = at(1)
+            b(2) = at(2)
+            a(ax2) = a(ax2) - h
+            b(ax2) = b(ax2) + h
+            call ast_trann( m, 1, 2, 1, a, .true., 2, 1, oa, status )
+            call ast_trann( m, 1, 2, 1, b, .true., 2, 1, ob, status )
+
+            do ax1 = 1, 2
+               est = ( ob(ax1) - oa(ax1) )/( 2.0D0*h )
+               r = ast_rate( m, at, ax1, ax2, status )
+               if( abs( r - est ) .gt. 1.0D-8*max( 1.0D0, abs( est ) ) )
+     :            then
+                  write(*,*) dir, ax1, ax2, est
+                  call stopit( itest, r, status )
+               end if
+            end do
+         end do
+      end do
+
+      call ast_annul( m, status )
+
+      end
+
+
       subroutine stopit( i, r, status )
       implicit none
       include 'SAE_PAR'
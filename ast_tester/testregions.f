@@ -20,6 +20,9 @@ c      call ast_watchmemory( 282905 )
       call generalChecks( status )
       call checkCmpRegion( status )
       call checkPointList( status )
+      call checkOverlapCap( status )
+      call checkRegionsContain( status )
+      call checkLargeMask( status )
 
       call ast_end( status )
 
@@ -2142,9 +2145,9 @@ C
 
       character fwd(1)*30,inv(1)*30
       integer status, frm, reg, reg2, reg3, reg4, mm, map
-      integer mdata(-1:15),lbnd,ubnd,nbad,unc
+      integer mdata(-1:15),lbnd,ubnd,nbad,unc,size1,size2,km
       double precision pnts( 3 ), xin(3),xout(3), acc, ina, inb, outa,
-     :                 outb
+     :                 outb, pnts2(3,2), cen(2), crn(2), yin(3), yout(3)
       data mdata /17*0/
 
       if( status .ne.sai__ok ) return
@@ -2265,6 +2268,46 @@ C
          call stopit( status, 'Above value should be 0' )
       end if
 
+*  Testing positions against a PointList in a basic Frame builds a k-d
+*  tree. Check that the ObjSize of a KeyMap holding the PointList
+*  includes it (the ObjSize of a Region itself is that of its Frame).
+      frm = ast_frame( 2, ' ', status )
+      cen(1) = 0.0
+      cen(2) = 0.0
+      crn(1) = 0.01
+      crn(2) = 0.01
+      unc = ast_box( frm, 0, cen, crn, AST__NULL, ' ', status )
+
+      pnts2(1,1) = 1.0
+      pnts2(2,1) = 2.0
+      pnts2(3,1) = 3.0
+      pnts2(1,2) = 1.0
+      pnts2(2,2) = 4.0
+      pnts2(3,2) = 9.0
+      reg = ast_pointlist( frm, 3, 2, 3, pnts2, unc, ' ', status )
+      km = ast_keymap( ' ', status )
+      call ast_mapput0a( km, 'PointList', reg, ' ', status )
+      size1 = ast_geti( km, 'ObjSize', status )
+
+      xin(1) = 2.0
+      yin(1) = 4.0
+      xin(2) = 2.5
+      yin(2) = 4.0
+      xin(3) = 3.0
+      yin(3) = 9.001
+      call ast_tran2( reg, 3, xin, yin, .true., xout, yout, status )
+      if( xout(1) .ne. 2.0 .or. xout(2) .ne. AST__BAD .or.
+     :    xout(3) .ne. 3.0 ) then
+         write(*,*) xout
+         call stopit( status, 'PointList: Error 9' )
+      end if
+
+      size2 = ast_geti( km, 'ObjSize', status )
+      if( size2 .le. size1 ) then
+         write(*,*) size1, size2
+         call stopit( status, 'PointList: Error 10' )
+      end if
+
 
 
 
@@ -2280,6 +2323,354 @@ C
 
 
 
+      subroutine checkLargeMask( status )
+      implicit none
+      include 'AST_PAR'
+      include 'SAE_PAR'
+
+      integer nx, ny
+      parameter( nx = 100, ny = 200000 )
+
+      integer status, frm, pol, cir, um, wm, lbnd(2), ubnd(2), n, i, j
+      byte mask( nx, ny ), val
+      double precision pnts(3,2), cen(2), r, ina(2), inb(2), outa(2),
+     :                 outb(2)
+
+      if( status .ne. sai__ok ) return
+
+      call ast_begin( status )
+
+*  Masks for grids with many rows are found a batch of rows at a time.
+*  Use a tall narrow grid that needs many batches, of different sizes.
+*  The expected counts were found by transforming every pixel.
+      lbnd(1) = 1
+      lbnd(2) = 1
+      ubnd(1) = nx
+      ubnd(2) = ny
+      val = 1
+      frm = ast_frame( 2, ' ', status )
+      um = ast_unitmap( 2, ' ', status )
+
+*  A long thin triangle.
+      pnts(1,1) = 3.5D0
+      pnts(2,1) = 97.2D0
+      pnts(3,1) = 40.3D0
+      pnts(1,2) = 2.5D0
+      pnts(2,2) = 1000.5D0
+      pnts(3,2) = 199990.7D0
+      pol = ast_polygon( frm, 3, 3, pnts, AST__NULL, ' ', status )
+
+      do j = 1, ny
+         do i = 1, nx
+            mask( i, j ) = 0
+         end do
+      end do
+      n = ast_maskub( pol, um, .true., 2, lbnd, ubnd, mask, val,
+     :                status )
+      if( n .ne. 9343115 ) then
+         write(*,*) n
+         call stopit( status, 'LargeMask: Error 1' )
+      end if
+
+*  A Circle, stretched along the grid's second axis by a WinMap.
+      ina(1) = 0.5D0
+      ina(2) = 0.5D0
+      inb(1) = 100.5D0
+      inb(2) = 100.5D0
+      outa(1) = 0.5D0
+      outa(2) = 0.5D0
+      outb(1) = 100.5D0
+      outb(2) = 200000.5D0
+      wm = ast_winmap( 2, ina, inb, outa, outb, ' ', status )
+
+      cen(1) = 50.5D0
+      cen(2) = 50.5D0
+      r = 48.0D0
+      cir = ast_circle( frm, 1, cen, r, AST__NULL, ' ', status )
+
+      do j = 1, ny
+         do i = 1, nx
+            mask( i, j ) = 0
+         end do
+      end do
+      n = ast_maskub( cir, wm, .true., 2, lbnd, ubnd, mask, val,
+     :                status )
+      if( n .ne. 14481228 ) then
+         write(*,*) n
+         call stopit( status, 'LargeMask: Error 2' )
+      end if
+
+      call ast_end( status )
+      if( status .ne. sai__ok ) write(*,*) 'LargeMask tests failed'
+
+      end
+
+
+
+
+      subroutine checkRegionsContain( status )
+      implicit none
+      include 'AST_PAR'
+      include 'SAE_PAR'
+
+      integer nreg, npoint, ndim
+      parameter( nreg = 8, ndim = 21, npoint = ndim*ndim + 3 )
+
+      integer status, frm, regs(nreg), inside(npoint,nreg), nin,
+     :        nexp, i, j, ip, ireg, zm, wm
+      logical good, any
+      double precision in(npoint,2), out(npoint,2), p1(2), p2(2),
+     :                 r, pg(4,2), ina(2), inb(2), outa(2), outb(2)
+
+      if( status .ne. sai__ok ) return
+
+      call ast_begin( status )
+
+*  A set of Regions, some defined with the same base Frame and some
+*  with different base Frames, and some negated.
+      frm = ast_frame( 2, ' ', status )
+
+      p1(1) = 0.0D0
+      p1(2) = 0.0D0
+      r = 1.0D0
+      regs(1) = ast_circle( frm, 1, p1, r, AST__NULL, ' ', status )
+
+      p1(1) = -0.5D0
+      p1(2) = -1.5D0
+      p2(1) = 1.5D0
+      p2(2) = 0.5D0
+      regs(2) = ast_box( frm, 1, p1, p2, AST__NULL, ' ', status )
+      call ast_negate( regs(2), status )
+
+      pg(1,1) = -1.8D0
+      pg(1,2) = -1.8D0
+      pg(2,1) = 0.3D0
+      pg(2,2) = -1.2D0
+      pg(3,1) = 1.7D0
+      pg(3,2) = 1.6D0
+      pg(4,1) = -0.9D0
+      pg(4,2) = 0.4D0
+      regs(3) = ast_polygon( frm, 4, 4, pg, AST__NULL, ' ', status )
+
+*  Regions whose base Frame is related to the common Frame by a
+*  ZoomMap or a WinMap.
+      zm = ast_zoommap( 2, 2.0D0, ' ', status )
+      regs(4) = ast_mapregion( regs(1), zm, frm, status )
+      regs(5) = ast_copy( regs(4), status )
+      call ast_negate( regs(5), status )
+
+      ina(1) = 0.0D0
+      ina(2) = 0.0D0
+      inb(1) = 1.0D0
+      inb(2) = 1.0D0
+      outa(1) = -1.0D0
+      outa(2) = 0.5D0
+      outb(1) = -0.5D0
+      outb(2) = 1.5D0
+      wm = ast_winmap( 2, ina, inb, outa, outb, ' ', status )
+      regs(6) = ast_mapregion( regs(3), wm, frm, status )
+
+*  A compound Region, and an unbounded Interval.
+      regs(7) = ast_cmpregion( regs(2), regs(6), AST__AND, ' ',
+     :                         status )
+
+      p1(1) = 0.7D0
+      p1(2) = AST__BAD
+      p2(1) = AST__BAD
+      p2(2) = AST__BAD
+      regs(8) = ast_interval( frm, p1, p2, AST__NULL, ' ', status )
+
+*  A grid of test points, plus points with one or both axis values bad.
+      ip = 0
+      do j = 1, ndim
+         do i = 1, ndim
+            ip = ip + 1
+            in(ip,1) = -2.0D0 + 0.2D0*( i - 1 )
+            in(ip,2) = -2.0D0 + 0.2D0*( j - 1 )
+         end do
+      end do
+      in(ndim*ndim+1,1) = AST__BAD
+      in(ndim*ndim+1,2) = AST__BAD
+      in(ndim*ndim+2,1) = AST__BAD
+      in(ndim*ndim+2,2) = 0.1D0
+      in(ndim*ndim+3,1) = 0.9D0
+      in(ndim*ndim+3,2) = AST__BAD
+
+      nin = ast_regionscontain( nreg, regs, npoint, 2, npoint, in,
+     :                          inside, status )
+
+*  Compare with the results of transforming the points with each Region
+*  in turn.
+      nexp = 0
+      do ip = 1, npoint
+         any = .false.
+         do ireg = 1, nreg
+            call ast_trann( regs(ireg), 1, 2, npoint, in(ip,1), .true.,
+     :                      2, npoint, out(ip,1), status )
+            good = ( out(ip,1) .ne. AST__BAD .or.
+     :               out(ip,2) .ne. AST__BAD )
+            if( good ) any = .true.
+            if( ( good .and. inside(ip,ireg) .ne. 1 ) .or.
+     :          ( .not. good .and. inside(ip,ireg) .ne. 0 ) ) then
+               write(*,*) ip, ireg, in(ip,1), in(ip,2), inside(ip,ireg)
+               call stopit( status, 'RegionsContain: Error 1' )
+               go to 10
+            end if
+         end do
+         if( any ) nexp = nexp + 1
+      end do
+
+      if( nin .ne. nexp ) then
+         write(*,*) nin, nexp
+         call stopit( status, 'RegionsContain: Error 2' )
+      end if
+
+*  Check every Region contains some of the points and excludes others,
+*  so that the above test is not trivial.
+      do ireg = 1, nreg
+         nexp = 0
+         do ip = 1, npoint
+            nexp = nexp + inside(ip,ireg)
+         end do
+         if( nexp .eq. 0 .or. nexp .eq. npoint ) then
+            write(*,*) ireg, nexp
+            call stopit( status, 'RegionsContain: Error 3' )
+         end if
+      end do
+
+ 10   continue
+
+      call ast_end( status )
+      if( status .ne. sai__ok ) write(*,*) 'RegionsContain tests failed'
+
+      end
+
+
+
+
+      subroutine checkOverlapCap( status )
+      implicit none
+      include 'AST_PAR'
+      include 'SAE_PAR'
+
+      integer status, frm, sky, c1, c2, c3, c4, b1, s1, s2, s3, i,
+     :        regs(4), over(4), cpy
+      double precision p1(2), p2(2), r
+
+      if( status .ne. sai__ok ) return
+
+      call ast_begin( status )
+
+*  Regions in a basic Frame. astOverlap first compares the caps that
+*  enclose each Region, and only compares the meshes if the caps
+*  overlap.
+      frm = ast_frame( 2, ' ', status )
+
+      p1(1) = 0.0D0
+      p1(2) = 0.0D0
+      r = 1.0D0
+      c1 = ast_circle( frm, 1, p1, r, AST__NULL, ' ', status )
+
+*  Caps well separated, so the overlap is rejected using the caps alone.
+      p1(1) = 5.0D0
+      c2 = ast_circle( frm, 1, p1, r, AST__NULL, ' ', status )
+      if( ast_overlap( c2, c1, status ) .ne. 1 ) then
+         call stopit( status, 'OverlapCap: Error 1' )
+      end if
+
+*  Caps overlap, and so do the Regions.
+      p1(1) = 1.5D0
+      c3 = ast_circle( frm, 1, p1, r, AST__NULL, ' ', status )
+      if( ast_overlap( c3, c1, status ) .ne. 4 ) then
+         call stopit( status, 'OverlapCap: Error 2' )
+      end if
+
+      p1(1) = 0.2D0
+      r = 0.3D0
+      c4 = ast_circle( frm, 1, p1, r, AST__NULL, ' ', status )
+      if( ast_overlap( c4, c1, status ) .ne. 2 ) then
+         call stopit( status, 'OverlapCap: Error 3' )
+      end if
+
+*  Caps overlap, but the Regions do not (the Box lies beyond the
+*  Circle, diagonally), so the meshes must be compared.
+      p1(1) = 0.8D0
+      p1(2) = 0.8D0
+      p2(1) = 1.5D0
+      p2(2) = 1.5D0
+      b1 = ast_box( frm, 1, p1, p2, AST__NULL, ' ', status )
+      if( ast_overlap( b1, c1, status ) .ne. 1 ) then
+         call stopit( status, 'OverlapCap: Error 4' )
+      end if
+
+*  The mesh of c1 transformed into the common base Frame is cached in c1
+*  by the above calls. Compare each Region with c1 again, and with a copy
+*  of c1 (which has no cached mesh), and check the results are unchanged.
+      regs(1) = c2
+      regs(2) = c3
+      regs(3) = c4
+      regs(4) = b1
+      over(1) = 1
+      over(2) = 4
+      over(3) = 2
+      over(4) = 1
+      cpy = ast_copy( c1, status )
+      do i = 1, 4
+         if( ast_overlap( regs(i), c1, status ) .ne. over(i) ) then
+            write(*,*) i
+            call stopit( status, 'OverlapCap: Error 5' )
+         else if( ast_overlap( regs(i), cpy, status ) .ne.
+     :            over(i) ) then
+            write(*,*) i
+            call stopit( status, 'OverlapCap: Error 6' )
+         end if
+      end do
+
+*  Changing c1 must discard the cached cap and mesh. Negate it so that
+*  c2 lies inside it, then restore it.
+      call ast_negate( c1, status )
+      if( ast_overlap( c2, c1, status ) .ne. 2 ) then
+         call stopit( status, 'OverlapCap: Error 7' )
+      end if
+      call ast_negate( c1, status )
+      if( ast_overlap( c2, c1, status ) .ne. 1 ) then
+         call stopit( status, 'OverlapCap: Error 8' )
+      end if
+
+*  Circles on the sky. The caps are spherical caps.
+      sky = ast_skyframe( ' ', status )
+      p1(1) = 0.0D0
+      p1(2) = 0.5D0
+      r = 0.1D0
+      s1 = ast_circle( sky, 1, p1, r, AST__NULL, ' ', status )
+
+      p1(1) = 3.0D0
+      p1(2) = -0.5D0
+      s2 = ast_circle( sky, 1, p1, r, AST__NULL, ' ', status )
+      if( ast_overlap( s2, s1, status ) .ne. 1 ) then
+         call stopit( status, 'OverlapCap: Error 9' )
+      end if
+
+*  Close to the pole, where the two centres differ greatly in longitude
+*  but overlap on the sphere.
+      p1(1) = 0.0D0
+      p1(2) = 1.5D0
+      s1 = ast_circle( sky, 1, p1, r, AST__NULL, ' ', status )
+      p1(1) = 3.0D0
+      p1(2) = 1.5D0
+      s3 = ast_circle( sky, 1, p1, r, AST__NULL, ' ', status )
+      if( ast_overlap( s3, s1, status ) .ne. 4 ) then
+         call stopit( status, 'OverlapCap: Error 10' )
+      end if
+
+      call ast_end( status )
+      if( status .ne. sai__ok ) write(*,*) 'OverlapCap tests failed'
+
+      end
+
+
+
+
       subroutine checkCircle( status )
       implicit none
       include 'AST_PAR'
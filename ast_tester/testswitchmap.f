@@ -562,6 +562,13 @@ c      call ast_watchmemory(22617)
       if( abs( r1 - r2 ) .gt. abs( 1.0E-6*r2 )  ) call stopit( 154, r1,
      :                                                  status )
 
+*  Test a SelectorMap containing Regions that are connected to their
+*  base Frames by non-linear and linear Mappings.
+      call testselector( status )
+
+*  Test a SwitchMap with many routes and enough points for the routes
+*  to be transformed in parallel.
+      call testmanyroutes( status )
 
 
 
@@ -581,6 +588,77 @@ c      call ast_watchmemory(22617)
       end
 
 
+*  Test a 1D SwitchMap with 20 routes. Route "r" adds 100*r to the input
+*  value, and is used for input values that round to "r". Input values
+*  that round to 0 or 21 select no route.
+      subroutine testmanyroutes( status )
+      implicit none
+      include 'SAE_PAR'
+      include 'AST_PAR'
+
+      integer np, nr
+      parameter( np = 50000, nr = 20 )
+
+      integer status, fs, is, swm, rm(nr), i, k, ir
+      double precision x(np), y(np), x2(np), shift(1)
+
+      if( status .ne. sai__ok ) return
+
+      call ast_begin( status )
+
+      do ir = 1, nr
+         shift(1) = 100.0D0*ir
+         rm(ir) = ast_shiftmap( 1, shift, ' ', status )
+      end do
+
+*  The forward selector uses the input value. The inverse transformation
+*  of the inverse selector divides the output value by 101, which rounds
+*  to the route index.
+      fs = ast_unitmap( 1, ' ', status )
+      is = ast_zoommap( 1, 101.0D0, ' ', status )
+      swm = ast_switchmap( fs, is, nr, rm, ' ', status )
+
+      do k = 1, np
+         x(k) = 0.3D0 + mod( k*37, 21000 )*0.001D0
+      end do
+      x(10) = AST__BAD
+
+      call ast_tran1( swm, np, x, .true., y, status )
+      call ast_tran1( swm, np, y, .false., x2, status )
+      if( status .ne. sai__ok ) go to 10
+
+      do k = 1, np
+         if( x(k) .eq. AST__BAD ) then
+            ir = 0
+         else
+            ir = nint( x(k) )
+         end if
+
+         if( ir .lt. 1 .or. ir .gt. nr ) then
+            if( y(k) .ne. AST__BAD ) then
+               call stopit( 200, y(k), status )
+            else if( x2(k) .ne. AST__BAD ) then
+               call stopit( 201, x2(k), status )
+            end if
+         else if( y(k) .ne. x(k) + 100.0D0*ir ) then
+            call stopit( 202, y(k), status )
+         else if( abs( x2(k) - x(k) ) .gt. 1.0D-9 ) then
+            call stopit( 203, x2(k), status )
+         end if
+
+         if( status .ne. sai__ok ) then
+            write(*,*) k, x(k), y(k), x2(k)
+            go to 10
+         end if
+      end do
+
+ 10   continue
+      call ast_end( status )
+
+      end
+
+
+
       subroutine stopit( i, r, status )
       implicit none
       include 'SAE_PAR'
@@ -594,6 +672,85 @@ c      call ast_watchmemory(22617)
 
 
 
+      subroutine testselector( status )
+      implicit none
+      include 'SAE_PAR'
+      include 'AST_PAR'
+
+      integer status, frm, mm, zm, reg(3), sm, i, j, k, n, iexp(441)
+      double precision c(2), r, p1(2), p2(2), in(441,2), out(441),
+     :                 rout(441,2)
+      character fwd(2)*30, inv(2)*30
+
+      if( status .ne. sai__ok ) return
+
+*  Two Circles mapped into a Frame in which the first axis is an
+*  exponential function of the first base Frame axis, followed by a Box
+*  that has been scaled by a ZoomMap.
+      frm = ast_frame( 2, ' ', status )
+      fwd(1) = 'xo=exp(xi/10)'
+      fwd(2) = 'yo=yi'
+      inv(1) = 'xi=10*log(xo)'
+      inv(2) = 'yi=yo'
+      mm = ast_mathmap( 2, 2, 2, fwd, 2, inv, ' ', status )
+
+      c(1) = 5.0
+      c(2) = 5.0
+      r = 3.0
+      reg(1) = ast_mapregion( ast_circle( frm, 1, c, r, AST__NULL, ' ',
+     :                                    status ), mm, frm, status )
+      c(1) = 12.0
+      reg(2) = ast_mapregion( ast_circle( frm, 1, c, r, AST__NULL, ' ',
+     :                                    status ), mm, frm, status )
+
+      zm = ast_zoommap( 2, 0.5D0, ' ', status )
+      p1(1) = 2.0
+      p1(2) = 0.0
+      p2(1) = 8.0
+      p2(2) = 4.0
+      reg(3) = ast_mapregion( ast_box( frm, 1, p1, p2, AST__NULL, ' ',
+     :                                 status ), zm, frm, status )
+
+      sm = ast_selectormap( 3, reg, AST__BAD, ' ', status )
+
+*  Transform a grid of points covering all three Regions, and check each
+*  result against the first Region found to contain the point when the
+*  Regions are used directly.
+      n = 0
+      do i = 0, 20
+         do j = 0, 20
+            n = n + 1
+            in(n,1) = 1.0 + 0.2*i
+            in(n,2) = 0.5*j
+         end do
+      end do
+      in(1,1) = AST__BAD
+
+      call ast_trann( sm, n, 2, 441, in, .true., 1, 441, out, status )
+
+      do i = 1, n
+         iexp(i) = 0
+      end do
+
+      do k = 3, 1, -1
+         call ast_trann( reg(k), n, 2, 441, in, .true., 2, 441, rout,
+     :                   status )
+         do i = 1, n
+            if( rout(i,1) .ne. AST__BAD ) iexp(i) = k
+         end do
+      end do
+
+      do i = 2, n
+         if( nint( out(i) ) .ne. iexp(i) ) then
+            call stopit( 155, out(i), status )
+            return
+         end if
+      end do
+
+      if( out(1) .ne. AST__BAD ) call stopit( 156, out(1), status )
+
+      end
+
       subroutine checkdump( obj, text, status )
 
       implicit none
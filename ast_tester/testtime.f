@@ -7,12 +7,18 @@
       character txt*40
       double precision xin, xout, xout2, ct, ctl, origin
       integer status, tf, tf1, tf2, fs, n, chr_len, nc
+      logical badleap
       status = sai__ok
 
       call ast_begin( status )
 
 c      call ast_SetWatchId( 740050 )
 
+*  Test any leap second file specified by AST_LEAP_SECONDS. If the file
+*  cannot be read, all UTC conversions fail, so skip the other tests.
+      call checkleap( badleap, status )
+      if( badleap ) go to 10
+
 c
 c Test default attribute values
 c
@@ -790,6 +796,7 @@ c
 
 
 
+ 10   continue
 
       call ast_end( status )
 c      call ast_listissued( 'testtime' )
@@ -804,6 +811,102 @@ c      call ast_listissued( 'testtime' )
 
       end
 
+      subroutine checkleap( badleap, status )
+      implicit none
+      include 'SAE_PAR'
+      include 'AST_PAR'
+      include 'AST_ERR'
+
+      logical badleap, there
+      integer status, tf1, tf2, fs, i
+      character path*200
+      double precision xin, xout, dat
+
+      badleap = .false.
+      if( status .ne. sai__ok ) return
+
+*  See if a leap second file has been specified. If not, the built-in
+*  table is used, which has no leap seconds after 2017. The file used
+*  by ast_tester (leapsec.dat) adds a leap second at 2030 January 1.
+      path = ' '
+      call err_mark
+      call psx_getenv( 'AST_LEAP_SECONDS', path, status )
+      if( status .ne. sai__ok ) then
+         call err_annul( status )
+         path = ' '
+      end if
+      call err_rlse
+
+      there = .false.
+      if( path .ne. ' ' ) inquire( file = path, exist = there )
+      badleap = ( path .ne. ' ' .and. .not. there )
+
+*  If the file is missing, every attempt to convert a UTC value should
+*  report an error, not just the first.
+      if( badleap ) then
+         xin = 62503.0D0
+         do i = 1, 2
+            if( status .eq. sai__ok ) then
+               call err_mark
+               tf1 = ast_timeframe( 'system=mjd,timescale=utc', status )
+               tf2 = ast_timeframe( 'system=mjd,timescale=tai', status )
+               fs = ast_convert( tf1, tf2, ' ', status )
+               call ast_tran1( fs, 1, xin, .true., xout, status )
+               if( status .eq. AST__RDERR ) then
+                  call err_annul( status )
+               else
+                  call err_rlse
+                  call stopit( status, 'error leap 1' )
+                  return
+               end if
+               call err_rlse
+            end if
+         end do
+         return
+      end if
+
+*  Otherwise, check TAI-UTC either side of 2030 January 1, and check the
+*  inverse conversion.
+      tf1 = ast_timeframe( 'system=mjd,timescale=utc', status )
+      tf2 = ast_timeframe( 'system=mjd,timescale=tai', status )
+      fs = ast_convert( tf1, tf2, ' ', status )
+      if( fs .eq. AST__NULL ) then
+         call stopit( status, 'error leap 2' )
+         return
+      end if
+
+      if( path .eq. ' ' ) then
+         dat = 37.0D0
+      else
+         dat = 38.0D0
+      end if
+
+      xin = 62503.0D0
+      call ast_tran1( fs, 1, xin, .true., xout, status )
+      if( abs( ( xout - xin )*86400.0D0 - dat ) .gt. 1.0D-3 ) then
+         write(*,*) ( xout - xin )*86400.0D0, dat
+         call stopit( status, 'error leap 3' )
+      end if
+
+      call ast_tran1( fs, 1, xout, .false., xin, status )
+      if( abs( xin - 62503.0D0 )*86400.0D0 .gt. 1.0D-3 ) then
+         write(*,*) xin
+         call stopit( status, 'error leap 4' )
+      end if
+
+      xin = 62501.0D0
+      call ast_tran1( fs, 1, xin, .true., xout, status )
+      if( abs( ( xout - xin )*86400.0D0 - 37.0D0 ) .gt. 1.0D-3 ) then
+         write(*,*) ( xout - xin )*86400.0D0
+         call stopit( status, 'error leap 5' )
+      end if
+
+      call ast_annul( fs, status )
+      call ast_annul( tf1, status )
+      call ast_annul( tf2, status )
+
+      end
+
       subroutine stopit( status, text )
       implicit none
       include 'SAE_PAR'
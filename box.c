@@ -132,6 +132,7 @@ f     The Box class does not define any new routines beyond those
 #include "region.h"              /* Coordinate regions (parent class) */
 #include "channel.h"             /* I/O channels */
 #include "box.h"                 /* Interface definition for this class */
+#include "skyframe.h"            /* Celestial coordinate systems */
 #include "polygon.h"             /* Interface definition for this class */
 #include "mapping.h"             /* Position mappings */
 #include "unitmap.h"             /* Unit Mappings */
@@ -223,6 +224,7 @@ static int GetObjSize( AstObject *, int * );
 static int MakeGrid( int, double **, int, double *, double *, int *, int, int, double, int * );
 static int MapMerge( AstMapping *, int, int, int *, AstMapping ***, int **, int * );
 static int RegPins( AstRegion *, AstPointSet *, AstRegion *, int **, int * );
+static int RegLineCross( AstRegion *, const double[], const double[], double **, int * );
 static int RegTrace( AstRegion *, int, double *, double **, int * );
 static void BoxPoints( AstBox *, double *, double *, int *);
 static void Cache( AstBox *, int, int * );
@@ -1246,6 +1248,7 @@ void astInitBoxVtab_(  AstBoxVtab *vtab, const char *name, int *status ) {
    region->RegBasePick = RegBasePick;
    region->RegBaseBox = RegBaseBox;
    region->RegPins = RegPins;
+   region->RegLineCross = RegLineCross;
    region->RegTrace = RegTrace;
    region->RegCentre = RegCentre;
 
@@ -3209,6 +3212,122 @@ static int RegPins( AstRegion *this_region, AstPointSet *pset, AstRegion *unc,
    return result;
 }
 
+static int RegLineCross( AstRegion *this_region, const double start[],
+                         const double step[], double **cross, int *status ){
+/*
+*+
+*  Name:
+*     RegLineCross
+
+*  Purpose:
+*     Find where a straight line crosses the boundary of a 2D Region.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "box.h"
+*     int RegLineCross( AstRegion *this, const double start[],
+*                       const double step[], double **cross, int *status )
+
+*  Class Membership:
+*     Box member function (overrides the astRegLineCross method
+*     inherited from the parent Region class).
+
+*  Description:
+*     This function finds the places at which a straight line in the
+*     base Frame of a 2-dimensional Region may cross the boundary of the
+*     Region. The line is given by "start + t*step", where "t" is a
+*     scalar parameter, and the returned positions are expressed as
+*     values of "t".
+*
+*     The boundary of a Box in a Cartesian base Frame is made of lines
+*     of constant axis value, and so the line is crossed wherever one of
+*     its axis values equals the upper or lower limit on that axis.
+
+*  Parameters:
+*     this
+*        Pointer to the Region.
+*     start
+*        The base Frame axis values at "t = 0".
+*     step
+*        The change in the base Frame axis values per unit increase
+*        in "t".
+*     cross
+*        Address at which to return a pointer to a newly allocated array
+*        holding the lower and upper "t" values of each crossing
+*        interval. It should be freed using astFree when no longer
+*        needed. A NULL pointer is returned if no crossings are found, or
+*        if the method cannot be used.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The number of crossings found, or -1 if the method cannot be used
+*     with the base Frame of the Region.
+
+*-
+*/
+
+/* Local Variables; */
+   AstBox *this;
+   AstFrame *frm;
+   double t;
+   int i;
+   int result;
+
+/* Initialise */
+   *cross = NULL;
+   result = -1;
+
+/* Check inherited status. */
+   if( ! astOK ) return result;
+
+/* Get a pointer to the Box structure. */
+   this = (AstBox *) this_region;
+
+/* The edges are only lines of constant axis value if the base Frame is a
+   2-dimensional Cartesian Frame. */
+   frm = astGetFrame( this_region->frameset, AST__BASE );
+   if( astGetNaxes( frm ) == 2 && !astIsASkyFrame( frm ) &&
+       !astIsARegion( frm ) && !astIsAFrameSet( frm ) ) {
+
+/* Ensure the cached limits are those used by the astTransform method. */
+      Cache( this, 1, status );
+
+/* Allocate room for two crossings on each axis. */
+      *cross = astMalloc( sizeof( double )*8 );
+      if( astOK ) {
+         result = 0;
+
+/* The line crosses the lower and upper limits on each axis along which
+   it is not parallel. */
+         for( i = 0; i < 2; i++ ) {
+            if( step[ i ] != 0.0 ) {
+               t = ( this->lo[ i ] - start[ i ] )/step[ i ];
+               (*cross)[ 2*result ] = t;
+               (*cross)[ 2*result + 1 ] = t;
+               result++;
+               t = ( this->hi[ i ] - start[ i ] )/step[ i ];
+               (*cross)[ 2*result ] = t;
+               (*cross)[ 2*result + 1 ] = t;
+               result++;
+            }
+         }
+      }
+   }
+   frm = astAnnul( frm );
+
+/* Return -1 if an error occurred. */
+   if( !astOK ) {
+      *cross = astFree( *cross );
+      result = -1;
+   }
+
+/* Return the result. */
+   return result;
+}
+
 static int RegTrace( AstRegion *this_region, int n, double *dist, double **ptr,
                      int *status ){
 /*
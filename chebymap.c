@@ -3,8 +3,6 @@
    - what to do about input positions that fall outside the bounding box.
    Have an attribute that can be used to select "set bad" or "extrapolate"?
 
-   - what about overriding astRate ?
-
    - Providing an iterative inverse requires the Jacobian to be defined.
 
      for a PolyMap:   if y = C.x^n     then y' = n.C.x^n-1
@@ -180,6 +178,7 @@ static int class_check;
 static int (* parent_getobjsize)( AstObject *, int * );
 static int (* parent_equal)( AstObject *, AstObject *, int * );
 static void (* parent_polypowers)( AstPolyMap *, double **, int, const int *, double **, int, int, int * );
+static void (* parent_polyrates)( AstPolyMap *, double *, int, int, double, int, int * );
 static AstPolyMap *(*parent_polytran)( AstPolyMap *, int, double, double, int, const double *, const double *, int * );
 
 
@@ -229,6 +228,7 @@ static void Copy( const AstObject *, AstObject *, int * );
 static void Delete( AstObject *obj, int * );
 static void Dump( AstObject *, AstChannel *, int * );
 static void PolyPowers( AstPolyMap *, double **, int, const int *, double **, int, int, int *);
+static void PolyRates( AstPolyMap *, double *, int, int, double, int, int * );
 static void FitPoly1DInit( AstPolyMap *, int, double **, AstMinPackData *, double *, int *);
 static void FitPoly2DInit( AstPolyMap *, int, double **, AstMinPackData *, double *, int *);
 
@@ -1027,6 +1027,9 @@ void astInitChebyMapVtab_(  AstChebyMapVtab *vtab, const char *name, int *status
    parent_polypowers = polymap->PolyPowers;
    polymap->PolyPowers = PolyPowers;
 
+   parent_polyrates = polymap->PolyRates;
+   polymap->PolyRates = PolyRates;
+
    parent_polytran = polymap->PolyTran;
    polymap->PolyTran = PolyTran;
 
@@ -1187,6 +1190,102 @@ static void PolyPowers( AstPolyMap *this_polymap, double **work, int ncoord,
    }
 }
 
+static void PolyRates( AstPolyMap *this_polymap, double *work, int coord,
+                       int mxpow, double x, int fwd, int *status ){
+/*
+*  Name:
+*     PolyRates
+
+*  Purpose:
+*     Find the derivatives of the required powers of an input axis value.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "chebymap.h"
+*     void PolyRates( AstPolyMap *this, double *work, int coord, int mxpow,
+*                     double x, int fwd, int *status )
+
+*  Class Membership:
+*     ChebyMap member function (over-rides the astPolyRates protected
+*     method inherited from the PolyMap class).
+
+*  Description:
+*     This function is used by astRate to calculate the rate of change
+*     of each of the quantities returned by astPolyPowers for a single
+*     input axis, with respect to the input axis value. For a ChebyMap,
+*     element "i" of the returned array is the derivative of the
+*     Chebyshev polynomial of the first kind of degree "i", evaluated at
+*     the scaled axis value. This is "i" times the Chebyshev polynomial of
+*     the second kind of degree "i-1", multiplied by the axis scale factor.
+
+*  Parameters:
+*     this
+*        Pointer to the PolyMap.
+*     work
+*        An array of length "max(2,mxpow+1)". The required values are
+*        placed in this array on exit.
+*     coord
+*        The zero based index of the input axis.
+*     mxpow
+*        The maximum power required of the axis value.
+*     x
+*        The input axis value. Should not be AST__BAD.
+*     fwd
+*        Do the supplied coefficients define the foward transformation of
+*        the PolyMap?
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Variables; */
+   AstChebyMap *this;
+   double scale;
+   double u0;
+   double u1;
+   double u2;
+   int ip;
+
+/* Check the local error status. */
+   if ( !astOK ) return;
+
+/* Get a pointer to the ChebyMap structure. */
+   this = (AstChebyMap *) this_polymap;
+
+/* If the coefficients relate to a standard polynomial, then invoke the
+   astPolyRates implementation of the parent class (PolyMap). */
+   if( (fwd && !this->scale_f) || (!fwd && !this->scale_i) ) {
+      (*parent_polyrates)( this_polymap, work, coord, mxpow, x, fwd, status );
+
+/* If the coefficients relate to a Chebyshev polynomial, scale and shift
+   the input value into the range [-1,+1]. The Chebyshev function of degree
+   zero is constant. Return bad values for input positions outside the
+   bounding box associated with the transformation, as is done by
+   PolyPowers. */
+   } else {
+      scale = fwd ? this->scale_f[ coord ] : this->scale_i[ coord ];
+      x = x*scale + ( fwd ? this->offset_f[ coord ] : this->offset_i[ coord ] );
+      work[ 0 ] = 0.0;
+      if( fabs( x ) <= 1.0 ) {
+
+/* Form the Chebyshev polynomials of the second kind using the standard
+   recurrence relation: Un+1(x') = 2.x'.Un(x') - Un-1(x'), starting with
+   U-1(x') = 0 and U0(x') = 1. */
+         u0 = 0.0;
+         u1 = 1.0;
+         for( ip = 1; ip <= mxpow; ip++ ) {
+            work[ ip ] = ip*u1*scale;
+            u2 = 2.0*x*u1 - u0;
+            u0 = u1;
+            u1 = u2;
+         }
+      } else {
+         for( ip = 1; ip <= mxpow; ip++ ) work[ ip ] = AST__BAD;
+      }
+   }
+}
+
 static AstPolyMap *PolyTran( AstPolyMap *this_polymap, int forward, double acc,
                              double maxacc, int maxorder, const double *lbnd,
                              const double *ubnd, int *status ){
@@ -72,6 +72,12 @@ f     - AST_CIRCLEPARS: Get the geometric parameters of the Circle
    "protected" symbols available. */
 #define astCLASS Circle
 
+/* The margin by which the cosine of the distance from the centre of a
+   Circle on the sky must differ from the cosine of the radius for a point
+   to be classified using a dot product alone. Points closer to the
+   boundary than this are classified using astDistance. */
+#define DOT_TOL 1.0E-12
+
 /* Include files. */
 /* ============== */
 /* Interface definitions. */
@@ -87,6 +93,7 @@ f     - AST_CIRCLEPARS: Get the geometric parameters of the Circle
 #include "box.h"                 /* Box Regions */
 #include "wcsmap.h"              /* Definitons of AST__DPI etc */
 #include "circle.h"              /* Interface definition for this class */
+#include "skyframe.h"            /* Celestial coordinate systems */
 #include "ellipse.h"             /* Interface definition for ellipse class */
 #include "mapping.h"             /* Position mappings */
 #include "unitmap.h"             /* Unit Mapping */
@@ -159,6 +166,7 @@ static AstPointSet *Transform( AstMapping *, AstPointSet *, int, AstPointSet *,
 static double *CircumPoint( AstFrame *, int, const double *, double, int * );
 static double *RegCentre( AstRegion *this, double *, double **, int, int, int * );
 static int RegPins( AstRegion *, AstPointSet *, AstRegion *, int **, int * );
+static int RegLineCross( AstRegion *, const double[], const double[], double **, int * );
 static int RegTrace( AstRegion *, int, double *, double **, int * );
 static void Cache( AstCircle *, int * );
 static void CalcPars( AstFrame *, AstPointSet *, double *, double *, double *, int * );
@@ -729,6 +737,7 @@ void astInitCircleVtab_(  AstCircleVtab *vtab, const char *name, int *status ) {
    region->ResetCache = ResetCache;
 
    region->RegPins = RegPins;
+   region->RegLineCross = RegLineCross;
    region->RegTrace = RegTrace;
    region->RegBaseMesh = RegBaseMesh;
    region->RegBaseBox = RegBaseBox;
@@ -1539,6 +1548,127 @@ static int RegPins( AstRegion *this_region, AstPointSet *pset, AstRegion *unc,
    return result;
 }
 
+static int RegLineCross( AstRegion *this_region, const double start[],
+                         const double step[], double **cross, int *status ){
+/*
+*+
+*  Name:
+*     RegLineCross
+
+*  Purpose:
+*     Find where a straight line crosses the boundary of a 2D Region.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "circle.h"
+*     int RegLineCross( AstRegion *this, const double start[],
+*                       const double step[], double **cross, int *status )
+
+*  Class Membership:
+*     Circle member function (overrides the astRegLineCross method
+*     inherited from the parent Region class).
+
+*  Description:
+*     This function finds the places at which a straight line in the
+*     base Frame of a 2-dimensional Region may cross the boundary of the
+*     Region. The line is given by "start + t*step", where "t" is a
+*     scalar parameter, and the returned positions are expressed as
+*     values of "t".
+*
+*     The crossings of a Circle in a Cartesian base Frame are the roots
+*     of a quadratic equation in "t". If the line misses the Circle, the
+*     point of closest approach is returned instead, to guard against
+*     rounding errors when the line is close to a tangent.
+
+*  Parameters:
+*     this
+*        Pointer to the Region.
+*     start
+*        The base Frame axis values at "t = 0".
+*     step
+*        The change in the base Frame axis values per unit increase
+*        in "t".
+*     cross
+*        Address at which to return a pointer to a newly allocated array
+*        holding the lower and upper "t" values of each crossing
+*        interval. It should be freed using astFree when no longer
+*        needed. A NULL pointer is returned if no crossings are found, or
+*        if the method cannot be used.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The number of crossings found, or -1 if the method cannot be used
+*     with the base Frame of the Region.
+
+*-
+*/
+
+/* Local Variables; */
+   AstCircle *this;
+   AstFrame *frm;
+   double a;
+   double b;
+   double c;
+   double d0[ 2 ];
+   double disc;
+   int result;
+
+/* Initialise */
+   *cross = NULL;
+   result = -1;
+
+/* Check inherited status. */
+   if( ! astOK ) return result;
+
+/* Get a pointer to the Circle structure. */
+   this = (AstCircle *) this_region;
+
+/* The boundary is only a conic section if the base Frame is a
+   2-dimensional Cartesian Frame. */
+   frm = astGetFrame( this_region->frameset, AST__BASE );
+   if( astGetNaxes( frm ) == 2 && !astIsASkyFrame( frm ) &&
+       !astIsARegion( frm ) && !astIsAFrameSet( frm ) ) {
+
+/* Ensure cached information is available. */
+      Cache( this, status );
+
+/* Form the coefficients of the quadratic "a*t*t + b*t + c = 0" giving
+   the values of "t" at which the line is at a distance "radius" from
+   the centre. */
+      d0[ 0 ] = start[ 0 ] - this->centre[ 0 ];
+      d0[ 1 ] = start[ 1 ] - this->centre[ 1 ];
+      a = step[ 0 ]*step[ 0 ] + step[ 1 ]*step[ 1 ];
+      b = 2.0*( d0[ 0 ]*step[ 0 ] + d0[ 1 ]*step[ 1 ] );
+      c = d0[ 0 ]*d0[ 0 ] + d0[ 1 ]*d0[ 1 ] - this->radius*this->radius;
+
+/* Store the two roots, or the point of closest approach if there are no
+   real roots. */
+      if( a > 0.0 ) {
+         *cross = astMalloc( sizeof( double )*4 );
+         if( astOK ) {
+            disc = b*b - 4.0*a*c;
+            disc = ( disc > 0.0 ) ? sqrt( disc ) : 0.0;
+            (*cross)[ 0 ] = (*cross)[ 1 ] = ( -b - disc )/( 2.0*a );
+            (*cross)[ 2 ] = (*cross)[ 3 ] = ( -b + disc )/( 2.0*a );
+            result = 2;
+         }
+      }
+   }
+   frm = astAnnul( frm );
+
+/* Return -1 if an error occurred. */
+   if( !astOK ) {
+      *cross = astFree( *cross );
+      result = -1;
+   }
+
+/* Return the result. */
+   return result;
+}
+
 static int RegTrace( AstRegion *this_region, int n, double *dist, double **ptr,
                      int *status ){
 /*
@@ -1960,6 +2090,13 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
 *     PointSet and transforms the points by setting axis values to
 *     AST__BAD for all points which are outside the region. Points inside
 *     the region are copied unchanged from input to output.
+*
+*     If the Circle is defined within a SkyFrame, the cosine of the
+*     distance from the centre to each point is found from the dot product
+*     of their unit vectors, and compared with the cosine of the radius.
+*     This avoids the cost of calling astDistance for each point. Only
+*     points very close to the boundary are passed to astDistance, so that
+*     the results are identical to those of the general case.
 
 *  Parameters:
 *     this
@@ -2000,15 +2137,24 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
    double **ptr_out;             /* Pointer to output coordinate data */
    double **ptr_tmp;             /* Pointer to base Frame coordinate data */
    double *work;                 /* Pointer to array holding single base point */
+   double cl;                    /* Cosine of latitude */
+   double cosrad;                /* Cosine of the radius */
+   double cvec[ 3 ];             /* Unit vector at the centre */
    double d;                     /* Base-Frame distance from centre to point */
+   double dot;                   /* Cosine of distance from centre to point */
+   double lat;                   /* Latitude of point */
+   double lon;                   /* Longitude of point */
    int closed;                   /* Is the boundary part of the Region? */
    int coord;                    /* Zero-based index for coordinates */
+   int ilat;                     /* Index of latitude axis */
+   int ilon;                     /* Index of longitude axis */
    int inside;                   /* Is the point inside the Region? */
    int ncoord_out;               /* No. of coordinates per output point */
    int ncoord_tmp;               /* No. of coordinates per base Frame point */
    int neg;                      /* Has the Region been negated? */
    int npoint;                   /* No. of points */
    int point;                    /* Loop counter for points */
+   int sky;                      /* Use dot products to classify points? */
 
 /* Check the global error status. */
    if ( !astOK ) return NULL;
@@ -2059,17 +2205,60 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
 /* Ensure cached information is available. */
       Cache( this, status );
 
+/* If the base Frame is a SkyFrame, and the Circle has a usable centre and
+   radius, get the unit vector at the centre, and the cosine of the radius.
+   The cosine of the distance decreases monotonically with distance
+   only if the radius is less than PI. */
+      sky = 0;
+      ilon = 0;
+      ilat = 1;
+      cosrad = 0.0;
+      if( astIsASkyFrame( frm ) && this->centre[ 0 ] != AST__BAD &&
+          this->centre[ 1 ] != AST__BAD && this->radius != AST__BAD &&
+          this->radius >= 0.0 && this->radius < AST__DPI ) {
+         sky = 1;
+         ilon = astGetLonAxis( (AstSkyFrame *) frm );
+         ilat = 1 - ilon;
+         cl = cos( this->centre[ ilat ] );
+         cvec[ 0 ] = cl*cos( this->centre[ ilon ] );
+         cvec[ 1 ] = cl*sin( this->centre[ ilon ] );
+         cvec[ 2 ] = sin( this->centre[ ilat ] );
+         cosrad = cos( this->radius );
+      }
+
 /* Loop round each point */
       for ( point = 0; point < npoint; point++ ) {
 
-/* Copy the base Frame position into a work array. */
-         for ( coord = 0; coord < ncoord_tmp; coord++ ) {
-            work[ coord ] = ptr_tmp[ coord ][ point ];
+/* If possible, compare the dot product of the unit vectors at the point
+   and the centre with the cosine of the radius. Points well inside the
+   Circle are given a distance of -1, and points well outside are given a
+   distance of 2.PI. Bad points are given a bad distance, as returned by
+   astDistance. */
+         d = AST__BAD;
+         dot = AST__BAD;
+         if( sky ) {
+            lon = ptr_tmp[ ilon ][ point ];
+            lat = ptr_tmp[ ilat ][ point ];
+            if( lon != AST__BAD && lat != AST__BAD ) {
+               cl = cos( lat );
+               dot = cl*cos( lon )*cvec[ 0 ] + cl*sin( lon )*cvec[ 1 ] +
+                     sin( lat )*cvec[ 2 ];
+               if( dot > cosrad + DOT_TOL ) {
+                  d = -1.0;
+               } else if( dot < cosrad - DOT_TOL ) {
+                  d = 2*AST__DPI;
+               }
+            }
          }
 
-/* Find the geodesic distance from the centre of the Circle in the base
-   Frame. */
-         d = astDistance( frm, this->centre, work );
+/* Otherwise, copy the base Frame position into a work array and find the
+   geodesic distance from the centre of the Circle in the base Frame. */
+         if( !sky || ( d == AST__BAD && dot != AST__BAD ) ) {
+            for ( coord = 0; coord < ncoord_tmp; coord++ ) {
+               work[ coord ] = ptr_tmp[ coord ][ point ];
+            }
+            d = astDistance( frm, this->centre, work );
+         }
 
 /* Now consider whether this radius value puts the point in or out of the
    Circle. */
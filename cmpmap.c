@@ -177,6 +177,9 @@ f     The CmpMap class does not define any new routines beyond those
 #include "unitmap.h"             /* Unit transformations */
 #include "cmpmap.h"              /* Interface definition for this class */
 #include "frameset.h"            /* Interface definition for FrameSets */
+#include "matrixmap.h"           /* Matrix transformations */
+#include "sphmap.h"              /* Cartesian to spherical transformations */
+#include "wcsmap.h"              /* FITS-WCS sky projections */
 #include "globals.h"             /* Thread-safe global data access */
 
 /* Error code definitions. */
@@ -202,6 +205,7 @@ static int (* parent_getobjsize)( AstObject *, int * );
 static AstPointSet *(* parent_transform)( AstMapping *, AstPointSet *, int, AstPointSet *, int * );
 static int (* parent_maplist)( AstMapping *, int, int, int *, AstMapping ***, int **, int * );
 static int *(* parent_mapsplit)( AstMapping *, int, const int *, AstMapping **, int * );
+static double (* parent_rate)( AstMapping *, double *, int, int, int * );
 
 #if defined(THREAD_SAFE)
 static int (* parent_managelock)( AstObject *, int, int, AstObject **, int * );
@@ -256,6 +260,7 @@ static AstMapping *RemoveRegions( AstMapping *, int * );
 static AstMapping *Simplify( AstMapping *, int * );
 static AstPointSet *Transform( AstMapping *, AstPointSet *, int, AstPointSet *, int * );
 static double Rate( AstMapping *, double *, int, int, int * );
+static int RateIsExact( AstMapping *, int * );
 static int *MapSplit( AstMapping *, int, const int *, AstMapping **, int * );
 static int *MapSplit0( AstMapping *, int, const int *, AstMapping **, int, int * );
 static int *MapSplit1( AstMapping *, int, const int *, AstMapping **, int * );
@@ -265,6 +270,8 @@ static int GetIsLinear( AstMapping *, int * );
 static int MapList( AstMapping *, int, int, int *, AstMapping ***, int **, int * );
 static int MapMerge( AstMapping *, int, int, int *, AstMapping ***, int **, int * );
 static int PatternCheck( int, int, int **, int *, int * );
+static int SeriesLeaves( AstCmpMap *, int, int, AstMapping **, int *, int *, int * );
+static int SkyRot( AstCmpMap *, int, AstPointSet *, AstPointSet *, int * );
 static void Copy( const AstObject *, AstObject *, int * );
 static void Decompose( AstMapping *, AstMapping **, AstMapping **, int *, int *, int *, int * );
 static void Delete( AstObject *, int * );
@@ -866,6 +873,9 @@ void astInitCmpMapVtab_(  AstCmpMapVtab *vtab, const char *name, int *status ) {
    parent_mapsplit = mapping->MapSplit;
    mapping->MapSplit = MapSplit;
 
+   parent_rate = mapping->Rate;
+   mapping->Rate = Rate;
+
 /* Store replacement pointers for methods which will be over-ridden by
    new member functions implemented here. */
    object->Equal = Equal;
@@ -874,13 +884,7 @@ void astInitCmpMapVtab_(  AstCmpMapVtab *vtab, const char *name, int *status ) {
    mapping->Simplify = Simplify;
    mapping->RemoveRegions = RemoveRegions;
    mapping->GetIsLinear = GetIsLinear;
-
-/* For some reason the CmpMap implementation of astRate can be immensely
-   slow for complex Mapping, so it's currently disable until such time as
-   I have time to sort it out.
-
-   mapping->Rate = Rate;
-*/
+   mapping->RateIsExact = RateIsExact;
 
 /* Declare the copy constructor, destructor and class dump function. */
    astSetCopy( vtab, Copy );
@@ -2993,6 +2997,17 @@ static double Rate( AstMapping *this, double *at, int ax1, int ax2, int *status
 *     This function returns the rate of change of a specified output of
 *     the supplied Mapping with respect to a specified input, at a
 *     specified input position.
+*
+*     For a series CmpMap in which any component Mapping estimates its
+*     rates numerically, the rate is estimated numerically for the CmpMap
+*     as a whole, since this requires fewer evaluations of the expensive
+*     components. Otherwise, the CmpMap is first decomposed into a list of
+*     component Mappings applied in series. A vector holding the rate of
+*     change of every intermediate axis with respect to input "ax2" is
+*     then propagated through the list using the chain rule, together
+*     with the position at which the next component is evaluated. Each
+*     component is therefore visited only once, and its astRate method is
+*     only invoked for inputs upon which the propagated vector depends.
 
 *  Parameters:
 *     this
@@ -3020,19 +3035,32 @@ static double Rate( AstMapping *this, double *at, int ax1, int ax2, int *status
 */
 
 /* Local Variables: */
-   AstMapping *c1;
-   AstMapping *c2;
    AstCmpMap *map;
+   AstMapping **map_list;
+   AstMapping *cmap;
+   double *pos;
+   double *pos2;
+   double *tmp;
+   double *vec;
+   double *vec2;
+   double r;
    double result;
-   int old_inv1;
-   int old_inv2;
+   double sum;
+   int *invert_list;
+   int bad;
+   int i;
+   int imap;
+   int j;
+   int last;
+   int maxdim;
+   int nin;
    int nin1;
-   int nin2;
-   double *at2;
-   double r1;
-   double r2;
+   int nmap;
+   int nout;
    int nout1;
-   int i;
+   int old_inv;
+   int old_inv1;
+   int old_inv2;
 
 /* Check inherited status */
    if( !astOK ) return AST__BAD;
@@ -3040,71 +3068,127 @@ static double Rate( AstMapping *this, double *at, int ax1, int ax2, int *status
 /* Get a pointer to the CmpMap structure. */
    map = (AstCmpMap *) this;
 
-/* Note the current Invert flags of the two component Mappings. */
-   old_inv1 = astGetInvert( map->map1 );
-   old_inv2 = astGetInvert( map->map2 );
+/* If the CmpMap is in series and any component Mapping has a numerical
+   astRate method, use the numerical estimate provided by the parent
+   class. */
+   if( map->series && !astRateIsExact( this ) ) {
+      result = (*parent_rate)( this, at, ax1, ax2, status );
 
-/* Temporarily reset them to the values they had when the CmpMap was
-   created. */
-   astSetInvert( map->map1, map->invert1 );
-   astSetInvert( map->map2, map->invert2 );
-
-/* If the CmpMap itself has been inverted, invert the component Mappings.
-   Also note the order in which the Mappings should be applied if in series. */
-   if( !astGetInvert( this ) ) {
-      c1 = map->map1;
-      c2 = map->map2;
-   } else {
-      c1 = map->map2;
-      c2 = map->map1;
-      astInvert( c1 );
-      astInvert( c2 );
-   }
+/* Otherwise, deal with Mappings in series. */
+   } else if( map->series ) {
 
-/* First deal with Mappings in series. */
-   if( map->series ) {
-
-/* Get the number of inputs to the two component Mappings. */
-      nin1 = astGetNin( c1 );
-      nin2 = astGetNin( c2 );
-
-/* Allocate workspace to hold the result of transforming the supplied "at"
-   position using the first component. */
-      at2 = astMalloc( sizeof( double )*(size_t) nin2 );
-
-/* Transform the supplied "at" position using the first component. */
-      astTranN( c1, 1, nin1, 1, at, 1, nin2, 1, at2 );
+/* Decompose the CmpMap into a sequence of Mappings to be applied in
+   series, and an associated list of Invert flags. */
+      nmap = 0;
+      map_list = NULL;
+      invert_list = NULL;
+      astMapList( this, 1, astGetInvert( this ), &nmap, &map_list,
+                  &invert_list );
+
+/* Find the largest number of axes used by any component, and allocate
+   work arrays to hold positions and rate vectors. */
+      maxdim = astGetNin( this );
+      for( imap = 0; imap < nmap; imap++ ) {
+         nout = astGetNout( map_list[ imap ] );
+         if( nout > maxdim ) maxdim = nout;
+      }
+      pos = astMalloc( sizeof( double )*(size_t) maxdim );
+      pos2 = astMalloc( sizeof( double )*(size_t) maxdim );
+      vec = astMalloc( sizeof( double )*(size_t) maxdim );
+      vec2 = astMalloc( sizeof( double )*(size_t) maxdim );
+
+/* Initialise the position to the supplied position, and the vector of
+   rates to the unit vector along input "ax2". */
+      bad = 1;
+      if( astOK ) {
+         nin = astGetNin( this );
+         for( j = 0; j < nin; j++ ) {
+            pos[ j ] = at[ j ];
+            vec[ j ] = 0.0;
+         }
+         vec[ ax2 ] = 1.0;
+
+/* Loop round each component Mapping, temporarily setting its Invert flag
+   to the required value. */
+         bad = 0;
+         for( imap = 0; imap < nmap && !bad; imap++ ) {
+            cmap = map_list[ imap ];
+            old_inv = astGetInvert( cmap );
+            astSetInvert( cmap, invert_list[ imap ] );
+            nin = astGetNin( cmap );
+            nout = astGetNout( cmap );
+            last = ( imap == nmap - 1 );
+
+/* Find the rate of change of each output of the component with respect
+   to CmpMap input "ax2", using the chain rule. Only output "ax1" is
+   needed from the last component. */
+            for( i = 0; i < nout && !bad; i++ ) {
+               vec2[ i ] = 0.0;
+               if( last && i != ax1 ) continue;
+
+               sum = 0.0;
+               for( j = 0; j < nin; j++ ) {
+                  if( vec[ j ] != 0.0 ) {
+                     r = astRate( cmap, pos, i, j );
+                     if( r == AST__BAD ) {
+                        bad = 1;
+                        break;
+                     }
+                     sum += r*vec[ j ];
+                  }
+               }
+               vec2[ i ] = sum;
+            }
 
-/* The required rate of change is the sum of the products of the rate of
-   changes of the two component mappings, summed over all the output axes
-   of the first componment. */
-      result = 0.0;
-      for( i = 0; i < nin2; i++ ) {
+/* Transform the position using the component, ready for the next
+   component. */
+            if( !last && !bad ) {
+               astTranN( cmap, 1, nin, 1, pos, 1, nout, 1, pos2 );
+            }
 
-/* Find the rate of change of output "i" of the first component with
-   respect to input "ax2" at the supplied "at" position. */
-         r1 = astRate( c1, at, i, ax2 );
+/* Re-instate the original Invert flag, and swap the work arrays. */
+            astSetInvert( cmap, old_inv );
 
-/* Find the rate of change of output "ax1" of the second component with
-   respect to input "i" at the transformed "at2" position. */
-         r2 = astRate( c2, at2, ax1, i );
+            tmp = pos;
+            pos = pos2;
+            pos2 = tmp;
 
-/* If both are good, increment the ryunning total by the product of the
-   two rates. Otherwise, break. */
-         if( r1 != AST__BAD && r2 != AST__BAD ) {
-            result += r1*r2;
-         } else {
-            result = AST__BAD;
-            break;
+            tmp = vec;
+            vec = vec2;
+            vec2 = tmp;
          }
       }
 
-/* Free the workspace. */
-      at2 = astFree( at2 );
+/* Get the required rate. */
+      result = ( bad || !astOK ) ? AST__BAD : vec[ ax1 ];
+
+/* Free resources */
+      for( imap = 0; imap < nmap; imap++ ) {
+         map_list[ imap ] = astAnnul( map_list[ imap ] );
+      }
+      map_list = astFree( map_list );
+      invert_list = astFree( invert_list );
+      pos = astFree( pos );
+      pos2 = astFree( pos2 );
+      vec = astFree( vec );
+      vec2 = astFree( vec2 );
 
 /* Now deal with Mappings in parallel. */
    } else {
 
+/* Note the current Invert flags of the two component Mappings. */
+      old_inv1 = astGetInvert( map->map1 );
+      old_inv2 = astGetInvert( map->map2 );
+
+/* Temporarily reset them to the values they had when the CmpMap was
+   created, and then invert them if the CmpMap itself has been inverted. */
+      astSetInvert( map->map1, map->invert1 );
+      astSetInvert( map->map2, map->invert2 );
+      if( astGetInvert( this ) ) {
+         astInvert( map->map1 );
+         astInvert( map->map2 );
+      }
+
 /* Get the number of inputs and outputs for the lower component Mappings. */
       nin1 = astGetNin( map->map1 );
       nout1 = astGetNout( map->map1 );
@@ -3124,16 +3208,65 @@ static double Rate( AstMapping *this, double *at, int ax1, int ax2, int *status
       } else {
          result = 0.0;
       }
-   }
 
 /* Reinstate the original Invert flags of the component Mappings .*/
-   astSetInvert( map->map1, old_inv1 );
-   astSetInvert( map->map2, old_inv2 );
+      astSetInvert( map->map1, old_inv1 );
+      astSetInvert( map->map2, old_inv2 );
+   }
 
 /* Return the result. */
    return result;
 }
 
+static int RateIsExact( AstMapping *this, int *status ) {
+/*
+*  Name:
+*     RateIsExact
+
+*  Purpose:
+*     Check if the astRate method of a Mapping is exact.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "cmpmap.h"
+*     int RateIsExact( AstMapping *this, int *status )
+
+*  Class Membership:
+*     CmpMap member function (over-rides the protected astRateIsExact
+*     method inherited from the Mapping class).
+
+*  Description:
+*     This function returns a flag indicating if the astRate method of
+*     the supplied Mapping evaluates the rate of change analytically.
+*     The astRate method of a CmpMap combines the rates of its component
+*     Mappings, and so is exact only if both component Mappings have
+*     exact astRate methods.
+
+*  Parameters:
+*     this
+*        Pointer to the Mapping.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Non-zero if the astRate method of the supplied Mapping is exact, and
+*     zero otherwise.
+
+*/
+
+/* Local Variables: */
+   AstCmpMap *map;
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* Check both component Mappings. */
+   map = (AstCmpMap *) this;
+   return astRateIsExact( map->map1 ) && astRateIsExact( map->map2 );
+}
+
 static AstMapping *RemoveRegions( AstMapping *this_mapping, int *status ) {
 /*
 *  Name:
@@ -3299,6 +3432,109 @@ static AstMapping *RemoveRegions( AstMapping *this_mapping, int *status ) {
    return result;
 }
 
+static int SeriesLeaves( AstCmpMap *this, int forward, int maxmap,
+                         AstMapping **maps, int *fwds, int *nmap,
+                         int *status ){
+/*
+*  Name:
+*     SeriesLeaves
+
+*  Purpose:
+*     Find the Mappings applied in turn by a series CmpMap.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "cmpmap.h"
+*     int SeriesLeaves( AstCmpMap *this, int forward, int maxmap,
+*                       AstMapping **maps, int *fwds, int *nmap,
+*                       int *status )
+
+*  Class Membership:
+*     CmpMap member function
+
+*  Description:
+*     This function finds the sequence of Mappings that the Transform
+*     function would apply to transform points through a series CmpMap,
+*     expanding any nested series CmpMaps. Each Mapping is returned along
+*     with the "forward" value that would be passed to its astTransform
+*     method. Unlike astMapList, no new Object pointers are created and
+*     Invert attributes are not changed, so this function is cheap enough
+*     to be called every time points are transformed.
+
+*  Parameters:
+*     this
+*        Pointer to the series CmpMap.
+*     forward
+*        The direction in which the CmpMap is used, after allowing for
+*        its own Invert attribute.
+*     maxmap
+*        The maximum number of Mappings that may be returned.
+*     maps
+*        Array in which to return the Mapping pointers. These are not
+*        cloned, and so should not be annulled.
+*     fwds
+*        Array in which to return the "forward" value for each Mapping.
+*     nmap
+*        Pointer to the number of Mappings already stored in "maps" and
+*        "fwds". Updated on exit.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Zero if the CmpMap applies more than "maxmap" Mappings, or if it
+*     contains a parallel CmpMap. One otherwise.
+*/
+
+/* Local Variables: */
+   AstMapping *map;              /* Current component Mapping */
+   int forward1;                 /* Use forward direction for Mapping 1? */
+   int forward2;                 /* Use forward direction for Mapping 2? */
+   int fwd;                      /* Direction for current Mapping */
+   int i;                        /* Component index */
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* Determine the direction in which each component will be used, in the
+   same way as the Transform function. */
+   forward1 = forward;
+   forward2 = forward;
+   if ( this->invert1 != astGetInvert( this->map1 ) ) forward1 = !forward1;
+   if ( this->invert2 != astGetInvert( this->map2 ) ) forward2 = !forward2;
+
+/* Consider the two components in the order in which they are applied. */
+   for( i = 0; i < 2; i++ ) {
+      if( ( i == 0 ) == ( forward != 0 ) ) {
+         map = this->map1;
+         fwd = forward1;
+      } else {
+         map = this->map2;
+         fwd = forward2;
+      }
+
+/* Expand nested CmpMaps, allowing for their own Invert attributes. */
+      if( astIsACmpMap( map ) ) {
+         if( !( (AstCmpMap *) map )->series ) return 0;
+         if( astGetInvert( map ) ) fwd = !fwd;
+         if( !SeriesLeaves( (AstCmpMap *) map, fwd, maxmap, maps, fwds,
+                            nmap, status ) ) return 0;
+
+/* Store any other Mapping, if there is room. */
+      } else if( *nmap < maxmap ) {
+         maps[ *nmap ] = map;
+         fwds[ *nmap ] = fwd;
+         ( *nmap )++;
+
+      } else {
+         return 0;
+      }
+   }
+
+   return astOK;
+}
+
 static AstMapping *Simplify( AstMapping *this_mapping, int *status ) {
 /*
 *  Name:
@@ -3639,6 +3875,118 @@ static AstMapping *Simplify( AstMapping *this_mapping, int *status ) {
    return result;
 }
 
+static int SkyRot( AstCmpMap *this, int forward, AstPointSet *in,
+                   AstPointSet *out, int *status ){
+/*
+*  Name:
+*     SkyRot
+
+*  Purpose:
+*     Apply a CmpMap that projects and rotates celestial coordinates.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "cmpmap.h"
+*     int SkyRot( AstCmpMap *this, int forward, AstPointSet *in,
+*                 AstPointSet *out, int *status )
+
+*  Class Membership:
+*     CmpMap member function
+
+*  Description:
+*     The celestial part of a Mapping read from a FITS header by a
+*     FitsChan consists of a WcsMap followed by a rotation of the sky,
+*     represented as an inverted SphMap, a 3x3 MatrixMap and a SphMap.
+*     This function checks whether the supplied series CmpMap consists of
+*     exactly that sequence (in either direction). If so, it transforms
+*     the supplied points using astWcsSkyRot, which performs all four
+*     steps on each block of points without creating intermediate
+*     PointSets. The results are identical to applying the four Mappings
+*     in turn.
+
+*  Parameters:
+*     this
+*        Pointer to the series CmpMap.
+*     forward
+*        The direction in which the CmpMap is used, after allowing for
+*        its own Invert attribute.
+*     in
+*        Pointer to the PointSet holding the input coordinate data.
+*     out
+*        Pointer to the PointSet which is to receive the transformed
+*        coordinate data.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     One if the points were transformed, zero if the CmpMap is not of
+*     the required form (in which case nothing is done).
+*/
+
+/* Local Variables: */
+   AstMapping *maps[ 4 ];        /* Mappings applied by the CmpMap */
+   AstMapping *wcs;              /* The WcsMap */
+   double matrix[ 9 ];           /* Rotation matrix */
+   int effwd[ 4 ];               /* Effective direction for each Mapping */
+   int fwds[ 4 ];                /* Direction passed to each Mapping */
+   int i;                        /* Mapping index */
+   int isph;                     /* Index of first SphMap */
+   int iwcs;                     /* Index of WcsMap */
+   int nmap;                     /* Number of Mappings */
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* Get the Mappings applied by the CmpMap, in order. Return if there are
+   not exactly four. */
+   nmap = 0;
+   if( !SeriesLeaves( this, forward, 4, maps, fwds, &nmap, status ) ||
+       nmap != 4 ) return 0;
+
+/* Get the effective direction of each Mapping, allowing for its Invert
+   attribute. */
+   for( i = 0; i < 4; i++ ) {
+      effwd[ i ] = astGetInvert( maps[ i ] ) ? !fwds[ i ] : fwds[ i ];
+   }
+
+/* The WcsMap must either be first and used to de-project, or be last and
+   used to project. */
+   if( !strcmp( astGetClass( maps[ 0 ] ), "WcsMap" ) && !effwd[ 0 ] ) {
+      iwcs = 0;
+      isph = 1;
+   } else if( !strcmp( astGetClass( maps[ 3 ] ), "WcsMap" ) && effwd[ 3 ] ) {
+      iwcs = 3;
+      isph = 0;
+   } else {
+      return 0;
+   }
+
+/* The WcsMap must have two axes and describe a genuine projection. */
+   wcs = maps[ iwcs ];
+   if( astGetNin( wcs ) != 2 ||
+       astGetWcsType( (AstWcsMap *) wcs ) == AST__WCSBAD ) return 0;
+
+/* The other Mappings must be an inverted SphMap, a MatrixMap holding a
+   full 3x3 matrix, and a SphMap. */
+   if( strcmp( astGetClass( maps[ isph ] ), "SphMap" ) || effwd[ isph ] ||
+       strcmp( astGetClass( maps[ isph + 1 ] ), "MatrixMap" ) ||
+       astGetNin( maps[ isph + 1 ] ) != 3 ||
+       astGetNout( maps[ isph + 1 ] ) != 3 ||
+       strcmp( astGetClass( maps[ isph + 2 ] ), "SphMap" ) ||
+       !effwd[ isph + 2 ] ) return 0;
+
+   if( !astMtrFull( (AstMatrixMap *) maps[ isph + 1 ], fwds[ isph + 1 ],
+                    matrix ) ) return 0;
+
+/* Transform the points. */
+   astWcsSkyRot( (AstWcsMap *) wcs, fwds[ iwcs ], matrix,
+                 astGetPolarLong( (AstSphMap *) maps[ isph + 2 ] ), in, out );
+
+   return 1;
+}
+
 static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
                                int forward, AstPointSet *out, int *status ) {
 /*
@@ -3703,6 +4051,7 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
    AstPointSet *temp;            /* Pointer to temporary PointSet */
    int forward1;                 /* Use forward direction for Mapping 1? */
    int forward2;                 /* Use forward direction for Mapping 2? */
+   int fused;                    /* Points transformed by a fused function? */
    int ipoint1;                  /* Index of first point in batch */
    int ipoint2;                  /* Index of last point in batch */
    int nin1;                     /* No. input coordinates for Mapping 1 */
@@ -3749,6 +4098,13 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
 /* Determine the number of points being transformed. */
    npoint = astGetNpoint( in );
 
+/* Celestial projections. */
+/* ---------------------- */
+/* If the CmpMap projects and rotates celestial coordinates in the way
+   used by FitsChan, transform all the points in a single pass using a
+   fused function. */
+   fused = map->series && SkyRot( map, forward, in, result, status );
+
 /* Mappings in series. */
 /* ------------------- */
 /* If required, use the two component Mappings in series. To do this, we must
@@ -3757,7 +4113,7 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
    intermediate result on each occasion, the memory required may become
    excessive when transforming large numbers of points. To overcome this, we
    split the points up into smaller batches. */
-   if ( astOK ) {
+   if ( astOK && !fused ) {
       if ( map->series ) {
 
 /* Obtain the numbers of input and output coordinates. */
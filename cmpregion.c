@@ -224,13 +224,16 @@ static AstRegion *GetDefUnc( AstRegion *, int * );
 static AstRegion *MatchRegion( AstRegion *, int, AstRegion *, const char *, int * );
 static AstRegion *RegBasePick( AstRegion *this, int, const int *, int * );
 static AstRegion **RegSplit( AstRegion *, int *, int * );
+static double *CompBox( AstCmpRegion *, int, AstRegion *, int * );
 static double GetFillFactor( AstRegion *, int * );
 static int CmpRegionList( AstCmpRegion *, int *, AstRegion ***, int * );
 static int Equal( AstObject *, AstObject *, int * );
 static int GetBounded( AstRegion *, int * );
 static int GetObjSize( AstObject *, int * );
+static int NodeBox( AstRegion *, double *, double *, int * );
 static int RegPins( AstRegion *, AstPointSet *, AstRegion *, int **, int * );
 static int RegTrace( AstRegion *, int, double *, double **, int * );
+static int SelectPoints( AstPointSet *, const int *, int, const double *, int *, int *, int * );
 static void ClearClosed( AstRegion *, int * );
 static void ClearMeshSize( AstRegion *, int * );
 static void Copy( const AstObject *, AstObject *, int * );
@@ -247,6 +250,7 @@ static void SetBreakInfo( AstCmpRegion *, int, int * );
 static void SetClosed( AstRegion *, int, int * );
 static void SetMeshSize( AstRegion *, int, int * );
 static void SetRegFS( AstRegion *, AstFrame *, int * );
+static void TestPoints( AstRegion *, AstPointSet *, int, const int *, int *, int * );
 static void XORCheck( AstCmpRegion *, int * );
 
 #if defined(THREAD_SAFE)
@@ -405,6 +409,80 @@ int CmpRegionList( AstCmpRegion *this, int *nreg, AstRegion ***reg_list,
    return result;
 }
 
+static double *CompBox( AstCmpRegion *this, int comp, AstRegion *reg,
+                        int *status ){
+/*
+*  Name:
+*     CompBox
+
+*  Purpose:
+*     Get a bounding box for a component of a CmpRegion.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "cmpregion.h"
+*     double *CompBox( AstCmpRegion *this, int comp, AstRegion *reg,
+*                      int *status )
+
+*  Class Membership:
+*     CmpRegion member function
+
+*  Description:
+*     This function returns a box within the base Frame of the CmpRegion
+*     that encloses one of the component Regions, as used by the
+*     Transform function (i.e. after any negation implied by the Negated
+*     attribute of the CmpRegion has been applied). Points outside the box
+*     are known to be outside the component Region without needing to
+*     transform them. The box is found by NodeBox when first needed and is
+*     then cached in the CmpRegion until the cache is next reset.
+
+*  Parameters:
+*     this
+*        Pointer to the CmpRegion.
+*     comp
+*        Zero or one, indicating which component Region is supplied.
+*     reg
+*        Pointer to the component Region, with any required negation
+*        applied.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Pointer to an array holding the lower bounds of the box on all
+*     base Frame axes, followed by the upper bounds. The array is owned
+*     by the CmpRegion and should not be freed. NULL is returned if no
+*     box is available (e.g. if the component is unbounded).
+
+*  Notes:
+*     - A NULL pointer will be returned if this function is invoked
+*     with the global error status set, or if it should fail for any
+*     reason.
+*/
+
+/* Local Variables: */
+   int nax;                      /* Number of base Frame axes */
+
+/* Check the global error status. */
+   if ( !astOK ) return NULL;
+
+/* If the box has not yet been looked for, look for it now. */
+   if( this->hasbox[ comp ] == -INT_MAX ) {
+      nax = astGetNaxes( reg );
+      this->box[ comp ] = astGrow( this->box[ comp ], 2*nax,
+                                   sizeof( **this->box ) );
+      if( astOK ) {
+         this->hasbox[ comp ] = NodeBox( reg, this->box[ comp ],
+                                         this->box[ comp ] + nax, status );
+      }
+      if( !astOK ) this->hasbox[ comp ] = -INT_MAX;
+   }
+
+/* Return the box. */
+   return ( astOK && this->hasbox[ comp ] == 1 ) ? this->box[ comp ] : NULL;
+}
+
 static void Decompose( AstMapping *this_mapping, AstMapping **map1,
                        AstMapping **map2, int *series, int *invert1,
                        int *invert2, int *status ) {
@@ -970,6 +1048,8 @@ static int GetObjSize( AstObject *this_object, int *status ) {
    result += astGetObjSize( this->region2 );
    if( this->xor1 ) result += astGetObjSize( this->xor1 );
    if( this->xor2 ) result += astGetObjSize( this->xor2 );
+   result += astTSizeOf( this->box[ 0 ] );
+   result += astTSizeOf( this->box[ 1 ] );
 
 /* If an error occurred, clear the result value. */
    if ( !astOK ) result = 0;
@@ -1505,6 +1585,221 @@ static AstRegion *MatchRegion( AstRegion *this, int ifrm, AstRegion *that,
    return result;
 }
 
+static int NodeBox( AstRegion *reg, double *lbnd, double *ubnd,
+                    int *status ){
+/*
+*  Name:
+*     NodeBox
+
+*  Purpose:
+*     Find a conservative bounding box for a Region.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "cmpregion.h"
+*     int NodeBox( AstRegion *reg, double *lbnd, double *ubnd, int *status )
+
+*  Class Membership:
+*     CmpRegion member function
+
+*  Description:
+*     This function finds a box within the current Frame of the supplied
+*     Region that is guaranteed to enclose every point that the Region
+*     would accept. Boxes are found for CmpRegions by combining the boxes
+*     of their components: an AND uses the intersection of the component
+*     boxes (or the one box that is available), and an OR uses their
+*     union. Boxes for other bounded Regions are found using astRegBaseBox
+*     and are then padded to allow for the uncertainty of the Region, and
+*     for base Frame boxes that are derived from a mesh of boundary points.
+*
+*     Boxes are only available for Regions defined in a basic Frame, and
+*     for which the base->current Mapping is a UnitMap, since axis values
+*     do not then need normalising or transforming.
+
+*  Parameters:
+*     reg
+*        Pointer to the Region, with any required negation applied.
+*     lbnd
+*        Array in which to return the lower bound on each current Frame
+*        axis.
+*     ubnd
+*        Array in which to return the upper bound on each current Frame
+*        axis.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Non-zero if a box was found, and zero otherwise.
+
+*  Notes:
+*     - Zero will be returned if this function is invoked with the
+*     global error status set, or if it should fail for any reason.
+*/
+
+/* Local Variables: */
+   AstFrame *frm;                /* Current Frame of Region */
+   AstMapping *smap;             /* Simplified base->current Mapping */
+   AstPointSet *mesh;            /* Base Frame boundary mesh */
+   AstRegion *reg1;              /* First component Region */
+   AstRegion *reg2;              /* Second component Region */
+   AstRegion *unc;               /* Uncertainty Region */
+   const char *class;            /* Class of current Frame */
+   double **ptr;                 /* Pointers to mesh axis values */
+   double *lbnd2;                /* Lower bounds of second component */
+   double *p;                    /* Previous mesh point */
+   double *q;                    /* Current mesh point */
+   double *ubnd2;                /* Upper bounds of second component */
+   double *work;                 /* Work space */
+   double d;                     /* Distance between mesh points */
+   double gap;                   /* Largest gap between mesh points */
+   double pad;                   /* Padding on current axis */
+   int i;                        /* Axis index */
+   int ip;                       /* Mesh point index */
+   int nax;                      /* Number of current Frame axes */
+   int neg1;                     /* Negated value for first component */
+   int neg2;                     /* Negated value for second component */
+   int np;                       /* Number of mesh points */
+   int ok1;                      /* Box found for first component? */
+   int ok2;                      /* Box found for second component? */
+   int oper;                     /* Boolean operator */
+   int result;                   /* Returned flag */
+
+/* Initialise. */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Check the base->current Mapping is a UnitMap. */
+   smap = astRegMapping( reg );
+   if( astIsAUnitMap( smap ) ) {
+      nax = astGetNaxes( reg );
+
+/* For a CmpRegion, get the components with any negation applied (see
+   Transform), and combine their boxes. */
+      if( astIsACmpRegion( reg ) ) {
+         GetRegions( (AstCmpRegion *) reg, &reg1, &reg2, &oper, &neg1,
+                     &neg2, status );
+
+         if( neg1 != astGetNegated( reg1 ) ) {
+            AstRegion *tmp = astGetNegation( reg1 );
+            (void) astAnnul( reg1 );
+            reg1 = tmp;
+         }
+
+         if( neg2 != astGetNegated( reg2 ) ) {
+            AstRegion *tmp = astGetNegation( reg2 );
+            (void) astAnnul( reg2 );
+            reg2 = tmp;
+         }
+
+         work = astMalloc( 2*nax*sizeof( *work ) );
+         if( astOK ) {
+            lbnd2 = work;
+            ubnd2 = work + nax;
+            ok1 = NodeBox( reg1, lbnd, ubnd, status );
+            ok2 = NodeBox( reg2, lbnd2, ubnd2, status );
+
+            if( oper == AST__AND ) {
+               if( ok1 && ok2 ) {
+                  for( i = 0; i < nax; i++ ) {
+                     lbnd[ i ] = astMAX( lbnd[ i ], lbnd2[ i ] );
+                     ubnd[ i ] = astMIN( ubnd[ i ], ubnd2[ i ] );
+                  }
+               } else if( ok2 ) {
+                  for( i = 0; i < nax; i++ ) {
+                     lbnd[ i ] = lbnd2[ i ];
+                     ubnd[ i ] = ubnd2[ i ];
+                  }
+               }
+               result = ( ok1 || ok2 );
+
+            } else if( ok1 && ok2 ) {
+               for( i = 0; i < nax; i++ ) {
+                  lbnd[ i ] = astMIN( lbnd[ i ], lbnd2[ i ] );
+                  ubnd[ i ] = astMAX( ubnd[ i ], ubnd2[ i ] );
+               }
+               result = 1;
+            }
+         }
+         work = astFree( work );
+         reg1 = astAnnul( reg1 );
+         reg2 = astAnnul( reg2 );
+
+/* For any other class of Region, the Region must be bounded and defined
+   within a basic Frame. */
+      } else if( astGetBounded( reg ) ) {
+         frm = astGetFrame( reg->frameset, AST__CURRENT );
+         class = astGetClass( frm );
+         if( class && !strcmp( class, "Frame" ) ) {
+
+/* Get the base Frame box of the Region and the box enclosing its
+   uncertainty Region. */
+            work = astMalloc( 4*nax*sizeof( *work ) );
+            if( astOK ) {
+               lbnd2 = work;
+               ubnd2 = work + nax;
+               p = ubnd2 + nax;
+               q = p + nax;
+               astRegBaseBox( reg, lbnd, ubnd );
+               unc = astGetUncFrm( reg, AST__CURRENT );
+               astGetRegionBounds( unc, lbnd2, ubnd2 );
+               unc = astAnnul( unc );
+
+/* Some classes (e.g. Ellipse) find their box from the boundary mesh, and
+   so may under-estimate the true extent of the Region between mesh
+   points. The boundary cannot stray further from the chord joining two
+   adjacent mesh points than the length of the chord, so find the largest
+   gap between adjacent mesh points. */
+               mesh = astRegBaseMesh( reg );
+               ptr = astGetPoints( mesh );
+               np = astGetNpoint( mesh );
+               gap = 0.0;
+               if( astOK && np > 0 ) {
+                  for( i = 0; i < nax; i++ ) p[ i ] = ptr[ i ][ np - 1 ];
+                  for( ip = 0; ip < np && gap != AST__BAD; ip++ ) {
+                     for( i = 0; i < nax; i++ ) q[ i ] = ptr[ i ][ ip ];
+                     d = astDistance( frm, p, q );
+                     if( d == AST__BAD ) {
+                        gap = AST__BAD;
+                     } else if( d > gap ) {
+                        gap = d;
+                     }
+                     for( i = 0; i < nax; i++ ) p[ i ] = q[ i ];
+                  }
+               }
+               mesh = astAnnul( mesh );
+
+/* Pad each axis by the width of the uncertainty and the largest mesh
+   gap. */
+               result = ( astOK && gap != AST__BAD );
+               for( i = 0; i < nax && result; i++ ) {
+                  if( lbnd[ i ] == AST__BAD || ubnd[ i ] == AST__BAD ||
+                      lbnd2[ i ] == AST__BAD || ubnd2[ i ] == AST__BAD ||
+                      lbnd[ i ] == -DBL_MAX || ubnd[ i ] == DBL_MAX ||
+                      lbnd2[ i ] == -DBL_MAX || ubnd2[ i ] == DBL_MAX ||
+                      lbnd[ i ] > ubnd[ i ] ) {
+                     result = 0;
+                  } else {
+                     pad = ( ubnd2[ i ] - lbnd2[ i ] ) + gap;
+                     lbnd[ i ] -= pad;
+                     ubnd[ i ] += pad;
+                  }
+               }
+            }
+            work = astFree( work );
+         }
+         frm = astAnnul( frm );
+      }
+   }
+   smap = astAnnul( smap );
+
+/* Return the result. */
+   return astOK ? result : 0;
+}
+
 static void RegBaseBox( AstRegion *this_region, double *lbnd, double *ubnd, int *status ){
 /*
 *  Name:
@@ -3159,6 +3454,8 @@ static void ResetCache( AstRegion *this_region, int *status ){
          this->nbreak[ i ] = 0;
          this->d0[ i ] = AST__BAD;
          this->dtot[ i ] = AST__BAD;
+         this->box[ i ] = astFree( this->box[ i ] );
+         this->hasbox[ i ] = -INT_MAX;
       }
 
       this->bounded = -INT_MAX;
@@ -3172,6 +3469,106 @@ static void ResetCache( AstRegion *this_region, int *status ){
    }
 }
 
+static int SelectPoints( AstPointSet *pset, const int *prev, int want,
+                         const double *box, int *inside, int *index,
+                         int *status ){
+/*
+*  Name:
+*     SelectPoints
+
+*  Purpose:
+*     Select the points that need to be tested against a component Region.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "cmpregion.h"
+*     int SelectPoints( AstPointSet *pset, const int *prev, int want,
+*                       const double *box, int *inside, int *index,
+*                       int *status )
+
+*  Class Membership:
+*     CmpRegion member function
+
+*  Description:
+*     This function is used by Transform to find the points for which a
+*     component Region needs to be evaluated. Points are skipped if their
+*     result has already been decided by the other component Region, or if
+*     they are outside the bounding box of the component Region. The
+*     "inside" flag for each skipped point is set to zero.
+
+*  Parameters:
+*     pset
+*        PointSet holding the base Frame positions.
+*     prev
+*        Array holding a flag for each point indicating if it was inside
+*        the previously tested component Region. May be NULL, in which
+*        case all points are candidates.
+*     want
+*        Points for which "prev" does not equal this value are skipped.
+*     box
+*        The bounding box of the component Region, as returned by
+*        CompBox. May be NULL.
+*     inside
+*        Array in which to store a zero for each skipped point.
+*     index
+*        Array in which to return the indices of the selected points.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The number of selected points.
+*/
+
+/* Local Variables: */
+   const double *lbnd;           /* Lower bounds of box */
+   const double *ubnd;           /* Upper bounds of box */
+   double **ptr;                 /* Pointers to axis values */
+   double x;                     /* Axis value */
+   int ic;                       /* Axis index */
+   int ip;                       /* Point index */
+   int nc;                       /* Number of axes */
+   int np;                       /* Number of points */
+   int result;                   /* Number of selected points */
+   int sel;                      /* Is the point selected? */
+
+/* Initialise. */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+   nc = astGetNcoord( pset );
+   np = astGetNpoint( pset );
+   ptr = astGetPoints( pset );
+   lbnd = box;
+   ubnd = box ? box + nc : NULL;
+
+   if( astOK ) {
+      for( ip = 0; ip < np; ip++ ) {
+         sel = ( !prev || prev[ ip ] == want );
+         if( sel && box ) {
+            for( ic = 0; ic < nc; ic++ ) {
+               x = ptr[ ic ][ ip ];
+               if( x == AST__BAD || x < lbnd[ ic ] || x > ubnd[ ic ] ) {
+                  sel = 0;
+                  break;
+               }
+            }
+         }
+         if( sel ) {
+            index[ result++ ] = ip;
+         } else {
+            inside[ ip ] = 0;
+         }
+      }
+   }
+
+/* Return the result. */
+   return result;
+}
+
 static void SetBreakInfo( AstCmpRegion *this, int comp, int *status ){
 /*
 *  Name:
@@ -3788,6 +4185,104 @@ static AstMapping *Simplify( AstMapping *this_mapping, int *status ) {
    return result;
 }
 
+static void TestPoints( AstRegion *reg, AstPointSet *pset, int n,
+                        const int *index, int *inside, int *status ){
+/*
+*  Name:
+*     TestPoints
+
+*  Purpose:
+*     Test which of a selection of points are inside a component Region.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "cmpregion.h"
+*     void TestPoints( AstRegion *reg, AstPointSet *pset, int n,
+*                      const int *index, int *inside, int *status )
+
+*  Class Membership:
+*     CmpRegion member function
+
+*  Description:
+*     This function uses a component Region to transform a selection of
+*     the points in a PointSet, and stores a flag for each selected point
+*     indicating if it is inside the Region. If all points are selected
+*     the supplied PointSet is transformed directly, otherwise the
+*     selected points are first copied into a smaller PointSet.
+
+*  Parameters:
+*     reg
+*        Pointer to the component Region, with any required negation
+*        applied.
+*     pset
+*        PointSet holding the base Frame positions.
+*     n
+*        The number of selected points.
+*     index
+*        Array holding the indices within "pset" of the selected points.
+*     inside
+*        Array in which to store a flag for each selected point. Elements
+*        for other points are left unchanged.
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Variables: */
+   AstPointSet *ps1;             /* Selected points */
+   AstPointSet *ps2;             /* Selected points after transformation */
+   double **ptr1;                /* Pointers to selected axis values */
+   double **ptr2;                /* Pointers to transformed axis values */
+   double **ptr;                 /* Pointers to all axis values */
+   int all;                      /* Are all points selected? */
+   int good;                     /* Is the point inside the Region? */
+   int ic;                       /* Axis index */
+   int ip;                       /* Index of selected point */
+   int nc;                       /* Number of axes */
+
+/* Check the global error status, and that there is something to do. */
+   if ( !astOK || n == 0 ) return;
+
+/* Get a PointSet holding the selected points. */
+   nc = astGetNcoord( pset );
+   all = ( n == astGetNpoint( pset ) );
+   if( all ) {
+      ps1 = astClone( pset );
+   } else {
+      ps1 = astPointSet( n, nc, "", status );
+      ptr = astGetPoints( pset );
+      ptr1 = astGetPoints( ps1 );
+      if( astOK ) {
+         for( ic = 0; ic < nc; ic++ ) {
+            for( ip = 0; ip < n; ip++ ) {
+               ptr1[ ic ][ ip ] = ptr[ ic ][ index[ ip ] ];
+            }
+         }
+      }
+   }
+
+/* Transform them using the Region, and note which are inside. */
+   ps2 = astTransform( reg, ps1, 0, NULL );
+   ptr2 = astGetPoints( ps2 );
+   if( astOK ) {
+      for( ip = 0; ip < n; ip++ ) {
+         good = 0;
+         for( ic = 0; ic < nc; ic++ ) {
+            if( ptr2[ ic ][ ip ] != AST__BAD ) {
+               good = 1;
+               break;
+            }
+         }
+         inside[ all ? ip : index[ ip ] ] = good;
+      }
+   }
+
+/* Free resources. */
+   ps1 = astAnnul( ps1 );
+   ps2 = astAnnul( ps2 );
+}
+
 static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
                                int forward, AstPointSet *out, int *status ) {
 /*
@@ -3814,6 +4309,12 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
 *     PointSet and transforms the points so as to apply the required Region.
 *     This implies applying each of the CmpRegion's component Regions in turn,
 *     either in series or in parallel.
+*
+*     The second component Region is only applied to points that are not
+*     already decided by the first (i.e. points inside the first component
+*     for an AND, or outside it for an OR). Points outside the bounding
+*     box of a component Region (if available) are rejected without
+*     applying the component Region at all.
 
 *  Parameters:
 *     this
@@ -3846,19 +4347,19 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
 
 /* Local Variables: */
    AstCmpRegion *this;           /* Pointer to the CmpRegion structure */
-   AstPointSet *ps1;             /* Pointer to PointSet for first component */
-   AstPointSet *ps2;             /* Pointer to PointSet for second component */
    AstPointSet *pset_tmp;        /* Pointer to PointSet holding base Frame positions*/
    AstPointSet *result;          /* Pointer to output PointSet */
    AstRegion *reg1;              /* Pointer to first component Region */
    AstRegion *reg2;              /* Pointer to second component Region */
-   double **ptr1;                /* Pointer to first component axis values */
-   double **ptr2;                /* Pointer to second component axis values */
    double **ptr_out;             /* Pointer to output coordinate data */
+   double *box1;                 /* Bounding box of first component Region */
+   double *box2;                 /* Bounding box of second component Region */
+   int *in1;                     /* Points inside first component Region */
+   int *in2;                     /* Points inside second component Region */
+   int *index;                   /* Indices of points to be tested */
    int coord;                    /* Zero-based index for coordinates */
-   int good;                     /* Is the point inside the CmpRegion? */
+   int n;                        /* Number of points to be tested */
    int ncoord_out;               /* No. of coordinates per output point */
-   int ncoord_tmp;               /* No. of coordinates per base Frame point */
    int neg1;                     /* Negated value for first component Region */
    int neg2;                     /* Negated value for second component Region */
    int npoint;                   /* No. of points */
@@ -3916,59 +4417,52 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
    must be carefull not to modify the contents of the returned PointSet. */
    pset_tmp = astRegTransform( this, in, 0, NULL, NULL );
 
-/* Now transform this PointSet using each of the two component Regions in
-   turn. */
-   ps1 = astTransform( reg1, pset_tmp, 0, NULL );
-   ps2 = astTransform( reg2, pset_tmp, 0, NULL );
-
-/* Determine the numbers of points and coordinates per point for these base
-   Frame PointSets and obtain pointers for accessing the base Frame and output
-   coordinate values. */
+/* Determine the numbers of points and coordinates per point and obtain
+   pointers for accessing the output coordinate values. Also get work
+   arrays to hold flags indicating if each point is inside each component
+   Region, and the indices of the points that need to be tested. */
    npoint = astGetNpoint( pset_tmp );
-   ncoord_tmp = astGetNcoord( pset_tmp );
-   ptr1 = astGetPoints( ps1 );
-   ptr2 = astGetPoints( ps2 );
    ncoord_out = astGetNcoord( result );
    ptr_out = astGetPoints( result );
+   in1 = astMalloc( npoint*sizeof( *in1 ) );
+   in2 = astMalloc( npoint*sizeof( *in2 ) );
+   index = astMalloc( npoint*sizeof( *index ) );
+
+/* Get any bounding boxes for the two component Regions. */
+   box1 = CompBox( this, 0, reg1, status );
+   box2 = CompBox( this, 1, reg2, status );
 
 /* Perform coordinate arithmetic. */
 /* ------------------------------ */
    if ( astOK ) {
 
-/* First deal with ANDed Regions */
-      if( oper == AST__AND ) {
-         for ( point = 0; point < npoint; point++ ) {
-            good = 0;
+/* Test the points against the first component Region, excluding any that
+   are outside its bounding box. */
+      n = SelectPoints( pset_tmp, NULL, 0, box1, in1, index, status );
+      TestPoints( reg1, pset_tmp, n, index, in1, status );
 
-            for ( coord = 0; coord < ncoord_tmp; coord++ ) {
-               if( ptr1[ coord ][ point ] != AST__BAD &&
-                   ptr2[ coord ][ point ] != AST__BAD ) {
-                  good = 1;
-                  break;
-               }
-            }
+/* First deal with ANDed Regions. Only points inside the first component
+   need to be tested against the second. */
+      if( oper == AST__AND ) {
+         n = SelectPoints( pset_tmp, in1, 1, box2, in2, index, status );
+         TestPoints( reg2, pset_tmp, n, index, in2, status );
 
-            if( !good ) {
+         for ( point = 0; point < npoint; point++ ) {
+            if( !in1[ point ] || !in2[ point ] ) {
                for ( coord = 0; coord < ncoord_out; coord++ ) {
                   ptr_out[ coord ][ point ] = AST__BAD;
                }
             }
          }
 
-/* Now deal with ORed Regions */
+/* Now deal with ORed Regions. Only points outside the first component
+   need to be tested against the second. */
       } else if( oper == AST__OR ) {
-         for ( point = 0; point < npoint; point++ ) {
-            good = 0;
+         n = SelectPoints( pset_tmp, in1, 0, box2, in2, index, status );
+         TestPoints( reg2, pset_tmp, n, index, in2, status );
 
-            for ( coord = 0; coord < ncoord_tmp; coord++ ) {
-               if( ptr1[ coord ][ point ] != AST__BAD ||
-                   ptr2[ coord ][ point ] != AST__BAD ) {
-                  good = 1;
-                  break;
-               }
-            }
-
-            if( !good ) {
+         for ( point = 0; point < npoint; point++ ) {
+            if( !in1[ point ] && !in2[ point ] ) {
                for ( coord = 0; coord < ncoord_out; coord++ ) {
                   ptr_out[ coord ][ point ] = AST__BAD;
                }
@@ -3987,9 +4481,10 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
 /* Free resources. */
    reg1 = astAnnul( reg1 );
    reg2 = astAnnul( reg2 );
-   ps1 = astAnnul( ps1 );
-   ps2 = astAnnul( ps2 );
    pset_tmp = astAnnul( pset_tmp );
+   in1 = astFree( in1 );
+   in2 = astFree( in2 );
+   index = astFree( index );
 
 /* If an error occurred, clean up by deleting the output PointSet (if
    allocated by this function) and setting a NULL result pointer. */
@@ -4158,6 +4653,8 @@ static void Copy( const AstObject *objin, AstObject *objout, int *status ) {
    for( i = 0; i < 2; i++ ) {
       out->rvals[ i ] = NULL;
       out->offs[ i ] = NULL;
+      out->box[ i ] = NULL;
+      out->hasbox[ i ] = -INT_MAX;
    }
 
 /* Make copies of these Regions and store pointers to them in the output
@@ -4218,6 +4715,7 @@ static void Delete( AstObject *obj, int *status ) {
    for( i = 0; i < 2; i++ ) {
       this->rvals[ i ] = astFree( this->rvals[ i ] );
       this->offs[ i ] = astFree( this->offs[ i ] );
+      this->box[ i ] = astFree( this->box[ i ] );
    }
 
 /* Annul the pointers to the component Regions. */
@@ -4847,6 +5345,8 @@ AstCmpRegion *astInitCmpRegion_( void *mem, size_t size, int init,
          new->nbreak[ i ] = 0;
          new->d0[ i ] = AST__BAD;
          new->dtot[ i ] = AST__BAD;
+         new->box[ i ] = NULL;
+         new->hasbox[ i ] = -INT_MAX;
       }
       new->bounded = -INT_MAX;
 
@@ -5041,6 +5541,8 @@ AstCmpRegion *astLoadCmpRegion_( void *mem, size_t size,
          new->nbreak[ i ] = 0;
          new->d0[ i ] = AST__BAD;
          new->dtot[ i ] = AST__BAD;
+         new->box[ i ] = NULL;
+         new->hasbox[ i ] = -INT_MAX;
       }
       new->bounded = -INT_MAX;
 
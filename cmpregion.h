@@ -119,6 +119,8 @@ typedef struct AstCmpRegion {
    AstRegion *xor1;              /* First XORed Region */
    AstRegion *xor2;              /* Second XORed Region */
    int bounded;                  /* Is this CmpRegion bounded? */
+   double *box[ 2 ];             /* Bounding box of each component */
+   int hasbox[ 2 ];              /* Is each bounding box available? */
 } AstCmpRegion;
 
 /* Virtual function table. */
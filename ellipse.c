@@ -75,6 +75,11 @@ f     - AST_ELLIPSEPARS: Get the geometric parameters of the Ellipse
    "protected" symbols available. */
 #define astCLASS Ellipse
 
+/* The margin by which the cosine of the distance from the centre of an
+   Ellipse on the sky must fall below the cosine of its semi-major axis
+   length for a point to be rejected using a dot product alone. */
+#define DOT_TOL 1.0E-12
+
 /* Include files. */
 /* ============== */
 /* Interface definitions. */
@@ -91,6 +96,7 @@ f     - AST_ELLIPSEPARS: Get the geometric parameters of the Ellipse
 #include "wcsmap.h"              /* Definitons of AST__DPI etc */
 #include "circle.h"              /* Interface definition for circle class */
 #include "ellipse.h"             /* Interface definition for this class */
+#include "skyframe.h"            /* Celestial coordinate systems */
 #include "mapping.h"             /* Position mappings */
 #include "unitmap.h"             /* Unit Mapping */
 #include "pal.h"                 /* Positional astronomy library */
@@ -162,6 +168,7 @@ static AstPointSet *RegBaseMesh( AstRegion *, int * );
 static AstPointSet *Transform( AstMapping *, AstPointSet *, int, AstPointSet *, int * );
 static double *RegCentre( AstRegion *this, double *, double **, int, int, int * );
 static int RegPins( AstRegion *, AstPointSet *, AstRegion *, int **, int * );
+static int RegLineCross( AstRegion *, const double[], const double[], double **, int * );
 static int RegTrace( AstRegion *, int, double *, double **, int * );
 static void Cache( AstEllipse *, int * );
 static void CalcPars( AstFrame *, double[2], double[2], double[2], double *, double *, double *, int * );
@@ -546,6 +553,7 @@ void astInitEllipseVtab_(  AstEllipseVtab *vtab, const char *name, int *status )
    region->RegBaseMesh = RegBaseMesh;
    region->RegBaseBox = RegBaseBox;
    region->RegCentre = RegCentre;
+   region->RegLineCross = RegLineCross;
    region->RegTrace = RegTrace;
 
 /* Store replacement pointers for methods which will be over-ridden by
@@ -1616,6 +1624,155 @@ static int RegPins( AstRegion *this_region, AstPointSet *pset, AstRegion *unc,
    return result;
 }
 
+static int RegLineCross( AstRegion *this_region, const double start[],
+                         const double step[], double **cross, int *status ){
+/*
+*+
+*  Name:
+*     RegLineCross
+
+*  Purpose:
+*     Find where a straight line crosses the boundary of a 2D Region.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "ellipse.h"
+*     int RegLineCross( AstRegion *this, const double start[],
+*                       const double step[], double **cross, int *status )
+
+*  Class Membership:
+*     Ellipse member function (overrides the astRegLineCross method
+*     inherited from the parent Region class).
+
+*  Description:
+*     This function finds the places at which a straight line in the
+*     base Frame of a 2-dimensional Region may cross the boundary of the
+*     Region. The line is given by "start + t*step", where "t" is a
+*     scalar parameter, and the returned positions are expressed as
+*     values of "t".
+*
+*     The crossings of an Ellipse in a Cartesian base Frame are the roots
+*     of a quadratic equation in "t". If the line misses the Ellipse, the
+*     point of closest approach (in elliptical distance) is returned
+*     instead, to guard against rounding errors when the line is close
+*     to a tangent.
+
+*  Parameters:
+*     this
+*        Pointer to the Region.
+*     start
+*        The base Frame axis values at "t = 0".
+*     step
+*        The change in the base Frame axis values per unit increase
+*        in "t".
+*     cross
+*        Address at which to return a pointer to a newly allocated array
+*        holding the lower and upper "t" values of each crossing
+*        interval. It should be freed using astFree when no longer
+*        needed. A NULL pointer is returned if no crossings are found, or
+*        if the method cannot be used.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The number of crossings found, or -1 if the method cannot be used
+*     with the base Frame of the Region.
+
+*-
+*/
+
+/* Local Variables; */
+   AstEllipse *this;
+   AstFrame *frm;
+   double a;
+   double b;
+   double c;
+   double c1;
+   double c2;
+   double d0[ 2 ];
+   double disc;
+   double len;
+   double p0;
+   double pd;
+   double q0;
+   double qd;
+   double u[ 2 ];
+   int result;
+
+/* Initialise */
+   *cross = NULL;
+   result = -1;
+
+/* Check inherited status. */
+   if( ! astOK ) return result;
+
+/* Get a pointer to the Ellipse structure. */
+   this = (AstEllipse *) this_region;
+
+/* The boundary is only a conic section if the base Frame is a
+   2-dimensional Cartesian Frame. */
+   frm = astGetFrame( this_region->frameset, AST__BASE );
+   if( astGetNaxes( frm ) == 2 && !astIsASkyFrame( frm ) &&
+       !astIsARegion( frm ) && !astIsAFrameSet( frm ) ) {
+
+/* Ensure cached information is available. */
+      Cache( this, status );
+
+/* Get a unit vector along the primary axis (from the centre towards
+   "point1"), as used by the astTransform method. */
+      u[ 0 ] = this->point1[ 0 ] - this->centre[ 0 ];
+      u[ 1 ] = this->point1[ 1 ] - this->centre[ 1 ];
+      len = sqrt( u[ 0 ]*u[ 0 ] + u[ 1 ]*u[ 1 ] );
+      if( len > 0.0 && this->a > 0.0 && this->b > 0.0 ) {
+         u[ 0 ] /= len;
+         u[ 1 ] /= len;
+
+/* Resolve the line start and step into components parallel ("p") and
+   perpendicular ("q") to the primary axis. */
+         d0[ 0 ] = start[ 0 ] - this->centre[ 0 ];
+         d0[ 1 ] = start[ 1 ] - this->centre[ 1 ];
+         p0 = d0[ 0 ]*u[ 0 ] + d0[ 1 ]*u[ 1 ];
+         q0 = d0[ 1 ]*u[ 0 ] - d0[ 0 ]*u[ 1 ];
+         pd = step[ 0 ]*u[ 0 ] + step[ 1 ]*u[ 1 ];
+         qd = step[ 1 ]*u[ 0 ] - step[ 0 ]*u[ 1 ];
+
+/* Form the coefficients of the quadratic "a*t*t + b*t + c = 0" giving
+   the values of "t" at which the elliptical distance from the centre is
+   1.0. */
+         c1 = 1.0/( this->a*this->a );
+         c2 = 1.0/( this->b*this->b );
+         a = c1*pd*pd + c2*qd*qd;
+         b = 2.0*( c1*p0*pd + c2*q0*qd );
+         c = c1*p0*p0 + c2*q0*q0 - 1.0;
+
+/* Store the two roots, or the point of closest approach if there are no
+   real roots. */
+         if( a > 0.0 ) {
+            *cross = astMalloc( sizeof( double )*4 );
+            if( astOK ) {
+               disc = b*b - 4.0*a*c;
+               disc = ( disc > 0.0 ) ? sqrt( disc ) : 0.0;
+               (*cross)[ 0 ] = (*cross)[ 1 ] = ( -b - disc )/( 2.0*a );
+               (*cross)[ 2 ] = (*cross)[ 3 ] = ( -b + disc )/( 2.0*a );
+               result = 2;
+            }
+         }
+      }
+   }
+   frm = astAnnul( frm );
+
+/* Return -1 if an error occurred. */
+   if( !astOK ) {
+      *cross = astFree( *cross );
+      result = -1;
+   }
+
+/* Return the result. */
+   return result;
+}
+
 static int RegTrace( AstRegion *this_region, int n, double *dist, double **ptr,
                      int *status ){
 /*
@@ -2058,6 +2215,13 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
 *     PointSet and transforms the points by setting axis values to
 *     AST__BAD for all points which are outside the region. Points inside
 *     the region are copied unchanged from input to output.
+*
+*     If the Ellipse is defined within a SkyFrame and has not been
+*     negated, points that are further from the centre than the semi-major
+*     axis length are first rejected by comparing the dot product of their
+*     unit vectors with the cosine of the semi-major axis length. Only the
+*     remaining points are resolved into components using
+*     astResolvePoints.
 
 *  Parameters:
 *     this
@@ -2093,19 +2257,36 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
 /* Local Variables: */
    AstEllipse *this;             /* Pointer to Ellipse */
    AstFrame *frm;                /* Pointer to base Frame in FrameSet */
+   AstPointSet *pset_cand;       /* Pointer to PointSet holding candidate points */
+   AstPointSet *pset_rc;         /* Pointer to PointSet holding candidate components */
    AstPointSet *pset_res;        /* Pointer to PointSet holding resolved components */
    AstPointSet *pset_tmp;        /* Pointer to PointSet holding base Frame positions*/
    AstPointSet *result;          /* Pointer to output PointSet */
+   double **ptr_cand;            /* Pointer to candidate coordinate data */
    double **ptr_out;             /* Pointer to output coordinate data */
+   double **ptr_rc;              /* Pointer to candidate components data */
    double **ptr_res;             /* Pointer to resolved components coordinate data */
+   double **ptr_tmp;             /* Pointer to base Frame coordinate data */
    double *px;                   /* Pointer to array of primary axis components */
    double *py;                   /* Pointer to array of secondary axis components */
    double c1;                    /* Constant */
    double c2;                    /* Constant */
+   double cl;                    /* Cosine of latitude */
+   double cosmax;                /* Cosine of the semi-major axis length */
+   double cvec[ 3 ];             /* Unit vector at the centre */
    double d;                     /* Elliptical distance to current point */
+   double dot;                   /* Cosine of distance from centre to point */
+   double lat;                   /* Latitude of point */
+   double lon;                   /* Longitude of point */
+   double maxax;                 /* Semi-major axis length */
+   int *cand;                    /* Indices of candidate points */
    int closed;                   /* Is the boundary part of the Region? */
    int coord;                    /* Zero-based index for coordinates */
+   int icand;                    /* Index of current candidate point */
+   int ilat;                     /* Index of latitude axis */
+   int ilon;                     /* Index of longitude axis */
    int inside;                   /* Is the point inside the Region? */
+   int ncand;                    /* Number of candidate points */
    int ncoord_out;               /* No. of coordinates per output point */
    int neg;                      /* Has the Region been negated? */
    int npoint;                   /* No. of points */
@@ -2138,10 +2319,90 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
    contents of the returned PointSet. */
    pset_tmp = astRegTransform( this, in, 0, NULL, &frm );
 
-/* Resolve all the base Frame positions into components parallel to and
-   perpendicular to the primary axis, relative to the ellipse centre. The
-   components are returned in a new PointSet. */
-   pset_res = astResolvePoints( frm, this->centre, this->point1, pset_tmp, NULL );
+/* If the Ellipse is defined on the sky, and the semi-major axis is less
+   than 90 degrees, any point inside the Ellipse is no further from the
+   centre than the semi-major axis length. So any point with a smaller
+   dot product between its unit vector and the unit vector at the centre
+   than the cosine of the semi-major axis length is outside the Ellipse.
+   Form a list of the remaining candidate points, and resolve just these.
+   The rejected points are given bad components. This is only done if
+   the Ellipse has not been negated, since a bad component then produces
+   a bad output point regardless of where the point is. */
+   pset_res = NULL;
+   maxax = ( this->a > this->b ) ? this->a : this->b;
+   if( astOK && astIsASkyFrame( frm ) && !astGetNegated( this ) &&
+       this->centre[ 0 ] != AST__BAD && this->centre[ 1 ] != AST__BAD &&
+       maxax != AST__BAD && maxax < AST__DPIBY2 ) {
+
+      ilon = astGetLonAxis( (AstSkyFrame *) frm );
+      ilat = 1 - ilon;
+      cl = cos( this->centre[ ilat ] );
+      cvec[ 0 ] = cl*cos( this->centre[ ilon ] );
+      cvec[ 1 ] = cl*sin( this->centre[ ilon ] );
+      cvec[ 2 ] = sin( this->centre[ ilat ] );
+      cosmax = cos( maxax ) - DOT_TOL;
+
+      npoint = astGetNpoint( pset_tmp );
+      ptr_tmp = astGetPoints( pset_tmp );
+      cand = astMalloc( sizeof( int )*(size_t) npoint );
+      if( astOK ) {
+         ncand = 0;
+         for ( point = 0; point < npoint; point++ ) {
+            lon = ptr_tmp[ ilon ][ point ];
+            lat = ptr_tmp[ ilat ][ point ];
+            if( lon != AST__BAD && lat != AST__BAD ) {
+               cl = cos( lat );
+               dot = cl*cos( lon )*cvec[ 0 ] + cl*sin( lon )*cvec[ 1 ] +
+                     sin( lat )*cvec[ 2 ];
+               if( dot >= cosmax ) cand[ ncand++ ] = point;
+            }
+         }
+
+/* Create a PointSet holding the full set of resolved components, and
+   initialise them to bad values. */
+         pset_res = astPointSet( npoint, 2, "", status );
+         ptr_res = astGetPoints( pset_res );
+         if( astOK ) {
+            for ( point = 0; point < npoint; point++ ) {
+               ptr_res[ 0 ][ point ] = AST__BAD;
+               ptr_res[ 1 ][ point ] = AST__BAD;
+            }
+         }
+
+/* Copy the candidate points into a new PointSet, resolve them, and copy
+   the resolved components into the full PointSet. */
+         if( ncand > 0 ) {
+            pset_cand = astPointSet( ncand, 2, "", status );
+            ptr_cand = astGetPoints( pset_cand );
+            if( astOK ) {
+               for ( icand = 0; icand < ncand; icand++ ) {
+                  ptr_cand[ 0 ][ icand ] = ptr_tmp[ 0 ][ cand[ icand ] ];
+                  ptr_cand[ 1 ][ icand ] = ptr_tmp[ 1 ][ cand[ icand ] ];
+               }
+            }
+            pset_rc = astResolvePoints( frm, this->centre, this->point1,
+                                        pset_cand, NULL );
+            ptr_rc = astGetPoints( pset_rc );
+            if( astOK ) {
+               for ( icand = 0; icand < ncand; icand++ ) {
+                  ptr_res[ 0 ][ cand[ icand ] ] = ptr_rc[ 0 ][ icand ];
+                  ptr_res[ 1 ][ cand[ icand ] ] = ptr_rc[ 1 ][ icand ];
+               }
+            }
+            pset_rc = astAnnul( pset_rc );
+            pset_cand = astAnnul( pset_cand );
+         }
+      }
+      cand = astFree( cand );
+   }
+
+/* Otherwise, resolve all the base Frame positions into components parallel
+   to and perpendicular to the primary axis, relative to the ellipse centre.
+   The components are returned in a new PointSet. */
+   if( !pset_res ) {
+      pset_res = astResolvePoints( frm, this->centre, this->point1, pset_tmp,
+                                   NULL );
+   }
 
 /* Determine the numbers of points from the component PointSet and obtain
    pointers for accessing the component and output coordinate values. */
@@ -0,0 +1,139 @@
+/*
+*+
+*  Name:
+*     fmoc.c
+
+*  Purpose:
+*     Define a FORTRAN 77 interface to the AST Moc class.
+
+*  Type of Module:
+*     C source file.
+
+*  Description:
+*     This file defines FORTRAN 77-callable C functions which provide
+*     a public FORTRAN 77 interface to the Moc class.
+
+*  Routines Defined:
+*     AST_ADDCELL
+*     AST_ADDREGION
+*     AST_GETCELL
+*     AST_ISAMOC
+*     AST_MOC
+
+*  Licence:
+*     This program is free software: you can redistribute it and/or
+*     modify it under the terms of the GNU Lesser General Public
+*     License as published by the Free Software Foundation, either
+*     version 3 of the License, or (at your option) any later
+*     version.
+*
+*     This program is distributed in the hope that it will be useful,
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*     GNU Lesser General Public License for more details.
+*
+*     You should have received a copy of the GNU Lesser General
+*     License along with this program.  If not, see
+*     <http://www.gnu.org/licenses/>.
+*/
+
+/* Define the astFORTRAN77 macro which prevents error messages from
+   AST C functions from reporting the file and line number where the
+   error occurred (since these would refer to this file, they would
+   not be useful). */
+#define astFORTRAN77
+
+/* Header files. */
+/* ============= */
+#include "f77.h"                 /* FORTRAN <-> C interface macros (SUN/209) */
+#include "c2f77.h"               /* F77 <-> C support functions/macros */
+#include "error.h"               /* Error reporting facilities */
+#include "memory.h"              /* Memory handling facilities */
+#include "moc.h"                 /* C interface to the Moc class */
+
+F77_LOGICAL_FUNCTION(ast_isamoc)( INTEGER(THIS), INTEGER(STATUS) ) {
+   GENPTR_INTEGER(THIS)
+   F77_LOGICAL_TYPE(RESULT);
+
+   astAt( "AST_ISAMOC", NULL, 0 );
+   astWatchSTATUS(
+      RESULT = astIsAMoc( astI2P( *THIS ) ) ? F77_TRUE : F77_FALSE;
+   )
+   return RESULT;
+}
+
+F77_INTEGER_FUNCTION(ast_moc)( CHARACTER(OPTIONS),
+                               INTEGER(STATUS)
+                               TRAIL(OPTIONS) ) {
+   GENPTR_CHARACTER(OPTIONS)
+   F77_INTEGER_TYPE(RESULT);
+   char *options;
+   int i;
+
+   astAt( "AST_MOC", NULL, 0 );
+   astWatchSTATUS(
+      options = astString( OPTIONS, OPTIONS_length );
+
+/* Truncate the options string to exlucde any trailing spaces. */
+      astChrTrunc( options );
+
+/* Change ',' to '\n' (see AST_SET in fobject.c for why). */
+      if ( astOK ) {
+         for ( i = 0; options[ i ]; i++ ) {
+            if ( options[ i ] == ',' ) options[ i ] = '\n';
+         }
+      }
+
+      RESULT = astP2I( astMoc( "%s", options ) );
+      astFree( options );
+   )
+   return RESULT;
+}
+
+F77_SUBROUTINE(ast_addcell)( INTEGER(THIS),
+                             INTEGER(CMODE),
+                             INTEGER(ORDER),
+                             INTEGER8(NPIX),
+                             INTEGER(STATUS) ) {
+   GENPTR_INTEGER(THIS)
+   GENPTR_INTEGER(CMODE)
+   GENPTR_INTEGER(ORDER)
+   GENPTR_INTEGER8(NPIX)
+
+   astAt( "AST_ADDCELL", NULL, 0 );
+   astWatchSTATUS(
+      astAddCell( astI2P( *THIS ), *CMODE, *ORDER, (int64_t) *NPIX );
+   )
+}
+
+F77_SUBROUTINE(ast_addregion)( INTEGER(THIS),
+                               INTEGER(CMODE),
+                               INTEGER(REGION),
+                               INTEGER(STATUS) ) {
+   GENPTR_INTEGER(THIS)
+   GENPTR_INTEGER(CMODE)
+   GENPTR_INTEGER(REGION)
+
+   astAt( "AST_ADDREGION", NULL, 0 );
+   astWatchSTATUS(
+      astAddRegion( astI2P( *THIS ), *CMODE, astI2P( *REGION ) );
+   )
+}
+
+F77_SUBROUTINE(ast_getcell)( INTEGER(THIS),
+                             INTEGER(ICELL),
+                             INTEGER(ORDER),
+                             INTEGER8(NPIX),
+                             INTEGER(STATUS) ) {
+   GENPTR_INTEGER(THIS)
+   GENPTR_INTEGER(ICELL)
+   GENPTR_INTEGER(ORDER)
+   GENPTR_INTEGER8(NPIX)
+   int64_t npix;
+
+   astAt( "AST_GETCELL", NULL, 0 );
+   astWatchSTATUS(
+      astGetCell( astI2P( *THIS ), *ICELL, ORDER, &npix );
+      *NPIX = (F77_INTEGER8_TYPE) npix;
+   )
+}
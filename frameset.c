@@ -895,6 +895,7 @@ static double Centre( AstFrame *, int, double, double, int * );
 static double Gap( AstFrame *, int, double, int *, int * );
 static double Offset2( AstFrame *, const double[2], double, double, double[2], int * );
 static double Rate( AstMapping *, double *, int, int, int * );
+static int RateIsExact( AstMapping *, int * );
 static int *MapSplit( AstMapping *, int, const int *, AstMapping **, int * );
 static int Equal( AstObject *, AstObject *, int * );
 static int Fields( AstFrame *, int, const char *, const char *, int, char **, int *, double *, int * );
@@ -5942,6 +5943,7 @@ void astInitFrameSetVtab_(  AstFrameSetVtab *vtab, const char *name, int *status
    mapping->GetTranForward = GetTranForward;
    mapping->GetTranInverse = GetTranInverse;
    mapping->Rate = Rate;
+   mapping->RateIsExact = RateIsExact;
    mapping->ReportPoints = ReportPoints;
    mapping->RemoveRegions = RemoveRegions;
    mapping->Simplify = Simplify;
@@ -8026,6 +8028,60 @@ static double Rate( AstMapping *this_mapping, double *at, int ax1, int ax2, int
    return result;
 }
 
+static int RateIsExact( AstMapping *this_mapping, int *status ) {
+/*
+*  Name:
+*     RateIsExact
+
+*  Purpose:
+*     Check if the astRate method of a Mapping is exact.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "frameset.h"
+*     int RateIsExact( AstMapping *this, int *status )
+
+*  Class Membership:
+*     FrameSet member function (over-rides the protected astRateIsExact
+*     method inherited from the Mapping class).
+
+*  Description:
+*     This function returns a flag indicating if the astRate method of
+*     the supplied Mapping evaluates the rate of change analytically.
+*     A FrameSet uses the astRate method of the Mapping from its base
+*     Frame to its current Frame.
+
+*  Parameters:
+*     this
+*        Pointer to the Mapping.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Non-zero if the astRate method of the supplied Mapping is exact, and
+*     zero otherwise.
+
+*/
+
+/* Local Variables: */
+   AstMapping *map;              /* Pointer to the base->current Mapping */
+   int result;                   /* Returned flag */
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* Obtain the Mapping between the base and current Frames in the
+   FrameSet and check its astRate method. */
+   map = astGetMapping( (AstFrameSet *) this_mapping, AST__BASE, AST__CURRENT );
+   result = astRateIsExact( map );
+   map = astAnnul( map );
+
+/* Return the result. */
+   return result;
+}
+
 static void RecordIntegrity( AstFrameSet *this, int *status ) {
 /*
 *+
@@ -174,6 +174,41 @@ F77_INTEGER_FUNCTION(ast_overlap)( INTEGER(THIS),
    return RESULT;
 }
 
+F77_INTEGER_FUNCTION(ast_regionscontain)( INTEGER(NREG),
+                                          INTEGER_ARRAY(REGS),
+                                          INTEGER(NPOINT),
+                                          INTEGER(NCOORD),
+                                          INTEGER(INDIM),
+                                          DOUBLE_ARRAY(IN),
+                                          INTEGER_ARRAY(INSIDE),
+                                          INTEGER(STATUS) ) {
+   GENPTR_INTEGER(NREG)
+   GENPTR_INTEGER_ARRAY(REGS)
+   GENPTR_INTEGER(NPOINT)
+   GENPTR_INTEGER(NCOORD)
+   GENPTR_INTEGER(INDIM)
+   GENPTR_DOUBLE_ARRAY(IN)
+   GENPTR_INTEGER_ARRAY(INSIDE)
+   F77_INTEGER_TYPE(RESULT);
+   int i;
+   AstObject **regs;
+
+   astAt( "AST_REGIONSCONTAIN", NULL, 0 );
+   astWatchSTATUS(
+      regs = astMalloc( sizeof(AstObject *) * (*NREG) );
+      if ( astOK ) {
+         for ( i = 0; i < *NREG; i++ ) {
+            regs[ i ] = astI2P( REGS[ i ] );
+         }
+      }
+
+      RESULT = astRegionsContain( *NREG, (void **) regs, *NPOINT, *NCOORD,
+                                  *INDIM, IN, INSIDE );
+      astFree( regs );
+   )
+   return RESULT;
+}
+
 /* AST_MASK<X> requires a function for each possible data type, so
    define it via a macro. */
 #define MAKE_AST_MASK(f,F,Ftype,X,Xtype) \
@@ -1,13 +1,15 @@
-#if defined( THREAD_SAFE )
-
 #define astCLASS
 
 #include "globals.h"
 #include "error.h"
-#include <pthread.h>
+#include "ast_err.h"
 #include <stdlib.h>
 #include <stdio.h>
 
+#if defined( THREAD_SAFE )
+
+#include <pthread.h>
+
 /* Configuration results. */
 /* ---------------------- */
 #if HAVE_CONFIG_H
@@ -37,6 +39,31 @@
 static int nthread = 0;
 static pthread_mutex_t nthread_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+/* The pool of worker threads used by astRunJobs. The pool is created
+   when first needed and the threads then wait for further jobs until the
+   process exits. All these variables are guarded by "pool_mutex". The
+   "pool_start" condition is signalled when a new batch of jobs is
+   available, and "pool_end" is signalled when the last job in a batch
+   has been completed. */
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_start = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t pool_end = PTHREAD_COND_INITIALIZER;
+static pthread_t *pool_thread = NULL;   /* Identifiers for worker threads */
+static int pool_nworker = 0;            /* Number of worker threads */
+static int pool_busy = 0;               /* Is a batch of jobs in progress? */
+static void (* pool_func)( void *, int * ) = NULL; /* Job function */
+static char *pool_data = NULL;          /* Data for first job */
+static size_t pool_jobsize = 0;         /* Size of the data for each job */
+static int pool_njob = 0;               /* Number of jobs in the batch */
+static int pool_next = 0;               /* Index of next job to start */
+static int pool_ndone = 0;              /* Number of jobs completed */
+static int pool_status = 0;             /* Status from first failed job */
+
+/* The number of threads (including the calling thread) to be used by
+   astRunJobs. A value of -1 indicates that it has not yet been obtained
+   from the AST_NTHREAD environment variable. */
+static int pool_size = -1;
+
 /* External variables visible throughout AST */
 /* ========================================= */
 
@@ -53,6 +80,11 @@ pthread_key_t starlink_ast_globals_key;
 pthread_key_t starlink_ast_status_key;
 
 
+/* Prototypes for private functions. */
+/* ================================== */
+static void *PoolWorker( void * );
+static void RunPoolJobs( int, int * );
+
 /* Function definitions: */
 /* ===================== */
 
@@ -192,6 +224,7 @@ AstGlobals *astGlobalsInit_( void ) {
       INIT( Ellipse );
       INIT( Interval );
       INIT( MatrixMap );
+      INIT( Moc );
       INIT( NormMap );
       INIT( NullRegion );
       INIT( PermMap );
@@ -249,5 +282,296 @@ AstGlobals *astGlobalsInit_( void ) {
    return globals;
 }
 
+static void *PoolWorker( void *arg ) {
+/*
+*  Name:
+*     PoolWorker
+
+*  Purpose:
+*     The function executed by each worker thread in the astRunJobs pool.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     void *PoolWorker( void *arg )
+
+*  Description:
+*     This function waits for a batch of jobs to become available, and
+*     then runs jobs from the batch until none are left. It then waits for
+*     the next batch. It never returns.
+
+*  Parameters:
+*     arg
+*        Not used.
+
+*  Returned Value:
+*     NULL.
+
+*/
+
+/* Local Variables: */
+   int *status;                 /* Pointer to thread-specific status */
+
+/* Get a pointer to the inherited status value for this thread. This also
+   creates the thread-specific AST global data for the thread. */
+   status = astGetStatusPtr;
+
+/* Loop for ever, waiting for each new batch of jobs. */
+   pthread_mutex_lock( &pool_mutex );
+   while( 1 ) {
+      while( !pool_busy || pool_next >= pool_njob ) {
+         pthread_cond_wait( &pool_start, &pool_mutex );
+      }
+      RunPoolJobs( 1, status );
+   }
+
+   return NULL;
+}
+
+static void RunPoolJobs( int worker, int *status ) {
+/*
+*  Name:
+*     RunPoolJobs
+
+*  Purpose:
+*     Run jobs from the current batch until none are left.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     void RunPoolJobs( int worker, int *status )
+
+*  Description:
+*     This function runs jobs from the current astRunJobs batch until
+*     all jobs have been started. It is called by each worker thread and
+*     by the thread that invoked astRunJobs. The pool mutex should be
+*     locked on entry, and is locked on exit, but is unlocked while each
+*     job runs.
+
+*  Parameters:
+*     worker
+*        Non-zero if the calling thread is a pool worker thread. An error
+*        status from a job run by a worker thread is recorded so that it
+*        can be reported by astRunJobs, and the worker's status is then
+*        cleared.
+*     status
+*        Pointer to the inherited status variable.
+
+*/
+
+/* Local Variables: */
+   char *data;                  /* Pointer to data for current job */
+   void (* func)( void *, int * ); /* Job function */
+
+/* Loop until all jobs have been started. */
+   while( pool_busy && pool_next < pool_njob ) {
+      func = pool_func;
+      data = pool_data + pool_jobsize*(size_t) pool_next++;
+
+/* Run the job, with the mutex unlocked so that other threads can start
+   jobs at the same time. */
+      pthread_mutex_unlock( &pool_mutex );
+      if( astOK ) func( data, status );
+      pthread_mutex_lock( &pool_mutex );
+
+/* Record any error status from a worker thread. */
+      if( worker && !astOK ) {
+         if( !pool_status ) pool_status = astStatus;
+         astClearStatus;
+      }
+
+/* If this was the last job in the batch, wake the thread that is
+   waiting for the batch to complete. */
+      if( ++pool_ndone == pool_njob ) pthread_cond_broadcast( &pool_end );
+   }
+}
+
+#endif
+
+int astGetNThread_( int *status ) {
+/*
+*+
+*  Name:
+*     astGetNThread
+
+*  Purpose:
+*     Return the number of threads to be used by astRunJobs.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "globals.h"
+*     int astGetNThread()
+
+*  Description:
+*     This function returns the number of threads that astRunJobs will
+*     use to run a batch of jobs (including the calling thread). It is
+*     given by the AST_NTHREAD environment variable, which is read when
+*     this function is first called. It is one (i.e. jobs are run serially)
+*     if the variable is not set or is not an integer greater than one,
+*     or if AST was built without POSIX threads support.
+
+*  Returned Value:
+*     The number of threads.
+
+*-
+*/
+
+#if defined( THREAD_SAFE )
+
+/* Local Variables: */
+   const char *envvar;          /* Value of environment variable */
+   int result;                  /* Returned value */
+
+/* Read the environment variable if this has not already been done. */
+   pthread_mutex_lock( &pool_mutex );
+   if( pool_size == -1 ) {
+      pool_size = 1;
+      envvar = getenv( "AST_NTHREAD" );
+      if( envvar && atoi( envvar ) > 1 ) pool_size = atoi( envvar );
+   }
+   result = pool_size;
+   pthread_mutex_unlock( &pool_mutex );
+
+/* Return the result. */
+   return result;
+
+#else
+   return 1;
+#endif
+}
+
+void astRunJobs_( int njob, void (* func)( void *, int * ), void *data,
+                  size_t size, int *status ) {
+/*
+*+
+*  Name:
+*     astRunJobs
+
+*  Purpose:
+*     Run a batch of independent jobs, using several threads if possible.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "globals.h"
+*     void astRunJobs( int njob, void (* func)( void *, int * ), void *data,
+*                      size_t size )
+
+*  Description:
+*     This function invokes "func" once for each element of an array of
+*     job descriptions, and returns when all the invocations have
+*     completed. If AST was built with POSIX threads support, and
+*     astGetNThread returns a value greater than one, the jobs are shared
+*     between the calling thread and a pool of worker threads. Otherwise,
+*     or if the pool is already in use (for instance, if this function
+*     is called from within a job), the jobs are run serially by the
+*     calling thread.
+*
+*     Each job may be run by any thread, and so must only use AST Objects
+*     that are not locked by any other thread. Typically, the caller
+*     creates a copy of each required Object for each job, unlocks the
+*     copies using astManageLock before calling this function, and locks
+*     them again afterwards. Each job function locks the Objects it uses
+*     on entry, and unlocks them before returning.
+
+*  Parameters:
+*     njob
+*        The number of jobs.
+*     func
+*        The function that performs a job. It is given a pointer to the
+*        description of the job, and a pointer to the inherited status
+*        variable of the thread running the job.
+*     data
+*        Pointer to an array of "njob" job descriptions.
+*     size
+*        The size of each job description, in bytes.
+
+*  Notes:
+*     - Error messages reported by a job run in a worker thread are
+*     delivered immediately. An error status is then set in the calling
+*     thread when all jobs have completed.
+
+*-
+*/
+
+/* Local Variables: */
+   char *pdata;                 /* Pointer to next job description */
+   int ijob;                    /* Index of job */
+   int serial;                  /* Run the jobs serially? */
+#if defined( THREAD_SAFE )
+   int i;                       /* Index of worker thread */
+#endif
+
+/* Check the global error status. */
+   if( !astOK ) return;
+
+/* Assume the jobs will be run serially. */
+   serial = 1;
+
+#if defined( THREAD_SAFE )
+
+/* Use the pool only if it would use more than one thread, if the pool is
+   not already in use and if this function was not called from a worker
+   thread. */
+   if( njob > 1 && astGetNThread_( status ) > 1 ) {
+      pthread_mutex_lock( &pool_mutex );
+      serial = pool_busy;
+      for( i = 0; i < pool_nworker && !serial; i++ ) {
+         if( pthread_equal( pool_thread[ i ], pthread_self() ) ) serial = 1;
+      }
+
+/* Start the worker threads if this has not already been done. */
+      if( !serial && !pool_thread ) {
+         pool_thread = MALLOC( sizeof( pthread_t )*(size_t)( pool_size - 1 ) );
+         while( pool_thread && pool_nworker < pool_size - 1 ) {
+            if( pthread_create( pool_thread + pool_nworker, NULL,
+                                PoolWorker, NULL ) ) break;
+            pthread_detach( pool_thread[ pool_nworker++ ] );
+         }
+      }
+      if( pool_nworker == 0 ) serial = 1;
+
+/* Store the batch of jobs and wake the worker threads. */
+      if( !serial ) {
+         pool_func = func;
+         pool_data = (char *) data;
+         pool_jobsize = size;
+         pool_njob = njob;
+         pool_next = 0;
+         pool_ndone = 0;
+         pool_status = 0;
+         pool_busy = 1;
+         pthread_cond_broadcast( &pool_start );
+
+/* Run jobs in this thread too, and then wait for all the jobs to
+   complete. */
+         RunPoolJobs( 0, status );
+         while( pool_ndone < pool_njob ) {
+            pthread_cond_wait( &pool_end, &pool_mutex );
+         }
+         pool_busy = 0;
+
+/* Report an error if any job failed in a worker thread. */
+         if( pool_status && astOK ) {
+            astError( pool_status, "astRunJobs: A job failed in a worker "
+                      "thread.", status );
+         }
+      }
+      pthread_mutex_unlock( &pool_mutex );
+   }
 #endif
 
+/* Run the jobs serially if required. */
+   if( serial ) {
+      pdata = (char *) data;
+      for( ijob = 0; ijob < njob && astOK; ijob++ ) {
+         func( pdata, status );
+         pdata += size;
+      }
+   }
+}
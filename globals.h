@@ -34,6 +34,7 @@
 #include "mathmap.h"
 #include "matrixmap.h"
 #include "memory.h"
+#include "moc.h"
 #include "normmap.h"
 #include "nullregion.h"
 #include "object.h"
@@ -185,6 +186,7 @@ typedef struct AstGlobals {
    AstEllipseGlobals Ellipse;
    AstIntervalGlobals Interval;
    AstMatrixMapGlobals MatrixMap;
+   AstMocGlobals Moc;
    AstNormMapGlobals NormMap;
    AstNullRegionGlobals NullRegion;
    AstPermMapGlobals PermMap;
@@ -243,5 +245,16 @@ AstGlobals *astGlobalsInit_( void );
 #define astGET_GLOBALS(This)
 #define astINIT_GLOBALS
 
+#endif
+
+/* Functions that run batches of jobs in parallel. These are available
+   whether or not thread-safety is required (if it is not, the jobs are
+   run serially by the calling thread). */
+#if defined( astCLASS )
+#include <stddef.h>
+int astGetNThread_( int * );
+void astRunJobs_( int, void (*)( void *, int * ), void *, size_t, int * );
+#define astGetNThread() astGetNThread_(STATUS_PTR)
+#define astRunJobs(njob,func,data,size) astRunJobs_(njob,func,data,size,STATUS_PTR)
 #endif
 #endif
@@ -105,6 +105,7 @@ f     The Interval class does not define any new routines beyond those
 #include "nullregion.h"          /* Null Regions */
 #include "wcsmap.h"              /* Definitons of AST__DPI etc */
 #include "interval.h"            /* Interface definition for this class */
+#include "skyframe.h"            /* Celestial coordinate systems */
 #include "ellipse.h"             /* Interface definition for ellipse class */
 #include "mapping.h"             /* Position mappings */
 #include "unitmap.h"             /* Unit Mappings */
@@ -195,6 +196,7 @@ static int GetBounded( AstRegion *, int * );
 static int MapMerge( AstMapping *, int, int, int *, AstMapping ***, int **, int * );
 static int Overlap( AstRegion *, AstRegion *, int * );
 static int RegPins( AstRegion *, AstPointSet *, AstRegion *, int **, int * );
+static int RegLineCross( AstRegion *, const double[], const double[], double **, int * );
 static int RegTrace( AstRegion *, int, double *, double **, int * );
 static void Copy( const AstObject *, AstObject *, int * );
 static void Delete( AstObject *, int * );
@@ -805,6 +807,7 @@ void astInitIntervalVtab_(  AstIntervalVtab *vtab, const char *name, int *status
    region->GetBounded = GetBounded;
    region->GetDefUnc = GetDefUnc;
    region->RegPins = RegPins;
+   region->RegLineCross = RegLineCross;
    region->RegTrace = RegTrace;
    region->RegBaseMesh = RegBaseMesh;
    region->BndBaseMesh = BndBaseMesh;
@@ -2884,6 +2887,137 @@ static int RegPins( AstRegion *this_region, AstPointSet *pset, AstRegion *unc,
    return result;
 }
 
+static int RegLineCross( AstRegion *this_region, const double start[],
+                         const double step[], double **cross, int *status ){
+/*
+*+
+*  Name:
+*     RegLineCross
+
+*  Purpose:
+*     Find where a straight line crosses the boundary of a 2D Region.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "interval.h"
+*     int RegLineCross( AstRegion *this, const double start[],
+*                       const double step[], double **cross, int *status )
+
+*  Class Membership:
+*     Interval member function (overrides the astRegLineCross method
+*     inherited from the parent Region class).
+
+*  Description:
+*     This function finds the places at which a straight line in the
+*     base Frame of a 2-dimensional Region may cross the boundary of the
+*     Region. The line is given by "start + t*step", where "t" is a
+*     scalar parameter, and the returned positions are expressed as
+*     values of "t".
+*
+*     The boundary of an Interval in a Cartesian base Frame is made of
+*     lines of constant axis value, and so the line is crossed wherever
+*     one of its axis values equals a finite limit on that axis.
+
+*  Parameters:
+*     this
+*        Pointer to the Region.
+*     start
+*        The base Frame axis values at "t = 0".
+*     step
+*        The change in the base Frame axis values per unit increase
+*        in "t".
+*     cross
+*        Address at which to return a pointer to a newly allocated array
+*        holding the lower and upper "t" values of each crossing
+*        interval. It should be freed using astFree when no longer
+*        needed. A NULL pointer is returned if no crossings are found, or
+*        if the method cannot be used.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The number of crossings found, or -1 if the method cannot be used
+*     with the base Frame of the Region.
+
+*-
+*/
+
+/* Local Variables; */
+   AstBox *box;
+   AstFrame *frm;
+   AstInterval *this;
+   double lim[ 2 ];
+   double t;
+   int i;
+   int j;
+   int result;
+
+/* Initialise */
+   *cross = NULL;
+   result = -1;
+
+/* Check inherited status. */
+   if( ! astOK ) return result;
+
+/* Get a pointer to the Interval structure. */
+   this = (AstInterval *) this_region;
+
+/* If the Interval is effectively a Box, invoke the astRegLineCross
+   function on the equivalent Box. */
+   box = Cache( this, status );
+   if( box ) {
+      result = astRegLineCross( box, start, step, cross );
+
+/* Otherwise, the edges are only lines of constant axis value if the base
+   Frame is a 2-dimensional Cartesian Frame. */
+   } else {
+      frm = astGetFrame( this_region->frameset, AST__BASE );
+      if( astGetNaxes( frm ) == 2 && !astIsASkyFrame( frm ) &&
+          !astIsARegion( frm ) && !astIsAFrameSet( frm ) ) {
+
+/* Allocate room for two crossings on each axis. */
+         *cross = astMalloc( sizeof( double )*8 );
+         if( astOK ) {
+            result = 0;
+
+/* Check each axis. Equal limits are widened by the astTransform method
+   using the uncertainty Region, so do not attempt to handle them. */
+            for( i = 0; i < 2 && result >= 0; i++ ) {
+               lim[ 0 ] = this->lbnd[ i ];
+               lim[ 1 ] = this->ubnd[ i ];
+               if( lim[ 0 ] == lim[ 1 ] ) {
+                  result = -1;
+
+/* The line crosses each finite limit on each axis along which it is not
+   parallel. */
+               } else if( step[ i ] != 0.0 ) {
+                  for( j = 0; j < 2; j++ ) {
+                     if( lim[ j ] != AST__BAD && fabs( lim[ j ] ) != DBL_MAX ) {
+                        t = ( lim[ j ] - start[ i ] )/step[ i ];
+                        (*cross)[ 2*result ] = t;
+                        (*cross)[ 2*result + 1 ] = t;
+                        result++;
+                     }
+                  }
+               }
+            }
+         }
+      }
+      frm = astAnnul( frm );
+   }
+
+/* Return -1 if an error occurred or the method cannot be used. */
+   if( !astOK || result < 0 ) {
+      *cross = astFree( *cross );
+      result = -1;
+   }
+
+/* Return the result. */
+   return result;
+}
+
 static int RegTrace( AstRegion *this_region, int n, double *dist, double **ptr,
                      int *status ){
 /*
@@ -130,6 +130,31 @@ f     The IntraMap class does not define any new routines beyond those
 #include <stdio.h>
 #include <string.h>
 
+/* Type definitions. */
+/* ================= */
+
+/* A structure that describes a job that passes a range of points to a
+   transformation function in batches. If the function is re-entrant,
+   jobs for separate ranges may be run in parallel using astRunJobs. */
+typedef struct IntraBatch {
+   AstIntraMap *map;             /* Private copy of the IntraMap (or NULL) */
+   AstMapping *id;               /* Public ID for the IntraMap */
+   void (* tran)( AstMapping *, int, int, const double *[], int, int, double *[] );
+                                 /* Pointer to transformation function */
+   void (* tran_wrap)( void (*)( AstMapping *, int, int, const double *[], int, int, double *[] ), AstMapping *, int, int, const double *[], int, int, double *[], int * );
+                                 /* Pointer to wrapper function */
+   const double **ptr_in;        /* Pointers to all input coordinate data */
+   double **ptr_out;             /* Pointers to all output coordinate data */
+   int alias;                    /* Do input and output arrays overlap? */
+   int forward;                  /* Use the forward transformation? */
+   int nbatch;                   /* Maximum number of points per batch */
+   int ncoord_in;                /* Number of coordinates per input point */
+   int ncoord_out;               /* Number of coordinates per output point */
+   int npoint;                   /* Number of points in the range */
+   int point0;                   /* Index of first point in the range */
+   int reent;                    /* Is the transformation function re-entrant? */
+} IntraBatch;
+
 /* Module Variables. */
 /* ================= */
 
@@ -177,7 +202,8 @@ static pthread_mutex_t mutex1 = PTHREAD_MUTEX_INITIALIZER;
 #define UNLOCK_MUTEX1 pthread_mutex_unlock( &mutex1 );
 
 /* A mutex used to serialise invocations of extrnal transformation
-   functions (which may not be thread-safe). */
+   functions (which may not be thread-safe). It is not used for functions
+   registered with the AST__REENT flag. */
 static pthread_mutex_t mutex2 = PTHREAD_MUTEX_INITIALIZER;
 #define LOCK_MUTEX2 pthread_mutex_lock( &mutex2 );
 #define UNLOCK_MUTEX2 pthread_mutex_unlock( &mutex2 );
@@ -224,9 +250,10 @@ static void Copy( const AstObject *, AstObject *, int * );
 static void Delete( AstObject *, int * );
 static void Dump( AstObject *, AstChannel *, int * );
 static int Equal( AstObject *, AstObject *, int * );
-static void IntraReg( const char *, int, int, void (*)( AstMapping *, int, int, const double *[], int, int, double *[] ), void (*)( void (*)( AstMapping *, int, int, const double *[], int, int, double *[] ), AstMapping *, int, int, const double *[], int, int, double *[], int * ), unsigned int, const char *, const char *, const char *, int * );
+static void IntraReg( const char *, int, int, void (*)( AstMapping *, int, int, const double *[], int, int, double *[] ), void (*)( void (*)( AstMapping *, int, int, const double *[], int, int, double *[] ), AstMapping *, int, int, const double *[], int, int, double *[], int * ), unsigned int, int, const char *, const char *, const char *, int * );
 static void SetAttrib( AstObject *, const char *, int * );
 static void SetIntraFlag( AstIntraMap *, const char *, int * );
+static void TranBatches( void *, int * );
 static void TranWrap( void (*)( AstMapping *, int, int, const double *[], int, int, double *[] ), AstMapping *, int, int, const double *[], int, int, double *[], int * );
 
 /* Member functions. */
@@ -742,7 +769,7 @@ static void IntraReg( const char *name, int nin, int nout,
                                           AstMapping *, int, int,
                                           const double *[], int, int,
                                           double *[], int * ),
-                      unsigned int flags,
+                      unsigned int flags, int nbatch,
                       const char *purpose, const char *author,
                       const char *contact, int *status ) {
 /*
@@ -766,7 +793,7 @@ static void IntraReg( const char *name, int nin, int nout,
 *                                        AstMapping *, int, int,
 *                                        const double *[], int, int,
 *                                        double *[], int * ),
-*                    unsigned int flags,
+*                    unsigned int flags, int nbatch,
 *                    const char *purpose, const char *author,
 *                    const char *contact, int *status )
 
@@ -810,6 +837,10 @@ static void IntraReg( const char *name, int nin, int nout,
 *        control the behaviour of any IntraMap which uses the
 *        registered transformation function. See the public interface
 *        for astIntraReg for details.
+*     nbatch
+*        The preferred maximum number of points to be passed to the
+*        transformation function in a single invocation, or zero if
+*        all points should be passed together.
 *     purpose
 *        Pointer to a null-terminated string containing a short (one
 *        line) textual comment to describe the purpose of the
@@ -863,6 +894,12 @@ static void IntraReg( const char *name, int nin, int nout,
                                "coordinates (%d).", status, clname, nout );
          astError( AST__BADNO, "This number should be zero or more (or "
                                "AST__ANY)." , status);
+
+      } else if ( nbatch < 0 ) {
+         astError( AST__NPTIN, "astIntraReg(%s): Bad preferred batch "
+                               "size (%d).", status, clname, nbatch );
+         astError( AST__NPTIN, "This number should be zero or more." ,
+                   status );
       }
    }
 
@@ -883,6 +920,7 @@ static void IntraReg( const char *name, int nin, int nout,
               ( tran != tran_data[ ifun ].tran ) ||
               ( tran_wrap != tran_data[ ifun ].tran_wrap ) ||
               ( flags != tran_data[ ifun ].flags ) ||
+              ( nbatch != tran_data[ ifun ].nbatch ) ||
               strcmp( purpose, tran_data[ ifun ].purpose ) ||
               strcmp( author, tran_data[ ifun ].author ) ||
               strcmp( contact, tran_data[ ifun ].contact ) ) {
@@ -905,6 +943,7 @@ static void IntraReg( const char *name, int nin, int nout,
             tran_data[ tran_nfun ].tran = tran;
             tran_data[ tran_nfun ].tran_wrap = tran_wrap;
             tran_data[ tran_nfun ].flags = flags;
+            tran_data[ tran_nfun ].nbatch = nbatch;
             tran_data[ tran_nfun ].purpose =
                astStore( NULL, purpose, strlen( purpose ) + (size_t) 1 );
             tran_data[ tran_nfun ].author =
@@ -1221,6 +1260,32 @@ f     an identity Mapping (a UnitMap) if it is encountered while
 f     simplifying a compound Mapping (e.g. using AST_SIMPLIFY).  It is
 f     not necessary that both transformations have actually been
 f     implemented.
+c     - AST__REENT: You may set this flag if the transformation
+c     function is re-entrant, i.e. it keeps no unprotected static
+c     state and so may safely be executing in several threads at
+c     once. By default, AST serialises all invocations of registered
+c     transformation functions so that only one executes at any time,
+c     which prevents IntraMaps being used concurrently from separate
+c     threads. If the function is registered using astIntraRegBatch,
+c     this flag also allows AST to pass separate batches of points to
+c     it from several threads at once (see astIntraRegBatch).
+f     - AST__REENT: You may set this flag if the transformation
+f     routine is re-entrant, i.e. it keeps no unprotected SAVEd or
+f     COMMON state and so may safely be executing in several threads
+f     at once. By default, AST serialises all calls to registered
+f     transformation routines so that only one executes at any time,
+f     which prevents IntraMaps being used concurrently from separate
+f     threads.
+c     - AST__INPLACE: You may set this flag if the transformation
+c     function gives correct results when its output coordinate
+c     arrays are the same arrays as its input coordinate arrays. By
+c     default, AST passes a separate copy of the input coordinates to
+c     the transformation function whenever the two would otherwise
+c     overlap.
+f     - AST__INPLACE: This flag is accepted for compatibility with the
+f     C interface but has no effect, since the coordinates are always
+f     copied into separate input and output arrays before a
+f     transformation routine is called.
 *--
 */
 
@@ -1229,10 +1294,108 @@ f     implemented.
 
 /* Register the transformation function together with the appropriate
    wrapper function for the C language. */
-   IntraReg( name, nin, nout, tran, TranWrap, flags, purpose, author,
+   IntraReg( name, nin, nout, tran, TranWrap, flags, 0, purpose, author,
              contact, status );
 }
 
+void astIntraRegBatch_( const char *name, int nin, int nout,
+                        void (* tran)( AstMapping *, int, int, const double *[],
+                                       int, int, double *[] ),
+                        unsigned int flags, int nbatch, const char *purpose,
+                        const char *author, const char *contact,
+                        int *status ) {
+/*
+*++
+*  Name:
+c     astIntraRegBatch
+
+*  Purpose:
+*     Register a transformation function with a preferred batch size.
+
+*  Type:
+*     Public function.
+
+*  Synopsis:
+c     #include "intramap.h"
+c     void astIntraRegBatch( const char *name, int nin, int nout,
+c                            void (* tran)( AstMapping *, int, int,
+c                                           const double *[], int, int,
+c                                           double *[] ),
+c                            unsigned int flags, int nbatch,
+c                            const char *purpose, const char *author,
+c                            const char *contact )
+
+*  Class Membership:
+*     IntraMap member function.
+
+*  Description:
+c     This function behaves exactly like astIntraReg, except that it
+c     also allows you to specify the largest number of points that
+c     the transformation function prefers to receive in a single
+c     invocation. When an IntraMap using the function transforms more
+c     points than this, they are passed to the function in successive
+c     batches of at most "nbatch" points. This may be used, for
+c     instance, to keep the working arrays of an expensive
+c     transformation within the processor cache, or within the limits
+c     of an external library.
+
+*  Parameters:
+c     name
+c        Pointer to a null-terminated string containing the name to be
+c        used to identify the transformation function. See astIntraReg.
+c     nin
+c        The number of input coordinates per point (or AST__ANY).
+c     nout
+c        The number of output coordinates per point (or AST__ANY).
+c     tran
+c        Pointer to the transformation function to be registered. This
+c        should have the same interface as for astIntraReg.
+c     flags
+c        The bitwise OR of any flags describing the transformation
+c        function (see the "Transformation Flags" section of
+c        astIntraReg).
+c     nbatch
+c        The preferred maximum number of points per invocation of the
+c        transformation function. A value of zero indicates that all
+c        points should be passed in a single invocation, as for
+c        astIntraReg. An error is reported if a negative value is given.
+c     purpose
+c        Pointer to a null-terminated string containing a short (one
+c        line) textual comment to describe the purpose of the
+c        transformation function.
+c     author
+c        Pointer to a null-terminated string containing the name of
+c        the author of the transformation function.
+c     contact
+c        Pointer to a null-terminated string containing contact
+c        details for the author of the transformation function.
+
+*  Notes:
+c     - The transformation function should not assume that every
+c     invocation receives exactly "nbatch" points. The final batch
+c     will usually be shorter.
+c     - If the transformation function is registered with the
+c     AST__REENT flag, and AST was built with POSIX threads support,
+c     the batches of points may be passed to it in parallel by several
+c     threads. The number of threads to use is given by the AST_NTHREAD
+c     environment variable (the default is to use a single thread). Each
+c     thread passes a pointer to a separate copy of the IntraMap to the
+c     transformation function, and the batches may be processed in any
+c     order.
+c     - A transformation function may only be registered once under any
+c     given name, whether by astIntraReg or astIntraRegBatch.
+*--
+*/
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Register the transformation function together with the appropriate
+   wrapper function for the C language. */
+   IntraReg( name, nin, nout, tran, TranWrap, flags, nbatch, purpose,
+             author, contact, status );
+}
+
 void astIntraRegFor_( const char *name, int nin, int nout,
                       void (* tran)( AstMapping *, int, int, const double *[],
                                      int, int, double *[] ),
@@ -1341,7 +1504,7 @@ void astIntraRegFor_( const char *name, int nin, int nout,
 
 /* Register the transformation function together with the appropriate
    wrapper function for the foreign language interface. */
-   IntraReg( name, nin, nout, tran, tran_wrap, flags, purpose, author,
+   IntraReg( name, nin, nout, tran, tran_wrap, flags, 0, purpose, author,
              contact, status );
 }
 
@@ -1834,13 +1997,26 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
    AstIntraMap *this;            /* Pointer to IntraMap structure */
    AstMapping *id;               /* Public ID for the IntraMap supplied */
    AstPointSet *result;          /* Pointer to output PointSet */
+   IntraBatch *jobs;             /* Descriptions of parallel jobs */
+   IntraBatch batch;             /* Description of serial job */
    const double **ptr_in;        /* Pointer to input coordinate data */
    double **ptr_out;             /* Pointer to output coordinate data */
+   int alias;                    /* Do input and output arrays overlap? */
+   int coord;                    /* Loop counter for coordinates */
+   int coord_in;                 /* Loop counter for input coordinates */
+   int ijob;                     /* Index of parallel job */
+   int nbat;                     /* Number of batches */
+   int nbatch;                   /* Maximum number of points per batch */
    int ncoord_in;                /* Number of coordinates per input point */
    int ncoord_out;               /* Number of coordinates per output point */
+   int njob;                     /* Number of parallel jobs */
    int npoint;                   /* Number of points */
+   int nthread;                  /* Number of threads used by astRunJobs */
    int ok;                       /* AST status OK? */
+   int point1;                   /* Index of first point after a job's range */
+   int reent;                    /* Is the transformation function re-entrant? */
    int status_value;             /* AST status value */
+   unsigned int flags;           /* Flags describing transformation function */
 
 /* Check the global error status. */
    if ( !astOK ) return NULL;
@@ -1881,16 +2057,82 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
    to astAnnulID later on does not annul the IntraMap pointer. */
    id = (AstMapping *) astMakeId( astClone( this ) );
 
-/* Locate the transformation function data associated with the
-   IntraMap and use the wrapper function to invoke the transformation
-   function itself. */
+/* Obtain the flags and preferred batch size registered with the
+   transformation function. A batch size of zero means all points are
+   passed in a single invocation. */
+   flags = tran_data[ this->ifun ].flags;
+   nbatch = tran_data[ this->ifun ].nbatch;
+   if ( nbatch <= 0 || nbatch > npoint ) nbatch = npoint;
+   reent = ( flags & AST__REENT ) != 0;
+
+/* Unless the function accepts in-place transformation, see if any
+   output coordinate array is also used for input (as happens if the
+   same PointSet is supplied for "in" and "out"). If so, the input
+   values for each batch are first copied into a separate work array. */
+   alias = 0;
+   if ( !( flags & AST__INPLACE ) ) {
+      for ( coord = 0; coord < ncoord_out && !alias; coord++ ) {
+         for ( coord_in = 0; coord_in < ncoord_in; coord_in++ ) {
+            if ( ptr_out[ coord ] == ptr_in[ coord_in ] ) {
+               alias = 1;
+               break;
+            }
+         }
+      }
+   }
+
+/* Describe the job of passing all the points to the transformation
+   function in batches. */
+   batch.map = NULL;
+   batch.id = id;
+   batch.tran = tran_data[ this->ifun ].tran;
+   batch.tran_wrap = tran_data[ this->ifun ].tran_wrap;
+   batch.ptr_in = ptr_in;
+   batch.ptr_out = ptr_out;
+   batch.alias = alias;
+   batch.forward = forward;
+   batch.nbatch = nbatch;
+   batch.ncoord_in = ncoord_in;
+   batch.ncoord_out = ncoord_out;
+   batch.npoint = npoint;
+   batch.point0 = 0;
+   batch.reent = reent;
+
+/* If the function is re-entrant, the points are to be passed to it in
+   more than one batch, and astRunJobs can use more than one thread,
+   divide the batches between a few jobs for each thread so that the
+   load is balanced. Each job handles a contiguous range of whole
+   batches, so the function is invoked with the same batches of points
+   as when they are processed serially. Each job is given its own copy
+   of the IntraMap, which is unlocked so that it can be locked by the
+   thread that runs the job. */
+   njob = 0;
+   jobs = NULL;
+   if ( reent && nbatch < npoint && ( nthread = astGetNThread() ) > 1 ) {
+      nbat = ( npoint + nbatch - 1 )/nbatch;
+      njob = 4*nthread;
+      if ( njob > nbat ) njob = nbat;
+      jobs = astCalloc( njob, sizeof( IntraBatch ) );
+      for ( ijob = 0; ijob < njob && astOK; ijob++ ) {
+         jobs[ ijob ] = batch;
+         jobs[ ijob ].id = NULL;
+         jobs[ ijob ].point0 = (int)( ( (double) nbat*ijob )/njob )*nbatch;
+         point1 = (int)( ( (double) nbat*( ijob + 1 ) )/njob )*nbatch;
+         if ( point1 > npoint ) point1 = npoint;
+         jobs[ ijob ].npoint = point1 - jobs[ ijob ].point0;
+         jobs[ ijob ].map = astCopy( this );
+         astManageLock( jobs[ ijob ].map, AST__UNLOCK, 1, NULL );
+      }
+   }
+
+/* Pass the points to the transformation function, either in parallel
+   jobs or all in the current thread. */
    if ( ( ok = astOK ) ) {
-      LOCK_MUTEX2;
-      ( *tran_data[ this->ifun ].tran_wrap )( tran_data[ this->ifun ].tran,
-                                              id, npoint, ncoord_in, ptr_in,
-                                              forward, ncoord_out, ptr_out,
-                                              status );
-      UNLOCK_MUTEX2;
+      if ( jobs ) {
+         astRunJobs( njob, TranBatches, jobs, sizeof( IntraBatch ) );
+      } else {
+         TranBatches( &batch, status );
+      }
 
 /* If an error occurred, report a contextual error message. To ensure
    that the location of the error appears in the message, we first clear
@@ -1906,6 +2148,17 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
       }
    }
 
+/* Lock and annul the copies of the IntraMap used by any parallel jobs. */
+   if ( jobs ) {
+      for ( ijob = 0; ijob < njob; ijob++ ) {
+         if ( jobs[ ijob ].map ) {
+            astManageLock( jobs[ ijob ].map, AST__LOCK, 1, NULL );
+            jobs[ ijob ].map = astAnnul( jobs[ ijob ].map );
+         }
+      }
+      jobs = astFree( jobs );
+   }
+
 /* Annul the external identifier. */
    id = astMakeId( astAnnulId( id ) );
 
@@ -1930,6 +2183,130 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
    return result;
 }
 
+static void TranBatches( void *data, int *status ) {
+/*
+*  Name:
+*     TranBatches
+
+*  Purpose:
+*     Pass a range of points to a transformation function in batches.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "intramap.h"
+*     void TranBatches( void *data, int *status )
+
+*  Class Membership:
+*     IntraMap member function.
+
+*  Description:
+*     This function uses the wrapper function for a transformation
+*     function to transform a range of points, passing at most "nbatch"
+*     points to the transformation function in each invocation. If
+*     required, the input coordinates for each batch are first copied
+*     into a work array so that they are not overwritten by the output
+*     coordinates. Unless the transformation function is re-entrant,
+*     only one thread may be executing any transformation function at
+*     any time.
+*
+*     If the job description includes a private copy of an IntraMap,
+*     this function may be run by astRunJobs in any thread. The copy is
+*     locked for use by the thread, and a public ID for it is passed to
+*     the transformation function.
+
+*  Parameters:
+*     data
+*        Pointer to an IntraBatch structure describing the job.
+*     status
+*        Pointer to the inherited status variable.
+
+*/
+
+/* Local Variables: */
+   AstMapping *id;               /* Public ID for the IntraMap */
+   IntraBatch *job;              /* Pointer to description of job */
+   const double **bptr_in;       /* Pointers to input data for one batch */
+   double **bptr_out;            /* Pointers to output data for one batch */
+   double *work;                 /* Copy of aliased input coordinates */
+   int coord;                    /* Loop counter for coordinates */
+   int nbatch;                   /* Maximum number of points per batch */
+   int npt;                      /* Number of points in current batch */
+   int point0;                   /* Index of first point in current batch */
+   int point1;                   /* Index of first point after the range */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* If the job has a private copy of the IntraMap, lock it for use by
+   this thread and obtain a public ID for it. Otherwise, use the
+   supplied ID. */
+   job = (IntraBatch *) data;
+   if ( job->map ) {
+      astManageLock( job->map, AST__LOCK, 1, NULL );
+      id = (AstMapping *) astMakeId( astClone( job->map ) );
+   } else {
+      id = job->id;
+   }
+
+/* Allocate the arrays of pointers used to pass each batch of points to
+   the transformation function. */
+   nbatch = job->nbatch;
+   bptr_in = astMalloc( sizeof( double * )*(size_t) job->ncoord_in );
+   bptr_out = astMalloc( sizeof( double * )*(size_t) job->ncoord_out );
+   work = job->alias ? astMalloc( sizeof( double )*(size_t) ( nbatch*job->ncoord_in ) ) : NULL;
+
+/* Use the wrapper function to invoke the transformation function on
+   each batch of points. */
+   if ( astOK ) {
+      point0 = job->point0;
+      point1 = job->point0 + job->npoint;
+      do {
+         npt = point1 - point0;
+         if ( npt > nbatch ) npt = nbatch;
+
+         for ( coord = 0; coord < job->ncoord_in; coord++ ) {
+            if ( job->alias ) {
+               if ( npt > 0 ) (void) memcpy( work + coord*nbatch,
+                                             job->ptr_in[ coord ] + point0,
+                                             sizeof( double )*(size_t) npt );
+               bptr_in[ coord ] = work + coord*nbatch;
+            } else {
+               bptr_in[ coord ] = job->ptr_in[ coord ] + point0;
+            }
+         }
+         for ( coord = 0; coord < job->ncoord_out; coord++ ) {
+            bptr_out[ coord ] = job->ptr_out[ coord ] + point0;
+         }
+
+         if ( !job->reent ) {
+            LOCK_MUTEX2;
+         }
+         ( *job->tran_wrap )( job->tran, id, npt, job->ncoord_in, bptr_in,
+                              job->forward, job->ncoord_out, bptr_out,
+                              status );
+         if ( !job->reent ) {
+            UNLOCK_MUTEX2;
+         }
+
+         point0 += npt;
+      } while( point0 < point1 && astOK );
+   }
+
+/* Free the work arrays. */
+   bptr_in = astFree( (void *) bptr_in );
+   bptr_out = astFree( bptr_out );
+   work = astFree( work );
+
+/* Annul the public ID for any private copy of the IntraMap, and unlock
+   the copy so that the calling thread can annul it. */
+   if ( job->map ) {
+      id = astMakeId( astAnnulId( id ) );
+      astManageLock( job->map, AST__UNLOCK, 1, NULL );
+   }
+}
+
 static void TranWrap( void (* tran)( AstMapping *, int, int, const double *[],
                                      int, int, double *[] ),
                       AstMapping *this, int npoint, int ncoord_in,
@@ -64,6 +64,8 @@
 *           Create an IntraMap.
 *        astIntraReg
 *           Register a transformation function for use by an IntraMap.
+*        astIntraRegBatch
+*           Register a transformation function with a preferred batch size.
 *        astIsAIntraMap
 *           Test class membership.
 *
@@ -151,6 +153,8 @@
 #define AST__NOINV (2U)          /* No inverse transformation defined */
 #define AST__SIMPFI (4U)         /* Forward-inverse may be simplified */
 #define AST__SIMPIF (8U)         /* Inverse-forward may be simplified */
+#define AST__REENT (16U)         /* Function may be invoked concurrently */
+#define AST__INPLACE (32U)       /* Output may overwrite input coordinates */
 
 #define AST__ANY (-66)           /* Allow any number of input/output coords */
 
@@ -208,6 +212,7 @@ typedef struct AstIntraMapTranData {
    char *purpose;                /* Comment string describing purpose */
    int nin;                      /* Number of input coordinates per point */
    int nout;                     /* Number of output coordinates per point */
+   int nbatch;                   /* Preferred number of points per call */
    unsigned int flags;           /* Flags to describe function behaviour */
 } AstIntraMapTranData;
 
@@ -261,6 +266,7 @@ void astInitIntraMapGlobals_( AstIntraMapGlobals * );
 /* Prototypes for member functions. */
 /* -------------------------------- */
 void astIntraReg_( const char *, int, int, void (*)( AstMapping *, int, int, const double *[], int, int, double *[] ), unsigned int, const char *, const char *, const char *, int * );
+void astIntraRegBatch_( const char *, int, int, void (*)( AstMapping *, int, int, const double *[], int, int, double *[] ), unsigned int, int, const char *, const char *, const char *, int * );
 
 #if defined(astCLASS)            /* Protected */
 const char *astGetIntraFlag_( AstIntraMap *, int * );
@@ -321,6 +327,8 @@ astINVOKE(O,astLoadIntraMap_(mem,size,vtab,name,astCheckChannel(channel),STATUS_
 
 #define astIntraReg(name,nin,nout,tran,flags,purpose,author,contact) \
 astIntraReg_(name,nin,nout,tran,flags,purpose,author,contact,STATUS_PTR)
+#define astIntraRegBatch(name,nin,nout,tran,flags,nbatch,purpose,author,contact) \
+astIntraRegBatch_(name,nin,nout,tran,flags,nbatch,purpose,author,contact,STATUS_PTR)
 
 #if defined(astCLASS)            /* Protected */
 #define astClearIntraFlag(this) \
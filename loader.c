@@ -25,6 +25,7 @@
 #include "mapping.h"
 #include "mathmap.h"
 #include "matrixmap.h"
+#include "moc.h"
 #include "nullregion.h"
 #include "object.h"
 #include "pcdmap.h"
@@ -147,6 +148,7 @@ if ( !strcmp( class, #name ) ) return (AstLoaderType *) astLoad##name##_
    LOAD(Mapping);
    LOAD(MathMap);
    LOAD(MatrixMap);
+   LOAD(Moc);
    LOAD(NullRegion);
    LOAD(Object);
    LOAD(PcdMap);
@@ -128,6 +128,10 @@ f     The LutMap class does not define any new routines beyond those
 #define LINEAR 0
 #define NEAR 1
 
+/* The minimum number of entries in the inverse lookup table for which a
+   bucket index is created to speed up the inverse transformation. */
+#define MIN_BUCKET 32
+
 /* Include files. */
 /* ============== */
 /* Interface definitions. */
@@ -189,7 +193,11 @@ astMAKE_INITGLOBALS(LutMap)
 #define class_vtab astGLOBAL(LutMap,Class_Vtab)
 #define getattrib_buff astGLOBAL(LutMap,GetAttrib_Buff)
 
-
+/* mutex1 is used to prevent the reference count for a set of shared
+   lookup tables being accessed by more than one thread at any one time. */
+static pthread_mutex_t mutex1 = PTHREAD_MUTEX_INITIALIZER;
+#define LOCK_MUTEX1 pthread_mutex_lock( &mutex1 );
+#define UNLOCK_MUTEX1 pthread_mutex_unlock( &mutex1 );
 
 /* If thread safety is not needed, declare and initialise globals at static
    variables. */
@@ -203,6 +211,9 @@ static char getattrib_buff[ 101 ];
 static AstLutMapVtab class_vtab;   /* Virtual function table */
 static int class_init = 0;       /* Virtual function table initialised? */
 
+#define LOCK_MUTEX1
+#define UNLOCK_MUTEX1
+
 #endif
 
 /* External Interface Function Prototypes. */
@@ -217,6 +228,8 @@ AstLutMap *astLutMapId_( int, const double [], double, double, const char *, ...
 static AstPointSet *Transform( AstMapping *, AstPointSet *, int, AstPointSet *, int * );
 static int GetLinear( AstMapping *, int * );
 static int GetMonotonic( int, const double *, int *, double **, int **, int **, int * );
+static int LutSearch( const double *, int, double, int, int );
+static void MakeBuckets( AstLutMap *, int * );
 static int MapMerge( AstMapping *, int, int, int *, AstMapping ***, int **, int * );
 static void Copy( const AstObject *, AstObject *, int * );
 static void Delete( AstObject *, int * );
@@ -381,11 +394,14 @@ static int Equal( AstObject *this_object, AstObject *that_object, int *status )
                 this->nlut == that->nlut &&
                 this->lutinterp == that->lutinterp ){
 
+/* There is no need to compare the tables if they are shared. */
                result = 1;
-               for( i = 0; i < this->nlut; i++ ) {
-                  if( !astEQUAL( (this->lut)[ i ], (that->lut)[ i ] ) ) {
-                     result = 0;
-                     break;
+               if( this->lut != that->lut ) {
+                  for( i = 0; i < this->nlut; i++ ) {
+                     if( !astEQUAL( (this->lut)[ i ], (that->lut)[ i ] ) ) {
+                        result = 0;
+                        break;
+                     }
                   }
                }
             }
@@ -866,6 +882,162 @@ static int GetMonotonic( int nlut, const double *lut, int *nluti, double **luti,
    return result;
 }
 
+static int LutSearch( const double *lut, int up, double value, int i1,
+                      int i2 ){
+/*
+*  Name:
+*     LutSearch
+
+*  Purpose:
+*     Find the lookup table interval that brackets a given value.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "lutmap.h"
+*     int LutSearch( const double *lut, int up, double value, int i1,
+*                    int i2 )
+
+*  Class Membership:
+*     LutMap member function.
+
+*  Description:
+*     This function performs a binary search of a monotonic lookup table
+*     (containing no bad values) to find the index of the lower of the
+*     two adjacent table entries that bracket the supplied value. The
+*     search is restricted to the range of indices (i1,i2), where "i1"
+*     should be an index for which "( value >= lut[ i1 ] ) == up" (or -1),
+*     and "i2" should be an index for which this is not true (or the index
+*     of the last table entry).
+
+*  Parameters:
+*     lut
+*        The lookup table.
+*     up
+*        Non-zero if the table values increase with index.
+*     value
+*        The value to search for.
+*     i1
+*        The lower limit of the search range (exclusive).
+*     i2
+*        The upper limit of the search range (exclusive).
+
+*  Returned Value:
+*     The index of the lower bracketing table entry, or -1 if the value
+*     lies before the first table entry. The upper bracketing table entry
+*     is always at the returned index plus one.
+
+*/
+
+/* Local Variables: */
+   int i;
+
+/* Perform a binary search to identify two adjacent lookup table
+   elements whose values bracket the input coordinate value. */
+   while ( i2 > ( i1 + 1 ) ) {
+      i = ( i1 + i2 ) / 2;
+      *( ( ( value >= lut[ i ] ) == up ) ? &i1 : &i2 ) = i;
+   }
+
+/* Return the lower index. */
+   return i1;
+}
+
+static void MakeBuckets( AstLutMap *this, int *status ){
+/*
+*  Name:
+*     MakeBuckets
+
+*  Purpose:
+*     Create a bucket index for the inverse transformation of a LutMap.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "lutmap.h"
+*     void MakeBuckets( AstLutMap *this, int *status )
+
+*  Class Membership:
+*     LutMap member function.
+
+*  Description:
+*     This function divides the range of values covered by the lookup
+*     table used by the inverse transformation into a set of equal sized
+*     buckets, and records the result of a binary search of the table for
+*     the value at each bucket boundary. The inverse transformation can
+*     then restrict the search for each point to the table entries that
+*     lie between the boundaries of the bucket containing the point,
+*     which for most tables involves only a few table entries,
+*     regardless of the size of the table.
+*
+*     Nothing is done if the index already exists, if the table is too
+*     small to benefit from an index, or if the table is entirely flat.
+
+*  Parameters:
+*     this
+*        Pointer to the LutMap.
+*     status
+*        Pointer to the inherited status variable.
+
+*/
+
+/* Local Variables: */
+   double *lut;
+   double hi;
+   double lo;
+   double width;
+   int ibucket;
+   int nlut;
+   int up;
+
+/* Check the global error status, and whether the index already exists. */
+   if ( !astOK || this->ibucket ) return;
+
+/* Get the table used by the inverse transformation. This excludes any
+   bad values. */
+   if( this->luti ) {
+      lut = this->luti;
+      nlut = this->nluti;
+   } else {
+      lut = this->lut;
+      nlut = this->nlut;
+   }
+
+/* Do nothing if the table is too small to benefit from an index. */
+   if( nlut < MIN_BUCKET ) return;
+
+/* Get the range of values in the table. The table is monotonic so the
+   extreme values are at the ends. Do nothing if the table is flat. */
+   up = ( lut[ nlut - 1 ] > lut[ 0 ] );
+   lo = up ? lut[ 0 ] : lut[ nlut - 1 ];
+   hi = up ? lut[ nlut - 1 ] : lut[ 0 ];
+   if( hi <= lo ) return;
+
+/* Use one bucket for each interval in the table, so that a table with
+   evenly spaced values has one table entry per bucket. Allocate an array
+   to hold the search result at the start of each bucket, plus one for the
+   end of the last bucket. */
+   this->nbucket = nlut - 1;
+   this->ibucket = astMalloc( sizeof( int )*( this->nbucket + 1 ) );
+   if( astOK ) {
+      width = ( hi - lo )/this->nbucket;
+      this->bucketlo = lo;
+      this->buckethi = hi;
+      this->bucketscale = 1.0/width;
+
+/* Store the index of the lower bracketing table entry for the value at
+   each bucket boundary. */
+      for( ibucket = 0; ibucket <= this->nbucket; ibucket++ ) {
+         this->ibucket[ ibucket ] = LutSearch( lut, up, lo + ibucket*width,
+                                               -1, nlut - 1 );
+      }
+   } else {
+      this->nbucket = 0;
+   }
+}
+
 void astInitLutMapVtab_(  AstLutMapVtab *vtab, const char *name, int *status ) {
 /*
 *+
@@ -1475,6 +1647,9 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
    int i1;                       /* Lower adjacent LUT index */
    int i2;                       /* Upper adjacent LUT index */
    int i;                        /* New LUT index */
+   int ibucket;                  /* Index of bucket containing input value */
+   int ihi;                      /* Upper LUT index limit for bucket */
+   int ilo;                      /* Lower LUT index limit for bucket */
    int istart;                   /* Original LUT index at start of interval */
    int ix;                       /* "x" converted to an int */
    int near;                     /* Perform nearest neighbour interpolation? */
@@ -1627,6 +1802,12 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
          near = ( astGetLutInterp( map ) == NEAR );
          nlutm1 = nlut - 1;
 
+/* If the table is large, ensure the LutMap has a bucket index that can
+   be used to speed up the search of the table for each point. The index
+   is created when first needed and then retained for use by subsequent
+   calls. */
+         if( npoint > 1 ) MakeBuckets( map, status );
+
 /* Loop to transform each input point. */
          for ( point = 0; point < npoint; point++ ) {
 
@@ -1650,15 +1831,43 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
             } else {
                up = ( lut[ nlutm1 ] > lut[ 0 ] );
 
-/* Perform a binary search to identify two adjacent lookup table
-   elements whose values bracket the input coordinate value. */
+/* By default, search the whole table. */
                i1 = -1;
                i2 = nlutm1;
-               while ( i2 > ( i1 + 1 ) ) {
-                  i = ( i1 + i2 ) / 2;
-                  *( ( ( value_in >= lut[ i ] ) == up ) ? &i1 : &i2 ) = i;
+
+/* If the LutMap has a bucket index, and the input value falls within the
+   range covered by the index, restrict the search to the table entries
+   that bracket the boundaries of the bucket containing the input value.
+   Check that the resulting limits do in fact bracket the input value
+   (they may not if rounding has put the value into a neighbouring
+   bucket), and use the whole table if not. */
+               if( map->ibucket && value_in >= map->bucketlo &&
+                                   value_in <= map->buckethi ) {
+                  ibucket = (int)( ( value_in - map->bucketlo )*
+                                   map->bucketscale );
+                  if( ibucket >= map->nbucket ) ibucket = map->nbucket - 1;
+
+                  ilo = map->ibucket[ ibucket ];
+                  ihi = map->ibucket[ ibucket + 1 ];
+                  if( ilo > ihi ) {
+                     i = ilo;
+                     ilo = ihi;
+                     ihi = i;
+                  }
+                  ihi++;
+
+                  if( ( ilo == -1 || ( value_in >= lut[ ilo ] ) == up ) &&
+                      ( ihi == nlutm1 || ( value_in >= lut[ ihi ] ) != up ) ) {
+                     i1 = ilo;
+                     i2 = ihi;
+                  }
                }
 
+/* Perform a binary search to identify two adjacent lookup table
+   elements whose values bracket the input coordinate value. */
+               i1 = LutSearch( lut, up, value_in, i1, i2 );
+               i2 = i1 + 1;
+
 /* If the lower table value is equal to the required value, and either of
    its neighbours is also equal to the required value, then we have been
    asked to find the inverse in a flat region of the table, so return
@@ -1877,23 +2086,28 @@ static void Copy( const AstObject *objin, AstObject *objout, int *status ) {
    in= (AstLutMap *) objin;
    out = (AstLutMap *) objout;
 
-/* Nullify all output pointers. */
-   out->lut = NULL;
-   out->luti = NULL;
-   out->flagsi = NULL;
-   out->indexi = NULL;
-
-/* Allocate memory and store a copy of the lookup table data. */
-   out->lut = astStore( NULL, in->lut,
-                        sizeof( double ) * (size_t) in->nlut );
-
-/* Do the arrays used for the inverse transformation, if they exist. */
-   if( in->luti ) out->luti = astStore( NULL, in->luti,
-                                        sizeof( double ) * (size_t) in->nluti );
-   if( in->flagsi ) out->flagsi = astStore( NULL, in->flagsi,
-                                        sizeof( double ) * (size_t) in->nluti );
-   if( in->indexi ) out->indexi = astStore( NULL, in->indexi,
-                                        sizeof( double ) * (size_t) in->nluti );
+/* The lookup table, and the arrays used for the inverse transformation,
+   are never changed once the LutMap has been created. So instead of
+   copying them, the new LutMap shares them with the input LutMap. They
+   are freed when the last LutMap using them is deleted. They are held in
+   ordinary memory rather than in a memory-mapped file, since the table
+   is supplied as an array when the LutMap is created (or read from a
+   Channel), and so there is no file from which it could be mapped.
+   Increment the count of LutMaps that are using them. */
+   out->lut = in->lut;
+   out->luti = in->luti;
+   out->flagsi = in->flagsi;
+   out->indexi = in->indexi;
+   out->nref = in->nref;
+
+   LOCK_MUTEX1
+   ( *(out->nref) )++;
+   UNLOCK_MUTEX1
+
+/* The bucket index used by the inverse transformation is not copied. It
+   will be re-created by the new LutMap when it is next needed. */
+   out->ibucket = NULL;
+   out->nbucket = 0;
 }
 
 /* Destructor. */
@@ -1924,15 +2138,38 @@ static void Delete( AstObject *obj, int *status ) {
 
 /* Local Variables: */
    AstLutMap *this;              /* Pointer to LutMap */
+   int last;                     /* Is this the last user of the tables? */
 
 /* Obtain a pointer to the LutMap structure. */
    this = (AstLutMap *) obj;
 
-/* Free the memory holding the lookup tables, etc. */
-   this->lut = astFree( this->lut );
-   this->luti = astFree( this->luti );
-   this->flagsi = astFree( this->flagsi );
-   this->indexi = astFree( this->indexi );
+/* Decrement the count of LutMaps that share the lookup tables. */
+   if( this->nref ) {
+      LOCK_MUTEX1
+      last = ( --( *(this->nref) ) == 0 );
+      UNLOCK_MUTEX1
+   } else {
+      last = 1;
+   }
+
+/* Free the memory holding the lookup tables, etc, if no other LutMap is
+   using them. Otherwise, just nullify the pointers. */
+   if( last ) {
+      this->lut = astFree( this->lut );
+      this->luti = astFree( this->luti );
+      this->flagsi = astFree( this->flagsi );
+      this->indexi = astFree( this->indexi );
+      this->nref = astFree( this->nref );
+   } else {
+      this->lut = NULL;
+      this->luti = NULL;
+      this->flagsi = NULL;
+      this->indexi = NULL;
+      this->nref = NULL;
+   }
+
+/* The bucket index is never shared. */
+   this->ibucket = astFree( this->ibucket );
 }
 
 /* Dump function. */
@@ -2403,10 +2640,17 @@ AstLutMap *astInitLutMap_( void *mem, size_t size, int init,
          new->luti = luti;
          new->flagsi = flagsi;
          new->indexi = indexi;
+         new->ibucket = NULL;
+         new->nbucket = 0;
 
 /* Allocate memory and store the lookup table. */
          new->lut = astStore( NULL, lut, sizeof( double ) * (size_t) nlut );
 
+/* The lookup tables may be shared with copies of the LutMap. Create
+   the count of LutMaps that use them. */
+         new->nref = astMalloc( sizeof( int ) );
+         if( astOK ) *(new->nref) = 1;
+
 /* Replace an NaN values by AST__BAD */
          p = new->lut;
          for ( ilut = 0; ilut < nlut; ilut++, p++ ) {
@@ -2558,6 +2802,14 @@ AstLutMap *astLoadLutMap_( void *mem, size_t size,
 /* Number of lookup table elements. */
       new->nlut = astReadInt( channel, "nlut", 2 );
 
+/* The bucket index is created when first needed. */
+      new->ibucket = NULL;
+      new->nbucket = 0;
+
+/* Create the count of LutMaps that share the lookup tables. */
+      new->nref = astMalloc( sizeof( int ) );
+      if( astOK ) *(new->nref) = 1;
+
 /* Starting input coordinate value. */
       new->start = astReadDouble( channel, "start", 0.0 );
 
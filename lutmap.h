@@ -156,6 +156,9 @@ typedef struct AstLutMap {
 /* Attributes specific to objects in this class. */
    double *lut;                 /* Pointer to lookup table */
    double *luti;                /* Reduced lookup table for inverse trans. */
+   double bucketlo;             /* Table value at start of first bucket */
+   double buckethi;             /* Table value at end of last bucket */
+   double bucketscale;          /* Buckets per unit change in table value */
    double inc;                  /* Input increment between table entries */
    double last_fwd_in;          /* Last input value (forward transfm.) */
    double last_fwd_out;         /* Last output value (forward transfm.) */
@@ -164,10 +167,13 @@ typedef struct AstLutMap {
    double start;                /* Input value for first table entry */
    int *flagsi;                 /* Flags indicating adjacent bad values */
    int *indexi;                 /* Translates reduced to original indices */
+   int *ibucket;                /* Inverse search start index for each bucket */
+   int *nref;                   /* No. of LutMaps sharing the above tables */
    double lutepsilon;           /* Relative error of table values */
    int lutinterp;               /* Interpolation method */
    int nlut;                    /* Number of table entries */
    int nluti;                   /* Reduced number of table entries */
+   int nbucket;                 /* Number of buckets in "ibucket" */
 } AstLutMap;
 
 /* Virtual function table. */
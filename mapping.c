@@ -668,6 +668,7 @@ static double MaxD( double, double, int * );
 static double NewVertex( const MapData *, int, double, double [], double [], int *, double [], int * );
 static double Random( long int *, int * );
 static double Rate( AstMapping *, double *, int, int, int * );
+static int RateIsExact( AstMapping *, int * );
 static double UphillSimplex( const MapData *, double, int, const double [], double [], double *, int *, int * );
 static int *MapSplit( AstMapping *, int, const int *, AstMapping **, int * );
 static int Equal( AstObject *, AstObject *, int * );
@@ -2517,6 +2518,7 @@ VTAB_GENERIC(LD)
    vtab->ClearReport = ClearReport;
    vtab->Decompose = Decompose;
    vtab->DoNotSimplify = DoNotSimplify;
+   vtab->RateIsExact = RateIsExact;
    vtab->GetInvert = GetInvert;
    vtab->GetIsLinear = GetIsLinear;
    vtab->GetIsSimple = GetIsSimple;
@@ -10065,6 +10067,57 @@ MAKE_REBIN(UB,unsigned char,1)
 /* Undefine the macro. */
 #undef MAKE_REBIN
 
+static int RateIsExact( AstMapping *this, int *status ) {
+/*
+*+
+*  Name:
+*     astRateIsExact
+
+*  Purpose:
+*     Check if the astRate method of a Mapping is exact.
+
+*  Type:
+*     Protected virtual function.
+
+*  Synopsis:
+*     #include "mapping.h"
+*     int astRateIsExact( AstMapping *this );
+
+*  Class Membership:
+*     Mapping method.
+
+*  Description:
+*     This function returns a flag indicating if the astRate method of
+*     the supplied Mapping evaluates the rate of change analytically
+*     (non-zero), or estimates it numerically by evaluating the Mapping
+*     many times (zero). It is used by compound Mappings to decide whether
+*     to combine the rates of their component Mappings using the chain
+*     rule, or to estimate the rate numerically for the compound Mapping
+*     as a whole.
+*
+*     The Mapping class estimates all rates numerically, and so always
+*     returns zero. Sub-classes that over-ride astRate with an analytic
+*     implementation should also over-ride this method.
+
+*  Parameters:
+*     this
+*        Pointer to the Mapping.
+
+*  Returned Value:
+*     Non-zero if the astRate method of the supplied Mapping is exact, and
+*     zero otherwise.
+
+*  Notes:
+*     - A value of 0 will be returned if this function is invoked
+*     with the global error status set, or if it should fail for any
+*     reason.
+*-
+*/
+
+/* The Mapping class uses numerical differentiation. */
+   return 0;
+}
+
 static int RebinAdaptively( AstMapping *this, int ndim_in,
                             const int *lbnd_in, const int *ubnd_in,
                             const void *in, const void *in_var,
@@ -23801,6 +23854,10 @@ int astDoNotSimplify_( AstMapping *this, int *status ) {
    if ( !astOK ) return 0;
    return (**astMEMBER(this,Mapping,DoNotSimplify))( this, status );
 }
+int astRateIsExact_( AstMapping *this, int *status ) {
+   if ( !astOK ) return 0;
+   return (**astMEMBER(this,Mapping,RateIsExact))( this, status );
+}
 void astReportPoints_( AstMapping *this, int forward,
                        AstPointSet *in_points, AstPointSet *out_points, int *status ) {
    if ( !astOK ) return;
@@ -24455,6 +24512,12 @@ f     This routine
 *     polynomial and the supplied Mapping function. This method produces
 *     good accuracy but can involve evaluating the Mapping 100 or more
 *     times.
+*
+*     Some classes of Mapping (for instance, the linear Mappings, PolyMap,
+*     ChebyMap and SphMap) instead evaluate the rate of change exactly
+*     using an analytic expression. A series CmpMap in which all the
+*     component Mappings have analytic rates combines them using the chain
+*     rule.
 
 *  Parameters:
 c     this
@@ -451,6 +451,7 @@ typedef struct AstMappingVtab {
    AstPointSet *(* Transform)( AstMapping *, AstPointSet *, int, AstPointSet *, int * );
    double (* Rate)( AstMapping *, double *, int, int, int * );
    int (* DoNotSimplify)( AstMapping *, int * );
+   int (* RateIsExact)( AstMapping *, int * );
    int (* GetInvert)( AstMapping *, int * );
    int (* GetIsSimple)( AstMapping *, int * );
    int (* GetNin)( AstMapping *, int * );
@@ -665,6 +666,7 @@ int astGetTranForward_( AstMapping *, int * );
 int astGetTranInverse_( AstMapping *, int * );
 int astGetIsLinear_( AstMapping *, int * );
 int astDoNotSimplify_( AstMapping *, int * );
+int astRateIsExact_( AstMapping *, int * );
 int astMapMerge_( AstMapping *, int, int, int *, AstMapping ***, int **, int * );
 int astTestInvert_( AstMapping *, int * );
 int astTestReport_( AstMapping *, int * );
@@ -841,6 +843,8 @@ astINVOKE(V,astTestInvert_(astCheckMapping(this),STATUS_PTR))
 astINVOKE(V,astTestReport_(astCheckMapping(this),STATUS_PTR))
 #define astDoNotSimplify(this) \
 astINVOKE(V,astDoNotSimplify_(astCheckMapping(this),STATUS_PTR))
+#define astRateIsExact(this) \
+astINVOKE(V,astRateIsExact_(astCheckMapping(this),STATUS_PTR))
 
 /* Since a NULL PointSet pointer is acceptable here, we must omit the argument
    checking in that case. (But unfortunately, "out" then gets evaluated
@@ -38,6 +38,7 @@ f     interpreted by other programs.
 *  Attributes:
 *     In addition to those attributes common to all Mappings, every
 *     MathMap also has the following attributes:
+*     - IndexedRand: Random numbers depend only on Seed and point index?
 *     - Seed: Random number seed
 *     - SimpFI: Forward-inverse MathMap pairs simplify?
 *     - SimpIF: Inverse-forward MathMap pairs simplify?
@@ -95,6 +96,11 @@ f     The MathMap class does not define any new routines beyond those
    "protected" symbols available. */
 #define astCLASS MathMap
 
+/* The maximum number of points processed in each pass through the
+   evaluation stack. Transforming large PointSets in tiles of this size
+   keeps the stack and any intermediate results in cache. */
+#define TILE_SIZE 1024
+
 /* Allocate pointer array. */
 /* ----------------------- */
 /* This macro allocates an array of pointers. If successful, each element
@@ -333,6 +339,20 @@ typedef enum {
    OP_OR,                        /* Boolean OR */
    OP_XOR,                       /* Boolean exclusive OR */
 
+/* Fused operations. These are never produced directly by parsing an
+   expression, but replace common sequences of the above operations (see
+   FuseOperations) so that they may be evaluated in a single pass. */
+   OP_FATAN2,                    /* atan2 of two variables */
+   OP_FATAN2D,                   /* atan2d of two variables */
+   OP_FCOS,                      /* cos of a scaled variable */
+   OP_FCOSD,                     /* cosd of a scaled variable */
+   OP_FHYPOT,                    /* sqrt(x*x+y*y) of two variables */
+   OP_FMULADD,                   /* Variable times constant plus constant */
+   OP_FSIN,                      /* sin of a scaled variable */
+   OP_FSIND,                     /* sind of a scaled variable */
+   OP_FTAN,                      /* tan of a scaled variable */
+   OP_FTAND,                     /* tand of a scaled variable */
+
 /* Null operation. */
    OP_NULL                       /* Null operation */
 } Oper;
@@ -597,18 +617,22 @@ static double Gauss( Rcontext *, int * );
 static double LogGamma( double, int * );
 static double Poisson( Rcontext *, double, int * );
 static double Rand( Rcontext *, int * );
+static UINT_BIG HashRand( UINT_BIG, int * );
 static int DefaultSeed( const Rcontext *, int * );
 static int Equal( AstObject *, AstObject *, int * );
+static int GetIndexedRand( AstMathMap *, int * );
 static int GetSeed( AstMathMap *, int * );
 static int GetSimpFI( AstMathMap *, int * );
 static int GetSimpIF( AstMathMap *, int * );
 static int MapMerge( AstMapping *, int, int, int *, AstMapping ***, int **, int * );
 static int TestAttrib( AstObject *, const char *, int * );
+static int TestIndexedRand( AstMathMap *, int * );
 static int TestSeed( AstMathMap *, int * );
 static int TestSimpFI( AstMathMap *, int * );
 static int TestSimpIF( AstMathMap *, int * );
 static void CleanFunctions( int, const char *[], char ***, int * );
 static void ClearAttrib( AstObject *, const char *, int * );
+static void ClearIndexedRand( AstMathMap *, int * );
 static void ClearSeed( AstMathMap *, int * );
 static void ClearSimpFI( AstMathMap *, int * );
 static void ClearSimpIF( AstMathMap *, int * );
@@ -617,14 +641,19 @@ static void CompileMapping( const char *, const char *, int, int, int, const cha
 static void Copy( const AstObject *, AstObject *, int * );
 static void Delete( AstObject *, int * );
 static void Dump( AstObject *, AstChannel *, int * );
-static void EvaluateFunction( Rcontext *, int, const double **, const int *, const double *, int, double *, int * );
+static void EvaluateFunction( Rcontext *, int, const double **, const int *, const double *, int, double *, double *, int * );
 static void EvaluationSort( const double [], int, int [], int **, int *, int * );
 static void ExtractExpressions( const char *, const char *, int, const char *[], int, char ***, int * );
 static void ExtractVariables( const char *, const char *, int, const char *[], int, int, int, int, int, char ***, int * );
+static void FoldConstants( int **, double **, int, int * );
+static void FuseOperations( int **, double **, int * );
+static int OpcodeArgs( Oper, const double *, int *, int * );
+static int UsesRandom( int, int **, int * );
 static void ParseConstant( const char *, const char *, const char *, int, int *, double *, int * );
 static void ParseName( const char *, int, int *, int * );
 static void ParseVariable( const char *, const char *, const char *, int, int, const char *[], int *, int *, int * );
 static void SetAttrib( AstObject *, const char *, int * );
+static void SetIndexedRand( AstMathMap *, int, int * );
 static void SetSeed( AstMathMap *, int, int * );
 static void SetSimpFI( AstMathMap *, int, int * );
 static void SetSimpIF( AstMathMap *, int, int * );
@@ -774,9 +803,14 @@ static void ClearAttrib( AstObject *this_object, const char *attrib, int *status
 
 /* Check the attribute name and clear the appropriate attribute. */
 
+/* IndexedRand. */
+/* ------------ */
+   if ( !strcmp( attrib, "indexedrand" ) ) {
+      astClearIndexedRand( this );
+
 /* Seed. */
 /* ----- */
-   if ( !strcmp( attrib, "seed" ) ) {
+   } else if ( !strcmp( attrib, "seed" ) ) {
       astClearSeed( this );
 
 /* SimpFI. */
@@ -899,6 +933,12 @@ static void CompileExpression( const char *method, const char *class,
 *     also substitutes operation codes (defined in the "Oper" enum) for the
 *     symbol numbers and calculates the size of evaluation stack which will
 *     be required.
+*
+*     Finally, the FoldConstants function is invoked to replace any
+*     sequence of operations that depends only on constant values with a
+*     single operation that loads the constant result, and the
+*     FuseOperations function is invoked to replace common sequences of
+*     operations on input variables with fused operations.
 
 *  Notes:
 *     - A value of NULL will be returned for the "*code" and "*con" pointers
@@ -1123,6 +1163,14 @@ static void CompileExpression( const char *method, const char *class,
       *con = astRealloc( *con, sizeof( double ) * (size_t) ncon );
    }
 
+/* Replace any operations that act only on constant values with the
+   constant result. */
+   FoldConstants( code, con, *stacksize, status );
+
+/* Replace common sequences of operations with fused operations that
+   can be evaluated in a single pass through the data. */
+   FuseOperations( code, con, status );
+
 /* If an error occurred, free any allocated memory and reset the
    output values. */
    if ( !astOK ) {
@@ -1614,11 +1662,14 @@ static int Equal( AstObject *this_object, AstObject *that_object, int *status )
    int icode;                 /* Opcode index */
    int icon;                  /* Constant index */
    int ifun;                  /* Function index */
+   int jcon;                  /* Constant offset within current opcode */
    int ncode;                 /* No. of opcodes for current "this" function */
+   int nconop;                /* No. of constants used by current opcode */
    int ncode_that;            /* No. of opcodes for current "that" function */
    int nin;                   /* Number of inputs */
    int nout;                  /* Number of outputs */
    int pass;                  /* Check fwd or inv */
+   int pure;                  /* Does opcode depend only on its arguments? */
    int result;                /* Result value to return */
    int that_nfun;             /* Number of functions from "that" */
    int this_nfun;             /* Number of functions from "this" */
@@ -1713,29 +1764,40 @@ static int Equal( AstObject *this_object, AstObject *that_object, int *status )
                if( ncode != ncode_that ) result = 0;
 
 /* Compare the following opcodes. Some opcodes consume constants from the
-   list of constants associated with the MathMap. Compare the constants
-   for such opcodes. */
+   list of constants associated with the MathMap (including the fused
+   opcodes, which hold variable indices as well as constants). Compare
+   all the constants used by each opcode. */
                icon = 0;
-               for( icode = 0; icode < ncode && result; icode++ ){
+               for( icode = 1; icode <= ncode && result; icode++ ){
                   code = this_code[ ifun ][ icode ];
                   if( that_code[ ifun ][ icode ] != code ) {
                      result = 0;
 
-                  } else if( code == OP_LDCON ||
-                             code == OP_LDVAR ||
-                             code == OP_MAX ||
-                             code == OP_MIN ) {
-
-                     if( this_con[ ifun ][ icon ] !=
-                         that_con[ ifun ][ icon ] ) {
-                        result = 0;
-                     } else {
-                        icon++;
+                  } else if( code != OP_NULL ) {
+                     (void) OpcodeArgs( (Oper) code, this_con[ ifun ] + icon,
+                                        &nconop, &pure );
+                     for( jcon = 0; jcon < nconop; jcon++ ) {
+                        if( this_con[ ifun ][ icon + jcon ] !=
+                            that_con[ ifun ][ icon + jcon ] ) {
+                           result = 0;
+                           break;
+                        }
                      }
+                     icon += nconop;
                   }
                }
             }
          }
+
+/* If the functions use random numbers, the MathMaps are only equal if
+   they generate the same random numbers, which requires them to have the
+   same IndexedRand and Seed values. */
+         if( result &&
+             ( ( this->fwdcode && UsesRandom( this->nfwd, this->fwdcode, status ) ) ||
+               ( this->invcode && UsesRandom( this->ninv, this->invcode, status ) ) ) ) {
+            if( astGetIndexedRand( this ) != astGetIndexedRand( that ) ||
+                astGetSeed( this ) != astGetSeed( that ) ) result = 0;
+         }
       }
    }
 
@@ -1748,7 +1810,8 @@ static int Equal( AstObject *this_object, AstObject *that_object, int *status )
 
 static void EvaluateFunction( Rcontext *rcontext, int npoint,
                               const double **ptr_in, const int *code,
-                              const double *con, int stacksize, double *out, int *status ) {
+                              const double *con, int stacksize, double *work,
+                              double *out, int *status ) {
 /*
 *  Name:
 *     EvaluateFunction
@@ -1763,7 +1826,8 @@ static void EvaluateFunction( Rcontext *rcontext, int npoint,
 *     #include "mathmap.h"
 *     void EvaluateFunction( Rcontext *rcontext, int npoint,
 *                            const double **ptr_in, const int *code,
-*                            const double *con, int stacksize, double *out, int *status )
+*                            const double *con, int stacksize, double *work,
+*                            double *out, int *status )
 
 *  Class Membership:
 *     MathMap member function.
@@ -1801,6 +1865,10 @@ static void EvaluateFunction( Rcontext *rcontext, int npoint,
 *        The size of the stack required to evaluate the expression using the
 *        opcodes and constants supplied. This value should be calculated during
 *        expression compilation.
+*     work
+*        Pointer to an array of double (with at least "npoint*(stacksize-1)"
+*        elements) which is used as workspace to hold the elements of the
+*        stack.
 *     out
 *        Pointer to an array of double (with "npoint" elements) in which to
 *        return the vector of result values.
@@ -1828,8 +1896,9 @@ static void EvaluateFunction( Rcontext *rcontext, int npoint,
       1UL << ( bits - 1 );
 
 /* Local Variables: */
+   const double *vv1;            /* Pointer to first input variable vector */
+   const double *vv2;            /* Pointer to second input variable vector */
    double **stack;               /* Array of pointers to stack elements */
-   double *work;                 /* Pointer to stack workspace */
    double *xv1;                  /* Pointer to first argument vector */
    double *xv2;                  /* Pointer to second argument vector */
    double *xv3;                  /* Pointer to third argument vector */
@@ -1907,15 +1976,10 @@ static void EvaluateFunction( Rcontext *rcontext, int npoint,
    workspace stack (each stack element being an array of double). */
    stack = astMalloc( sizeof( double * ) * (size_t) stacksize );
 
-/* Allocate space for the stack itself. */
-   work = astMalloc( sizeof( double ) *
-                     (size_t) ( npoint * ( stacksize - 1 ) ) );
-
 /* If OK, then initialise the stack pointer array to identify the
    start of each vector on the stack. The first element points at the
    output array (in which the result will be accumulated), while other
-   elements point at successive vectors within the workspace allocated
-   above. */
+   elements point at successive vectors within the supplied workspace. */
    if ( astOK ) {
       stack[ 0 ] = out;
       for ( istk = 1; istk < stacksize; istk++ ) {
@@ -2492,6 +2556,19 @@ static void EvaluateFunction( Rcontext *rcontext, int npoint,
    variable. */ \
    result = ldexp( result, expon )
 
+/* Indexed random numbers. */
+/* ------------------------ */
+/* This macro records the index of the current point and operation in
+   the random number generator context before a random number function
+   is evaluated for a point. If the indexed generator is in use, these
+   determine the random values produced (see Rand). */
+#define RAND_INDEX \
+   if ( rcontext->indexed ) { \
+      rcontext->point = rcontext->base + point; \
+      rcontext->oper = icode; \
+      rcontext->ndraw = 0; \
+   }
+
 /* Gaussian random number. */
 /* ----------------------- */
 /* This macro expands to code which assigns a pseudo-random value to
@@ -2516,6 +2593,95 @@ static void EvaluateFunction( Rcontext *rcontext, int npoint,
    overflow. */ \
    } while ( result == AST__BAD );
 
+/* Fused operation on a scaled variable. */
+/* -------------------------------------- */
+/* This macro performs an operation on an input variable multiplied by
+   a constant, which results in the insertion of a new vector on to the
+   stack. It is equivalent to the sequence OP_LDVAR, OP_LDCON, OP_MUL
+   followed by an operation on the product, but makes a single pass
+   through the data. The variable index and the constant are obtained by
+   consuming two constants, and any further constants required are
+   consumed by the "setup" code. */
+#define ARG_SCALED(oper,setup,function) \
+\
+/* Test for the required opcode value. */ \
+   case oper: \
+\
+/* Obtain the input variable and the constant factor, then perform any \
+   required initialisation. */ \
+      ivar = (int) ( con[ icon++ ] + 0.5 ); \
+      x2 = con[ icon++ ]; \
+      vv1 = ptr_in[ ivar ]; \
+      {setup;} \
+\
+/* Increment the top of stack index and obtain a pointer to the new stack \
+   element (vector). */ \
+      yv = stack[ ++tos ]; \
+\
+/* Loop to access each vector element, obtaining a pointer to it. Form \
+   the product of the variable and constant, checking for bad values in \
+   the same way as OP_MUL. */ \
+      for ( point = 0; point < npoint; point++ ) { \
+         y = yv + point; \
+         if ( ( ( x1 = vv1[ point ] ) != AST__BAD ) && ( x2 != AST__BAD ) && \
+              ( ( x = SAFE_MUL( x1, x2 ) ) != AST__BAD ) ) { \
+\
+/* Perform the processing, which uses the product and then assigns the \
+   result to this element. */ \
+            {function;} \
+\
+/* If any value was bad, so is the result. */ \
+         } else { \
+            *y = AST__BAD; \
+         } \
+      } \
+\
+/* Break out of the "case" block. */ \
+      break;
+
+/* Fused operation on a pair of variables. */
+/* --------------------------------------- */
+/* This macro performs an operation on two input variables, which
+   results in the insertion of a new vector on to the stack. It is
+   equivalent to loading each variable with OP_LDVAR followed by one or
+   more operations on the loaded values, but makes a single pass through
+   the data. The variable indices are obtained by consuming two
+   constants. */
+#define ARG_PAIR(oper,function) \
+\
+/* Test for the required opcode value. */ \
+   case oper: \
+\
+/* Obtain the two input variables. */ \
+      ivar = (int) ( con[ icon++ ] + 0.5 ); \
+      vv1 = ptr_in[ ivar ]; \
+      ivar = (int) ( con[ icon++ ] + 0.5 ); \
+      vv2 = ptr_in[ ivar ]; \
+\
+/* Increment the top of stack index and obtain a pointer to the new stack \
+   element (vector). */ \
+      yv = stack[ ++tos ]; \
+\
+/* Loop to access each vector element, obtaining a pointer to it and \
+   checking that neither variable value is bad. */ \
+      for ( point = 0; point < npoint; point++ ) { \
+         y = yv + point; \
+         if ( ( ( x1 = vv1[ point ] ) != AST__BAD ) && \
+              ( ( x2 = vv2[ point ] ) != AST__BAD ) ) { \
+\
+/* Perform the processing, which uses the two values and then assigns \
+   the result to this element. */ \
+            {function;} \
+\
+/* If either value was bad, so is the result. */ \
+         } else { \
+            *y = AST__BAD; \
+         } \
+      } \
+\
+/* Break out of the "case" block. */ \
+      break;
+
 /* Implement the stack-based arithmetic. */
 /* ===================================== */
 /* Initialise the top of stack index and constant counter. */
@@ -2626,7 +2792,8 @@ static void EvaluateFunction( Rcontext *rcontext, int npoint,
             ARG_1( OP_LOG10,    *y = ( x > 0.0 ) ? log10( x ) : AST__BAD )
             ARG_1( OP_NINT,     *y = ( x >= 0 ) ?
                                      floor( x + 0.5 ) : ceil( x - 0.5 ) )
-            ARG_1( OP_POISS,    *y = Poisson( rcontext, x, status ) )
+            ARG_1( OP_POISS,    RAND_INDEX;
+                                *y = Poisson( rcontext, x, status ) )
             ARG_1( OP_SECH,     *y = ( x = CATCH_MATHS_OVERFLOW( cosh( x ) ),
                                        ( x == AST__BAD ) ? 0.0 : 1.0 / x ) )
             ARG_1( OP_SIN,      *y = sin( x ) )
@@ -2645,11 +2812,11 @@ static void EvaluateFunction( Rcontext *rcontext, int npoint,
             ARG_2( OP_ATAN2,    *y = atan2( x1, x2 ) )
             ARG_2( OP_ATAN2D,   *y = atan2( x1, x2 ) * r2d )
             ARG_2( OP_DIM,      *y = ( x1 > x2 ) ? x1 - x2 : 0.0 )
-            ARG_2( OP_GAUSS,    GAUSS( x1, x2 ); *y = result )
+            ARG_2( OP_GAUSS,    RAND_INDEX; GAUSS( x1, x2 ); *y = result )
             ARG_2( OP_MOD,      *y = ( x2 != 0.0 ) ?
                                      fmod( x1, x2 ) : AST__BAD )
             ARG_2( OP_POW,      *y = CATCH_MATHS_ERROR( pow( x1, x2 ) ) )
-            ARG_2( OP_RAND,     ran = Rand( rcontext, status );
+            ARG_2( OP_RAND,     RAND_INDEX; ran = Rand( rcontext, status );
                                 *y = x1 * ran + x2 * ( 1.0 - ran ); )
             ARG_2( OP_SIGN,     *y = ( ( x1 >= 0.0 ) == ( x2 >= 0.0 ) ) ?
                                      x1 : -x1 )
@@ -2720,6 +2887,29 @@ static void EvaluateFunction( Rcontext *rcontext, int npoint,
             ARG_2( OP_EQV,      *y = ( ( x1 != 0.0 ) == ( x2 != 0.0 ) ) )
             ARG_2B( OP_OR,      *y = TRISTATE_OR( x1, x2 ) )
             ARG_2( OP_XOR,      *y = ( ( x1 != 0.0 ) != ( x2 != 0.0 ) ) )
+
+/* Fused operations. */
+/* ----------------- */
+/* These replace sequences of the above operations and must give
+   identical results, so they use the same expressions. Operations on a
+   scaled variable receive the product of the variable and constant in
+   "x". */
+            ARG_SCALED( OP_FMULADD, x3 = con[ icon++ ],
+                                *y = ( x3 != AST__BAD ) ?
+                                     SAFE_ADD( x, x3 ) : AST__BAD )
+            ARG_SCALED( OP_FCOS,  ;, *y = cos( x ) )
+            ARG_SCALED( OP_FCOSD, ;, *y = cos( x * d2r ) )
+            ARG_SCALED( OP_FSIN,  ;, *y = sin( x ) )
+            ARG_SCALED( OP_FSIND, ;, *y = sin( x * d2r ) )
+            ARG_SCALED( OP_FTAN,  ;, *y = CATCH_MATHS_OVERFLOW( tan( x ) ) )
+            ARG_SCALED( OP_FTAND, ;, *y = tan( x * d2r ) )
+
+            ARG_PAIR( OP_FATAN2,  *y = atan2( x1, x2 ) )
+            ARG_PAIR( OP_FATAN2D, *y = atan2( x1, x2 ) * r2d )
+            ARG_PAIR( OP_FHYPOT,  *y = ( ( ( x1 = SAFE_MUL( x1, x1 ) ) != AST__BAD ) &&
+                                         ( ( x2 = SAFE_MUL( x2, x2 ) ) != AST__BAD ) &&
+                                         ( ( x = SAFE_ADD( x1, x2 ) ) != AST__BAD ) ) ?
+                                       sqrt( x ) : AST__BAD )
          }
       }
    }
@@ -2728,8 +2918,7 @@ static void EvaluateFunction( Rcontext *rcontext, int npoint,
    evaluation will reside in the lowest stack entry - i.e. the output
    array. */
 
-/* Free the workspace arrays. */
-   work = astFree( work );
+/* Free the array of stack pointers. */
    stack = astFree( stack );
 
 /* Undefine macros local to this function. */
@@ -2739,6 +2928,8 @@ static void EvaluateFunction( Rcontext *rcontext, int npoint,
 #undef DO_ARG_2
 #undef ARG_2
 #undef ARG_2B
+#undef ARG_SCALED
+#undef ARG_PAIR
 #undef ABS
 #undef INT
 #undef CATCH_MATHS_OVERFLOW
@@ -2751,6 +2942,7 @@ static void EvaluateFunction( Rcontext *rcontext, int npoint,
 #undef SAFE_DIV
 #undef SHIFT_BITS
 #undef BIT_OPER
+#undef RAND_INDEX
 #undef GAUSS
 }
 
@@ -3360,6 +3552,403 @@ static void ExtractVariables( const char *method, const char *class,
    }
 }
 
+static void FoldConstants( int **code, double **con, int stacksize,
+                           int *status ) {
+/*
+*  Name:
+*     FoldConstants
+
+*  Purpose:
+*     Evaluate operations on constant values within compiled opcodes.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "mathmap.h"
+*     void FoldConstants( int **code, double **con, int stacksize,
+*                         int *status )
+
+*  Class Membership:
+*     MathMap member function.
+
+*  Description:
+*     This function examines the opcodes and constants produced by
+*     compiling an expression and identifies any operations whose
+*     arguments are all constants (for instance "2*<pi>" or "sqrt(2)").
+*     Each such operation, together with the operations that load its
+*     arguments, is evaluated once and replaced by a single opcode that
+*     loads the result as a constant. This is repeated for nested
+*     operations, so that any sub-expression which does not depend on an
+*     input variable is reduced to a single constant.
+*
+*     The operations are evaluated using EvaluateFunction, so the folded
+*     constants are identical to the values that would otherwise be
+*     calculated for every point. Operations that generate random numbers
+*     are never folded.
+
+*  Parameters:
+*     code
+*        Address of a pointer to a dynamically allocated array of int
+*        holding the opcodes, as returned by EvaluationSort. If any
+*        operations are folded, the array is freed and a pointer to a new
+*        array is returned.
+*     con
+*        Address of a pointer to a dynamically allocated array of double
+*        holding the constants associated with the opcodes (may be NULL if
+*        there are no constants). If any operations are folded, the array
+*        is freed and a pointer to a new array is returned (this may be
+*        NULL if no constants remain).
+*     stacksize
+*        The size of the evaluation stack required by the opcodes.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Notes:
+*     - The stack size required by the new opcodes is never more than
+*     the stack size required by the original opcodes.
+*/
+
+/* Local Variables: */
+   Oper oper;                    /* Operation code */
+   double *newcon;               /* Pointer to new constants array */
+   double *work;                 /* Workspace for evaluation stack */
+   double value;                 /* Value of folded constant */
+   int *cstart;                  /* Opcode index at start of each stack entry */
+   int *isconst;                 /* Is each stack entry constant? */
+   int *kstart;                  /* Constant index at start of each entry */
+   int *newcode;                 /* Pointer to new opcodes array */
+   int *subcode;                 /* Opcodes for a sequence to be folded */
+   int changed;                  /* Have any operations been folded? */
+   int i;                        /* Loop counter for arguments */
+   int icode;                    /* Loop counter for opcodes */
+   int icon;                     /* Index of next constant to be used */
+   int narg;                     /* Number of operation arguments */
+   int ncode;                    /* Number of original opcodes */
+   int ncon;                     /* Number of original constants */
+   int nconop;                   /* Number of constants used by operation */
+   int nnew;                     /* Number of new opcodes */
+   int nnewcon;                  /* Number of new constants */
+   int nsub;                     /* Number of opcodes in folded sequence */
+   int pure;                     /* Operation depends only on arguments? */
+   int tos;                      /* Top of stack index */
+
+/* Check the global error status and that there are opcodes to examine. */
+   if ( !astOK || !*code ) return;
+
+/* Get the number of opcodes and constants. */
+   ncode = ( *code )[ 0 ];
+   ncon = *con ? (int) ( astSizeOf( *con ) / sizeof( double ) ) : 0;
+
+/* Allocate arrays to hold the new opcodes and constants. Each folding
+   operation replaces at least one opcode with a single new constant, so
+   there cannot be more new constants than the total number of original
+   opcodes and constants. Also allocate arrays that record, for each
+   element on the evaluation stack, the indices of the first opcode and
+   constant used to calculate it, and whether it is constant. */
+   newcode = astMalloc( sizeof( int ) * (size_t) ( ncode + 1 ) );
+   newcon = astMalloc( sizeof( double ) * (size_t) ( ncode + ncon ) );
+   subcode = astMalloc( sizeof( int ) * (size_t) ( ncode + 1 ) );
+   cstart = astMalloc( sizeof( int ) * (size_t) stacksize );
+   kstart = astMalloc( sizeof( int ) * (size_t) stacksize );
+   isconst = astMalloc( sizeof( int ) * (size_t) stacksize );
+   work = astMalloc( sizeof( double ) * (size_t) stacksize );
+
+/* Initialise the top of stack index and the counts of opcodes and
+   constants. */
+   tos = -1;
+   icon = 0;
+   nnew = 0;
+   nnewcon = 0;
+   changed = 0;
+
+/* Loop round each opcode, simulating its effect on the evaluation
+   stack. */
+   for ( icode = 1; astOK && ( icode <= ncode ); icode++ ) {
+      oper = (Oper) ( *code )[ icode ];
+
+/* Null operations have no effect on the stack, so just copy them. */
+      if ( oper == OP_NULL ) {
+         newcode[ ++nnew ] = oper;
+         continue;
+      }
+
+/* Get the number of stack arguments and constants used by the
+   operation, and whether its result depends only on its arguments. */
+      narg = OpcodeArgs( oper, *con + icon, &nconop, &pure );
+
+/* An operation with no arguments pushes a new element on to the stack,
+   which starts with the current opcode. It is constant unless the
+   operation loads a variable. */
+      if ( !narg ) {
+         tos++;
+         cstart[ tos ] = nnew + 1;
+         kstart[ tos ] = nnewcon;
+         isconst[ tos ] = pure;
+
+/* Other operations replace their arguments with a single result, which
+   starts where the first argument started. It is constant if all the
+   arguments are constant, and the operation itself depends only on its
+   arguments. */
+      } else {
+         tos -= narg - 1;
+         for ( i = 0; i < narg; i++ ) {
+            if ( !isconst[ tos + i ] ) pure = 0;
+         }
+         isconst[ tos ] = pure;
+      }
+
+/* Append the opcode, and any constants it uses, to the new arrays. */
+      newcode[ ++nnew ] = oper;
+      for ( i = 0; i < nconop; i++ ) newcon[ nnewcon++ ] = ( *con )[ icon++ ];
+
+/* If the result is constant (and is not already a single constant
+   load operation), evaluate the opcodes that generate it. */
+      if ( isconst[ tos ] && ( oper != OP_LDCON ) ) {
+         nsub = nnew - cstart[ tos ] + 1;
+         subcode[ 0 ] = nsub;
+         for ( i = 0; i < nsub; i++ ) subcode[ i + 1 ] = newcode[ cstart[ tos ] + i ];
+         EvaluateFunction( NULL, 1, NULL, subcode, newcon + kstart[ tos ],
+                           stacksize, work, &value, status );
+
+/* Replace these opcodes and constants with a single operation that
+   loads the result as a constant. */
+         nnew = cstart[ tos ];
+         newcode[ nnew ] = OP_LDCON;
+         nnewcon = kstart[ tos ];
+         newcon[ nnewcon++ ] = value;
+         changed = 1;
+      }
+   }
+
+/* If any operations were folded, replace the original opcodes and
+   constants with the new ones. Otherwise, retain the originals. */
+   if ( astOK && changed ) {
+      newcode[ 0 ] = nnew;
+      ( *code ) = astFree( *code );
+      ( *code ) = astRealloc( newcode, sizeof( int ) * (size_t) ( nnew + 1 ) );
+      newcode = NULL;
+
+      ( *con ) = astFree( *con );
+      if ( nnewcon ) {
+         ( *con ) = astRealloc( newcon, sizeof( double ) * (size_t) nnewcon );
+         newcon = NULL;
+      }
+   }
+
+/* Free workspace. */
+   newcode = astFree( newcode );
+   newcon = astFree( newcon );
+   subcode = astFree( subcode );
+   cstart = astFree( cstart );
+   kstart = astFree( kstart );
+   isconst = astFree( isconst );
+   work = astFree( work );
+}
+
+static void FuseOperations( int **code, double **con, int *status ) {
+/*
+*  Name:
+*     FuseOperations
+
+*  Purpose:
+*     Replace common sequences of compiled opcodes with fused operations.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "mathmap.h"
+*     void FuseOperations( int **code, double **con, int *status )
+
+*  Class Membership:
+*     MathMap member function.
+
+*  Description:
+*     This function examines the opcodes and constants produced by
+*     compiling an expression and identifies common sequences of
+*     operations that act on input variables. Each such sequence is
+*     replaced by a single fused operation which EvaluateFunction can
+*     execute in one pass through the data, instead of making a separate
+*     pass (and writing a separate stack vector) for each operation. The
+*     sequences recognised are:
+*
+*     - "x*c+d", where "x" is a variable and "c" and "d" are constants.
+*     - "sin(x*c)", "cos(x*c)" and "tan(x*c)", together with the
+*     equivalent functions taking degrees.
+*     - "sqrt(x*x+y*y)", where "x" and "y" are variables.
+*     - "atan2(x,y)" and "atan2d(x,y)", where "x" and "y" are variables.
+*
+*     The fused operations use the same arithmetic as the operations they
+*     replace, so the results are identical.
+
+*  Parameters:
+*     code
+*        Address of a pointer to a dynamically allocated array of int
+*        holding the opcodes. If any sequences are replaced, the array is
+*        freed and a pointer to a new array is returned.
+*     con
+*        Address of a pointer to a dynamically allocated array of double
+*        holding the constants associated with the opcodes (may be NULL if
+*        there are no constants). If any sequences are replaced, the array
+*        is freed and a pointer to a new array is returned.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Notes:
+*     - This function should be invoked after FoldConstants, so that any
+*     constant sub-expressions have already been reduced to single
+*     constants.
+*     - The stack size required by the new opcodes is never more than
+*     the stack size required by the original opcodes.
+*/
+
+/* Local Variables: */
+   Oper fused;                   /* Fused operation code */
+   Oper oper;                    /* Operation code */
+   const double *k;              /* Pointer to next unused constant */
+   const int *op;                /* Pointer to current opcode */
+   double *newcon;               /* Pointer to new constants array */
+   double fcon[ 3 ];             /* Constants for fused operation */
+   int *newcode;                 /* Pointer to new opcodes array */
+   int changed;                  /* Have any sequences been replaced? */
+   int i;                        /* Loop counter for constants */
+   int icode;                    /* Index of current opcode */
+   int icon;                     /* Index of next constant to be used */
+   int ncode;                    /* Number of original opcodes */
+   int ncon;                     /* Number of original constants */
+   int nconop;                   /* Number of constants used by operation */
+   int nfcon;                    /* Number of constants for fused operation */
+   int nleft;                    /* Number of opcodes remaining */
+   int nmatch;                   /* Number of opcodes replaced */
+   int nnew;                     /* Number of new opcodes */
+   int nnewcon;                  /* Number of new constants */
+   int nused;                    /* Number of original constants replaced */
+   int pure;                     /* Operation depends only on arguments? */
+
+/* Check the global error status and that there are opcodes to examine. */
+   if ( !astOK || !*code ) return;
+
+/* Get the number of opcodes and constants. */
+   ncode = ( *code )[ 0 ];
+   ncon = *con ? (int) ( astSizeOf( *con ) / sizeof( double ) ) : 0;
+
+/* Allocate arrays to hold the new opcodes and constants. Fusing
+   operations never increases the number of either. */
+   newcode = astMalloc( sizeof( int ) * (size_t) ( ncode + 1 ) );
+   newcon = ncon ? astMalloc( sizeof( double ) * (size_t) ncon ) : NULL;
+
+/* Initialise. */
+   icode = 1;
+   icon = 0;
+   nnew = 0;
+   nnewcon = 0;
+   changed = 0;
+
+/* Loop round the opcodes. */
+   while ( astOK && ( icode <= ncode ) ) {
+      op = *code + icode;
+      oper = (Oper) op[ 0 ];
+      nleft = ncode - icode + 1;
+      k = *con + icon;
+      fused = OP_NULL;
+      nmatch = 0;
+      nfcon = 0;
+      nused = 0;
+
+/* All the sequences recognised start by loading a variable. */
+      if ( oper == OP_LDVAR ) {
+
+/* "sqrt(x*x+y*y)", where each variable is loaded twice. */
+         if ( ( nleft >= 8 ) && ( op[ 1 ] == OP_LDVAR ) &&
+              ( op[ 2 ] == OP_MUL ) && ( op[ 3 ] == OP_LDVAR ) &&
+              ( op[ 4 ] == OP_LDVAR ) && ( op[ 5 ] == OP_MUL ) &&
+              ( op[ 6 ] == OP_ADD ) && ( op[ 7 ] == OP_SQRT ) &&
+              ( k[ 0 ] == k[ 1 ] ) && ( k[ 2 ] == k[ 3 ] ) ) {
+            fused = OP_FHYPOT;
+            nmatch = 8;
+            nused = 4;
+            fcon[ nfcon++ ] = k[ 0 ];
+            fcon[ nfcon++ ] = k[ 2 ];
+
+/* "x*c+d". */
+         } else if ( ( nleft >= 5 ) && ( op[ 1 ] == OP_LDCON ) &&
+                     ( op[ 2 ] == OP_MUL ) && ( op[ 3 ] == OP_LDCON ) &&
+                     ( op[ 4 ] == OP_ADD ) ) {
+            fused = OP_FMULADD;
+            nmatch = 5;
+            nused = 3;
+            for ( i = 0; i < 3; i++ ) fcon[ nfcon++ ] = k[ i ];
+
+/* Trigonometric functions of "x*c". */
+         } else if ( ( nleft >= 4 ) && ( op[ 1 ] == OP_LDCON ) &&
+                     ( op[ 2 ] == OP_MUL ) ) {
+            switch ( (Oper) op[ 3 ] ) {
+               case OP_COS:  fused = OP_FCOS;  break;
+               case OP_COSD: fused = OP_FCOSD; break;
+               case OP_SIN:  fused = OP_FSIN;  break;
+               case OP_SIND: fused = OP_FSIND; break;
+               case OP_TAN:  fused = OP_FTAN;  break;
+               case OP_TAND: fused = OP_FTAND; break;
+               default: break;
+            }
+            if ( fused != OP_NULL ) {
+               nmatch = 4;
+               nused = 2;
+               for ( i = 0; i < 2; i++ ) fcon[ nfcon++ ] = k[ i ];
+            }
+
+/* "atan2(x,y)" and "atan2d(x,y)". */
+         } else if ( ( nleft >= 3 ) && ( op[ 1 ] == OP_LDVAR ) &&
+                     ( ( op[ 2 ] == OP_ATAN2 ) || ( op[ 2 ] == OP_ATAN2D ) ) ) {
+            fused = ( op[ 2 ] == OP_ATAN2 ) ? OP_FATAN2 : OP_FATAN2D;
+            nmatch = 3;
+            nused = 2;
+            for ( i = 0; i < 2; i++ ) fcon[ nfcon++ ] = k[ i ];
+         }
+      }
+
+/* If a sequence was recognised, append the fused operation and its
+   constants to the new arrays and skip over the opcodes and constants
+   it replaces. */
+      if ( fused != OP_NULL ) {
+         newcode[ ++nnew ] = fused;
+         for ( i = 0; i < nfcon; i++ ) newcon[ nnewcon++ ] = fcon[ i ];
+         icode += nmatch;
+         icon += nused;
+         changed = 1;
+
+/* Otherwise, copy the opcode and any constants it uses. */
+      } else {
+         newcode[ ++nnew ] = oper;
+         if ( oper != OP_NULL ) {
+            (void) OpcodeArgs( oper, k, &nconop, &pure );
+            for ( i = 0; i < nconop; i++ ) newcon[ nnewcon++ ] = ( *con )[ icon++ ];
+         }
+         icode++;
+      }
+   }
+
+/* If any sequences were replaced, replace the original opcodes and
+   constants with the new ones. Otherwise, retain the originals. */
+   if ( astOK && changed ) {
+      newcode[ 0 ] = nnew;
+      ( *code ) = astFree( *code );
+      ( *code ) = astRealloc( newcode, sizeof( int ) * (size_t) ( nnew + 1 ) );
+      newcode = NULL;
+
+      ( *con ) = astFree( *con );
+      if ( nnewcon ) {
+         ( *con ) = astRealloc( newcon, sizeof( double ) * (size_t) nnewcon );
+         newcon = NULL;
+      }
+   }
+
+/* Free workspace. */
+   newcode = astFree( newcode );
+   newcon = astFree( newcon );
+}
+
 static double Gauss( Rcontext *context, int *status ) {
 /*
 *  Name:
@@ -3382,6 +3971,13 @@ static double Gauss( Rcontext *context, int *status ) {
 *     On each invocation, this function returns a pseudo-random sample drawn
 *     from a standard Gaussian distribution with mean zero and standard
 *     deviation unity. The Box-Muller transformation method is used.
+*
+*     The Box-Muller method generates values in pairs. Normally, the
+*     second value of each pair is saved and returned on the next
+*     invocation. If the "indexed" flag is set in the context, however,
+*     each invocation generates a new pair and discards the second
+*     value, so that the result depends only on the counters recorded in
+*     the context (see Rand).
 
 *  Parameters:
 *     context
@@ -3409,20 +4005,27 @@ static double Gauss( Rcontext *context, int *status ) {
    double rsq;                   /* Squared radius */
    double s;                     /* Scale factor */
    double x;                     /* First result value */
+   double ynew;                  /* Second value of new pair */
+   int indexed;                  /* Use the indexed generator? */
    static double y;              /* Second result value */
    static int ysaved = 0;        /* Previously-saved value available? */
 
-   LOCK_MUTEX7
+/* The saved value is not used by the indexed generator, so there is no
+   need to serialise access to it. */
+   indexed = context->indexed;
+   if ( !indexed ) {
+      LOCK_MUTEX7
+   }
 
 /* If the random number generator context is not active, then it will
    be (re)initialised on the first invocation of Rand (below). Ensure
    that any previously-saved value within this function is first
    discarded. */
-   if ( !context->active ) ysaved = 0;
+   if ( !indexed && !context->active ) ysaved = 0;
 
 /* If there is a previously-saved value available, then use it and
    mark it as no longer available. */
-   if ( ysaved ) {
+   if ( !indexed && ysaved ) {
       x = y;
       ysaved = 0;
 
@@ -3436,8 +4039,8 @@ static double Gauss( Rcontext *context, int *status ) {
    result). */
          do {
             x = 2.0 * Rand( context, status ) - 1.0;
-            y = 2.0 * Rand( context, status ) - 1.0;
-            rsq = x * x + y * y;
+            ynew = 2.0 * Rand( context, status ) - 1.0;
+            rsq = x * x + ynew * ynew;
          } while ( ( rsq >= 1.0 ) || ( rsq == 0.0 ) );
 
 /* Perform the Box-Muller transformation, checking that this will not
@@ -3451,16 +4054,21 @@ static double Gauss( Rcontext *context, int *status ) {
 /* Scale the original random values to give a pair of results. One will be
    returned and the second kept until next time. */
             x *= s;
-            y *= s;
+            ynew *= s;
             break;
          }
       }
 
-/* Note that a saved value is available. */
-      ysaved = 1;
+/* Save the second value and note that it is available. */
+      if ( !indexed ) {
+         y = ynew;
+         ysaved = 1;
+      }
    }
 
-   UNLOCK_MUTEX7
+   if ( !indexed ) {
+      UNLOCK_MUTEX7
+   }
 
 /* Return the current result. */
    return x;
@@ -3607,9 +4215,18 @@ static const char *GetAttrib( AstObject *this_object, const char *attrib, int *s
    the value into "getattrib_buff" as a null-terminated string in an appropriate
    format.  Set "result" to point at the result string. */
 
+/* IndexedRand. */
+/* ------------ */
+   if ( !strcmp( attrib, "indexedrand" ) ) {
+      ival = astGetIndexedRand( this );
+      if ( astOK ) {
+         (void) sprintf( getattrib_buff, "%d", ival );
+         result = getattrib_buff;
+      }
+
 /* Seed. */
 /* ----- */
-   if ( !strcmp( attrib, "seed" ) ) {
+   } else if ( !strcmp( attrib, "seed" ) ) {
       ival = astGetSeed( this );
       if ( astOK ) {
          (void) sprintf( getattrib_buff, "%d", ival );
@@ -3707,15 +4324,19 @@ void astInitMathMapVtab_(  AstMathMapVtab *vtab, const char *name, int *status )
 /* ------------------------------------ */
 /* Store pointers to the member functions (implemented here) that
    provide virtual methods for this class. */
+   vtab->ClearIndexedRand = ClearIndexedRand;
    vtab->ClearSeed = ClearSeed;
    vtab->ClearSimpFI = ClearSimpFI;
    vtab->ClearSimpIF = ClearSimpIF;
+   vtab->GetIndexedRand = GetIndexedRand;
    vtab->GetSeed = GetSeed;
    vtab->GetSimpFI = GetSimpFI;
    vtab->GetSimpIF = GetSimpIF;
+   vtab->SetIndexedRand = SetIndexedRand;
    vtab->SetSeed = SetSeed;
    vtab->SetSimpFI = SetSimpFI;
    vtab->SetSimpIF = SetSimpIF;
+   vtab->TestIndexedRand = TestIndexedRand;
    vtab->TestSeed = TestSeed;
    vtab->TestSimpFI = TestSimpFI;
    vtab->TestSimpIF = TestSimpIF;
@@ -4164,6 +4785,114 @@ static int MapMerge( AstMapping *this, int where, int series, int *nmap,
    return result;
 }
 
+static int OpcodeArgs( Oper oper, const double *con, int *ncon,
+                       int *pure ) {
+/*
+*  Name:
+*     OpcodeArgs
+
+*  Purpose:
+*     Describe the arguments used by an opcode.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "mathmap.h"
+*     int OpcodeArgs( Oper oper, const double *con, int *ncon, int *pure )
+
+*  Class Membership:
+*     MathMap member function.
+
+*  Description:
+*     This function returns the number of values that an operation takes
+*     from the evaluation stack, and the number of constants it consumes.
+*     It also indicates whether the result of the operation depends only
+*     on its stack arguments (and so may be evaluated in advance if the
+*     arguments are constant).
+
+*  Parameters:
+*     oper
+*        The operation code. This should not be OP_NULL.
+*     con
+*        Pointer to the next unused constant associated with the opcodes.
+*        This is only accessed for operations that take a variable number
+*        of arguments.
+*     ncon
+*        Pointer to an int in which to return the number of constants
+*        consumed by the operation.
+*     pure
+*        Pointer to an int in which to return a flag indicating if the
+*        operation's result depends only on its stack arguments. This is
+*        zero for operations that load variables or generate random
+*        numbers.
+
+*  Returned Value:
+*     The number of stack arguments. Each operation leaves a single
+*     result on the stack, so operations with no arguments push a new
+*     value on to the stack.
+*/
+
+/* Local Variables: */
+   int result;                   /* Returned value */
+
+/* Initialise. */
+   *ncon = 0;
+   *pure = 1;
+
+/* Fused operations load one or two variables (whose indices are given
+   by constants) and, in some cases, also consume further constants. */
+   if ( oper >= OP_FATAN2 && oper <= OP_FTAND ) {
+      *ncon = ( oper == OP_FMULADD ) ? 3 : 2;
+      *pure = 0;
+      result = 0;
+
+/* Operations that load variables, or return the current floating point
+   rounding mode, do not have a fixed value. */
+   } else if ( oper == OP_LDVAR || oper == OP_LDRND ) {
+      *ncon = ( oper == OP_LDVAR ) ? 1 : 0;
+      *pure = 0;
+      result = 0;
+
+/* A user-supplied constant is loaded from the constants array. Other
+   system and mathematical constants have no arguments. */
+   } else if ( oper == OP_LDCON ) {
+      *ncon = 1;
+      result = 0;
+
+   } else if ( oper < OP_ABS ) {
+      result = 0;
+
+/* Functions with one argument, and unary operators. The Poisson random
+   number generator is the only one not determined by its argument. */
+   } else if ( oper < OP_ATAN2 || oper == OP_NEG || oper == OP_NOT ) {
+      if ( oper == OP_POISS ) *pure = 0;
+      result = 1;
+
+/* Functions with two arguments. */
+   } else if ( oper < OP_QIF ) {
+      if ( oper == OP_GAUSS || oper == OP_RAND ) *pure = 0;
+      result = 2;
+
+/* Functions with three arguments. */
+   } else if ( oper == OP_QIF ) {
+      result = 3;
+
+/* Functions with variable numbers of arguments. The number of arguments
+   is given by the next constant. */
+   } else if ( oper == OP_MAX || oper == OP_MIN ) {
+      *ncon = 1;
+      result = (int) ( con[ 0 ] + 0.5 );
+
+/* All remaining operators are binary. */
+   } else {
+      result = 2;
+   }
+
+/* Return the result. */
+   return result;
+}
+
 static void ParseConstant( const char *method, const char *class,
                            const char *exprs, int istart, int *iend,
                            double *con, int *status ) {
@@ -4749,6 +5478,63 @@ static double Poisson( Rcontext *context, double mean, int *status ) {
    return result;
 }
 
+static UINT_BIG HashRand( UINT_BIG value, int *status ) {
+/*
+*  Name:
+*     HashRand
+
+*  Purpose:
+*     Scramble the bits of a 64-bit integer.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "mathmap.h"
+*     UINT_BIG HashRand( UINT_BIG value, int *status )
+
+*  Class Membership:
+*     MathMap member function.
+
+*  Description:
+*     This function returns a 64-bit integer whose bits are a
+*     pseudo-random function of the bits in the supplied value. Any
+*     change to the supplied value changes each bit of the result with
+*     a probability close to one half. It is used by Rand to generate
+*     random numbers from a set of counters when the IndexedRand
+*     attribute is set. The algorithm is the output function of the
+*     "SplitMix64" generator (Steele, Lea & Flood, 2014).
+
+*  Parameters:
+*     value
+*        The value to be scrambled.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The scrambled value.
+
+*  Notes:
+*     - This function does not perform error checking and does not generate
+*     errors. It will execute even if the global error status is set.
+*/
+
+/* Local Constants: */
+   const UINT_BIG gamma =        /* Golden ratio increment */
+      ( (UINT_BIG) 0x9E3779B9UL << 32 ) | (UINT_BIG) 0x7F4A7C15UL;
+   const UINT_BIG mul1 =         /* First multiplier */
+      ( (UINT_BIG) 0xBF58476DUL << 32 ) | (UINT_BIG) 0x1CE4E5B9UL;
+   const UINT_BIG mul2 =         /* Second multiplier */
+      ( (UINT_BIG) 0x94D049BBUL << 32 ) | (UINT_BIG) 0x133111EBUL;
+
+/* Add the increment and mix the bits using alternate shifts and
+   multiplications. */
+   value += gamma;
+   value = ( value ^ ( value >> 30 ) ) * mul1;
+   value = ( value ^ ( value >> 27 ) ) * mul2;
+   return value ^ ( value >> 31 );
+}
+
 static double Rand( Rcontext *context, int *status ) {
 /*
 *  Name:
@@ -4774,6 +5560,12 @@ static double Rand( Rcontext *context, int *status ) {
 *     al. (Numerical Recipes), which has a long period and good statistical
 *     properties. This independent implementation returns double precision
 *     values.
+*
+*     If the "indexed" flag is set in the context, the result instead
+*     depends only on the seed and the counters (function, operation,
+*     point and draw number) recorded in the context. These are combined
+*     using the HashRand function. The draw number is incremented on each
+*     invocation, so that successive values for the same point differ.
 
 *  Parameters:
 *     context
@@ -4821,6 +5613,22 @@ static double Rand( Rcontext *context, int *status ) {
    static double scale0;         /* Scale decrement for successive integers */
    static int init = 0;          /* Local initialisation performed? */
    static int nrand;             /* Number of random integers to use */
+   UINT_BIG bits;                /* Hashed counter bits */
+
+/* Indexed generator. */
+/* ------------------ */
+/* Hash the seed, followed by the identifiers for the function and
+   operation, followed by the point index and draw number. Use the most
+   significant 53 bits of the result to form a value uniformly
+   distributed in the open interval (0,1). */
+   if ( context->indexed ) {
+      bits = HashRand( (UINT_BIG) (unsigned int) context->seed, status );
+      bits = HashRand( bits ^ ( ( (UINT_BIG) (unsigned int) context->fun << 32 ) |
+                                (UINT_BIG) (unsigned int) context->oper ), status );
+      bits = HashRand( bits ^ ( ( (UINT_BIG) (unsigned int) context->point << 32 ) |
+                                (UINT_BIG) (unsigned int) context->ndraw++ ), status );
+      return ( (double) ( bits >> 11 ) + 0.5 ) * ldexp( 1.0, -53 );
+   }
 
 /* If the random number generator context is not active, then
    initialise it. */
@@ -5020,11 +5828,18 @@ static void SetAttrib( AstObject *this_object, const char *setting, int *status
    that the entire string was matched. Once a value has been obtained, use the
    appropriate method to set it. */
 
-/* Seed. */
-/* ----- */
+/* IndexedRand. */
+/* ------------ */
    if ( nc = 0,
-        ( 1 == astSscanf( setting, "seed= %d %n", &ival, &nc ) )
+        ( 1 == astSscanf( setting, "indexedrand= %d %n", &ival, &nc ) )
         && ( nc >= len ) ) {
+      astSetIndexedRand( this, ival );
+
+/* Seed. */
+/* ----- */
+   } else if ( nc = 0,
+               ( 1 == astSscanf( setting, "seed= %d %n", &ival, &nc ) )
+               && ( nc >= len ) ) {
       astSetSeed( this, ival );
 
 /* SimpFI. */
@@ -5104,9 +5919,14 @@ static int TestAttrib( AstObject *this_object, const char *attrib, int *status )
 
 /* Check the attribute name and test the appropriate attribute. */
 
+/* IndexedRand. */
+/* ------------ */
+   if ( !strcmp( attrib, "indexedrand" ) ) {
+      result = astTestIndexedRand( this );
+
 /* Seed. */
 /* ----- */
-   if ( !strcmp( attrib, "seed" ) ) {
+   } else if ( !strcmp( attrib, "seed" ) ) {
       result = astTestSeed( this );
 
 /* SimpFI. */
@@ -5187,10 +6007,14 @@ static AstPointSet *Transform( AstMapping *map, AstPointSet *in,
 /* Local Variables: */
    AstMathMap *this;             /* Pointer to MathMap to be applied */
    AstPointSet *result;          /* Pointer to output PointSet */
+   Rcontext *rcontext;           /* Random number generator context to use */
+   Rcontext rlocal;              /* Local copy of random number context */
    double **data_ptr;            /* Array of pointers to coordinate data */
    double **ptr_in;              /* Pointer to input coordinate data */
    double **ptr_out;             /* Pointer to output coordinate data */
+   double *stack_work;           /* Workspace for the evaluation stack */
    double *work;                 /* Workspace for intermediate results */
+   int **code;                   /* Opcodes for each function */
    int idata;                    /* Loop counter for data pointer elements */
    int ifun;                     /* Loop counter for functions */
    int ncoord_in;                /* Number of coordinates per input point */
@@ -5198,6 +6022,10 @@ static AstPointSet *Transform( AstMapping *map, AstPointSet *in,
    int ndata;                    /* Number of data pointer elements filled */
    int nfun;                     /* Number of functions to evaluate */
    int npoint;                   /* Number of points */
+   int ntile;                    /* Number of points in current tile */
+   int point;                    /* Index of first point in current tile */
+   int stacksize;                /* Size of evaluation stack */
+   int tile;                     /* Maximum number of points in a tile */
 
 /* Check the global error status. */
    if ( !astOK ) return NULL;
@@ -5234,30 +6062,77 @@ static AstPointSet *Transform( AstMapping *map, AstPointSet *in,
 /* Obtain the number of transformation functions that must be
    evaluated to perform the transformation. This will include any that
    produce intermediate results from which the final results are
-   calculated. */
+   calculated. Also get the opcodes for each function and the size of
+   stack needed to evaluate them. */
    nfun = forward ? this->nfwd : this->ninv;
+   code = forward ? this->fwdcode : this->invcode;
+   stacksize = forward ? this->fwdstack : this->invstack;
+
+/* If the IndexedRand attribute is set, the random numbers used for each
+   point depend only on the Seed and the counters recorded in the random
+   number generator context (see Rand). Use a local copy of the context
+   to hold these counters, so that the MathMap itself is not modified and
+   simultaneous transformations using the same MathMap do not interfere
+   with each other. Otherwise, use the MathMap's own context, so that
+   successive transformations continue the same sequence of random
+   numbers. */
+   if ( astGetIndexedRand( this ) ) {
+      rlocal = this->rcontext;
+      rlocal.indexed = 1;
+      rcontext = &rlocal;
+   } else {
+      rcontext = &this->rcontext;
+   }
+
+/* The points are transformed in tiles, each containing no more than
+   TILE_SIZE points. All the functions are evaluated for one tile before
+   moving on to the next, so that the evaluation stack and intermediate
+   results for each tile remain in cache. However, if any function
+   generates random numbers from a single sequence, use a single tile
+   containing all points so that the sequence of random numbers is used
+   in the same order as if the functions were evaluated one at a time
+   for all points. This is not necessary if the random numbers are
+   indexed by point. */
+   if ( npoint > TILE_SIZE &&
+        ( rcontext->indexed || !UsesRandom( nfun, code, status ) ) ) {
+      tile = TILE_SIZE;
+   } else {
+      tile = npoint;
+   }
 
 /* If intermediate results are to be calculated, then allocate
    workspace to hold them (each intermediate result being a vector of
-   "npoint" double values). */
+   "tile" double values). */
    if ( nfun > ncoord_out ) {
       work = astMalloc( sizeof( double) *
-                        (size_t) ( npoint * ( nfun - ncoord_out ) ) );
+                        (size_t) ( tile * ( nfun - ncoord_out ) ) );
    }
 
+/* Allocate workspace for the evaluation stack. The first element of the
+   stack is the output array, so the workspace does not need to include
+   it. */
+   stack_work = astMalloc( sizeof( double ) *
+                           (size_t) ( tile * ( stacksize - 1 ) ) );
+
 /* Also allocate space for an array to hold pointers to the input
    data, intermediate results and output data. */
    data_ptr = astMalloc( sizeof( double * ) * (size_t) ( ncoord_in + nfun ) );
 
-/* We now set up the "data_ptr" array to locate the data to be
-   processed. */
-   if ( astOK ) {
+/* Loop round each tile of points. */
+   for ( point = 0; astOK && ( point < npoint ); point += tile ) {
+      ntile = npoint - point;
+      if ( ntile > tile ) ntile = tile;
 
-/* The first elements of this array point at the input data
-   vectors. */
+/* Record the index of the first point in the tile, so that indexed
+   random numbers can be related to the original point index. */
+      rcontext->base = point;
+
+/* We now set up the "data_ptr" array to locate the data to be
+   processed. The first elements of this array point at the input data
+   vectors for the current tile. */
       ndata = 0;
       for ( idata = 0; idata < ncoord_in; idata++ ) {
-         data_ptr[ ndata++ ] = ptr_in[ idata ];
+         data_ptr[ ndata++ ] = ptr_in[ idata ] + point;
       }
 
 /* The following elements point at successive vectors within the
@@ -5265,13 +6140,13 @@ static AstPointSet *Transform( AstMapping *map, AstPointSet *in,
    arrays for intermediate results, and then as input arrays for
    subsequent calculations which use these results. */
       for ( idata = 0; idata < ( nfun - ncoord_out ); idata++ ) {
-         data_ptr[ ndata++ ] = work + ( idata * npoint );
+         data_ptr[ ndata++ ] = work + ( idata * tile );
       }
 
 /* The final elements point at the output coordinate data arrays into
    which the final results will be written. */
       for ( idata = 0; idata < ncoord_out; idata++ ) {
-         data_ptr[ ndata++ ] = ptr_out[ idata ];
+         data_ptr[ ndata++ ] = ptr_out[ idata ] + point;
       }
 
 /* Perform coordinate transformation. */
@@ -5279,6 +6154,11 @@ static AstPointSet *Transform( AstMapping *map, AstPointSet *in,
 /* Loop to evaluate each transformation function in turn. */
       for ( ifun = 0; ifun < nfun; ifun++ ) {
 
+/* Identify the function being evaluated (using negative values for the
+   inverse functions) so that each function uses different indexed
+   random numbers. */
+         rcontext->fun = forward ? ifun : -1 - ifun;
+
 /* Invoke the function that evaluates compiled expressions. Pass the
    appropriate code and constants arrays, depending on the direction of
    coordinate transformation, together with the required stack size. The
@@ -5286,19 +6166,19 @@ static AstPointSet *Transform( AstMapping *map, AstPointSet *in,
    "data_ptr" array (skipping the input data elements), while the
    function has access to all previous elements of the "data_ptr" array
    to locate the required input data. */
-         EvaluateFunction( &this->rcontext, npoint, (const double **) data_ptr,
-                           forward ? this->fwdcode[ ifun ] :
-                                     this->invcode[ ifun ],
+         EvaluateFunction( rcontext, ntile, (const double **) data_ptr,
+                           code[ ifun ],
                            forward ? this->fwdcon[ ifun ] :
                                      this->invcon[ ifun ],
-                           forward ? this->fwdstack : this->invstack,
+                           stacksize, stack_work,
                            data_ptr[ ifun + ncoord_in ], status );
       }
    }
 
 /* Free the array of data pointers and any workspace allocated for
-   intermediate results. */
+   intermediate results and the evaluation stack. */
    data_ptr = astFree( data_ptr );
+   stack_work = astFree( stack_work );
    if ( nfun > ncoord_out ) work = astFree( work );
 
 /* If an error occurred, then return a NULL pointer. If no output
@@ -5312,6 +6192,66 @@ static AstPointSet *Transform( AstMapping *map, AstPointSet *in,
    return result;
 }
 
+static int UsesRandom( int nfun, int **code, int *status ) {
+/*
+*  Name:
+*     UsesRandom
+
+*  Purpose:
+*     Determine if compiled functions generate random numbers.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "mathmap.h"
+*     int UsesRandom( int nfun, int **code, int *status )
+
+*  Class Membership:
+*     MathMap member function.
+
+*  Description:
+*     This function returns a flag indicating if any of the supplied
+*     compiled functions use an operation that generates random numbers.
+
+*  Parameters:
+*     nfun
+*        The number of functions.
+*     code
+*        An array of "nfun" pointers, each pointing to the array of
+*        opcodes for one function.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Non-zero if any function generates random numbers.
+
+*  Notes:
+*     - A value of zero will be returned if this function is invoked
+*     with the global error status set.
+*/
+
+/* Local Variables: */
+   Oper oper;                    /* Operation code */
+   int icode;                    /* Loop counter for opcodes */
+   int ifun;                     /* Loop counter for functions */
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* Search the opcodes of each function for the random number
+   operations. */
+   for ( ifun = 0; ifun < nfun; ifun++ ) {
+      for ( icode = 1; icode <= code[ ifun ][ 0 ]; icode++ ) {
+         oper = (Oper) code[ ifun ][ icode ];
+         if ( oper == OP_RAND || oper == OP_GAUSS || oper == OP_POISS ) {
+            return 1;
+         }
+      }
+   }
+   return 0;
+}
+
 static void ValidateSymbol( const char *method, const char *class,
                             const char *exprs, int iend, int sym,
                             int *lpar, int **argcount, int **opensym,
@@ -5554,6 +6494,69 @@ static void ValidateSymbol( const char *method, const char *class,
    "object.h" file. For a description of each attribute, see the class
    interface (in the associated .h file). */
 
+/*
+*att++
+*  Name:
+*     IndexedRand
+
+*  Purpose:
+*     Random numbers depend only on Seed and point index?
+
+*  Type:
+*     Public attribute.
+
+*  Synopsis:
+*     Integer (boolean).
+
+*  Description:
+*     This attribute controls how the random number functions in MathMap
+*     expressions generate their values.
+*
+*     By default (IndexedRand is zero), each MathMap uses a single
+*     sequence of random numbers (determined by its Seed attribute) which
+*     is consumed in turn by each point that is transformed. The random
+*     value used for a point therefore depends on the points that were
+*     transformed before it, and on the order in which they were
+*     processed.
+*
+*     If IndexedRand is set to a non-zero value, the random values used
+*     for each point depend only on the Seed attribute, on the index of
+*     the point within the set of points being transformed, and on
+*     which random number function is being evaluated. Transforming the
+*     same set of points twice with the same Seed will then give
+*     identical results, and the results do not depend on how the
+*     points are divided up for processing. This allows the points to be
+*     processed in smaller blocks (which is usually faster), and allows
+*     several threads to transform points using the same MathMap
+*     concurrently.
+
+*  Applicability:
+*     MathMap
+*        All MathMaps have this attribute.
+
+*  Notes:
+*     - The random values produced when IndexedRand is non-zero are
+*     different from those produced when it is zero, even if the same
+*     Seed value is used.
+*     - When IndexedRand is non-zero, a given point index receives the
+*     same random values on each transformation. To obtain different
+*     values (for instance, in successive Monte Carlo trials), change
+*     the Seed attribute between transformations.
+*att--
+*/
+/* Clear the IndexedRand value by setting it to -INT_MAX. */
+astMAKE_CLEAR(MathMap,IndexedRand,indexed_rand,-INT_MAX)
+
+/* Supply a default of 0 if no IndexedRand value has been set. */
+astMAKE_GET(MathMap,IndexedRand,int,0,( ( this->indexed_rand != -INT_MAX ) ?
+                                        this->indexed_rand : 0 ))
+
+/* Set an IndexedRand value of 1 if any non-zero value is supplied. */
+astMAKE_SET(MathMap,IndexedRand,int,indexed_rand,( value != 0 ))
+
+/* The IndexedRand value is set if it is not -INT_MAX. */
+astMAKE_TEST(MathMap,IndexedRand,( this->indexed_rand != -INT_MAX ))
+
 /*
 *att++
 *  Name:
@@ -6063,6 +7066,16 @@ static void Dump( AstObject *this_object, AstChannel *channel, int *status ) {
                 ival ? "Inverse-forward pairs may simplify" :
                        "Inverse-forward pairs do not simplify" );
 
+/* IndexedRand. */
+/* ------------ */
+/* Write out the flag indicating if random numbers are indexed by
+   point. */
+   set = TestIndexedRand( this, status );
+   ival = set ? GetIndexedRand( this, status ) : astGetIndexedRand( this );
+   astWriteInt( channel, "IdxRnd", set, 0, ival,
+                ival ? "Random numbers indexed by point" :
+                       "Random numbers use a single sequence" );
+
 /* Seed. */
 /* ----- */
 /* Write out any random number seed value which is set. Prefix this with
@@ -7177,11 +8190,13 @@ AstMathMap *astInitMathMap_( void *mem, size_t size, int init,
          new->ninv = ninv;
          new->simp_fi = -INT_MAX;
          new->simp_if = -INT_MAX;
+         new->indexed_rand = -INT_MAX;
 
 /* Initialise the random number generator context associated with the
    MathMap, using an unpredictable default seed value. */
          new->rcontext.active = 0;
          new->rcontext.random_int = 0;
+         new->rcontext.indexed = 0;
          new->rcontext.seed_set = 0;
          new->rcontext.seed = DefaultSeed( &new->rcontext, status );
 
@@ -7376,11 +8391,17 @@ AstMathMap *astLoadMathMap_( void *mem, size_t size,
             new->simp_if = astReadInt( channel, "simpif", -INT_MAX );
             if ( TestSimpIF( new, status ) ) SetSimpIF( new, new->simp_if, status );
 
+/* Indexed random numbers flag. */
+/* ----------------------------- */
+            new->indexed_rand = astReadInt( channel, "idxrnd", -INT_MAX );
+            if ( TestIndexedRand( new, status ) ) SetIndexedRand( new, new->indexed_rand, status );
+
 /* Random number context. */
 /* ---------------------- */
 /* Initialise the random number generator context. */
             new->rcontext.active = 0;
             new->rcontext.random_int = 0;
+            new->rcontext.indexed = 0;
 
 /* Read the flag that determines if the Seed value is set, and the
    Seed value itself. */
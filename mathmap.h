@@ -30,6 +30,8 @@
 *     None.
 
 *  New Attributes Defined:
+*     IndexedRand
+*        Random numbers depend only on Seed and point index?
 *     Seed
 *        Random number seed.
 *     SimpFI
@@ -60,24 +62,33 @@
 *        None.
 *
 *     Protected:
+*        astClearIndexedRand
+*           Clear the IndexedRand attribute for a MathMap.
 *        astClearSeed
 *           Clear the Seed attribute for a MathMap.
 *        astClearSimpFI
 *           Clear the SimpFI attribute for a MathMap.
 *        astClearSimpIF
 *           Clear the SimpIF attribute for a MathMap.
+*        astGetIndexedRand
+*           Get the value of the IndexedRand attribute for a MathMap.
 *        astGetSeed
 *           Get the value of the Seed attribute for a MathMap.
 *        astGetSimpFI
 *           Get the value of the SimpFI attribute for a MathMap.
 *        astGetSimpIF
 *           Get the value of the SimpIF attribute for a MathMap.
+*        astSetIndexedRand
+*           Set the value of the IndexedRand attribute for a MathMap.
 *        astSetSeed
 *           Set the value of the Seed attribute for a MathMap.
 *        astSetSimpFI
 *           Set the value of the SimpFI attribute for a MathMap.
 *        astSetSimpIF
 *           Set the value of the SimpIF attribute for a MathMap.
+*        astTestIndexedRand
+*           Test whether a value has been set for the IndexedRand attribute
+*           of a MathMap.
 *        astTestSeed
 *           Test whether a value has been set for the Seed attribute of a
 *           MathMap.
@@ -199,7 +210,13 @@
    used by each MathMap. This ensures that the random number sequences
    used by different MathMaps are independent, and can be independently
    controlled by setting/clearing their Seed attributes. Random numbers
-   are produced by combining the output of two internal generators. */
+   are produced by combining the output of two internal generators.
+
+   If the IndexedRand attribute is set, random numbers are instead
+   produced by hashing the seed together with a counter that identifies
+   the point, function, operation and draw. The context then records the
+   current counter values, and the state of the two internal generators
+   is not used. */
 typedef struct AstMathMapRandContext_ {
    long int rand1;               /* State of first internal generator */
    long int rand2;               /* State of second internal generator */
@@ -208,6 +225,12 @@ typedef struct AstMathMapRandContext_ {
    int active;                   /* Generator has been initialised? */
    int seed;                     /* Seed to be used during initialisation */
    int seed_set;                 /* Seed value set via "Seed" attribute? */
+   int indexed;                  /* Use indexed (counter-based) generator? */
+   int fun;                      /* Indexed: function being evaluated */
+   int base;                     /* Indexed: index of first point in block */
+   int point;                    /* Indexed: index of current point */
+   int oper;                     /* Indexed: index of current operation */
+   int ndraw;                    /* Indexed: numbers drawn for this point */
 } AstMathMapRandContext_;
 
 /* MathMap structure. */
@@ -228,6 +251,7 @@ typedef struct AstMathMap {
    int **fwdcode;                /* Array of opcodes for forward functions */
    int **invcode;                /* Array of opcodes for inverse functions */
    int fwdstack;                 /* Stack size required by forward functions */
+   int indexed_rand;             /* Random numbers indexed by point? */
    int invstack;                 /* Stack size required by inverse functions */
    int nfwd;                     /* Number of forward functions */
    int ninv;                     /* Number of inverse functions */
@@ -249,15 +273,19 @@ typedef struct AstMathMapVtab {
    AstClassIdentifier id;
 
 /* Properties (e.g. methods) specific to this class. */
+   int (* GetIndexedRand)( AstMathMap *, int * );
    int (* GetSeed)( AstMathMap *, int * );
    int (* GetSimpFI)( AstMathMap *, int * );
    int (* GetSimpIF)( AstMathMap *, int * );
+   int (* TestIndexedRand)( AstMathMap *, int * );
    int (* TestSeed)( AstMathMap *, int * );
    int (* TestSimpFI)( AstMathMap *, int * );
    int (* TestSimpIF)( AstMathMap *, int * );
+   void (* ClearIndexedRand)( AstMathMap *, int * );
    void (* ClearSeed)( AstMathMap *, int * );
    void (* ClearSimpFI)( AstMathMap *, int * );
    void (* ClearSimpIF)( AstMathMap *, int * );
+   void (* SetIndexedRand)( AstMathMap *, int, int * );
    void (* SetSeed)( AstMathMap *, int, int * );
    void (* SetSimpFI)( AstMathMap *, int, int * );
    void (* SetSimpIF)( AstMathMap *, int, int * );
@@ -317,15 +345,19 @@ void astInitMathMapGlobals_( AstMathMapGlobals * );
 /* Prototypes for member functions. */
 /* -------------------------------- */
 #if defined(astCLASS)            /* Protected */
+int astGetIndexedRand_( AstMathMap *, int * );
 int astGetSeed_( AstMathMap *, int * );
 int astGetSimpFI_( AstMathMap *, int * );
 int astGetSimpIF_( AstMathMap *, int * );
+int astTestIndexedRand_( AstMathMap *, int * );
 int astTestSeed_( AstMathMap *, int * );
 int astTestSimpFI_( AstMathMap *, int * );
 int astTestSimpIF_( AstMathMap *, int * );
+void astClearIndexedRand_( AstMathMap *, int * );
 void astClearSeed_( AstMathMap *, int * );
 void astClearSimpFI_( AstMathMap *, int * );
 void astClearSimpIF_( AstMathMap *, int * );
+void astSetIndexedRand_( AstMathMap *, int, int * );
 void astSetSeed_( AstMathMap *, int, int * );
 void astSetSimpFI_( AstMathMap *, int, int * );
 void astSetSimpIF_( AstMathMap *, int, int * );
@@ -377,24 +409,32 @@ astINVOKE(O,astLoadMathMap_(mem,size,vtab,name,astCheckChannel(channel),STATUS_P
    before use. This provides a contextual error report if a pointer
    to the wrong sort of Object is supplied. */
 #if defined(astCLASS)            /* Protected */
+#define astClearIndexedRand(this) \
+astINVOKE(V,astClearIndexedRand_(astCheckMathMap(this),STATUS_PTR))
 #define astClearSeed(this) \
 astINVOKE(V,astClearSeed_(astCheckMathMap(this),STATUS_PTR))
 #define astClearSimpFI(this) \
 astINVOKE(V,astClearSimpFI_(astCheckMathMap(this),STATUS_PTR))
 #define astClearSimpIF(this) \
 astINVOKE(V,astClearSimpIF_(astCheckMathMap(this),STATUS_PTR))
+#define astGetIndexedRand(this) \
+astINVOKE(V,astGetIndexedRand_(astCheckMathMap(this),STATUS_PTR))
 #define astGetSeed(this) \
 astINVOKE(V,astGetSeed_(astCheckMathMap(this),STATUS_PTR))
 #define astGetSimpFI(this) \
 astINVOKE(V,astGetSimpFI_(astCheckMathMap(this),STATUS_PTR))
 #define astGetSimpIF(this) \
 astINVOKE(V,astGetSimpIF_(astCheckMathMap(this),STATUS_PTR))
+#define astSetIndexedRand(this,value) \
+astINVOKE(V,astSetIndexedRand_(astCheckMathMap(this),value,STATUS_PTR))
 #define astSetSeed(this,value) \
 astINVOKE(V,astSetSeed_(astCheckMathMap(this),value,STATUS_PTR))
 #define astSetSimpFI(this,value) \
 astINVOKE(V,astSetSimpFI_(astCheckMathMap(this),value,STATUS_PTR))
 #define astSetSimpIF(this,value) \
 astINVOKE(V,astSetSimpIF_(astCheckMathMap(this),value,STATUS_PTR))
+#define astTestIndexedRand(this) \
+astINVOKE(V,astTestIndexedRand_(astCheckMathMap(this),STATUS_PTR))
 #define astTestSeed(this) \
 astINVOKE(V,astTestSeed_(astCheckMathMap(this),STATUS_PTR))
 #define astTestSimpFI(this) \
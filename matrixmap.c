@@ -265,10 +265,12 @@ static AstMatrixMap *MatMat( AstMapping *, AstMapping *, int, int, int * );
 static AstMatrixMap *MatPerm( AstMatrixMap *, AstPermMap *, int, int, int, int * );
 static AstMatrixMap *MatZoom( AstMatrixMap *, AstZoomMap *, int, int, int * );
 static AstMatrixMap *MtrMult( AstMatrixMap *, AstMatrixMap *, int * );
+static int MtrFull( AstMatrixMap *, int, double *, int * );
 static AstMatrixMap *MtrRot( AstMatrixMap *, double, const double[], int * );
 static AstPointSet *Transform( AstMapping *, AstPointSet *, int, AstPointSet *, int * );
 static double *InvertMatrix( int, int, int, double *, int * );
 static double Rate( AstMapping *, double *, int, int, int * );
+static int RateIsExact( AstMapping *, int * );
 static int Equal( AstObject *, AstObject *, int * );
 static int FindString( int, const char *[], const char *, const char *, const char *, const char *, int * );
 static int Ustrcmp( const char *, const char *, int * );
@@ -1285,6 +1287,7 @@ void astInitMatrixMapVtab_(  AstMatrixMapVtab *vtab, const char *name, int *stat
    virtual methods for this class. */
    vtab->MtrRot = MtrRot;
    vtab->MtrMult = MtrMult;
+   vtab->MtrFull = MtrFull;
 
 /* Save the inherited pointers to methods that will be extended, and
    replace them with pointers to the new member functions. */
@@ -1305,6 +1308,7 @@ void astInitMatrixMapVtab_(  AstMatrixMapVtab *vtab, const char *name, int *stat
    mapping->GetTranInverse = GetTranInverse;
    mapping->MapMerge = MapMerge;
    mapping->Rate = Rate;
+   mapping->RateIsExact = RateIsExact;
 
 /* Declare the destructor and copy constructor. */
    astSetDelete( (AstObjectVtab *) vtab, Delete );
@@ -3391,6 +3395,81 @@ static AstMatrixMap *MtrMult( AstMatrixMap *this, AstMatrixMap *a, int *status )
 
 }
 
+static int MtrFull( AstMatrixMap *this, int forward, double *matrix,
+                    int *status ){
+/*
+*+
+*  Name:
+*     astMtrFull
+
+*  Purpose:
+*     Get the elements of a full MatrixMap.
+
+*  Type:
+*     Protected virtual function.
+
+*  Synopsis:
+*     #include "matrixmap.h"
+*     int astMtrFull( AstMatrixMap *this, int forward, double *matrix )
+
+*  Class Membership:
+*     MatrixMap method
+
+*  Description:
+*     If the MatrixMap stores every element of the matrix used to
+*     transform points in the requested direction (i.e. it is not a unit
+*     or diagonal MatrixMap), this function copies those elements into
+*     the supplied array and returns a non-zero value. Otherwise, it
+*     returns zero and leaves the array unchanged. The current value of
+*     the MatrixMap's Invert attribute is taken into account.
+
+*  Parameters:
+*     this
+*        Pointer to the MatrixMap.
+*     forward
+*        A non-zero value requests the matrix used by the forward
+*        transformation, while a zero value requests the matrix used by
+*        the inverse transformation.
+*     matrix
+*        Pointer to an array in which to return the matrix elements, in
+*        row order. It should have at least "nin*nout" elements, where
+*        "nin" and "nout" are the numbers of input and output coordinates
+*        for the requested transformation.
+
+*  Returned Value:
+*     Non-zero if the matrix elements were returned.
+
+*  Notes:
+*     - A value of zero will be returned if this function is invoked
+*     with the AST error status set, or if it should fail for any reason.
+*-
+*/
+
+/* Local Variables: */
+   double *elements;         /* Pointer to the stored matrix elements */
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* Only full matrices are returned. */
+   if( this->form != FULL ) return 0;
+
+/* Get a pointer to the stored matrix for the requested direction,
+   allowing for the Invert attribute. Return zero if it is not
+   available. */
+   if( astGetInvert( this ) ) forward = !forward;
+   elements = forward ? this->f_matrix : this->i_matrix;
+   if( !elements ) return 0;
+
+/* Copy the elements to the returned array. */
+   (void) memcpy( (void *) matrix, (const void *) elements,
+                  sizeof( double )*(size_t)( astGetNin( this )*
+                                             astGetNout( this ) ) );
+
+/* Return the result. */
+   return astOK;
+}
+
 static AstMatrixMap *MtrRot( AstMatrixMap *this, double theta,
                              const double axis[], int *status ){
 /*
@@ -3972,6 +4051,49 @@ static double Rate( AstMapping *this, double *at, int ax1, int ax2, int *status
    return result;
 }
 
+static int RateIsExact( AstMapping *this, int *status ) {
+/*
+*  Name:
+*     RateIsExact
+
+*  Purpose:
+*     Check if the astRate method of a Mapping is exact.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "matrixmap.h"
+*     int RateIsExact( AstMapping *this, int *status )
+
+*  Class Membership:
+*     MatrixMap member function (over-rides the protected astRateIsExact
+*     method inherited from the Mapping class).
+
+*  Description:
+*     This function returns a flag indicating if the astRate method of
+*     the supplied Mapping evaluates the rate of change analytically.
+*     The rates of change of a MatrixMap are the elements of its matrix.
+
+*  Parameters:
+*     this
+*        Pointer to the Mapping.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Non-zero if the astRate method of the supplied Mapping is exact, and
+*     zero otherwise.
+
+*/
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* The rates of change are the matrix elements. */
+   return 1;
+}
+
 static void SMtrMult( int post, int m, int n, const double *mat1,
                         double *mat2, double *work, int *status ){
 /*
@@ -5510,6 +5632,11 @@ AstMatrixMap *astMtrMult_( AstMatrixMap *this, AstMatrixMap *a, int *status ){
    return (**astMEMBER(this,MatrixMap,MtrMult))( this, a, status );
 }
 
+int astMtrFull_( AstMatrixMap *this, int forward, double *matrix, int *status ){
+   if( !astOK ) return 0;
+   return (**astMEMBER(this,MatrixMap,MtrFull))( this, forward, matrix, status );
+}
+
 
 
 
@@ -60,6 +60,8 @@
 *        None.
 *
 *     Protected:
+*        astMtrFull
+*           Get the elements of a full MatrixMap.
 *        astMtrMult
 *           Multiply a MatrixMap by another MatrixMap.
 *        astMtrRot
@@ -200,6 +202,7 @@ typedef struct AstMatrixMapVtab {
 /* Properties (e.g. methods) specific to this class. */
    AstMatrixMap *(* MtrRot)( AstMatrixMap *, double, const double[], int * );
    AstMatrixMap *(* MtrMult)( AstMatrixMap *,  AstMatrixMap *, int * );
+   int (* MtrFull)( AstMatrixMap *, int, double *, int * );
 
 } AstMatrixMapVtab;
 
@@ -255,6 +258,7 @@ AstMatrixMap *astLoadMatrixMap_( void *, size_t, AstMatrixMapVtab *,
 # if defined(astCLASS)           /* Protected */
 AstMatrixMap *astMtrRot_( AstMatrixMap *, double, const double[], int * );
 AstMatrixMap *astMtrMult_( AstMatrixMap *, AstMatrixMap *, int * );
+int astMtrFull_( AstMatrixMap *, int, double *, int * );
 #endif
 
 /* Function interfaces. */
@@ -309,6 +313,9 @@ astINVOKE(O,astMtrRot_(astCheckMatrixMap(this),theta,axis,STATUS_PTR))
 
 #define astMtrMult(this,a) \
 astINVOKE(O,astMtrMult_(astCheckMatrixMap(this),astCheckMatrixMap(a),STATUS_PTR))
+
+#define astMtrFull(this,forward,matrix) \
+astINVOKE(V,astMtrFull_(astCheckMatrixMap(this),forward,matrix,STATUS_PTR))
 #endif
 #endif
 
@@ -0,0 +1,4466 @@
+/*
+*class++
+*  Name:
+*     Moc
+
+*  Purpose:
+*     An area of the sky described by a HEALPix Multi-Order Coverage map.
+
+*  Constructor Function:
+c     astMoc
+f     AST_MOC
+
+*  Description:
+*     The Moc class implements a Region which represents an area of the
+*     celestial sphere as a collection of HEALPix cells of differing
+*     sizes (a "Multi-Order Coverage" map). All cells use the nested
+*     HEALPix numbering scheme, and are defined within an ICRS SkyFrame.
+*
+*     Internally, the covered cells are stored as a sorted list of
+*     disjoint ranges of nested indices at the finest HEALPix order
+*     supported (AST__MXORDHPX). This makes the test for a point being
+*     inside the Moc a binary search of the range list, and makes the
+*     union or intersection of two Mocs a single linear pass through
+*     their range lists. A Moc therefore provides a cheap way to evaluate
+*     and combine large numbers of sky Regions once they have been
+*     rasterised onto the HEALPix grid.
+*
+*     A new Moc is empty. Cells may be added to it explicitly using
+c     astAddCell,
+f     AST_ADDCELL,
+*     or by rasterising an existing Region of any class using
+c     astAddRegion.
+f     AST_ADDREGION.
+*     Rasterisation finds the boundary of the Region from a mesh of
+*     points, and includes every cell crossed by the boundary between
+*     adjacent mesh points. Boundary detail smaller than the mesh spacing
+*     (such as a sharp corner between two mesh points) may be missed, so
+*     a cell touched only by such detail may be omitted.
+
+*  Inheritance:
+*     The Moc class inherits from the Region class.
+
+*  Attributes:
+*     In addition to those attributes common to all Regions, every
+*     Moc also has the following attributes:
+*
+*     - MaxOrder: HEALPix order used when rasterising Regions
+*     - MocArea: The area covered by the Moc, in square arc-minutes
+*     - MocLength: The number of cells in the Moc
+
+*  Functions:
+c     In addition to those functions applicable to all Regions, the
+c     following functions may also be applied to all Mocs:
+f     In addition to those routines applicable to all Regions, the
+f     following routines may also be applied to all Mocs:
+*
+c     - astAddCell: Add a single HEALPix cell into a Moc
+c     - astAddRegion: Add a Region into a Moc
+c     - astGetCell: Get the order and index of a cell in a Moc
+f     - AST_ADDCELL: Add a single HEALPix cell into a Moc
+f     - AST_ADDREGION: Add a Region into a Moc
+f     - AST_GETCELL: Get the order and index of a cell in a Moc
+
+*  Licence:
+*     This program is free software: you can redistribute it and/or
+*     modify it under the terms of the GNU Lesser General Public
+*     License as published by the Free Software Foundation, either
+*     version 3 of the License, or (at your option) any later
+*     version.
+*
+*     This program is distributed in the hope that it will be useful,
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*     GNU Lesser General Public License for more details.
+*
+*     You should have received a copy of the GNU Lesser General
+*     License along with this program.  If not, see
+*     <http://www.gnu.org/licenses/>.
+*class--
+*/
+
+/* Module Macros. */
+/* ============== */
+/* Set the name of the class we are implementing. This indicates to
+   the header files that define class interfaces that they should make
+   "protected" symbols available. */
+#define astCLASS Moc
+
+/* The number of cells on the whole sky at order AST__MXORDHPX. */
+#define NCELL_MX ( INT64_C(12) << ( 2*AST__MXORDHPX ) )
+
+/* The approximate width of a cell at a given HEALPix order, in radians. */
+#define CELL_SIZE(order) ( sqrt( AST__DPI/3.0 )/(double)( INT64_C(1) << (order) ) )
+
+/* The default value for the MaxOrder attribute. */
+#define DEF_MAXORDER 12
+
+/* The largest number of boundary points used when rasterising a Region. */
+#define MXMESH 1000000
+
+/* Adjacent boundary mesh points separated by more than this multiple of
+   the median separation are assumed to be on separate parts of the
+   boundary. */
+#define JUMPFAC 10.0
+
+/* The largest depth of recursion used when finding the cells on the
+   path between two boundary mesh points. */
+#define MXDEPTH 40
+
+/* Include files. */
+/* ============== */
+/* Interface definitions. */
+/* ---------------------- */
+
+#include "globals.h"             /* Thread-safe global data access */
+#include "error.h"               /* Error reporting facilities */
+#include "memory.h"              /* Memory allocation facilities */
+#include "object.h"              /* Base Object class */
+#include "pointset.h"            /* Sets of points/coordinates */
+#include "region.h"              /* Coordinate regions (parent class) */
+#include "channel.h"             /* I/O channels */
+#include "moc.h"                 /* Interface definition for this class */
+#include "mapping.h"             /* Position mappings */
+#include "unitmap.h"             /* Unit Mapping */
+#include "frameset.h"            /* Sets of inter-related coordinate systems */
+#include "skyframe.h"            /* Celestial coordinate systems */
+#include "circle.h"              /* Circular regions */
+#include "pointlist.h"           /* Sets of points */
+#include "wcsmap.h"              /* Factors of PI */
+
+/* Error code definitions. */
+/* ----------------------- */
+#include "ast_err.h"             /* AST error codes */
+
+/* C header files. */
+/* --------------- */
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Type Definitions. */
+/* ================= */
+/* A HEALPix cell visited while rasterising a Region. */
+typedef struct MocCell {
+   int order;                    /* HEALPix order of the cell */
+   int flag;                     /* 0: test centre, 1: include, 2: exclude */
+   int64_t npix;                 /* Nested index of the cell */
+} MocCell;
+
+/* Module Variables. */
+/* ================= */
+
+/* Address of this static variable is used as a unique identifier for
+   member of this class. */
+static int class_check;
+
+/* The base face number and the face coordinate offsets for each of the
+   twelve HEALPix base cells. These are the "jrll" and "jpll" arrays of
+   the HEALPix reference implementation, and describe the same face
+   layout as used by the HPX projection in proj.c. */
+static const int jrll[ 12 ] = { 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4 };
+static const int jpll[ 12 ] = { 1, 3, 5, 7, 0, 2, 4, 6, 1, 3, 5, 7 };
+
+/* Pointers to parent class methods which are extended by this class. */
+static AstPointSet *(* parent_transform)( AstMapping *, AstPointSet *, int, AstPointSet *, int * );
+static const char *(* parent_getattrib)( AstObject *, const char *, int * );
+static int (* parent_equal)( AstObject *, AstObject *, int * );
+static int (* parent_getobjsize)( AstObject *, int * );
+static int (* parent_testattrib)( AstObject *, const char *, int * );
+static void (* parent_clearattrib)( AstObject *, const char *, int * );
+static void (* parent_setattrib)( AstObject *, const char *, int * );
+
+
+#ifdef THREAD_SAFE
+/* Define how to initialise thread-specific globals. */
+#define GLOBAL_inits \
+   globals->Class_Init = 0; \
+   globals->GetAttrib_Buff[ 0 ] = 0;
+
+/* Create the function that initialises global data for this module. */
+astMAKE_INITGLOBALS(Moc)
+
+/* Define macros for accessing each item of thread specific global data. */
+#define class_init astGLOBAL(Moc,Class_Init)
+#define class_vtab astGLOBAL(Moc,Class_Vtab)
+#define getattrib_buff astGLOBAL(Moc,GetAttrib_Buff)
+
+
+#include <pthread.h>
+
+
+#else
+
+static char getattrib_buff[ 101 ];
+
+/* Define the class virtual function table and its initialisation flag
+   as static variables. */
+static AstMocVtab class_vtab;    /* Virtual function table */
+static int class_init = 0;       /* Virtual function table initialised? */
+
+#endif
+
+/* External Interface Function Prototypes. */
+/* ======================================= */
+/* The following functions have public prototypes only (i.e. no
+   protected prototypes), so we must provide local prototypes for use
+   within this module. */
+AstMoc *astMocId_( const char *, ... );
+
+/* Prototypes for Private Member Functions. */
+/* ======================================== */
+static AstPointSet *BoundaryMesh( AstMoc *, double *, int * );
+static AstPointSet *RegBaseMesh( AstRegion *, int * );
+static AstPointSet *Transform( AstMapping *, AstPointSet *, int, AstPointSet *, int * );
+static AstRegion *GetDefUnc( AstRegion *, int * );
+static double GetMocArea( AstMoc *, int * );
+static double MeshSpacing( AstPointSet *, double *, int * );
+static int CmpDouble( const void *, const void * );
+static int CmpIndex( const void *, const void * );
+static int Equal( AstObject *, AstObject *, int * );
+static int GetMocLength( AstMoc *, int * );
+static int GetObjSize( AstObject *, int * );
+static int InRanges( AstMoc *, int64_t );
+static int RegPins( AstRegion *, AstPointSet *, AstRegion *, int **, int * );
+static int64_t *Combine( int, int, const int64_t *, int, const int64_t *, int *, int * );
+static int64_t *Complement( int, const int64_t *, int *, int * );
+static int64_t *Rasterise( AstMoc *, AstRegion *, int *, int * );
+static int64_t *PathCells( int, const double[3], int64_t, const double[3], int64_t, int, int64_t *, int *, int * );
+static int64_t Compress( int64_t );
+static int64_t Loc2Nest( double, double, double );
+static int64_t VecCell( int, const double[3] );
+static int64_t Spread( int64_t );
+static MocCell *Descend( int, int64_t, int, const int64_t *, int, MocCell *, int *, int * );
+static void AddCell( AstMoc *, int, int, int64_t, int * );
+static void AddRegion( AstMoc *, int, AstRegion *, int * );
+static void CellVec( int, int64_t, double, double, double[3] );
+static void Copy( const AstObject *, AstObject *, int * );
+static void Delete( AstObject *, int * );
+static void Dump( AstObject *, AstChannel *, int * );
+static void GetCell( AstMoc *, int, int *, int64_t *, int * );
+static void MakeCells( AstMoc *, int * );
+static void NewRanges( AstMoc *, int, int64_t *, int * );
+static void RegBaseBox( AstRegion *, double *, double *, int * );
+static void SkyOffset( const double[3], double, double, double[3] );
+
+static const char *GetAttrib( AstObject *, const char *, int * );
+static int TestAttrib( AstObject *, const char *, int * );
+static void ClearAttrib( AstObject *, const char *, int * );
+static void SetAttrib( AstObject *, const char *, int * );
+
+static int GetMaxOrder( AstMoc *, int * );
+static int TestMaxOrder( AstMoc *, int * );
+static void ClearMaxOrder( AstMoc *, int * );
+static void SetMaxOrder( AstMoc *, int, int * );
+
+/* Member functions. */
+/* ================= */
+static void AddCell( AstMoc *this, int cmode, int order, int64_t npix,
+                     int *status ){
+/*
+*++
+*  Name:
+c     astAddCell
+f     AST_ADDCELL
+
+*  Purpose:
+*     Add a single HEALPix cell into an existing Moc.
+
+*  Type:
+*     Public virtual function.
+
+*  Synopsis:
+c     #include "moc.h"
+c     void astAddCell( AstMoc *this, int cmode, int order, int64_t npix )
+f     CALL AST_ADDCELL( THIS, CMODE, ORDER, NPIX, STATUS )
+
+*  Class Membership:
+*     Moc method.
+
+*  Description:
+*     This function
+f     routine
+*     modifies a Moc by combining it with a single HEALPix cell, specified
+*     by its order and its index within the nested numbering scheme. The
+*     Moc is modified in place.
+
+*  Parameters:
+c     this
+f     THIS = INTEGER (Given)
+*        Pointer to the Moc to be modified.
+c     cmode
+f     CMODE = INTEGER (Given)
+*        Indicates how the cell should be combined with the existing Moc.
+*        If AST__OR is supplied, the modified Moc is the union of the
+*        supplied Moc and the cell. If AST__AND is supplied, the modified
+*        Moc is the intersection of the supplied Moc and the cell.
+c     order
+f     ORDER = INTEGER (Given)
+*        The HEALPix order of the cell, in the range zero to
+*        AST__MXORDHPX.
+c     npix
+f     NPIX = INTEGER*8 (Given)
+*        The nested index of the cell, in the range zero to
+*        (12*4**order - 1).
+f     STATUS = INTEGER (Given and Returned)
+f        The global status.
+
+*  Notes:
+*     - If the Moc has been negated, the coverage it represents is first
+*     inverted and its Negated attribute cleared, so that the cell is
+*     combined with the area actually represented by the Moc.
+*--
+*/
+
+/* Local Variables: */
+   int64_t *ranges;              /* Combined ranges */
+   int64_t cell[ 2 ];            /* Range covered by the cell */
+   int nranges;                  /* Number of combined ranges */
+   int shift;                    /* Bit shift from "order" to AST__MXORDHPX */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Validate the supplied values. */
+   if( cmode != AST__AND && cmode != AST__OR ) {
+      astError( AST__OPRIN, "astAddCell(%s): Illegal boolean operator "
+                "value (%d) supplied.", status, astGetClass( this ), cmode );
+
+   } else if( order < 0 || order > AST__MXORDHPX ) {
+      astError( AST__BDPAR, "astAddCell(%s): Illegal HEALPix order (%d) "
+                "supplied - must be in the range 0 to %d.", status,
+                astGetClass( this ), order, AST__MXORDHPX );
+
+   } else if( npix < 0 || npix >= ( INT64_C(12) << ( 2*order ) ) ) {
+      astError( AST__BDPAR, "astAddCell(%s): Illegal nested HEALPix index "
+                "(%lld) supplied for a cell of order %d.", status,
+                astGetClass( this ), (long long) npix, order );
+
+   } else {
+
+/* If the Moc has been negated, store the complement of its coverage and
+   clear the Negated flag. */
+      if( astGetNegated( this ) ) {
+         ranges = Complement( this->nrange, this->range, &nranges, status );
+         NewRanges( this, nranges, ranges, status );
+         astSetNegated( this, 0 );
+      }
+
+/* Get the range of AST__MXORDHPX cells covered by the supplied cell, and
+   combine it with the existing ranges. */
+      shift = 2*( AST__MXORDHPX - order );
+      cell[ 0 ] = npix << shift;
+      cell[ 1 ] = ( npix + 1 ) << shift;
+      ranges = Combine( cmode, this->nrange, this->range, 1, cell, &nranges,
+                        status );
+      NewRanges( this, nranges, ranges, status );
+   }
+}
+
+static void AddRegion( AstMoc *this, int cmode, AstRegion *region,
+                       int *status ){
+/*
+*++
+*  Name:
+c     astAddRegion
+f     AST_ADDREGION
+
+*  Purpose:
+*     Add a Region into an existing Moc.
+
+*  Type:
+*     Public virtual function.
+
+*  Synopsis:
+c     #include "moc.h"
+c     void astAddRegion( AstMoc *this, int cmode, AstRegion *region )
+f     CALL AST_ADDREGION( THIS, CMODE, REGION, STATUS )
+
+*  Class Membership:
+*     Moc method.
+
+*  Description:
+*     This function
+f     routine
+*     modifies a Moc by combining it with the area of the sky covered by
+*     a supplied Region. The Moc is modified in place.
+*
+*     If the supplied Region is itself a Moc, its cells are combined
+*     directly with those of the modified Moc, in a time proportional
+*     to the total number of cells. Any other class of Region is first
+*     rasterised onto the HEALPix grid at the order given by the
+*     MaxOrder attribute of the modified Moc. All HEALPix cells at that
+*     order which contain part of the boundary of the Region are included
+*     in the rasterised coverage, so that every point inside the
+*     Region is also inside the rasterised coverage (but see the Notes
+*     below). Larger cells that do not touch the boundary are used where
+*     possible.
+
+*  Parameters:
+c     this
+f     THIS = INTEGER (Given)
+*        Pointer to the Moc to be modified.
+c     cmode
+f     CMODE = INTEGER (Given)
+*        Indicates how the Region should be combined with the existing
+*        Moc. If AST__OR is supplied, the modified Moc is the union of
+*        the supplied Moc and the Region. If AST__AND is supplied, the
+*        modified Moc is the intersection of the supplied Moc and the
+*        Region.
+c     region
+f     REGION = INTEGER (Given)
+*        Pointer to the Region to be added into the Moc. It must be
+*        possible to convert the Frame represented by the Region into
+*        the celestial coordinate system represented by the Moc.
+f     STATUS = INTEGER (Given and Returned)
+f        The global status.
+
+*  Notes:
+*     - If the Moc has been negated, the coverage it represents is first
+*     inverted and its Negated attribute cleared, so that the Region is
+*     combined with the area actually represented by the Moc.
+*     - The boundary of the supplied Region is found using a mesh of
+*     points whose spacing is no larger than half the width of a cell at
+*     the MaxOrder order, up to a limit of one million points. An error
+*     is reported if more points than this would be needed (that is, if
+*     the boundary is longer than about half a million cells at the
+*     MaxOrder order). MaxOrder should then be reduced, or the Region
+*     split into smaller pieces.
+*     - Between adjacent mesh points, the boundary is assumed to follow
+*     a great circle, and every cell crossed by the great circle is
+*     included. A cell touched only by boundary detail much smaller than
+*     a cell (for instance, a sharp corner that is not itself on the
+*     mesh) may therefore be omitted. Adjacent mesh points that are more
+*     than ten times the typical mesh spacing apart are assumed to be on
+*     separate parts of the boundary (for instance, in a CmpRegion), and
+*     cells between them are not included.
+*--
+*/
+
+/* Local Variables: */
+   AstFrame *bfrm;               /* Base Frame of the Moc */
+   AstFrameSet *fs;              /* FrameSet connecting Region and Moc */
+   AstMapping *map;              /* Mapping from Region to Moc base Frame */
+   AstMapping *smap;             /* Simplified Mapping within mapped Moc */
+   AstMoc *moc;                  /* Mapped Region, if it is a Moc */
+   AstRegion *reg;               /* Region mapped into Moc base Frame */
+   int64_t *newr;                /* Ranges covered by the supplied Region */
+   int64_t *ranges;              /* Combined ranges */
+   int nnewr;                    /* Number of ranges in "newr" */
+   int nranges;                  /* Number of combined ranges */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Validate the combination mode. */
+   if( cmode != AST__AND && cmode != AST__OR ) {
+      astError( AST__OPRIN, "astAddRegion(%s): Illegal boolean operator "
+                "value (%d) supplied.", status, astGetClass( this ), cmode );
+      return;
+   }
+
+/* If the Moc has been negated, store the complement of its coverage and
+   clear the Negated flag. */
+   if( astGetNegated( this ) ) {
+      ranges = Complement( this->nrange, this->range, &nranges, status );
+      NewRanges( this, nranges, ranges, status );
+      astSetNegated( this, 0 );
+   }
+
+/* Find the Mapping from the Frame represented by the supplied Region to
+   the ICRS SkyFrame in which the Moc cells are defined. */
+   bfrm = astGetFrame( ((AstRegion *) this)->frameset, AST__BASE );
+   fs = astConvert( region, bfrm, "" );
+   if( !fs ) {
+      if( astOK ) astError( AST__NOCNV, "astAddRegion(%s): No Mapping can "
+                            "be found from the supplied %s to the celestial "
+                            "coordinate system used by the %s.", status,
+                            astGetClass( this ), astGetClass( region ),
+                            astGetClass( this ) );
+
+/* Map the supplied Region into the base Frame of the Moc. */
+   } else {
+      map = astGetMapping( fs, AST__BASE, AST__CURRENT );
+      reg = astMapRegion( region, map, bfrm );
+      map = astAnnul( map );
+      fs = astAnnul( fs );
+
+/* If the mapped Region is a Moc whose own cells are defined in the same
+   Frame, we can use its ranges directly. */
+      newr = NULL;
+      nnewr = 0;
+      moc = NULL;
+      if( astIsAMoc( reg ) ) {
+         map = astGetMapping( reg->frameset, AST__BASE, AST__CURRENT );
+         smap = astSimplify( map );
+         if( astIsAUnitMap( smap ) ) moc = (AstMoc *) reg;
+         smap = astAnnul( smap );
+         map = astAnnul( map );
+      }
+
+      if( moc ) {
+         if( astGetNegated( moc ) ) {
+            newr = Complement( moc->nrange, moc->range, &nnewr, status );
+         } else {
+            newr = astStore( NULL, moc->range,
+                             2*moc->nrange*sizeof( *moc->range ) );
+            nnewr = moc->nrange;
+         }
+
+/* Otherwise, rasterise the mapped Region onto the HEALPix grid. */
+      } else {
+         newr = Rasterise( this, reg, &nnewr, status );
+      }
+
+/* Combine the new ranges with the existing ranges. */
+      ranges = Combine( cmode, this->nrange, this->range, nnewr, newr,
+                        &nranges, status );
+      NewRanges( this, nranges, ranges, status );
+
+/* Free resources. */
+      newr = astFree( newr );
+      reg = astAnnul( reg );
+   }
+
+   bfrm = astAnnul( bfrm );
+}
+
+static AstPointSet *BoundaryMesh( AstMoc *this, double *spacing,
+                                  int *status ){
+/*
+*  Name:
+*     BoundaryMesh
+
+*  Purpose:
+*     Create a mesh of points on the boundary of a Moc.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     AstPointSet *BoundaryMesh( AstMoc *this, double *spacing,
+*                                int *status )
+
+*  Class Membership:
+*     Moc member function.
+
+*  Description:
+*     This function returns a PointSet holding points on the edges of
+*     the cells in the Moc that border an uncovered cell. Each cell edge
+*     is sampled at between 2 and 8 intervals, depending on the size of
+*     the cell. Each sample is retained if a position just outside the
+*     cell, on the far side of the edge, is not covered by the Moc.
+
+*  Parameters:
+*     this
+*        Pointer to the Moc.
+*     spacing
+*        Pointer to a double in which to return the largest spacing
+*        between adjacent samples along any cell edge, in radians. May be
+*        NULL.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Pointer to the PointSet, holding ICRS longitude and latitude
+*     values (radians). The Negated attribute of the Moc is ignored. If
+*     the Moc has no boundary, the PointSet holds a single point with bad
+*     axis values.
+
+*  Notes:
+*     - A NULL pointer is returned if an error has already occurred, or
+*     if this function should fail for any reason.
+*/
+
+/* Local Variables: */
+   AstPointSet *result;          /* Returned PointSet */
+   double **ptr;                 /* Pointers to returned axis values */
+   double *lat;                  /* Latitude of each boundary point */
+   double *lon;                  /* Longitude of each boundary point */
+   double cen[ 3 ];              /* Unit vector at cell centre */
+   double delta;                 /* Offset to the probe position */
+   double dx;                    /* Fractional X position within cell */
+   double dy;                    /* Fractional Y position within cell */
+   double edge[ 3 ];             /* Unit vector on cell edge */
+   double len;                   /* Length of offset vector */
+   double maxsp;                 /* Largest sample spacing */
+   double probe[ 3 ];            /* Unit vector just outside cell edge */
+   double sp;                    /* Sample spacing for current cell */
+   double t;                     /* Fractional position along edge */
+   int finest;                   /* Order of the smallest cells */
+   int i;                        /* Vector component index */
+   int icell;                    /* Cell index */
+   int iedge;                    /* Edge index */
+   int isamp;                    /* Sample index */
+   int n;                        /* Number of boundary points */
+   int nint;                     /* Number of intervals along each edge */
+   int order;                    /* Order of current cell */
+
+/* Initialise */
+   result = NULL;
+   if( spacing ) *spacing = 0.0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Ensure the list of cells is available, and find the order of the
+   smallest cell. */
+   MakeCells( this, status );
+   finest = ( this->ncell > 0 ) ? this->cellorder[ this->ncell - 1 ] : 0;
+
+/* Probe positions are this far outside the edge of each cell. */
+   delta = 0.01*CELL_SIZE( finest );
+
+/* Loop round every cell. */
+   lon = NULL;
+   lat = NULL;
+   n = 0;
+   maxsp = 0.0;
+   for( icell = 0; icell < this->ncell && astOK; icell++ ) {
+      order = this->cellorder[ icell ];
+
+/* Get the number of intervals into which each edge of this cell is
+   divided, and the corresponding spacing between samples. */
+      i = finest - order;
+      nint = 1 << ( ( i < 3 ) ? i : 3 );
+      if( nint < 2 ) nint = 2;
+      sp = CELL_SIZE( order )/nint;
+
+/* Get the unit vector at the cell centre. */
+      CellVec( order, this->cellnpix[ icell ], 0.5, 0.5, cen );
+
+/* Visit the corners of the cell in turn, sampling each edge between
+   one corner and the next. */
+      for( iedge = 0; iedge < 4; iedge++ ) {
+         for( isamp = 0; isamp < nint; isamp++ ) {
+            t = ( (double) isamp )/nint;
+            if( iedge == 0 ) {
+               dx = 1.0 - t;
+               dy = 1.0;
+            } else if( iedge == 1 ) {
+               dx = 0.0;
+               dy = 1.0 - t;
+            } else if( iedge == 2 ) {
+               dx = t;
+               dy = 0.0;
+            } else {
+               dx = 1.0;
+               dy = t;
+            }
+            CellVec( order, this->cellnpix[ icell ], dx, dy, edge );
+
+/* Form a probe position just outside the cell, by moving away from
+   the cell centre. */
+            len = 0.0;
+            for( i = 0; i < 3; i++ ) {
+               probe[ i ] = edge[ i ] - cen[ i ];
+               len += probe[ i ]*probe[ i ];
+            }
+            len = sqrt( len );
+            if( len <= 0.0 ) continue;
+            for( i = 0; i < 3; i++ ) {
+               probe[ i ] = edge[ i ] + delta*probe[ i ]/len;
+            }
+
+/* If the probe position is not covered by the Moc, the sample is on
+   the boundary of the Moc, so retain it. */
+            if( !InRanges( this, Loc2Nest( probe[ 2 ], sqrt( probe[ 0 ]*probe[ 0 ] + probe[ 1 ]*probe[ 1 ] ),
+                                           atan2( probe[ 1 ], probe[ 0 ] ) ) ) ) {
+               lon = astGrow( lon, n + 1, sizeof( *lon ) );
+               lat = astGrow( lat, n + 1, sizeof( *lat ) );
+               if( astOK ) {
+                  lon[ n ] = atan2( edge[ 1 ], edge[ 0 ] );
+                  if( lon[ n ] < 0.0 ) lon[ n ] += 2*AST__DPI;
+                  lat[ n ] = atan2( edge[ 2 ], sqrt( edge[ 0 ]*edge[ 0 ] +
+                                                     edge[ 1 ]*edge[ 1 ] ) );
+                  n++;
+                  if( sp > maxsp ) maxsp = sp;
+               }
+            }
+         }
+      }
+   }
+
+/* Store the boundary points in a new PointSet. If the Moc has no
+   boundary (i.e. it is empty or covers the whole sky), return a single
+   point with bad axis values, as is done by the NullRegion class. */
+   if( astOK ) {
+      result = astPointSet( ( n > 0 ) ? n : 1, 2, "", status );
+      ptr = astGetPoints( result );
+      if( astOK ) {
+         if( n > 0 ) {
+            memcpy( ptr[ 0 ], lon, n*sizeof( *lon ) );
+            memcpy( ptr[ 1 ], lat, n*sizeof( *lat ) );
+         } else {
+            ptr[ 0 ][ 0 ] = AST__BAD;
+            ptr[ 1 ][ 0 ] = AST__BAD;
+         }
+      }
+      if( spacing ) *spacing = maxsp;
+   }
+
+/* Free resources. */
+   lon = astFree( lon );
+   lat = astFree( lat );
+
+/* Annul the result if an error occurred. */
+   if( !astOK ) result = astAnnul( result );
+
+/* Return the result. */
+   return result;
+}
+
+static void CellVec( int order, int64_t npix, double dx, double dy,
+                     double vec[3] ){
+/*
+*  Name:
+*     CellVec
+
+*  Purpose:
+*     Get the unit vector at a position within a HEALPix cell.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     void CellVec( int order, int64_t npix, double dx, double dy,
+*                   double vec[3] )
+
+*  Class Membership:
+*     Moc member function.
+
+*  Description:
+*     This function returns the ICRS unit vector at a given fractional
+*     position within a HEALPix cell. The position (0.5,0.5) is the
+*     centre of the cell, and the four corners are at (0,0), (0,1), (1,0)
+*     and (1,1). The arithmetic follows the "xyf2loc" function in the
+*     HEALPix reference implementation.
+
+*  Parameters:
+*     order
+*        The HEALPix order of the cell.
+*     npix
+*        The nested index of the cell.
+*     dx
+*        The fractional position along the X axis of the cell.
+*     dy
+*        The fractional position along the Y axis of the cell.
+*     vec
+*        Returned holding the unit vector.
+*/
+
+/* Local Variables: */
+   double jr;                    /* Ring number within the base face */
+   double nr;                    /* Scaled number of pixels in the ring */
+   double nside;                 /* Number of cells along a base face edge */
+   double phi;                   /* Longitude */
+   double sth;                   /* Sine of the colatitude */
+   double tmp;                   /* Intermediate value */
+   double x;                     /* X position within the base face */
+   double y;                     /* Y position within the base face */
+   double z;                     /* Cosine of the colatitude */
+   int face;                     /* Base face number */
+   int64_t rem;                  /* Index within the base face */
+
+/* Decompose the nested index into a base face number and X and Y
+   positions within the face. */
+   face = (int)( npix >> ( 2*order ) );
+   rem = npix & ( ( INT64_C(1) << ( 2*order ) ) - 1 );
+   nside = (double)( INT64_C(1) << order );
+   x = ( Compress( rem ) + dx )/nside;
+   y = ( Compress( rem >> 1 ) + dy )/nside;
+
+/* Find the ring number, and so the z coordinate. */
+   jr = jrll[ face ] - x - y;
+   if( jr < 1.0 ) {
+      nr = jr;
+      tmp = nr*nr/3.0;
+      z = 1.0 - tmp;
+      sth = sqrt( tmp*( 2.0 - tmp ) );
+
+   } else if( jr > 3.0 ) {
+      nr = 4.0 - jr;
+      tmp = nr*nr/3.0;
+      z = tmp - 1.0;
+      sth = sqrt( tmp*( 2.0 - tmp ) );
+
+   } else {
+      nr = 1.0;
+      z = ( 2.0 - jr )*2.0/3.0;
+      sth = sqrt( ( 1.0 - z )*( 1.0 + z ) );
+   }
+
+/* Find the longitude. */
+   tmp = jpll[ face ]*nr + x - y;
+   if( tmp < 0.0 ) tmp += 8.0;
+   if( tmp >= 8.0 ) tmp -= 8.0;
+   phi = ( nr < 1.0E-15 ) ? 0.0 : ( 0.5*AST__DPIBY2*tmp )/nr;
+
+/* Form the unit vector. */
+   vec[ 0 ] = sth*cos( phi );
+   vec[ 1 ] = sth*sin( phi );
+   vec[ 2 ] = z;
+}
+
+static void ClearAttrib( AstObject *this_object, const char *attrib,
+                         int *status ) {
+/*
+*  Name:
+*     ClearAttrib
+
+*  Purpose:
+*     Clear an attribute value for a Moc.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     void ClearAttrib( AstObject *this, const char *attrib, int *status )
+
+*  Class Membership:
+*     Moc member function (over-rides the astClearAttrib protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function clears the value of a specified attribute for a
+*     Moc, so that the default value will subsequently be used.
+
+*  Parameters:
+*     this
+*        Pointer to the Moc.
+*     attrib
+*        Pointer to a null-terminated string specifying the attribute
+*        name.  This should be in lower case with no surrounding white
+*        space.
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Variables: */
+   AstMoc *this;                 /* Pointer to the Moc structure */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Obtain a pointer to the Moc structure. */
+   this = (AstMoc *) this_object;
+
+/* Check the attribute name and clear the appropriate attribute. */
+
+/* MaxOrder. */
+/* --------- */
+   if ( !strcmp( attrib, "maxorder" ) ) {
+      astClearMaxOrder( this );
+
+/* Test if the name matches any of the read-only attributes of this
+   class. If it does, then report an error. */
+   } else if ( !strcmp( attrib, "mocarea" ) ||
+               !strcmp( attrib, "moclength" ) ) {
+      astError( AST__NOWRT, "astClear: Invalid attempt to clear the \"%s\" "
+                "value for a %s.", status, attrib, astGetClass( this ) );
+      astError( AST__NOWRT, "This is a read-only attribute." , status);
+
+/* If the attribute is still not recognised, pass it on to the parent
+   method for further interpretation. */
+   } else {
+      (*parent_clearattrib)( this_object, attrib, status );
+   }
+}
+
+static int CmpDouble( const void *a, const void *b ){
+/*
+*  Name:
+*     CmpDouble
+
+*  Purpose:
+*     Compare two double precision values.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     int CmpDouble( const void *a, const void *b )
+
+*  Class Membership:
+*     Moc member function.
+
+*  Description:
+*     This function is a qsort comparison function that sorts double
+*     values into increasing order.
+
+*  Parameters:
+*     a
+*        Pointer to the first value.
+*     b
+*        Pointer to the second value.
+
+*  Returned Value:
+*     -1, 0 or +1 if the first value is less than, equal to, or greater
+*     than the second value.
+*/
+
+   double va = *( (const double *) a );
+   double vb = *( (const double *) b );
+   return ( va < vb ) ? -1 : ( ( va > vb ) ? 1 : 0 );
+}
+
+static int CmpIndex( const void *a, const void *b ){
+/*
+*  Name:
+*     CmpIndex
+
+*  Purpose:
+*     Compare two nested HEALPix indices.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     int CmpIndex( const void *a, const void *b )
+
+*  Class Membership:
+*     Moc member function.
+
+*  Description:
+*     This function is a qsort comparison function that sorts int64_t
+*     values into increasing order.
+
+*  Parameters:
+*     a
+*        Pointer to the first value.
+*     b
+*        Pointer to the second value.
+
+*  Returned Value:
+*     -1, 0 or +1 if the first value is less than, equal to, or greater
+*     than the second value.
+*/
+
+   int64_t va = *( (const int64_t *) a );
+   int64_t vb = *( (const int64_t *) b );
+   return ( va < vb ) ? -1 : ( ( va > vb ) ? 1 : 0 );
+}
+
+static int64_t *Combine( int cmode, int n1, const int64_t *r1, int n2,
+                         const int64_t *r2, int *nout, int *status ){
+/*
+*  Name:
+*     Combine
+
+*  Purpose:
+*     Form the union or intersection of two lists of cell ranges.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     int64_t *Combine( int cmode, int n1, const int64_t *r1, int n2,
+*                       const int64_t *r2, int *nout, int *status )
+
+*  Class Membership:
+*     Moc member function.
+
+*  Description:
+*     This function combines two sorted lists of disjoint, non-adjacent
+*     cell ranges into a single list of the same form, using a single
+*     pass through both lists.
+
+*  Parameters:
+*     cmode
+*        AST__OR for the union of the two lists, or AST__AND for the
+*        intersection.
+*     n1
+*        The number of ranges in the first list.
+*     r1
+*        The first list. Holds "2*n1" values - the first and
+*        last-plus-one cell index in each range.
+*     n2
+*        The number of ranges in the second list.
+*     r2
+*        The second list. Holds "2*n2" values.
+*     nout
+*        Returned holding the number of ranges in the returned list.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A pointer to a newly allocated array holding "2*nout" values,
+*     which should be freed using astFree when no longer needed. NULL
+*     may be returned if the list is empty.
+*/
+
+/* Local Variables: */
+   const int64_t *r;             /* Next range to be added to the union */
+   int64_t *result;              /* Returned list */
+   int64_t hi;                   /* Upper limit of overlap */
+   int64_t lo;                   /* Lower limit of overlap */
+   int i1;                       /* Index of next range in first list */
+   int i2;                       /* Index of next range in second list */
+   int n;                        /* Number of ranges in returned list */
+
+/* Initialise */
+   *nout = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return NULL;
+
+/* Allocate the largest array that may be needed. */
+   result = astMalloc( 2*( n1 + n2 )*sizeof( *result ) );
+   if( !astOK ) return result;
+
+   i1 = 0;
+   i2 = 0;
+   n = 0;
+
+/* For a union, take the ranges from the two lists in order of increasing
+   lower limit, merging each one into the previous output range if they
+   overlap or touch. */
+   if( cmode == AST__OR ) {
+      while( i1 < n1 || i2 < n2 ) {
+         if( i2 >= n2 || ( i1 < n1 && r1[ 2*i1 ] <= r2[ 2*i2 ] ) ) {
+            r = r1 + 2*( i1++ );
+         } else {
+            r = r2 + 2*( i2++ );
+         }
+
+         if( n > 0 && r[ 0 ] <= result[ 2*n - 1 ] ) {
+            if( r[ 1 ] > result[ 2*n - 1 ] ) result[ 2*n - 1 ] = r[ 1 ];
+         } else {
+            result[ 2*n ] = r[ 0 ];
+            result[ 2*n + 1 ] = r[ 1 ];
+            n++;
+         }
+      }
+
+/* For an intersection, step through both lists together, storing the
+   overlap between the current range in each, and then advancing
+   whichever range ends first. */
+   } else {
+      while( i1 < n1 && i2 < n2 ) {
+         lo = ( r1[ 2*i1 ] > r2[ 2*i2 ] ) ? r1[ 2*i1 ] : r2[ 2*i2 ];
+         hi = ( r1[ 2*i1 + 1 ] < r2[ 2*i2 + 1 ] ) ? r1[ 2*i1 + 1 ] : r2[ 2*i2 + 1 ];
+         if( lo < hi ) {
+            result[ 2*n ] = lo;
+            result[ 2*n + 1 ] = hi;
+            n++;
+         }
+         if( r1[ 2*i1 + 1 ] < r2[ 2*i2 + 1 ] ) {
+            i1++;
+         } else {
+            i2++;
+         }
+      }
+   }
+
+/* Return the result. */
+   *nout = n;
+   return result;
+}
+
+static int64_t *Complement( int nin, const int64_t *in, int *nout,
+                            int *status ){
+/*
+*  Name:
+*     Complement
+
+*  Purpose:
+*     Find the complement of a list of cell ranges.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     int64_t *Complement( int nin, const int64_t *in, int *nout,
+*                          int *status )
+
+*  Class Membership:
+*     Moc member function.
+
+*  Description:
+*     This function returns a list of the ranges of cells at order
+*     AST__MXORDHPX that are not included in a supplied list.
+
+*  Parameters:
+*     nin
+*        The number of ranges in the supplied list.
+*     in
+*        The supplied list. Holds "2*nin" values.
+*     nout
+*        Returned holding the number of ranges in the returned list.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A pointer to a newly allocated array holding "2*nout" values,
+*     which should be freed using astFree when no longer needed.
+*/
+
+/* Local Variables: */
+   int64_t *result;              /* Returned list */
+   int64_t lo;                   /* Start of next gap */
+   int i;                        /* Input range index */
+   int n;                        /* Number of output ranges */
+
+/* Initialise */
+   *nout = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return NULL;
+
+/* Allocate the largest array that may be needed. */
+   result = astMalloc( 2*( nin + 1 )*sizeof( *result ) );
+   if( !astOK ) return result;
+
+/* Store the gaps between the supplied ranges, including any gaps at the
+   start and end of the list. */
+   n = 0;
+   lo = 0;
+   for( i = 0; i < nin; i++ ) {
+      if( in[ 2*i ] > lo ) {
+         result[ 2*n ] = lo;
+         result[ 2*n + 1 ] = in[ 2*i ];
+         n++;
+      }
+      lo = in[ 2*i + 1 ];
+   }
+
+   if( lo < NCELL_MX ) {
+      result[ 2*n ] = lo;
+      result[ 2*n + 1 ] = NCELL_MX;
+      n++;
+   }
+
+/* Return the result. */
+   *nout = n;
+   return result;
+}
+
+static int64_t Compress( int64_t v ){
+/*
+*  Name:
+*     Compress
+
+*  Purpose:
+*     Extract the even-numbered bits from an integer.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     int64_t Compress( int64_t v )
+
+*  Class Membership:
+*     Moc member function.
+
+*  Description:
+*     This function returns an integer formed from bits 0, 2, 4, ... of
+*     the supplied integer. It is the inverse of the Spread function, and
+*     is used to extract X and Y positions from a nested HEALPix index.
+
+*  Parameters:
+*     v
+*        The supplied integer.
+
+*  Returned Value:
+*     The compressed value.
+*/
+
+   v &= INT64_C(0x5555555555555555);
+   v = ( v | ( v >> 1 ) ) & INT64_C(0x3333333333333333);
+   v = ( v | ( v >> 2 ) ) & INT64_C(0x0f0f0f0f0f0f0f0f);
+   v = ( v | ( v >> 4 ) ) & INT64_C(0x00ff00ff00ff00ff);
+   v = ( v | ( v >> 8 ) ) & INT64_C(0x0000ffff0000ffff);
+   v = ( v | ( v >> 16 ) ) & INT64_C(0x00000000ffffffff);
+   return v;
+}
+
+static MocCell *Descend( int order, int64_t npix, int maxorder,
+                         const int64_t *bnd, int nbnd, MocCell *cells,
+                         int *ncell, int *status ){
+/*
+*  Name:
+*     Descend
+
+*  Purpose:
+*     Subdivide a HEALPix cell while rasterising a Region.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     MocCell *Descend( int order, int64_t npix, int maxorder,
+*                       const int64_t *bnd, int nbnd, MocCell *cells,
+*                       int *ncell, int *status )
+
+*  Class Membership:
+*     Moc member function.
+
+*  Description:
+*     This function appends a description of a given HEALPix cell to a
+*     list of cells. If the cell contains any part of the boundary of the
+*     Region being rasterised, and is larger than a cell at order
+*     "maxorder", it is instead divided into its four child cells, and
+*     this function is invoked recursively on each child. Cells are
+*     appended to the list in order of increasing nested index.
+
+*  Parameters:
+*     order
+*        The order of the cell.
+*     npix
+*        The nested index of the cell.
+*     maxorder
+*        The finest order to use.
+*     bnd
+*        A sorted list of the nested indices at order "maxorder" of the
+*        cells that contain part of the Region boundary and that are
+*        descendants of the given cell.
+*     nbnd
+*        The length of the "bnd" array.
+*     cells
+*        The list of cells. It is extended as required.
+*     ncell
+*        Pointer to the number of cells in the list. Updated on exit.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A pointer to the extended list of cells.
+*/
+
+/* Local Variables: */
+   int64_t child;                /* Nested index of child cell */
+   int64_t hi;                   /* First "maxorder" index after child */
+   int ichild;                   /* Child index */
+   int j;                        /* Index of first boundary cell in child */
+   int k;                        /* Index of first boundary cell after child */
+   int shift;                    /* Bit shift from child order to maxorder */
+
+/* Check the global error status. */
+   if ( !astOK ) return cells;
+
+/* If the cell contains no boundary, or is at the finest order, append it
+   to the list. Cells that do not touch the boundary are marked for
+   testing later. Cells that touch the boundary are included. */
+   if( nbnd == 0 || order == maxorder ) {
+      cells = astGrow( cells, *ncell + 1, sizeof( *cells ) );
+      if( astOK ) {
+         cells[ *ncell ].order = order;
+         cells[ *ncell ].npix = npix;
+         cells[ *ncell ].flag = ( nbnd == 0 ) ? 0 : 1;
+         (*ncell)++;
+      }
+
+/* Otherwise, divide the boundary cells between the four children and
+   descend into each child in turn. */
+   } else {
+      shift = 2*( maxorder - order - 1 );
+      j = 0;
+      for( ichild = 0; ichild < 4; ichild++ ) {
+         child = 4*npix + ichild;
+         hi = ( child + 1 ) << shift;
+         k = j;
+         while( k < nbnd && bnd[ k ] < hi ) k++;
+         cells = Descend( order + 1, child, maxorder, bnd + j, k - j,
+                          cells, ncell, status );
+         j = k;
+      }
+   }
+
+/* Return the extended list. */
+   return cells;
+}
+
+static int Equal( AstObject *this_object, AstObject *that_object, int *status ) {
+/*
+*  Name:
+*     Equal
+
+*  Purpose:
+*     Test if two Mocs are equivalent.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     int Equal( AstObject *this, AstObject *that, int *status )
+
+*  Class Membership:
+*     Moc member function (over-rides the astEqual protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function returns a boolean result (0 or 1) to indicate whether
+*     two Mocs are equivalent.
+
+*  Parameters:
+*     this
+*        Pointer to the first Moc.
+*     that
+*        Pointer to the second Moc.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     One if the Mocs are equivalent, zero otherwise.
+
+*  Notes:
+*     - The Mocs are equivalent if they cover the same cells and are
+*     equivalent as Regions.
+*     - A value of zero will be returned if this function is invoked
+*     with the global status set, or if it should fail for any reason.
+*/
+
+/* Local Variables: */
+   AstMoc *that;
+   AstMoc *this;
+   int result;
+
+/* Initialise. */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Invoke the Equal method inherited from the parent Region class. This checks
+   that the Objects are both of the same class, and have the same Negated
+   and Closed flags (amongst other things). */
+   if( (*parent_equal)( this_object, that_object, status ) ) {
+
+/* Obtain pointers to the two Moc structures. */
+      this = (AstMoc *) this_object;
+      that = (AstMoc *) that_object;
+
+/* Compare their cell ranges. */
+      if( this->nrange == that->nrange ) {
+         result = ( this->nrange == 0 ||
+                    !memcmp( this->range, that->range,
+                             2*this->nrange*sizeof( *this->range ) ) );
+      }
+   }
+
+/* If an error occurred, clear the result value. */
+   if ( !astOK ) result = 0;
+
+/* Return the result, */
+   return result;
+}
+
+static const char *GetAttrib( AstObject *this_object, const char *attrib,
+                              int *status ) {
+/*
+*  Name:
+*     GetAttrib
+
+*  Purpose:
+*     Get the value of a specified attribute for a Moc.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     const char *GetAttrib( AstObject *this, const char *attrib, int *status )
+
+*  Class Membership:
+*     Moc member function (over-rides the protected astGetAttrib
+*     method inherited from the Region class).
+
+*  Description:
+*     This function returns a pointer to the value of a specified
+*     attribute for a Moc, formatted as a character string.
+
+*  Parameters:
+*     this
+*        Pointer to the Moc.
+*     attrib
+*        Pointer to a null-terminated string containing the name of
+*        the attribute whose value is required. This name should be in
+*        lower case, with all white space removed.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     - Pointer to a null-terminated string containing the attribute
+*     value.
+
+*  Notes:
+*     - The returned string pointer may point at memory allocated
+*     within the Moc, or at static memory. The contents of the
+*     string may be over-written or the pointer may become invalid
+*     following a further invocation of the same function or any
+*     modification of the Moc. A copy of the string should
+*     therefore be made if necessary.
+*     - A NULL pointer will be returned if this function is invoked
+*     with the global error status set, or if it should fail for any
+*     reason.
+*/
+
+/* Local Variables: */
+   astDECLARE_GLOBALS            /* Pointer to thread-specific global data */
+   AstMoc *this;                 /* Pointer to the Moc structure */
+   const char *result;           /* Pointer value to return */
+   double dval;                  /* Floating point attribute value */
+   int ival;                     /* Integer attribute value */
+
+/* Initialise. */
+   result = NULL;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Get a pointer to the thread specific global data structure. */
+   astGET_GLOBALS(this_object);
+
+/* Obtain a pointer to the Moc structure. */
+   this = (AstMoc *) this_object;
+
+/* Compare "attrib" with each recognised attribute name in turn,
+   obtaining the value of the required attribute. If necessary, write
+   the value into "getattrib_buff" as a null-terminated string in an appropriate
+   format.  Set "result" to point at the result string. */
+
+/* MaxOrder. */
+/* --------- */
+   if ( !strcmp( attrib, "maxorder" ) ) {
+      ival = astGetMaxOrder( this );
+      if ( astOK ) {
+         (void) sprintf( getattrib_buff, "%d", ival );
+         result = getattrib_buff;
+      }
+
+/* MocArea. */
+/* -------- */
+   } else if ( !strcmp( attrib, "mocarea" ) ) {
+      dval = astGetMocArea( this );
+      if ( astOK ) {
+         (void) sprintf( getattrib_buff, "%.*g", DBL_DIG, dval );
+         result = getattrib_buff;
+      }
+
+/* MocLength. */
+/* ---------- */
+   } else if ( !strcmp( attrib, "moclength" ) ) {
+      ival = astGetMocLength( this );
+      if ( astOK ) {
+         (void) sprintf( getattrib_buff, "%d", ival );
+         result = getattrib_buff;
+      }
+
+/* If the attribute name was not recognised, pass it on to the parent
+   method for further interpretation. */
+   } else {
+      result = (*parent_getattrib)( this_object, attrib, status );
+   }
+
+/* Return the result. */
+   return result;
+
+}
+
+static void GetCell( AstMoc *this, int icell, int *order, int64_t *npix,
+                     int *status ){
+/*
+*++
+*  Name:
+c     astGetCell
+f     AST_GETCELL
+
+*  Purpose:
+*     Get the order and index of a single cell in a Moc.
+
+*  Type:
+*     Public virtual function.
+
+*  Synopsis:
+c     #include "moc.h"
+c     void astGetCell( AstMoc *this, int icell, int *order, int64_t *npix )
+f     CALL AST_GETCELL( THIS, ICELL, ORDER, NPIX, STATUS )
+
+*  Class Membership:
+*     Moc method.
+
+*  Description:
+*     This function
+f     routine
+*     returns the HEALPix order and nested index of a single cell in a
+*     Moc. The cells are those of the shortest description of the Moc
+*     as a list of HEALPix cells - each cell is as large as possible,
+*     and no two cells overlap. The cells are ordered by increasing
+*     order, and then by increasing index within each order. The number
+*     of cells is given by the MocLength attribute.
+
+*  Parameters:
+c     this
+f     THIS = INTEGER (Given)
+*        Pointer to the Moc.
+c     icell
+f     ICELL = INTEGER (Given)
+*        The one-based index of the required cell, in the range 1 to the
+*        value of the MocLength attribute.
+c     order
+f     ORDER = INTEGER (Returned)
+c        Pointer to an int in which to return
+f        Returned holding
+*        the HEALPix order of the cell.
+c     npix
+f     NPIX = INTEGER*8 (Returned)
+c        Pointer to an int64_t in which to return
+f        Returned holding
+*        the nested index of the cell.
+f     STATUS = INTEGER (Given and Returned)
+f        The global status.
+
+*  Notes:
+*     - The Negated attribute of the Moc is ignored.
+*--
+*/
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Ensure the list of cells is available. */
+   MakeCells( this, status );
+
+/* Validate the cell index and return the cell. */
+   if( astOK ) {
+      if( icell < 1 || icell > this->ncell ) {
+         astError( AST__BDPAR, "astGetCell(%s): Invalid cell index (%d) "
+                   "supplied - must be in the range 1 to %d.", status,
+                   astGetClass( this ), icell, this->ncell );
+      } else {
+         *order = this->cellorder[ icell - 1 ];
+         *npix = this->cellnpix[ icell - 1 ];
+      }
+   }
+}
+
+static AstRegion *GetDefUnc( AstRegion *this_region, int *status ) {
+/*
+*  Name:
+*     GetDefUnc
+
+*  Purpose:
+*     Obtain a pointer to the default uncertainty Region for a given Region.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     AstRegion *GetDefUnc( AstRegion *this, int *status )
+
+*  Class Membership:
+*     Moc member function (over-rides the astGetDefUnc protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function returns a pointer to a Region which represents the
+*     default uncertainty associated with a position on the boundary of the
+*     given Region. The returned Region refers to the base Frame within the
+*     FrameSet encapsulated by the supplied Region. For a Moc, it is a
+*     Circle with a diameter equal to the width of the smallest cell.
+
+*  Parameters:
+*     this
+*        Pointer to the Region.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A pointer to the Region. This should be annulled (using astAnnul)
+*     when no longer needed.
+
+*  Notes:
+*     - A NULL pointer will be returned if this function is invoked
+*     with the global error status set, or if it should fail for any
+*     reason.
+*/
+
+/* Local Variables: */
+   AstFrame *bfrm;               /* Base Frame of the Moc */
+   AstMoc *this;                 /* Pointer to Moc structure */
+   AstRegion *result;            /* Returned pointer */
+   double cen[ 2 ];              /* Centre of the Circle */
+   double rad;                   /* Radius of the Circle */
+   int finest;                   /* Order of the smallest cells */
+
+/* Initialise */
+   result = NULL;
+
+/* Check inherited status */
+   if( !astOK ) return result;
+
+/* Get a pointer to the Moc structure. */
+   this = (AstMoc *) this_region;
+
+/* Find the order of the smallest cell. Use MaxOrder if the Moc is
+   empty. */
+   MakeCells( this, status );
+   finest = ( this->ncell > 0 ) ? this->cellorder[ this->ncell - 1 ] :
+                                  astGetMaxOrder( this );
+
+/* Create a Circle in the base Frame, centred on the origin. */
+   bfrm = astGetFrame( this_region->frameset, AST__BASE );
+   cen[ 0 ] = 0.0;
+   cen[ 1 ] = 0.0;
+   rad = 0.5*CELL_SIZE( finest );
+   result = (AstRegion *) astCircle( bfrm, 1, cen, &rad, NULL, "", status );
+   bfrm = astAnnul( bfrm );
+
+/* Return the default uncertainty Region. */
+   return result;
+}
+
+static double GetMocArea( AstMoc *this, int *status ){
+/*
+*+
+*  Name:
+*     astGetMocArea
+
+*  Purpose:
+*     Get the area covered by a Moc.
+
+*  Type:
+*     Protected virtual function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     double astGetMocArea( AstMoc *this )
+
+*  Class Membership:
+*     Moc method.
+
+*  Description:
+*     This function returns the value of the MocArea attribute - the
+*     area covered by the Moc in square arc-minutes. The Negated
+*     attribute is ignored.
+
+*  Parameters:
+*     this
+*        Pointer to the Moc.
+
+*  Returned Value:
+*     The area, in square arc-minutes.
+*-
+*/
+
+/* Local Variables: */
+   double ncov;                  /* Number of covered cells */
+   int i;                        /* Range index */
+
+/* Check the global error status. */
+   if ( !astOK ) return 0.0;
+
+/* Count the covered cells at order AST__MXORDHPX. */
+   ncov = 0.0;
+   for( i = 0; i < this->nrange; i++ ) {
+      ncov += (double)( this->range[ 2*i + 1 ] - this->range[ 2*i ] );
+   }
+
+/* Convert to square arc-minutes. */
+   return ncov*( 4*AST__DPI/(double) NCELL_MX )*
+          ( 60.0*AST__DR2D )*( 60.0*AST__DR2D );
+}
+
+static int GetMocLength( AstMoc *this, int *status ){
+/*
+*+
+*  Name:
+*     astGetMocLength
+
+*  Purpose:
+*     Get the number of cells in a Moc.
+
+*  Type:
+*     Protected virtual function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     int astGetMocLength( AstMoc *this )
+
+*  Class Membership:
+*     Moc method.
+
+*  Description:
+*     This function returns the value of the MocLength attribute - the
+*     number of cells in the shortest description of the Moc as a list of
+*     non-overlapping HEALPix cells.
+
+*  Parameters:
+*     this
+*        Pointer to the Moc.
+
+*  Returned Value:
+*     The number of cells.
+*-
+*/
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* Ensure the list of cells is available, and return its length. */
+   MakeCells( this, status );
+   return astOK ? this->ncell : 0;
+}
+
+static int GetObjSize( AstObject *this_object, int *status ) {
+/*
+*  Name:
+*     GetObjSize
+
+*  Purpose:
+*     Return the in-memory size of an Object.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     int GetObjSize( AstObject *this, int *status )
+
+*  Class Membership:
+*     Moc member function (over-rides the astGetObjSize protected
+*     method inherited from the parent class).
+
+*  Description:
+*     This function returns the in-memory size of the supplied Moc,
+*     in bytes.
+
+*  Parameters:
+*     this
+*        Pointer to the Moc.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The Object size, in bytes.
+
+*  Notes:
+*     - A value of zero will be returned if this function is invoked
+*     with the global status set, or if it should fail for any reason.
+*/
+
+/* Local Variables: */
+   AstMoc *this;              /* Pointer to Moc structure */
+   int result;                /* Result value to return */
+
+/* Initialise. */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Obtain a pointers to the Moc structure. */
+   this = (AstMoc *) this_object;
+
+/* Invoke the GetObjSize method inherited from the parent class, and then
+   add on any components of the class structure defined by this class
+   which are stored in dynamically allocated memory. */
+   result = (*parent_getobjsize)( this_object, status );
+
+   result += astTSizeOf( this->range );
+   result += astTSizeOf( this->cellorder );
+   result += astTSizeOf( this->cellnpix );
+
+/* If an error occurred, clear the result value. */
+   if ( !astOK ) result = 0;
+
+/* Return the result, */
+   return result;
+}
+
+void astInitMocVtab_(  AstMocVtab *vtab, const char *name, int *status ) {
+/*
+*+
+*  Name:
+*     astInitMocVtab
+
+*  Purpose:
+*     Initialise a virtual function table for a Moc.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     void astInitMocVtab( AstMocVtab *vtab, const char *name )
+
+*  Class Membership:
+*     Moc vtab initialiser.
+
+*  Description:
+*     This function initialises the component of a virtual function
+*     table which is used by the Moc class.
+
+*  Parameters:
+*     vtab
+*        Pointer to the virtual function table. The components used by
+*        all ancestral classes will be initialised if they have not already
+*        been initialised.
+*     name
+*        Pointer to a constant null-terminated character string which contains
+*        the name of the class to which the virtual function table belongs (it
+*        is this pointer value that will subsequently be returned by the Object
+*        astClass function).
+*-
+*/
+
+/* Local Variables: */
+   astDECLARE_GLOBALS            /* Pointer to thread-specific global data */
+   AstObjectVtab *object;        /* Pointer to Object component of Vtab */
+   AstMappingVtab *mapping;      /* Pointer to Mapping component of Vtab */
+   AstRegionVtab *region;        /* Pointer to Region component of Vtab */
+
+/* Check the local error status. */
+   if ( !astOK ) return;
+
+/* Get a pointer to the thread specific global data structure. */
+   astGET_GLOBALS(NULL);
+
+/* Initialize the component of the virtual function table used by the
+   parent class. */
+   astInitRegionVtab( (AstRegionVtab *) vtab, name );
+
+/* Store a unique "magic" value in the virtual function table. This
+   will be used (by astIsAMoc) to determine if an object belongs
+   to this class.  We can conveniently use the address of the (static)
+   class_check variable to generate this unique value. */
+   vtab->id.check = &class_check;
+   vtab->id.parent = &(((AstRegionVtab *) vtab)->id);
+
+/* Initialise member function pointers. */
+/* ------------------------------------ */
+/* Store pointers to the member functions (implemented here) that provide
+   virtual methods for this class. */
+   vtab->AddCell = AddCell;
+   vtab->AddRegion = AddRegion;
+   vtab->GetCell = GetCell;
+   vtab->GetMocArea = GetMocArea;
+   vtab->GetMocLength = GetMocLength;
+   vtab->ClearMaxOrder = ClearMaxOrder;
+   vtab->GetMaxOrder = GetMaxOrder;
+   vtab->SetMaxOrder = SetMaxOrder;
+   vtab->TestMaxOrder = TestMaxOrder;
+
+/* Save the inherited pointers to methods that will be extended, and
+   replace them with pointers to the new member functions. */
+   object = (AstObjectVtab *) vtab;
+   mapping = (AstMappingVtab *) vtab;
+   region = (AstRegionVtab *) vtab;
+
+   parent_equal = object->Equal;
+   object->Equal = Equal;
+
+   parent_getobjsize = object->GetObjSize;
+   object->GetObjSize = GetObjSize;
+
+   parent_clearattrib = object->ClearAttrib;
+   object->ClearAttrib = ClearAttrib;
+
+   parent_getattrib = object->GetAttrib;
+   object->GetAttrib = GetAttrib;
+
+   parent_setattrib = object->SetAttrib;
+   object->SetAttrib = SetAttrib;
+
+   parent_testattrib = object->TestAttrib;
+   object->TestAttrib = TestAttrib;
+
+   parent_transform = mapping->Transform;
+   mapping->Transform = Transform;
+
+/* Store replacement pointers for methods which will be over-ridden by
+   new member functions implemented here. */
+   region->GetDefUnc = GetDefUnc;
+   region->RegBaseBox = RegBaseBox;
+   region->RegBaseMesh = RegBaseMesh;
+   region->RegPins = RegPins;
+
+/* Declare the copy constructor, destructor and class dump
+   functions. */
+   astSetDelete( vtab, Delete );
+   astSetCopy( vtab, Copy );
+   astSetDump( vtab, Dump, "Moc", "Multi-order sky coverage map" );
+
+/* If we have just initialised the vtab for the current class, indicate
+   that the vtab is now initialised, and store a pointer to the class
+   identifier in the base "object" level of the vtab. */
+   if( vtab == &class_vtab ) {
+      class_init = 1;
+      astSetVtabClassIdentifier( vtab, &(vtab->id) );
+   }
+}
+
+static int InRanges( AstMoc *this, int64_t index ){
+/*
+*  Name:
+*     InRanges
+
+*  Purpose:
+*     Is a cell covered by a Moc?
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     int InRanges( AstMoc *this, int64_t index )
+
+*  Class Membership:
+*     Moc member function.
+
+*  Description:
+*     This function uses a binary search of the list of ranges in a Moc
+*     to determine if a given cell at order AST__MXORDHPX is covered by
+*     the Moc. The Negated attribute is ignored.
+
+*  Parameters:
+*     this
+*        Pointer to the Moc.
+*     index
+*        The nested index of the cell at order AST__MXORDHPX.
+
+*  Returned Value:
+*     Non-zero if the cell is covered by the Moc.
+*/
+
+/* Local Variables: */
+   int hi;                       /* Upper limit of search */
+   int lo;                       /* Lower limit of search */
+   int mid;                      /* Middle of search */
+
+/* Find the last range that starts at or before the given cell. */
+   lo = 0;
+   hi = this->nrange;
+   while( lo < hi ) {
+      mid = ( lo + hi )/2;
+      if( this->range[ 2*mid ] <= index ) {
+         lo = mid + 1;
+      } else {
+         hi = mid;
+      }
+   }
+
+/* The cell is covered if that range ends after the cell. */
+   return ( lo > 0 && index < this->range[ 2*lo - 1 ] );
+}
+
+static int64_t Loc2Nest( double z, double sth, double phi ){
+/*
+*  Name:
+*     Loc2Nest
+
+*  Purpose:
+*     Find the HEALPix cell containing a given sky position.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     int64_t Loc2Nest( double z, double sth, double phi )
+
+*  Class Membership:
+*     Moc member function.
+
+*  Description:
+*     This function returns the nested index of the cell at order
+*     AST__MXORDHPX that contains a given sky position. The index of the
+*     cell containing the position at any lower order "n" can be found
+*     by shifting the returned value right by 2*(AST__MXORDHPX-n) bits.
+*     The arithmetic follows the "loc2pix" function in the HEALPix
+*     reference implementation.
+
+*  Parameters:
+*     z
+*        The sine of the latitude.
+*     sth
+*        The cosine of the latitude (non-negative). This is used in
+*        preference to "z" close to the poles.
+*     phi
+*        The longitude, in radians.
+
+*  Returned Value:
+*     The nested index.
+*/
+
+/* Local Variables: */
+   double temp1;                 /* Intermediate value */
+   double temp2;                 /* Intermediate value */
+   double tmp;                   /* Intermediate value */
+   double tp;                    /* Fractional position within quadrant */
+   double tt;                    /* Longitude in units of 90 degrees */
+   double za;                    /* Absolute value of z */
+   int face;                     /* Base face number */
+   int ntt;                      /* Quadrant index */
+   int64_t ifm;                  /* Face index along one diagonal */
+   int64_t ifp;                  /* Face index along the other diagonal */
+   int64_t ix;                   /* X position within the base face */
+   int64_t iy;                   /* Y position within the base face */
+   int64_t jm;                   /* Pixel index along one diagonal */
+   int64_t jp;                   /* Pixel index along the other diagonal */
+   int64_t nside;                /* Number of cells along a base face edge */
+
+   nside = INT64_C(1) << AST__MXORDHPX;
+
+/* Express the longitude in units of 90 degrees, in the range [0,4). */
+   tt = fmod( phi/AST__DPIBY2, 4.0 );
+   if( tt < 0.0 ) tt += 4.0;
+   if( tt >= 4.0 ) tt = 0.0;
+
+/* Equatorial region. */
+   za = fabs( z );
+   if( za <= 2.0/3.0 ) {
+      temp1 = nside*( 0.5 + tt );
+      temp2 = nside*( z*0.75 );
+      jp = (int64_t)( temp1 - temp2 );
+      jm = (int64_t)( temp1 + temp2 );
+      ifp = jp >> AST__MXORDHPX;
+      ifm = jm >> AST__MXORDHPX;
+      if( ifp == ifm ) {
+         face = (int)( ifp | 4 );
+      } else if( ifp < ifm ) {
+         face = (int) ifp;
+      } else {
+         face = (int)( ifm + 8 );
+      }
+      ix = jm & ( nside - 1 );
+      iy = nside - ( jp & ( nside - 1 ) ) - 1;
+
+/* Polar caps. */
+   } else {
+      ntt = (int) tt;
+      if( ntt > 3 ) ntt = 3;
+      tp = tt - ntt;
+      if( za < 0.99 ) {
+         tmp = nside*sqrt( 3.0*( 1.0 - za ) );
+      } else {
+         tmp = nside*sth/sqrt( ( 1.0 + za )/3.0 );
+      }
+      jp = (int64_t)( tp*tmp );
+      jm = (int64_t)( ( 1.0 - tp )*tmp );
+      if( jp >= nside ) jp = nside - 1;
+      if( jm >= nside ) jm = nside - 1;
+      if( z >= 0.0 ) {
+         face = ntt;
+         ix = nside - jm - 1;
+         iy = nside - jp - 1;
+      } else {
+         face = ntt + 8;
+         ix = jp;
+         iy = jm;
+      }
+   }
+
+/* Interleave the bits of the X and Y positions to form the nested index
+   within the face. */
+   return ( ( (int64_t) face ) << ( 2*AST__MXORDHPX ) ) + Spread( ix ) +
+          ( Spread( iy ) << 1 );
+}
+
+static void MakeCells( AstMoc *this, int *status ){
+/*
+*  Name:
+*     MakeCells
+
+*  Purpose:
+*     Ensure the list of cells in a Moc is available.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     void MakeCells( AstMoc *this, int *status )
+
+*  Class Membership:
+*     Moc member function.
+
+*  Description:
+*     This function decomposes the ranges stored in a Moc into the
+*     shortest list of non-overlapping HEALPix cells, sorted by order and
+*     then by index, and caches the list in the Moc structure. It
+*     returns without action if the list is already available.
+
+*  Parameters:
+*     this
+*        Pointer to the Moc.
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Variables: */
+   int count[ AST__MXORDHPX + 1 ]; /* Number of cells at each order */
+   int64_t hi;                   /* End of current range */
+   int64_t lo;                   /* Start of next cell */
+   int irange;                   /* Range index */
+   int next[ AST__MXORDHPX + 1 ]; /* Index of next cell at each order */
+   int order;                    /* Cell order */
+   int pass;                     /* Counting pass or storing pass? */
+   int shift;                    /* Bit shift from "order" to AST__MXORDHPX */
+
+/* Check the global error status. */
+   if ( !astOK || this->ncell >= 0 ) return;
+
+/* We make two passes through the ranges. The first counts the cells at
+   each order, and the second stores them in the correct place. Within
+   each range, each cell is the largest aligned cell that starts at the
+   current position and does not extend past the end of the range. */
+   for( order = 0; order <= AST__MXORDHPX; order++ ) count[ order ] = 0;
+
+   for( pass = 0; pass < 2 && astOK; pass++ ) {
+      if( pass == 1 ) {
+         this->ncell = 0;
+         for( order = 0; order <= AST__MXORDHPX; order++ ) {
+            next[ order ] = this->ncell;
+            this->ncell += count[ order ];
+         }
+         this->cellorder = astMalloc( this->ncell*sizeof( *this->cellorder ) );
+         this->cellnpix = astMalloc( this->ncell*sizeof( *this->cellnpix ) );
+         if( !astOK ) break;
+      }
+
+      for( irange = 0; irange < this->nrange; irange++ ) {
+         lo = this->range[ 2*irange ];
+         hi = this->range[ 2*irange + 1 ];
+         while( lo < hi ) {
+            for( order = 0; order < AST__MXORDHPX; order++ ) {
+               shift = 2*( AST__MXORDHPX - order );
+               if( !( lo & ( ( INT64_C(1) << shift ) - 1 ) ) &&
+                   lo + ( INT64_C(1) << shift ) <= hi ) break;
+            }
+            shift = 2*( AST__MXORDHPX - order );
+            if( pass == 0 ) {
+               count[ order ]++;
+            } else {
+               this->cellorder[ next[ order ] ] = order;
+               this->cellnpix[ next[ order ]++ ] = lo >> shift;
+            }
+            lo += INT64_C(1) << shift;
+         }
+      }
+   }
+
+/* If an error occurred, leave the cache empty. */
+   if( !astOK ) {
+      this->cellorder = astFree( this->cellorder );
+      this->cellnpix = astFree( this->cellnpix );
+      this->ncell = -1;
+   }
+}
+
+static double MeshSpacing( AstPointSet *mesh, double *jump, int *status ){
+/*
+*  Name:
+*     MeshSpacing
+
+*  Purpose:
+*     Find the largest spacing between adjacent points on a boundary mesh.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     double MeshSpacing( AstPointSet *mesh, double *jump, int *status )
+
+*  Class Membership:
+*     Moc member function.
+
+*  Description:
+*     This function finds the arc-distance between each pair of adjacent
+*     good points in a mesh of sky positions on the boundary of a Region.
+*     Adjacent points are normally neighbours on the boundary, but a mesh
+*     may also jump from one part of the boundary to another (for
+*     instance, between the pieces of the boundary of a CmpRegion).
+*     Separations more than JUMPFAC times the median separation are
+*     taken to be such jumps. The largest of the remaining separations
+*     is returned.
+
+*  Parameters:
+*     mesh
+*        Pointer to the mesh. Axis 1 holds longitude and axis 2 holds
+*        latitude, in radians.
+*     jump
+*        Returned holding the smallest separation that is taken to be a
+*        jump. Zero is returned if the mesh has fewer than two good
+*        points.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The largest separation that is not taken to be a jump, as the
+*     length of the chord between the two points on the unit sphere.
+*/
+
+/* Local Variables: */
+   double **ptr;                 /* Pointers to mesh values */
+   double *sep;                  /* Separations between mesh points */
+   double cl;                    /* Cosine of latitude */
+   double dx;                    /* Vector difference on X axis */
+   double dy;                    /* Vector difference on Y axis */
+   double dz;                    /* Vector difference on Z axis */
+   double result;                /* Returned value */
+   double v0[ 3 ];               /* Unit vector at previous mesh point */
+   double v1[ 3 ];               /* Unit vector at current mesh point */
+   int have0;                    /* Is "v0" valid? */
+   int i;                        /* Loop index */
+   int npoint;                   /* Number of mesh points */
+   int nsep;                     /* Number of separations */
+
+/* Initialise */
+   result = 0.0;
+   *jump = 0.0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Find the separation between each pair of adjacent good mesh points. */
+   npoint = astGetNpoint( mesh );
+   ptr = astGetPoints( mesh );
+   sep = astMalloc( npoint*sizeof( *sep ) );
+   if( astOK ) {
+      nsep = 0;
+      have0 = 0;
+      for( i = 0; i < npoint; i++ ) {
+         if( ptr[ 0 ][ i ] != AST__BAD && ptr[ 1 ][ i ] != AST__BAD ) {
+            cl = cos( ptr[ 1 ][ i ] );
+            v1[ 0 ] = cl*cos( ptr[ 0 ][ i ] );
+            v1[ 1 ] = cl*sin( ptr[ 0 ][ i ] );
+            v1[ 2 ] = sin( ptr[ 1 ][ i ] );
+            if( have0 ) {
+               dx = v1[ 0 ] - v0[ 0 ];
+               dy = v1[ 1 ] - v0[ 1 ];
+               dz = v1[ 2 ] - v0[ 2 ];
+               sep[ nsep++ ] = sqrt( dx*dx + dy*dy + dz*dz );
+            }
+            v0[ 0 ] = v1[ 0 ];
+            v0[ 1 ] = v1[ 1 ];
+            v0[ 2 ] = v1[ 2 ];
+            have0 = 1;
+         } else {
+            have0 = 0;
+         }
+      }
+
+/* Sort them, and find the largest that is no more than JUMPFAC times
+   the median. */
+      if( nsep > 0 ) {
+         qsort( sep, nsep, sizeof( *sep ), CmpDouble );
+         *jump = JUMPFAC*sep[ nsep/2 ];
+         for( i = nsep - 1; i >= 0; i-- ) {
+            if( sep[ i ] <= *jump ) {
+               result = sep[ i ];
+               break;
+            }
+         }
+      }
+   }
+   sep = astFree( sep );
+
+/* Return the result. */
+   return result;
+}
+
+static void NewRanges( AstMoc *this, int nrange, int64_t *range,
+                       int *status ){
+/*
+*  Name:
+*     NewRanges
+
+*  Purpose:
+*     Store a new list of ranges in a Moc.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     void NewRanges( AstMoc *this, int nrange, int64_t *range,
+*                     int *status )
+
+*  Class Membership:
+*     Moc member function.
+
+*  Description:
+*     This function replaces the list of ranges in a Moc with a supplied
+*     list, and clears all cached information derived from the old list.
+
+*  Parameters:
+*     this
+*        Pointer to the Moc.
+*     nrange
+*        The number of ranges in the new list.
+*     range
+*        Pointer to the new list, holding "2*nrange" values. The Moc
+*        takes ownership of this memory, which must have been allocated
+*        using astMalloc.
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* If an error has occurred, just free the supplied memory. */
+   if ( !astOK ) {
+      range = astFree( range );
+      return;
+   }
+
+/* Replace the list of ranges. */
+   this->range = astFree( this->range );
+   this->range = range;
+   this->nrange = nrange;
+
+/* Clear the cached cell list and bounding box, and the cached
+   information held by the parent Region. */
+   this->cellorder = astFree( this->cellorder );
+   this->cellnpix = astFree( this->cellnpix );
+   this->ncell = -1;
+   this->boxstale = 1;
+   astResetCache( this );
+}
+
+static int64_t *PathCells( int maxorder, const double p[3], int64_t ip,
+                           const double q[3], int64_t iq, int depth,
+                           int64_t *bnd, int *nbnd, int *status ){
+/*
+*  Name:
+*     PathCells
+
+*  Purpose:
+*     Find the cells on the boundary between two boundary mesh points.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     int64_t *PathCells( int maxorder, const double p[3], int64_t ip,
+*                         const double q[3], int64_t iq, int depth,
+*                         int64_t *bnd, int *nbnd, int *status )
+
+*  Class Membership:
+*     Moc member function.
+
+*  Description:
+*     This function appends to a list the nested indices of any further
+*     cells, at order "maxorder", through which the boundary of a Region
+*     may pass on its way between two adjacent boundary mesh points. The
+*     boundary is assumed to be close to the great circle joining the
+*     two points.
+*
+*     If the cells containing the two points meet only at a corner, the
+*     boundary may cross any of the other cells that share that corner,
+*     so they are all included. This is done directly from the X and Y
+*     cell positions if the cells are in the same base face, and by
+*     finding the shared corner on the sky otherwise. If the cells do not
+*     touch at all, the point midway between the two points is found, and
+*     this function is invoked recursively on each half of the path.
+
+*  Parameters:
+*     maxorder
+*        The HEALPix order of the cells.
+*     p
+*        The unit vector at the first point.
+*     ip
+*        The nested index of the cell containing the first point.
+*     q
+*        The unit vector at the second point.
+*     iq
+*        The nested index of the cell containing the second point.
+*     depth
+*        The depth of recursion. Zero should be supplied.
+*     bnd
+*        The list of cells. It is extended as required.
+*     nbnd
+*        Pointer to the number of cells in the list. Updated on exit.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A pointer to the extended list of cells.
+*/
+
+/* Local Variables: */
+   double cp[ 4 ][ 3 ];          /* Corners of the first cell */
+   double cq[ 3 ];               /* Corner of the second cell */
+   double d;                     /* Distance between corners */
+   double m[ 3 ];                /* Unit vector midway between p and q */
+   double r;                     /* Length of a vector */
+   double tol;                   /* Tolerance for shared corners */
+   double v[ 3 ];                /* Offset from the shared corner */
+   int64_t cell;                 /* Nested index of a cell */
+   int64_t im;                   /* Nested index of cell containing "m" */
+   int64_t ix0;                  /* X position of first cell */
+   int64_t ix1;                  /* X position of second cell */
+   int64_t iy0;                  /* Y position of first cell */
+   int64_t iy1;                  /* Y position of second cell */
+   int64_t mask;                 /* Mask for index within a base cell */
+   int i;                        /* Loop index */
+   int ishared;                  /* Index of the shared corner */
+   int j;                        /* Loop index */
+   int k;                        /* Vector component index */
+   int nshared;                  /* Number of shared corners */
+
+/* Check the global error status, and return if both points are in the
+   same cell. */
+   if ( !astOK || ip == iq ) return bnd;
+
+/* If the two cells are in the same base face, compare their X and Y
+   positions. If they meet only at a corner, include the two cells that
+   share an edge with both. Nothing more is needed if they share an edge. */
+   mask = ( INT64_C(1) << ( 2*maxorder ) ) - 1;
+   if( ( ip & ~mask ) == ( iq & ~mask ) ) {
+      ix0 = Compress( ip & mask );
+      iy0 = Compress( ( ip & mask ) >> 1 );
+      ix1 = Compress( iq & mask );
+      iy1 = Compress( ( iq & mask ) >> 1 );
+      if( ix1 - ix0 <= 1 && ix0 - ix1 <= 1 &&
+          iy1 - iy0 <= 1 && iy0 - iy1 <= 1 ) {
+         if( ix1 != ix0 && iy1 != iy0 ) {
+            bnd = astGrow( bnd, *nbnd + 2, sizeof( *bnd ) );
+            if( astOK ) {
+               bnd[ (*nbnd)++ ] = ( iq & ~mask ) + Spread( ix0 ) +
+                                  ( Spread( iy1 ) << 1 );
+               bnd[ (*nbnd)++ ] = ( iq & ~mask ) + Spread( ix1 ) +
+                                  ( Spread( iy0 ) << 1 );
+            }
+         }
+         return bnd;
+      }
+
+/* Otherwise, count the corners that the cells share on the sky. */
+   } else {
+      tol = 1.0E-3*CELL_SIZE( maxorder );
+      for( i = 0; i < 4; i++ ) CellVec( maxorder, ip, i % 2, i/2, cp[ i ] );
+      nshared = 0;
+      ishared = 0;
+      for( j = 0; j < 4; j++ ) {
+         CellVec( maxorder, iq, j % 2, j/2, cq );
+         for( i = 0; i < 4; i++ ) {
+            d = 0.0;
+            for( k = 0; k < 3; k++ ) {
+               d += ( cp[ i ][ k ] - cq[ k ] )*( cp[ i ][ k ] - cq[ k ] );
+            }
+            if( sqrt( d ) < tol ) {
+               nshared++;
+               ishared = i;
+            }
+         }
+      }
+
+/* If they share an edge, nothing more is needed. If they share only a
+   corner, include every cell that touches the corner. Three or four
+   cells meet at each corner, so find the cells containing eight points
+   spaced evenly around the corner. */
+      if( nshared > 1 ) return bnd;
+      if( nshared == 1 ) {
+         bnd = astGrow( bnd, *nbnd + 8, sizeof( *bnd ) );
+         for( j = 0; j < 8 && astOK; j++ ) {
+            SkyOffset( cp[ ishared ], j*AST__DPI/4.0,
+                       0.01*CELL_SIZE( maxorder ), v );
+            cell = VecCell( maxorder, v );
+            if( cell != ip && cell != iq ) bnd[ (*nbnd)++ ] = cell;
+         }
+         return bnd;
+      }
+   }
+
+/* The cells do not touch. Find the cell containing the point midway
+   between the two points, and then find the cells on each half of the
+   path. */
+   if( depth < MXDEPTH ) {
+      r = 0.0;
+      for( k = 0; k < 3; k++ ) {
+         m[ k ] = p[ k ] + q[ k ];
+         r += m[ k ]*m[ k ];
+      }
+      if( r > 0.0 ) {
+         r = sqrt( r );
+         for( k = 0; k < 3; k++ ) m[ k ] /= r;
+         im = VecCell( maxorder, m );
+         bnd = astGrow( bnd, *nbnd + 1, sizeof( *bnd ) );
+         if( astOK ) bnd[ (*nbnd)++ ] = im;
+         bnd = PathCells( maxorder, p, ip, m, im, depth + 1, bnd, nbnd,
+                          status );
+         bnd = PathCells( maxorder, m, im, q, iq, depth + 1, bnd, nbnd,
+                          status );
+      }
+   }
+
+/* Return the extended list. */
+   return bnd;
+}
+
+static int64_t *Rasterise( AstMoc *this, AstRegion *reg, int *nrange,
+                           int *status ){
+/*
+*  Name:
+*     Rasterise
+
+*  Purpose:
+*     Find the HEALPix cells covered by a Region.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     int64_t *Rasterise( AstMoc *this, AstRegion *reg, int *nrange,
+*                         int *status )
+
+*  Class Membership:
+*     Moc member function.
+
+*  Description:
+*     This function rasterises a Region onto the HEALPix grid at the order
+*     given by the MaxOrder attribute of a Moc.
+*
+*     A mesh of points on the boundary of the Region is first used to
+*     identify the cells at order MaxOrder that contain part of the
+*     boundary. The mesh is made fine enough that no two adjacent mesh
+*     points on the same part of the boundary are more than half a cell
+*     apart, and the cells crossed by the great circle between each such
+*     pair of points are included, whether or not they are in the same
+*     base cell. Adjacent mesh points more than JUMPFAC times the median
+*     spacing apart are assumed to be on separate parts of the boundary.
+*
+*     Starting with the twelve base cells, each cell that contains a
+*     boundary cell is then divided recursively into four children. Cells
+*     that contain no part of the boundary are entirely inside or entirely
+*     outside the Region, and are classified using a single test at their
+*     centre. All such centres are transformed by the Region in one call.
+*     Cells at order MaxOrder that contain part of the boundary are
+*     included in the result.
+*
+*     An error is reported if the boundary mesh would need more than
+*     MXMESH points to identify every boundary cell at order MaxOrder.
+
+*  Parameters:
+*     this
+*        Pointer to the Moc.
+*     reg
+*        Pointer to the Region. Its current Frame must be the base Frame
+*        of the Moc. The MeshSize attribute of the Region may be changed.
+*     nrange
+*        Returned holding the number of ranges in the returned list.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A pointer to a newly allocated array holding "2*nrange" values,
+*     which should be freed using astFree when no longer needed.
+*/
+
+/* Local Variables: */
+   AstPointSet *mesh;            /* Boundary mesh */
+   AstPointSet *pset1;           /* Centres of cells to be tested */
+   AstPointSet *pset2;           /* Centres masked by the Region */
+   MocCell *cells;               /* Cells visited during the descent */
+   double **ptr1;                /* Pointers to centre values */
+   double **ptr2;                /* Pointers to masked centre values */
+   double **ptrm;                /* Pointers to mesh values */
+   double cen[ 3 ];              /* Unit vector at a cell centre */
+   double cl;                    /* Cosine of latitude */
+   double dx;                    /* Vector difference on X axis */
+   double dy;                    /* Vector difference on Y axis */
+   double dz;                    /* Vector difference on Z axis */
+   double jump;                  /* Smallest jump between boundary pieces */
+   double need;                  /* Number of mesh points needed */
+   double space;                 /* Largest spacing between mesh points */
+   double v0[ 3 ];               /* Unit vector at previous mesh point */
+   double v1[ 3 ];               /* Unit vector at current mesh point */
+   double vf[ 3 ];               /* Unit vector at first mesh point */
+   int64_t *bnd;                 /* Boundary cells at MaxOrder */
+   int64_t *result;              /* Returned list */
+   int64_t first;                /* First boundary cell */
+   int64_t hi;                   /* End of a range */
+   int64_t lo;                   /* Start of a range */
+   int64_t next;                 /* Current boundary cell */
+   int64_t prev;                 /* Previous boundary cell */
+   int curve;                    /* Is the boundary a curve? */
+   int face;                     /* Base face index */
+   int i;                        /* Loop index */
+   int j;                        /* Index of first boundary cell in face */
+   int k;                        /* Index of first boundary cell after face */
+   int maxorder;                 /* Finest order to use */
+   int meshsize;                 /* Required number of mesh points */
+   int n;                        /* Number of values */
+   int nbnd;                     /* Number of boundary cells */
+   int ncell;                    /* Number of cells visited */
+   int npoint;                   /* Number of mesh points */
+   int ntest;                    /* Number of cells to test */
+
+/* Initialise */
+   result = NULL;
+   *nrange = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Get the order at which to rasterise the Region. */
+   maxorder = astGetMaxOrder( this );
+
+/* Get a mesh of points on the boundary of the Region. */
+   mesh = astRegMesh( reg );
+   npoint = astGetNpoint( mesh );
+   ptrm = astGetPoints( mesh );
+
+/* Find the largest spacing between adjacent mesh points that are
+   neighbours on the boundary. The boundary of a PointList is just its
+   points, so no finer mesh is needed in that case. */
+   curve = !astIsAPointList( reg );
+   space = curve ? MeshSpacing( mesh, &jump, status ) : 0.0;
+
+/* If the mesh is too coarse to identify every boundary cell at MaxOrder,
+   get a finer mesh. If this would need more than MXMESH points, report an
+   error rather than use a mesh that may miss some boundary cells. */
+   if( space > 0.5*CELL_SIZE( maxorder ) && astOK ) {
+      need = npoint*( space/( 0.5*CELL_SIZE( maxorder ) ) ) + 1.0;
+      if( need > MXMESH ) {
+         astError( AST__BDPAR, "astAddRegion(%s): The supplied %s is too "
+                   "large to be rasterised at HEALPix order %d (MaxOrder).",
+                   status, astGetClass( this ), astGetClass( reg ),
+                   maxorder );
+         astError( AST__BDPAR, "About %.3g boundary points would be needed, "
+                   "but no more than %d can be used. Reduce MaxOrder, or "
+                   "split the Region into smaller pieces.", status, need,
+                   (int) MXMESH );
+         mesh = astAnnul( mesh );
+         return result;
+      }
+      meshsize = (int) need;
+      if( meshsize > astGetMeshSize( reg ) ) {
+         astSetMeshSize( reg, meshsize );
+         (void) astAnnul( mesh );
+         mesh = astRegMesh( reg );
+         npoint = astGetNpoint( mesh );
+         ptrm = astGetPoints( mesh );
+         (void) MeshSpacing( mesh, &jump, status );
+      }
+   }
+
+/* Find the cell at MaxOrder containing each mesh point. Adjacent mesh
+   points that are no further apart than "jump" are taken to be
+   neighbours on the boundary, and the boundary between them is assumed
+   to follow the great circle through them. Include any further cells
+   through which it passes. Without this, a cell in which the boundary
+   cuts off a corner may be missed, either within a base face or where
+   the boundary crosses from one face to another. */
+   nbnd = 0;
+   bnd = astMalloc( npoint*sizeof( *bnd ) );
+   if( astOK ) {
+      first = -1;
+      prev = -1;
+      for( i = 0; i < npoint; i++ ) {
+         if( ptrm[ 0 ][ i ] != AST__BAD && ptrm[ 1 ][ i ] != AST__BAD ) {
+            cl = cos( ptrm[ 1 ][ i ] );
+            v1[ 0 ] = cl*cos( ptrm[ 0 ][ i ] );
+            v1[ 1 ] = cl*sin( ptrm[ 0 ][ i ] );
+            v1[ 2 ] = sin( ptrm[ 1 ][ i ] );
+            next = VecCell( maxorder, v1 );
+            bnd = astGrow( bnd, nbnd + 1, sizeof( *bnd ) );
+            if( !astOK ) break;
+            bnd[ nbnd++ ] = next;
+
+            if( prev >= 0 && curve ) {
+               dx = v1[ 0 ] - v0[ 0 ];
+               dy = v1[ 1 ] - v0[ 1 ];
+               dz = v1[ 2 ] - v0[ 2 ];
+               if( sqrt( dx*dx + dy*dy + dz*dz ) <= jump ) {
+                  bnd = PathCells( maxorder, v0, prev, v1, next, 0, bnd,
+                                   &nbnd, status );
+               }
+            }
+
+            if( first < 0 ) {
+               vf[ 0 ] = v1[ 0 ];
+               vf[ 1 ] = v1[ 1 ];
+               vf[ 2 ] = v1[ 2 ];
+               first = next;
+            }
+            v0[ 0 ] = v1[ 0 ];
+            v0[ 1 ] = v1[ 1 ];
+            v0[ 2 ] = v1[ 2 ];
+            prev = next;
+         } else {
+            prev = -1;
+         }
+      }
+
+/* The boundary is usually closed, so also include the cells between the
+   last and first mesh points, unless they are too far apart. */
+      if( prev >= 0 && first >= 0 && curve && astOK ) {
+         dx = vf[ 0 ] - v0[ 0 ];
+         dy = vf[ 1 ] - v0[ 1 ];
+         dz = vf[ 2 ] - v0[ 2 ];
+         if( sqrt( dx*dx + dy*dy + dz*dz ) <= jump ) {
+            bnd = PathCells( maxorder, v0, prev, vf, first, 0, bnd, &nbnd,
+                             status );
+         }
+      }
+
+      if( nbnd > 0 && astOK ) {
+         qsort( bnd, nbnd, sizeof( *bnd ), CmpIndex );
+         n = 1;
+         for( i = 1; i < nbnd; i++ ) {
+            if( bnd[ i ] != bnd[ n - 1 ] ) bnd[ n++ ] = bnd[ i ];
+         }
+         nbnd = n;
+      }
+   }
+   mesh = astAnnul( mesh );
+
+/* Descend from each of the twelve base cells in turn, passing on the
+   boundary cells that are within the base cell. */
+   cells = NULL;
+   ncell = 0;
+   j = 0;
+   for( face = 0; face < 12 && astOK; face++ ) {
+      hi = ( (int64_t) face + 1 ) << ( 2*maxorder );
+      k = j;
+      while( k < nbnd && bnd[ k ] < hi ) k++;
+      cells = Descend( 0, face, maxorder, bnd + j, k - j, cells, &ncell,
+                       status );
+      j = k;
+   }
+   bnd = astFree( bnd );
+
+/* Count the cells that do not touch the boundary, and store their
+   centres in a PointSet. */
+   ntest = 0;
+   for( i = 0; i < ncell && astOK; i++ ) {
+      if( cells[ i ].flag == 0 ) ntest++;
+   }
+
+   if( ntest > 0 && astOK ) {
+      pset1 = astPointSet( ntest, 2, "", status );
+      ptr1 = astGetPoints( pset1 );
+      if( astOK ) {
+         n = 0;
+         for( i = 0; i < ncell; i++ ) {
+            if( cells[ i ].flag == 0 ) {
+               CellVec( cells[ i ].order, cells[ i ].npix, 0.5, 0.5, cen );
+               ptr1[ 0 ][ n ] = atan2( cen[ 1 ], cen[ 0 ] );
+               ptr1[ 1 ][ n ] = atan2( cen[ 2 ], sqrt( cen[ 0 ]*cen[ 0 ] +
+                                                       cen[ 1 ]*cen[ 1 ] ) );
+               n++;
+            }
+         }
+      }
+
+/* Transform them all using the Region, and flag the cells whose centres
+   are outside the Region. */
+      pset2 = astTransform( reg, pset1, 1, NULL );
+      ptr2 = astGetPoints( pset2 );
+      if( astOK ) {
+         n = 0;
+         for( i = 0; i < ncell; i++ ) {
+            if( cells[ i ].flag == 0 ) {
+               if( ptr2[ 0 ][ n ] != AST__BAD && ptr2[ 1 ][ n ] != AST__BAD ) {
+                  cells[ i ].flag = 1;
+               } else {
+                  cells[ i ].flag = 2;
+               }
+               n++;
+            }
+         }
+      }
+      pset1 = astAnnul( pset1 );
+      pset2 = astAnnul( pset2 );
+   }
+
+/* The cells are in order of increasing nested index, so the included
+   cells can be converted into a sorted list of ranges, merging adjacent
+   cells as we go. */
+   if( astOK ) {
+      result = astMalloc( 2*ncell*sizeof( *result ) );
+      if( astOK ) {
+         n = 0;
+         for( i = 0; i < ncell; i++ ) {
+            if( cells[ i ].flag == 1 ) {
+               lo = cells[ i ].npix << ( 2*( AST__MXORDHPX - cells[ i ].order ) );
+               hi = ( cells[ i ].npix + 1 ) << ( 2*( AST__MXORDHPX - cells[ i ].order ) );
+               if( n > 0 && result[ 2*n - 1 ] == lo ) {
+                  result[ 2*n - 1 ] = hi;
+               } else {
+                  result[ 2*n ] = lo;
+                  result[ 2*n + 1 ] = hi;
+                  n++;
+               }
+            }
+         }
+         *nrange = n;
+      }
+   }
+
+/* Free resources. */
+   cells = astFree( cells );
+
+/* Return the result. */
+   if( !astOK ) {
+      result = astFree( result );
+      *nrange = 0;
+   }
+   return result;
+}
+
+static void RegBaseBox( AstRegion *this_region, double *lbnd, double *ubnd,
+                        int *status ){
+/*
+*  Name:
+*     RegBaseBox
+
+*  Purpose:
+*     Returns the bounding box of an un-negated Region in the base Frame of
+*     the encapsulated FrameSet.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     void RegBaseBox( AstRegion *this, double *lbnd, double *ubnd,
+*                      int *status )
+
+*  Class Membership:
+*     Moc member function (over-rides the astRegBaseBox protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function returns the upper and lower axis bounds of a Region in
+*     the base Frame of the encapsulated FrameSet, assuming the Region
+*     has not been negated. That is, the value of the Negated attribute
+*     is ignored.
+*
+*     For a Moc, the box is found from the boundary mesh, padded by half
+*     the spacing between mesh points. The longitude range excludes the
+*     largest gap between the longitudes of the mesh points, and so
+*     may extend outside the range zero to 2.PI. If the Moc covers
+*     either pole, the full range of longitude is used. An empty Moc
+*     returns an upper bound less than the lower bound on each axis.
+
+*  Parameters:
+*     this
+*        Pointer to the Region.
+*     lbnd
+*        Pointer to an array in which to return the lower axis bounds
+*        covered by the Region in the base Frame of the encapsulated
+*        FrameSet. It should have at least as many elements as there are
+*        axes in the base Frame.
+*     ubnd
+*        Pointer to an array in which to return the upper axis bounds
+*        covered by the Region in the base Frame of the encapsulated
+*        FrameSet. It should have at least as many elements as there are
+*        axes in the base Frame.
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Variables: */
+   AstMoc *this;                 /* Pointer to Moc structure */
+   AstPointSet *mesh;            /* Boundary mesh */
+   double **ptr;                 /* Pointers to mesh values */
+   double *lon;                  /* Sorted mesh longitudes */
+   double gap;                   /* Gap between adjacent longitudes */
+   double maxgap;                /* Largest gap between longitudes */
+   double maxlat;                /* Largest absolute latitude */
+   double pad;                   /* Padding for the box */
+   double spacing;               /* Largest spacing between mesh points */
+   double start;                 /* Longitude at end of largest gap */
+   int i;                        /* Mesh point index */
+   int north;                    /* Does the Moc cover the north pole? */
+   int npoint;                   /* Number of mesh points */
+   int south;                    /* Does the Moc cover the south pole? */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Get a pointer to the Moc structure. */
+   this = (AstMoc *) this_region;
+
+/* If the cached bounding box is stale, re-compute it. */
+   if( this->boxstale ) {
+
+/* An empty Moc contains no points. */
+      if( this->nrange == 0 ) {
+         this->lbnd[ 0 ] = 1.0;
+         this->ubnd[ 0 ] = -1.0;
+         this->lbnd[ 1 ] = 1.0;
+         this->ubnd[ 1 ] = -1.0;
+
+/* Otherwise, get the boundary mesh. */
+      } else {
+         mesh = BoundaryMesh( this, &spacing, status );
+         npoint = astGetNpoint( mesh );
+         ptr = astGetPoints( mesh );
+         pad = 0.5*spacing;
+         if( astOK && ptr[ 0 ][ 0 ] == AST__BAD ) npoint = 0;
+
+/* See if either pole is covered. */
+         north = InRanges( this, Loc2Nest( 1.0, 0.0, 0.0 ) );
+         south = InRanges( this, Loc2Nest( -1.0, 0.0, 0.0 ) );
+
+/* Find the latitude range of the mesh. */
+         this->lbnd[ 1 ] = AST__DPIBY2;
+         this->ubnd[ 1 ] = -AST__DPIBY2;
+         for( i = 0; i < npoint && astOK; i++ ) {
+            if( ptr[ 1 ][ i ] < this->lbnd[ 1 ] ) this->lbnd[ 1 ] = ptr[ 1 ][ i ];
+            if( ptr[ 1 ][ i ] > this->ubnd[ 1 ] ) this->ubnd[ 1 ] = ptr[ 1 ][ i ];
+         }
+         this->lbnd[ 1 ] -= pad;
+         this->ubnd[ 1 ] += pad;
+         if( south || this->lbnd[ 1 ] < -AST__DPIBY2 ) this->lbnd[ 1 ] = -AST__DPIBY2;
+         if( north || this->ubnd[ 1 ] > AST__DPIBY2 ) this->ubnd[ 1 ] = AST__DPIBY2;
+
+/* If a pole is covered, or there is no boundary (i.e. the whole sky is
+   covered), use the full range of longitude. */
+         this->lbnd[ 0 ] = 0.0;
+         this->ubnd[ 0 ] = 2*AST__DPI;
+         if( !north && !south && npoint > 0 && astOK ) {
+
+/* Otherwise, sort the mesh longitudes and find the largest gap between
+   adjacent longitudes, including the gap that wraps round through zero. */
+            lon = astStore( NULL, ptr[ 0 ], npoint*sizeof( *lon ) );
+            if( astOK ) {
+               qsort( lon, npoint, sizeof( *lon ), CmpDouble );
+               maxgap = lon[ 0 ] + 2*AST__DPI - lon[ npoint - 1 ];
+               start = lon[ 0 ];
+               for( i = 1; i < npoint; i++ ) {
+                  gap = lon[ i ] - lon[ i - 1 ];
+                  if( gap > maxgap ) {
+                     maxgap = gap;
+                     start = lon[ i ];
+                  }
+               }
+
+/* Pad the longitude range by an amount corresponding to the padding
+   on the sky at the highest latitude in the Moc. */
+               maxlat = fabs( this->lbnd[ 1 ] );
+               if( fabs( this->ubnd[ 1 ] ) > maxlat ) maxlat = fabs( this->ubnd[ 1 ] );
+               if( cos( maxlat ) > 0.0 ) {
+                  pad /= cos( maxlat );
+               } else {
+                  pad = AST__DPI;
+               }
+
+               if( maxgap > 2*pad ) {
+                  this->lbnd[ 0 ] = start - pad;
+                  this->ubnd[ 0 ] = start + 2*AST__DPI - maxgap + pad;
+               }
+            }
+            lon = astFree( lon );
+         }
+
+         mesh = astAnnul( mesh );
+      }
+
+      if( astOK ) this->boxstale = 0;
+   }
+
+/* Return the cached box. */
+   lbnd[ 0 ] = this->lbnd[ 0 ];
+   ubnd[ 0 ] = this->ubnd[ 0 ];
+   lbnd[ 1 ] = this->lbnd[ 1 ];
+   ubnd[ 1 ] = this->ubnd[ 1 ];
+}
+
+static AstPointSet *RegBaseMesh( AstRegion *this_region, int *status ){
+/*
+*  Name:
+*     RegBaseMesh
+
+*  Purpose:
+*     Return a PointSet containing a mesh of points on the boundary of a
+*     Region in its base Frame.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     AstPointSet *astRegBaseMesh( AstRegion *this, int *status )
+
+*  Class Membership:
+*     Moc member function (over-rides the astRegBaseMesh protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function returns a PointSet containing a mesh of points on the
+*     boundary of the Region. The points refer to the base Frame of
+*     the encapsulated FrameSet. For a Moc, the mesh samples the edges of
+*     the cells that border uncovered cells. The MeshSize attribute is
+*     ignored, since the density of the mesh is determined by the sizes
+*     of the cells.
+
+*  Parameters:
+*     this
+*        Pointer to the Region.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Pointer to the PointSet.
+
+*  Notes:
+*    - A NULL pointer is returned if an error has already occurred, or if
+*    this function should fail for any reason.
+*/
+
+/* Local Variables: */
+   AstPointSet *result;          /* Returned pointer */
+
+/* Initialise */
+   result = NULL;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* If the Region structure contains a pointer to a PointSet holding
+   a previously created mesh, return it. */
+   if( this_region->basemesh ) {
+      result = astClone( this_region->basemesh );
+
+/* Otherwise, create a new mesh and cache it in the Region structure. */
+   } else {
+      result = BoundaryMesh( (AstMoc *) this_region, NULL, status );
+      if( astOK && result ) this_region->basemesh = astClone( result );
+   }
+
+/* Annul the result if an error has occurred. */
+   if( !astOK ) result = astAnnul( result );
+
+/* Return a pointer to the output PointSet. */
+   return result;
+}
+
+static int RegPins( AstRegion *this_region, AstPointSet *pset, AstRegion *unc,
+                    int **mask, int *status ){
+/*
+*  Name:
+*     RegPins
+
+*  Purpose:
+*     Check if a set of points fall on the boundary of a given Moc.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     int RegPins( AstRegion *this, AstPointSet *pset, AstRegion *unc,
+*                  int **mask, int *status ){
+
+*  Class Membership:
+*     Moc member function (over-rides the astRegPins protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function returns a flag indicating if the supplied set of
+*     points all fall on the boundary of the given Moc.
+*
+*     Some tolerance is allowed, as specified by the uncertainty Region
+*     stored in the supplied Moc "this", and the supplied uncertainty
+*     Region "unc" which describes the uncertainty of the supplied points.
+*     A point is on the boundary if the Moc covers some, but not all, of
+*     the point itself and eight positions surrounding it at a distance
+*     equal to the tolerance.
+
+*  Parameters:
+*     this
+*        Pointer to the Moc.
+*     pset
+*        Pointer to the PointSet. The points are assumed to refer to the
+*        base Frame of the FrameSet encapsulated by "this".
+*     unc
+*        Pointer to a Region representing the uncertainties in the points
+*        given by "pset". The Region is assumed to represent the base Frame
+*        of the FrameSet encapsulated by "this". Zero uncertainity is assumed
+*        if NULL is supplied.
+*     mask
+*        Pointer to location at which to return a pointer to a newly
+*        allocated dynamic array of ints. The number of elements in this
+*        array is equal to the value of the Npoint attribute of "pset".
+*        Each element in the returned array is set to 1 if the
+*        corresponding position in "pset" is on the boundary of the Region
+*        and is set to zero otherwise. A NULL value may be supplied
+*        in which case no array is created. If created, the array should
+*        be freed using astFree when no longer needed.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Non-zero if the points all fall on the boundary of the given
+*     Region, to within the tolerance specified. Zero otherwise.
+
+*/
+
+/* Local variables: */
+   AstFrame *frm;               /* Base Frame in supplied Moc */
+   AstMoc *this;                /* Pointer to the Moc structure. */
+   AstRegion *tunc;             /* Uncertainity Region from "this" */
+   double **ptr;                /* Pointer to axis values in "pset" */
+   double cen[ 2 ];             /* Position at which to centre uncertainties */
+   double cl;                   /* Cosine of latitude */
+   double drad;                 /* Border width */
+   double l1;                   /* Length of bounding box diagonal */
+   double l2;                   /* Length of bounding box diagonal */
+   double lbnd[ 2 ];            /* Lower bounds of an uncertainty Region */
+   double p[ 3 ];               /* Unit vector at supplied point */
+   double q[ 3 ];               /* Unit vector at surrounding position */
+   double ubnd[ 2 ];            /* Upper bounds of an uncertainty Region */
+   int dir;                     /* Direction index */
+   int in0;                     /* Is the supplied point covered? */
+   int ip;                      /* Point index */
+   int nc;                      /* No. of axes in Moc base frame */
+   int np;                      /* No. of supplied points */
+   int on;                      /* Is the point on the boundary? */
+   int result;                  /* Returned flag */
+
+/* Initialise */
+   result = 0;
+   if( mask ) *mask = NULL;
+
+/* Check the inherited status. */
+   if( !astOK ) return result;
+
+/* Get a pointer to the Moc structure. */
+   this = (AstMoc *) this_region;
+
+/* Get the number of base Frame axes in the Moc, and check the supplied
+   PointSet has the same number of axis values per point. */
+   frm = astGetFrame( this_region->frameset, AST__BASE );
+   nc = astGetNaxes( frm );
+   if( astGetNcoord( pset ) != nc && astOK ) {
+      astError( AST__INTER, "astRegPins(%s): Illegal number of axis "
+                "values per point (%d) in the supplied PointSet - should be "
+                "%d (internal AST programming error).", status, astGetClass( this ),
+                astGetNcoord( pset ), nc );
+   }
+
+/* Get the number of axes in the uncertainty Region and check it is the
+   same as above. */
+   if( unc && astGetNaxes( unc ) != nc && astOK ) {
+      astError( AST__INTER, "astRegPins(%s): Illegal number of axes (%d) "
+                "in the supplied uncertainty Region - should be "
+                "%d (internal AST programming error).", status, astGetClass( this ),
+                astGetNaxes( unc ), nc );
+   }
+
+/* Find the geodesic length of the diagonal of the bounding box of the
+   uncertainty Region of "this", and of the supplied uncertainty Region.
+   Both are first re-centred on the origin to avoid problems from
+   uncertainties that straddle a discontinuity. */
+   cen[ 0 ] = 0.0;
+   cen[ 1 ] = 0.0;
+   tunc = astGetUncFrm( this, AST__BASE );
+   astRegCentre( tunc, cen, NULL, 0, AST__CURRENT );
+   astGetRegionBounds( tunc, lbnd, ubnd );
+   l1 = astDistance( frm, lbnd, ubnd );
+   tunc = astAnnul( tunc );
+
+   if( unc ) {
+      astRegCentre( unc, cen, NULL, 0, AST__CURRENT );
+      astGetRegionBounds( unc, lbnd, ubnd );
+      l2 = astDistance( frm, lbnd, ubnd );
+   } else {
+      l2 = 0.0;
+   }
+
+/* The required border width is half of the total diagonal of the two
+   bounding boxes. */
+   drad = 0.5*( l1 + l2 );
+
+/* Get a pointer to the supplied axis values, and allocate the mask. */
+   ptr = astGetPoints( pset );
+   np = astGetNpoint( pset );
+   if( mask ) *mask = astMalloc( sizeof(int)*(size_t) np );
+
+/* Check each point in turn. */
+   if( astOK && drad != AST__BAD ) {
+      result = 1;
+      for( ip = 0; ip < np; ip++ ) {
+         on = 0;
+         if( ptr[ 0 ][ ip ] != AST__BAD && ptr[ 1 ][ ip ] != AST__BAD ) {
+
+/* See if the point itself is covered. */
+            cl = cos( ptr[ 1 ][ ip ] );
+            p[ 0 ] = cl*cos( ptr[ 0 ][ ip ] );
+            p[ 1 ] = cl*sin( ptr[ 0 ][ ip ] );
+            p[ 2 ] = sin( ptr[ 1 ][ ip ] );
+            in0 = InRanges( this, Loc2Nest( p[ 2 ], cl, ptr[ 0 ][ ip ] ) );
+
+/* The point is on the boundary if any of the surrounding positions
+   differs. */
+            for( dir = 0; dir < 8 && !on; dir++ ) {
+               SkyOffset( p, dir*AST__DPI/4.0, drad, q );
+               if( InRanges( this, Loc2Nest( q[ 2 ], sqrt( q[ 0 ]*q[ 0 ] + q[ 1 ]*q[ 1 ] ),
+                                             atan2( q[ 1 ], q[ 0 ] ) ) ) != in0 ) on = 1;
+            }
+         }
+
+         if( mask ) (*mask)[ ip ] = on;
+         if( !on ) result = 0;
+      }
+   }
+
+/* Free resources. */
+   frm = astAnnul( frm );
+
+/* If an error has occurred, return zero. */
+   if( !astOK ) {
+      result = 0;
+      if( mask ) *mask = astFree( *mask );
+   }
+
+/* Return the result. */
+   return result;
+}
+
+static void SetAttrib( AstObject *this_object, const char *setting,
+                       int *status ) {
+/*
+*  Name:
+*     SetAttrib
+
+*  Purpose:
+*     Set an attribute value for a Moc.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     void SetAttrib( AstObject *this, const char *setting, int *status )
+
+*  Class Membership:
+*     Moc member function (over-rides the astSetAttrib protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function assigns an attribute value for a Moc, the
+*     attribute and its value being specified by means of a string of
+*     the form:
+*
+*        "attribute= value "
+*
+*     Here, "attribute" specifies the attribute name and should be in lower
+*     case with no white space present. The value to the right of the "="
+*     should be a suitable textual representation of the value to be assigned
+*     and this will be interpreted according to the attribute's data type.
+*     White space surrounding the value is only significant for string
+*     attributes.
+
+*  Parameters:
+*     this
+*        Pointer to the Moc.
+*     setting
+*        Pointer to a null-terminated string specifying the new attribute
+*        value.
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Vaiables: */
+   AstMoc *this;                 /* Pointer to the Moc structure */
+   int ival;                     /* Integer attribute value */
+   int len;                      /* Length of setting string */
+   int nc;                       /* Number of characters read by astSscanf */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Obtain a pointer to the Moc structure. */
+   this = (AstMoc *) this_object;
+
+/* Obtain the length of the setting string. */
+   len = (int) strlen( setting );
+
+/* Test for each recognised attribute in turn, using "astSscanf" to parse the
+   setting string and extract the attribute value (or an offset to it in the
+   case of string values). In each case, use the value set in "nc" to check
+   that the entire string was matched. Once a value has been obtained, use the
+   appropriate method to set it. */
+
+/* MaxOrder. */
+/* --------- */
+   if ( nc = 0,
+        ( 1 == astSscanf( setting, "maxorder= %d %n", &ival, &nc ) )
+        && ( nc >= len ) ) {
+      astSetMaxOrder( this, ival );
+
+/* Define a macro to see if the setting string matches any of the
+   read-only attributes of this class. */
+#define MATCH(attrib) \
+        ( nc = 0, ( 0 == astSscanf( setting, attrib "=%*[^\n]%n", &nc ) ) && \
+                  ( nc >= len ) )
+
+/* Use this macro to report an error if a read-only attribute has been
+   specified. */
+   } else if ( MATCH( "mocarea" ) || MATCH( "moclength" ) ) {
+      astError( AST__NOWRT, "astSet: The setting \"%s\" is invalid for a %s.",
+                status, setting, astGetClass( this ) );
+      astError( AST__NOWRT, "This is a read-only attribute." , status );
+
+/* Pass any unrecognised setting to the parent method for further
+   interpretation. */
+   } else {
+      (*parent_setattrib)( this_object, setting, status );
+   }
+
+/* Undefine macros local to this function. */
+#undef MATCH
+}
+
+static void SkyOffset( const double p[3], double angle, double dist,
+                       double q[3] ){
+/*
+*  Name:
+*     SkyOffset
+
+*  Purpose:
+*     Offset away from a position on the sky.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     void SkyOffset( const double p[3], double angle, double dist,
+*                     double q[3] )
+
+*  Class Membership:
+*     Moc member function.
+
+*  Description:
+*     This function returns the unit vector at a position that is a given
+*     arc-distance from a supplied position, in a given direction.
+
+*  Parameters:
+*     p
+*        The unit vector at the supplied position.
+*     angle
+*        The position angle of the offset, in radians, measured from
+*        north through east.
+*     dist
+*        The arc-distance of the offset, in radians.
+*     q
+*        Returned holding the unit vector at the offset position.
+*/
+
+/* Local Variables: */
+   double ca;                    /* Cosine of position angle */
+   double cd;                    /* Cosine of distance */
+   double e[ 3 ];                /* Unit vector towards east */
+   double n[ 3 ];                /* Unit vector towards north */
+   double r;                     /* Distance from polar axis */
+   double sa;                    /* Sine of position angle */
+   double sd;                    /* Sine of distance */
+   int i;                        /* Vector component index */
+
+/* Form unit vectors towards north and east at the supplied position. At
+   the poles, use the directions defined by zero longitude. */
+   r = sqrt( p[ 0 ]*p[ 0 ] + p[ 1 ]*p[ 1 ] );
+   if( r > 0.0 ) {
+      e[ 0 ] = -p[ 1 ]/r;
+      e[ 1 ] = p[ 0 ]/r;
+   } else {
+      e[ 0 ] = 0.0;
+      e[ 1 ] = 1.0;
+   }
+   e[ 2 ] = 0.0;
+
+   n[ 0 ] = p[ 1 ]*e[ 2 ] - p[ 2 ]*e[ 1 ];
+   n[ 1 ] = p[ 2 ]*e[ 0 ] - p[ 0 ]*e[ 2 ];
+   n[ 2 ] = p[ 0 ]*e[ 1 ] - p[ 1 ]*e[ 0 ];
+
+/* Move along the great circle in the required direction. */
+   ca = cos( angle );
+   sa = sin( angle );
+   cd = cos( dist );
+   sd = sin( dist );
+   for( i = 0; i < 3; i++ ) {
+      q[ i ] = cd*p[ i ] + sd*( ca*n[ i ] + sa*e[ i ] );
+   }
+}
+
+static int64_t Spread( int64_t v ){
+/*
+*  Name:
+*     Spread
+
+*  Purpose:
+*     Spread the bits of an integer into the even-numbered bits.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     int64_t Spread( int64_t v )
+
+*  Class Membership:
+*     Moc member function.
+
+*  Description:
+*     This function moves bit "i" of the supplied integer to bit "2*i"
+*     of the returned integer, for "i" in the range 0 to 31, and sets all
+*     odd-numbered bits to zero. It is used to interleave the X and Y
+*     positions within a base face to form a nested HEALPix index.
+
+*  Parameters:
+*     v
+*        The supplied integer.
+
+*  Returned Value:
+*     The spread value.
+*/
+
+   v &= INT64_C(0x00000000ffffffff);
+   v = ( v | ( v << 16 ) ) & INT64_C(0x0000ffff0000ffff);
+   v = ( v | ( v << 8 ) ) & INT64_C(0x00ff00ff00ff00ff);
+   v = ( v | ( v << 4 ) ) & INT64_C(0x0f0f0f0f0f0f0f0f);
+   v = ( v | ( v << 2 ) ) & INT64_C(0x3333333333333333);
+   v = ( v | ( v << 1 ) ) & INT64_C(0x5555555555555555);
+   return v;
+}
+
+static int64_t VecCell( int order, const double v[3] ){
+/*
+*  Name:
+*     VecCell
+
+*  Purpose:
+*     Find the HEALPix cell containing a given unit vector.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     int64_t VecCell( int order, const double v[3] )
+
+*  Class Membership:
+*     Moc member function.
+
+*  Description:
+*     This function returns the nested index of the cell at a given order
+*     that contains the position given by a unit vector.
+
+*  Parameters:
+*     order
+*        The HEALPix order.
+*     v
+*        The unit vector.
+
+*  Returned Value:
+*     The nested index.
+*/
+
+   return Loc2Nest( v[ 2 ], sqrt( v[ 0 ]*v[ 0 ] + v[ 1 ]*v[ 1 ] ),
+                    atan2( v[ 1 ], v[ 0 ] ) ) >> 2*( AST__MXORDHPX - order );
+}
+
+static int TestAttrib( AstObject *this_object, const char *attrib, int *status ) {
+/*
+*  Name:
+*     TestAttrib
+
+*  Purpose:
+*     Test if a specified attribute value is set for a Moc.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     int TestAttrib( AstObject *this, const char *attrib, int *status )
+
+*  Class Membership:
+*     Moc member function (over-rides the astTestAttrib protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function returns a boolean result (0 or 1) to indicate whether
+*     a value has been set for one of a Moc's attributes.
+
+*  Parameters:
+*     this
+*        Pointer to the Moc.
+*     attrib
+*        Pointer to a null-terminated string specifying the attribute
+*        name.  This should be in lower case with no surrounding white
+*        space.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     One if a value has been set, otherwise zero.
+
+*  Notes:
+*     - A value of zero will be returned if this function is invoked
+*     with the global status set, or if it should fail for any reason.
+*/
+
+/* Local Variables: */
+   AstMoc *this;                 /* Pointer to the Moc structure */
+   int result;                   /* Result value to return */
+
+/* Initialise. */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Obtain a pointer to the Moc structure. */
+   this = (AstMoc *) this_object;
+
+/* Check the attribute name and test the appropriate attribute. */
+
+/* MaxOrder. */
+/* --------- */
+   if ( !strcmp( attrib, "maxorder" ) ) {
+      result = astTestMaxOrder( this );
+
+/* Test if the name matches any of the read-only attributes of this
+   class. If it does, then return zero. */
+   } else if ( !strcmp( attrib, "mocarea" ) ||
+               !strcmp( attrib, "moclength" ) ) {
+      result = 0;
+
+/* If the attribute is not recognised, pass it on to the parent method
+   for further interpretation. */
+   } else {
+      result = (*parent_testattrib)( this_object, attrib, status );
+   }
+
+/* Return the result, */
+   return result;
+}
+
+static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
+                               int forward, AstPointSet *out, int *status ) {
+/*
+*  Name:
+*     Transform
+
+*  Purpose:
+*     Apply a Moc to transform a set of points.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     AstPointSet *Transform( AstMapping *this, AstPointSet *in,
+*                             int forward, AstPointSet *out, int *status )
+
+*  Class Membership:
+*     Moc member function (over-rides the astTransform protected
+*     method inherited from the Mapping class).
+
+*  Description:
+*     This function takes a Moc and a set of points encapsulated in a
+*     PointSet and transforms the points by setting axis values to
+*     AST__BAD for all points which are outside the region. Points inside
+*     the region are copied unchanged from input to output.
+*
+*     Each point is tested by finding the index of the HEALPix cell at
+*     order AST__MXORDHPX that contains it, and searching the sorted
+*     list of ranges for that index. The Closed attribute is ignored,
+*     since the boundary of a Moc has no area.
+
+*  Parameters:
+*     this
+*        Pointer to the Moc.
+*     in
+*        Pointer to the PointSet holding the input coordinate data.
+*     forward
+*        A non-zero value indicates that the forward coordinate transformation
+*        should be applied, while a zero value requests the inverse
+*        transformation.
+*     out
+*        Pointer to a PointSet which will hold the transformed (output)
+*        coordinate values. A NULL value may also be given, in which case a
+*        new PointSet will be created by this function.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Pointer to the output (possibly new) PointSet.
+
+*  Notes:
+*     -  The forward and inverse transformations are identical for a
+*     Region.
+*     -  A null pointer will be returned if this function is invoked with the
+*     global error status set, or if it should fail for any reason.
+*     -  The number of coordinate values per point in the input PointSet must
+*     match the number of axes in the Frame represented by the Moc.
+*     -  If an output PointSet is supplied, it must have space for sufficient
+*     number of points and coordinate values per point to accommodate the
+*     result. Any excess space will be ignored.
+*/
+
+/* Local Variables: */
+   AstMoc *this;                 /* Pointer to Moc */
+   AstPointSet *pset_tmp;        /* Pointer to PointSet holding base Frame positions*/
+   AstPointSet *result;          /* Pointer to output PointSet */
+   double **ptr_out;             /* Pointer to output coordinate data */
+   double **ptr_tmp;             /* Pointer to base Frame coordinate data */
+   double lat;                   /* Base Frame latitude */
+   double lon;                   /* Base Frame longitude */
+   int coord;                    /* Zero-based index for coordinates */
+   int inside;                   /* Is the point inside the Region? */
+   int ncoord_out;               /* No. of coordinates per output point */
+   int neg;                      /* Has the Region been negated? */
+   int npoint;                   /* No. of points */
+   int point;                    /* Loop counter for points */
+
+/* Check the global error status. */
+   if ( !astOK ) return NULL;
+
+/* Obtain a pointer to the Moc structure. */
+   this = (AstMoc *) this_mapping;
+
+/* Apply the parent mapping using the stored pointer to the Transform member
+   function inherited from the parent Region class. This function validates
+   all arguments and generates an output PointSet if necessary,
+   containing a copy of the input PointSet. */
+   result = (*parent_transform)( this_mapping, in, forward, out, status );
+
+/* We will now extend the parent astTransform method by performing the
+   calculations needed to generate the output coordinate values. */
+
+/* First use the encapsulated FrameSet to transform the supplied positions
+   from the current Frame in the encapsulated FrameSet (the Frame
+   represented by the Region), to the base Frame (the ICRS SkyFrame in
+   which the cells are defined). Note, the returned pointer may be a
+   clone of the "in" pointer, and so we must be carefull not to modify the
+   contents of the returned PointSet. */
+   pset_tmp = astRegTransform( this, in, 0, NULL, NULL );
+
+/* Determine the numbers of points and coordinates per point from the base
+   Frame PointSet and obtain pointers for accessing the base Frame and output
+   coordinate values. */
+   npoint = astGetNpoint( pset_tmp );
+   ptr_tmp = astGetPoints( pset_tmp );
+   ncoord_out = astGetNcoord( result );
+   ptr_out = astGetPoints( result );
+
+/* See if the Region has been negated. */
+   neg = astGetNegated( this );
+
+/* Loop round each point, finding the cell that contains it and searching
+   for the cell in the list of ranges. */
+   if ( astOK ) {
+      for ( point = 0; point < npoint; point++ ) {
+         lon = ptr_tmp[ 0 ][ point ];
+         lat = ptr_tmp[ 1 ][ point ];
+         if( lon != AST__BAD && lat != AST__BAD ) {
+            inside = InRanges( this, Loc2Nest( sin( lat ), cos( lat ), lon ) );
+            if( neg ) inside = !inside;
+         } else {
+            inside = 0;
+         }
+
+/* If the point is outside, store bad output values. */
+         if( !inside ) {
+            for ( coord = 0; coord < ncoord_out; coord++ ) {
+               ptr_out[ coord ][ point ] = AST__BAD;
+            }
+         }
+      }
+   }
+
+/* Free resources */
+   pset_tmp = astAnnul( pset_tmp );
+
+/* Annul the result if an error has occurred. */
+   if( !astOK ) result = astAnnul( result );
+
+/* Return a pointer to the output PointSet. */
+   return result;
+}
+
+/* Functions which access class attributes. */
+/* ---------------------------------------- */
+/* Implement member functions to access the attributes associated with
+   this class using the macros defined for this purpose in the
+   "object.h" file. For a description of each attribute, see the class
+   interface (in the associated .h file). */
+
+/*
+*att++
+*  Name:
+*     MaxOrder
+
+*  Purpose:
+*     The HEALPix order used when rasterising Regions.
+
+*  Type:
+*     Public attribute.
+
+*  Synopsis:
+*     Integer.
+
+*  Description:
+*     This attribute gives the order of the smallest HEALPix cells used
+*     when a Region of any class other than Moc is added into a Moc using
+c     astAddRegion.
+f     AST_ADDREGION.
+*     Cells at order "n" are approximately 3520/2**n arc-minutes across.
+*     The value must be in the range zero to AST__MXORDHPX (29), and the
+*     default is 12 (cells about 52 arc-seconds across). Changing the
+*     value does not change any cells already stored in the Moc.
+
+*  Applicability:
+*     Moc
+*        All Mocs have this attribute.
+
+*att--
+*/
+astMAKE_CLEAR(Moc,MaxOrder,maxorder,-INT_MAX)
+astMAKE_GET(Moc,MaxOrder,int,DEF_MAXORDER,( ( this->maxorder != -INT_MAX ) ?
+                                   this->maxorder : DEF_MAXORDER ))
+astMAKE_SET(Moc,MaxOrder,int,maxorder,( value < 0 ? 0 :
+                                        ( value > AST__MXORDHPX ?
+                                          AST__MXORDHPX : value ) ))
+astMAKE_TEST(Moc,MaxOrder,( this->maxorder != -INT_MAX ))
+
+/*
+*att++
+*  Name:
+*     MocArea
+
+*  Purpose:
+*     The area covered by a Moc.
+
+*  Type:
+*     Public attribute.
+
+*  Synopsis:
+*     Floating point, read-only.
+
+*  Description:
+*     This is a read-only attribute giving the total area of the cells
+*     in a Moc, in square arc-minutes. The Negated attribute is ignored.
+
+*  Applicability:
+*     Moc
+*        All Mocs have this attribute.
+
+*att--
+*/
+
+/*
+*att++
+*  Name:
+*     MocLength
+
+*  Purpose:
+*     The number of cells in a Moc.
+
+*  Type:
+*     Public attribute.
+
+*  Synopsis:
+*     Integer, read-only.
+
+*  Description:
+*     This is a read-only attribute giving the number of cells in the
+*     shortest description of a Moc as a list of non-overlapping HEALPix
+*     cells, each of which is as large as possible. Individual cells
+*     can be obtained using
+c     astGetCell.
+f     AST_GETCELL.
+*     The Negated attribute is ignored.
+
+*  Applicability:
+*     Moc
+*        All Mocs have this attribute.
+
+*att--
+*/
+
+/* Copy constructor. */
+/* ----------------- */
+static void Copy( const AstObject *objin, AstObject *objout, int *status ) {
+/*
+*  Name:
+*     Copy
+
+*  Purpose:
+*     Copy constructor for Moc objects.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     void Copy( const AstObject *objin, AstObject *objout, int *status )
+
+*  Description:
+*     This function implements the copy constructor for Moc objects.
+
+*  Parameters:
+*     objin
+*        Pointer to the object to be copied.
+*     objout
+*        Pointer to the object being constructed.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Notes:
+*     -  This constructor makes a deep copy.
+*/
+
+/* Local Variables: */
+   AstMoc *in;                /* Pointer to input Moc */
+   AstMoc *out;               /* Pointer to output Moc */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Obtain pointers to the input and output Mocs. */
+   in = (AstMoc *) objin;
+   out = (AstMoc *) objout;
+
+/* For safety, first clear any references to the input memory from
+   the output Moc. */
+   out->range = NULL;
+   out->cellorder = NULL;
+   out->cellnpix = NULL;
+
+/* Copy the list of ranges. The cached cell list is re-created when
+   needed. */
+   if( in->range ) out->range = astStore( NULL, in->range,
+                                          astSizeOf( in->range ) );
+   out->ncell = -1;
+}
+
+/* Destructor. */
+/* ----------- */
+static void Delete( AstObject *obj, int *status ) {
+/*
+*  Name:
+*     Delete
+
+*  Purpose:
+*     Destructor for Moc objects.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     void Delete( AstObject *obj, int *status )
+
+*  Description:
+*     This function implements the destructor for Moc objects.
+
+*  Parameters:
+*     obj
+*        Pointer to the object to be deleted.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Notes:
+*     This function attempts to execute even if the global error status is
+*     set.
+*/
+
+/* Local Variables: */
+   AstMoc *this;                 /* Pointer to Moc */
+
+/* Obtain a pointer to the Moc structure. */
+   this = (AstMoc *) obj;
+
+/* Annul all resources. */
+   this->range = astFree( this->range );
+   this->cellorder = astFree( this->cellorder );
+   this->cellnpix = astFree( this->cellnpix );
+}
+
+/* Dump function. */
+/* -------------- */
+static void Dump( AstObject *this_object, AstChannel *channel, int *status ) {
+/*
+*  Name:
+*     Dump
+
+*  Purpose:
+*     Dump function for Moc objects.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     void Dump( AstObject *this, AstChannel *channel, int *status )
+
+*  Description:
+*     This function implements the Dump function which writes out data
+*     for the Moc class to an output Channel.
+
+*  Parameters:
+*     this
+*        Pointer to the Moc whose data are being written.
+*     channel
+*        Pointer to the Channel to which the data are being written.
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Variables: */
+   AstMoc *this;                 /* Pointer to the Moc structure */
+   char buff[ 30 ];              /* Buffer for formatted index */
+   char key[ 20 ];               /* Buffer for keyword string */
+   int i;                        /* Range index */
+   int ival;                     /* Integer value */
+   int set;                      /* Attribute value set? */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Obtain a pointer to the Moc structure. */
+   this = (AstMoc *) this_object;
+
+/* Write out values representing the instance variables for the
+   Moc class.  Accompany these with appropriate comment strings,
+   possibly depending on the values being written.*/
+
+/* In the case of attributes, we first use the appropriate (private)
+   Test...  member function to see if they are set. If so, we then use
+   the (private) Get... function to obtain the value to be written
+   out.
+
+   For attributes which are not set, we use the astGet... method to
+   obtain the value instead. This will supply a default value
+   (possibly provided by a derived class which over-rides this method)
+   which is more useful to a human reader as it corresponds to the
+   actual default attribute value.  Since "set" will be zero, these
+   values are for information only and will not be read back. */
+
+/* MaxOrder. */
+/* --------- */
+   set = TestMaxOrder( this, status );
+   ival = set ? GetMaxOrder( this, status ) : astGetMaxOrder( this );
+   astWriteInt( channel, "MxOrd", set, 0, ival,
+                "HEALPix order for rasterising Regions" );
+
+/* Ranges. The indices may be too large to be represented exactly as
+   double precision values, so they are written as strings. */
+   astWriteInt( channel, "Nrange", 1, 1, this->nrange,
+                "Number of ranges of covered cells" );
+   for( i = 0; i < this->nrange; i++ ) {
+      (void) sprintf( key, "Lo%d", i + 1 );
+      (void) sprintf( buff, "%lld", (long long) this->range[ 2*i ] );
+      astWriteString( channel, key, 1, 1, buff, i ? "" :
+                      "First cell index in range (order 29)" );
+      (void) sprintf( key, "Hi%d", i + 1 );
+      (void) sprintf( buff, "%lld", (long long) this->range[ 2*i + 1 ] );
+      astWriteString( channel, key, 1, 1, buff, i ? "" :
+                      "Last cell index plus one in range" );
+   }
+}
+
+/* Standard class functions. */
+/* ========================= */
+/* Implement the astIsAMoc and astCheckMoc functions using the macros
+   defined for this purpose in the "object.h" header file. */
+astMAKE_ISA(Moc,Region)
+astMAKE_CHECK(Moc)
+
+AstMoc *astMoc_( const char *options, int *status, ...) {
+/*
+*++
+*  Name:
+c     astMoc
+f     AST_MOC
+
+*  Purpose:
+*     Create a Moc.
+
+*  Type:
+*     Public function.
+
+*  Synopsis:
+c     #include "moc.h"
+c     AstMoc *astMoc( const char *options, ... )
+f     RESULT = AST_MOC( OPTIONS, STATUS )
+
+*  Class Membership:
+*     Moc constructor.
+
+*  Description:
+*     This function creates a new empty Moc and optionally initialises its
+*     attributes.
+*
+*     A Moc is a Region representing an area of the sky as a collection
+*     of HEALPix cells of differing sizes, described within an ICRS
+*     SkyFrame. Cells and Regions are added into the Moc using
+c     astAddCell and astAddRegion.
+f     AST_ADDCELL and AST_ADDREGION.
+
+*  Parameters:
+c     options
+f     OPTIONS = CHARACTER * ( * ) (Given)
+c        Pointer to a null-terminated string containing an optional
+c        comma-separated list of attribute assignments to be used for
+c        initialising the new Moc. The syntax used is identical to
+c        that for the astSet function and may include "printf" format
+c        specifiers identified by "%" symbols in the normal way.
+f        A character string containing an optional comma-separated
+f        list of attribute assignments to be used for initialising the
+f        new Moc. The syntax used is identical to that for the
+f        AST_SET routine.
+c     ...
+c        If the "options" string contains "%" format specifiers, then
+c        an optional list of additional arguments may follow it in
+c        order to supply values to be substituted for these
+c        specifiers. The rules for supplying these are identical to
+c        those for the astSet function (and for the C "printf"
+c        function).
+f     STATUS = INTEGER (Given and Returned)
+f        The global status.
+
+*  Returned Value:
+c     astMoc()
+f     AST_MOC = INTEGER
+*        A pointer to the new Moc.
+
+*  Notes:
+*     - A null Object pointer (AST__NULL) will be returned if this
+c     function is invoked with the AST error status set, or if it
+f     function is invoked with STATUS set to an error value, or if it
+*     should fail for any reason.
+*--
+*/
+
+/* Local Variables: */
+   astDECLARE_GLOBALS            /* Pointer to thread-specific global data */
+   AstMoc *new;                  /* Pointer to new Moc */
+   va_list args;                 /* Variable argument list */
+
+/* Get a pointer to the thread specific global data structure. */
+   astGET_GLOBALS(NULL);
+
+/* Check the global status. */
+   if ( !astOK ) return NULL;
+
+/* Initialise the Moc, allocating memory and initialising the
+   virtual function table as well if necessary. */
+   new = astInitMoc( NULL, sizeof( AstMoc ), !class_init, &class_vtab,
+                     "Moc" );
+
+/* If successful, note that the virtual function table has been
+   initialised. */
+   if ( astOK ) {
+      class_init = 1;
+
+/* Obtain the variable argument list and pass it along with the options string
+   to the astVSet method to initialise the new Moc's attributes. */
+      va_start( args, status );
+      astVSet( new, options, NULL, args );
+      va_end( args );
+
+/* If an error occurred, clean up by deleting the new object. */
+      if ( !astOK ) new = astDelete( new );
+   }
+
+/* Return a pointer to the new Moc. */
+   return new;
+}
+
+AstMoc *astMocId_( const char *options, ... ) {
+/*
+*  Name:
+*     astMocId_
+
+*  Purpose:
+*     Create a Moc.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     AstMoc *astMocId_( const char *options, ... )
+
+*  Class Membership:
+*     Moc constructor.
+
+*  Description:
+*     This function implements the external (public) interface to the
+*     astMoc constructor function. It returns an ID value (instead
+*     of a true C pointer) to external users, and must be provided
+*     because astMoc_ has a variable argument list which cannot be
+*     encapsulated in a macro (where this conversion would otherwise
+*     occur).
+*
+*     The variable argument list also prevents this function from
+*     invoking astMoc_ directly, so it must be a re-implementation
+*     of it in all respects, except for the final conversion of the
+*     result to an ID value.
+
+*  Parameters:
+*     As for astMoc_.
+
+*  Returned Value:
+*     The ID value associated with the new Moc.
+*/
+
+/* Local Variables: */
+   astDECLARE_GLOBALS            /* Pointer to thread-specific global data */
+   AstMoc *new;                  /* Pointer to new Moc */
+   va_list args;                 /* Variable argument list */
+   int *status;                  /* Pointer to inherited status value */
+
+/* Get a pointer to the thread specific global data structure. */
+   astGET_GLOBALS(NULL);
+
+/* Get a pointer to the inherited status value. */
+   status = astGetStatusPtr;
+
+/* Check the global status. */
+   if ( !astOK ) return NULL;
+
+/* Initialise the Moc, allocating memory and initialising the
+   virtual function table as well if necessary. */
+   new = astInitMoc( NULL, sizeof( AstMoc ), !class_init, &class_vtab,
+                     "Moc" );
+
+/* If successful, note that the virtual function table has been
+   initialised. */
+   if ( astOK ) {
+      class_init = 1;
+
+/* Obtain the variable argument list and pass it along with the options string
+   to the astVSet method to initialise the new Moc's attributes. */
+      va_start( args, options );
+      astVSet( new, options, NULL, args );
+      va_end( args );
+
+/* If an error occurred, clean up by deleting the new object. */
+      if ( !astOK ) new = astDelete( new );
+   }
+
+/* Return an ID value for the new Moc. */
+   return astMakeId( new );
+}
+
+AstMoc *astInitMoc_( void *mem, size_t size, int init, AstMocVtab *vtab,
+                     const char *name, int *status ) {
+/*
+*+
+*  Name:
+*     astInitMoc
+
+*  Purpose:
+*     Initialise a Moc.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     AstMoc *astInitMoc_( void *mem, size_t size, int init, AstMocVtab *vtab,
+*                          const char *name )
+
+*  Class Membership:
+*     Moc initialiser.
+
+*  Description:
+*     This function is provided for use by class implementations to initialise
+*     a new Moc object. It allocates memory (if necessary) to accommodate
+*     the Moc plus any additional data associated with the derived class.
+*     It then initialises a Moc structure at the start of this memory. If
+*     the "init" flag is set, it also initialises the contents of a virtual
+*     function table for a Moc at the start of the memory passed via the
+*     "vtab" parameter. The new Moc is empty, and is defined within an
+*     ICRS SkyFrame.
+
+*  Parameters:
+*     mem
+*        A pointer to the memory in which the Moc is to be initialised.
+*        This must be of sufficient size to accommodate the Moc data
+*        (sizeof(Moc)) plus any data used by the derived class. If a value
+*        of NULL is given, this function will allocate the memory itself using
+*        the "size" parameter to determine its size.
+*     size
+*        The amount of memory used by the Moc (plus derived class data).
+*        This will be used to allocate memory if a value of NULL is given for
+*        the "mem" parameter. This value is also stored in the Moc
+*        structure, so a valid value must be supplied even if not required for
+*        allocating memory.
+*     init
+*        A logical flag indicating if the Moc's virtual function table is
+*        to be initialised. If this value is non-zero, the virtual function
+*        table will be initialised by this function.
+*     vtab
+*        Pointer to the start of the virtual function table to be associated
+*        with the new Moc.
+*     name
+*        Pointer to a constant null-terminated character string which contains
+*        the name of the class to which the new object belongs (it is this
+*        pointer value that will subsequently be returned by the astGetClass
+*        method).
+
+*  Returned Value:
+*     A pointer to the new Moc.
+
+*  Notes:
+*     -  A null pointer will be returned if this function is invoked with the
+*     global error status set, or if it should fail for any reason.
+*-
+*/
+
+/* Local Variables: */
+   AstMoc *new;                  /* Pointer to new Moc */
+   AstSkyFrame *frame;           /* Frame in which the cells are defined */
+
+/* Check the global status. */
+   if ( !astOK ) return NULL;
+
+/* If necessary, initialise the virtual function table. */
+   if ( init ) astInitMocVtab( vtab, name );
+
+/* Create the ICRS SkyFrame in which the cells are defined. */
+   frame = astSkyFrame( "System=ICRS", status );
+
+/* Initialise a Region structure (the parent class) as the first component
+   within the Moc structure, allocating memory if necessary. */
+   new = (AstMoc *) astInitRegion( mem, size, 0, (AstRegionVtab *) vtab,
+                                   name, frame, NULL, NULL );
+   frame = astAnnul( frame );
+
+/* Initialise the Moc data. */
+   if ( astOK ) {
+      new->maxorder = -INT_MAX;
+      new->nrange = 0;
+      new->range = NULL;
+      new->ncell = -1;
+      new->cellorder = NULL;
+      new->cellnpix = NULL;
+      new->boxstale = 1;
+
+/* If an error occurred, clean up by deleting the new Moc. */
+      if ( !astOK ) new = astDelete( new );
+   }
+
+/* Return a pointer to the new Moc. */
+   return new;
+}
+
+AstMoc *astLoadMoc_( void *mem, size_t size, AstMocVtab *vtab,
+                     const char *name, AstChannel *channel, int *status ) {
+/*
+*+
+*  Name:
+*     astLoadMoc
+
+*  Purpose:
+*     Load a Moc.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     AstMoc *astLoadMoc( void *mem, size_t size, AstMocVtab *vtab,
+*                         const char *name, AstChannel *channel )
+
+*  Class Membership:
+*     Moc loader.
+
+*  Description:
+*     This function is provided to load a new Moc using data read
+*     from a Channel. It first loads the data used by the parent class
+*     (which allocates memory if necessary) and then initialises a
+*     Moc structure in this memory, using data read from the input
+*     Channel.
+*
+*     If the "init" flag is set, it also initialises the contents of a
+*     virtual function table for a Moc at the start of the memory
+*     passed via the "vtab" parameter.
+
+*  Parameters:
+*     mem
+*        A pointer to the memory into which the Moc is to be
+*        loaded.  This must be of sufficient size to accommodate the
+*        Moc data (sizeof(Moc)) plus any data used by derived
+*        classes. If a value of NULL is given, this function will
+*        allocate the memory itself using the "size" parameter to
+*        determine its size.
+*     size
+*        The amount of memory used by the Moc (plus derived class
+*        data).  This will be used to allocate memory if a value of
+*        NULL is given for the "mem" parameter. This value is also
+*        stored in the Moc structure, so a valid value must be
+*        supplied even if not required for allocating memory.
+*
+*        If the "vtab" parameter is NULL, the "size" value is ignored
+*        and sizeof(AstMoc) is used instead.
+*     vtab
+*        Pointer to the start of the virtual function table to be
+*        associated with the new Moc. If this is NULL, a pointer
+*        to the (static) virtual function table for the Moc class
+*        is used instead.
+*     name
+*        Pointer to a constant null-terminated character string which
+*        contains the name of the class to which the new object
+*        belongs (it is this pointer value that will subsequently be
+*        returned by the astGetClass method).
+*
+*        If the "vtab" parameter is NULL, the "name" value is ignored
+*        and a pointer to the string "Moc" is used instead.
+
+*  Returned Value:
+*     A pointer to the new Moc.
+
+*  Notes:
+*     - A null pointer will be returned if this function is invoked
+*     with the global error status set, or if it should fail for any
+*     reason.
+*-
+*/
+
+/* Local Variables: */
+   astDECLARE_GLOBALS            /* Pointer to thread-specific global data */
+   AstMoc *new;                  /* Pointer to the new Moc */
+   char *text;                   /* Formatted cell index */
+   char key[ 20 ];               /* Buffer for keyword string */
+   int i;                        /* Range index */
+   int j;                        /* Index of limit within range */
+   long long int lval;           /* Cell index */
+
+/* Initialise. */
+   new = NULL;
+
+/* Check the global error status. */
+   if ( !astOK ) return new;
+
+/* Get a pointer to the thread specific global data structure. */
+   astGET_GLOBALS(channel);
+
+/* If a NULL virtual function table has been supplied, then this is
+   the first loader to be invoked for this Moc. In this case the
+   Moc belongs to this class, so supply appropriate values to be
+   passed to the parent class loader (and its parent, etc.). */
+   if ( !vtab ) {
+      size = sizeof( AstMoc );
+      vtab = &class_vtab;
+      name = "Moc";
+
+/* If required, initialise the virtual function table for this class. */
+      if ( !class_init ) {
+         astInitMocVtab( vtab, name );
+         class_init = 1;
+      }
+   }
+
+/* Invoke the parent class loader to load data for all the ancestral
+   classes of the current one, returning a pointer to the resulting
+   partly-built Moc. */
+   new = astLoadRegion( mem, size, (AstRegionVtab *) vtab, name,
+                        channel );
+
+   if ( astOK ) {
+
+/* Read input data. */
+/* ================ */
+/* Request the input Channel to read all the input data appropriate to
+   this class into the internal "values list". */
+      astReadClassData( channel, "Moc" );
+
+/* Now read each individual data item from this list and use it to
+   initialise the appropriate instance variable(s) for this class. */
+
+/* In the case of attributes, we first read the "raw" input value,
+   supplying the "unset" value as the default. If a "set" value is
+   obtained, we then use the appropriate (private) Set... member
+   function to validate and set the value properly. */
+
+/* MaxOrder. */
+/* --------- */
+      new->maxorder = astReadInt( channel, "mxord", -INT_MAX );
+      if ( TestMaxOrder( new, status ) ) SetMaxOrder( new, new->maxorder, status );
+
+/* Ranges. */
+/* ------- */
+      new->ncell = -1;
+      new->cellorder = NULL;
+      new->cellnpix = NULL;
+      new->boxstale = 1;
+      new->nrange = astReadInt( channel, "nrange", 0 );
+      if( new->nrange < 0 ) new->nrange = 0;
+      new->range = astMalloc( 2*new->nrange*sizeof( *new->range ) );
+      for( i = 0; i < new->nrange && astOK; i++ ) {
+         for( j = 0; j < 2; j++ ) {
+            (void) sprintf( key, j ? "hi%d" : "lo%d", i + 1 );
+            text = astReadString( channel, key, NULL );
+            if( !text || sscanf( text, "%lld", &lval ) != 1 ) {
+               if( astOK ) astError( AST__BADIN, "astRead(%s): Missing or "
+                                     "invalid cell index \"%s\" found when "
+                                     "reading a %s.", status, name, key, name );
+            } else {
+               new->range[ 2*i + j ] = (int64_t) lval;
+            }
+            text = astFree( text );
+         }
+      }
+
+/* If an error occurred, clean up by deleting the new Moc. */
+      if ( !astOK ) new = astDelete( new );
+   }
+
+/* Return the new Moc pointer. */
+   return new;
+}
+
+/* Virtual function interfaces. */
+/* ============================ */
+/* These provide the external interface to the virtual functions defined by
+   this class. Each simply checks the global error status and then locates and
+   executes the appropriate member function, using the function pointer stored
+   in the object's virtual function table (this pointer is located using the
+   astMEMBER macro defined in "object.h").
+
+   Note that the member function may not be the one defined here, as it may
+   have been over-ridden by a derived class. However, it should still have the
+   same interface. */
+
+void astAddCell_( AstMoc *this, int cmode, int order, int64_t npix,
+                  int *status ){
+   if ( !astOK ) return;
+   (**astMEMBER(this,Moc,AddCell))( this, cmode, order, npix, status );
+}
+void astAddRegion_( AstMoc *this, int cmode, AstRegion *region, int *status ){
+   if ( !astOK ) return;
+   (**astMEMBER(this,Moc,AddRegion))( this, cmode, region, status );
+}
+void astGetCell_( AstMoc *this, int icell, int *order, int64_t *npix,
+                  int *status ){
+   if ( !astOK ) return;
+   (**astMEMBER(this,Moc,GetCell))( this, icell, order, npix, status );
+}
+double astGetMocArea_( AstMoc *this, int *status ) {
+   if ( !astOK ) return 0.0;
+   return (**astMEMBER(this,Moc,GetMocArea))( this, status );
+}
+int astGetMocLength_( AstMoc *this, int *status ) {
+   if ( !astOK ) return 0;
+   return (**astMEMBER(this,Moc,GetMocLength))( this, status );
+}
@@ -0,0 +1,271 @@
+#if !defined( MOC_INCLUDED ) /* Include this file only once */
+#define MOC_INCLUDED
+/*
+*+
+*  Name:
+*     moc.h
+
+*  Type:
+*     C include file.
+
+*  Purpose:
+*     Define the interface to the Moc class.
+
+*  Invocation:
+*     #include "moc.h"
+
+*  Description:
+*     This include file defines the interface to the Moc class and
+*     provides the type definitions, function prototypes and macros,
+*     etc.  needed to use this class.
+*
+*     The Moc class implements a Region which represents an area of the
+*     celestial sphere as a "Multi-Order Coverage" map - a collection of
+*     HEALPix cells of differing sizes, all using the nested numbering
+*     scheme.
+
+*  Inheritance:
+*     The Moc class inherits from the Region class.
+
+*  Feature Test Macros:
+*     astCLASS
+*        If the astCLASS macro is undefined, only public symbols are
+*        made available, otherwise protected symbols (for use in other
+*        class implementations) are defined. This macro also affects
+*        the reporting of error context information, which is only
+*        provided for external calls to the AST library.
+
+*  Licence:
+*     This program is free software: you can redistribute it and/or
+*     modify it under the terms of the GNU Lesser General Public
+*     License as published by the Free Software Foundation, either
+*     version 3 of the License, or (at your option) any later
+*     version.
+*
+*     This program is distributed in the hope that it will be useful,
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*     GNU Lesser General Public License for more details.
+*
+*     You should have received a copy of the GNU Lesser General
+*     License along with this program.  If not, see
+*     <http://www.gnu.org/licenses/>.
+*-
+*/
+
+/* Include files. */
+/* ============== */
+/* Interface definitions. */
+/* ---------------------- */
+#include "region.h"              /* Coordinate regions (parent class) */
+#include "cmpregion.h"           /* Boolean operators AST__AND and AST__OR */
+
+#if defined(astCLASS)            /* Protected */
+#include "channel.h"             /* I/O channels */
+#endif
+
+/* C header files. */
+/* --------------- */
+#include <stdint.h>
+
+#if defined(astCLASS)            /* Protected */
+#include <stddef.h>
+#endif
+
+/* Macros */
+/* ====== */
+
+/* The highest HEALPix order that can be represented within a Moc. Cells
+   at this order are about 0.4 milli-arc-seconds across, and their nested
+   indices still fit within a 64 bit integer. */
+#define AST__MXORDHPX 29
+
+/* Define a dummy __attribute__ macro for use on non-GNU compilers. */
+#ifndef __GNUC__
+#  define  __attribute__(x)  /*NOTHING*/
+#endif
+
+/* Type Definitions. */
+/* ================= */
+/* Moc structure. */
+/* ------------------ */
+/* This structure contains all information that is unique to each object in
+   the class (e.g. its instance variables). */
+typedef struct AstMoc {
+
+/* Attributes inherited from the parent class. */
+   AstRegion region;             /* Parent class structure */
+
+/* Attributes specific to objects in this class. */
+   int maxorder;                 /* HEALPix order used to rasterise Regions */
+   int nrange;                   /* Number of ranges of covered cells */
+   int64_t *range;               /* Ranges of covered cells at AST__MXORDHPX */
+   int ncell;                    /* Number of cells in cached cell list */
+   int *cellorder;               /* HEALPix order of each cached cell */
+   int64_t *cellnpix;            /* Nested index of each cached cell */
+   double lbnd[ 2 ];             /* Lower bounds of cached bounding box */
+   double ubnd[ 2 ];             /* Upper bounds of cached bounding box */
+   int boxstale;                 /* Does the bounding box need recomputing? */
+} AstMoc;
+
+/* Virtual function table. */
+/* ----------------------- */
+/* This table contains all information that is the same for all
+   objects in the class (e.g. pointers to its virtual functions). */
+#if defined(astCLASS)            /* Protected */
+typedef struct AstMocVtab {
+
+/* Properties (e.g. methods) inherited from the parent class. */
+   AstRegionVtab region_vtab;    /* Parent class virtual function table */
+
+/* A Unique identifier to determine class membership. */
+   AstClassIdentifier id;
+
+/* Properties (e.g. methods) specific to this class. */
+   void (* AddCell)( AstMoc *, int, int, int64_t, int * );
+   void (* AddRegion)( AstMoc *, int, AstRegion *, int * );
+   void (* GetCell)( AstMoc *, int, int *, int64_t *, int * );
+
+   double (* GetMocArea)( AstMoc *, int * );
+   int (* GetMocLength)( AstMoc *, int * );
+
+   int (* GetMaxOrder)( AstMoc *, int * );
+   int (* TestMaxOrder)( AstMoc *, int * );
+   void (* ClearMaxOrder)( AstMoc *, int * );
+   void (* SetMaxOrder)( AstMoc *, int, int * );
+
+} AstMocVtab;
+
+#if defined(THREAD_SAFE)
+
+/* Define a structure holding all data items that are global within the
+   object.c file. */
+
+typedef struct AstMocGlobals {
+   AstMocVtab Class_Vtab;
+   int Class_Init;
+   char GetAttrib_Buff[ 101 ];
+} AstMocGlobals;
+
+
+/* Thread-safe initialiser for all global data used by this module. */
+void astInitMocGlobals_( AstMocGlobals * );
+
+#endif
+
+
+#endif
+
+/* Function prototypes. */
+/* ==================== */
+/* Prototypes for standard class functions. */
+/* ---------------------------------------- */
+astPROTO_CHECK(Moc)              /* Check class membership */
+astPROTO_ISA(Moc)                /* Test class membership */
+
+/* Constructor. */
+#if defined(astCLASS)            /* Protected. */
+AstMoc *astMoc_( const char *, int *, ...);
+#else
+AstMoc *astMocId_( const char *, ... )__attribute__((format(printf,1,2)));
+#endif
+
+#if defined(astCLASS)            /* Protected */
+
+/* Initialiser. */
+AstMoc *astInitMoc_( void *, size_t, int, AstMocVtab *, const char *, int * );
+
+/* Vtab initialiser. */
+void astInitMocVtab_( AstMocVtab *, const char *, int * );
+
+/* Loader. */
+AstMoc *astLoadMoc_( void *, size_t, AstMocVtab *,
+                     const char *, AstChannel *, int * );
+
+#endif
+
+/* Prototypes for member functions. */
+/* -------------------------------- */
+void astAddCell_( AstMoc *, int, int, int64_t, int * );
+void astAddRegion_( AstMoc *, int, AstRegion *, int * );
+void astGetCell_( AstMoc *, int, int *, int64_t *, int * );
+
+#if defined(astCLASS)            /* Protected */
+double astGetMocArea_( AstMoc *, int * );
+int astGetMocLength_( AstMoc *, int * );
+
+int astGetMaxOrder_( AstMoc *, int * );
+int astTestMaxOrder_( AstMoc *, int * );
+void astClearMaxOrder_( AstMoc *, int * );
+void astSetMaxOrder_( AstMoc *, int, int * );
+#endif
+
+/* Function interfaces. */
+/* ==================== */
+/* These macros are wrap-ups for the functions defined by this class
+   to make them easier to invoke (e.g. to avoid type mis-matches when
+   passing pointers to objects from derived classes). */
+
+/* Interfaces to standard class functions. */
+/* --------------------------------------- */
+/* Some of these functions provide validation, so we cannot use them
+   to validate their own arguments. We must use a cast when passing
+   object pointers (so that they can accept objects from derived
+   classes). */
+
+/* Check class membership. */
+#define astCheckMoc(this) astINVOKE_CHECK(Moc,this,0)
+#define astVerifyMoc(this) astINVOKE_CHECK(Moc,this,1)
+
+/* Test class membership. */
+#define astIsAMoc(this) astINVOKE_ISA(Moc,this)
+
+/* Constructor. */
+#if defined(astCLASS)            /* Protected. */
+#define astMoc astINVOKE(F,astMoc_)
+#else
+#define astMoc astINVOKE(F,astMocId_)
+#endif
+
+#if defined(astCLASS)            /* Protected */
+
+/* Initialiser. */
+#define astInitMoc(mem,size,init,vtab,name) \
+astINVOKE(O,astInitMoc_(mem,size,init,vtab,name,STATUS_PTR))
+
+/* Vtab Initialiser. */
+#define astInitMocVtab(vtab,name) astINVOKE(V,astInitMocVtab_(vtab,name,STATUS_PTR))
+/* Loader. */
+#define astLoadMoc(mem,size,vtab,name,channel) \
+astINVOKE(O,astLoadMoc_(mem,size,vtab,name,astCheckChannel(channel),STATUS_PTR))
+#endif
+
+/* Interfaces to public member functions. */
+/* -------------------------------------- */
+/* Here we make use of astCheckMoc to validate Moc pointers
+   before use.  This provides a contextual error report if a pointer
+   to the wrong sort of Object is supplied. */
+
+#define astAddCell(this,cmode,order,npix) \
+astINVOKE(V,astAddCell_(astCheckMoc(this),cmode,order,npix,STATUS_PTR))
+#define astAddRegion(this,cmode,region) \
+astINVOKE(V,astAddRegion_(astCheckMoc(this),cmode,astCheckRegion(region),STATUS_PTR))
+#define astGetCell(this,icell,order,npix) \
+astINVOKE(V,astGetCell_(astCheckMoc(this),icell,order,npix,STATUS_PTR))
+
+#if defined(astCLASS)            /* Protected */
+#define astGetMocArea(this) \
+astINVOKE(V,astGetMocArea_(astCheckMoc(this),STATUS_PTR))
+#define astGetMocLength(this) \
+astINVOKE(V,astGetMocLength_(astCheckMoc(this),STATUS_PTR))
+
+#define astClearMaxOrder(this) \
+astINVOKE(V,astClearMaxOrder_(astCheckMoc(this),STATUS_PTR))
+#define astGetMaxOrder(this) \
+astINVOKE(V,astGetMaxOrder_(astCheckMoc(this),STATUS_PTR))
+#define astSetMaxOrder(this,value) \
+astINVOKE(V,astSetMaxOrder_(astCheckMoc(this),value,STATUS_PTR))
+#define astTestMaxOrder(this) \
+astINVOKE(V,astTestMaxOrder_(astCheckMoc(this),STATUS_PTR))
+#endif
+#endif
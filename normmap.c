@@ -167,6 +167,7 @@ AstNormMap *astNormMapId_( void *, const char *, ... );
 static AstMapping *RemoveRegions( AstMapping *, int * );
 static AstPointSet *Transform( AstMapping *, AstPointSet *, int, AstPointSet *, int * );
 static double Rate( AstMapping *, double *, int, int, int * );
+static int RateIsExact( AstMapping *, int * );
 static int MapMerge( AstMapping *, int, int, int *, AstMapping ***, int **, int * );
 static void Copy( const AstObject *, AstObject *, int * );
 static void Delete( AstObject *, int * );
@@ -345,6 +346,7 @@ void astInitNormMapVtab_(  AstNormMapVtab *vtab, const char *name, int *status )
    mapping->MapMerge = MapMerge;
    mapping->MapSplit = MapSplit;
    mapping->Rate = Rate;
+   mapping->RateIsExact = RateIsExact;
 
 /* Declare the copy constructor, destructor and class dump function. */
    astSetDump( vtab, Dump, "NormMap", "Normalise axis values" );
@@ -893,6 +895,50 @@ static double Rate( AstMapping *this, double *at, int ax1, int ax2, int *status
    return ( ax1 == ax2 ) ? 1.0 : 0.0;
 }
 
+static int RateIsExact( AstMapping *this, int *status ) {
+/*
+*  Name:
+*     RateIsExact
+
+*  Purpose:
+*     Check if the astRate method of a Mapping is exact.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "normmap.h"
+*     int RateIsExact( AstMapping *this, int *status )
+
+*  Class Membership:
+*     NormMap member function (over-rides the protected astRateIsExact
+*     method inherited from the Mapping class).
+
+*  Description:
+*     This function returns a flag indicating if the astRate method of
+*     the supplied Mapping evaluates the rate of change analytically.
+*     The astRate method of a NormMap ignores any discontinuities
+*     introduced by normalisation, and so is treated as exact.
+
+*  Parameters:
+*     this
+*        Pointer to the Mapping.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Non-zero if the astRate method of the supplied Mapping is exact, and
+*     zero otherwise.
+
+*/
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* The rates of change are always zero or one. */
+   return 1;
+}
+
 static AstMapping *RemoveRegions( AstMapping *this_mapping, int *status ) {
 /*
 *  Name:
@@ -190,6 +190,7 @@ AstPermMap *astPermMapId_( int, const int [], int, const int [], const double []
 static AstPointSet *Transform( AstMapping *, AstPointSet *, int, AstPointSet *, int * );
 static double *GetConstants( AstPermMap *, int * );
 static double Rate( AstMapping *, double *, int, int, int * );
+static int RateIsExact( AstMapping *, int * );
 static int Equal( AstObject *, AstObject *, int * );
 static int *GetInPerm( AstPermMap *, int * );
 static int *GetOutPerm( AstPermMap *, int * );
@@ -704,6 +705,7 @@ void astInitPermMapVtab_(  AstPermMapVtab *vtab, const char *name, int *status )
    object->Equal = Equal;
    mapping->MapMerge = MapMerge;
    mapping->Rate = Rate;
+   mapping->RateIsExact = RateIsExact;
 
 /* Declare the copy constructor, destructor and class dump function. */
    astSetCopy( vtab, Copy );
@@ -1853,6 +1855,49 @@ static double Rate( AstMapping *this, double *at, int ax1, int ax2, int *status
    return result;
 }
 
+static int RateIsExact( AstMapping *this, int *status ) {
+/*
+*  Name:
+*     RateIsExact
+
+*  Purpose:
+*     Check if the astRate method of a Mapping is exact.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "permmap.h"
+*     int RateIsExact( AstMapping *this, int *status )
+
+*  Class Membership:
+*     PermMap member function (over-rides the protected astRateIsExact
+*     method inherited from the Mapping class).
+
+*  Description:
+*     This function returns a flag indicating if the astRate method of
+*     the supplied Mapping evaluates the rate of change analytically.
+*     The rates of change of a PermMap are always zero or one.
+
+*  Parameters:
+*     this
+*        Pointer to the Mapping.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Non-zero if the astRate method of the supplied Mapping is exact, and
+*     zero otherwise.
+
+*/
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* The rates of change are always zero or one. */
+   return 1;
+}
+
 static AstPointSet *Transform( AstMapping *map, AstPointSet *in,
                                int forward, AstPointSet *out, int *status ) {
 /*
@@ -74,14 +74,6 @@ f     The PointList class does not define any new routines beyond those
 *        In Transform, use "ptr2", not "ptr", if we are creating a mask.
 *class--
 
-*  Implementation Deficiencies:
-*     - Use of simple arrays to hold lists  of points is probably not
-*     efficient for large numbers of points. For instance, use of k-tree
-*     structures instead of arrays could result in a much  more efficient
-*     implementation of the Transform function. Maybe the PointSet class
-*     should be extended to provide a k-tree representation as well as a
-*     simple array.
-
 */
 
 /* Module Macros. */
@@ -110,6 +102,10 @@ f     The PointList class does not define any new routines beyond those
 #include "cmpframe.h"            /* Compound Frames */
 #include "cmpmap.h"              /* Compound Mappings */
 #include "prism.h"               /* Extruded Regions */
+#include "box.h"                 /* Box Regions */
+#include "circle.h"              /* Circular Regions */
+#include "skyframe.h"            /* Celestial coordinate systems */
+#include "wcsmap.h"              /* Factors of PI */
 
 /* Error code definitions. */
 /* ----------------------- */
@@ -139,6 +135,7 @@ static int (* parent_getobjsize)( AstObject *, int * );
 static int (* parent_testattrib)( AstObject *, const char *, int * );
 static void (* parent_clearattrib)( AstObject *, const char *, int * );
 static void (* parent_setattrib)( AstObject *, const char *, int * );
+static void (* parent_resetcache)( AstRegion *, int * );
 
 
 #ifdef THREAD_SAFE
@@ -196,16 +193,22 @@ static int MaskUS( AstRegion *, AstMapping *, int, int, const int[], const int[]
 static AstMapping *Simplify( AstMapping *, int * );
 static AstPointSet *RegBaseMesh( AstRegion *, int * );
 static AstPointSet *Transform( AstMapping *, AstPointSet *, int, AstPointSet *, int * );
+static AstPointSet *UncLoop( AstRegion *, double **, int, AstPointSet *, int * );
 static AstRegion *RegBasePick( AstRegion *, int, const int *, int * );
 static int GetClosed( AstRegion *, int * );
 static int GetListSize( AstPointList *, int * );
 static int GetObjSize( AstObject *, int * );
+static int *NearPoints( AstPointList *, AstRegion *, double **, AstPointSet *, int * );
+static int KdTree( AstPointList *, double **, int, int, int, int, int * );
 static int RegPins( AstRegion *, AstPointSet *, AstRegion *, int **, int * );
 static void Copy( const AstObject *, AstObject *, int * );
+static void KdSearch( const double *, const int *, int, int, int, const double *, const double *, int **, int *, int * );
+static void KdSplit( double *, int *, int *, int, int, int, int * );
 static void PointListPoints( AstPointList *, AstPointSet **, int *);
 static void Delete( AstObject *, int * );
 static void Dump( AstObject *, AstChannel *, int * );
 static void RegBaseBox( AstRegion *, double *, double *, int * );
+static void ResetCache( AstRegion *, int * );
 static AstRegion *MergePointList( AstPointList *, AstRegion *, int, int * );
 static int MapMerge( AstMapping *, int, int, int *, AstMapping ***, int **, int * );
 
@@ -518,8 +521,11 @@ static int GetObjSize( AstObject *this_object, int *status ) {
    which are stored in dynamically allocated memory. */
    result = (*parent_getobjsize)( this_object, status );
 
-   result += astGetObjSize( this->lbnd );
-   result += astGetObjSize( this->ubnd );
+   result += astTSizeOf( this->lbnd );
+   result += astTSizeOf( this->ubnd );
+   result += astTSizeOf( this->kdpos );
+   result += astTSizeOf( this->kdindex );
+   result += astTSizeOf( this->kdaxis );
 
 /* If an error occurred, clear the result value. */
    if ( !astOK ) result = 0;
@@ -622,6 +628,9 @@ void astInitPointListVtab_(  AstPointListVtab *vtab, const char *name,
    parent_simplify = mapping->Simplify;
    mapping->Simplify = Simplify;
 
+   parent_resetcache = region->ResetCache;
+   region->ResetCache = ResetCache;
+
 /* Store replacement pointers for methods which will be over-ridden by
    new member functions implemented here. */
    mapping->MapMerge = MapMerge;
@@ -660,6 +669,330 @@ void astInitPointListVtab_(  AstPointListVtab *vtab, const char *name,
    }
 }
 
+static void KdSearch( const double *pos, const int *axis, int nc, int lo,
+                      int hi, const double *qlo, const double *qhi,
+                      int **hits, int *nhit, int *status ){
+/*
+*  Name:
+*     KdSearch
+
+*  Purpose:
+*     Find the k-d tree nodes that fall within a given box.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "pointlist.h"
+*     void KdSearch( const double *pos, const int *axis, int nc, int lo,
+*                    int hi, const double *qlo, const double *qhi,
+*                    int **hits, int *nhit, int *status )
+
+*  Class Membership:
+*     PointList member function
+
+*  Description:
+*     This function searches the sub-tree occupying nodes "lo" to "hi-1"
+*     of a k-d tree created by KdSplit, and appends the index of every
+*     node that falls within the supplied box (boundaries included) to
+*     the "hits" array.
+
+*  Parameters:
+*     pos
+*        The node coordinates, "nc" values per node.
+*     axis
+*        The axis split at each node.
+*     nc
+*        The number of coordinates per node.
+*     lo
+*        The first node in the sub-tree.
+*     hi
+*        One more than the last node in the sub-tree.
+*     qlo
+*        The lower bounds of the box on each axis.
+*     qhi
+*        The upper bounds of the box on each axis.
+*     hits
+*        Address of a pointer to a dynamically allocated array holding
+*        the indices of the nodes found so far. It is extended as
+*        required using astGrow.
+*     nhit
+*        Address of the number of nodes found so far. Updated on exit.
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Variables: */
+   const double *x;           /* Coords of the node at the sub-tree root */
+   int ic;                    /* Axis index */
+   int mid;                   /* Node at the root of the sub-tree */
+
+/* Loop until the sub-tree is empty. The right hand sub-tree is handled
+   by the loop and the left hand one by recursion. */
+   while( lo < hi && astOK ) {
+
+/* The root of the sub-tree is its central node. Check if it is inside the
+   box. */
+      mid = ( lo + hi )/2;
+      x = pos + mid*nc;
+      for( ic = 0; ic < nc; ic++ ) {
+         if( x[ ic ] < qlo[ ic ] || x[ ic ] > qhi[ ic ] ) break;
+      }
+
+/* If so, append it to the returned list. */
+      if( ic == nc ) {
+         *hits = astGrow( *hits, *nhit + 1, sizeof( int ) );
+         if( astOK ) (*hits)[ (*nhit)++ ] = mid;
+      }
+
+/* Nodes below "mid" have values no greater than "mid" on the split axis,
+   and nodes above "mid" have values no less than "mid". Search whichever
+   halves could overlap the box. */
+      if( qlo[ axis[ mid ] ] <= x[ axis[ mid ] ] ) {
+         KdSearch( pos, axis, nc, lo, mid, qlo, qhi, hits, nhit, status );
+      }
+      if( qhi[ axis[ mid ] ] >= x[ axis[ mid ] ] ) {
+         lo = mid + 1;
+      } else {
+         lo = hi;
+      }
+   }
+}
+
+static void KdSplit( double *pos, int *index, int *axis, int nc, int lo,
+                     int hi, int *status ){
+/*
+*  Name:
+*     KdSplit
+
+*  Purpose:
+*     Arrange a set of points into a balanced k-d tree.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "pointlist.h"
+*     void KdSplit( double *pos, int *index, int *axis, int nc, int lo,
+*                   int hi, int *status )
+
+*  Class Membership:
+*     PointList member function
+
+*  Description:
+*     This function re-orders the points "lo" to "hi-1" in place so that
+*     they form an implicit balanced k-d tree. The root of the tree is the
+*     central point, which holds the median value on the axis with the
+*     largest spread of values. All points before it have values no
+*     greater than the median on that axis, and all points after it have
+*     values no less than the median. The two halves are then split
+*     recursively in the same way.
+
+*  Parameters:
+*     pos
+*        The point coordinates, "nc" values per point. Re-ordered on exit.
+*     index
+*        An identifier for each point. Re-ordered on exit in the same way
+*        as "pos".
+*     axis
+*        Returned holding the axis split at each node of the tree.
+*     nc
+*        The number of coordinates per point.
+*     lo
+*        The first point to include in the tree.
+*     hi
+*        One more than the last point to include in the tree.
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Variables: */
+   double *pi;                /* Coords of low point to be swapped */
+   double *pj;                /* Coords of high point to be swapped */
+   double dtmp;               /* Swap variable */
+   double hival;              /* Largest value on an axis */
+   double loval;              /* Smallest value on an axis */
+   double pivot;              /* Partition value */
+   double spread;             /* Largest axis spread found so far */
+   int ax;                    /* Axis to split */
+   int i;                     /* Low partition index */
+   int ic;                    /* Axis index */
+   int ip;                    /* Point index */
+   int itmp;                  /* Swap variable */
+   int j;                     /* High partition index */
+   int l;                     /* Low end of range being partitioned */
+   int mid;                   /* Central point */
+   int r;                     /* High end of range being partitioned */
+
+/* Loop until all sub-trees have been split. The right hand sub-tree is
+   handled by the loop and the left hand one by recursion. */
+   while( hi - lo > 1 && astOK ) {
+
+/* Find the axis with the largest spread of values. */
+      ax = 0;
+      spread = -1.0;
+      for( ic = 0; ic < nc; ic++ ) {
+         loval = hival = pos[ lo*nc + ic ];
+         for( ip = lo + 1; ip < hi; ip++ ) {
+            if( pos[ ip*nc + ic ] < loval ) loval = pos[ ip*nc + ic ];
+            if( pos[ ip*nc + ic ] > hival ) hival = pos[ ip*nc + ic ];
+         }
+         if( hival - loval > spread ) {
+            spread = hival - loval;
+            ax = ic;
+         }
+      }
+
+/* Partially sort the points on that axis so that the central point holds
+   the median value (Hoare's selection algorithm). */
+      mid = ( lo + hi )/2;
+      l = lo;
+      r = hi - 1;
+      while( l < r ) {
+         pivot = pos[ mid*nc + ax ];
+         i = l;
+         j = r;
+         do {
+            while( pos[ i*nc + ax ] < pivot ) i++;
+            while( pivot < pos[ j*nc + ax ] ) j--;
+            if( i <= j ) {
+               pi = pos + i*nc;
+               pj = pos + j*nc;
+               for( ic = 0; ic < nc; ic++ ) {
+                  dtmp = pi[ ic ];
+                  pi[ ic ] = pj[ ic ];
+                  pj[ ic ] = dtmp;
+               }
+               itmp = index[ i ];
+               index[ i ] = index[ j ];
+               index[ j ] = itmp;
+               i++;
+               j--;
+            }
+         } while( i <= j );
+         if( j < mid ) l = i;
+         if( mid < i ) r = j;
+      }
+
+/* Record the split axis and then split each half. */
+      axis[ mid ] = ax;
+      KdSplit( pos, index, axis, nc, lo, mid, status );
+      lo = mid + 1;
+   }
+
+/* A sub-tree holding a single point needs no split, but give it a valid
+   axis index. */
+   if( hi - lo == 1 ) axis[ lo ] = 0;
+}
+
+static int KdTree( AstPointList *this, double **ptr, int nc, int np,
+                   int sky, int lonax, int *status ){
+/*
+*  Name:
+*     KdTree
+
+*  Purpose:
+*     Ensure a k-d tree of the PointList positions is available.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "pointlist.h"
+*     int KdTree( AstPointList *this, double **ptr, int nc, int np,
+*                 int sky, int lonax, int *status )
+
+*  Class Membership:
+*     PointList member function
+
+*  Description:
+*     This function creates a k-d tree holding the supplied PointList
+*     positions and caches it in the PointList structure, unless a tree
+*     of the requested type already exists. The cached tree is deleted
+*     by astResetCache.
+*
+*     For a SkyFrame the tree holds 3-D unit vectors rather than
+*     longitude and latitude, so that a box in the tree corresponds to a
+*     region of the sky with no discontinuity at the longitude origin or
+*     the poles.
+
+*  Parameters:
+*     this
+*        Pointer to the PointList.
+*     ptr
+*        Pointers to the axis values of the PointList positions, in the
+*        base Frame of the uncertainty Region. None should be bad.
+*     nc
+*        The number of axes in the base Frame of the uncertainty Region.
+*     np
+*        The number of positions in the PointList.
+*     sky
+*        Non-zero if the tree should hold 3-D unit vectors. In this case
+*        "nc" must be 2.
+*     lonax
+*        The zero-based index of the longitude axis. Only used if "sky"
+*        is non-zero.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Non-zero if a tree is available.
+*/
+
+/* Local Variables: */
+   double *p;                 /* Coords of next node */
+   double cl;                 /* Cos(latitude) */
+   int ip;                    /* Point index */
+   int ic;                    /* Axis index */
+   int kdnc;                  /* Number of coords per tree node */
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* Return if a tree of the required type already exists. */
+   if( this->kdpos && this->kdsky == sky ) return 1;
+
+/* Otherwise, delete any existing tree and allocate memory for a new one. */
+   this->kdpos = astFree( this->kdpos );
+   this->kdindex = astFree( this->kdindex );
+   this->kdaxis = astFree( this->kdaxis );
+
+   kdnc = sky ? 3 : nc;
+   this->kdpos = astMalloc( sizeof( double )*(size_t)( np*kdnc ) );
+   this->kdindex = astMalloc( sizeof( int )*(size_t) np );
+   this->kdaxis = astMalloc( sizeof( int )*(size_t) np );
+   this->kdsky = sky;
+
+/* Store the coordinates of each position in the tree arrays. */
+   if( astOK ) {
+      p = this->kdpos;
+      for( ip = 0; ip < np; ip++ ) {
+         this->kdindex[ ip ] = ip;
+         if( sky ) {
+            cl = cos( ptr[ 1 - lonax ][ ip ] );
+            *(p++) = cl*cos( ptr[ lonax ][ ip ] );
+            *(p++) = cl*sin( ptr[ lonax ][ ip ] );
+            *(p++) = sin( ptr[ 1 - lonax ][ ip ] );
+         } else {
+            for( ic = 0; ic < nc; ic++ ) *(p++) = ptr[ ic ][ ip ];
+         }
+      }
+
+/* Arrange them into a tree. */
+      KdSplit( this->kdpos, this->kdindex, this->kdaxis, kdnc, 0, np,
+               status );
+   }
+
+/* Delete the tree if anything went wrong. */
+   if( !astOK ) {
+      this->kdpos = astFree( this->kdpos );
+      this->kdindex = astFree( this->kdindex );
+      this->kdaxis = astFree( this->kdaxis );
+   }
+
+   return ( this->kdpos != NULL );
+}
+
 /*
 *  Name:
 *     Mask<X>
@@ -1526,6 +1859,351 @@ void PointListPoints( AstPointList *this, AstPointSet **pset, int *status) {
 
 }
 
+static int *NearPoints( AstPointList *this, AstRegion *unc, double **ptr_base,
+                        AstPointSet *in_base, int *status ){
+/*
+*  Name:
+*     NearPoints
+
+*  Purpose:
+*     Use a k-d tree to find the test points that are close to a PointList.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "pointlist.h"
+*     int *NearPoints( AstPointList *this, AstRegion *unc, double **ptr_base,
+*                      AstPointSet *in_base, int *status )
+
+*  Class Membership:
+*     PointList member function
+
+*  Description:
+*     This function finds the supplied test points which fall inside the
+*     uncertainty Region when it is centred on any of the PointList
+*     positions. It gives the same results as re-centring the uncertainty
+*     Region on every PointList position in turn and transforming all
+*     the test points each time, but uses a k-d tree of the PointList
+*     positions to find the few positions that need to be checked for
+*     each test point.
+*
+*     This is only possible if re-centring the uncertainty Region is a
+*     simple shift (a Box or Circle within a basic Frame), or if the
+*     uncertainty Region is a Circle within a SkyFrame.
+*     For a Circle, the distance from each nearby PointList position is
+*     compared directly with the Circle radius. For other classes, the
+*     uncertainty Region is re-centred only on the PointList positions
+*     that have nearby test points, and only those test points are
+*     transformed.
+
+*  Parameters:
+*     this
+*        Pointer to the PointList.
+*     unc
+*        Pointer to the uncertainty Region, with its Negated attribute set.
+*     ptr_base
+*        Pointers to the axis values of the PointList positions, in the
+*        base Frame of "unc".
+*     in_base
+*        The test points, in the current Frame of "unc".
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A pointer to a dynamically allocated array with an element for each
+*     test point. Each element is 1 if the test point falls inside the
+*     uncertainty Region centred on any PointList position, zero if not,
+*     and -1 if the test point has a bad axis value (such points are not
+*     checked). The array should be freed using astFree when no longer
+*     needed. NULL is returned if the k-d tree cannot be used.
+
+*  Notes:
+*     - NULL is returned if this function is invoked with the global
+*     error status set, or if it should fail for any reason.
+*/
+
+/* Local Variables: */
+   AstFrame *ubfrm;           /* Uncertainty base Frame */
+   AstFrame *ucfrm;           /* Uncertainty current Frame */
+   AstMapping *smap;          /* Uncertainty base->current Mapping */
+   AstPointSet *ps1;          /* Test points near one PointList position */
+   AstPointSet *ps2;          /* Transformed test points */
+   double **ptr1;             /* Pointers to "ps1" axis values */
+   double **ptr2;             /* Pointers to "ps2" axis values */
+   double **ptr_in;           /* Pointers to test point axis values */
+   double *c0;                /* Original uncertainty centre */
+   double *lbox;              /* Lower bounds of uncertainty Region */
+   double *pv;                /* Test point axis values */
+   double *qhi;               /* Upper bounds of k-d tree search box */
+   double *qlo;               /* Lower bounds of k-d tree search box */
+   double *qv;                /* PointList axis values */
+   double *ubox;              /* Upper bounds of uncertainty Region */
+   double *whi;               /* Upper offsets of search box */
+   double *wlo;               /* Lower offsets of search box */
+   double cl;                 /* Cos(latitude) */
+   double d;                  /* Distance from PointList position */
+   double pad;                /* Padding for search box */
+   double radius;             /* Circle radius */
+   double x[ 3 ];             /* Test point k-d tree coords */
+   int *first;                /* Index of first pair for each PointList position */
+   int *hits;                 /* k-d tree nodes found by search */
+   int *order;                /* Pairs sorted by PointList position */
+   int *pairp;                /* Test point for each candidate pair */
+   int *pairq;                /* PointList position for each candidate pair */
+   int *result;               /* Returned array */
+   int circle;                /* Is the uncertainty Region a Circle? */
+   int closed;                /* Is the uncertainty boundary included? */
+   int ic;                    /* Axis index */
+   int ih;                    /* Hit index */
+   int ip;                    /* Test point index */
+   int iq;                    /* PointList position index */
+   int kdnc;                  /* Number of coords per k-d tree node */
+   int lonax;                 /* Index of longitude axis */
+   int n;                     /* Number of test points near a position */
+   int nc;                    /* Number of axes */
+   int nhit;                  /* Number of k-d tree nodes found */
+   int npair;                 /* Number of candidate pairs */
+   int npoint;                /* Number of test points */
+   int nrp;                   /* Number of PointList positions */
+   int sky;                   /* Is the base Frame a SkyFrame? */
+   int use;                   /* Can the k-d tree be used? */
+
+/* Initialise */
+   result = NULL;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Get the numbers of test points, axes and PointList positions. */
+   npoint = astGetNpoint( in_base );
+   nc = astGetNcoord( in_base );
+   nrp = astGetNpoint( ((AstRegion *) this)->points );
+   ptr_in = astGetPoints( in_base );
+
+/* The uncertainty Region must be one of the classes described in the
+   prologue, and its base->current Mapping must be a UnitMap so that the
+   supplied positions can be compared with its base Frame centre without
+   any change. */
+   smap = astRegMapping( unc );
+   ubfrm = astGetFrame( unc->frameset, AST__BASE );
+   ucfrm = astGetFrame( unc->frameset, AST__CURRENT );
+   circle = astIsACircle( unc );
+   use = 0;
+   sky = 0;
+   lonax = 0;
+   if( astOK && nrp > 0 && astIsAUnitMap( smap ) &&
+       !strcmp( astGetClass( ubfrm ), astGetClass( ucfrm ) ) ) {
+      if( !strcmp( astGetClass( ubfrm ), "Frame" ) ) {
+         use = circle || astIsABox( unc );
+      } else if( !strcmp( astGetClass( ubfrm ), "SkyFrame" ) && circle ) {
+         use = 1;
+         sky = 1;
+         lonax = astGetLonAxis( ubfrm );
+      }
+   }
+
+/* Re-centring the uncertainty Region does not change any axis that has a
+   bad centre value, so the results would depend on the order in which
+   the PointList positions are used. Do not use the tree if any PointList
+   axis value is bad. */
+   for( ic = 0; ic < nc && use; ic++ ) {
+      for( iq = 0; iq < nrp; iq++ ) {
+         if( ptr_base[ ic ][ iq ] == AST__BAD ) {
+            use = 0;
+            break;
+         }
+      }
+   }
+
+/* Find the box, relative to a PointList position, within which any test
+   point must lie in order to be inside the uncertainty Region centred on
+   that position. For a Circle on the sky this is a box of 3-D unit
+   vectors large enough to contain the chord subtended by the radius. The
+   box is padded to allow for rounding errors. */
+   kdnc = sky ? 3 : nc;
+   wlo = astMalloc( sizeof( double )*(size_t) kdnc );
+   whi = astMalloc( sizeof( double )*(size_t) kdnc );
+   qlo = astMalloc( sizeof( double )*(size_t) kdnc );
+   qhi = astMalloc( sizeof( double )*(size_t) kdnc );
+   pv = astMalloc( sizeof( double )*(size_t) nc );
+   qv = astMalloc( sizeof( double )*(size_t) nc );
+   radius = AST__BAD;
+   closed = 0;
+   if( use && astOK ) {
+      if( circle ) {
+         astCirclePars( unc, qv, &radius, NULL );
+         closed = astGetClosed( unc );
+         if( radius == AST__BAD || !( radius >= 0.0 ) ) {
+            use = 0;
+         } else {
+            pad = radius*( 1.0 + 1.0E-9 ) + 1.0E-12;
+            if( sky ) pad = ( pad < AST__DPI ) ? 2.0*sin( 0.5*pad ) + 1.0E-12 : 2.0;
+            for( ic = 0; ic < kdnc; ic++ ) {
+               wlo[ ic ] = -pad;
+               whi[ ic ] = pad;
+            }
+         }
+
+      } else {
+         lbox = astMalloc( sizeof( double )*(size_t) nc );
+         ubox = astMalloc( sizeof( double )*(size_t) nc );
+         astRegBaseBox( unc, lbox, ubox );
+         c0 = astRegCentre( unc, NULL, NULL, 0, AST__BASE );
+         if( astOK ) {
+            for( ic = 0; ic < nc; ic++ ) {
+               if( lbox[ ic ] == AST__BAD || ubox[ ic ] == AST__BAD ||
+                   c0[ ic ] == AST__BAD || !( ubox[ ic ] - lbox[ ic ] < DBL_MAX ) ) {
+                  use = 0;
+               } else {
+                  pad = 1.0E-6*( ubox[ ic ] - lbox[ ic ] ) +
+                        1.0E-12*( fabs( lbox[ ic ] ) + fabs( ubox[ ic ] ) );
+                  wlo[ ic ] = lbox[ ic ] - c0[ ic ] - pad;
+                  whi[ ic ] = ubox[ ic ] - c0[ ic ] + pad;
+               }
+            }
+         }
+         c0 = astFree( c0 );
+         lbox = astFree( lbox );
+         ubox = astFree( ubox );
+      }
+   }
+
+/* Ensure the k-d tree is available, and allocate the returned array. */
+   if( use && KdTree( this, ptr_base, nc, nrp, sky, lonax, status ) ) {
+      result = astMalloc( sizeof( int )*(size_t) npoint );
+   }
+
+/* Loop round each test point. */
+   hits = NULL;
+   pairp = NULL;
+   pairq = NULL;
+   npair = 0;
+   if( result && astOK ) {
+      for( ip = 0; ip < npoint; ip++ ) {
+
+/* Test points with bad axis values are left for the caller to handle. */
+         result[ ip ] = 0;
+         for( ic = 0; ic < nc; ic++ ) {
+            pv[ ic ] = ptr_in[ ic ][ ip ];
+            if( pv[ ic ] == AST__BAD ) result[ ip ] = -1;
+         }
+         if( result[ ip ] ) continue;
+
+/* Get the k-d tree coords of the test point, and find all PointList
+   positions within the search box around it. */
+         if( sky ) {
+            cl = cos( pv[ 1 - lonax ] );
+            x[ 0 ] = cl*cos( pv[ lonax ] );
+            x[ 1 ] = cl*sin( pv[ lonax ] );
+            x[ 2 ] = sin( pv[ 1 - lonax ] );
+         }
+         for( ic = 0; ic < kdnc; ic++ ) {
+            d = sky ? x[ ic ] : pv[ ic ];
+            qlo[ ic ] = d - whi[ ic ];
+            qhi[ ic ] = d - wlo[ ic ];
+         }
+         nhit = 0;
+         KdSearch( this->kdpos, this->kdaxis, kdnc, 0, nrp, qlo, qhi,
+                   &hits, &nhit, status );
+
+/* For a Circle, the test point is inside if its distance from any of
+   these PointList positions would put it inside the negated Circle. The
+   Circle class uses the same test, with the distance measured from the
+   Circle centre. Bad distances are treated as inside, since the negated
+   Circle would return a bad position. */
+         for( ih = 0; ih < nhit && astOK; ih++ ) {
+            iq = this->kdindex[ hits[ ih ] ];
+            if( circle ) {
+               for( ic = 0; ic < nc; ic++ ) qv[ ic ] = ptr_base[ ic ][ iq ];
+               d = astDistance( ubfrm, qv, pv );
+               if( d == AST__BAD || ( closed ? d < radius : d <= radius ) ) {
+                  result[ ip ] = 1;
+                  break;
+               }
+
+/* For other classes, record the pair for checking below. */
+            } else {
+               pairp = astGrow( pairp, npair + 1, sizeof( int ) );
+               pairq = astGrow( pairq, npair + 1, sizeof( int ) );
+               if( astOK ) {
+                  pairp[ npair ] = ip;
+                  pairq[ npair++ ] = iq;
+               }
+            }
+         }
+      }
+   }
+
+/* If any candidate pairs were found, sort them by PointList position
+   (a counting sort which retains the test point order). */
+   if( npair > 0 && astOK ) {
+      first = astCalloc( nrp + 1, sizeof( int ) );
+      order = astMalloc( sizeof( int )*(size_t) npair );
+      if( astOK ) {
+         for( ih = 0; ih < npair; ih++ ) first[ pairq[ ih ] + 1 ]++;
+         for( iq = 0; iq < nrp; iq++ ) first[ iq + 1 ] += first[ iq ];
+         for( ih = 0; ih < npair; ih++ ) order[ first[ pairq[ ih ] ]++ ] = pairp[ ih ];
+         for( iq = nrp; iq > 0; iq-- ) first[ iq ] = first[ iq - 1 ];
+         first[ 0 ] = 0;
+
+/* Loop round each PointList position that has candidate test points. */
+         for( iq = 0; iq < nrp && astOK; iq++ ) {
+            n = first[ iq + 1 ] - first[ iq ];
+            if( n == 0 ) continue;
+
+/* Copy the candidate test points into a new PointSet. */
+            ps1 = astPointSet( n, nc, "", status );
+            ptr1 = astGetPoints( ps1 );
+            if( astOK ) {
+               for( ih = 0; ih < n; ih++ ) {
+                  ip = order[ first[ iq ] + ih ];
+                  for( ic = 0; ic < nc; ic++ ) ptr1[ ic ][ ih ] = ptr_in[ ic ][ ip ];
+               }
+            }
+
+/* Centre the uncertainty Region on the PointList position and use it to
+   transform the candidates. Candidates which are inside the uncertainty
+   Region are returned bad, since it has been negated. */
+            astRegCentre( unc, NULL, ptr_base, iq, AST__BASE );
+            ps2 = astTransform( unc, ps1, 0, NULL );
+            ptr2 = astGetPoints( ps2 );
+            if( astOK ) {
+               for( ih = 0; ih < n; ih++ ) {
+                  if( ptr2[ 0 ][ ih ] == AST__BAD ) {
+                     result[ order[ first[ iq ] + ih ] ] = 1;
+                  }
+               }
+            }
+            ps1 = astAnnul( ps1 );
+            ps2 = astAnnul( ps2 );
+         }
+      }
+      first = astFree( first );
+      order = astFree( order );
+   }
+
+/* Free resources. */
+   hits = astFree( hits );
+   pairp = astFree( pairp );
+   pairq = astFree( pairq );
+   wlo = astFree( wlo );
+   whi = astFree( whi );
+   qlo = astFree( qlo );
+   qhi = astFree( qhi );
+   pv = astFree( pv );
+   qv = astFree( qv );
+   smap = astAnnul( smap );
+   ubfrm = astAnnul( ubfrm );
+   ucfrm = astAnnul( ucfrm );
+
+/* Return NULL if an error occurred. */
+   if( !astOK ) result = astFree( result );
+
+/* Return the result. */
+   return result;
+}
+
 static void RegBaseBox( AstRegion *this_region, double *lbnd, double *ubnd, int *status ){
 /*
 *  Name:
@@ -2073,6 +2751,43 @@ static int RegPins( AstRegion *this_region, AstPointSet *pset, AstRegion *unc,
    return result;
 }
 
+static void ResetCache( AstRegion *this, int *status ){
+/*
+*  Name:
+*     ResetCache
+
+*  Purpose:
+*     Clear cached information within the supplied Region.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "pointlist.h"
+*     void ResetCache( AstRegion *this, int *status )
+
+*  Class Membership:
+*     Region member function (overrides the astResetCache method
+*     inherited from the parent Region class).
+
+*  Description:
+*     This function clears cached information from the supplied Region
+*     structure.
+
+*  Parameters:
+*     this
+*        Pointer to the Region.
+*     status
+*        Pointer to the inherited status variable.
+*/
+   if( this ) {
+      ( (AstPointList *) this )->kdpos = astFree( ( (AstPointList *) this )->kdpos );
+      ( (AstPointList *) this )->kdindex = astFree( ( (AstPointList *) this )->kdindex );
+      ( (AstPointList *) this )->kdaxis = astFree( ( (AstPointList *) this )->kdaxis );
+      (*parent_resetcache)( this, status );
+   }
+}
+
 static void SetAttrib( AstObject *this_object, const char *setting,
                        int *status ) {
 /*
@@ -2423,22 +3138,28 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
 
 /* Local Variables: */
    AstPointSet *in_base;         /* Pointer to PointSet holding base Frame positions*/
-   AstPointSet *ps1;             /* Pointer to accumulation PointSet */
-   AstPointSet *ps2;             /* Pointer to accumulation PointSet */
+   AstPointSet *ps1;             /* Pointer to mask PointSet */
    AstPointSet *ps3;             /* Pointer for swapping PointSet pointers */
    AstPointSet *pset_base;       /* PointList positions in "unc" base Frame */
    AstPointSet *pset_reg;        /* Pointer to Region PointSet */
+   AstPointSet *pset_sub;        /* Test points with bad axis values */
    AstPointSet *result;          /* Pointer to output PointSet */
    AstRegion *this;              /* Pointer to the Region structure */
    AstRegion *unc;               /* Pointer to uncertainty Region */
    double **ptr1;                /* Pointer to mask pointer array */
    double **ptr_base;            /* Pointer to axis values for "pset_base" */
+   double **ptr_in;              /* Pointer to axis values for "in_base" */
    double **ptr_out;             /* Pointer to output coordinate data */
+   double **ptr_sub;             /* Pointer to axis values for "pset_sub" */
    double *cen_orig;             /* Pointer to array holding original centre coords */
-   double *mask;                 /* Pointer to mask axis values */
+   int *near;                    /* Flags for test points close to the PointList */
    int coord;                    /* Zero-based index for coordinates */
+   int inside;                   /* Is the test point in the PointList? */
+   int isub;                     /* Index into "pset_sub" */
+   int nbad;                     /* No. of test points with bad axis values */
    int ncoord_base;              /* No. of coordinates per base Frame point */
    int ncoord_out;               /* No. of coordinates per output point */
+   int neg;                      /* Has the PointList been negated? */
    int npoint;                   /* No. of supplied input test points */
    int nrp;                      /* No. of points in Region PointSet */
    int point;                    /* Loop counter for points */
@@ -2446,10 +3167,6 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
 /* Check the global error status. */
    if ( !astOK ) return NULL;
 
-/* Avoid -Wall compiler warnings. */
-   ps1 = NULL;
-   ps2 = NULL;
-
 /* Obtain a pointer to the Region structure. */
    this = (AstRegion *) this_mapping;
 
@@ -2512,69 +3229,86 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
 /* Save the original base Frame centre coords of the uncertainty Region. */
       cen_orig = astRegCentre( unc, NULL, NULL, 0, AST__BASE );
 
-/* We use the PointSet created above as the initial input to astTransform
-   below. Also indicate we currently have no output PointSet. This will
-   cause a new PointSet to be created on the first pass through the loop
-   below. */
-      ps1 = astClone( in_base );
-      ps2 = NULL;
-
-/* Loop round all the points in the PointList. */
-      for ( point = 0; point < nrp; point++ ) {
-
-/* Centre the uncertainty Region at this PointList position. Note, the
-   base Frame of the PointList should be the same as the current Frame
-   of the uncertainty Region. */
-         astRegCentre( unc, NULL, ptr_base, point, AST__BASE );
-
-/* Use the uncertainty Region to transform the supplied PointSet. This
-   will set supplied points bad if they are within the uncertainty Region
-   (since the uncertainty Region has been negated above). */
-         ps2 = astTransform( unc, ps1, 0, ps2 );
+/* Where possible, use a k-d tree of the PointList positions to find the
+   test points that are inside the uncertainty Region centred on any
+   PointList position. Test points with bad axis values are flagged with
+   -1 and are handled below. */
+      near = NearPoints( (AstPointList *) this, unc, ptr_base, in_base,
+                         status );
+
+/* Otherwise, re-centre the uncertainty Region on every PointList position
+   in turn. The returned PointSet is a copy of the test points but with
+   positions set bad if they are inside any of the re-centred uncertainty
+   Regions. Convert this into the same form as the values returned by
+   NearPoints. */
+      if( !near && astOK ) {
+         ps1 = UncLoop( unc, ptr_base, nrp, in_base, status );
+         ptr1 = astGetPoints( ps1 );
+         near = astMalloc( sizeof( int )*(size_t) npoint );
+         if( astOK ) {
+            for ( point = 0; point < npoint; point++ ) {
+               near[ point ] = ( ptr1[ 0 ][ point ] == AST__BAD );
+            }
+         }
+         ps1 = astAnnul( ps1 );
+      }
 
-/* Use the output PointSet created above as the input for the next
-   position. This causes bad points to be accumulated in the output
-   PointSet. */
-         ps3 = ps2;
-         ps2 = ps1;
-         ps1 = ps3;
+/* Test points with bad axis values are checked using the full loop,
+   since the result depends on the uncertainty Region class. Copy them
+   into a new PointSet. */
+      nbad = 0;
+      ptr_in = astGetPoints( in_base );
+      for ( point = 0; astOK && point < npoint; point++ ) {
+         if( near[ point ] < 0 ) nbad++;
+      }
+      if( nbad > 0 && astOK ) {
+         pset_sub = astPointSet( nbad, ncoord_base, "", status );
+         ptr_sub = astGetPoints( pset_sub );
+         if( astOK ) {
+            isub = 0;
+            for ( point = 0; point < npoint; point++ ) {
+               if( near[ point ] < 0 ) {
+                  for( coord = 0; coord < ncoord_base; coord++ ) {
+                     ptr_sub[ coord ][ isub ] = ptr_in[ coord ][ point ];
+                  }
+                  isub++;
+               }
+            }
+         }
 
+         ps1 = UncLoop( unc, ptr_base, nrp, pset_sub, status );
+         ptr1 = astGetPoints( ps1 );
+         if( astOK ) {
+            isub = 0;
+            for ( point = 0; point < npoint; point++ ) {
+               if( near[ point ] < 0 ) {
+                  near[ point ] = ( ptr1[ 0 ][ isub++ ] == AST__BAD );
+               }
+            }
+         }
+         ps1 = astAnnul( ps1 );
+         pset_sub = astAnnul( pset_sub );
       }
 
 /* Re-instate the original centre coords of the uncertainty Region. */
       astRegCentre( unc, cen_orig, NULL, 0, AST__BASE );
       cen_orig = astFree( cen_orig );
 
-/* The ps1 PointSet will now be a copy of the supplied PointSet but with
-   positions set to bad if they are inside any of the re-centred uncertainty
-   Regions.  If this PointList has been negated, this is what we want so
-   we just transfer this bad position mask to the result PointSet. If this
-   PointList has not been negated we need to invert the bad position
-   mask. Get a pointer to the first axis of the resulting PointSet. */
-      ptr1 = astGetPoints( ps1 );
+/* A test point is in an un-negated PointList if it is inside any of the
+   re-centred uncertainty Regions. Store bad output values for all other
+   points, inverting the test if the PointList has been negated. */
       if( astOK ) {
-         mask = ptr1[ 0 ];
-
-/* Apply the mask to the returned PointSet, inverted if necessary. */
-         if( astGetNegated( this ) ) {
-            for ( point = 0; point < npoint; point++, mask++ ) {
-               if( *mask == AST__BAD ) {
-                  for( coord = 0; coord < ncoord_out; coord++ ) {
-                     ptr_out[ coord ][ point ] = AST__BAD;
-                  }
-               }
-            }
-
-         } else {
-            for ( point = 0; point < npoint; point++, mask++ ) {
-               if( *mask != AST__BAD ) {
-                  for( coord = 0; coord < ncoord_out; coord++ ) {
-                     ptr_out[ coord ][ point ] = AST__BAD;
-                  }
+         neg = astGetNegated( this );
+         for ( point = 0; point < npoint; point++ ) {
+            inside = near[ point ] ? !neg : neg;
+            if( !inside ) {
+               for( coord = 0; coord < ncoord_out; coord++ ) {
+                  ptr_out[ coord ][ point ] = AST__BAD;
                }
             }
          }
       }
+      near = astFree( near );
    }
 
 /* Clear the negated flag for the uncertainty Region. */
@@ -2584,8 +3318,6 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
    in_base = astAnnul( in_base );
    pset_base = astAnnul( pset_base );
    unc = astAnnul( unc );
-   if( ps2 ) ps2 = astAnnul( ps2 );
-   if( ps1 ) ps1 = astAnnul( ps1 );
 
 /* Annul the result if an error has occurred. */
    if( !astOK ) result = astAnnul( result );
@@ -2594,6 +3326,102 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
    return result;
 }
 
+static AstPointSet *UncLoop( AstRegion *unc, double **ptr_base, int nrp,
+                             AstPointSet *in, int *status ){
+/*
+*  Name:
+*     UncLoop
+
+*  Purpose:
+*     Find the test points that are close to a PointList by brute force.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "pointlist.h"
+*     AstPointSet *UncLoop( AstRegion *unc, double **ptr_base, int nrp,
+*                           AstPointSet *in, int *status )
+
+*  Class Membership:
+*     PointList member function
+
+*  Description:
+*     This function re-centres the uncertainty Region on each PointList
+*     position in turn, and uses it to transform the supplied test
+*     points. Bad values are accumulated in the returned PointSet. It is
+*     used when the k-d tree search in NearPoints is not possible.
+
+*  Parameters:
+*     unc
+*        Pointer to the uncertainty Region, with its Negated attribute set.
+*     ptr_base
+*        Pointers to the axis values of the PointList positions, in the
+*        base Frame of "unc".
+*     nrp
+*        The number of PointList positions.
+*     in
+*        The test points, in the current Frame of "unc".
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A new PointSet holding a copy of the test points, in which any
+*     point that is inside the uncertainty Region centred on any PointList
+*     position is set bad.
+
+*  Notes:
+*     - NULL is returned if this function is invoked with the global
+*     error status set, or if it should fail for any reason.
+*/
+
+/* Local Variables: */
+   AstPointSet *ps1;             /* Pointer to accumulation PointSet */
+   AstPointSet *ps2;             /* Pointer to accumulation PointSet */
+   AstPointSet *ps3;             /* Pointer for swapping PointSet pointers */
+   int point;                    /* Loop counter for points */
+
+/* Check the global error status. */
+   if ( !astOK ) return NULL;
+
+/* We use the supplied PointSet as the initial input to astTransform
+   below. Also indicate we currently have no output PointSet. This will
+   cause a new PointSet to be created on the first pass through the loop
+   below. */
+   ps1 = astClone( in );
+   ps2 = NULL;
+
+/* Loop round all the points in the PointList. */
+   for ( point = 0; point < nrp; point++ ) {
+
+/* Centre the uncertainty Region at this PointList position. Note, the
+   base Frame of the PointList should be the same as the current Frame
+   of the uncertainty Region. */
+      astRegCentre( unc, NULL, ptr_base, point, AST__BASE );
+
+/* Use the uncertainty Region to transform the supplied PointSet. This
+   will set supplied points bad if they are within the uncertainty Region
+   (since the uncertainty Region has been negated). */
+      ps2 = astTransform( unc, ps1, 0, ps2 );
+
+/* Use the output PointSet created above as the input for the next
+   position. This causes bad points to be accumulated in the output
+   PointSet. */
+      ps3 = ps2;
+      ps2 = ps1;
+      ps1 = ps3;
+   }
+
+/* Free resources. */
+   if( ps2 ) ps2 = astAnnul( ps2 );
+
+/* Annul the result if an error has occurred. */
+   if( !astOK && ps1 ) ps1 = astAnnul( ps1 );
+
+/* Return the result. */
+   return ps1;
+}
+
 /* Functions which access class attributes. */
 /* ---------------------------------------- */
 /* Implement member functions to access the attributes associated with
@@ -2673,6 +3501,9 @@ static void Copy( const AstObject *objin, AstObject *objout, int *status ) {
    the output PointList. */
    out->lbnd = NULL;
    out->ubnd = NULL;
+   out->kdpos = NULL;
+   out->kdindex = NULL;
+   out->kdaxis = NULL;
 
 /* Copy dynamic memory contents */
    if( in->lbnd && in->ubnd ) {
@@ -2722,6 +3553,9 @@ static void Delete( AstObject *obj, int *status ) {
 /* Annul all resources. */
    this->lbnd = astFree( this->lbnd );
    this->ubnd = astFree( this->ubnd );
+   this->kdpos = astFree( this->kdpos );
+   this->kdindex = astFree( this->kdindex );
+   this->kdaxis = astFree( this->kdaxis );
 }
 
 /* Dump function. */
@@ -3241,6 +4075,10 @@ AstPointList *astInitPointList_( void *mem, size_t size, int init,
 /* ------------------------------ */
          new->lbnd = NULL;
          new->ubnd = NULL;
+         new->kdpos = NULL;
+         new->kdindex = NULL;
+         new->kdaxis = NULL;
+         new->kdsky = 0;
 
 /* If an error occurred, clean up by deleting the new PointList. */
          if ( !astOK ) new = astDelete( new );
@@ -3361,6 +4199,14 @@ AstPointList *astLoadPointList_( void *mem, size_t size, AstPointListVtab *vtab,
 
    if ( astOK ) {
 
+/* Initialise the cached values. */
+      new->lbnd = NULL;
+      new->ubnd = NULL;
+      new->kdpos = NULL;
+      new->kdindex = NULL;
+      new->kdaxis = NULL;
+      new->kdsky = 0;
+
 /* Read input data. */
 /* ================ */
 /* Request the input Channel to read all the input data appropriate to
@@ -100,6 +100,10 @@ typedef struct AstPointList {
 /* Attributes specific to objects in this class. */
    double *lbnd;              /* Lower axis limits of bounding box */
    double *ubnd;              /* Upper axis limits of bounding box */
+   double *kdpos;             /* Coords of each k-d tree node */
+   int *kdindex;              /* Index of the point at each k-d tree node */
+   int *kdaxis;               /* Axis split at each k-d tree node */
+   int kdsky;                 /* Are k-d tree coords 3-D unit vectors? */
 } AstPointList;
 
 /* Virtual function table. */
@@ -169,6 +169,7 @@ f     - AST_OUTLINE<X>: Create a Polygon outlining values in a pixel array
 #include "unitmap.h"             /* Unit Mapping */
 #include "pal.h"                 /* SLALIB library interface */
 #include "frame.h"               /* Coordinate system description */
+#include "skyframe.h"            /* Celestial coordinate systems */
 
 /* Error code definitions. */
 /* ----------------------- */
@@ -196,10 +197,37 @@ typedef struct Segment {
    int i2;        /* Index of ending vertex within old Polygon */
    double error;  /* Max geodesic distance from any old vertex to the line */
    int imax;      /* Index of the old vertex at which max error is reached */
-   struct Segment *next;/* Pointer to next Segment in a double link list */
-   struct Segment *prev;/* Pointer to previous Segment in a double link list */
+   int order;     /* Number of Segments added to the heap before this one */
 } Segment;
 
+/* A structure that describes one of the independent parts of the
+   search for the convex hull of the selected pixels in an array. Each
+   part either finds one edge of the bounding box of the selected pixels
+   (using FindBoxEdge), or finds the vertices of the hull within one
+   corner of the bounding box (using PartHull). The parts are run in
+   parallel using astRunJobs. */
+typedef struct HullPart {
+   const void *value;   /* Pointer to the value defining selected pixels */
+   const void *array;   /* Pointer to the array of pixel values */
+   const int *lbnd;     /* Lower pixel index bounds of the array */
+   int xdim;            /* Number of pixels in each row */
+   int ydim;            /* Number of rows */
+   int starpix;         /* Use Starlink pixel coordinates? */
+   int edge;            /* Find a box edge rather than part of the hull? */
+   int axis;            /* FindBoxEdge: Edge is parallel to the X axis? */
+   int low;             /* FindBoxEdge: Find the lower edge? */
+   int val;             /* FindBoxEdge: Returned axis value */
+   int valmax;          /* FindBoxEdge: Returned max. other axis value */
+   int valmin;          /* FindBoxEdge: Returned min. other axis value */
+   int xs;              /* PartHull: X index of starting pixel */
+   int ys;              /* PartHull: Y index of starting pixel */
+   int xe;              /* PartHull: X index of ending pixel */
+   int ye;              /* PartHull: Y index of ending pixel */
+   double *xv;          /* PartHull: Returned X vertex values */
+   double *yv;          /* PartHull: Returned Y vertex values */
+   int nv;              /* PartHull: Returned number of vertices */
+} HullPart;
+
 
 /* Module Variables. */
 /* ================= */
@@ -427,20 +455,25 @@ static AstPointSet *DownsizePoly( AstPointSet *, double, int, AstFrame *, int *
 static AstPointSet *RegBaseMesh( AstRegion *, int * );
 static AstPointSet *Transform( AstMapping *, AstPointSet *, int, AstPointSet *, int * );
 static AstPolygon *Downsize( AstPolygon *, double, int, int * );
-static Segment *AddToChain( Segment *, Segment *, int * );
+static Segment *HeapPop( Segment **, int *, int * );
 static Segment *NewSegment( Segment *, int, int, int, int * );
-static Segment *RemoveFromChain( Segment *, Segment *, int * );
 static double Polywidth( AstFrame *, AstLineDef **, int, int, double[ 2 ], int * );
 static int GetBounded( AstRegion *, int * );
 static int IntCmp( const void *, const void * );
+static int IndexParity( AstPolygon *, AstFrame *, const double[ 2 ], int * );
 static int RegPins( AstRegion *, AstPointSet *, AstRegion *, int **, int * );
+static int RegLineCross( AstRegion *, const double[], const double[], double **, int * );
 static int RegTrace( AstRegion *, int, double *, double **, int * );
+static int SegAbove( Segment *, Segment * );
 static void Cache( AstPolygon *, int * );
 static void Copy( const AstObject *, AstObject *, int * );
 static void Delete( AstObject *, int * );
 static void Dump( AstObject *, AstChannel *, int * );
 static void EnsureInside( AstPolygon *, int * );
 static void FindMax( Segment *, AstFrame *, double *, double *, int, int, int * );
+static void FreeIndex( AstPolygon *, int * );
+static void HeapPush( Segment **, int *, int *, Segment *, int * );
+static void IndexEdges( AstPolygon *, AstFrame *, int, int * );
 static void RegBaseBox( AstRegion *this, double *, double *, int * );
 static void ResetCache( AstRegion *this, int * );
 static void SetPointSet( AstPolygon *, AstPointSet *, int * );
@@ -460,92 +493,6 @@ static void SetSimpVertices( AstPolygon *, int, int * );
 
 /* Member functions. */
 /* ================= */
-static Segment *AddToChain( Segment *head, Segment *seg, int *status ){
-/*
-*  Name:
-*     AddToChain
-
-*  Purpose:
-*     Add a Segment into the linked list of Segments, maintaining the
-*     required order in the list.
-
-*  Type:
-*     Private function.
-
-*  Synopsis:
-*     #include "polygon.h"
-*     Segment *AddToChain( Segment *head, Segment *seg, int *status )
-
-*  Class Membership:
-*     Polygon member function
-
-*  Description:
-*     The linked list of Segments maintained by astDownsize is searched
-*     from the high error end (the head), until a Segment is foound which
-*     has a lower error than the supplied segment. The supplied Segment
-*     is then inserted into the list at that point.
-
-*  Parameters:
-*     head
-*        The Segment structure at the head of the list (i.e. the segment
-*        with maximum error).
-*     seg
-*        The Segment to be added into the list.
-*     status
-*        Pointer to the inherited status variable.
-
-*  Returned Value:
-*     Pointer to the link head (which will have changed if "seg" has a
-*     higher error than the original head).
-
-*/
-
-/* Local Variables: */
-   Segment *tseg;
-
-/* Check the global error status. */
-   if ( !astOK ) return head;
-
-/* If the list is empty, return the supplied segment as the new list
-   head. */
-   if( !head ) {
-      head = seg;
-
-/* If the supplied segment has a higher error than the original head,
-   insert the new segment in front of the original head. */
-   } else if( seg->error > head->error ){
-      seg->next = head;
-      head->prev = seg;
-      head = seg;
-
-/* Otherwise, move down the list from the head until a segment is found
-   which has a lower error than the supplied Segment. Then insert the
-   supplied segment into the list in front of it. */
-   } else {
-      tseg = head;
-      seg->next = NULL;
-
-      while( tseg->next ) {
-         if( seg->error > tseg->next->error ) {
-            seg->next = tseg->next;
-            seg->prev = tseg;
-            tseg->next->prev = seg;
-            tseg->next = seg;
-            break;
-         }
-         tseg = tseg->next;
-      }
-
-      if( !seg->next ) {
-         tseg->next = seg;
-         seg->prev = tseg;
-      }
-   }
-
-/* Return the new head. */
-   return head;
-}
-
 static void Cache( AstPolygon *this, int *status ){
 /*
 *  Name:
@@ -675,6 +622,14 @@ static void Cache( AstPolygon *this, int *status ){
          } else {
             this->acw = 1;
          }
+
+/* If the edges are straight lines in the base Frame (i.e. the base Frame
+   is not a SkyFrame, and does not delegate its geometry to some other
+   Frame), build an index of the edges that can be used to speed up
+   point-in-polygon tests. */
+         FreeIndex( this, status );
+         if( !astIsASkyFrame( frm ) && !astIsARegion( frm ) &&
+             !astIsAFrameSet( frm ) ) IndexEdges( this, frm, nv, status );
       }
 
 /* Free resources */
@@ -890,6 +845,11 @@ c     - NULL
 f     - AST__NULL
 *     will be returned if this function is invoked with the global
 *     error status set, or if it should fail for any reason.
+*     - If AST was built with POSIX threads support, different parts
+*     of the hull may be found in parallel. The number of threads to
+*     use is given by the AST_NTHREAD environment variable (the default
+*     is to use a single thread). The returned Polygon does not depend
+*     on the number of threads used.
 
 *  Data Type Codes:
 *     To select the appropriate masking function, you should
@@ -1075,35 +1035,54 @@ MAKE_CONVEX(F,float)
 *     error occurs.
 
 *  Notes:
-*     - The following code has been designed with a view to it being
-*     multi-threaded at some point.
+*     - The three remaining edges of the bounding box, and then the
+*     four corners of the hull, are independent of each other. Each set
+*     is found in parallel using astRunJobs, so the returned vertices do
+*     not depend on the number of threads used.
 
 */
 
 /* Define a macro to implement the function for a specific data
-   type and operation. */
+   type and operation. The macro also defines function HullPart<Oper><X>,
+   which is run by astRunJobs to find one part of the hull described by
+   a HullPart structure. */
 #define MAKE_CONVEXHULL(X,Xtype,Oper,OperI) \
+static void HullPart##Oper##X( void *data, int *status ) { \
+\
+/* Local Variables: */ \
+   HullPart *part; \
+\
+/* Check the global error status. */ \
+   if ( !astOK ) return; \
+\
+/* Find an edge of the bounding box, or the vertices within one corner \
+   of the bounding box, as required. */ \
+   part = (HullPart *) data; \
+   if( part->edge ) { \
+      FindBoxEdge##Oper##X( *( (const Xtype *) part->value ), \
+                            (const Xtype *) part->array, part->xdim, \
+                            part->ydim, part->axis, part->low, &part->val, \
+                            &part->valmax, &part->valmin, status ); \
+   } else { \
+      PartHull##Oper##X( *( (const Xtype *) part->value ), \
+                         (const Xtype *) part->array, part->xdim, \
+                         part->ydim, part->xs, part->ys, part->xe, part->ye, \
+                         part->starpix, part->lbnd, &part->xv, &part->yv, \
+                         &part->nv, status ); \
+   } \
+} \
+\
 static AstPointSet *ConvexHull##Oper##X( Xtype value, const Xtype array[], \
                                          const int lbnd[2], int starpix, \
                                          int xdim, int ydim, int *status ) { \
 \
 /* Local Variables: */ \
    AstPointSet *result; \
+   HullPart part[ 4 ]; \
    double **ptr; \
-   double *xv1; \
-   double *xv2; \
-   double *xv3; \
-   double *xv4; \
    double *xvert; \
-   double *yv1; \
-   double *yv2; \
-   double *yv3; \
-   double *yv4; \
    double *yvert; \
-   int nv1; \
-   int nv2; \
-   int nv3; \
-   int nv4; \
+   int i; \
    int nv; \
    int xhi; \
    int xhiymax; \
@@ -1132,78 +1111,101 @@ static AstPointSet *ConvexHull##Oper##X( Xtype value, const Xtype array[], \
 /* Skip if there are no selected values in the array. */ \
    if( ylo > 0 ) { \
 \
+/* Initialise the descriptions of the parts of the hull. */ \
+      memset( part, 0, sizeof( part ) ); \
+      for( i = 0; i < 4; i++ ) { \
+         part[ i ].value = &value; \
+         part[ i ].array = array; \
+         part[ i ].lbnd = lbnd; \
+         part[ i ].xdim = xdim; \
+         part[ i ].ydim = ydim; \
+         part[ i ].starpix = starpix; \
+      } \
+\
 /* Find the highest Y value at any selected pixel, and find the max and \
    min X value of the selected pixels at that highest Y value. */ \
-      FindBoxEdge##Oper##X( value, array, xdim, ydim, 1, 0, &yhi, &yhixmax,  \
-                            &yhixmin, status ); \
+      part[ 0 ].edge = 1; \
+      part[ 0 ].axis = 1; \
+      part[ 0 ].low = 0; \
 \
 /* Find the lowest X value at any selected pixel, and find the max and \
    min Y value of the selected pixels at that lowest X value. */ \
-      FindBoxEdge##Oper##X( value, array, xdim, ydim, 0, 1, &xlo, &xloymax,  \
-                            &xloymin, status ); \
+      part[ 1 ].edge = 1; \
+      part[ 1 ].axis = 0; \
+      part[ 1 ].low = 1; \
 \
 /* Find the highest X value at any selected pixel, and find the max and \
    min Y value of the selected pixels at that highest X value. */ \
-      FindBoxEdge##Oper##X( value, array, xdim, ydim, 0, 0, &xhi, &xhiymax,  \
-                            &xhiymin, status ); \
+      part[ 2 ].edge = 1; \
+      part[ 2 ].axis = 0; \
+      part[ 2 ].low = 0; \
+\
+/* Find these three edges in parallel. */ \
+      astRunJobs( 3, HullPart##Oper##X, part, sizeof( HullPart ) ); \
+      yhi = part[ 0 ].val; \
+      yhixmax = part[ 0 ].valmax; \
+      yhixmin = part[ 0 ].valmin; \
+      xlo = part[ 1 ].val; \
+      xloymax = part[ 1 ].valmax; \
+      xloymin = part[ 1 ].valmin; \
+      xhi = part[ 2 ].val; \
+      xhiymax = part[ 2 ].valmax; \
+      xhiymin = part[ 2 ].valmin; \
 \
 /* Create a list of vertices for the bottom right corner of the bounding \
    box of the selected pixels. */ \
-      PartHull##Oper##X( value, array, xdim, ydim, yloxmax, ylo, xhi, xhiymin, \
-                         starpix, lbnd, &xv1, &yv1, &nv1, status ); \
+      for( i = 0; i < 4; i++ ) part[ i ].edge = 0; \
+      part[ 0 ].xs = yloxmax; \
+      part[ 0 ].ys = ylo; \
+      part[ 0 ].xe = xhi; \
+      part[ 0 ].ye = xhiymin; \
 \
 /* Create a list of vertices for the top right corner of the bounding \
    box of the selected pixels. */ \
-      PartHull##Oper##X( value, array, xdim, ydim, xhi, xhiymax, yhixmax, yhi, \
-                         starpix, lbnd, &xv2, &yv2, &nv2, status ); \
+      part[ 1 ].xs = xhi; \
+      part[ 1 ].ys = xhiymax; \
+      part[ 1 ].xe = yhixmax; \
+      part[ 1 ].ye = yhi; \
 \
 /* Create a list of vertices for the top left corner of the bounding \
    box of the selected pixels. */ \
-      PartHull##Oper##X( value, array, xdim, ydim, yhixmin, yhi, xlo, xloymax, \
-                         starpix, lbnd, &xv3, &yv3, &nv3, status ); \
+      part[ 2 ].xs = yhixmin; \
+      part[ 2 ].ys = yhi; \
+      part[ 2 ].xe = xlo; \
+      part[ 2 ].ye = xloymax; \
 \
 /* Create a list of vertices for the bottom left corner of the bounding \
    box of the selected pixels. */ \
-      PartHull##Oper##X( value, array, xdim, ydim, xlo, xloymin, yloxmin, ylo, \
-                         starpix, lbnd, &xv4, &yv4, &nv4, status ); \
+      part[ 3 ].xs = xlo; \
+      part[ 3 ].ys = xloymin; \
+      part[ 3 ].xe = yloxmin; \
+      part[ 3 ].ye = ylo; \
+\
+/* Find the vertices in the four corners in parallel. */ \
+      astRunJobs( 4, HullPart##Oper##X, part, sizeof( HullPart ) ); \
 \
 /* Concatenate the four vertex lists and store them in the returned \
    PointSet. */ \
-      nv =  nv1 + nv2 + nv3 + nv4; \
+      nv = part[ 0 ].nv + part[ 1 ].nv + part[ 2 ].nv + part[ 3 ].nv; \
       result = astPointSet( nv, 2, " ", status ); \
       ptr = astGetPoints( result ); \
       if( astOK ) { \
          xvert = ptr[ 0 ]; \
          yvert = ptr[ 1 ]; \
 \
-         memcpy( xvert, xv1, nv1*sizeof( double ) ); \
-         memcpy( yvert, yv1, nv1*sizeof( double ) ); \
-         xvert += nv1; \
-         yvert += nv1; \
-\
-         memcpy( xvert, xv2, nv2*sizeof( double ) ); \
-         memcpy( yvert, yv2, nv2*sizeof( double ) ); \
-         xvert += nv2; \
-         yvert += nv2; \
-\
-         memcpy( xvert, xv3, nv3*sizeof( double ) ); \
-         memcpy( yvert, yv3, nv3*sizeof( double ) ); \
-         xvert += nv3; \
-         yvert += nv3; \
-\
-         memcpy( xvert, xv4, nv4*sizeof( double ) ); \
-         memcpy( yvert, yv4, nv4*sizeof( double ) ); \
+         for( i = 0; i < 4; i++ ) { \
+            memcpy( xvert, part[ i ].xv, part[ i ].nv*sizeof( double ) ); \
+            memcpy( yvert, part[ i ].yv, part[ i ].nv*sizeof( double ) ); \
+            xvert += part[ i ].nv; \
+            yvert += part[ i ].nv; \
+         } \
       } \
 \
 /* Free resources. */ \
-      xv1 = astFree( xv1 ); \
-      xv2 = astFree( xv2 ); \
-      xv3 = astFree( xv3 ); \
-      xv4 = astFree( xv4 ); \
-      yv1 = astFree( yv1 ); \
-      yv2 = astFree( yv2 ); \
-      yv3 = astFree( yv3 ); \
-      yv4 = astFree( yv4 ); \
+      for( i = 0; i < 4; i++ ) { \
+         part[ i ].xv = astFree( part[ i ].xv ); \
+         part[ i ].yv = astFree( part[ i ].yv ); \
+      } \
    } \
 \
 /* Free the returned PointSet if an error occurred. */ \
@@ -1405,7 +1407,7 @@ static AstPointSet *DownsizePoly( AstPointSet *pset, double maxerr,
 
 /* Local Variables: */
    AstPointSet *result;   /* Returned pointer to new PointSet */
-   Segment *head;         /* Pointer to new polygon edge with highest error */
+   Segment **heap;        /* Heap of new polygon edges ordered by error */
    Segment *seg1;         /* Pointer to new polygon edge */
    Segment *seg2;         /* Pointer to new polygon edge */
    Segment *seg3;         /* Pointer to new polygon edge */
@@ -1429,6 +1431,8 @@ static AstPointSet *DownsizePoly( AstPointSet *pset, double maxerr,
    int iadd;              /* Normalised vertex index */
    int iat;               /* Index at which to store new vertex index */
    int newlen;            /* Number of vertices currently in new Polygon */
+   int nheap;             /* Number of edges in the heap */
+   int norder;            /* Number of edges added to the heap so far */
    int nv;                /* Number of vertices in old Polygon */
 
 /* Initialise. */
@@ -1460,6 +1464,12 @@ static AstPointSet *DownsizePoly( AstPointSet *pset, double maxerr,
    needed. */
       newpoly = astMalloc( 10*sizeof( int ) );
 
+/* Allocate memory for the heap of edges in the new Polygon. The new
+   Polygon can never have more edges than the old Polygon has vertices. */
+      heap = astMalloc( sizeof( Segment * )*(size_t) nv );
+      nheap = 0;
+      norder = 0;
+
 /* Check the pointers can be used safely. */
       if( astOK ) {
 
@@ -1572,12 +1582,12 @@ static AstPointSet *DownsizePoly( AstPointSet *pset, double maxerr,
    occurred. */
          FindMax( seg3, frm, x, y, nv, 1, status );
 
-/* The "head" variable points to the head of a double linked list of
-   Segment structures. This list is ordered by residual, so that the
-   Segment with the maximum residual is at the head, and the Segment
-   with the minimum residual is at the tail. Initially "seg3" is at the
-   head. */
-         head = seg3;
+/* The "heap" array holds a binary heap of Segment structures, ordered by
+   residual, so that the Segment with the maximum residual is always at
+   the top (element zero). Adding or removing a Segment costs O(log n),
+   rather than the O(n) needed to keep a sorted list. Initially "seg3" is
+   at the top. */
+         HeapPush( heap, &nheap, &norder, seg3, status );
 
 /* Search the old vertices between the start and end of segment 1, looking
    for the vertex which lies furthest from the line of segment 1. The
@@ -1586,14 +1596,14 @@ static AstPointSet *DownsizePoly( AstPointSet *pset, double maxerr,
    occurred. */
          FindMax( seg1, frm, x, y, nv, 1, status );
 
-/* Insert segment 1 into the linked list of Segments, at a position that
-   maintains the ordering of the segments by error. Thus the head of the
-   list will still have the max error. */
-         head = AddToChain( head, seg1, status );
+/* Add segment 1 into the heap of Segments, at a position that maintains
+   the ordering of the segments by error. Thus the top of the heap will
+   still have the max error. */
+         HeapPush( heap, &nheap, &norder, seg1, status );
 
 /* Do the same for segment 2. */
          FindMax( seg2, frm, x, y, nv, 1, status );
-         head = AddToChain( head, seg2, status );
+         HeapPush( heap, &nheap, &norder, seg2, status );
 
 /* If the maximum allowed number of vertices in the output Polygon is
    less than 3, allow any number of vertices up to the number in the
@@ -1604,16 +1614,16 @@ static AstPointSet *DownsizePoly( AstPointSet *pset, double maxerr,
    maximum residual between the new and old polygons is no more than
    "maxerr". Abort early if the specified maximum number of vertices is
    reached. */
-         while( head->error > maxerr && newlen < maxvert ) {
+         while( astOK && heap[ 0 ]->error > maxerr && newlen < maxvert ) {
 
-/* The segment at the head of the list has the max error (that is, it is
+/* The segment at the top of the heap has the max error (that is, it is
    the segment that departs most from the supplied Polygon). To make the
    new polygon a better fit to the old polygon, we add the vertex that is
    furthest away from this segment to the new polygon. Remember that a
    polygon is cyclic so if the vertex has an index that is greater than the
    number of vertices in the old polygon, reduce the index by the number
    of vertices in the old polygon. */
-            iadd = head->imax;
+            iadd = heap[ 0 ]->imax;
             if( iadd >= nv ) iadd -= nv;
             iat = newlen++;
             newpoly = astGrow( newpoly, newlen, sizeof( int ) );
@@ -1621,33 +1631,28 @@ static AstPointSet *DownsizePoly( AstPointSet *pset, double maxerr,
             newpoly[ iat ] = iadd;
 
 /* We now split the segment that had the highest error into two segments.
-   The split occurs at the vertex that had the highest error. */
-            seg1 = NewSegment( NULL, head->imax, head->i2, nv, status );
-            seg2 = head;
-            seg2->i2 = head->imax;
-
-/* We do not know where these two new segments should be in the ordered
-   linked list, so remove them from the list. */
-            head = RemoveFromChain( head, seg1, status );
-            head = RemoveFromChain( head, seg2, status );
+   The split occurs at the vertex that had the highest error. We do not
+   know where these two new segments should be in the heap, so remove the
+   original segment from the heap. */
+            seg2 = HeapPop( heap, &nheap, status );
+            seg1 = NewSegment( NULL, seg2->imax, seg2->i2, nv, status );
+            seg2->i2 = seg2->imax;
 
 /* Find the vertex that deviates most from the first of these two new
-   segments, and then add the segment into the list of vertices, using
-   the maximum deviation to determine the position of the segment within
-   the list. */
+   segments, and then add the segment into the heap, using the maximum
+   deviation to determine the position of the segment within the heap. */
             FindMax( seg1, frm, x, y, nv, 1, status );
-            head = AddToChain( head, seg1, status );
+            HeapPush( heap, &nheap, &norder, seg1, status );
 
 /* Do the same for the second new segment. */
             FindMax( seg2, frm, x, y, nv, 1, status );
-            head = AddToChain( head, seg2, status );
+            HeapPush( heap, &nheap, &norder, seg2, status );
          }
 
 /* Now we have reached the required accuracy, free resources. */
-         while( head ) {
-            seg1 = head;
-            head = head->next;
-            seg1 = astFree( seg1 );
+         while( nheap > 0 ) {
+            nheap--;
+            heap[ nheap ] = astFree( heap[ nheap ] );
          }
 
 /* If no vertices have been left out, return a deep copy of the supplied
@@ -1679,6 +1684,7 @@ static AstPointSet *DownsizePoly( AstPointSet *pset, double maxerr,
 
 /* Free resources. */
       newpoly = astFree( newpoly );
+      heap = astFree( heap );
    }
 
 /* If an error occurred, annul the returned PointSet. */
@@ -2555,6 +2561,44 @@ static void FindMax( Segment *seg, AstFrame *frm, double *x, double *y,
    }
 }
 
+static void FreeIndex( AstPolygon *this, int *status ){
+/*
+*  Name:
+*     FreeIndex
+
+*  Purpose:
+*     Free the edge index stored in a Polygon.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "polygon.h"
+*     void FreeIndex( AstPolygon *this, int *status )
+
+*  Class Membership:
+*     Polygon member function
+
+*  Description:
+*     This function frees the arrays holding the edge index created by
+*     IndexEdges, and indicates that no index is available.
+
+*  Parameters:
+*     this
+*        Pointer to the Polygon.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Notes:
+*     - This function attempts to execute even if the global error status
+*     is set.
+*/
+
+   this->bandstart = astFree( this->bandstart );
+   this->bandedge = astFree( this->bandedge );
+   this->nband = 0;
+}
+
 static const char *GetAttrib( AstObject *this_object, const char *attrib, int *status ) {
 /*
 *  Name:
@@ -2811,6 +2855,7 @@ void astInitPolygonVtab_(  AstPolygonVtab *vtab, const char *name, int *status )
    region->RegPins = RegPins;
    region->RegBaseMesh = RegBaseMesh;
    region->RegBaseBox = RegBaseBox;
+   region->RegLineCross = RegLineCross;
    region->RegTrace = RegTrace;
    region->GetBounded = GetBounded;
 
@@ -2837,6 +2882,374 @@ void astInitPolygonVtab_(  AstPolygonVtab *vtab, const char *name, int *status )
    }
 }
 
+static Segment *HeapPop( Segment **heap, int *nheap, int *status ){
+/*
+*  Name:
+*     HeapPop
+
+*  Purpose:
+*     Remove the Segment with the highest error from the heap maintained
+*     by astDownsize.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "polygon.h"
+*     Segment *HeapPop( Segment **heap, int *nheap, int *status )
+
+*  Class Membership:
+*     Polygon member function
+
+*  Description:
+*     The Segment at the top of the heap (the Segment with the highest
+*     error) is removed from the heap and returned. The heap is then
+*     re-ordered so that the Segment with the highest remaining error is
+*     at the top. See HeapPush for the ordering.
+
+*  Parameters:
+*     heap
+*        The array of Segment pointers forming the heap.
+*     nheap
+*        Pointer to the number of Segments in the heap. Decremented on
+*        exit.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Pointer to the removed Segment, or NULL if the heap was empty.
+
+*/
+
+/* Local Variables: */
+   Segment *result;
+   Segment *seg;
+   int child;
+   int i;
+   int n;
+
+/* Check the global error status. */
+   if ( !astOK || *nheap < 1 ) return NULL;
+
+/* The top of the heap is returned. */
+   result = heap[ 0 ];
+
+/* Move the last Segment in the heap down from the top until it is above
+   both its children. */
+   n = --(*nheap);
+   if( n > 0 ) {
+      seg = heap[ n ];
+      i = 0;
+      while( ( child = 2*i + 1 ) < n ) {
+         if( child + 1 < n && SegAbove( heap[ child + 1 ], heap[ child ] ) ) child++;
+         if( !SegAbove( heap[ child ], seg ) ) break;
+         heap[ i ] = heap[ child ];
+         i = child;
+      }
+      heap[ i ] = seg;
+   }
+
+/* Return the removed Segment. */
+   return result;
+}
+
+static void HeapPush( Segment **heap, int *nheap, int *norder, Segment *seg,
+                      int *status ){
+/*
+*  Name:
+*     HeapPush
+
+*  Purpose:
+*     Add a Segment into the heap maintained by astDownsize.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "polygon.h"
+*     void HeapPush( Segment **heap, int *nheap, int *norder, Segment *seg,
+*                    int *status )
+
+*  Class Membership:
+*     Polygon member function
+
+*  Description:
+*     The supplied Segment is added into a binary heap of Segments, in
+*     which each Segment is above its two children. A Segment is above
+*     another if it has a higher error or, for equal errors, if it was
+*     added to the heap first. So Segments leave the heap in the same
+*     order as they would leave a list sorted by error in which new
+*     Segments are inserted after all Segments with equal error.
+
+*  Parameters:
+*     heap
+*        The array of Segment pointers forming the heap. It must have room
+*        for the new Segment.
+*     nheap
+*        Pointer to the number of Segments in the heap. Incremented on
+*        exit.
+*     norder
+*        Pointer to the number of Segments added to the heap so far.
+*        Incremented on exit.
+*     seg
+*        The Segment to be added into the heap.
+*     status
+*        Pointer to the inherited status variable.
+
+*/
+
+/* Local Variables: */
+   int i;
+   int parent;
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Record the order in which the Segment was added. */
+   seg->order = (*norder)++;
+
+/* Move the new Segment up from the bottom of the heap until it is below
+   its parent. */
+   i = (*nheap)++;
+   while( i > 0 ) {
+      parent = ( i - 1 )/2;
+      if( !SegAbove( seg, heap[ parent ] ) ) break;
+      heap[ i ] = heap[ parent ];
+      i = parent;
+   }
+   heap[ i ] = seg;
+}
+
+static void IndexEdges( AstPolygon *this, AstFrame *frm, int nv, int *status ){
+/*
+*  Name:
+*     IndexEdges
+
+*  Purpose:
+*     Create an index of the Polygon edges for point-in-polygon tests.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "polygon.h"
+*     void IndexEdges( AstPolygon *this, AstFrame *frm, int nv, int *status )
+
+*  Class Membership:
+*     Polygon member function
+
+*  Description:
+*     This function divides the range of axis 2 values covered by the
+*     Polygon into a set of equal width bands, and records the edges that
+*     overlap each band. The index is stored in the Polygon structure and
+*     is used by IndexParity to find the edges that may contain, or be
+*     crossed by a horizontal line through, a given test point without
+*     checking every edge. The index should only be created if the edges
+*     are straight lines in the base Frame (i.e. if the base Frame uses
+*     the astLineContains and astLineCrossing methods inherited from the
+*     Frame class).
+
+*  Parameters:
+*     this
+*        Pointer to the Polygon. The "edges" and "in" components should
+*        already have been set up.
+*     frm
+*        Pointer to the base Frame of the Polygon.
+*     nv
+*        The number of vertices (and edges) in the Polygon.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Notes:
+*     - No index is created if any edge is undefined.
+*/
+
+/* Local Variables: */
+   AstLineDef *e;       /* Pointer to current edge */
+   double maxtol;       /* Largest edge tolerance */
+   double tol;          /* Tolerance used by astLineContains for an edge */
+   double ymax;         /* Largest axis 2 value of any vertex */
+   double ymin;         /* Smallest axis 2 value of any vertex */
+   int *next;           /* Next free entry for each band */
+   int ib;              /* Band index */
+   int ib1;             /* Index of first band overlapping an edge */
+   int ib2;             /* Index of last band overlapping an edge */
+   int iv;              /* Edge index */
+   int nband;           /* Number of bands */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Find the range of axis 2 values covered by the edges. Each edge is
+   widened by the tolerance used by astLineContains (1.0E-7 of the edge
+   length), so that any point that may be on the edge is within the
+   index. */
+   ymin = DBL_MAX;
+   ymax = -DBL_MAX;
+   maxtol = 0.0;
+   for( iv = 0; iv < nv; iv++ ) {
+      e = this->edges[ iv ];
+      if( !e ) return;
+      tol = 1.0E-7*e->length;
+      if( tol > maxtol ) maxtol = tol;
+      if( e->start[ 1 ] < ymin ) ymin = e->start[ 1 ];
+      if( e->start[ 1 ] > ymax ) ymax = e->start[ 1 ];
+   }
+   if( nv <= 0 ) return;
+
+/* Use one band per edge. */
+   nband = nv;
+   this->band0 = ymin - maxtol;
+   this->bandwid = ( ymax + maxtol - this->band0 )/nband;
+   if( this->bandwid <= 0.0 ) {
+      nband = 1;
+      this->bandwid = 1.0;
+   }
+
+/* Count the edges overlapping each band, using "bandstart[ ib + 1 ]". */
+   this->bandstart = astCalloc( nband + 1, sizeof( int ) );
+   if( astOK ) {
+      for( iv = 0; iv < nv; iv++ ) {
+         e = this->edges[ iv ];
+         tol = 1.0E-7*e->length;
+         ib1 = (int)( ( astMIN( e->start[ 1 ], e->end[ 1 ] ) - tol -
+                        this->band0 )/this->bandwid );
+         ib2 = (int)( ( astMAX( e->start[ 1 ], e->end[ 1 ] ) + tol -
+                        this->band0 )/this->bandwid );
+         if( ib1 < 0 ) ib1 = 0;
+         if( ib2 >= nband ) ib2 = nband - 1;
+         for( ib = ib1; ib <= ib2; ib++ ) this->bandstart[ ib + 1 ]++;
+      }
+
+/* Convert the counts into offsets, and allocate the array of edge
+   indices. */
+      for( ib = 0; ib < nband; ib++ ) {
+         this->bandstart[ ib + 1 ] += this->bandstart[ ib ];
+      }
+      this->bandedge = astMalloc( sizeof( int )*(size_t) this->bandstart[ nband ] );
+      next = astStore( NULL, this->bandstart, sizeof( int )*(size_t) nband );
+
+/* Store the index of each edge in every band it overlaps. */
+      if( astOK ) {
+         for( iv = 0; iv < nv; iv++ ) {
+            e = this->edges[ iv ];
+            tol = 1.0E-7*e->length;
+            ib1 = (int)( ( astMIN( e->start[ 1 ], e->end[ 1 ] ) - tol -
+                           this->band0 )/this->bandwid );
+            ib2 = (int)( ( astMAX( e->start[ 1 ], e->end[ 1 ] ) + tol -
+                           this->band0 )/this->bandwid );
+            if( ib1 < 0 ) ib1 = 0;
+            if( ib2 >= nband ) ib2 = nband - 1;
+            for( ib = ib1; ib <= ib2; ib++ ) this->bandedge[ next[ ib ]++ ] = iv;
+         }
+      }
+      next = astFree( next );
+   }
+
+/* Record the number of bands, and the crossing parity for the inside
+   point. If anything went wrong, free the index so that the Polygon
+   falls back to checking every edge. */
+   if( astOK ) {
+      this->nband = nband;
+      this->inpar = IndexParity( this, frm, this->in, status );
+      if( this->inpar == ON ) FreeIndex( this, status );
+   } else {
+      FreeIndex( this, status );
+   }
+}
+
+static int IndexParity( AstPolygon *this, AstFrame *frm, const double p[ 2 ],
+                        int *status ){
+/*
+*  Name:
+*     IndexParity
+
+*  Purpose:
+*     Use the edge index to find the crossing parity for a point.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "polygon.h"
+*     int IndexParity( AstPolygon *this, AstFrame *frm, const double p[ 2 ],
+*                      int *status )
+
+*  Class Membership:
+*     Polygon member function
+
+*  Description:
+*     This function uses the edge index created by IndexEdges to count
+*     the edges crossed by a line that starts at the supplied point and
+*     runs parallel to axis 1 towards +infinity. Two points are on the
+*     same side of the Polygon boundary if their counts have the same
+*     parity. Only the edges in the band containing the point are checked.
+
+*  Parameters:
+*     this
+*        Pointer to the Polygon. It should contain an edge index.
+*     frm
+*        Pointer to the base Frame of the Polygon.
+*     p
+*        The base Frame position to test. Both axis values should be good.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     ON if the point is on one of the edges (as determined by
+*     astLineContains), and otherwise zero or one giving the parity of
+*     the number of edges crossed.
+*/
+
+/* Local Variables: */
+   AstLineDef *e;       /* Pointer to current edge */
+   double tol;          /* Tolerance used by astLineContains for an edge */
+   double xcross;       /* Axis 1 value at which the edge is crossed */
+   int ib;              /* Band index */
+   int k;               /* Index into "bandedge" array */
+   int ncross;          /* Number of crossings */
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* Find the band containing the point. Points outside all bands are
+   outside the bounding box of the Polygon and so cannot be on, or cross,
+   any edge. */
+   if( p[ 1 ] < this->band0 ) return 0;
+   ib = (int)( ( p[ 1 ] - this->band0 )/this->bandwid );
+   if( ib >= this->nband ) {
+      if( p[ 1 ] > this->band0 + this->nband*this->bandwid ) return 0;
+      ib = this->nband - 1;
+   }
+
+/* Check each edge that overlaps the band. */
+   ncross = 0;
+   for( k = this->bandstart[ ib ]; k < this->bandstart[ ib + 1 ]; k++ ) {
+      e = this->edges[ this->bandedge[ k ] ];
+
+/* If the point is within the bounding box of the edge (widened by the
+   tolerance used by astLineContains) see if the point is on the edge. */
+      tol = 1.0E-7*e->length;
+      if( p[ 0 ] >= astMIN( e->start[ 0 ], e->end[ 0 ] ) - tol &&
+          p[ 0 ] <= astMAX( e->start[ 0 ], e->end[ 0 ] ) + tol &&
+          p[ 1 ] >= astMIN( e->start[ 1 ], e->end[ 1 ] ) - tol &&
+          p[ 1 ] <= astMAX( e->start[ 1 ], e->end[ 1 ] ) + tol &&
+          astLineContains( frm, e, 0, (double *) p ) ) return ON;
+
+/* Otherwise, see if the edge crosses the line through the point. Each
+   edge includes its lower end but not its upper end, so that a line
+   through a vertex is counted correctly. */
+      if( ( e->start[ 1 ] > p[ 1 ] ) != ( e->end[ 1 ] > p[ 1 ] ) ) {
+         xcross = e->start[ 0 ] + ( p[ 1 ] - e->start[ 1 ] )*
+                  ( e->end[ 0 ] - e->start[ 0 ] )/( e->end[ 1 ] - e->start[ 1 ] );
+         if( p[ 0 ] < xcross ) ncross++;
+      }
+   }
+
+/* Return the parity. */
+   return ncross % 2;
+}
+
 static int IntCmp( const void *a, const void *b ){
 /*
 *  Name:
@@ -2962,9 +3375,8 @@ static Segment *NewSegment( Segment *seg, int i1, int i2, int nvert,
          result->i2 = i2 - nvert;
       }
 
-/* Nullify the links to other Segments */
-      result->next = NULL;
-      result->prev = NULL;
+/* Indicate the Segment has not yet been added to the heap. */
+      result->order = -1;
    }
 
 /* Return the pointer to the new Segment structure. */
@@ -4648,6 +5060,162 @@ static int RegPins( AstRegion *this_region, AstPointSet *pset, AstRegion *unc,
    return result;
 }
 
+static int RegLineCross( AstRegion *this_region, const double start[],
+                         const double step[], double **cross, int *status ){
+/*
+*+
+*  Name:
+*     RegLineCross
+
+*  Purpose:
+*     Find where a straight line crosses the boundary of a 2D Region.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "polygon.h"
+*     int RegLineCross( AstRegion *this, const double start[],
+*                       const double step[], double **cross, int *status )
+
+*  Class Membership:
+*     Polygon member function (overrides the astRegLineCross method
+*     inherited from the parent Region class).
+
+*  Description:
+*     This function finds the places at which a straight line in the
+*     base Frame of a 2-dimensional Region may cross the boundary of the
+*     Region. The line is given by "start + t*step", where "t" is a
+*     scalar parameter, and the returned positions are expressed as
+*     values of "t".
+*
+*     For each edge of a Polygon in a Cartesian base Frame, the range
+*     of "t" within which the line is considered to be on the edge by
+*     astLineContains is returned (widened slightly). The line can only
+*     pass between the inside and the outside of the Polygon within one
+*     of these ranges.
+
+*  Parameters:
+*     this
+*        Pointer to the Region.
+*     start
+*        The base Frame axis values at "t = 0".
+*     step
+*        The change in the base Frame axis values per unit increase
+*        in "t".
+*     cross
+*        Address at which to return a pointer to a newly allocated array
+*        holding the lower and upper "t" values of each crossing
+*        interval. It should be freed using astFree when no longer
+*        needed. A NULL pointer is returned if no crossings are found, or
+*        if the method cannot be used.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The number of crossings found, or -1 if the method cannot be used
+*     with the base Frame of the Region.
+
+*-
+*/
+
+/* Local Variables; */
+   AstLineDef *e;
+   AstPolygon *this;
+   double d0[ 2 ];
+   double lim;
+   double p0;
+   double pd;
+   double q0;
+   double qd;
+   double t1;
+   double t2;
+   double thi;
+   double tlo;
+   double tol;
+   int iedge;
+   int nv;
+   int result;
+
+/* Initialise */
+   *cross = NULL;
+   result = -1;
+
+/* Check inherited status. */
+   if( ! astOK ) return result;
+
+/* Get a pointer to the Polygon structure. */
+   this = (AstPolygon *) this_region;
+
+/* Ensure cached information is available. The edges are only straight
+   lines in the base Frame if an edge index was created. */
+   Cache( this, status );
+   nv = astGetNpoint( this_region->points );
+   if( this->nband > 0 && this->edges && ( step[ 0 ] != 0.0 ||
+                                           step[ 1 ] != 0.0 ) ) {
+      *cross = astMalloc( sizeof( double )*2*(size_t) nv );
+      if( astOK ) result = 0;
+
+/* Check each edge. */
+      for( iedge = 0; iedge < nv && result >= 0; iedge++ ) {
+         e = this->edges[ iedge ];
+
+/* Resolve the offset from the start of the edge to the line start, and
+   the line step, into components parallel ("p") and perpendicular ("q")
+   to the edge. */
+         d0[ 0 ] = start[ 0 ] - e->start[ 0 ];
+         d0[ 1 ] = start[ 1 ] - e->start[ 1 ];
+         p0 = d0[ 0 ]*e->dir[ 0 ] + d0[ 1 ]*e->dir[ 1 ];
+         pd = step[ 0 ]*e->dir[ 0 ] + step[ 1 ]*e->dir[ 1 ];
+         q0 = d0[ 0 ]*e->q[ 0 ] + d0[ 1 ]*e->q[ 1 ];
+         qd = step[ 0 ]*e->q[ 0 ] + step[ 1 ]*e->q[ 1 ];
+
+/* astLineContains considers a point to be on the edge if "p" is within
+   [0,length) and "q" is no more than 1.0E-7 of the length from zero.
+   Find the range of "t" within which both conditions are met, using
+   twice the tolerance. */
+         tol = 2.0E-7*e->length;
+         tlo = -DBL_MAX;
+         thi = DBL_MAX;
+
+         if( qd != 0.0 ) {
+            t1 = ( -tol - q0 )/qd;
+            t2 = ( tol - q0 )/qd;
+            tlo = astMAX( tlo, astMIN( t1, t2 ) );
+            thi = astMIN( thi, astMAX( t1, t2 ) );
+         } else if( fabs( q0 ) > tol ) {
+            continue;
+         }
+
+         lim = e->length + tol;
+         if( pd != 0.0 ) {
+            t1 = ( -tol - p0 )/pd;
+            t2 = ( lim - p0 )/pd;
+            tlo = astMAX( tlo, astMIN( t1, t2 ) );
+            thi = astMIN( thi, astMAX( t1, t2 ) );
+         } else if( p0 < -tol || p0 > lim ) {
+            continue;
+         }
+
+/* Store the range if it is not empty. */
+         if( tlo <= thi ) {
+            (*cross)[ 2*result ] = tlo;
+            (*cross)[ 2*result + 1 ] = thi;
+            result++;
+         }
+      }
+   }
+
+/* Return -1 if an error occurred. */
+   if( !astOK ) {
+      *cross = astFree( *cross );
+      result = -1;
+   }
+
+/* Return the result. */
+   return result;
+}
+
 static int RegTrace( AstRegion *this_region, int n, double *dist, double **ptr,
                      int *status ){
 /*
@@ -4829,62 +5397,6 @@ static int RegTrace( AstRegion *this_region, int n, double *dist, double **ptr,
    return 1;
 }
 
-static Segment *RemoveFromChain( Segment *head, Segment *seg, int *status ){
-/*
-*  Name:
-*     RemoveFromChain
-
-*  Purpose:
-*     Remove a Segment from the link list maintained by astDownsize.
-
-*  Type:
-*     Private function.
-
-*  Synopsis:
-*     #include "polygon.h"
-*     Segment *RemoveFromChain( Segment *head, Segment *seg, int *status )
-
-*  Class Membership:
-*     Polygon member function
-
-*  Description:
-*     The supplied Segment is removed form the list, and the gap is
-*     closed up.
-
-*  Parameters:
-*     head
-*        The Segment structure at the head of the list.
-*     seg
-*        The Segment to be removed from the list.
-*     status
-*        Pointer to the inherited status variable.
-
-*  Returned Value:
-*     Pointer to the link head (which will have changed if "seg" was the
-*     original head).
-
-*/
-
-/* Check the global error status. */
-   if ( !astOK ) return head;
-
-/* If the Segment was the original head, make the next segment the new
-   head. */
-   if( head == seg ) head = seg->next;
-
-/* Close up the links between the Segments on either side of the segment
-   being removed. */
-   if( seg->prev ) seg->prev->next = seg->next;
-   if( seg->next ) seg->next->prev = seg->prev;
-
-/* Nullify the links in the segment being removed. */
-   seg->next = NULL;
-   seg->prev = NULL;
-
-/* Return the new head. */
-   return head;
-}
-
 static void ResetCache( AstRegion *this_region, int *status ){
 /*
 *  Name:
@@ -4938,12 +5450,50 @@ static void ResetCache( AstRegion *this_region, int *status ){
          }
          this->edges = astFree( this->edges );
       }
+      FreeIndex( this, status );
 
 /* Clear the cache of the parent class. */
       (*parent_resetcache)( this_region, status );
    }
 }
 
+static int SegAbove( Segment *seg1, Segment *seg2 ){
+/*
+*  Name:
+*     SegAbove
+
+*  Purpose:
+*     See if one Segment should be above another in the astDownsize heap.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "polygon.h"
+*     int SegAbove( Segment *seg1, Segment *seg2 )
+
+*  Class Membership:
+*     Polygon member function
+
+*  Description:
+*     This function returns a non-zero value if "seg1" has a higher error
+*     than "seg2", or has the same error but was added to the heap
+*     first.
+
+*  Parameters:
+*     seg1
+*        The first Segment.
+*     seg2
+*        The second Segment.
+
+*  Returned Value:
+*     Non-zero if "seg1" should be above "seg2" in the heap.
+
+*/
+   return ( seg1->error > seg2->error ||
+            ( seg1->error == seg2->error && seg1->order < seg2->order ) );
+}
+
 static void SetAttrib( AstObject *this_object, const char *setting, int *status ) {
 /*
 *  Name:
@@ -6112,43 +6662,54 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
 /* Ensure cached information is available.*/
             Cache( this, status );
 
-/* Create a definition of the line from a point which is inside the
-   polygon to the supplied point. This is a structure which includes
-   cached intermediate information which can be used to speed up
-   subsequent calculations. */
             p[ 0 ] = *px;
             p[ 1 ] = *py;
-            a = astLineDef( frm, this->in, p );
+
+/* If an edge index is available, use it to find the parity of the
+   number of edges crossed by a line from the supplied point to infinity.
+   The point is inside the polygon if this is the same as the parity for
+   the inside point. */
+            if( this->bandstart ) {
+               pos = IndexParity( this, frm, p, status );
+               if( pos != ON ) pos = ( pos == this->inpar ) ? IN : OUT;
+
+/* Otherwise, create a definition of the line from a point which is inside
+   the polygon to the supplied point. This is a structure which includes
+   cached intermediate information which can be used to speed up
+   subsequent calculations. */
+            } else {
+               a = astLineDef( frm, this->in, p );
 
 /* We now determine the number of times this line crosses the polygon
    boundary. Initialise the number of crossings to zero. */
-            ncross = 0;
-            pos = UNKNOWN;
+               ncross = 0;
+               pos = UNKNOWN;
 
 /* Loop rouind all edges of the polygon. */
-            for( i = 0; i < nv; i++ ) {
-               b = this->edges[ i ];
+               for( i = 0; i < nv; i++ ) {
+                  b = this->edges[ i ];
 
 /* If this point is on the current edge, then we need do no more checks
    since we know it is either inside or outside the polygon (depending on
    whether the polygon is closed or not). */
-               if( astLineContains( frm, b, 0, p ) ) {
-                  pos = ON;
-                  break;
+                  if( astLineContains( frm, b, 0, p ) ) {
+                     pos = ON;
+                     break;
 
 /* Otherwise, see if the two lines cross within their extent. If so,
    increment the number of crossings. */
-               } else if( astLineCrossing( frm, b, a, NULL ) ) {
-                  ncross++;
+                  } else if( astLineCrossing( frm, b, a, NULL ) ) {
+                     ncross++;
+                  }
                }
-            }
 
 /* Free resources */
-            a = astFree( a );
+               a = astFree( a );
 
 /* If the position is not on the boundary, it is inside the boundary if
    the number of crossings is even, and outside otherwise. */
-            if( pos == UNKNOWN ) pos = ( ncross % 2 == 0 )? IN : OUT;
+               if( pos == UNKNOWN ) pos = ( ncross % 2 == 0 )? IN : OUT;
+            }
 
 /* Whether the point is in the Region depends on whether the point is
    inside the polygon boundary, whether the Polygon has been negated, and
@@ -6290,6 +6851,8 @@ static void Copy( const AstObject *objin, AstObject *objout, int *status ) {
    the output Polygon. */
    out->edges = NULL;
    out->startsat = NULL;
+   out->bandstart = NULL;
+   out->bandedge = NULL;
 
 /* Indicate cached information needs nre-calculating. */
    astResetCache( (AstPolygon *) out );
@@ -6359,6 +6922,7 @@ static void Delete( AstObject *obj, int *status ) {
       this->startsat = astFree( this->startsat );
 
    }
+   FreeIndex( this, status );
 }
 
 /* Dump function. */
@@ -6884,6 +7448,9 @@ AstPolygon *astInitPolygon_( void *mem, size_t size, int init, AstPolygonVtab *v
          new->simp_vertices = -INT_MAX;
          new->edges = NULL;
          new->startsat = NULL;
+         new->bandstart = NULL;
+         new->bandedge = NULL;
+         new->nband = 0;
          new->totlen = 0.0;
          new->acw = 1;
          new->stale = 1;
@@ -7044,6 +7611,9 @@ AstPolygon *astLoadPolygon_( void *mem, size_t size, AstPolygonVtab *vtab,
       new->ubnd[ 1 ] = AST__BAD;
       new->edges = NULL;
       new->startsat = NULL;
+      new->bandstart = NULL;
+      new->bandedge = NULL;
+      new->nband = 0;
       new->totlen = 0.0;
       new->acw = 1;
       new->stale = 1;
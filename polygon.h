@@ -115,6 +115,12 @@ typedef struct AstPolygon {
    AstLineDef **edges;     /* Cached description of edges */
    double *startsat;       /* Perimeter distance to each vertex */
    double totlen;          /* Total perimeter distance round polygon */
+   int *bandstart;         /* Index of first entry for each edge band */
+   int *bandedge;          /* Indices of the edges overlapping each band */
+   double band0;           /* Lower limit on axis 2 of the first band */
+   double bandwid;         /* Width of each band on axis 2 */
+   int nband;              /* Number of edge bands */
+   int inpar;              /* Crossing parity of the inside point */
    int acw;                /* Are vertices stored in anti-clockwise order? */
    int stale;              /* Is cached information stale? */
    int simp_vertices;      /* Simplify by transforming vertices? */
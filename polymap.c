@@ -173,6 +173,7 @@ static int class_check;
 
 /* Pointers to parent class methods which are extended by this class. */
 static AstPointSet *(* parent_transform)( AstMapping *, AstPointSet *, int, AstPointSet *, int * );
+static double (* parent_rate)( AstMapping *, double *, int, int, int * );
 static const char *(* parent_getattrib)( AstObject *, const char *, int * );
 static int (* parent_testattrib)( AstObject *, const char *, int * );
 static void (* parent_clearattrib)( AstObject *, const char *, int * );
@@ -229,6 +230,9 @@ static AstPolyMap **GetJacobian( AstPolyMap *, int * );
 static AstPolyMap *PolyTran( AstPolyMap *, int, double, double, int, const double *, const double *, int * );
 static double **SamplePoly1D( AstPolyMap *, int, double **, double, double, int, int *, double[2], int * );
 static double **SamplePoly2D( AstPolyMap *, int, double **, const double *, const double *, int, int *, double[4], int * );
+static double CoeffRate( AstPolyMap *, int, double *, int, int, int * );
+static double Rate( AstMapping *, double *, int, int, int * );
+static int RateIsExact( AstMapping *, int * );
 static double *FitPoly1D( AstPolyMap *, int, int, double, int, double **, double[2], int *, double *, int * );
 static double *FitPoly2D( AstPolyMap *, int, int, double, int, double **, double[4], int *, double *, int * );
 static int Equal( AstObject *, AstObject *, int * );
@@ -249,6 +253,7 @@ static void LMFunc2D(  const double *, double *, int, int, void * );
 static void LMJacob1D( const double *, double *, int, int, void * );
 static void LMJacob2D( const double *, double *, int, int, void * );
 static void PolyPowers( AstPolyMap *, double **, int, const int *, double **, int, int, int * );
+static void PolyRates( AstPolyMap *, double *, int, int, double, int, int * );
 static void StoreArrays( AstPolyMap *, int, int, const double *, int * );
 static void PolyCoeffs( AstPolyMap *, int, int, double *, int *, int * );
 static void FitPoly1DInit( AstPolyMap *, int, double **, AstMinPackData *, double *, int *);
@@ -349,6 +354,175 @@ static void ClearAttrib( AstObject *this_object, const char *attrib, int *status
    }
 }
 
+static double CoeffRate( AstPolyMap *this, int fwd, double *at, int ax1,
+                         int ax2, int *status ){
+/*
+*  Name:
+*     CoeffRate
+
+*  Purpose:
+*     Differentiate a polynomial defined by the coefficients of a PolyMap.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "polymap.h"
+*     double CoeffRate( AstPolyMap *this, int fwd, double *at, int ax1,
+*                       int ax2, int *status )
+
+*  Description:
+*     This function returns the rate of change of a specified output of
+*     one of the polynomial transformations stored in a PolyMap, with
+*     respect to a specified input, at a specified input position. The
+*     polynomial is differentiated analytically using astPolyPowers and
+*     astPolyRates, so that sub-classes such as ChebyMap are also handled.
+*     The Invert attribute of the PolyMap is ignored.
+
+*  Parameters:
+*     this
+*        Pointer to the PolyMap.
+*     fwd
+*        If non-zero, use the coefficients of the original forward
+*        transformation. Otherwise, use the coefficients of the original
+*        inverse transformation. The required coefficients must be
+*        defined.
+*     at
+*        The address of an array holding the axis values at the position
+*        at which the rate of change is to be evaluated. The number of
+*        elements in this array should equal the number of inputs to the
+*        transformation.
+*     ax1
+*        The index of the output for which the rate of change is to be
+*        found (output numbering starts at 0 for the first output).
+*     ax2
+*        The index of the input which is to be varied in order to find
+*        the rate of change (input numbering starts at 0 for the first
+*        input).
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The rate of change of output "ax1" with respect to input "ax2",
+*     evaluated at "at", or AST__BAD if the value cannot be calculated.
+
+*/
+
+/* Local Variables: */
+   double **ptr;
+   double **work;
+   double *dwork;
+   double *outcof;
+   double result;
+   double term;
+   double xp;
+   int **outpow;
+   int *mxpow;
+   int ico;
+   int in_coord;
+   int nc;
+   int ncoord_in;
+   int pow;
+
+/* Check inherited status */
+   if( !astOK ) return AST__BAD;
+
+/* The rate is undefined if the input value being varied is bad. */
+   if( at[ ax2 ] == AST__BAD ) return AST__BAD;
+
+/* Get the maximum power used on each input axis. */
+   mxpow = fwd ? this->mxpow_f : this->mxpow_i;
+
+/* Get the number of inputs to the transformation, allowing for the
+   Invert attribute being ignored. */
+   if( fwd != astGetInvert( this ) ) {
+      ncoord_in = astGetNin( this );
+   } else {
+      ncoord_in = astGetNout( this );
+   }
+
+/* Allocate memory to hold the required powers of the input axis values,
+   the derivatives of the powers of input "ax2", and pointers to the input
+   axis values. */
+   ptr = astMalloc( sizeof( double * )*(size_t) ncoord_in );
+   work = astMalloc( sizeof( double * )*(size_t) ncoord_in );
+   dwork = astMalloc( sizeof( double )*(size_t) ( astMAX( 2, mxpow[ ax2 ] + 1 ) ) );
+   if( work ) {
+      for( in_coord = 0; in_coord < ncoord_in; in_coord++ ) {
+         work[ in_coord ] = astMalloc( sizeof( double )*
+                           (size_t) ( astMAX( 2, mxpow[ in_coord ] + 1 ) ) );
+      }
+   }
+
+/* Find the powers of all the input axis values, and the derivatives of the
+   powers of input "ax2". */
+   result = AST__BAD;
+   if( astOK ) {
+      for( in_coord = 0; in_coord < ncoord_in; in_coord++ ) {
+         ptr[ in_coord ] = at + in_coord;
+      }
+      astPolyPowers( this, work, ncoord_in, mxpow, ptr, 0, fwd );
+      astPolyRates( this, dwork, ax2, mxpow[ ax2 ], at[ ax2 ], fwd );
+
+/* Get pointers to the coefficients and powers for the required output. */
+      outcof = fwd ? this->coeff_f[ ax1 ] : this->coeff_i[ ax1 ];
+      outpow = fwd ? this->power_f[ ax1 ] : this->power_i[ ax1 ];
+      nc = fwd ? this->ncoeff_f[ ax1 ] : this->ncoeff_i[ ax1 ];
+
+/* Loop round all polynomial coefficients, summing the derivative of each
+   term. Terms that do not depend on input "ax2" have zero derivative. */
+      result = 0.0;
+      for ( ico = 0; ico < nc; ico++, outcof++, outpow++ ) {
+         pow = (*outpow)[ ax2 ];
+         if( pow == 0 ) continue;
+
+/* Initialise the derivative of the current term to be the coefficient
+   value times the derivative of the relevant power of input "ax2". */
+         term = *outcof;
+         xp = dwork[ pow ];
+         if( term == AST__BAD || xp == AST__BAD ) {
+            result = AST__BAD;
+            break;
+         }
+         term *= xp;
+
+/* Multiply by the powers of the other input axis values. */
+         for( in_coord = 0; in_coord < ncoord_in; in_coord++ ) {
+            pow = (*outpow)[ in_coord ];
+            if( pow > 0 && in_coord != ax2 ) {
+               xp = work[ in_coord ][ pow ];
+               if( xp == AST__BAD ) {
+                  term = AST__BAD;
+                  break;
+               }
+               term *= xp;
+            }
+         }
+
+/* Increment the result by the derivative of the current term. */
+         if( term == AST__BAD ) {
+            result = AST__BAD;
+            break;
+         }
+         result += term;
+      }
+   }
+
+/* Free resources. */
+   if( work ) {
+      for( in_coord = 0; in_coord < ncoord_in; in_coord++ ) {
+         work[ in_coord ] = astFree( work[ in_coord ] );
+      }
+   }
+   work = astFree( work );
+   dwork = astFree( dwork );
+   ptr = astFree( ptr );
+
+/* Return the result. */
+   if( !astOK ) result = AST__BAD;
+   return result;
+}
+
 static int Equal( AstObject *this_object, AstObject *that_object, int *status ) {
 /*
 *  Name:
@@ -1862,6 +2036,7 @@ void astInitPolyMapVtab_(  AstPolyMapVtab *vtab, const char *name, int *status )
 /* Store pointers to the member functions (implemented here) that provide
    virtual methods for this class. */
    vtab->PolyPowers = PolyPowers;
+   vtab->PolyRates = PolyRates;
    vtab->FitPoly1DInit = FitPoly1DInit;
    vtab->FitPoly2DInit = FitPoly2DInit;
    vtab->PolyTran = PolyTran;
@@ -1906,6 +2081,9 @@ void astInitPolyMapVtab_(  AstPolyMapVtab *vtab, const char *name, int *status )
 
    parent_transform = mapping->Transform;
    mapping->Transform = Transform;
+   parent_rate = mapping->Rate;
+   mapping->Rate = Rate;
+   mapping->RateIsExact = RateIsExact;
    mapping->GetTranForward = GetTranForward;
    mapping->GetTranInverse = GetTranInverse;
 
@@ -3313,6 +3491,70 @@ static void PolyPowers( AstPolyMap *this, double **work, int ncoord,
    }
 }
 
+static void PolyRates( AstPolyMap *this, double *work, int coord, int mxpow,
+                       double x, int fwd, int *status ){
+/*
+*+
+*  Name:
+*     astPolyRates
+
+*  Purpose:
+*     Find the derivatives of the required powers of an input axis value.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "polymap.h"
+*     void astPolyRates( AstPolyMap *this, double *work, int coord,
+*                        int mxpow, double x, int fwd )
+
+*  Class Membership:
+*     PolyMap virtual function.
+
+*  Description:
+*     This function is used by astRate to calculate the rate of change
+*     of each of the quantities returned by astPolyPowers for a single
+*     input axis, with respect to the input axis value. For the PolyMap
+*     class, element "i" of the returned array is the derivative of
+*     "x raised to the power i". Sub-classes that over-ride astPolyPowers
+*     should also over-ride this method.
+
+*  Parameters:
+*     this
+*        Pointer to the PolyMap.
+*     work
+*        An array of length "max(2,mxpow+1)". The required values are
+*        placed in this array on exit.
+*     coord
+*        The zero based index of the input axis.
+*     mxpow
+*        The maximum power required of the axis value.
+*     x
+*        The input axis value. Should not be AST__BAD.
+*     fwd
+*        Do the supplied coefficients define the foward transformation of
+*        the PolyMap?
+*-
+*/
+
+/* Local Variables; */
+   double xp;
+   int ip;
+
+/* Check the local error status. */
+   if ( !astOK ) return;
+
+/* The derivative of "x to the power i" is "i times x to the power i-1".
+   Form the powers of "x" as we go. */
+   work[ 0 ] = 0.0;
+   xp = 1.0;
+   for( ip = 1; ip <= mxpow; ip++ ) {
+      work[ ip ] = ip*xp;
+      xp *= x;
+   }
+}
+
 static AstPolyMap *PolyTran( AstPolyMap *this, int forward, double acc,
                              double maxacc, int maxorder, const double *lbnd,
                              const double *ubnd, int *status ){
@@ -3517,6 +3759,191 @@ f     function is invoked with STATUS set to an error value, or if it
    return result;
 }
 
+static double Rate( AstMapping *this, double *at, int ax1, int ax2, int *status ){
+/*
+*  Name:
+*     Rate
+
+*  Purpose:
+*     Calculate the rate of change of a Mapping output.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "polymap.h"
+*     result = Rate( AstMapping *this, double *at, int ax1, int ax2, int *status )
+
+*  Class Membership:
+*     PolyMap member function (overrides the astRate method inherited
+*     from the Mapping class ).
+
+*  Description:
+*     This function returns the rate of change of a specified output of
+*     the supplied Mapping with respect to a specified input, at a
+*     specified input position.
+*
+*     The polynomial defining the output is differentiated analytically.
+*     If the transformation in use is an iterative inverse, the input
+*     position is first transformed using the iterative inverse, and the
+*     required rate is then found by inverting the analytic Jacobian
+*     matrix of the forward transformation at the resulting position.
+
+*  Parameters:
+*     this
+*        Pointer to the Mapping to be applied.
+*     at
+*        The address of an array holding the axis values at the position
+*        at which the rate of change is to be evaluated. The number of
+*        elements in this array should equal the number of inputs to the
+*        Mapping.
+*     ax1
+*        The index of the Mapping output for which the rate of change is to
+*        be found (output numbering starts at 0 for the first output).
+*     ax2
+*        The index of the Mapping input which is to be varied in order to
+*        find the rate of change (input numbering starts at 0 for the first
+*        input).
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The rate of change of Mapping output "ax1" with respect to input
+*     "ax2", evaluated at "at", or AST__BAD if the value cannot be
+*     calculated.
+
+*/
+
+/* Local Variables: */
+   AstPolyMap *map;
+   double *jac;
+   double *x;
+   double *y;
+   double det;
+   double result;
+   int *iw;
+   int fwd;
+   int i;
+   int j;
+   int n;
+   int sing;
+
+/* Check inherited status */
+   if( !astOK ) return AST__BAD;
+
+/* Get a pointer to the PolyMap structure. */
+   map = (AstPolyMap *) this;
+
+/* Determine which of the original transformations is in use. */
+   fwd = !astGetInvert( this );
+
+/* If the original inverse transformation is being approximated using an
+   iterative algorithm, the PolyMap has equal numbers of inputs and
+   outputs, and the forward transformation is defined. */
+   if( !fwd && astGetIterInverse( map ) ) {
+      result = AST__BAD;
+
+/* Allocate work space. */
+      n = astGetNin( this );
+      x = astMalloc( sizeof( double )*(size_t) n );
+      y = astMalloc( sizeof( double )*(size_t) n );
+      jac = astMalloc( sizeof( double )*(size_t) ( n*n ) );
+      iw = astMalloc( sizeof( int )*(size_t) n );
+      if( astOK ) {
+
+/* Use the iterative inverse to find the position at which the Jacobian
+   of the original forward transformation is required. */
+         astTranN( this, 1, n, 1, at, 1, n, 1, x );
+
+/* Find the Jacobian matrix of the original forward transformation at
+   this position. */
+         sing = 0;
+         for( i = 0; i < n && !sing; i++ ) {
+            for( j = 0; j < n; j++ ) {
+               jac[ i*n + j ] = CoeffRate( map, 1, x, i, j, status );
+               if( jac[ i*n + j ] == AST__BAD ) {
+                  sing = 1;
+                  break;
+               }
+            }
+         }
+
+/* Column "ax2" of the inverse of the Jacobian holds the rates of change
+   of the iterative inverse outputs with respect to input "ax2". Get it by
+   solving the linear equations "jac.y = e", where "e" is the unit vector
+   along axis "ax2". */
+         if( !sing && astOK ) {
+            for( i = 0; i < n; i++ ) y[ i ] = 0.0;
+            y[ ax2 ] = 1.0;
+            palDmat( n, jac, y, &det, &sing, iw );
+            if( sing == 0 ) result = y[ ax1 ];
+         }
+      }
+
+/* Free resources. */
+      x = astFree( x );
+      y = astFree( y );
+      jac = astFree( jac );
+      iw = astFree( iw );
+
+/* If the transformation is undefined, use the numerical estimate provided
+   by the parent class (which will report an error). */
+   } else if( fwd ? !map->ncoeff_f : !map->ncoeff_i ) {
+      result = (*parent_rate)( this, at, ax1, ax2, status );
+
+/* Otherwise, differentiate the polynomial analytically. */
+   } else {
+      result = CoeffRate( map, fwd, at, ax1, ax2, status );
+   }
+
+/* Return the result. */
+   return result;
+}
+
+static int RateIsExact( AstMapping *this, int *status ) {
+/*
+*  Name:
+*     RateIsExact
+
+*  Purpose:
+*     Check if the astRate method of a Mapping is exact.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "polymap.h"
+*     int RateIsExact( AstMapping *this, int *status )
+
+*  Class Membership:
+*     PolyMap member function (over-rides the protected astRateIsExact
+*     method inherited from the Mapping class).
+
+*  Description:
+*     This function returns a flag indicating if the astRate method of
+*     the supplied Mapping evaluates the rate of change analytically.
+*     The polynomials defining a PolyMap are differentiated analytically,
+*     and so the rate is exact.
+
+*  Parameters:
+*     this
+*        Pointer to the Mapping.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Non-zero if the astRate method of the supplied Mapping is exact, and
+*     zero otherwise.
+
+*/
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* The polynomials are differentiated analytically. */
+   return 1;
+}
+
 static int ReplaceTransformation( AstPolyMap *this, int forward, double acc,
                                   double maxacc, int maxorder, const double *lbnd,
                                   const double *ubnd, int *status ){
@@ -6066,6 +6493,13 @@ void astPolyPowers_( AstPolyMap *this, double **work, int ncoord,
                                            point, fwd, status );
 }
 
+void astPolyRates_( AstPolyMap *this, double *work, int coord, int mxpow,
+                    double x, int fwd, int *status ){
+   if ( !astOK ) return;
+   (**astMEMBER(this,PolyMap,PolyRates))( this, work, coord, mxpow, x, fwd,
+                                          status );
+}
+
 AstPolyMap *astPolyTran_( AstPolyMap *this, int forward, double acc,
                           double maxacc, int maxorder, const double *lbnd,
                           const double *ubnd, int *status ){
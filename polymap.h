@@ -195,6 +195,7 @@ typedef struct AstPolyMapVtab {
 /* Properties (e.g. methods) specific to this class. */
    AstPolyMap *(* PolyTran)( AstPolyMap *, int, double, double, int, const double *, const double *, int * );
    void (* PolyPowers)( AstPolyMap *, double **, int, const int *, double **, int, int, int * );
+   void (* PolyRates)( AstPolyMap *, double *, int, int, double, int, int * );
    void (* PolyCoeffs)( AstPolyMap *, int, int, double *, int *, int *);
    void (* FitPoly1DInit)( AstPolyMap *, int, double **, AstMinPackData *, double *, int *);
    void (* FitPoly2DInit)( AstPolyMap *, int, double **, AstMinPackData *, double *, int *);
@@ -270,6 +271,7 @@ void astPolyCoeffs_( AstPolyMap *, int, int, double *, int *, int *);
 
 # if defined(astCLASS)           /* Protected */
    void astPolyPowers_( AstPolyMap *, double **, int, const int *, double **, int, int, int * );
+   void astPolyRates_( AstPolyMap *, double *, int, int, double, int, int * );
    void astFitPoly1DInit_( AstPolyMap *, int, double **, AstMinPackData *, double *, int *);
    void astFitPoly2DInit_( AstPolyMap *, int, double **, AstMinPackData *, double *, int *);
 
@@ -344,8 +346,10 @@ astINVOKE(V,astPolyCoeffs_(astCheckPolyMap(this),forward,nel,coeffs,ncoeff,STATU
 
 #if defined(astCLASS)            /* Protected */
 
-#define astPolyPowers(this,work,ncoord,mxpow,ptr,offset,fwd) \
+#define astPolyPowers(this,work,ncoord,mxpow,ptr,point,fwd) \
         astINVOKE(V,astPolyPowers_(astCheckPolyMap(this),work,ncoord,mxpow,ptr,point,fwd,STATUS_PTR))
+#define astPolyRates(this,work,coord,mxpow,x,fwd) \
+        astINVOKE(V,astPolyRates_(astCheckPolyMap(this),work,coord,mxpow,x,fwd,STATUS_PTR))
 #define astFitPoly1DInit(this,forward,table,data,scales) \
         astINVOKE(V,astFitPoly1DInit_(astCheckPolyMap(this),forward,table,data,scales,STATUS_PTR))
 #define astFitPoly2DInit(this,forward,table,data,scales) \
@@ -64,6 +64,11 @@
 *        been conditioned differently to the WCSLIB code in order to improve
 *        accuracy of the floor function for arguments very slightly below an
 *        integer value.
+*     -  Array-oriented versions of the forward and reverse functions
+*        (*s2x() and *x2s()) added for the TAN, SIN, ARC, ZPN, ZEA, CAR,
+*        AIT and HPX projections (and TPN in tpn.c). These transform many
+*        points in a single call, producing results identical to the
+*        corresponding scalar functions.
 
 *=============================================================================
 *
@@ -111,6 +116,10 @@
 *      astXPHset astXPHfwd astXPHrev   XPH: HEALPix polar, aka "butterfly"
 *
 *
+*   The TAN, SIN, ARC, ZPN, ZEA, CAR, AIT, HPX and TPN projections also
+*   have array-oriented forward, *s2x(), and reverse, *x2s(), routines
+*   which transform many points in a single call (see below).
+*
 *   Driver routines; astPRJset(), astPRJfwd() & astPRJrev()
 *   ----------------------------------------------
 *   A set of driver routines are available for use as a generic interface to
@@ -194,6 +203,41 @@
 *                           2: Invalid value of (x,y).
 *                           1: Invalid projection parameters.
 *
+*   Array transformations; *s2x() and *x2s()
+*   ----------------------------------------
+*   Transform a vector of points. The results for each point are identical
+*   to those returned by the corresponding scalar *fwd() or *rev() routine,
+*   but the projection flag is checked only once and invariant quantities
+*   are evaluated outside the loop.
+*
+*   Given and returned:
+*      prj      AstPrjPrm*  Projection parameters (see below).
+*
+*   Given:
+*      n        const int
+*                        Number of points.
+*      phi,     const double[]
+*      theta             (*s2x) Longitudes and latitudes, in degrees.
+*      x,y      const double[]
+*                        (*x2s) Projected coordinates.
+*
+*   Returned:
+*      x,y      double[] (*s2x) Projected coordinates.
+*      phi,     double[] (*x2s) Longitudes and latitudes, in degrees.
+*      theta
+*
+*   Given and returned:
+*      stat     int[]    Status for each point. On entry, any point with a
+*                        non-zero status is skipped and its output values
+*                        are left unchanged. On exit, points that were
+*                        transformed have a status of 0 (success) or 2
+*                        (invalid value), as for the scalar routines.
+*
+*   Function return value:
+*               int      Error status
+*                           0: Success.
+*                           1: Invalid projection parameters.
+*
 *   Projection parameters
 *   ---------------------
 *   The AstPrjPrm struct consists of the following:
@@ -914,6 +958,79 @@ double *phi, *theta;
    return 0;
 }
 
+/*--------------------------------------------------------------------------*/
+
+int astTANs2x(prj, n, phi, theta, x, y, stat)
+
+struct AstPrjPrm *prj;
+const int n;
+const double phi[], theta[];
+double x[], y[];
+int stat[];
+
+{
+   int i, strict;
+   double cphi, cthe, r, sphi, s;
+
+   if (abs(prj->flag) != WCS__TAN) {
+      if (astTANset(prj)) return 1;
+   }
+
+   strict = (prj->flag > 0);
+
+   for (i = 0; i < n; i++) {
+      if (stat[i]) continue;
+
+      astSinCosd(theta[i], &s, &cthe);
+      if (s == 0.0) {
+         stat[i] = 2;
+         continue;
+      }
+
+      r =  prj->r0*cthe/s;
+      astSinCosd(phi[i], &sphi, &cphi);
+      x[i] =  r*sphi;
+      y[i] = -r*cphi;
+
+      if (strict && s < 0.0) stat[i] = 2;
+   }
+
+   return 0;
+}
+
+/*--------------------------------------------------------------------------*/
+
+int astTANx2s(prj, n, x, y, phi, theta, stat)
+
+struct AstPrjPrm *prj;
+const int n;
+const double x[], y[];
+double phi[], theta[];
+int stat[];
+
+{
+   int i;
+   double r;
+
+   if (abs(prj->flag) != WCS__TAN) {
+      if (astTANset(prj)) return 1;
+   }
+
+   for (i = 0; i < n; i++) {
+      if (stat[i]) continue;
+
+      r = sqrt(x[i]*x[i] + y[i]*y[i]);
+      if (r == 0.0) {
+         phi[i] = 0.0;
+      } else {
+         phi[i] = astATan2d(x[i], -y[i]);
+      }
+      theta[i] = astATan2d(prj->r0, r);
+   }
+
+   return 0;
+}
+
 /*============================================================================
 *   STG: stereographic projection.
 *
@@ -1204,6 +1321,170 @@ double *phi, *theta;
    return 0;
 }
 
+/*--------------------------------------------------------------------------*/
+
+int astSINs2x(prj, n, phi, theta, x, y, stat)
+
+struct AstPrjPrm *prj;
+const int n;
+const double phi[], theta[];
+double x[], y[];
+int stat[];
+
+{
+   int i, strict;
+   double cphi, cthe, sphi, sthe, t, z;
+
+   if (abs(prj->flag) != WCS__SIN) {
+      if (astSINset(prj)) return 1;
+   }
+
+   strict = (prj->flag > 0);
+
+   for (i = 0; i < n; i++) {
+      if (stat[i]) continue;
+
+      t = (90.0 - fabs(theta[i]))*D2R;
+      if (t < 1.0e-5) {
+         if (theta[i] > 0.0) {
+            z = t*t/2.0;
+         } else {
+            z = 2.0 - t*t/2.0;
+         }
+         cthe = t;
+      } else {
+         astSinCosd(theta[i], &sthe, &cthe);
+         z =  1.0 - sthe;
+      }
+
+      astSinCosd(phi[i], &sphi, &cphi);
+      x[i] =  prj->r0*(cthe*sphi + prj->p[1]*z);
+      y[i] = -prj->r0*(cthe*cphi - prj->p[2]*z);
+
+      /* Validate this solution. */
+      if (strict) {
+         if (prj->w[1] == 0.0) {
+            /* Orthographic projection. */
+            if (theta[i] < 0.0) stat[i] = 2;
+         } else {
+            /* "Synthesis" projection. */
+            t = -astATand(prj->p[1]*sphi - prj->p[2]*cphi);
+            if (theta[i] < t) stat[i] = 2;
+         }
+      }
+   }
+
+   return 0;
+}
+
+/*--------------------------------------------------------------------------*/
+
+int astSINx2s(prj, n, x, y, phi, theta, stat)
+
+struct AstPrjPrm *prj;
+const int n;
+const double x[], y[];
+double phi[], theta[];
+int stat[];
+
+{
+   const double tol = 1.0e-13;
+   int i;
+   double a, b, c, d, r2, sth1, sth2, sthe, sxy, x0, x1, xp, y0, y1, yp, z;
+
+   if (abs(prj->flag) != WCS__SIN) {
+      if (astSINset(prj)) return 1;
+   }
+
+   x1 = prj->p[1];
+   y1 = prj->p[2];
+   a = prj->w[2];
+
+   for (i = 0; i < n; i++) {
+      if (stat[i]) continue;
+
+      /* Compute intermediaries. */
+      x0 = x[i]*prj->w[0];
+      y0 = y[i]*prj->w[0];
+      r2 = x0*x0 + y0*y0;
+
+      if (prj->w[1] == 0.0) {
+         /* Orthographic projection. */
+         if (r2 != 0.0) {
+            phi[i] = astATan2d(x0, -y0);
+         } else {
+            phi[i] = 0.0;
+         }
+
+         if (r2 < 0.5) {
+            theta[i] = astACosd(sqrt(r2));
+         } else if (r2 <= 1.0) {
+            theta[i] = astASind(sqrt(1.0 - r2));
+         } else {
+            stat[i] = 2;
+         }
+
+      } else {
+         /* "Synthesis" projection. */
+         sxy = x0*x1 + y0*y1;
+
+         if (r2 < 1.0e-10) {
+            /* Use small angle formula. */
+            z = r2/2.0;
+            theta[i] = 90.0 - R2D*sqrt(r2/(1.0 + sxy));
+
+         } else {
+            b = sxy - prj->w[1];
+            c = r2 - sxy - sxy + prj->w[3];
+            d = b*b - a*c;
+
+            /* Check for a solution. */
+            if (d < 0.0) {
+               stat[i] = 2;
+               continue;
+            }
+            d = sqrt(d);
+
+            /* Choose solution closest to pole. */
+            sth1 = (-b + d)/a;
+            sth2 = (-b - d)/a;
+            sthe = (sth1 > sth2) ? sth1 : sth2;
+            if (sthe > 1.0) {
+               if (sthe-1.0 < tol) {
+                  sthe = 1.0;
+               } else {
+                  sthe = (sth1 < sth2) ? sth1 : sth2;
+               }
+            }
+
+            if (sthe < -1.0) {
+               if (sthe+1.0 > -tol) {
+                  sthe = -1.0;
+               }
+            }
+
+            if (sthe > 1.0 || sthe < -1.0) {
+               stat[i] = 2;
+               continue;
+            }
+
+            theta[i] = astASind(sthe);
+            z = 1.0 - sthe;
+         }
+
+         xp = -y0 + prj->p[2]*z;
+         yp =  x0 - prj->p[1]*z;
+         if (xp == 0.0 && yp == 0.0) {
+            phi[i] = 0.0;
+         } else {
+            phi[i] = astATan2d(yp,xp);
+         }
+      }
+   }
+
+   return 0;
+}
+
 /*============================================================================
 *   ARC: zenithal/azimuthal equidistant projection.
 *
@@ -1294,6 +1575,69 @@ double *phi, *theta;
    return 0;
 }
 
+/*--------------------------------------------------------------------------*/
+
+int astARCs2x(prj, n, phi, theta, x, y, stat)
+
+struct AstPrjPrm *prj;
+const int n;
+const double phi[], theta[];
+double x[], y[];
+int stat[];
+
+{
+   int i;
+   double cphi, r, sphi;
+
+   if (prj->flag != WCS__ARC) {
+      if (astARCset(prj)) return 1;
+   }
+
+   for (i = 0; i < n; i++) {
+      if (stat[i]) continue;
+
+      r =  prj->w[0]*(90.0 - theta[i]);
+      astSinCosd(phi[i], &sphi, &cphi);
+      x[i] =  r*sphi;
+      y[i] = -r*cphi;
+   }
+
+   return 0;
+}
+
+/*--------------------------------------------------------------------------*/
+
+int astARCx2s(prj, n, x, y, phi, theta, stat)
+
+struct AstPrjPrm *prj;
+const int n;
+const double x[], y[];
+double phi[], theta[];
+int stat[];
+
+{
+   int i;
+   double r;
+
+   if (prj->flag != WCS__ARC) {
+      if (astARCset(prj)) return 1;
+   }
+
+   for (i = 0; i < n; i++) {
+      if (stat[i]) continue;
+
+      r = sqrt(x[i]*x[i] + y[i]*y[i]);
+      if (r == 0.0) {
+         phi[i] = 0.0;
+      } else {
+         phi[i] = astATan2d(x[i], -y[i]);
+      }
+      theta[i] = 90.0 - r*prj->w[1];
+   }
+
+   return 0;
+}
+
 /*============================================================================
 *   ZPN: zenithal/azimuthal polynomial projection.
 *
@@ -1546,6 +1890,77 @@ double *phi, *theta;
    return 0;
 }
 
+/*--------------------------------------------------------------------------*/
+
+int astZPNs2x(prj, n, phi, theta, x, y, stat)
+
+struct AstPrjPrm *prj;
+const int n;
+const double phi[], theta[];
+double x[], y[];
+int stat[];
+
+{
+   int   i, j, strict;
+   double cphi, r, s, sphi;
+
+   if (abs(prj->flag) != WCS__ZPN) {
+      if (astZPNset(prj)) return 1;
+   }
+
+   strict = (prj->flag > 0 && prj->n > 2);
+
+   for (i = 0; i < n; i++) {
+      if (stat[i]) continue;
+
+      s = (90.0 - theta[i])*D2R;
+
+      r = 0.0;
+      for (j = prj->n; j >= 0; j--) {
+         r = r*s + prj->p[j];
+      }
+      r = prj->r0*r;
+
+      astSinCosd(phi[i], &sphi, &cphi);
+      x[i] =  r*sphi;
+      y[i] = -r*cphi;
+
+      if (strict && s > prj->w[0]) stat[i] = 2;
+   }
+
+   return 0;
+}
+
+/*--------------------------------------------------------------------------*/
+
+int astZPNx2s(prj, n, x, y, phi, theta, stat)
+
+struct AstPrjPrm *prj;
+const int n;
+const double x[], y[];
+double phi[], theta[];
+int stat[];
+
+{
+   int i;
+
+   if (abs(prj->flag) != WCS__ZPN) {
+      if (astZPNset(prj)) return 1;
+   }
+
+   /* Constant - no solution. */
+   if (prj->n < 1) return 1;
+
+   /* The cost of the polynomial inversion dominates, so each point is
+      simply passed to the scalar routine. */
+   for (i = 0; i < n; i++) {
+      if (stat[i]) continue;
+      stat[i] = astZPNrev(x[i], y[i], prj, phi + i, theta + i);
+   }
+
+   return 0;
+}
+
 /*============================================================================
 *   ZEA: zenithal/azimuthal equal area projection.
 *
@@ -1647,6 +2062,80 @@ double *phi, *theta;
    return 0;
 }
 
+/*--------------------------------------------------------------------------*/
+
+int astZEAs2x(prj, n, phi, theta, x, y, stat)
+
+struct AstPrjPrm *prj;
+const int n;
+const double phi[], theta[];
+double x[], y[];
+int stat[];
+
+{
+   int i;
+   double cphi, r, sphi;
+
+   if (prj->flag != WCS__ZEA) {
+      if (astZEAset(prj)) return 1;
+   }
+
+   for (i = 0; i < n; i++) {
+      if (stat[i]) continue;
+
+      r =  prj->w[0]*astSind((90.0 - theta[i])/2.0);
+      astSinCosd(phi[i], &sphi, &cphi);
+      x[i] =  r*sphi;
+      y[i] = -r*cphi;
+   }
+
+   return 0;
+}
+
+/*--------------------------------------------------------------------------*/
+
+int astZEAx2s(prj, n, x, y, phi, theta, stat)
+
+struct AstPrjPrm *prj;
+const int n;
+const double x[], y[];
+double phi[], theta[];
+int stat[];
+
+{
+   int i;
+   double r, s;
+   const double tol = 1.0e-12;
+
+   if (prj->flag != WCS__ZEA) {
+      if (astZEAset(prj)) return 1;
+   }
+
+   for (i = 0; i < n; i++) {
+      if (stat[i]) continue;
+
+      r = sqrt(x[i]*x[i] + y[i]*y[i]);
+      if (r == 0.0) {
+         phi[i] = 0.0;
+      } else {
+         phi[i] = astATan2d(x[i], -y[i]);
+      }
+
+      s = r*prj->w[1];
+      if (fabs(s) > 1.0) {
+         if (fabs(r - prj->w[0]) < tol) {
+            theta[i] = -90.0;
+         } else {
+            stat[i] = 2;
+         }
+      } else {
+         theta[i] = 90.0 - 2.0*astASind(s);
+      }
+   }
+
+   return 0;
+}
+
 /*============================================================================
 *   AIR: Airy's projection.
 *
@@ -2148,6 +2637,62 @@ double *phi, *theta;
    return 0;
 }
 
+/*--------------------------------------------------------------------------*/
+
+int astCARs2x(prj, n, phi, theta, x, y, stat)
+
+struct AstPrjPrm *prj;
+const int n;
+const double phi[], theta[];
+double x[], y[];
+int stat[];
+
+{
+   int i;
+   double w0;
+
+   if (prj->flag != WCS__CAR) {
+      if (astCARset(prj)) return 1;
+   }
+
+   w0 = prj->w[0];
+   for (i = 0; i < n; i++) {
+      if (stat[i]) continue;
+      x[i] = w0*phi[i];
+      y[i] = w0*theta[i];
+   }
+
+   return 0;
+}
+
+/*--------------------------------------------------------------------------*/
+
+int astCARx2s(prj, n, x, y, phi, theta, stat)
+
+struct AstPrjPrm *prj;
+const int n;
+const double x[], y[];
+double phi[], theta[];
+int stat[];
+
+{
+   int i;
+   double w1;
+
+   if (prj->flag != WCS__CAR) {
+      if (astCARset(prj)) return 1;
+   }
+
+   w1 = prj->w[1];
+   for (i = 0; i < n; i++) {
+      if (stat[i]) continue;
+      phi[i]   = w1*x[i];
+      theta[i] = w1*y[i];
+   }
+
+   return 0;
+}
+
 /*============================================================================
 *   MER: Mercator's projection.
 *
@@ -2682,6 +3227,92 @@ double *phi, *theta;
    return 0;
 }
 
+/*--------------------------------------------------------------------------*/
+
+int astAITs2x(prj, n, phi, theta, x, y, stat)
+
+struct AstPrjPrm *prj;
+const int n;
+const double phi[], theta[];
+double x[], y[];
+int stat[];
+
+{
+   int i;
+   double chalf, cthe, shalf, sthe, w;
+
+   if (prj->flag != WCS__AIT) {
+      if (astAITset(prj)) return 1;
+   }
+
+   for (i = 0; i < n; i++) {
+      if (stat[i]) continue;
+
+      astSinCosd(theta[i], &sthe, &cthe);
+      astSinCosd(phi[i]/2.0, &shalf, &chalf);
+      w = sqrt(prj->w[0]/(1.0 + cthe*chalf));
+      x[i] = 2.0*w*cthe*shalf;
+      y[i] = w*sthe;
+   }
+
+   return 0;
+}
+
+/*--------------------------------------------------------------------------*/
+
+int astAITx2s(prj, n, x, y, phi, theta, stat)
+
+struct AstPrjPrm *prj;
+const int n;
+const double x[], y[];
+double phi[], theta[];
+int stat[];
+
+{
+   int i;
+   double s, u, xp, yp, z;
+   const double tol = 1.0e-13;
+
+   if (prj->flag != WCS__AIT) {
+      if (astAITset(prj)) return 1;
+   }
+
+   for (i = 0; i < n; i++) {
+      if (stat[i]) continue;
+
+      u = 1.0 - x[i]*x[i]*prj->w[2] - y[i]*y[i]*prj->w[1];
+      if (u < 0.0) {
+         if (u < -tol) {
+            stat[i] = 2;
+            continue;
+         }
+
+         u = 0.0;
+      }
+
+      z = sqrt(u);
+      s = z*y[i]/prj->r0;
+      if (fabs(s) > 1.0) {
+         if (fabs(s) > 1.0+tol) {
+            stat[i] = 2;
+            continue;
+         }
+         s = copysign(1.0,s);
+      }
+
+      xp = 2.0*z*z - 1.0;
+      yp = z*x[i]*prj->w[3];
+      if (xp == 0.0 && yp == 0.0) {
+         phi[i] = 0.0;
+      } else {
+         phi[i] = 2.0*astATan2d(yp, xp);
+      }
+      theta[i] = astASind(s);
+   }
+
+   return 0;
+}
+
 /*============================================================================
 *   COP: conic perspective projection.
 *
@@ -4611,6 +5242,58 @@ double *phi, *theta;
    return 0;
 }
 
+/*--------------------------------------------------------------------------*/
+
+int astHPXs2x(prj, n, phi, theta, x, y, stat)
+
+struct AstPrjPrm *prj;
+const int n;
+const double phi[], theta[];
+double x[], y[];
+int stat[];
+
+{
+   int i;
+
+   if( prj->flag != WCS__HPX ) {
+      if( astHPXset( prj ) ) return 1;
+   }
+
+/* Each point is handled by the scalar routine. The flag check above
+   ensures the routine does no further initialisation. */
+   for( i = 0; i < n; i++ ) {
+      if( stat[ i ] ) continue;
+      stat[ i ] = astHPXfwd( phi[ i ], theta[ i ], prj, x + i, y + i );
+   }
+
+   return 0;
+}
+
+/*--------------------------------------------------------------------------*/
+
+int astHPXx2s(prj, n, x, y, phi, theta, stat)
+
+struct AstPrjPrm *prj;
+const int n;
+const double x[], y[];
+double phi[], theta[];
+int stat[];
+
+{
+   int i;
+
+   if( prj->flag != WCS__HPX ) {
+      if( astHPXset( prj ) ) return 1;
+   }
+
+   for( i = 0; i < n; i++ ) {
+      if( stat[ i ] ) continue;
+      stat[ i ] = astHPXrev( x[ i ], y[ i ], prj, phi + i, theta + i );
+   }
+
+   return 0;
+}
+
 /*============================================================================
 *   XPH: HEALPix polar, aka "butterfly" projection.
 *
@@ -47,6 +47,8 @@
 *        tpn.c).
 *     -  Added prototypes for HPX projection functions.
 *     -  Added prototypes for XPH projection functions.
+*     -  Added prototypes for the array-oriented "s2x" and "x2s" functions
+*        for the TAN, SIN, ARC, ZPN, ZEA, CAR, AIT, HPX and TPN projections.
 *===========================================================================*/
 
 #ifndef WCSLIB_PROJ_INCLUDED
@@ -170,6 +172,25 @@ struct AstPrjPrm {
    int astTPNfwd(const double, const double, struct AstPrjPrm *, double *, double *);
    int astTPNrev(const double, const double, struct AstPrjPrm *, double *, double *);
 
+   int astTANs2x(struct AstPrjPrm *, const int, const double [], const double [], double [], double [], int []);
+   int astTANx2s(struct AstPrjPrm *, const int, const double [], const double [], double [], double [], int []);
+   int astSINs2x(struct AstPrjPrm *, const int, const double [], const double [], double [], double [], int []);
+   int astSINx2s(struct AstPrjPrm *, const int, const double [], const double [], double [], double [], int []);
+   int astARCs2x(struct AstPrjPrm *, const int, const double [], const double [], double [], double [], int []);
+   int astARCx2s(struct AstPrjPrm *, const int, const double [], const double [], double [], double [], int []);
+   int astZPNs2x(struct AstPrjPrm *, const int, const double [], const double [], double [], double [], int []);
+   int astZPNx2s(struct AstPrjPrm *, const int, const double [], const double [], double [], double [], int []);
+   int astZEAs2x(struct AstPrjPrm *, const int, const double [], const double [], double [], double [], int []);
+   int astZEAx2s(struct AstPrjPrm *, const int, const double [], const double [], double [], double [], int []);
+   int astCARs2x(struct AstPrjPrm *, const int, const double [], const double [], double [], double [], int []);
+   int astCARx2s(struct AstPrjPrm *, const int, const double [], const double [], double [], double [], int []);
+   int astAITs2x(struct AstPrjPrm *, const int, const double [], const double [], double [], double [], int []);
+   int astAITx2s(struct AstPrjPrm *, const int, const double [], const double [], double [], double [], int []);
+   int astHPXs2x(struct AstPrjPrm *, const int, const double [], const double [], double [], double [], int []);
+   int astHPXx2s(struct AstPrjPrm *, const int, const double [], const double [], double [], double [], int []);
+   int astTPNs2x(struct AstPrjPrm *, const int, const double [], const double [], double [], double [], int []);
+   int astTPNx2s(struct AstPrjPrm *, const int, const double [], const double [], double [], double [], int []);
+
 extern const char *astPRJset_errmsg[];
 extern const char *astPRJfwd_errmsg[];
 extern const char *astPRJrev_errmsg[];
@@ -807,6 +807,7 @@ static int Test##attribute( AstFrame *this_frame, int axis, int *status ) { \
 #include "cmpregion.h"           /* Compound regions */
 #include "ellipse.h"             /* Elliptical regions */
 #include "pointset.h"            /* Sets of points */
+#include "wcsmap.h"              /* Factors of PI */
 #include "globals.h"             /* Thread-safe global data access */
 
 /* Error code definitions. */
@@ -824,6 +825,35 @@ static int Test##attribute( AstFrame *this_frame, int axis, int *status ) { \
 #include <stdlib.h>
 #include <math.h>
 
+/* Type definitions. */
+/* ================= */
+
+/* A structure that describes a job that masks one band of rows in a
+   grid. The jobs for each band are run in parallel using astRunJobs. */
+typedef struct MaskBand {
+   AstRegion *region;   /* Private copy of the Region to use */
+   const int *lbnd;     /* Lower pixel index bounds of the whole grid */
+   const int *ubnd;     /* Upper pixel index bounds of the whole grid */
+   int *lbndb;          /* Lower pixel index bounds of the band */
+   int *ubndb;          /* Upper pixel index bounds of the band */
+   int ndim;            /* Number of grid axes */
+   void *in;            /* Pointer to the array to be masked */
+   void *out;           /* Pointer to the array to receive masked values */
+   const void *val;     /* Pointer to the value to be assigned */
+   int *spans;          /* Runs of pixels found within the band */
+   int nspan;           /* Number of runs found within the band */
+   int result;          /* Number of pixels assigned the value */
+} MaskBand;
+
+/* A structure that records where a few probe positions fall in the base
+   Frame of one Region. astRegionsContain sorts these so that Regions with
+   equal base->current Mappings end up next to each other. */
+typedef struct RegionSig {
+   int ireg;            /* Index of the Region within the supplied array */
+   int nval;            /* Number of base Frame axis values */
+   const double *val;   /* Base Frame axis values at the probe positions */
+} RegionSig;
+
 /* Module Variables. */
 /* ================= */
 
@@ -886,6 +916,24 @@ static int MaskUB( AstRegion *, AstMapping *, int, int, const int[], const int[]
 static int MaskUI( AstRegion *, AstMapping *, int, int, const int[], const int[], unsigned int[], unsigned int, int * );
 static int MaskUL( AstRegion *, AstMapping *, int, int, const int[], const int[], unsigned long int[], unsigned long int, int * );
 static int MaskUS( AstRegion *, AstMapping *, int, int, const int[], const int[], unsigned short int[], unsigned short int, int * );
+#if HAVE_LONG_DOUBLE     /* Not normally implemented */
+static void MaskBandLD( void *, int * );
+#endif
+static void MaskBandB( void *, int * );
+static void MaskBandD( void *, int * );
+static void MaskBandF( void *, int * );
+static void MaskBandI( void *, int * );
+static void MaskBandL( void *, int * );
+static void MaskBandS( void *, int * );
+static void MaskBandUB( void *, int * );
+static void MaskBandUI( void *, int * );
+static void MaskBandUL( void *, int * );
+static void MaskBandUS( void *, int * );
+static MaskBand *FreeMaskBands( MaskBand *, int, int * );
+static MaskBand *MaskBands( AstRegion *, int, const int[], const int[], const int[], const int[], int *, int * );
+static int *FindSpans( AstRegion *, const int[], const int[], int *, int * );
+static int *MaskSpans( AstRegion *, const int[], const int[], int *, int * );
+static void MaskSpansBand( void *, int * );
 
 static AstAxis *GetAxis( AstFrame *, int, int * );
 static AstFrame *GetRegionFrame( AstRegion *, int * );
@@ -923,6 +971,7 @@ static const char *SystemString( AstFrame *, AstSystemType, int * );
 static const int *GetPerm( AstFrame *, int * );
 static double *RegCentre( AstRegion *, double *, double **, int, int, int * );
 static double Angle( AstFrame *, const double[], const double[], const double[], int * );
+static double BaseCap( AstRegion *, double **, int * );
 static double AxAngle( AstFrame *, const double[], const double[], int, int * );
 static double AxDistance( AstFrame *, int, double, double, int * );
 static double AxOffset( AstFrame *, int, double, double, int * );
@@ -944,6 +993,8 @@ static int RegDummyFS( AstRegion *, int * );
 static int RegPins( AstRegion *, AstPointSet *, AstRegion *, int **, int * );
 static int SubFrame( AstFrame *, AstFrame *, int, const int *, const int *, AstMapping **, AstFrame **, int * );
 static int RegTrace( AstRegion *, int, double *, double **, int * );
+static int RegLineCross( AstRegion *, const double[], const double[], double **, int * );
+static int SigCmp( const void *, const void * );
 static int Unformat( AstFrame *, int, const char *, double *, int * );
 static int ValidateAxis( AstFrame *, int, int, const char *, int * );
 static void AxNorm( AstFrame *, int, int, int, double *, int * );
@@ -1634,6 +1685,237 @@ static double AxOffset( AstFrame *this_frame, int axis, double v1, double dist,
    return result;
 }
 
+static double BaseCap( AstRegion *this, double **cen, int *status ){
+/*
+*  Name:
+*     BaseCap
+
+*  Purpose:
+*     Return a cap enclosing a Region within its base Frame.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "region.h"
+*     double BaseCap( AstRegion *this, double **cen, int *status )
+
+*  Class Membership:
+*     Region member function
+
+*  Description:
+*     This function returns the centre and radius of a circle (or
+*     spherical cap) within the base Frame of the supplied Region, which
+*     encloses the whole of the Region, including a margin for the
+*     separation between adjacent boundary mesh points and the extent of
+*     the Region's positional uncertainty. It is found using the points
+*     in the base Frame mesh, and is cached in the Region so that it
+*     can be re-used until the Region is next changed.
+*
+*     A cap can only be found if the base Frame is a basic Frame or a
+*     SkyFrame, and the Region is bounded within the base Frame. On a
+*     SkyFrame the cap must also be smaller than a hemisphere, and
+*     the Region must not contain the point opposite the cap centre.
+
+*  Parameters:
+*     this
+*        Pointer to the Region.
+*     cen
+*        Address at which to return a pointer to an array holding the
+*        base Frame axis values at the centre of the cap. The array is
+*        owned by the Region and should not be freed or changed. NULL
+*        is returned if no cap is available.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The radius of the cap, as a distance within the base Frame. A
+*     negative value is returned if no cap is available.
+
+*  Notes:
+*     - A negative value will be returned if this function is invoked
+*     with the global error status set, or if it should fail for any
+*     reason.
+*/
+
+/* Local Variables: */
+   AstFrame *frm;                /* Base Frame */
+   AstMapping *map;              /* Base->current Mapping */
+   AstPointSet *mesh;            /* Base Frame mesh */
+   AstPointSet *ps1;             /* Opposite point in base Frame */
+   AstPointSet *ps2;             /* Opposite point in current Frame */
+   AstPointSet *ps3;             /* Opposite point after masking by Region */
+   AstRegion *unc;               /* Uncertainty in base Frame */
+   const char *class;            /* Class of base Frame */
+   double **ptr;                 /* Pointers to mesh axis values */
+   double **ptr1;                /* Pointers to opposite point axis values */
+   double *c;                    /* Cap centre */
+   double *p;                    /* Work point */
+   double *pp;                   /* Previous mesh point */
+   double *q;                    /* Work point */
+   double *work;                 /* Work space */
+   double d;                     /* A distance */
+   double dmax;                  /* Largest distance found */
+   double gap;                   /* Largest gap between mesh points */
+   double rad;                   /* Cap radius */
+   int ic;                       /* Axis index */
+   int ifar;                     /* Index of furthest mesh point */
+   int ip;                       /* Mesh point index */
+   int nc;                       /* Number of base Frame axes */
+   int np;                       /* Number of mesh points */
+   int pass;                     /* Pass through mesh */
+   int sky;                      /* Is the base Frame a SkyFrame? */
+
+/* Initialise. */
+   *cen = NULL;
+
+/* Check the global error status. */
+   if ( !astOK ) return -1.0;
+
+/* If the cap has not yet been found, find it now. A negative radius is
+   cached if no cap is available. */
+   if( this->caprad == AST__BAD ) {
+      rad = -1.0;
+      gap = 0.0;
+
+/* Distances within other classes of Frame do not in general behave like
+   those in a plane or on a sphere, so only basic Frames and SkyFrames are
+   handled. */
+      frm = astGetFrame( this->frameset, AST__BASE );
+      class = astGetClass( frm );
+      sky = class && !strcmp( class, "SkyFrame" );
+      if( sky || ( class && !strcmp( class, "Frame" ) ) ) {
+
+/* Get the base Frame mesh and some work space. */
+         mesh = astRegBaseMesh( this );
+         nc = astGetNcoord( mesh );
+         np = astGetNpoint( mesh );
+         ptr = astGetPoints( mesh );
+         work = astMalloc( 4*nc*sizeof( *work ) );
+         if( astOK && np > 1 ) {
+            p = work;
+            q = p + nc;
+            c = q + nc;
+            pp = c + nc;
+
+/* Find the mesh point furthest from the first mesh point, and then the
+   mesh point furthest from that one. These two points span (nearly)
+   the full width of the Region. */
+            rad = 0.0;
+            ifar = 0;
+            dmax = 0.0;
+            for( pass = 0; pass < 2 && rad == 0.0; pass++ ) {
+               for( ic = 0; ic < nc; ic++ ) p[ ic ] = ptr[ ic ][ ifar ];
+               dmax = 0.0;
+               for( ip = 0; ip < np; ip++ ) {
+                  for( ic = 0; ic < nc; ic++ ) q[ ic ] = ptr[ ic ][ ip ];
+                  d = astDistance( frm, p, q );
+                  if( d == AST__BAD ) {
+                     rad = -1.0;
+                     break;
+                  } else if( d > dmax ) {
+                     dmax = d;
+                     ifar = ip;
+                  }
+               }
+            }
+
+/* Use the point mid way between them as the cap centre. */
+            if( rad == 0.0 ) {
+               for( ic = 0; ic < nc; ic++ ) q[ ic ] = ptr[ ic ][ ifar ];
+               astOffset( frm, p, q, 0.5*dmax, c );
+
+/* Find the largest distance from the centre to any mesh point, and the
+   largest gap between adjacent mesh points. */
+               gap = 0.0;
+               for( ic = 0; ic < nc; ic++ ) pp[ ic ] = ptr[ ic ][ np - 1 ];
+               for( ip = 0; ip < np; ip++ ) {
+                  for( ic = 0; ic < nc; ic++ ) q[ ic ] = ptr[ ic ][ ip ];
+                  d = astDistance( frm, c, q );
+                  if( d == AST__BAD ) {
+                     rad = -1.0;
+                     break;
+                  } else if( d > rad ) {
+                     rad = d;
+                  }
+                  d = astDistance( frm, pp, q );
+                  if( d == AST__BAD ) {
+                     rad = -1.0;
+                     break;
+                  } else if( d > gap ) {
+                     gap = d;
+                  }
+                  for( ic = 0; ic < nc; ic++ ) pp[ ic ] = q[ ic ];
+               }
+            }
+
+/* Add on the gap and the diagonal of the box enclosing the uncertainty
+   Region. */
+            if( rad >= 0.0 ) {
+               rad += gap;
+               unc = astGetUncFrm( this, AST__BASE );
+               astGetRegionBounds( unc, p, q );
+               d = astDistance( frm, p, q );
+               unc = astAnnul( unc );
+               rad = ( d != AST__BAD ) ? rad + d : -1.0;
+            }
+
+/* On a sphere, the boundary of a Region with an unbounded interior may
+   also fit within a small cap, so check that the point opposite the cap
+   centre is outside the Region. */
+            if( sky && rad >= 0.0 ) {
+               if( rad >= AST__DPIBY2 ) {
+                  rad = -1.0;
+               } else {
+                  for( ic = 0; ic < nc; ic++ ) q[ ic ] = ptr[ ic ][ 0 ];
+                  ps1 = astPointSet( 1, nc, "", status );
+                  ptr1 = astGetPoints( ps1 );
+                  if( astOK ) {
+                     astOffset( frm, c, q, AST__DPI, p );
+                     for( ic = 0; ic < nc; ic++ ) ptr1[ ic ][ 0 ] = p[ ic ];
+                  }
+                  map = astGetMapping( this->frameset, AST__BASE, AST__CURRENT );
+                  ps2 = astTransform( map, ps1, 1, NULL );
+                  ps3 = astTransform( this, ps2, 1, NULL );
+                  ptr1 = astGetPoints( ps3 );
+                  if( astOK ) {
+                     for( ic = 0; ic < nc; ic++ ) {
+                        if( p[ ic ] == AST__BAD ||
+                            ptr1[ ic ][ 0 ] != AST__BAD ) rad = -1.0;
+                     }
+                  }
+                  map = astAnnul( map );
+                  ps1 = astAnnul( ps1 );
+                  ps2 = astAnnul( ps2 );
+                  ps3 = astAnnul( ps3 );
+               }
+            }
+
+/* Store the centre. */
+            if( rad >= 0.0 ) {
+               this->capcen = astStore( this->capcen, c, nc*sizeof( *c ) );
+            }
+         }
+
+/* Free resources. */
+         work = astFree( work );
+         mesh = astAnnul( mesh );
+      }
+      frm = astAnnul( frm );
+
+/* Cache the radius. */
+      this->caprad = astOK ? rad : AST__BAD;
+   }
+
+/* Return the cap. */
+   if( astOK && this->caprad >= 0.0 ) {
+      *cen = this->capcen;
+      return this->caprad;
+   } else {
+      return -1.0;
+   }
+}
+
 static AstPointSet *BndBaseMesh( AstRegion *this, double *lbnd, double *ubnd, int *status ){
 /*
 *+
@@ -3057,6 +3339,9 @@ static int GetObjSize( AstObject *this_object, int *status ) {
    result += astGetObjSize( this->unc );
    result += astGetObjSize( this->negation );
    result += astGetObjSize( this->defunc );
+   result += astTSizeOf( this->capcen );
+   result += astGetObjSize( this->overmap );
+   result += astGetObjSize( this->overmesh );
 
 /* If an error occurred, clear the result value. */
    if ( !astOK ) result = 0;
@@ -4543,6 +4828,7 @@ void astInitRegionVtab_(  AstRegionVtab *vtab, const char *name, int *status ) {
 
    vtab->ResetCache = ResetCache;
    vtab->RegTrace = RegTrace;
+   vtab->RegLineCross = RegLineCross;
    vtab->GetBounded = GetBounded;
    vtab->TestUnc = TestUnc;
    vtab->ClearUnc = ClearUnc;
@@ -5292,6 +5578,8 @@ static int ManageLock( AstObject *this_object, int mode, int extra,
    if( !result ) result = astManageLock( this->defunc, mode, extra, fail );
    if( !result ) result = astManageLock( this->basemesh, mode, extra, fail );
    if( !result ) result = astManageLock( this->basegrid, mode, extra, fail );
+   if( !result ) result = astManageLock( this->overmap, mode, extra, fail );
+   if( !result ) result = astManageLock( this->overmesh, mode, extra, fail );
 
    return result;
 
@@ -5834,6 +6122,11 @@ f        BADVAL
 *     reason.
 *     - An error will be reported if the overlap of the Region and
 *     the array cannot be determined.
+*     - If AST was built with POSIX threads support, large arrays may
+*     be divided into bands which are masked in parallel. The number of
+*     threads to use is given by the AST_NTHREAD environment variable
+*     (the default is to use a single thread). The masked array does not
+*     depend on the number of threads used.
 
 *  Data Type Codes:
 *     To select the appropriate masking function, you should
@@ -5882,6 +6175,8 @@ static int Mask##X( AstRegion *this, AstMapping *map, int inside, int ndim, \
 \
 /* Local Variables: */ \
    AstFrame *grid_frame;         /* Pointer to Frame describing grid coords */ \
+   AstMapping *span_map;         /* Pointer to Region used to find pixel runs */ \
+   MaskBand *bands;              /* Bands of rows to mask in parallel */ \
    AstRegion *used_region;       /* Pointer to Region to be used by astResample */ \
    Xtype *c;                     /* Pointer to next array element */ \
    Xtype *d;                     /* Pointer to next array element */ \
@@ -5890,18 +6185,28 @@ static int Mask##X( AstRegion *this, AstMapping *map, int inside, int ndim, \
    double *lbndgd;               /* Pointer to array holding lower grid bounds */ \
    double *ubndgd;               /* Pointer to array holding upper grid bounds */ \
    int *lbndg;                   /* Pointer to array holding lower grid bounds */ \
+   int *span;                    /* Pointer to next run of unchanged pixels */ \
+   int *spans;                   /* Pointer to runs of unchanged pixels */ \
    int *ubndg;                   /* Pointer to array holding upper grid bounds */ \
+   int iband;                    /* Index of current band */ \
    int idim;                     /* Loop counter for coordinate dimensions */ \
    int ipix;                     /* Loop counter for pixel index */ \
+   int ispan;                    /* Index of next run of unchanged pixels */ \
+   int ix;                       /* Pixel index on grid axis 1 */ \
+   int iy;                       /* Pixel index on grid axis 2 */ \
    int nax;                      /* Number of Region axes */ \
+   int nband;                    /* Number of bands */ \
    int nin;                      /* Number of Mapping input coordinates */ \
    int nout;                     /* Number of Mapping output coordinates */ \
    int npix;                     /* Number of pixels in supplied array */ \
    int npixg;                    /* Number of pixels in bounding box */ \
+   int nspan;                    /* Number of runs of unchanged pixels */ \
+   int nx;                       /* Number of pixels in each grid row */ \
    int result;                   /* Result value to return */ \
 \
 /* Initialise. */ \
    result = 0; \
+   spans = NULL; \
 \
 /* Check the global error status. */ \
    if ( !astOK ) return result; \
@@ -6004,6 +6309,27 @@ static int Mask##X( AstRegion *this, AstMapping *map, int inside, int ndim, \
          if( npixg >= 0 ) npixg *= ( ubndg[ idim ] - lbndg[ idim ] + 1 ); \
       } \
 \
+/* For a 2-dimensional grid, attempt to find the runs of pixels within \
+   the bounding box that are to be left unchanged, using the places where \
+   each row crosses the Region boundary. This is only possible for some \
+   classes of Region and Mapping, and is much faster than transforming \
+   every pixel. NULL is returned if it is not possible. To ensure that \
+   pixels on the boundary are treated in the same way as by astResample \
+   below, the Region is negated if the inside is to be assigned the \
+   value (so that the runs are the pixels outside the Region), and is \
+   simplified if astResample would simplify it. */ \
+      if( npixg > 0 && ndim == 2 ) { \
+         if( inside ) astNegate( used_region ); \
+         span_map = ( npix > 1024 ) ? astSimplify( used_region ) : \
+                                      astClone( used_region ); \
+         if( astIsARegion( span_map ) ) { \
+            spans = MaskSpans( (AstRegion *) span_map, lbndg, ubndg, \
+                               &nspan, status ); \
+         } \
+         span_map = astAnnul( span_map ); \
+         if( inside ) astNegate( used_region ); \
+      } \
+\
 /* If the bounding box is null, fill the mask with the supplied value if \
    we assigning the value to the outside of the region (do the opposite if \
    the Region has been negated). */ \
@@ -6014,7 +6340,45 @@ static int Mask##X( AstRegion *this, AstMapping *map, int inside, int ndim, \
             result = npix; \
          } \
 \
-/* If the bounding box is null, return without action. */ \
+/* If the runs of unchanged pixels were found, assign the supplied value \
+   directly to the supplied array. First fill the pixels outside the \
+   bounding box if they are to be assigned the value. */ \
+      } else if( spans && astOK ) { \
+         nx = ubnd[ 0 ] - lbnd[ 0 ] + 1; \
+         if( ( inside != 0 ) == ( astGetNegated( used_region ) != 0 ) ) { \
+            for( iy = lbnd[ 1 ]; iy <= ubnd[ 1 ]; iy++ ) { \
+               c = in + ( iy - lbnd[ 1 ] )*nx; \
+               if( iy < lbndg[ 1 ] || iy > ubndg[ 1 ] ) { \
+                  for( ix = lbnd[ 0 ]; ix <= ubnd[ 0 ]; ix++ ) *(c++) = val; \
+               } else { \
+                  for( ix = lbnd[ 0 ]; ix < lbndg[ 0 ]; ix++ ) *(c++) = val; \
+                  c += ubndg[ 0 ] - lbndg[ 0 ] + 1; \
+                  for( ix = ubndg[ 0 ] + 1; ix <= ubnd[ 0 ]; ix++ ) *(c++) = val; \
+               } \
+            } \
+            result = npix - npixg; \
+         } \
+\
+/* Now assign the value to the pixels within the bounding box that are \
+   not in any run. The runs are sorted by row and then by column. */ \
+         ispan = 0; \
+         for( iy = lbndg[ 1 ]; iy <= ubndg[ 1 ]; iy++ ) { \
+            c = in + ( iy - lbnd[ 1 ] )*nx + ( lbndg[ 0 ] - lbnd[ 0 ] ); \
+            ix = lbndg[ 0 ]; \
+            for( ; ispan < nspan && spans[ 3*ispan ] == iy; ispan++ ) { \
+               span = spans + 3*ispan; \
+               for( ; ix < span[ 1 ]; ix++ ) *(c++) = val; \
+               c += span[ 2 ] - ix + 1; \
+               ix = span[ 2 ] + 1; \
+            } \
+            for( ; ix <= ubndg[ 0 ]; ix++ ) *(c++) = val; \
+         } \
+         result += npixg; \
+         for( ispan = 0; ispan < nspan; ispan++ ) { \
+            result -= spans[ 3*ispan + 2 ] - spans[ 3*ispan + 1 ] + 1; \
+         } \
+\
+/* Otherwise, use astResample to test every pixel in the bounding box. */ \
       } else if( npixg > 0 && astOK ) { \
 \
 /* All points outside this box are either all inside, or all outside, the \
@@ -6054,12 +6418,33 @@ static int Mask##X( AstRegion *this, AstMapping *map, int inside, int ndim, \
    region if the inside is to be assigned the value VAL.*/ \
          if( inside ) astNegate( used_region ); \
 \
-/* Invoke astResample to mask just the region inside the bounding box found \
-   above (specified by lbndg and ubndg), since all the points outside this \
-   box will already contain their required value. */ \
-         result += astResample##X( used_region, ndim, lbnd, ubnd, in, NULL, AST__NEAREST, \
-                                   NULL, NULL, 0, 0.0, 100, val, ndim, \
-                                   lbnd, ubnd, lbndg, ubndg, out, NULL ); \
+/* If there are enough pixels, and more than one thread is available, \
+   divide the bounding box into bands of rows along the last grid axis. */ \
+         bands = MaskBands( used_region, ndim, lbnd, ubnd, lbndg, ubndg, \
+                            &nband, status ); \
+         if( bands ) { \
+\
+/* If the box has been divided into bands of rows, mask each band in \
+   parallel. Each band writes to a separate part of the output array. */ \
+            for( iband = 0; iband < nband; iband++ ) { \
+               bands[ iband ].in = in; \
+               bands[ iband ].out = out; \
+               bands[ iband ].val = &val; \
+            } \
+            astRunJobs( nband, MaskBand##X, bands, sizeof( MaskBand ) ); \
+            for( iband = 0; iband < nband; iband++ ) { \
+               result += bands[ iband ].result; \
+            } \
+            bands = FreeMaskBands( bands, nband, status ); \
+\
+/* Otherwise, invoke astResample to mask just the region inside the \
+   bounding box found above (specified by lbndg and ubndg), since all the \
+   points outside this box will already contain their required value. */ \
+         } else { \
+            result += astResample##X( used_region, ndim, lbnd, ubnd, in, NULL, AST__NEAREST, \
+                                      NULL, NULL, 0, 0.0, 100, val, ndim, \
+                                      lbnd, ubnd, lbndg, ubndg, out, NULL ); \
+         } \
 \
 /* Revert to the original setting of the Negated attribute. */ \
          if( inside ) astNegate( used_region ); \
@@ -6077,6 +6462,7 @@ static int Mask##X( AstRegion *this, AstMapping *map, int inside, int ndim, \
 \
 /* Free resources */ \
    ubndg = astFree( ubndg ); \
+   spans = astFree( spans ); \
    lbndg = astFree( lbndg ); \
    ubndgd = astFree( ubndgd ); \
    lbndgd = astFree( lbndgd ); \
@@ -6108,6 +6494,723 @@ MAKE_MASK(F,float)
 /* Undefine the macro. */
 #undef MAKE_MASK
 
+/*
+*  Name:
+*     MaskBand<X>
+
+*  Purpose:
+*     Mask one band of rows in a grid.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "region.h"
+*     void MaskBand<X>( void *data, int *status )
+
+*  Class Membership:
+*     Region member function
+
+*  Description:
+*     This function is run by astRunJobs to mask one band of rows within
+*     the bounding box of a Region, for the astMask<X> functions. It uses
+*     astResample<X> in the same way as astMask<X> does when the grid is
+*     processed as a whole, so the masked values do not depend on the
+*     number of bands.
+
+*  Parameters:
+*     data
+*        Pointer to a MaskBand structure describing the band. The
+*        number of pixels assigned the mask value is returned in its
+*        "result" component.
+*     status
+*        Pointer to the inherited status variable.
+
+*/
+
+/* Define a macro to implement the function for a specific data
+   type. */
+#define MAKE_MASKBAND(X,Xtype) \
+static void MaskBand##X( void *data, int *status ) { \
+\
+/* Local Variables: */ \
+   MaskBand *band;               /* Pointer to description of band */ \
+\
+/* Check the global error status. */ \
+   if ( !astOK ) return; \
+\
+/* Lock the private copy of the Region for use by this thread, mask the \
+   band, and then unlock the Region again so that the calling thread can \
+   annul it. */ \
+   band = (MaskBand *) data; \
+   astManageLock( band->region, AST__LOCK, 1, NULL ); \
+   band->result = astResample##X( band->region, band->ndim, band->lbnd, \
+                                  band->ubnd, (Xtype *) band->in, NULL, \
+                                  AST__NEAREST, NULL, NULL, 0, 0.0, 100, \
+                                  *( (const Xtype *) band->val ), \
+                                  band->ndim, band->lbnd, band->ubnd, \
+                                  band->lbndb, band->ubndb, \
+                                  (Xtype *) band->out, NULL ); \
+   astManageLock( band->region, AST__UNLOCK, 1, NULL ); \
+}
+
+/* Expand the above macro to generate a function for each required
+   data type. */
+#if HAVE_LONG_DOUBLE     /* Not normally implemented */
+MAKE_MASKBAND(LD,long double)
+#endif
+MAKE_MASKBAND(D,double)
+MAKE_MASKBAND(L,long int)
+MAKE_MASKBAND(UL,unsigned long int)
+MAKE_MASKBAND(I,int)
+MAKE_MASKBAND(UI,unsigned int)
+MAKE_MASKBAND(S,short int)
+MAKE_MASKBAND(US,unsigned short int)
+MAKE_MASKBAND(B,signed char)
+MAKE_MASKBAND(UB,unsigned char)
+MAKE_MASKBAND(F,float)
+
+/* Undefine the macro. */
+#undef MAKE_MASKBAND
+
+static MaskBand *MaskBands( AstRegion *this, int ndim, const int lbnd[],
+                            const int ubnd[], const int lbndg[],
+                            const int ubndg[], int *nband, int *status ){
+/*
+*  Name:
+*     MaskBands
+
+*  Purpose:
+*     Divide the bounding box of a Region into bands for parallel masking.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "region.h"
+*     MaskBand *MaskBands( AstRegion *this, int ndim, const int lbnd[],
+*                          const int ubnd[], const int lbndg[],
+*                          const int ubndg[], int *nband, int *status )
+
+*  Class Membership:
+*     Region member function
+
+*  Description:
+*     This function divides a box within a grid into bands along the
+*     last grid axis, so that each band can be masked by a separate
+*     thread using astRunJobs. Each band is given its own copy of the
+*     supplied Region, which is unlocked so that it can be locked by
+*     the thread that processes the band.
+*
+*     No bands are created if astRunJobs would use only one thread, or
+*     if there are too few pixels in the box to make it worthwhile.
+
+*  Parameters:
+*     this
+*        Pointer to the Region. Its current Frame should be the grid
+*        coordinate Frame.
+*     ndim
+*        The number of grid axes.
+*     lbnd
+*        The lower pixel index bounds of the whole grid.
+*     ubnd
+*        The upper pixel index bounds of the whole grid.
+*     lbndg
+*        The lower pixel index bounds of the box to be divided.
+*     ubndg
+*        The upper pixel index bounds of the box to be divided.
+*     nband
+*        Pointer to an int in which to return the number of bands.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A pointer to a newly allocated array of "*nband" MaskBand
+*     structures, in increasing order of pixel index on the last axis.
+*     The "region", "lbnd", "ubnd", "lbndb", "ubndb" and "ndim"
+*     components are set, and all other components are zeroed. It
+*     should be freed using FreeMaskBands when no longer needed. NULL is
+*     returned if no bands are created.
+
+*  Notes:
+*     - NULL is returned if an error has already occurred, or if
+*     this function should fail for any reason.
+*/
+
+/* Local Constants: */
+#define MINPIX 20000          /* Min. no. of pixels in each band */
+
+/* Local Variables: */
+   MaskBand *result;          /* Returned array */
+   double npix;               /* Number of pixels in box */
+   int iband;                 /* Index of current band */
+   int idim;                  /* Axis index */
+   int n;                     /* Maximum number of bands */
+   int nrow;                  /* Number of rows on last axis */
+   int nthread;               /* Number of threads */
+
+/* Initialise */
+   *nband = 0;
+   result = NULL;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Find the number of threads that astRunJobs will use. Use a few bands
+   for each thread so that the load is balanced even if some bands take
+   longer to mask than others. Each band should be a worthwhile amount
+   of work, and should contain at least one row. */
+   nthread = astGetNThread();
+   if( nthread < 2 ) return result;
+   npix = 1.0;
+   for( idim = 0; idim < ndim; idim++ ) {
+      npix *= ubndg[ idim ] - lbndg[ idim ] + 1;
+   }
+   nrow = ubndg[ ndim - 1 ] - lbndg[ ndim - 1 ] + 1;
+   n = 4*nthread;
+   if( n > npix/MINPIX ) n = (int)( npix/MINPIX );
+   if( n > nrow ) n = nrow;
+   if( n < 2 ) return result;
+
+/* Create the bands, dividing the rows as equally as possible between
+   them. */
+   result = astCalloc( n, sizeof( MaskBand ) );
+   if( astOK ) {
+      *nband = n;
+      for( iband = 0; iband < n; iband++ ) {
+         result[ iband ].lbnd = lbnd;
+         result[ iband ].ubnd = ubnd;
+         result[ iband ].ndim = ndim;
+         result[ iband ].lbndb = astStore( NULL, lbndg,
+                                           sizeof( int )*(size_t) ndim );
+         result[ iband ].ubndb = astStore( NULL, ubndg,
+                                           sizeof( int )*(size_t) ndim );
+         if( astOK ) {
+            result[ iband ].lbndb[ ndim - 1 ] = lbndg[ ndim - 1 ] +
+                                      (int)( ( (double) nrow*iband )/n );
+            result[ iband ].ubndb[ ndim - 1 ] = lbndg[ ndim - 1 ] +
+                                      (int)( ( (double) nrow*( iband + 1 ) )/n ) - 1;
+         }
+
+/* Give each band its own copy of the Region, and unlock it so that it
+   can be used by another thread. */
+         result[ iband ].region = astCopy( this );
+         astManageLock( result[ iband ].region, AST__UNLOCK, 1, NULL );
+      }
+   }
+
+/* Free the bands if anything went wrong. */
+   if( !astOK ) result = FreeMaskBands( result, *nband, status );
+   if( !result ) *nband = 0;
+
+/* Return the result. */
+   return result;
+
+/* Undefine local constants. */
+#undef MINPIX
+}
+
+static MaskBand *FreeMaskBands( MaskBand *bands, int nband, int *status ){
+/*
+*  Name:
+*     FreeMaskBands
+
+*  Purpose:
+*     Free the bands created by MaskBands.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "region.h"
+*     MaskBand *FreeMaskBands( MaskBand *bands, int nband, int *status )
+
+*  Class Membership:
+*     Region member function
+
+*  Description:
+*     This function locks and annuls the copy of the Region held by each
+*     band created by MaskBands, and then frees the bands. Any spans in
+*     the bands are also freed. It attempts to execute even if an error
+*     has already occurred.
+
+*  Parameters:
+*     bands
+*        Pointer to the array of bands. May be NULL.
+*     nband
+*        The number of bands.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A NULL pointer.
+*/
+
+/* Local Variables: */
+   int iband;                 /* Index of current band */
+
+/* Check the supplied pointer. */
+   if( !bands ) return NULL;
+
+/* Free the resources used by each band. */
+   for( iband = 0; iband < nband; iband++ ) {
+      if( bands[ iband ].region ) {
+         astManageLock( bands[ iband ].region, AST__LOCK, 1, NULL );
+         bands[ iband ].region = astAnnul( bands[ iband ].region );
+      }
+      bands[ iband ].lbndb = astFree( bands[ iband ].lbndb );
+      bands[ iband ].ubndb = astFree( bands[ iband ].ubndb );
+      bands[ iband ].spans = astFree( bands[ iband ].spans );
+   }
+
+/* Free the array of bands. */
+   return astFree( bands );
+}
+
+static int *MaskSpans( AstRegion *this, const int lbnd[], const int ubnd[],
+                       int *nspan, int *status ){
+/*
+*  Name:
+*     MaskSpans
+
+*  Purpose:
+*     Find the runs of pixels in a 2D grid that are inside a Region.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "region.h"
+*     int *MaskSpans( AstRegion *this, const int lbnd[], const int ubnd[],
+*                     int *nspan, int *status )
+
+*  Class Membership:
+*     Region member function
+
+*  Description:
+*     This function finds the runs of pixels within each row of a
+*     2-dimensional grid that have centres inside the supplied Region.
+*     It is used by the astMask<X> functions as a faster alternative to
+*     transforming every pixel. See FindSpans for details.
+*
+*     If astRunJobs can use more than one thread, the grid is divided
+*     into bands of rows which are processed in parallel. Runs never
+*     extend over more than one row, and so the runs found in each band
+*     are simply concatenated.
+
+*  Parameters:
+*     this
+*        Pointer to the Region. Its current Frame should be the 2D
+*        grid coordinate Frame.
+*     lbnd
+*        The lower pixel index bounds of the area to be checked.
+*     ubnd
+*        The upper pixel index bounds of the area to be checked.
+*     nspan
+*        Pointer to an int in which to return the number of runs.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A pointer to a newly allocated array holding three values for
+*     each run - the pixel index on axis 2, and the first and last pixel
+*     indices on axis 1. The runs are sorted into increasing order of
+*     axis 2 index, and then axis 1 index. It should be freed using
+*     astFree when no longer needed. NULL is returned (without error)
+*     if the runs cannot be found in this way.
+
+*  Notes:
+*     - NULL is returned if an error has already occurred, or if
+*     this function should fail for any reason.
+*/
+
+/* Local Variables: */
+   MaskBand *bands;           /* Bands of rows to process in parallel */
+   int *result;               /* Returned array */
+   int iband;                 /* Index of current band */
+   int nband;                 /* Number of bands */
+   int ok;                    /* Were runs found in every band? */
+
+/* Initialise */
+   *nspan = 0;
+   result = NULL;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Divide the grid into bands of rows. If this is not worthwhile, find
+   the runs in the whole grid at once. */
+   bands = MaskBands( this, 2, lbnd, ubnd, lbnd, ubnd, &nband, status );
+   if( !bands ) return FindSpans( this, lbnd, ubnd, nspan, status );
+
+/* Find the runs in each band in parallel. */
+   astRunJobs( nband, MaskSpansBand, bands, sizeof( MaskBand ) );
+
+/* Concatenate the runs found in each band. If the runs could not be
+   found in any band, return NULL. */
+   ok = astOK;
+   for( iband = 0; iband < nband && ok; iband++ ) {
+      if( bands[ iband ].spans ) {
+         *nspan += bands[ iband ].nspan;
+      } else {
+         ok = 0;
+      }
+   }
+   if( ok ) {
+      result = astMalloc( sizeof( int )*3*( *nspan + 1 ) );
+      if( astOK ) {
+         *nspan = 0;
+         for( iband = 0; iband < nband; iband++ ) {
+            memcpy( result + 3*( *nspan ), bands[ iband ].spans,
+                    sizeof( int )*3*bands[ iband ].nspan );
+            *nspan += bands[ iband ].nspan;
+         }
+      }
+   }
+   if( !result ) *nspan = 0;
+
+/* Free resources. */
+   bands = FreeMaskBands( bands, nband, status );
+
+/* Return the result. */
+   return result;
+}
+
+static void MaskSpansBand( void *data, int *status ){
+/*
+*  Name:
+*     MaskSpansBand
+
+*  Purpose:
+*     Find the runs of pixels inside a Region in one band of rows.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "region.h"
+*     void MaskSpansBand( void *data, int *status )
+
+*  Class Membership:
+*     Region member function
+
+*  Description:
+*     This function is run by astRunJobs to find the runs of pixels that
+*     are inside a Region within one band of rows, for MaskSpans.
+
+*  Parameters:
+*     data
+*        Pointer to a MaskBand structure describing the band. The runs
+*        are returned in its "spans" and "nspan" components.
+*     status
+*        Pointer to the inherited status variable.
+
+*/
+
+/* Local Variables: */
+   MaskBand *band;            /* Pointer to description of band */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Lock the private copy of the Region for use by this thread, find the
+   runs, and then unlock the Region again. */
+   band = (MaskBand *) data;
+   astManageLock( band->region, AST__LOCK, 1, NULL );
+   band->spans = FindSpans( band->region, band->lbndb, band->ubndb,
+                            &band->nspan, status );
+   astManageLock( band->region, AST__UNLOCK, 1, NULL );
+}
+
+static int *FindSpans( AstRegion *this, const int lbnd[], const int ubnd[],
+                       int *nspan, int *status ){
+/*
+*  Name:
+*     FindSpans
+
+*  Purpose:
+*     Find the runs of pixels in a 2D grid that are inside a Region.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "region.h"
+*     int *FindSpans( AstRegion *this, const int lbnd[], const int ubnd[],
+*                     int *nspan, int *status )
+
+*  Class Membership:
+*     Region member function
+
+*  Description:
+*     This function finds the runs of pixels within each row of a
+*     2-dimensional grid that have centres inside the supplied Region
+*     (as determined by the astTransform method of the Region, so that
+*     the Negated and Closed attributes are honoured). It is used by
+*     MaskSpans to process each band of rows.
+*
+*     It can only be used if the Mapping from the current Frame of the
+*     Region (grid coordinates) to its base Frame is linear, and if the
+*     class of the Region implements the astRegLineCross method. Each
+*     row of the grid then maps onto a straight line in the base Frame,
+*     and astRegLineCross gives the places where the line may cross the
+*     boundary. Pixels within one pixel of any such place are
+*     transformed individually. Each remaining run of pixels between
+*     two such places must be either wholly inside or wholly outside the
+*     Region, and so only its first pixel needs to be transformed.
+
+*  Parameters:
+*     this
+*        Pointer to the Region. Its current Frame should be the 2D
+*        grid coordinate Frame.
+*     lbnd
+*        The lower pixel index bounds of the area to be checked.
+*     ubnd
+*        The upper pixel index bounds of the area to be checked.
+*     nspan
+*        Pointer to an int in which to return the number of runs.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A pointer to a newly allocated array holding three values for
+*     each run - the pixel index on axis 2, and the first and last pixel
+*     indices on axis 1. The runs are sorted into increasing order of
+*     axis 2 index, and then axis 1 index. It should be freed using
+*     astFree when no longer needed. NULL is returned (without error)
+*     if the runs cannot be found in this way.
+
+*  Notes:
+*     - NULL is returned if an error has already occurred, or if
+*     this function should fail for any reason.
+*/
+
+/* Local Constants: */
+#define MAXPIECE 100000       /* Max. no. of pixels transformed at once */
+
+/* Local Variables: */
+   AstMapping *map;           /* Grid to base Frame Mapping */
+   AstMapping *smap;          /* Simplified grid to base Frame Mapping */
+   AstPointSet *pset_in;      /* Pixels to be transformed */
+   AstPointSet *pset_out;     /* Transformed pixels */
+   double **ptr_in;           /* Pointers to pixel positions */
+   double **ptr_out;          /* Pointers to transformed positions */
+   double *cross;             /* Crossing intervals for current row */
+   double ax[ 2 ];            /* Base Frame step per unit change in axis 1 */
+   double ay[ 2 ];            /* Base Frame step per unit change in axis 2 */
+   double gx[ 3 ];            /* Grid axis 1 values at test points */
+   double gy[ 3 ];            /* Grid axis 2 values at test points */
+   double bx[ 3 ];            /* Base axis 1 values at test points */
+   double by[ 3 ];            /* Base axis 2 values at test points */
+   double start[ 2 ];         /* Base Frame position of row start */
+   double tlo;                /* Lower end of crossing interval */
+   double thi;                /* Upper end of crossing interval */
+   int *piece;                /* Row, first and last pixel for each piece */
+   int *range;                /* First and last pixel of each exact range */
+   int *result;               /* Returned array */
+   int e1;                    /* First pixel in an exact range */
+   int e2;                    /* Last pixel in an exact range */
+   int i;                     /* Index of current range */
+   int ip;                    /* Index of current piece */
+   int j;                     /* Index of another range */
+   int k;                     /* Crossing index */
+   int last;                  /* Index of last run */
+   int ncross;                /* No. of crossings in current row */
+   int npiece;                /* No. of pieces waiting to be transformed */
+   int nrange;                /* No. of exact ranges in current row */
+   int nx;                    /* Number of pixels in each row */
+   int ok;                    /* Can the runs be found? */
+   int tmp;                   /* Used for swapping range ends */
+   int x;                     /* Axis 1 pixel index */
+   int y;                     /* Axis 2 pixel index */
+
+/* Initialise */
+   *nspan = 0;
+   result = NULL;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Check the Region is 2-dimensional and that the Mapping from grid
+   coordinates to the base Frame is linear. */
+   if( astGetNaxes( this ) != 2 ) return result;
+   map = astGetMapping( this->frameset, AST__CURRENT, AST__BASE );
+   smap = astSimplify( map );
+   map = astAnnul( map );
+   ok = ( astGetNout( smap ) == 2 && astGetTranForward( smap ) &&
+          astGetIsLinear( smap ) );
+
+/* If so, find the base Frame position of the first pixel, and the
+   change in base Frame position per unit change in each grid axis. */
+   if( ok ) {
+      gx[ 0 ] = lbnd[ 0 ];
+      gy[ 0 ] = lbnd[ 1 ];
+      gx[ 1 ] = lbnd[ 0 ] + 1.0;
+      gy[ 1 ] = lbnd[ 1 ];
+      gx[ 2 ] = lbnd[ 0 ];
+      gy[ 2 ] = lbnd[ 1 ] + 1.0;
+      astTran2( smap, 3, gx, gy, 1, bx, by );
+      ax[ 0 ] = bx[ 1 ] - bx[ 0 ];
+      ax[ 1 ] = by[ 1 ] - by[ 0 ];
+      ay[ 0 ] = bx[ 2 ] - bx[ 0 ];
+      ay[ 1 ] = by[ 2 ] - by[ 0 ];
+      if( !astOK || bx[ 0 ] == AST__BAD || by[ 0 ] == AST__BAD ||
+          bx[ 1 ] == AST__BAD || by[ 1 ] == AST__BAD ||
+          bx[ 2 ] == AST__BAD || by[ 2 ] == AST__BAD ) ok = 0;
+   }
+   smap = astAnnul( smap );
+
+/* Allocate work space. The "piece" array describes the pixels in the
+   rows processed so far. Each piece is either a single pixel close to
+   the boundary, or a run of pixels between two such pixels. Only the
+   first pixel in each piece is transformed. */
+   nx = ubnd[ 0 ] - lbnd[ 0 ] + 1;
+   piece = ok ? astMalloc( sizeof( int )*3*( MAXPIECE + nx ) ) : NULL;
+   range = NULL;
+   npiece = 0;
+   last = -1;
+
+/* Loop round each row. */
+   for( y = lbnd[ 1 ]; y <= ubnd[ 1 ] + 1 && ok && astOK; y++ ) {
+
+/* Unless we have passed the last row, find the places at which the row
+   crosses the boundary of the Region. */
+      if( y <= ubnd[ 1 ] ) {
+         start[ 0 ] = bx[ 0 ] + ( y - lbnd[ 1 ] )*ay[ 0 ];
+         start[ 1 ] = by[ 0 ] + ( y - lbnd[ 1 ] )*ay[ 1 ];
+         ncross = astRegLineCross( this, start, ax, &cross );
+         if( ncross < 0 ) {
+            ok = 0;
+            break;
+         }
+
+/* Convert each crossing into the range of pixels that must be
+   transformed individually - those within one pixel of the crossing.
+   "t" is the offset in pixels from the first pixel in the row. Ignore
+   crossings that are outside the row. */
+         range = astGrow( range, 2*ncross + 2, sizeof( int ) );
+         nrange = 0;
+         for( k = 0; k < ncross && astOK; k++ ) {
+            tlo = astMIN( cross[ 2*k ], cross[ 2*k + 1 ] );
+            thi = astMAX( cross[ 2*k ], cross[ 2*k + 1 ] );
+            if( astISNAN( tlo ) || astISNAN( thi ) ) {
+               ok = 0;
+               break;
+            }
+            if( thi < -2.0 || tlo > nx + 1.0 ) continue;
+            if( tlo < -2.0 ) tlo = -2.0;
+            if( thi > nx + 1.0 ) thi = nx + 1.0;
+            e1 = astMAX( 0, (int) ceil( tlo ) - 1 );
+            e2 = astMIN( nx - 1, (int) floor( thi ) + 1 );
+            if( e1 <= e2 ) {
+               range[ 2*nrange ] = e1;
+               range[ 2*nrange + 1 ] = e2;
+               nrange++;
+            }
+         }
+         cross = astFree( cross );
+         if( !ok || !astOK ) break;
+
+/* Sort the ranges into increasing order of first pixel (there are
+   usually very few of them). */
+         for( i = 1; i < nrange; i++ ) {
+            for( j = i; j > 0 && range[ 2*j - 2 ] > range[ 2*j ]; j-- ) {
+               tmp = range[ 2*j - 2 ];
+               range[ 2*j - 2 ] = range[ 2*j ];
+               range[ 2*j ] = tmp;
+               tmp = range[ 2*j - 1 ];
+               range[ 2*j - 1 ] = range[ 2*j + 1 ];
+               range[ 2*j + 1 ] = tmp;
+            }
+         }
+
+/* Divide the row into pieces. Each pixel in an exact range is a
+   separate piece. Any pixels between exact ranges form a single piece. */
+         x = 0;
+         for( i = 0; i < nrange; i++ ) {
+            e1 = astMAX( x, range[ 2*i ] );
+            e2 = range[ 2*i + 1 ];
+            if( e1 > x ) {
+               piece[ 3*npiece ] = y;
+               piece[ 3*npiece + 1 ] = x;
+               piece[ 3*npiece + 2 ] = e1 - 1;
+               npiece++;
+            }
+            for( x = e1; x <= e2; x++ ) {
+               piece[ 3*npiece ] = y;
+               piece[ 3*npiece + 1 ] = x;
+               piece[ 3*npiece + 2 ] = x;
+               npiece++;
+            }
+         }
+         if( x < nx ) {
+            piece[ 3*npiece ] = y;
+            piece[ 3*npiece + 1 ] = x;
+            piece[ 3*npiece + 2 ] = nx - 1;
+            npiece++;
+         }
+      }
+
+/* Once enough pieces have been found (or the last row has been
+   processed), transform the first pixel of each piece. The number of
+   pieces differs from batch to batch, and astSetNpoint can only reduce
+   the size of a PointSet, so a new PointSet is used for each batch. */
+      if( npiece > 0 && ( npiece >= MAXPIECE || y > ubnd[ 1 ] ) ) {
+         pset_in = astPointSet( npiece, 2, "", status );
+         ptr_in = astGetPoints( pset_in );
+         if( astOK ) {
+            for( ip = 0; ip < npiece; ip++ ) {
+               ptr_in[ 0 ][ ip ] = lbnd[ 0 ] + piece[ 3*ip + 1 ];
+               ptr_in[ 1 ][ ip ] = piece[ 3*ip ];
+            }
+         }
+         pset_out = astTransform( this, pset_in, 1, NULL );
+         ptr_out = astGetPoints( pset_out );
+
+/* Append each piece that is inside the Region to the returned list of
+   runs, merging it with the previous run if they are contiguous. */
+         if( astOK ) {
+            for( ip = 0; ip < npiece; ip++ ) {
+               if( ptr_out[ 0 ][ ip ] != AST__BAD ) {
+                  if( last >= 0 && result[ 3*last ] == piece[ 3*ip ] &&
+                      result[ 3*last + 2 ] == lbnd[ 0 ] + piece[ 3*ip + 1 ] - 1 ) {
+                     result[ 3*last + 2 ] = lbnd[ 0 ] + piece[ 3*ip + 2 ];
+                  } else {
+                     result = astGrow( result, 3*( last + 2 ), sizeof( int ) );
+                     if( !astOK ) break;
+                     last++;
+                     result[ 3*last ] = piece[ 3*ip ];
+                     result[ 3*last + 1 ] = lbnd[ 0 ] + piece[ 3*ip + 1 ];
+                     result[ 3*last + 2 ] = lbnd[ 0 ] + piece[ 3*ip + 2 ];
+                  }
+               }
+            }
+         }
+         pset_out = astAnnul( pset_out );
+         pset_in = astAnnul( pset_in );
+         npiece = 0;
+      }
+   }
+
+/* Free resources. */
+   piece = astFree( piece );
+   range = astFree( range );
+
+/* If the runs could not be found, or an error occurred, return NULL.
+   Otherwise return the number of runs. A non-NULL pointer must be
+   returned even if no pixels are inside the Region. */
+   if( !ok || !astOK ) {
+      result = astFree( result );
+   } else {
+      *nspan = last + 1;
+      if( !result ) result = astMalloc( sizeof( int )*3 );
+   }
+
+   return result;
+
+/* Undefine local constants. */
+#undef MAXPIECE
+}
 
 
 static int Match( AstFrame *this_frame, AstFrame *target, int matchsub,
@@ -6853,7 +7956,10 @@ static int OverlapX( AstRegion *that, AstRegion *this, int *status ){
    AstFrameSet *fs;               /* FrameSet connecting Region Frames */
    AstMapping *cmap;              /* Mapping connecting Region Frames */
    AstMapping *map;               /* Mapping form "reg2" current to "reg1" base */
+   AstMapping *key;               /* Mapping used to transform cached mesh */
    AstMapping *map_reg1;          /* Pointer to current->base Mapping in "reg1" */
+   AstMapping *map_that;          /* Pointer to base->current Mapping */
+   AstMapping *smap;              /* Simplified Mapping */
    AstPointSet *ps1;              /* Mesh covering second Region */
    AstPointSet *ps3;              /* Mesh covering first Region */
    AstPointSet *ps4;              /* Mesh covering first Region */
@@ -6861,11 +7967,17 @@ static int OverlapX( AstRegion *that, AstRegion *this, int *status ){
    AstPointSet *reg2_mesh;        /* Mesh covering second Region */
    AstPointSet *reg1_mesh;        /* Mesh covering first Region */
    AstPointSet *reg2_submesh;     /* Second Region mesh minus boundary points */
+   AstRegion *neg;                /* Negated copy of "this" */
    AstRegion *reg1;               /* Region to use as the first Region */
    AstRegion *reg2;               /* Region to use as the second Region */
    AstRegion *unc1;               /* "unc" mapped into Frame of first Region */
    AstRegion *unc;                /* Uncertainty in second Region */
    double **ptr1;                 /* Pointer to mesh axis values */
+   double *cen_that;              /* Centre of cap enclosing "that" */
+   double *cen_this;              /* Centre of cap enclosing "this" */
+   double dist;                   /* Distance between cap centres */
+   double rad_that;               /* Radius of cap enclosing "that" */
+   double rad_this;               /* Radius of cap enclosing "this" */
    double **ptr;                  /* Pointer to pointset data */
    double *p;                     /* Pointer to next axis value */
    int *mask;                     /* Mask identifying common boundary points */
@@ -6903,11 +8015,12 @@ static int OverlapX( AstRegion *that, AstRegion *this, int *status ){
       return 5;
 
 /* Return 6 if the two Regions are equal using the Equal method after
-   temporarily negating the first. */
+   negating the first. Use the cached negated copy rather than negating
+   "this" in place, since that would also discard any cached meshes. */
    } else {
-      astNegate( this );
-      result = astEqual( this, that );
-      astNegate( this );
+      neg = astGetNegation( this );
+      result = astEqual( neg, that );
+      neg = astAnnul( neg );
       if( result ) return 6;
    }
 
@@ -6960,6 +8073,41 @@ static int OverlapX( AstRegion *that, AstRegion *this, int *status ){
       that_neg = 0;
    }
 
+/* If both Regions are bounded without negation, and they share a common
+   base Frame, compare the caps enclosing them. If the caps are separated
+   there can be no overlap, and there is no need to compare the meshes.
+   The cap radii include the mesh spacing and the uncertainties, so the
+   mesh comparison below would also find no overlap. */
+   if( bnd_this && bnd_that && !this_neg && !that_neg ) {
+      map_that = astGetMapping( that->frameset, AST__BASE, AST__CURRENT );
+      cmap = astGetMapping( fs0, AST__BASE, AST__CURRENT );
+      map_reg1 = astGetMapping( this->frameset, AST__CURRENT, AST__BASE );
+      map = (AstMapping *) astCmpMap( map_that, cmap, 1, "", status );
+      key = (AstMapping *) astCmpMap( map, map_reg1, 1, "", status );
+      smap = astSimplify( key );
+      if( astIsAUnitMap( smap ) ) {
+         rad_that = BaseCap( that, &cen_that, status );
+         rad_this = BaseCap( this, &cen_this, status );
+         if( rad_that >= 0.0 && rad_this >= 0.0 ) {
+            bfrm_reg1 = astGetFrame( this->frameset, AST__BASE );
+            dist = astDistance( bfrm_reg1, cen_this, cen_that );
+            if( dist != AST__BAD && dist > rad_this + rad_that ) result = 1;
+            bfrm_reg1 = astAnnul( bfrm_reg1 );
+         }
+      }
+      map_that = astAnnul( map_that );
+      cmap = astAnnul( cmap );
+      map_reg1 = astAnnul( map_reg1 );
+      map = astAnnul( map );
+      key = astAnnul( key );
+      smap = astAnnul( smap );
+
+      if( result == 1 || !astOK ) {
+         fs0 = astAnnul( fs0 );
+         return astOK ? result : 0;
+      }
+   }
+
 /* If neither Regions has a finite boundary, then we cannot currently
    determine any overlap, so report an error. Given more time, it
    is probably possible to think of some way of determining overlap
@@ -7025,8 +8173,27 @@ L1:
    within the current Frame of the second Region. */
       reg2_mesh = astRegMesh( reg2 );
 
-/* Transform this mesh into the base Frame of the first Region. */
-      ps1 = astTransform( map, reg2_mesh, 1, NULL );
+/* Transform this mesh into the base Frame of the first Region. The
+   transformed mesh is cached in the second Region, together with the
+   total Mapping from its base Frame, so that it can be re-used if the
+   Region is compared with other Regions that have the same base Frame
+   (e.g. a set of tiles compared with a single field). A deep copy of the
+   Mapping is cached so that the Region shares no Objects with the other
+   Region. */
+      map_that = astGetMapping( reg2->frameset, AST__BASE, AST__CURRENT );
+      key = (AstMapping *) astCmpMap( map_that, map, 1, "", status );
+      map_that = astAnnul( map_that );
+      if( reg2->overmesh && astEqual( key, reg2->overmap ) ) {
+         ps1 = astClone( reg2->overmesh );
+         key = astAnnul( key );
+      } else {
+         ps1 = astTransform( map, reg2_mesh, 1, NULL );
+         if( reg2->overmap ) (void) astAnnul( reg2->overmap );
+         if( reg2->overmesh ) (void) astAnnul( reg2->overmesh );
+         reg2->overmap = astCopy( key );
+         reg2->overmesh = astClone( ps1 );
+         key = astAnnul( key );
+      }
 
 /* Check there are some good points in the transformed pointset. */
       good = 0;
@@ -9770,6 +10937,10 @@ static void ResetCache( AstRegion *this, int *status ){
       if( this->basemesh ) this->basemesh = astAnnul( this->basemesh );
       if( this->basegrid ) this->basegrid = astAnnul( this->basegrid );
       if( this->negation ) this->negation = astAnnul( this->negation );
+      if( this->overmap ) this->overmap = astAnnul( this->overmap );
+      if( this->overmesh ) this->overmesh = astAnnul( this->overmesh );
+      this->capcen = astFree( this->capcen );
+      this->caprad = AST__BAD;
    }
 }
 
@@ -10566,6 +11737,62 @@ f        The global status.
    }
 }
 
+static int SigCmp( const void *a, const void *b ){
+/*
+*  Name:
+*     SigCmp
+
+*  Purpose:
+*     Compare two RegionSig structures.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "region.h"
+*     int SigCmp( const void *a, const void *b )
+
+*  Class Membership:
+*     Region member function
+
+*  Description:
+*     This function is a qsort comparison function for the RegionSig
+*     structures used by astRegionsContain. Structures are ordered first
+*     by the number of base Frame axis values, then by the bit patterns of
+*     the axis values themselves, and finally by Region index. Comparing
+*     bit patterns rather than values gives a consistent ordering even if
+*     some of the values are NaN.
+
+*  Parameters:
+*     a
+*        Pointer to the first RegionSig.
+*     b
+*        Pointer to the second RegionSig.
+
+*  Returned Value:
+*     Negative, zero or positive if "a" should be placed before, at the
+*     same position as, or after "b".
+
+*/
+
+/* Local Variables: */
+   const RegionSig *sa;
+   const RegionSig *sb;
+   int result;
+
+   sa = (const RegionSig *) a;
+   sb = (const RegionSig *) b;
+
+   if( sa->nval != sb->nval ) {
+      result = ( sa->nval < sb->nval ) ? -1 : 1;
+   } else {
+      result = memcmp( sa->val, sb->val, sizeof( double )*(size_t) sa->nval );
+      if( !result ) result = sa->ireg - sb->ireg;
+   }
+
+   return result;
+}
+
 static AstMapping *Simplify( AstMapping *this_mapping, int *status ) {
 /*
 *  Name:
@@ -11118,6 +12345,76 @@ static const char *SystemString( AstFrame *this_frame, AstSystemType system, int
 
 }
 
+static int RegLineCross( AstRegion *this, const double start[],
+                         const double step[], double **cross, int *status ){
+/*
+*+
+*  Name:
+*     astRegLineCross
+
+*  Purpose:
+*     Find where a straight line crosses the boundary of a 2D Region.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "region.h"
+*     int astRegLineCross( AstRegion *this, const double start[],
+*                          const double step[], double **cross )
+
+*  Class Membership:
+*     Region virtual function
+
+*  Description:
+*     This function finds the places at which a straight line in the
+*     base Frame of a 2-dimensional Region may cross the boundary of the
+*     Region. The line is given by "start + t*step", where "t" is a
+*     scalar parameter, and the returned positions are expressed as
+*     values of "t".
+*
+*     Each returned crossing is an interval of "t". At any two points
+*     on the line that are separated by no returned interval, the
+*     astTransform method of the Region is guaranteed to give the same
+*     result (inside or outside) apart from rounding errors in the
+*     positions of the interval ends. A crossing that occurs at a single
+*     point is returned as an interval of zero width. Spurious crossings
+*     may be returned, but no true crossing may be omitted.
+*
+*     It is used, for instance, to determine which pixels in a row of a
+*     grid are inside a Region without transforming every pixel.
+
+*  Parameters:
+*     this
+*        Pointer to the Region.
+*     start
+*        The base Frame axis values at "t = 0".
+*     step
+*        The change in the base Frame axis values per unit increase
+*        in "t".
+*     cross
+*        Address at which to return a pointer to a newly allocated array
+*        holding the lower and upper "t" values of each crossing
+*        interval (i.e. two values per crossing, in no particular order
+*        of crossings). It should be freed using astFree when no longer
+*        needed. A NULL pointer is returned if no crossings are found, or
+*        if the method is not supported.
+
+*  Returned Value:
+*     The number of crossings found, or -1 if this method is not
+*     implemented by the class of Region supplied, or cannot be used
+*     with the Frame in which the Region is defined (for instance,
+*     because the boundary is not made of straight lines and conic
+*     sections in that Frame).
+
+*-
+*/
+
+/* Concrete sub-classes of Region may over-ride this method. */
+   *cross = NULL;
+   return -1;
+}
+
 static int RegTrace( AstRegion *this, int n, double *dist, double **ptr, int *status ){
 /*
 *+
@@ -11457,6 +12754,381 @@ double *astRegTranPoint_( AstRegion *this, double *in, int np, int forward, int
    return result;
 }
 
+int astRegionsContain_( int nreg, AstRegion **regs, int npoint, int ncoord,
+                        int indim, const double *in, int *inside,
+                        int *status ){
+/*
+*+
+*  Name:
+*     astRegionsContain
+
+*  Purpose:
+*     Test many points against many Regions.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "region.h"
+*     int astRegionsContain( int nreg, AstRegion **regs, int npoint,
+*                            int ncoord, int indim, const double *in,
+*                            int *inside )
+
+*  Class Membership:
+*     Region member function
+
+*  Description:
+*     This function is the protected implementation of the public
+*     astRegionsContain function (see astRegionsContainId_), and takes
+*     true C pointers to the Regions rather than Object identifiers.
+*
+*     Calling astTransform once for each Region would transform the points
+*     into the base Frame of each Region in turn. Instead, the Regions are
+*     first put into groups that have equal base->current Mappings, and
+*     the points are transformed into the base Frame only once for each
+*     group. Each Region in the group then tests the base Frame positions
+*     directly using astBTransform. To find the groups cheaply, a few of
+*     the supplied points are transformed into the base Frame of every
+*     Region and the Regions are sorted by the resulting axis values, so
+*     that astEqual is only used to compare Regions which put these
+*     probe points at the same base Frame positions.
+
+*  Parameters:
+*     nreg
+*        The number of Regions.
+*     regs
+*        Array of "nreg" Region pointers.
+*     npoint
+*        The number of points to be tested.
+*     ncoord
+*        The number of axis values supplied for each point.
+*     indim
+*        The number of elements along the second dimension of the "in"
+*        array.
+*     in
+*        The address of the first element in a 2-dimensional array of
+*        shape "[ncoord][indim]" holding the point positions.
+*     inside
+*        The address of the first element in a 2-dimensional array of
+*        shape "[nreg][npoint]" in which to return the membership flags.
+
+*  Returned Value:
+*     The number of points that are inside at least one of the Regions.
+
+*  Notes:
+*     - Zero is returned if an error has already occurred, or if this
+*     function should fail for any reason.
+*-
+*/
+
+/* Local Variables: */
+   AstMapping **maps;            /* Simplified base->current Mapping for each Region */
+   AstPointSet *pset_base;       /* Supplied positions in a group's base Frame */
+   AstPointSet *pset_in;         /* Supplied positions */
+   AstPointSet *pset_one;        /* A single supplied position */
+   AstPointSet *pset_out;        /* Base Frame positions masked by one Region */
+   AstPointSet *pset_pb;         /* Probe positions in a base Frame */
+   AstPointSet *pset_probe;      /* Probe positions */
+   AstPointSet *pset_tst;        /* A single position tested by one Region */
+   RegionSig *sigs;              /* Probe signature for each Region */
+   const double **ptr_in;        /* Pointers to supplied axis values */
+   double **ptr_base;            /* Pointers to base Frame axis values */
+   double **ptr_one;             /* Pointers to single position axis values */
+   double **ptr_out;             /* Pointers to masked axis values */
+   double **ptr_pb;              /* Pointers to base Frame probe axis values */
+   double **ptr_probe;           /* Pointers to probe axis values */
+   double **ptr_tst;             /* Pointers to tested position axis values */
+   double *sigval;               /* Base Frame axis values for all probes */
+   int *allbad;                  /* Are all base Frame axis values bad? */
+   int *curgood;                 /* Is any supplied axis value good? */
+   int *flags;                   /* Membership flags for one Region */
+   int *found;                   /* Is the point inside any Region? */
+   int *next;                    /* Next Region in the same group */
+   int *offset;                  /* Offset of each Region's values in "sigval" */
+   int *rep;                     /* First Region in the group of each Region */
+   int badin;                    /* Are points with bad base positions inside? */
+   int iax;                      /* Axis index */
+   int ip;                       /* Point index */
+   int ireg;                     /* Region index */
+   int irep;                     /* Index of a point with a bad base position */
+   int is;                       /* Index into sorted signatures */
+   int isin;                     /* Is the point inside the Region? */
+   int jreg;                     /* Region index */
+   int js;                       /* Index of first signature in current run */
+   int ks;                       /* Index into sorted signatures */
+   int nbase;                    /* Number of base Frame axes */
+   int nprobe;                   /* Number of probe points */
+   int nval;                     /* Number of values stored in "sigval" */
+   int probe[ 3 ];               /* Indices of the probe points */
+   int result;                   /* Returned value */
+
+/* Initialise. */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Validate the arguments. */
+   if( nreg < 1 ) {
+      astError( AST__BDPAR, "astRegionsContain(Region): Bad number of "
+                "Regions (%d) - must be at least 1.", status, nreg );
+
+   } else if( npoint < 0 ) {
+      astError( AST__NPTIN, "astRegionsContain(Region): Number of points "
+                "to be tested (%d) is invalid.", status, npoint );
+
+   } else if( indim < npoint ) {
+      astError( AST__DIMIN, "astRegionsContain(Region): The input array "
+                "dimension value (%d) is invalid.", status, indim );
+      astError( AST__DIMIN, "This should not be less than the number of "
+                "points being tested (%d).", status, npoint );
+   }
+
+   for( ireg = 0; ireg < nreg && astOK; ireg++ ) {
+      if( astGetNaxes( regs[ ireg ] ) != ncoord ) {
+         astError( AST__NCPIN, "astRegionsContain(%s): Bad number of "
+                   "coordinate values (%d).", status,
+                   astGetClass( regs[ ireg ] ), ncoord );
+         astError( AST__NCPIN, "Region %d requires %d coordinate value%s "
+                   "for each point.", status, ireg + 1,
+                   astGetNaxes( regs[ ireg ] ),
+                   ( astGetNaxes( regs[ ireg ] ) == 1 ) ? "" : "s" );
+      }
+   }
+
+/* Nothing more to do if there are no points. */
+   if( !astOK || npoint == 0 ) return result;
+
+/* Allocate work arrays. */
+   ptr_in = (const double **) astMalloc( sizeof( const double * )*
+                                         (size_t) ncoord );
+   maps = astCalloc( nreg, sizeof( AstMapping * ) );
+   sigs = astMalloc( sizeof( RegionSig )*(size_t) nreg );
+   offset = astMalloc( sizeof( int )*(size_t) nreg );
+   rep = astMalloc( sizeof( int )*(size_t) nreg );
+   next = astMalloc( sizeof( int )*(size_t) nreg );
+   curgood = astMalloc( sizeof( int )*(size_t) npoint );
+   allbad = astMalloc( sizeof( int )*(size_t) npoint );
+   found = astCalloc( npoint, sizeof( int ) );
+   sigval = NULL;
+
+   if( astOK ) {
+
+/* Create a PointSet that describes the supplied points without copying
+   them (note we must explicitly remove the "const" qualifier here,
+   although the values will not be modified). */
+      for( iax = 0; iax < ncoord; iax++ ) ptr_in[ iax ] = in + iax*indim;
+      pset_in = astPointSet( npoint, ncoord, "", status );
+      astSetPoints( pset_in, (double **) ptr_in );
+
+/* Note which points have at least one good axis value. Region
+   astTransform methods copy supplied positions for points that are
+   inside, so a point with no good axis values can never be seen to be
+   inside a Region. */
+      for( ip = 0; ip < npoint; ip++ ) {
+         curgood[ ip ] = 0;
+         for( iax = 0; iax < ncoord; iax++ ) {
+            if( ptr_in[ iax ][ ip ] != AST__BAD ) {
+               curgood[ ip ] = 1;
+               break;
+            }
+         }
+      }
+
+/* Choose up to three probe points - the first, middle and last. */
+      nprobe = ( npoint < 3 ) ? npoint : 3;
+      probe[ 0 ] = 0;
+      probe[ 1 ] = ( nprobe == 3 ) ? npoint/2 : nprobe - 1;
+      probe[ 2 ] = npoint - 1;
+
+      pset_probe = astPointSet( nprobe, ncoord, "", status );
+      ptr_probe = astGetPoints( pset_probe );
+      if( astOK ) {
+         for( iax = 0; iax < ncoord; iax++ ) {
+            for( ip = 0; ip < nprobe; ip++ ) {
+               ptr_probe[ iax ][ ip ] = ptr_in[ iax ][ probe[ ip ] ];
+            }
+         }
+      }
+
+/* Get the simplified base->current Mapping for each Region, and use it
+   to transform the probe points into the base Frame. Store the
+   resulting axis values as the Region's signature. */
+      nval = 0;
+      for( ireg = 0; ireg < nreg && astOK; ireg++ ) {
+         maps[ ireg ] = astRegMapping( regs[ ireg ] );
+         nbase = astGetNin( maps[ ireg ] );
+
+         pset_pb = astTransform( maps[ ireg ], pset_probe, 0, NULL );
+         ptr_pb = astGetPoints( pset_pb );
+         sigval = astGrow( sigval, nval + nbase*nprobe, sizeof( double ) );
+         if( astOK ) {
+            offset[ ireg ] = nval;
+            for( iax = 0; iax < nbase; iax++ ) {
+               for( ip = 0; ip < nprobe; ip++ ) {
+                  sigval[ nval++ ] = ptr_pb[ iax ][ ip ];
+               }
+            }
+            sigs[ ireg ].ireg = ireg;
+            sigs[ ireg ].nval = nbase*nprobe;
+         }
+         pset_pb = astAnnul( pset_pb );
+      }
+
+/* Sort the signatures so that Regions which may have equal Mappings are
+   adjacent. */
+      if( astOK ) {
+         for( ireg = 0; ireg < nreg; ireg++ ) {
+            sigs[ ireg ].val = sigval + offset[ ireg ];
+         }
+         qsort( sigs, (size_t) nreg, sizeof( RegionSig ), SigCmp );
+      }
+
+/* Form the groups. Each Region is compared only with the first Region in
+   each group found so far within the current run of equal signatures.
+   The Regions in each group are held in a list starting at the first
+   Region in the group, linked through the "next" array. */
+      js = 0;
+      for( is = 0; is < nreg && astOK; is++ ) {
+         ireg = sigs[ is ].ireg;
+         if( sigs[ is ].nval != sigs[ js ].nval ||
+             memcmp( sigs[ is ].val, sigs[ js ].val,
+                     sizeof( double )*(size_t) sigs[ is ].nval ) ) js = is;
+
+         rep[ ireg ] = ireg;
+         next[ ireg ] = -1;
+         for( ks = js; ks < is; ks++ ) {
+            jreg = sigs[ ks ].ireg;
+            if( rep[ jreg ] == jreg && astEqual( maps[ jreg ], maps[ ireg ] ) ) {
+               rep[ ireg ] = jreg;
+               next[ ireg ] = next[ jreg ];
+               next[ jreg ] = ireg;
+               break;
+            }
+         }
+      }
+
+/* Loop round each group. */
+      for( ireg = 0; ireg < nreg && astOK; ireg++ ) {
+         if( rep[ ireg ] == ireg ) {
+
+/* Transform the supplied points into the base Frame shared by the
+   Regions in the group. */
+            if( astIsAUnitMap( maps[ ireg ] ) ) {
+               pset_base = astClone( pset_in );
+            } else {
+               pset_base = astTransform( maps[ ireg ], pset_in, 0, NULL );
+            }
+            nbase = astGetNin( maps[ ireg ] );
+            ptr_base = astGetPoints( pset_base );
+
+            pset_out = astPointSet( npoint, nbase, "", status );
+            ptr_out = astGetPoints( pset_out );
+
+/* Note the points that have no good base Frame axis values, and find one
+   such point that has a good supplied axis value. */
+            irep = -1;
+            if( astOK ) {
+               for( ip = 0; ip < npoint; ip++ ) {
+                  allbad[ ip ] = 1;
+                  for( iax = 0; iax < nbase; iax++ ) {
+                     if( ptr_base[ iax ][ ip ] != AST__BAD ) {
+                        allbad[ ip ] = 0;
+                        break;
+                     }
+                  }
+                  if( allbad[ ip ] && curgood[ ip ] && irep == -1 ) irep = ip;
+               }
+            }
+
+/* Test the points against each Region in the group. */
+            for( jreg = ireg; jreg != -1 && astOK; jreg = next[ jreg ] ) {
+               (void) astBTransform( regs[ jreg ], pset_base, 1, pset_out );
+
+/* A Region sets every output axis value bad for a point that is outside,
+   and copies the base Frame position for a point that is inside. So a
+   point with no good base Frame axis values looks the same either way.
+   The Region sees the same base Frame position for all such points
+   though, so find out if they are inside by testing just one of them in
+   the usual way. */
+               badin = 0;
+               if( irep != -1 ) {
+                  pset_one = astPointSet( 1, ncoord, "", status );
+                  ptr_one = astGetPoints( pset_one );
+                  if( astOK ) {
+                     for( iax = 0; iax < ncoord; iax++ ) {
+                        ptr_one[ iax ][ 0 ] = ptr_in[ iax ][ irep ];
+                     }
+                     pset_tst = astTransform( regs[ jreg ], pset_one, 1, NULL );
+                     ptr_tst = astGetPoints( pset_tst );
+                     if( astOK ) {
+                        for( iax = 0; iax < ncoord; iax++ ) {
+                           if( ptr_tst[ iax ][ 0 ] != AST__BAD ) badin = 1;
+                        }
+                     }
+                     pset_tst = astAnnul( pset_tst );
+                  }
+                  pset_one = astAnnul( pset_one );
+               }
+
+/* Store the membership flags for the Region. */
+               if( astOK ) {
+                  flags = inside + (size_t) jreg*(size_t) npoint;
+                  for( ip = 0; ip < npoint; ip++ ) {
+                     if( !curgood[ ip ] ) {
+                        isin = 0;
+                     } else if( allbad[ ip ] ) {
+                        isin = badin;
+                     } else {
+                        isin = 0;
+                        for( iax = 0; iax < nbase; iax++ ) {
+                           if( ptr_out[ iax ][ ip ] != AST__BAD ) {
+                              isin = 1;
+                              break;
+                           }
+                        }
+                     }
+
+                     flags[ ip ] = isin;
+                     if( isin && !found[ ip ] ) {
+                        found[ ip ] = 1;
+                        result++;
+                     }
+                  }
+               }
+            }
+
+            pset_out = astAnnul( pset_out );
+            pset_base = astAnnul( pset_base );
+         }
+      }
+
+/* Free resources. */
+      for( ireg = 0; ireg < nreg; ireg++ ) {
+         if( maps[ ireg ] ) maps[ ireg ] = astAnnul( maps[ ireg ] );
+      }
+      pset_probe = astAnnul( pset_probe );
+      pset_in = astAnnul( pset_in );
+   }
+
+   ptr_in = astFree( (void *) ptr_in );
+   maps = astFree( maps );
+   sigs = astFree( sigs );
+   offset = astFree( offset );
+   rep = astFree( rep );
+   next = astFree( next );
+   curgood = astFree( curgood );
+   allbad = astFree( allbad );
+   found = astFree( found );
+   sigval = astFree( sigval );
+
+/* Return zero if an error occurred. */
+   if( !astOK ) result = 0;
+
+/* Return the result. */
+   return result;
+}
+
 static AstPointSet *RegTransform( AstRegion *this, AstPointSet *in,
                                   int forward, AstPointSet *out, AstFrame **frm, int *status ) {
 /*
@@ -12446,6 +14118,9 @@ static void Copy( const AstObject *objin, AstObject *objout, int *status ) {
    out->unc = NULL;
    out->negation = NULL;
    out->defunc = NULL;
+   out->capcen = NULL;
+   out->overmap = NULL;
+   out->overmesh = NULL;
 
 /* Now copy each of the above structures. */
    out->frameset = astCopy( in->frameset );
@@ -12455,6 +14130,8 @@ static void Copy( const AstObject *objin, AstObject *objout, int *status ) {
    if( in->unc ) out->unc = astCopy( in->unc );
    if( in->negation ) out->negation = astCopy( in->negation );
    if( in->defunc ) out->defunc = astCopy( in->defunc );
+   if( in->capcen ) out->capcen = astStore( NULL, in->capcen,
+                                            astSizeOf( in->capcen ) );
 }
 
 
@@ -12502,6 +14179,9 @@ static void Delete( AstObject *obj, int *status ) {
    if( this->unc ) this->unc = astAnnul( this->unc );
    if( this->negation ) this->negation = astAnnul( this->negation );
    if( this->defunc ) this->defunc = astAnnul( this->defunc );
+   if( this->overmap ) this->overmap = astAnnul( this->overmap );
+   if( this->overmesh ) this->overmesh = astAnnul( this->overmesh );
+   this->capcen = astFree( this->capcen );
 }
 
 /* Dump function. */
@@ -12824,6 +14504,10 @@ AstRegion *astInitRegion_( void *mem, size_t size, int init,
       new->defunc = NULL;
       new->nomap = 0;
       new->negation = NULL;
+      new->capcen = NULL;
+      new->caprad = AST__BAD;
+      new->overmap = NULL;
+      new->overmesh = NULL;
 
 /* If the supplied Frame is a Region, gets its encapsulated Frame. If a
    FrameSet was supplied, use its current Frame, otherwise use the
@@ -13133,6 +14817,10 @@ AstRegion *astLoadRegion_( void *mem, size_t size,
    from the attributes set above. */
       new->basemesh = NULL;
       new->basegrid = NULL;
+      new->capcen = NULL;
+      new->caprad = AST__BAD;
+      new->overmap = NULL;
+      new->overmesh = NULL;
 
 /* If an error occurred, clean up by deleting the new Region. */
       if ( !astOK ) new = astDelete( new );
@@ -13250,6 +14938,12 @@ int astRegTrace_( AstRegion *this, int n, double *dist, double **ptr, int *statu
    if ( !astOK ) return 0;
    return (**astMEMBER(this,Region,RegTrace))( this, n, dist, ptr, status );
 }
+int astRegLineCross_( AstRegion *this, const double start[], const double step[],
+                      double **cross, int *status ){
+   *cross = NULL;
+   if ( !astOK ) return -1;
+   return (**astMEMBER(this,Region,RegLineCross))( this, start, step, cross, status );
+}
 void astGetRegionBounds_( AstRegion *this, double *lbnd, double *ubnd, int *status ){
    if ( !astOK ) return;
    (**astMEMBER(this,Region,GetRegionBounds))( this, lbnd, ubnd, status );
@@ -13377,10 +15071,161 @@ MAKE_MASK_(UB,unsigned char)
 /* The following functions have public prototypes only (i.e. no
    protected prototypes), so we must provide local prototypes for use
    within this module. */
+int astRegionsContainId_( int, void *[], int, int, int, const double *, int *, int * );
 
 /* Special interface function implementations. */
 /* ------------------------------------------- */
 
+int astRegionsContainId_( int nreg, void *regs_void[], int npoint,
+                          int ncoord, int indim, const double *in,
+                          int *inside, int *status ) {
+/*
+*++
+*  Name:
+c     astRegionsContain
+f     AST_REGIONSCONTAIN
+
+*  Purpose:
+*     Test whether many points are inside many Regions.
+
+*  Type:
+*     Public function.
+
+*  Synopsis:
+c     #include "region.h"
+c     int astRegionsContain( int nreg, AstRegion *regs[], int npoint,
+c                            int ncoord, int indim, const double *in,
+c                            int *inside )
+f     RESULT = AST_REGIONSCONTAIN( NREG, REGS, NPOINT, NCOORD, INDIM, IN,
+f                                  INSIDE, STATUS )
+
+*  Class Membership:
+*     Region function.
+
+*  Description:
+*     This function tests a set of points against each of a set of
+*     Regions, and returns a flag for every combination of Region and
+*     point indicating if the point is inside the Region. The result is
+*     the same as would be obtained by using
+c     astTranN
+f     AST_TRANN
+*     to transform the points with each Region in turn, and then checking
+*     which output points have good axis values. However, this function
+*     is usually much faster if many of the Regions are defined in the
+*     same coordinate system, since the points are then transformed into
+*     that coordinate system only once rather than once for each Region.
+*
+*     The points are assumed to be in the current Frame of every Region,
+*     so the Regions would usually all have equivalent current Frames.
+
+*  Parameters:
+c     nreg
+f     NREG = INTEGER (Given)
+*        The number of Regions. This must be at least one.
+c     regs
+f     REGS( NREG ) = INTEGER (Given)
+*        An array holding pointers to the Regions. Each Region must have
+c        "ncoord"
+f        NCOORD
+*        axes.
+c     npoint
+f     NPOINT = INTEGER (Given)
+*        The number of points to be tested.
+c     ncoord
+f     NCOORD = INTEGER (Given)
+*        The number of coordinates being supplied for each point.
+c     indim
+f     INDIM = INTEGER (Given)
+c        The number of elements along the second dimension of the "in"
+f        The number of elements along the first dimension of the IN
+*        array (which contains the point positions). This value is
+*        required so that the coordinate values can be correctly
+*        located if they do not entirely fill this array. The value
+c        given should not be less than "npoint".
+f        given should not be less than NPOINT.
+c     in
+f     IN( INDIM, NCOORD ) = DOUBLE PRECISION (Given)
+c        The address of the first element in a 2-dimensional array of
+c        shape "[ncoord][indim]" containing the coordinates of the points
+c        to be tested. These should be stored such that the value of
+c        coordinate number "coord" for point number "point" is found in
+c        element "in[coord][point]".
+f        An array containing the coordinates of the points to be tested.
+f        These should be stored such that the value of coordinate number
+f        COORD for point number POINT is found in element IN(POINT,COORD).
+c     inside
+f     INSIDE( NPOINT, NREG ) = INTEGER (Returned)
+c        The address of the first element in a 2-dimensional array of
+c        shape "[nreg][npoint]" in which to return the results. Element
+c        "inside[reg][point]" is returned holding 1 if point number
+c        "point" is inside Region number "reg", and zero otherwise.
+f        An array in which to return the results. Element
+f        INSIDE(POINT,REG) is returned holding 1 if point number POINT
+f        is inside Region number REG, and zero otherwise.
+f     STATUS = INTEGER (Given and Returned)
+f        The global status.
+
+*  Returned Value:
+c     astRegionsContain()
+f     AST_REGIONSCONTAIN = INTEGER
+*        The number of points that are inside at least one of the
+*        supplied Regions.
+
+*  Notes:
+*     - A point is inside a Region if transforming it with the Region
+*     (using
+c     astTranN)
+f     AST_TRANN)
+*     produces at least one good axis value. So points with no good axis
+*     values are never inside any Region.
+*     - A value of zero will be returned if this function is invoked
+*     with the AST error status set, or if it should fail for any reason.
+*--
+
+*  Implementation Notes:
+*     - This function implements the external (public) interface to
+*     the astRegionsContain function. It accepts an array of Object
+*     identifiers, which it converts to true C pointers before invoking
+*     the protected astRegionsContain_ function.
+*/
+
+/* Local Variables: */
+   AstRegion **regs;             /* Array of Region pointers */
+   int ireg;                     /* Region index */
+   int result;                   /* Returned value */
+
+/* Initialise. */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Report an error if no Regions have been supplied. */
+   if( nreg < 1 ) {
+      astError( AST__BDPAR, "astRegionsContain(Region): Bad number of "
+                "Regions (%d) - must be at least 1.", status, nreg );
+   }
+
+/* Otherwise create an array to hold the Region pointers, and obtain and
+   validate pointers to the Region structures provided. */
+   regs = astMalloc( sizeof( AstRegion * )*(size_t) nreg );
+   if( astOK ) {
+      for( ireg = 0; ireg < nreg; ireg++ ) {
+         regs[ ireg ] = astVerifyRegion( astMakePointer( regs_void[ ireg ] ) );
+      }
+   }
+
+/* Test the points. */
+   if( astOK ) result = astRegionsContain( nreg, regs, npoint, ncoord,
+                                           indim, in, inside );
+
+/* Free resources. */
+   regs = astFree( regs );
+
+/* Return the result. */
+   return result;
+}
+
 
 AstRegion *astMapRegionId_( AstRegion *this, AstMapping *map, AstFrame *frame, int *status ) {
 /*
@@ -102,6 +102,10 @@ typedef struct AstRegion {
    int adaptive;              /* Does the Region adapt to coord sys changes? */
    int nomap;                 /* Ignore the Region's FrameSet? */
    struct AstRegion *negation;/* Negated copy of "this" */
+   double *capcen;            /* Centre of base Frame bounding cap */
+   double caprad;             /* Radius of base Frame bounding cap */
+   AstMapping *overmap;       /* Mapping used to create "overmesh" */
+   AstPointSet *overmesh;     /* Mesh transformed by astOverlap */
 } AstRegion;
 
 /* Virtual function table. */
@@ -158,6 +162,7 @@ typedef struct AstRegionVtab {
    AstRegion *(* RegBasePick)( AstRegion *this, int, const int *, int * );
    void (* ResetCache)( AstRegion *, int * );
    int (* RegTrace)( AstRegion *, int, double *, double **, int * );
+   int (* RegLineCross)( AstRegion *, const double[], const double[], double **, int * );
    void (* SetUnc)( AstRegion *, AstRegion *, int * );
    void (* SetRegFS)( AstRegion *, AstFrame *, int * );
    double *(* RegCentre)( AstRegion *, double *, double **, int, int, int * );
@@ -308,8 +313,10 @@ AstFrameSet *astGetRegFS_( AstRegion *, int * );
 void astSetRegFS_( AstRegion *, AstFrame *, int * );
 double *astRegCentre_( AstRegion *, double *, double **, int, int, int * );
 double *astRegTranPoint_( AstRegion *, double *, int, int, int * );
+int astRegionsContain_( int, AstRegion **, int, int, int, const double *, int *, int * );
 void astResetCache_( AstRegion *, int * );
 int astRegTrace_( AstRegion *, int, double *, double **, int * );
+int astRegLineCross_( AstRegion *, const double[], const double[], double **, int * );
 
 int astGetNegated_( AstRegion *, int * );
 int astTestNegated_( AstRegion *, int * );
@@ -343,6 +350,7 @@ void astSetAdaptive_( AstRegion *, int, int * );
 
 #else   /* Public only */
 AstRegion *astMapRegionId_( AstRegion *, AstMapping *, AstFrame *, int * );
+int astRegionsContainId_( int, void *[], int, int, int, const double *, int *, int * );
 
 #endif
 
@@ -457,11 +465,13 @@ astINVOKE(V,astGetRegionPoints_(astCheckRegion(this),maxpoint,maxcoord,npoint,po
 #define astRegMapping(this) astINVOKE(O,astRegMapping_(astCheckRegion(this),STATUS_PTR))
 #define astRegPins(this,pset,unc,mask) astINVOKE(V,astRegPins_(astCheckRegion(this),astCheckPointSet(pset),unc?astCheckRegion(unc):unc,mask,STATUS_PTR))
 #define astRegTranPoint(this,in,np,forward) astRegTranPoint_(this,in,np,forward,STATUS_PTR)
+#define astRegionsContain(nreg,regs,npoint,ncoord,indim,in,inside) astINVOKE(V,astRegionsContain_(nreg,regs,npoint,ncoord,indim,in,inside,STATUS_PTR))
 #define astGetRegFS(this) astINVOKE(O,astGetRegFS_(astCheckRegion(this),STATUS_PTR))
 #define astSetRegFS(this,frm) astINVOKE(V,astSetRegFS_(astCheckRegion(this),astCheckFrame(frm),STATUS_PTR))
 #define astTestUnc(this) astINVOKE(V,astTestUnc_(astCheckRegion(this),STATUS_PTR))
 #define astResetCache(this) astINVOKE(V,astResetCache_(astCheckRegion(this),STATUS_PTR))
 #define astRegTrace(this,n,dist,ptr) astINVOKE(V,astRegTrace_(astCheckRegion(this),n,dist,ptr,STATUS_PTR))
+#define astRegLineCross(this,start,step,cross) astINVOKE(V,astRegLineCross_(astCheckRegion(this),start,step,cross,STATUS_PTR))
 
 /* Since a NULL PointSet pointer is acceptable for "out", we must omit the
    argument checking in that case. (But unfortunately, "out" then gets
@@ -505,6 +515,7 @@ astINVOKE(O,astBTransform_(astCheckRegion(this),in?astCheckPointSet(in):NULL,for
 
 #else  /* Public only */
 #define astMapRegion(this,map,frame) astINVOKE(O,astMapRegionId_(astCheckRegion(this),astCheckMapping(map),astCheckFrame(frame),STATUS_PTR))
+#define astRegionsContain(nreg,regs,npoint,ncoord,indim,in,inside) astINVOKE(V,astRegionsContainId_(nreg,(void **)(regs),npoint,ncoord,indim,in,inside,STATUS_PTR))
 #endif
 
 #endif
@@ -90,6 +90,9 @@ f     The SelectorMap class does not define any new routines beyond those
    "protected" symbols available. */
 #define astCLASS SelectorMap
 
+/* The maximum number of Regions in a leaf node of the bounding box tree. */
+#define MAX_LEAF 4
+
 /* Include files. */
 /* ============== */
 /* Interface definitions. */
@@ -102,6 +105,9 @@ f     The SelectorMap class does not define any new routines beyond those
 #include "pointset.h"            /* Sets of points/coordinates */
 #include "mapping.h"             /* Coordinate Mappings (parent class) */
 #include "unitmap.h"             /* Unit Mappings */
+#include "region.h"              /* Coordinate Regions */
+#include "frame.h"               /* Coordinate Frames */
+#include "skyaxis.h"             /* Sky coordinate axes */
 #include "channel.h"             /* I/O channels */
 #include "selectormap.h"         /* Interface definition for this class */
 
@@ -111,6 +117,8 @@ f     The SelectorMap class does not define any new routines beyond those
 
 /* C header files. */
 /* --------------- */
+#include <float.h>
+#include <math.h>
 #include <stdarg.h>
 #include <stddef.h>
 #include <string.h>
@@ -168,12 +176,118 @@ AstSelectorMap *astSelectorMapId_( int, void **, double, const char *, ... );
 /* Prototypes for Private Member Functions. */
 /* ======================================== */
 static AstPointSet *Transform( AstMapping *, AstPointSet *, int, AstPointSet *, int * );
+static int BuildNode( AstSelectorMap *, int, int, int, int * );
 static int Equal( AstObject *, AstObject *, int * );
 static int GetObjSize( AstObject *, int * );
 static int MapMerge( AstMapping *, int, int, int *, AstMapping ***, int **, int * );
 static void Copy( const AstObject *, AstObject *, int * );
 static void Delete( AstObject *, int * );
 static void Dump( AstObject *, AstChannel *, int * );
+static void MakeTree( AstSelectorMap *, int * );
+static void RegionBox( AstRegion *, double *, double *, int * );
+
+static void MakeTree( AstSelectorMap *this, int *status ){
+/*
+*  Name:
+*     MakeTree
+
+*  Purpose:
+*     Create the bounding box tree for a SelectorMap.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "selectormap.h"
+*     void MakeTree( AstSelectorMap *this, int *status )
+
+*  Class Membership:
+*     SelectorMap member function
+
+*  Description:
+*     This function finds a bounding box for each Region in the supplied
+*     SelectorMap, and then creates a binary tree of bounding boxes over
+*     the Regions. Each leaf node of the tree refers to a small number of
+*     Regions, and each node has a box that encloses the boxes of all the
+*     Regions below it. Transform uses the tree to find the Regions that
+*     may contain each point, so that each point is only tested against
+*     a few candidate Regions.
+*
+*     Regions that are unbounded on every axis would make every node of
+*     the tree unbounded, and so are excluded from the tree. They are
+*     stored at the end of the "treereg" array instead, and Transform
+*     tests every point against them.
+*
+*     Nothing is done if the tree has already been created. The Regions
+*     in a SelectorMap cannot be changed once the SelectorMap has been
+*     created, so the tree never needs to be re-built.
+
+*  Parameters:
+*     this
+*        Pointer to the SelectorMap.
+*     status
+*        Pointer to the inherited status variable.
+
+*/
+
+/* Local Variables: */
+   double *box;
+   int ic;
+   int ireg;
+   int nbox;
+   int ncoord;
+   int nreg;
+   int nunb;
+
+/* Check the global error status, and check the tree has not already been
+   created. */
+   if ( !astOK || this->nnode > 0 ) return;
+
+/* Get the number of Regions and axes. The number of axes is taken from
+   the first Region rather than from the SelectorMap, since the SelectorMap
+   may have been inverted. */
+   nreg = this->nreg;
+   ncoord = astGetNaxes( this->reg[ 0 ] );
+
+/* Allocate the arrays. A binary tree with "nreg" leaves has fewer than
+   "2*nreg" nodes. */
+   this->regbox = astMalloc( sizeof( double )*2*ncoord*nreg );
+   this->nodebox = astMalloc( sizeof( double )*2*ncoord*2*nreg );
+   this->treenode = astMalloc( sizeof( int )*3*2*nreg );
+   this->treereg = astMalloc( sizeof( int )*nreg );
+   if( astOK ) {
+
+/* Get the bounding box of each Region. Store the indices of Regions that
+   are bounded on at least one axis at the start of "treereg", and the
+   indices of Regions that are unbounded on all axes at the end. */
+      nbox = 0;
+      nunb = 0;
+      for( ireg = 0; ireg < nreg; ireg++ ) {
+         box = this->regbox + 2*ncoord*ireg;
+         RegionBox( this->reg[ ireg ], box, box + ncoord, status );
+         for( ic = 0; ic < ncoord; ic++ ) {
+            if( box[ ic ] > -DBL_MAX || box[ ic + ncoord ] < DBL_MAX ) break;
+         }
+         if( ic < ncoord ) {
+            this->treereg[ nbox++ ] = ireg;
+         } else {
+            this->treereg[ nreg - ++nunb ] = ireg;
+         }
+      }
+
+/* Create the tree over the bounded Regions, starting with the root node. */
+      (void) BuildNode( this, 0, nbox, ncoord, status );
+   }
+
+/* If anything went wrong, free the arrays so that the tree is not used. */
+   if( !astOK ) {
+      this->regbox = astFree( this->regbox );
+      this->nodebox = astFree( this->nodebox );
+      this->treenode = astFree( this->treenode );
+      this->treereg = astFree( this->treereg );
+      this->nnode = 0;
+   }
+}
 
 #if defined(THREAD_SAFE)
 static int ManageLock( AstObject *, int, int, AstObject **, int * );
@@ -181,6 +295,154 @@ static int ManageLock( AstObject *, int, int, AstObject **, int * );
 
 /* Member functions. */
 /* ================= */
+static int BuildNode( AstSelectorMap *this, int first, int nr, int ncoord,
+                      int *status ){
+/*
+*  Name:
+*     BuildNode
+
+*  Purpose:
+*     Add a node to the bounding box tree of a SelectorMap.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "selectormap.h"
+*     int BuildNode( AstSelectorMap *this, int first, int nr, int ncoord,
+*                    int *status )
+
+*  Class Membership:
+*     SelectorMap member function
+
+*  Description:
+*     This function creates a new node in the bounding box tree of the
+*     supplied SelectorMap, covering a contiguous group of the Region
+*     indices stored in the "treereg" array. If the group contains more
+*     than MAX_LEAF Regions, the Regions are sorted on the centres of their
+*     bounding boxes along the axis on which the centres have the largest
+*     spread, and the group is split in two at the median. A child node
+*     is then created for each half by calling this function recursively.
+
+*  Parameters:
+*     this
+*        Pointer to the SelectorMap. The "regbox" array should hold the
+*        bounding box of every Region, and the "treenode", "treereg" and
+*        "nodebox" arrays should be large enough to hold 2*nreg nodes.
+*     first
+*        The index within "treereg" of the first Region in the group.
+*     nr
+*        The number of Regions in the group.
+*     ncoord
+*        The number of axes in each bounding box.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The index of the new node.
+
+*/
+
+/* Local Variables: */
+   double *box;
+   double *nbox;
+   double cen;
+   double hi;
+   double lo;
+   double spread;
+   double maxspread;
+   int *reg;
+   int axis;
+   int i;
+   int ic;
+   int j;
+   int nlo;
+   int node;
+   int tmp;
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* Get the index of the new node and a pointer to its bounding box. */
+   node = ( this->nnode )++;
+   nbox = this->nodebox + 2*ncoord*node;
+   reg = this->treereg + first;
+
+/* Form the union of the bounding boxes of the Regions in the group. */
+   for( ic = 0; ic < ncoord; ic++ ) {
+      nbox[ ic ] = DBL_MAX;
+      nbox[ ic + ncoord ] = -DBL_MAX;
+      for( i = 0; i < nr; i++ ) {
+         box = this->regbox + 2*ncoord*reg[ i ];
+         if( box[ ic ] < nbox[ ic ] ) nbox[ ic ] = box[ ic ];
+         if( box[ ic + ncoord ] > nbox[ ic + ncoord ] ) {
+            nbox[ ic + ncoord ] = box[ ic + ncoord ];
+         }
+      }
+   }
+
+/* Find the axis on which the bounding box centres have the largest
+   spread. Unbounded axes are ignored. */
+   axis = -1;
+   maxspread = 0.0;
+   if( nr > MAX_LEAF ) {
+      for( ic = 0; ic < ncoord; ic++ ) {
+         lo = DBL_MAX;
+         hi = -DBL_MAX;
+         for( i = 0; i < nr; i++ ) {
+            box = this->regbox + 2*ncoord*reg[ i ];
+            if( box[ ic ] > -DBL_MAX && box[ ic + ncoord ] < DBL_MAX ) {
+               cen = 0.5*( box[ ic ] + box[ ic + ncoord ] );
+               if( cen < lo ) lo = cen;
+               if( cen > hi ) hi = cen;
+            }
+         }
+         spread = hi - lo;
+         if( spread > maxspread ) {
+            maxspread = spread;
+            axis = ic;
+         }
+      }
+   }
+
+/* If the group is small, or cannot be split, make the node a leaf that
+   refers directly to the Regions in the group. */
+   if( axis == -1 ) {
+      this->treenode[ 3*node ] = first;
+      this->treenode[ 3*node + 1 ] = -1;
+      this->treenode[ 3*node + 2 ] = nr;
+
+/* Otherwise, sort the Regions on the centre of their bounding boxes along
+   the chosen axis (an insertion sort is used since the number of Regions
+   is usually modest and the tree is only built once). Unbounded centres
+   are sorted as if they were zero. */
+   } else {
+      for( i = 1; i < nr; i++ ) {
+         tmp = reg[ i ];
+         box = this->regbox + 2*ncoord*tmp;
+         cen = ( box[ axis ] > -DBL_MAX && box[ axis + ncoord ] < DBL_MAX ) ?
+               0.5*( box[ axis ] + box[ axis + ncoord ] ) : 0.0;
+         for( j = i; j > 0; j-- ) {
+            box = this->regbox + 2*ncoord*reg[ j - 1 ];
+            if( ( ( box[ axis ] > -DBL_MAX && box[ axis + ncoord ] < DBL_MAX ) ?
+                  0.5*( box[ axis ] + box[ axis + ncoord ] ) : 0.0 ) <= cen ) break;
+            reg[ j ] = reg[ j - 1 ];
+         }
+         reg[ j ] = tmp;
+      }
+
+/* Create child nodes for the lower and upper halves. */
+      nlo = nr/2;
+      this->treenode[ 3*node + 2 ] = 0;
+      this->treenode[ 3*node ] = BuildNode( this, first, nlo, ncoord, status );
+      this->treenode[ 3*node + 1 ] = BuildNode( this, first + nlo, nr - nlo,
+                                                ncoord, status );
+   }
+
+/* Return the node index. */
+   return node;
+}
+
 static int Equal( AstObject *this_object, AstObject *that_object, int *status ) {
 /*
 *  Name:
@@ -331,6 +593,10 @@ static int GetObjSize( AstObject *this_object, int *status ) {
    for( i = 0; i < this->nreg; i++ ) {
       result += astGetObjSize( this->reg[ i ] );
    }
+   result += astTSizeOf( this->treenode );
+   result += astTSizeOf( this->treereg );
+   result += astTSizeOf( this->regbox );
+   result += astTSizeOf( this->nodebox );
 
 /* If an error occurred, clear the result value. */
    if ( !astOK ) result = 0;
@@ -788,6 +1054,199 @@ static int MapMerge( AstMapping *this, int where, int series, int *nmap,
    return result;
 }
 
+static void RegionBox( AstRegion *reg, double *lbnd, double *ubnd,
+                       int *status ){
+/*
+*  Name:
+*     RegionBox
+
+*  Purpose:
+*     Find a box that encloses all points that a Region could contain.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "selectormap.h"
+*     void RegionBox( AstRegion *reg, double *lbnd, double *ubnd,
+*                     int *status )
+
+*  Class Membership:
+*     SelectorMap member function
+
+*  Description:
+*     This function returns a box, within the current Frame of the
+*     supplied Region, that encloses every position that astTransform may
+*     consider to be inside the Region. The box is padded so that
+*     positions on or near the boundary are never excluded. Unbounded axes
+*     are indicated by returning -DBL_MAX and +DBL_MAX as the bounds.
+
+*  Parameters:
+*     reg
+*        Pointer to the Region.
+*     lbnd
+*        Pointer to an array in which to return the lower axis bounds.
+*     ubnd
+*        Pointer to an array in which to return the upper axis bounds.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Notes:
+*     - No bounds are used for axes that are represented by a SkyAxis,
+*     since sky longitude values outside the normal range may still fall
+*     within the Region.
+*     - If the Region's current Frame is connected to its base Frame by a
+*     UnitMap, the box is the base Frame bounding box of the Region. If
+*     they are connected by a linear Mapping, the box encloses the
+*     transformed corners of the base Frame bounding box, which encloses
+*     the whole transformed Region. Otherwise, no reliable box can be
+*     found without relying on a mesh of boundary points, and so the
+*     Region is treated as unbounded on all axes.
+*     - The width of the uncertainty Region is also added on each side, since
+*     some classes of Region (e.g. PointList) use the uncertainty Region
+*     when testing whether a position is inside.
+
+*/
+
+/* Local Variables: */
+   AstAxis *ax;
+   AstFrame *frm;
+   AstMapping *map;
+   AstPointSet *ps1;
+   AstPointSet *ps2;
+   AstRegion *unc;
+   double **ptr1;
+   double **ptr2;
+   double *blbnd;
+   double *bubnd;
+   double *ulbnd;
+   double *uubnd;
+   double pad;
+   double x;
+   int ib;
+   int ic;
+   int ip;
+   int nbase;
+   int ncoord;
+   int npos;
+
+/* Get the number of axes. */
+   ncoord = astGetNaxes( reg );
+
+/* Initialise the box to be unbounded on every axis. */
+   for( ic = 0; ic < ncoord; ic++ ) {
+      lbnd[ ic ] = -DBL_MAX;
+      ubnd[ ic ] = DBL_MAX;
+   }
+
+/* Check the global error status. Nothing more can be done if the Region
+   is unbounded (e.g. a negated Region). */
+   if ( !astOK || !astGetBounded( reg ) ) return;
+
+/* Get the base Frame bounding box of the Region, and the Mapping from
+   base to current Frame. */
+   map = astRegMapping( reg );
+   nbase = astGetNin( map );
+   blbnd = astMalloc( sizeof( double )*nbase );
+   bubnd = astMalloc( sizeof( double )*nbase );
+   astRegBaseBox( reg, blbnd, bubnd );
+
+/* If the Mapping is a UnitMap, the base Frame box is the required box. */
+   if( astIsAUnitMap( map ) ) {
+      if( astOK ) {
+         for( ic = 0; ic < ncoord; ic++ ) {
+            lbnd[ ic ] = blbnd[ ic ];
+            ubnd[ ic ] = bubnd[ ic ];
+         }
+      }
+
+/* If the Mapping is linear, transform the corners of the base Frame box
+   into the current Frame and find their bounds. */
+   } else if( astGetIsLinear( map ) && nbase < 16 ) {
+      npos = 1 << nbase;
+      ps1 = astPointSet( npos, nbase, "", status );
+      ptr1 = astGetPoints( ps1 );
+      if( astOK ) {
+         for( ip = 0; ip < npos; ip++ ) {
+            for( ib = 0; ib < nbase; ib++ ) {
+               ptr1[ ib ][ ip ] = ( ip & ( 1 << ib ) ) ? bubnd[ ib ] : blbnd[ ib ];
+            }
+         }
+      }
+      ps2 = astTransform( map, ps1, 1, NULL );
+      ptr2 = astGetPoints( ps2 );
+      if( astOK ) {
+         for( ic = 0; ic < ncoord; ic++ ) {
+            lbnd[ ic ] = DBL_MAX;
+            ubnd[ ic ] = -DBL_MAX;
+            for( ip = 0; ip < npos; ip++ ) {
+               x = ptr2[ ic ][ ip ];
+               if( x == AST__BAD ) {
+                  lbnd[ ic ] = AST__BAD;
+                  break;
+               }
+               if( x < lbnd[ ic ] ) lbnd[ ic ] = x;
+               if( x > ubnd[ ic ] ) ubnd[ ic ] = x;
+            }
+         }
+      }
+      ps1 = astAnnul( ps1 );
+      ps2 = astAnnul( ps2 );
+
+/* Otherwise, leave the box unbounded. */
+   } else {
+      for( ic = 0; ic < ncoord; ic++ ) lbnd[ ic ] = AST__BAD;
+   }
+   blbnd = astFree( blbnd );
+   bubnd = astFree( bubnd );
+
+/* Get the bounds of the uncertainty Region. */
+   ulbnd = astMalloc( sizeof( double )*ncoord );
+   uubnd = astMalloc( sizeof( double )*ncoord );
+   unc = astGetUncFrm( reg, AST__CURRENT );
+   astGetRegionBounds( unc, ulbnd, uubnd );
+
+/* Loop round each axis. */
+   frm = astRegFrame( reg );
+   for( ic = 0; ic < ncoord && astOK; ic++ ) {
+      ax = astGetAxis( frm, ic );
+
+/* Leave the axis unbounded if the bounds could not be found, or if the
+   axis is a sky axis. */
+      if( lbnd[ ic ] == AST__BAD || ubnd[ ic ] == AST__BAD ||
+          ubnd[ ic ] < lbnd[ ic ] || astIsASkyAxis( ax ) ) {
+         lbnd[ ic ] = -DBL_MAX;
+         ubnd[ ic ] = DBL_MAX;
+
+/* Otherwise, extend the bounds by the width of the uncertainty Region,
+   plus a small fraction of the absolute values to allow for rounding
+   errors. */
+      } else {
+         pad = 1.0E-10*( fabs( lbnd[ ic ] ) + fabs( ubnd[ ic ] ) );
+         if( ulbnd[ ic ] != AST__BAD && uubnd[ ic ] != AST__BAD &&
+             uubnd[ ic ] > ulbnd[ ic ] ) pad += uubnd[ ic ] - ulbnd[ ic ];
+         lbnd[ ic ] -= pad;
+         ubnd[ ic ] += pad;
+      }
+      ax = astAnnul( ax );
+   }
+
+/* Free resources. */
+   frm = astAnnul( frm );
+   map = astAnnul( map );
+   unc = astAnnul( unc );
+   ulbnd = astFree( ulbnd );
+   uubnd = astFree( uubnd );
+
+/* If anything went wrong, return an unbounded box. */
+   if( !astOK ) {
+      for( ic = 0; ic < ncoord; ic++ ) {
+         lbnd[ ic ] = -DBL_MAX;
+         ubnd[ ic ] = DBL_MAX;
+      }
+   }
+}
+
 static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
                                int forward, AstPointSet *out, int *status ) {
 /*
@@ -848,23 +1307,39 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
    AstPointSet *ps1;
    AstPointSet *ps2;
    AstPointSet *result;
-   AstPointSet *tps;
    AstRegion *reg;
    AstSelectorMap *map;
+   double **ptr_in;
    double **ptr_out;
    double **ptr1;
    double **ptr2;
-   double **tptr;
+   double *box;
    double *p2;
    double *pout;
    double badval;
+   double x;
+   int *cand;
+   int *ncand;
+   int *pairpnt;
+   int *pairreg;
+   int *sel;
+   int *stack;
    int bad;
    int closed;
+   int icand;
    int icoord;
+   int inside;
+   int ipair;
    int ipoint;
    int ireg;
+   int k;
    int ncoord;
+   int node;
+   int npair;
    int npoint;
+   int nreg;
+   int nsel;
+   int nstack;
 
 /* Check the global error status. */
    if ( !astOK ) return NULL;
@@ -885,18 +1360,29 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
    inverse transformation is not defined). */
    if( forward != astGetInvert( this ) ) {
 
-/* Get the number of input axes and the number of points. */
+/* Get the number of input axes, the number of points and the number of
+   Regions. */
       ncoord = astGetNcoord( in );
       npoint = astGetNpoint( in );
+      nreg = map->nreg;
 
-/* Create two temporary PointSets to hold copies of the input points. */
-      ps1 = astCopy( in );
-      ptr1 = astGetPoints( ps1 );
-      ps2 = astPointSet( npoint, ncoord, "", status );
-      ptr2 = astGetPoints( ps2 );
+/* Ensure the bounding box tree has been created. */
+      MakeTree( map, status );
 
-/* Get a pointer to the output data */
+/* Get pointers to the input and output data. */
+      ptr_in = astGetPoints( in );
       ptr_out = astGetPoints( result );
+
+/* Allocate work arrays. "stack" is used when searching the tree, "pairpnt"
+   and "pairreg" hold the point index and Region index for each pair
+   consisting of a point and a Region that may contain it, "ncand" holds
+   the number of candidate points for each Region and "cand" holds the
+   candidate point indices sorted by Region. */
+      stack = astMalloc( sizeof( int )*( map->nnode + 1 ) );
+      ncand = astMalloc( sizeof( int )*( nreg + 1 ) );
+      pairpnt = astMalloc( sizeof( int )*npoint );
+      pairreg = astMalloc( sizeof( int )*npoint );
+      npair = 0;
       if( astOK ) {
 
 /* Initialise the output array to hold -1 at any points that have
@@ -905,7 +1391,7 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
          for( ipoint = 0; ipoint < npoint; ipoint++ ) {
             bad = 0;
             for( icoord = 0; icoord < ncoord; icoord++ ) {
-               if( ptr1[ icoord ][ ipoint ] == AST__BAD ) {
+               if( ptr_in[ icoord ][ ipoint ] == AST__BAD ) {
                   bad = 1;
                   break;
                }
@@ -913,41 +1399,147 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
             *(pout++) = bad ? -1 : 0;
          }
 
-/* Loop round all Regions. */
-         for( ireg = 1; ireg <= map->nreg; ireg++ ) {
+/* For each good point, search the tree for Regions with bounding boxes
+   that contain the point. Start at the root node. */
+         for( ireg = 0; ireg <= nreg; ireg++ ) ncand[ ireg ] = 0;
+         pout = ptr_out[ 0 ];
+         for( ipoint = 0; ipoint < npoint && astOK; ipoint++ ) {
+            if( pout[ ipoint ] != 0 ) continue;
+
+            nstack = 0;
+            stack[ nstack++ ] = 0;
+            while( nstack > 0 ) {
+               node = stack[ --nstack ];
+
+/* Pass on if the point is outside the box for this node. */
+               box = map->nodebox + 2*ncoord*node;
+               inside = 1;
+               for( icoord = 0; icoord < ncoord; icoord++ ) {
+                  x = ptr_in[ icoord ][ ipoint ];
+                  if( x < box[ icoord ] || x > box[ icoord + ncoord ] ) {
+                     inside = 0;
+                     break;
+                  }
+               }
+               if( !inside ) continue;
+
+/* If this is a leaf node, record a pair for each of its Regions that have
+   bounding boxes containing the point. */
+               if( map->treenode[ 3*node + 1 ] < 0 ) {
+                  for( k = 0; k < map->treenode[ 3*node + 2 ]; k++ ) {
+                     ireg = map->treereg[ map->treenode[ 3*node ] + k ];
+                     box = map->regbox + 2*ncoord*ireg;
+                     inside = 1;
+                     for( icoord = 0; icoord < ncoord; icoord++ ) {
+                        x = ptr_in[ icoord ][ ipoint ];
+                        if( x < box[ icoord ] || x > box[ icoord + ncoord ] ) {
+                           inside = 0;
+                           break;
+                        }
+                     }
+                     if( inside ) {
+                        pairpnt = astGrow( pairpnt, npair + 1, sizeof( int ) );
+                        pairreg = astGrow( pairreg, npair + 1, sizeof( int ) );
+                        if( !astOK ) break;
+                        pairpnt[ npair ] = ipoint;
+                        pairreg[ npair++ ] = ireg;
+                        ( ncand[ ireg + 1 ] )++;
+                     }
+                  }
+
+/* Otherwise, search both child nodes. */
+               } else {
+                  stack[ nstack++ ] = map->treenode[ 3*node ];
+                  stack[ nstack++ ] = map->treenode[ 3*node + 1 ];
+               }
+            }
+         }
+
+/* Sort the candidate points by Region, retaining the original order of
+   the points for each Region. On exit, "ncand[ireg]" holds the index
+   within "cand" of the first candidate point for Region "ireg". */
+         for( ireg = 0; ireg < nreg; ireg++ ) ncand[ ireg + 1 ] += ncand[ ireg ];
+         cand = astMalloc( sizeof( int )*( npair ? npair : 1 ) );
+         if( astOK ) {
+            for( ipair = 0; ipair < npair; ipair++ ) {
+               cand[ ( ncand[ pairreg[ ipair ] ] )++ ] = pairpnt[ ipair ];
+            }
+            for( ireg = nreg; ireg > 0; ireg-- ) ncand[ ireg ] = ncand[ ireg - 1 ];
+            ncand[ 0 ] = 0;
+         }
+
+/* Loop round all Regions in order, so that each point is assigned to
+   the first Region that contains it. */
+         for( ireg = 1; ireg <= nreg && astOK; ireg++ ) {
             reg = map->reg[ ireg - 1 ];
 
+/* If the Region is unbounded on all axes it is not included in the tree,
+   so use all points that have not already been assigned to an earlier
+   Region. Store their indices at the start of "pairpnt", which is no
+   longer needed. */
+            box = map->regbox + 2*ncoord*( ireg - 1 );
+            for( icoord = 0; icoord < ncoord; icoord++ ) {
+               if( box[ icoord ] > -DBL_MAX || box[ icoord + ncoord ] < DBL_MAX ) break;
+            }
+            nsel = 0;
+            if( icoord == ncoord ) {
+               sel = pairpnt;
+               for( ipoint = 0; ipoint < npoint; ipoint++ ) {
+                  if( pout[ ipoint ] == 0 ) sel[ nsel++ ] = ipoint;
+               }
+
+/* Otherwise, use the candidate points found using the tree, removing any
+   that have already been assigned to an earlier Region. */
+            } else {
+               sel = cand + ncand[ ireg - 1 ];
+               for( icand = ncand[ ireg - 1 ]; icand < ncand[ ireg ]; icand++ ) {
+                  ipoint = cand[ icand ];
+                  if( pout[ ipoint ] == 0 ) sel[ nsel++ ] = ipoint;
+               }
+            }
+
+/* Pass on if no points remain. */
+            if( nsel == 0 ) continue;
+
+/* Copy the candidate points into a temporary PointSet. */
+            ps1 = astPointSet( nsel, ncoord, "", status );
+            ptr1 = astGetPoints( ps1 );
+            ps2 = astPointSet( nsel, ncoord, "", status );
+            ptr2 = astGetPoints( ps2 );
+            if( astOK ) {
+               for( icoord = 0; icoord < ncoord; icoord++ ) {
+                  for( k = 0; k < nsel; k++ ) {
+                     ptr1[ icoord ][ k ] = ptr_in[ icoord ][ sel[ k ] ];
+                  }
+               }
+            }
+
 /* Temporarily Negate the Region. */
             astNegate( reg );
             closed = astGetClosed( reg );
             astSetClosed( reg, !closed );
 
-/* Transform the remaining input positions. Good input positions which
-   are within the Region will be bad in the output. */
-            ps2 = astTransform( reg, ps1, 1, ps2 );
-
-/* Loop round all positions. */
-            p2 = ptr2[ 0 ];
-            pout = ptr_out[ 0 ];
-            for( ipoint = 0; ipoint < npoint; ipoint++, p2++, pout++ ) {
+/* Transform the candidate positions. Good input positions which are within
+   the Region will be bad in the output. */
+            (void) astTransform( reg, ps1, 1, ps2 );
 
-/* Any position that has not already been assigned to a Region and is bad
-   in the output PointSet must be contained within the current Region, so
-   assign the (one-based) index of the current Region to the output element. */
-               if( *pout == 0 && *p2 == AST__BAD ) *pout = ireg;
+/* Any candidate position that is bad in the output PointSet must be
+   contained within the current Region, so assign the (one-based) index of
+   the current Region to the output element. */
+            if( astOK ) {
+               p2 = ptr2[ 0 ];
+               for( k = 0; k < nsel; k++ ) {
+                  if( p2[ k ] == AST__BAD ) pout[ sel[ k ] ] = ireg;
+               }
             }
 
 /* Negate the Region to get it back to its original state. */
             astSetClosed( reg, closed );
             astNegate( reg );
 
-/* Swap the input and output PointSets. */
-            tps = ps1;
-            ps1 = ps2;
-            ps2 = tps;
-            tptr = ptr1;
-            ptr1 = ptr2;
-            ptr2 = tptr;
+/* Free resources. */
+            ps1 = astAnnul( ps1 );
+            ps2 = astAnnul( ps2 );
          }
 
 /* Replace -1 values in the output (that indicate that the input position
@@ -957,11 +1549,15 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
          for( ipoint = 0; ipoint < npoint; ipoint++, pout++ ) {
             if( *pout == -1 ) *pout = badval;
          }
+
+         cand = astFree( cand );
       }
 
 /* Free resources. */
-      ps1 = astAnnul( ps1 );
-      ps2 = astAnnul( ps2 );
+      stack = astFree( stack );
+      ncand = astFree( ncand );
+      pairpnt = astFree( pairpnt );
+      pairreg = astFree( pairreg );
    }
 
 /* If an error occurred, clean up by deleting the output PointSet (if
@@ -1026,6 +1622,14 @@ static void Copy( const AstObject *objin, AstObject *objout, int *status ) {
    out->reg = NULL;
    out->nreg = 0;
 
+/* The bounding box tree is not copied. The new SelectorMap creates its
+   own tree when first needed. */
+   out->nnode = 0;
+   out->treenode = NULL;
+   out->treereg = NULL;
+   out->regbox = NULL;
+   out->nodebox = NULL;
+
 /* Make copies of the Regions, and store pointers to them in the output
    SelectorMap structure. */
    out->reg = astMalloc( sizeof( AstRegion * )*( in->nreg ) );
@@ -1083,9 +1687,14 @@ static void Delete( AstObject *obj, int *status ) {
       this->reg[ i ] = astAnnul( this->reg[ i ] );
    }
    this->reg = astFree( this->reg );
+   this->treenode = astFree( this->treenode );
+   this->treereg = astFree( this->treereg );
+   this->regbox = astFree( this->regbox );
+   this->nodebox = astFree( this->nodebox );
 
 /* Clear the remaining SelectorMap variables. */
    this->nreg = 0;
+   this->nnode = 0;
 }
 
 /* Dump function. */
@@ -1632,6 +2241,13 @@ AstSelectorMap *astInitSelectorMap_( void *mem, size_t size, int init,
 /* Store other items */
          new->badval = badval;
 
+/* The bounding box tree used by Transform is created when first needed. */
+         new->nnode = 0;
+         new->treenode = NULL;
+         new->treereg = NULL;
+         new->regbox = NULL;
+         new->nodebox = NULL;
+
 /* If an error occurred, clean up by deleting the new object. */
          if ( !astOK ) new = astDelete( new );
       }
@@ -1811,6 +2427,14 @@ AstSelectorMap *astLoadSelectorMap_( void *mem, size_t size,
 /* ------- */
       new->badval = astReadDouble( channel, "badval", AST__BAD );
 
+/* The bounding box tree used by Transform is not dumped. It is created
+   when first needed. */
+      new->nnode = 0;
+      new->treenode = NULL;
+      new->treereg = NULL;
+      new->regbox = NULL;
+      new->nodebox = NULL;
+
 /* If an error occurred, clean up by deleting the new SelectorMap. */
       if ( !astOK ) new = astDelete( new );
    }
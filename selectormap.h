@@ -152,6 +152,11 @@ typedef struct AstSelectorMap {
    int nreg;                /* The number of Regions in the SelectorMap */
    AstRegion **reg;         /* Array of Region pointers */
    double badval;           /* Output value for positions with bad axis values */
+   int nnode;               /* Number of nodes in the bounding box tree */
+   int *treenode;           /* Children, or Regions, of each tree node */
+   int *treereg;            /* Region indices sorted into tree order */
+   double *regbox;          /* Bounding box of each Region */
+   double *nodebox;         /* Bounding box of each tree node */
 
 } AstSelectorMap;
 
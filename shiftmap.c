@@ -149,6 +149,7 @@ AstShiftMap *astShiftMapId_( int, const double [], const char *, ... );
 static AstPointSet *Transform( AstMapping *, AstPointSet *, int, AstPointSet *, int * );
 static int GetObjSize( AstObject *, int * );
 static double Rate( AstMapping *, double *, int, int, int * );
+static int RateIsExact( AstMapping *, int * );
 static int MapMerge( AstMapping *, int, int, int *, AstMapping ***, int **, int * );
 static void Copy( const AstObject *, AstObject *, int * );
 static void Delete( AstObject *, int * );
@@ -437,6 +438,7 @@ void astInitShiftMapVtab_(  AstShiftMapVtab *vtab, const char *name, int *status
    object->Equal = Equal;
    mapping->MapMerge = MapMerge;
    mapping->Rate = Rate;
+   mapping->RateIsExact = RateIsExact;
    mapping->MapSplit = MapSplit;
    mapping->GetIsLinear = GetIsLinear;
 
@@ -816,6 +818,49 @@ static double Rate( AstMapping *this, double *at, int ax1, int ax2, int *status
    return ( ax1 == ax2 ) ? 1.0 : 0.0;
 }
 
+static int RateIsExact( AstMapping *this, int *status ) {
+/*
+*  Name:
+*     RateIsExact
+
+*  Purpose:
+*     Check if the astRate method of a Mapping is exact.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "shiftmap.h"
+*     int RateIsExact( AstMapping *this, int *status )
+
+*  Class Membership:
+*     ShiftMap member function (over-rides the protected astRateIsExact
+*     method inherited from the Mapping class).
+
+*  Description:
+*     This function returns a flag indicating if the astRate method of
+*     the supplied Mapping evaluates the rate of change analytically.
+*     The rates of change of a ShiftMap are always zero or one.
+
+*  Parameters:
+*     this
+*        Pointer to the Mapping.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Non-zero if the astRate method of the supplied Mapping is exact, and
+*     zero otherwise.
+
+*/
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* The rates of change are always zero or one. */
+   return 1;
+}
+
 static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
                                int forward, AstPointSet *out, int *status ) {
 /*
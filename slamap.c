@@ -161,6 +161,14 @@ f     - AST_SLAADD: Add a celestial coordinate conversion to an SlaMap
 #define AST__R2H        27       /* RA to hour angle */
 #define AST__H2R        28       /* Hour to RA angle */
 
+/* Values identifying the kinds of parameter stored in the cache of
+   conversion parameters. */
+#define CACHE_MAPPA  1           /* palMappa parameters (21 values) */
+#define CACHE_PREBN  2           /* palPrebn precession matrix (9 values) */
+#define CACHE_PREC   3           /* palPrec precession matrix (9 values) */
+#define CACHE_ECL    4           /* Ecliptic conversion matrix (9 values) */
+#define CACHE_ETRMS  5           /* palEtrms E-terms vector (3 values) */
+
 /* Maximum number of arguments required by an SLALIB conversion. */
 #define MAX_SLA_ARGS 4
 
@@ -179,6 +187,8 @@ f     - AST_SLAADD: Add a celestial coordinate conversion to an SlaMap
 /* Interface definitions. */
 /* ---------------------- */
 #include "pal.h"              /* SLALIB interface */
+#include "erfa.h"             /* ERFA interface */
+#include "erfam.h"            /* ERFA macros */
 
 #include "globals.h"             /* Thread-safe global data access */
 #include "error.h"               /* Error reporting facilities */
@@ -220,8 +230,10 @@ static AstPointSet *(* parent_transform)( AstMapping *, AstPointSet *, int, AstP
 /* Define how to initialise thread-specific globals. */
 #define GLOBAL_inits \
    globals->Class_Init = 0; \
-   globals->Eq_Cache = AST__BAD; \
-   globals->Ep_Cache = AST__BAD; \
+   globals->Cache_Used = 0; \
+   globals->Cache_Clock = 0; \
+   globals->Cache_Hits = 0; \
+   globals->Cache_Misses = 0; \
 
 /* Create the function that initialises global data for this module. */
 astMAKE_INITGLOBALS(SlaMap)
@@ -229,9 +241,11 @@ astMAKE_INITGLOBALS(SlaMap)
 /* Define macros for accessing each item of thread specific global data. */
 #define class_init astGLOBAL(SlaMap,Class_Init)
 #define class_vtab astGLOBAL(SlaMap,Class_Vtab)
-#define eq_cache astGLOBAL(SlaMap,Eq_Cache)
-#define ep_cache astGLOBAL(SlaMap,Ep_Cache)
-#define amprms_cache astGLOBAL(SlaMap,Amprms_Cache)
+#define param_cache astGLOBAL(SlaMap,Param_Cache)
+#define cache_used astGLOBAL(SlaMap,Cache_Used)
+#define cache_clock astGLOBAL(SlaMap,Cache_Clock)
+#define cache_hits astGLOBAL(SlaMap,Cache_Hits)
+#define cache_misses astGLOBAL(SlaMap,Cache_Misses)
 
 
 
@@ -239,11 +253,17 @@ astMAKE_INITGLOBALS(SlaMap)
    variables. */
 #else
 
-/* A cache used to store the most recent results from palMappa in order
-   to avoid continuously recalculating the same values. */
-static double eq_cache = AST__BAD;
-static double ep_cache = AST__BAD;
-static double amprms_cache[ 21 ];
+/* A cache used to store the most recently used conversion parameters
+   (palMappa parameters, precession matrices, E-terms, etc) in order to
+   avoid continuously recalculating the same values. Entries are
+   re-used on a least-recently-used basis. The numbers of hits and
+   misses are recorded so that the effectiveness of the cache can be
+   monitored. */
+static AstSlaCacheEntry param_cache[ AST__SLACACHE ];
+static int cache_used = 0;
+static unsigned long int cache_clock = 0;
+static unsigned long int cache_hits = 0;
+static unsigned long int cache_misses = 0;
 
 
 /* Define the class virtual function table and its initialisation flag
@@ -267,8 +287,13 @@ static const char *CvtString( int, const char **, int *, const char *[ MAX_SLA_A
 static int CvtCode( const char *, int * );
 static int Equal( AstObject *, AstObject *, int * );
 static int MapMerge( AstMapping *, int, int, int *, AstMapping ***, int **, int * );
+static int RotMatrix( int, double *, int, double[3][3], int * );
+static int RotRun( AstSlaMap *, int, int, double[3][3], int *, int * );
 static int SlaIsEmpty( AstSlaMap *, int * );
 static void AddSlaCvt( AstSlaMap *, int, int, const double *, int * );
+static void Addet( double, double, double[3], double *, double * );
+static void CacheParams( int, double, double, double *, int * );
+static void Subet( double, double, double[3], double *, double * );
 static void Copy( const AstObject *, AstObject *, int * );
 static void De2h( double, double, double, double, double *, double *, int * );
 static void Dh2e( double, double, double, double, double *, double *, int * );
@@ -801,6 +826,214 @@ static void AddSlaCvt( AstSlaMap *this, int cvttype, int narg,
    }
 }
 
+static void Addet( double rm, double dm, double eterms[3], double *rc,
+                   double *dc ) {
+/*
+*  Name:
+*     Addet
+
+*  Purpose:
+*     Add the E-terms of aberration to a position.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "slamap.h"
+*     void Addet( double rm, double dm, double eterms[3], double *rc,
+*                 double *dc )
+
+*  Class Membership:
+*     SlaMap member function.
+
+*  Description:
+*     This function does the same as palAddet, except that the E-terms
+*     vector is supplied by the caller rather than being recalculated
+*     for every position. The arithmetic is identical to that of palAddet.
+
+*  Parameters:
+*     rm
+*        The RA without E-terms (radians).
+*     dm
+*        The Dec without E-terms (radians).
+*     eterms
+*        The E-terms vector, as returned by palEtrms.
+*     rc
+*        Pointer to a location at which to return the RA with E-terms
+*        included (radians).
+*     dc
+*        Pointer to a location at which to return the Dec with E-terms
+*        included (radians).
+
+*  Notes:
+*     - This function does not check the inherited status.
+*/
+
+/* Local Variables: */
+   double v[ 3 ];                /* Cartesian position */
+   int i;                        /* Axis index */
+
+/* Spherical to Cartesian. */
+   palDcs2c( rm, dm, v );
+
+/* Include the E-terms. */
+   for( i = 0; i < 3; i++ ) v[ i ] += eterms[ i ];
+
+/* Cartesian to spherical, bringing the RA into the conventional range. */
+   palDcc2s( v, rc, dc );
+   *rc = palDranrm( *rc );
+}
+
+static void CacheParams( int kind, double arg1, double arg2, double *value,
+                         int *status ) {
+/*
+*  Name:
+*     CacheParams
+
+*  Purpose:
+*     Get a set of conversion parameters, using a cache if possible.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "slamap.h"
+*     void CacheParams( int kind, double arg1, double arg2, double *value,
+*                       int *status )
+
+*  Class Membership:
+*     SlaMap member function.
+
+*  Description:
+*     This function returns a set of parameter values (e.g. a precession
+*     matrix) needed by a coordinate conversion. The most recently used
+*     sets of parameters are held in a small cache, keyed by the kind of
+*     parameter and the arguments used to calculate them. If the requested
+*     parameters are found in the cache they are copied from it.
+*     Otherwise they are calculated using PAL and stored in the cache,
+*     replacing the least recently used entry if the cache is full.
+*
+*     Each thread has its own cache, so no locking is needed. The numbers
+*     of hits and misses are recorded and can be obtained using
+*     astSlaCacheStats.
+
+*  Parameters:
+*     kind
+*        Identifies the parameters required:
+*
+*        - CACHE_MAPPA: The 21 values returned by palMappa, for
+*        equinox "arg1" and date "arg2".
+*        - CACHE_PREBN: The 9 elements of the palPrebn precession matrix
+*        (row order), from Besselian epoch "arg1" to "arg2".
+*        - CACHE_PREC: The 9 elements of the palPrec precession matrix
+*        (row order), from Julian epoch "arg1" to "arg2".
+*        - CACHE_ECL: The 9 elements of the matrix (row order) that
+*        converts from J2000.0 equatorial coordinates to ecliptic
+*        coordinates at date "arg1". "arg2" is ignored.
+*        - CACHE_ETRMS: The 3 elements of the E-terms vector returned by
+*        palEtrms for Besselian epoch "arg1". "arg2" is ignored.
+*     arg1
+*        The first argument.
+*     arg2
+*        The second argument.
+*     value
+*        Pointer to an array in which to return the parameter values. It
+*        should have room for the number of values indicated above.
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Variables: */
+   astDECLARE_GLOBALS            /* Pointer to thread-specific global data */
+   AstSlaCacheEntry *entry;      /* Pointer to cache entry to use */
+   double precess_matrix[ 3 ][ 3 ]; /* Precession matrix */
+   double rotate_matrix[ 3 ][ 3 ]; /* Equatorial to ecliptic rotation */
+   int i;                        /* Entry index */
+   int nval;                     /* Number of parameter values */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Get a pointer to the thread specific global data structure. */
+   astGET_GLOBALS(NULL);
+
+/* Get the number of values for the requested kind of parameter. Arguments
+   that are not used are set to zero so that they do not prevent a match. */
+   if( kind == CACHE_MAPPA ) {
+      nval = 21;
+   } else if( kind == CACHE_ETRMS ) {
+      nval = 3;
+      arg2 = 0.0;
+   } else {
+      nval = 9;
+      if( kind == CACHE_ECL ) arg2 = 0.0;
+   }
+
+/* Search the cache for an entry with the same kind and arguments. */
+   entry = NULL;
+   for( i = 0; i < cache_used; i++ ) {
+      if( param_cache[ i ].kind == kind &&
+          param_cache[ i ].arg1 == arg1 &&
+          param_cache[ i ].arg2 == arg2 ) {
+         entry = param_cache + i;
+         break;
+      }
+   }
+
+/* If found, record the hit. */
+   if( entry ) {
+      cache_hits++;
+
+/* Otherwise, record the miss and choose the entry to use. This is the next
+   unused entry if the cache is not yet full, and the least recently used
+   entry otherwise. */
+   } else {
+      cache_misses++;
+      if( cache_used < AST__SLACACHE ) {
+         entry = param_cache + cache_used++;
+      } else {
+         entry = param_cache;
+         for( i = 1; i < AST__SLACACHE; i++ ) {
+            if( param_cache[ i ].stamp < entry->stamp ) {
+               entry = param_cache + i;
+            }
+         }
+      }
+
+/* Calculate the parameter values and store them in the entry. */
+      if( kind == CACHE_MAPPA ) {
+         palMappa( arg1, arg2, entry->value );
+
+      } else if( kind == CACHE_PREBN ) {
+         palPrebn( arg1, arg2, precess_matrix );
+         (void) memcpy( entry->value, precess_matrix, 9*sizeof( double ) );
+
+      } else if( kind == CACHE_PREC ) {
+         palPrec( arg1, arg2, precess_matrix );
+         (void) memcpy( entry->value, precess_matrix, 9*sizeof( double ) );
+
+/* The ecliptic matrix combines precession from J2000.0 to the required
+   date with the rotation from equatorial to ecliptic coordinates. */
+      } else if( kind == CACHE_ECL ) {
+         palPrec( 2000.0, palEpj( arg1 ), precess_matrix );
+         palEcmat( arg1, rotate_matrix );
+         palDmxm( rotate_matrix, precess_matrix,
+                  (double (*)[ 3 ]) entry->value );
+
+      } else {
+         palEtrms( arg1, entry->value );
+      }
+
+      entry->kind = kind;
+      entry->arg1 = arg1;
+      entry->arg2 = arg2;
+   }
+
+/* Time-stamp the entry and return a copy of its values. */
+   entry->stamp = ++cache_clock;
+   (void) memcpy( value, entry->value, nval*sizeof( double ) );
+}
+
 static int CvtCode( const char *cvt_string, int *status ) {
 /*
 *  Name:
@@ -1869,6 +2102,70 @@ static void J2000H( int forward, int npoint, double *alpha, double *delta, int *
    }
 }
 
+void astSlaCacheStats_( unsigned long int *nhit, unsigned long int *nmiss,
+                        int reset, int *status ){
+/*
+*+
+*  Name:
+*     astSlaCacheStats
+
+*  Purpose:
+*     Get usage statistics for the cache of conversion parameters.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "slamap.h"
+*     void astSlaCacheStats( unsigned long int *nhit,
+*                            unsigned long int *nmiss, int reset )
+
+*  Class Membership:
+*     SlaMap member function.
+
+*  Description:
+*     The SlaMap class keeps a small cache of the parameters (palMappa
+*     parameters, precession matrices, E-terms, etc) used by the most
+*     recent coordinate conversions, so that they do not need to be
+*     re-calculated each time an SlaMap is used. This function returns
+*     the number of times the required parameters were found in the cache
+*     ("hits") and the number of times they had to be calculated
+*     ("misses"), since the cache was created or last reset.
+*
+*     Each thread has its own cache, and so the returned values refer
+*     only to the calling thread.
+
+*  Parameters:
+*     nhit
+*        Pointer to a location at which to return the number of hits.
+*        May be NULL.
+*     nmiss
+*        Pointer to a location at which to return the number of misses.
+*        May be NULL.
+*     reset
+*        If non-zero, the counts are reset to zero after being returned.
+*        The contents of the cache are unchanged.
+*-
+*/
+
+/* Local Variables: */
+   astDECLARE_GLOBALS            /* Pointer to thread-specific global data */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Get a pointer to the thread specific global data structure. */
+   astGET_GLOBALS(NULL);
+
+/* Return the counts, and reset them if required. */
+   if( nhit ) *nhit = cache_hits;
+   if( nmiss ) *nmiss = cache_misses;
+   if( reset ) {
+      cache_hits = 0;
+      cache_misses = 0;
+   }
+}
+
 void astSTPConv1_( double mjd, int in_sys, double in_obs[3], double in[3],
                    int out_sys, double out_obs[3], double out[3], int *status ){
 /*
@@ -3193,6 +3490,256 @@ static int MapMerge( AstMapping *this, int where, int series, int *nmap,
    return result;
 }
 
+static int RotMatrix( int cvttype, double *args, int forward,
+                      double matrix[3][3], int *status ) {
+/*
+*  Name:
+*     RotMatrix
+
+*  Purpose:
+*     Get the rotation matrix for a conversion step that is a pure rotation.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "slamap.h"
+*     int RotMatrix( int cvttype, double *args, int forward,
+*                    double matrix[3][3], int *status )
+
+*  Class Membership:
+*     SlaMap member function.
+
+*  Description:
+*     This function checks if a conversion step is a pure rotation of
+*     the celestial sphere (i.e. it can be applied by converting to
+*     Cartesian coordinates, multiplying by a fixed 3x3 matrix, and
+*     converting back to spherical coordinates). If so, it returns the
+*     matrix. The matrix elements are obtained in the same way as by
+*     the Transform function (or the PAL functions it calls).
+
+*  Parameters:
+*     cvttype
+*        The conversion type.
+*     args
+*        Pointer to the conversion arguments.
+*     forward
+*        If non-zero, return the matrix for the forward direction of the
+*        step. Otherwise, return the matrix for the inverse direction.
+*     matrix
+*        Returned holding the rotation matrix, if the step is a pure
+*        rotation. The rotation is applied by pre-multiplying a column
+*        vector by this matrix.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Non-zero if the step is a pure rotation, and zero otherwise.
+*/
+
+/* Local Constants: */
+/* The equatorial to galactic rotation matrix used by palEqgal and
+   palGaleq. */
+   static double galmat[ 3 ][ 3 ] = {
+      { -0.054875539726,-0.873437108010,-0.483834985808 },
+      { +0.494109453312,-0.444829589425,+0.746982251810 },
+      { -0.867666135858,-0.198076386122,+0.455983795705 }
+   };
+
+/* The galactic to supergalactic rotation matrix used by palGalsup and
+   palSupgal. */
+   static double supmat[ 3 ][ 3 ] = {
+      { -0.735742574804,+0.677261296414,+0.000000000000 },
+      { -0.074553778365,-0.080991471307,+0.993922590400 },
+      { +0.673145302109,+0.731271165817,+0.110081262225 }
+   };
+
+/* Local Variables: */
+   double date1;                 /* First part of TDB Julian date */
+   double date2;                 /* Second part of TDB Julian date */
+   double r5h[ 3 ][ 3 ];         /* FK5 to Hipparcos orientation matrix */
+   double rmat[ 3 ][ 3 ];        /* Matrix for forward direction */
+   double rst[ 3 ][ 3 ];         /* Accumulated spin as a matrix */
+   double s5h[ 3 ];              /* FK5 to Hipparcos spin vector */
+   double t;                     /* Interval from J2000.0 (Julian years) */
+   double vst[ 3 ];              /* Accumulated spin */
+   int i;                        /* Row index */
+   int j;                        /* Column index */
+   int result;                   /* Returned flag */
+   int transpose;                /* Return the transpose of "rmat"? */
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* Initialise. Most steps have a fixed matrix for the forward direction,
+   and use its transpose for the inverse direction. */
+   result = 1;
+   transpose = !forward;
+
+/* Precession uses a matrix calculated for the two epochs, swapped for
+   the inverse direction. */
+   if( cvttype == AST__SLA_PREBN ) {
+      CacheParams( CACHE_PREBN, forward ? args[ 0 ] : args[ 1 ],
+                   forward ? args[ 1 ] : args[ 0 ], rmat[ 0 ], status );
+      transpose = 0;
+
+   } else if( cvttype == AST__SLA_PREC ) {
+      CacheParams( CACHE_PREC, forward ? args[ 0 ] : args[ 1 ],
+                   forward ? args[ 1 ] : args[ 0 ], rmat[ 0 ], status );
+      transpose = 0;
+
+/* The ecliptic conversions use the equatorial to ecliptic matrix, or its
+   transpose. */
+   } else if( cvttype == AST__SLA_EQECL || cvttype == AST__SLA_ECLEQ ) {
+      CacheParams( CACHE_ECL, args[ 0 ], 0.0, rmat[ 0 ], status );
+      if( cvttype == AST__SLA_ECLEQ ) transpose = !transpose;
+
+/* The galactic and supergalactic conversions use fixed matrices. */
+   } else if( cvttype == AST__SLA_EQGAL || cvttype == AST__SLA_GALEQ ) {
+      (void) memcpy( rmat, galmat, sizeof( rmat ) );
+      if( cvttype == AST__SLA_GALEQ ) transpose = !transpose;
+
+   } else if( cvttype == AST__SLA_GALSUP || cvttype == AST__SLA_SUPGAL ) {
+      (void) memcpy( rmat, supmat, sizeof( rmat ) );
+      if( cvttype == AST__SLA_SUPGAL ) transpose = !transpose;
+
+/* The FK5 to ICRS conversion (with zero Hipparcos proper motion) is a
+   rotation followed by a spin which depends on the epoch. Form the
+   matrix in the same way as eraFk5hz. The inverse (eraHfk5z) uses the
+   transpose of the matrix formed from the opposite spin. */
+   } else if( cvttype == AST__SLA_FK5HZ || cvttype == AST__SLA_HFK5Z ) {
+      if( cvttype == AST__SLA_HFK5Z ) forward = !forward;
+      eraEpj2jd( args[ 0 ], &date1, &date2 );
+      t = ( ( date1 - ERFA_DJ00 ) + date2 ) / ERFA_DJY;
+      if( forward ) t = -t;
+      eraFk5hip( r5h, s5h );
+      eraSxp( t, s5h, vst );
+      eraRv2m( vst, rst );
+      if( forward ) {
+         for( i = 0; i < 3; i++ ) {
+            for( j = 0; j < 3; j++ ) rmat[ i ][ j ] = rst[ j ][ i ];
+         }
+         eraRxr( r5h, rmat, rmat );
+         transpose = 0;
+      } else {
+         eraRxr( r5h, rst, rmat );
+         transpose = 1;
+      }
+
+/* The dynamical J2000 to ICRS conversion uses a fixed matrix. */
+   } else if( cvttype == AST__J2000H || cvttype == AST__HJ2000 ) {
+      palDeuler( "XYZ", -0.0068192*AS2R, 0.0166172*AS2R, 0.0146000*AS2R,
+                 rmat );
+      if( cvttype == AST__HJ2000 ) transpose = !transpose;
+
+/* All other steps are not pure rotations. */
+   } else {
+      result = 0;
+   }
+
+/* Return the matrix, transposing it if required. */
+   if( result ) {
+      for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+            matrix[ i ][ j ] = transpose ? rmat[ j ][ i ] : rmat[ i ][ j ];
+         }
+      }
+   }
+
+/* Return the result. */
+   return astOK ? result : 0;
+}
+
+static int RotRun( AstSlaMap *this, int cvt, int forward, double matrix[3][3],
+                   int *norm, int *status ) {
+/*
+*  Name:
+*     RotRun
+
+*  Purpose:
+*     Combine a run of pure rotation steps into a single rotation.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "slamap.h"
+*     int RotRun( AstSlaMap *this, int cvt, int forward, double matrix[3][3],
+*                 int *norm, int *status )
+
+*  Class Membership:
+*     SlaMap member function.
+
+*  Description:
+*     This function checks if the conversion step with index "cvt" is
+*     a pure rotation of the celestial sphere and, if so, how many of the
+*     steps that would be applied immediately after it are also pure
+*     rotations. If the run contains two or more steps, the product of
+*     their rotation matrices is returned, so that the whole run can be
+*     applied as a single rotation.
+
+*  Parameters:
+*     this
+*        Pointer to the SlaMap.
+*     cvt
+*        Index of the first step in the run.
+*     forward
+*        If non-zero, the steps are applied in their forward direction in
+*        order of increasing index. Otherwise, they are applied in their
+*        inverse direction in order of decreasing index.
+*     matrix
+*        Returned holding the combined rotation matrix if the run
+*        contains two or more steps.
+*     norm
+*        Returned holding a flag indicating if the longitude values
+*        produced by the final step in the run are normalised into the
+*        range [0,2*PI).
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The number of steps in the run, or zero if the step with index "cvt"
+*     is not a pure rotation.
+*/
+
+/* Local Variables: */
+   double rmat[ 3 ][ 3 ];        /* Rotation matrix for a single step */
+   int icvt;                     /* Index of step */
+   int inc;                      /* Increment to the next step */
+   int result;                   /* Number of steps in the run */
+
+/* Initialise. */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Loop round the steps in the order in which they are applied, until a
+   step is found which is not a pure rotation. */
+   inc = forward ? 1 : -1;
+   for( icvt = cvt; icvt >= 0 && icvt < this->ncvt; icvt += inc ) {
+      if( !RotMatrix( this->cvttype[ icvt ], this->cvtargs[ icvt ], forward,
+                      rmat, status ) ) break;
+
+/* Accumulate the product of the matrices. Each step's matrix
+   pre-multiplies the product of the matrices for the earlier steps. */
+      if( result == 0 ) {
+         (void) memcpy( matrix, rmat, sizeof( rmat ) );
+      } else {
+         palDmxm( rmat, matrix, matrix );
+      }
+      result++;
+
+/* The dynamical J2000 conversions are the only rotations which do not
+   normalise the resulting longitude values. */
+      *norm = ( this->cvttype[ icvt ] != AST__J2000H &&
+                this->cvttype[ icvt ] != AST__HJ2000 );
+   }
+
+/* Return the result. */
+   return astOK ? result : 0;
+}
+
 static void SlaAdd( AstSlaMap *this, const char *cvt, int narg,
                     const double args[], int *status ) {
 /*
@@ -3503,6 +4050,66 @@ static void SolarPole( double mjd, double pole[3], int *status ) {
 
 }
 
+static void Subet( double rc, double dc, double eterms[3], double *rm,
+                   double *dm ) {
+/*
+*  Name:
+*     Subet
+
+*  Purpose:
+*     Remove the E-terms of aberration from a position.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "slamap.h"
+*     void Subet( double rc, double dc, double eterms[3], double *rm,
+*                 double *dm )
+
+*  Class Membership:
+*     SlaMap member function.
+
+*  Description:
+*     This function does the same as palSubet, except that the E-terms
+*     vector is supplied by the caller rather than being recalculated
+*     for every position. The arithmetic is identical to that of palSubet.
+
+*  Parameters:
+*     rc
+*        The RA with E-terms included (radians).
+*     dc
+*        The Dec with E-terms included (radians).
+*     eterms
+*        The E-terms vector, as returned by palEtrms.
+*     rm
+*        Pointer to a location at which to return the RA without E-terms
+*        (radians).
+*     dm
+*        Pointer to a location at which to return the Dec without E-terms
+*        (radians).
+
+*  Notes:
+*     - This function does not check the inherited status.
+*/
+
+/* Local Variables: */
+   double f;                     /* Scale factor */
+   double v[ 3 ];                /* Cartesian position */
+   int i;                        /* Axis index */
+
+/* Spherical to Cartesian. */
+   palDcs2c( rc, dc, v );
+
+/* Remove the E-terms. */
+   f = 1.0 + palDvdv( v, eterms );
+   for( i = 0; i < 3; i++ ) v[ i ] = f*v[ i ] - eterms[ i ];
+
+/* Cartesian to spherical, bringing the RA into the conventional range. */
+   palDcc2s( v, rm, dm );
+   *rm = palDranrm( *rm );
+}
+
 static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
                                int forward, AstPointSet *out, int *status ) {
 /*
@@ -3560,7 +4167,6 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
 */
 
 /* Local Variables: */
-   astDECLARE_GLOBALS            /* Pointer to thread-specific global data */
    AstPointSet *result;          /* Pointer to output PointSet */
    AstSlaMap *map;               /* Pointer to SlaMap to be applied */
    double **ptr_in;              /* Pointer to input coordinate data */
@@ -3571,11 +4177,14 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
    double *delta;                /* Pointer to latitude array */
    double *p[3];                 /* Pointers to arrays to be transformed */
    double *obs;                  /* Pointer to array holding observers position */
+   double rot_matrix[ 3 ][ 3 ];  /* Combined matrix for a run of rotations */
    int cvt;                      /* Loop counter for conversions */
    int ct;                       /* Conversion type */
    int end;                      /* Termination index for conversion loop */
    int inc;                      /* Increment for conversion loop */
+   int norm;                     /* Normalise longitudes after rotation? */
    int npoint;                   /* Number of points */
+   int nrot;                     /* Number of steps in a run of rotations */
    int point;                    /* Loop counter for points */
    int start;                    /* Starting index for conversion loop */
    int sys;                      /* STP coordinate system code */
@@ -3583,9 +4192,6 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
 /* Check the global error status. */
    if ( !astOK ) return NULL;
 
-/* Get a pointer to the thread specific global data structure. */
-   astGET_GLOBALS(this);
-
 /* Obtain a pointer to the SlaMap. */
    map = (AstSlaMap *) this;
 
@@ -3651,23 +4257,45 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
 	   } \
         }
 
+/* If this step and the next step(s) to be applied are all pure rotations
+   of the celestial sphere, apply the whole run of steps as a single
+   rotation, avoiding the conversions to and from Cartesian coordinates
+   between the steps. Then skip to the last step in the run. */
+         nrot = RotRun( map, cvt, forward, rot_matrix, &norm, status );
+         if( nrot > 1 ) {
+            double vec1[ 3 ];
+            double vec2[ 3 ];
+            TRAN_ARRAY(palDcs2c( alpha[ point ], delta[ point ], vec1 );
+                       palDmxv( rot_matrix, vec1, vec2 );
+                       palDcc2s( vec2, alpha + point, delta + point );
+                       if( norm ) alpha[ point ] = palDranrm( alpha[ point ] );)
+            cvt += ( nrot - 1 )*inc;
+            continue;
+         }
+
 /* Classify the SLALIB sky coordinate conversion to be applied. */
          ct = map->cvttype[ cvt ];
          switch ( ct ) {
 
 /* Add E-terms of aberration. */
 /* -------------------------- */
-/* Add or subtract (for the inverse) the E-terms from each coordinate pair
-   in turn, returning the results to the same arrays. */
+/* Get the E-terms vector (this is what palAddet and palSubet would
+   calculate for every point). Then add or subtract (for the inverse) the
+   E-terms from each coordinate pair in turn, returning the results to the
+   same arrays. */
             case AST__SLA_ADDET:
-               if ( forward ) {
-                  TRAN_ARRAY(palAddet( alpha[ point ], delta[ point ],
-                                       args[ 0 ],
+               {
+                  double eterms[ 3 ];
+                  CacheParams( CACHE_ETRMS, args[ 0 ], 0.0, eterms, status );
+                  if ( forward ) {
+                     TRAN_ARRAY(Addet( alpha[ point ], delta[ point ],
+                                       eterms,
                                        alpha + point, delta + point );)
-	       } else {
-                  TRAN_ARRAY(palSubet( alpha[ point ], delta[ point ],
-                                       args[ 0 ],
+                  } else {
+                     TRAN_ARRAY(Subet( alpha[ point ], delta[ point ],
+                                       eterms,
                                        alpha + point, delta + point );)
+                  }
                }
                break;
 
@@ -3676,15 +4304,19 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
 /* This is the same as above, but with the forward and inverse cases
    transposed. */
             case AST__SLA_SUBET:
-               if ( forward ) {
-                  TRAN_ARRAY(palSubet( alpha[ point ], delta[ point ],
-                                       args[ 0 ],
+               {
+                  double eterms[ 3 ];
+                  CacheParams( CACHE_ETRMS, args[ 0 ], 0.0, eterms, status );
+                  if ( forward ) {
+                     TRAN_ARRAY(Subet( alpha[ point ], delta[ point ],
+                                       eterms,
                                        alpha + point, delta + point );)
-	       } else {
-                  TRAN_ARRAY(palAddet( alpha[ point ], delta[ point ],
-                                       args[ 0 ],
+                  } else {
+                     TRAN_ARRAY(Addet( alpha[ point ], delta[ point ],
+                                       eterms,
                                        alpha + point, delta + point );)
-	       }
+                  }
+               }
                break;
 
 /* Apply Bessel-Newcomb pre-IAU 1976 (FK4) precession model. */
@@ -3699,7 +4331,8 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
                   double precess_matrix[ 3 ][ 3 ];
                   double vec1[ 3 ];
                   double vec2[ 3 ];
-                  palPrebn( epoch1, epoch2, precess_matrix );
+                  CacheParams( CACHE_PREBN, epoch1, epoch2,
+                               precess_matrix[ 0 ], status );
 
 /* For each point in the (alpha,delta) arrays, convert to Cartesian
    coordinates, apply the precession matrix, convert back to polar coordinates
@@ -3723,7 +4356,8 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
                   double precess_matrix[ 3 ][ 3 ];
                   double vec1[ 3 ];
                   double vec2[ 3 ];
-                  palPrec( epoch1, epoch2, precess_matrix );
+                  CacheParams( CACHE_PREC, epoch1, epoch2,
+                               precess_matrix[ 0 ], status );
                   TRAN_ARRAY(palDcs2c( alpha[ point ], delta[ point ], vec1 );
                              palDmxv( precess_matrix, vec1, vec2 );
                              palDcc2s( vec2, alpha + point, delta + point );
@@ -3779,16 +4413,10 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
                {
 
                   if( !extra ) {
-
-                     if( args[ 1 ] != eq_cache ||
-                         args[ 0 ] != ep_cache ) {
-                        eq_cache = args[ 1 ];
-                        ep_cache = args[ 0 ];
-                        palMappa( eq_cache, ep_cache, amprms_cache );
-                     }
-
-                     extra = astStore( NULL, amprms_cache,
-                                       sizeof( double )*21 );
+                     double amprms[ 21 ];
+                     CacheParams( CACHE_MAPPA, args[ 1 ], args[ 0 ], amprms,
+                                  status );
+                     extra = astStore( NULL, amprms, sizeof( double )*21 );
                      map->cvtextra[ cvt ] = extra;
                   }
 
@@ -3814,16 +4442,10 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
 	    case AST__SLA_MAP:
                {
                   if( !extra ) {
-
-                     if( args[ 0 ] != eq_cache ||
-                         args[ 1 ] != ep_cache ) {
-                        eq_cache = args[ 0 ];
-                        ep_cache = args[ 1 ];
-                        palMappa( eq_cache, ep_cache, amprms_cache );
-                     }
-
-                     extra = astStore( NULL, amprms_cache,
-                                       sizeof( double )*21 );
+                     double amprms[ 21 ];
+                     CacheParams( CACHE_MAPPA, args[ 0 ], args[ 1 ], amprms,
+                                  status );
+                     extra = astStore( NULL, amprms, sizeof( double )*21 );
                      map->cvtextra[ cvt ] = extra;
                   }
 
@@ -3846,21 +4468,16 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
 	    case AST__SLA_ECLEQ:
                {
                   double convert_matrix[ 3 ][ 3 ];
-                  double precess_matrix[ 3 ][ 3 ];
-                  double rotate_matrix[ 3 ][ 3 ];
                   double vec1[ 3 ];
                   double vec2[ 3 ];
 
-/* Obtain the matrix that precesses equatorial coordinates from J2000.0 to the
-   required date. Also obtain the rotation matrix that converts from
-   equatorial to ecliptic coordinates.  */
-                  palPrec( 2000.0, palEpj( args[ 0 ] ), precess_matrix );
-                  palEcmat( args[ 0 ], rotate_matrix );
-
-/* Multiply these matrices to give the overall matrix that converts from
-   equatorial J2000.0 coordinates to ecliptic coordinates for the required
-   date. */
-                  palDmxm( rotate_matrix, precess_matrix, convert_matrix );
+/* Obtain the matrix that converts from equatorial J2000.0 coordinates to
+   ecliptic coordinates for the required date. This is the product of the
+   matrix that precesses equatorial coordinates from J2000.0 to the
+   required date and the rotation matrix that converts from equatorial to
+   ecliptic coordinates. */
+                  CacheParams( CACHE_ECL, args[ 0 ], 0.0, convert_matrix[ 0 ],
+                               status );
 
 /* Apply the conversion by transforming from polar to Cartesian coordinates,
    multiplying by the inverse conversion matrix and converting back to polar
@@ -3892,15 +4509,12 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
 	    case AST__SLA_EQECL:
                {
                   double convert_matrix[ 3 ][ 3 ];
-                  double precess_matrix[ 3 ][ 3 ];
-                  double rotate_matrix[ 3 ][ 3 ];
                   double vec1[ 3 ];
                   double vec2[ 3 ];
 
-/* Create the conversion matrix. */
-                  palPrec( 2000.0, palEpj( args[ 0 ] ), precess_matrix );
-                  palEcmat( args[ 0 ], rotate_matrix );
-                  palDmxm( rotate_matrix, precess_matrix, convert_matrix );
+/* Get the conversion matrix. */
+                  CacheParams( CACHE_ECL, args[ 0 ], 0.0, convert_matrix[ 0 ],
+                               status );
 
 /* Apply it. */
                   if ( forward ) {
@@ -66,6 +66,8 @@
 *           Initialise an SlaMap.
 *        astLoadSlaMap
 *           Load an SlaMap.
+*        astSlaCacheStats
+*           Get usage statistics for the cache of conversion parameters.
 
 *  Macros:
 *     None.
@@ -209,6 +211,20 @@ typedef struct AstSlaMapVtab {
    int (* SlaIsEmpty)( AstSlaMap *, int * );
 } AstSlaMapVtab;
 
+/* The number of entries in the cache of conversion parameters. */
+#define AST__SLACACHE 16
+
+/* An entry in the cache of conversion parameters. Each entry holds the
+   values (e.g. a precession matrix) calculated by PAL for a particular
+   kind of parameter and a particular pair of arguments (e.g. epochs). */
+typedef struct AstSlaCacheEntry {
+   int kind;                     /* Identifies the kind of parameter */
+   double arg1;                  /* First argument used to calculate values */
+   double arg2;                  /* Second argument used to calculate values */
+   double value[ 21 ];           /* The calculated parameter values */
+   unsigned long int stamp;      /* Time-stamp of most recent use */
+} AstSlaCacheEntry;
+
 #if defined(THREAD_SAFE)
 
 /* Define a structure holding all data items that are global within this
@@ -216,9 +232,11 @@ typedef struct AstSlaMapVtab {
 typedef struct AstSlaMapGlobals {
    AstSlaMapVtab Class_Vtab;
    int Class_Init;
-   double Eq_Cache;
-   double Ep_Cache;
-   double Amprms_Cache[ 21 ];
+   AstSlaCacheEntry Param_Cache[ AST__SLACACHE ];
+   int Cache_Used;
+   unsigned long int Cache_Clock;
+   unsigned long int Cache_Hits;
+   unsigned long int Cache_Misses;
 } AstSlaMapGlobals;
 
 #endif
@@ -258,6 +276,7 @@ void astInitSlaMapGlobals_( AstSlaMapGlobals * );
 #endif
 
 /* Other functions. */
+void astSlaCacheStats_( unsigned long int *, unsigned long int *, int, int * );
 void astSTPConv1_( double, int, double[3], double[3], int, double[3], double[3], int * );
 void astSTPConv_( double, int, int, double[3], double *[3], int, double[3], double *[3], int * );
 
@@ -319,6 +338,7 @@ astINVOKE(V,astSlaAdd_(astCheckSlaMap(this),cvt,narg,args,STATUS_PTR))
 #if defined(astCLASS)            /* Protected */
 #define astSTPConv astSTPConv_
 #define astSTPConv1 astSTPConv1_
+#define astSlaCacheStats(nhit,nmiss,reset) astSlaCacheStats_(nhit,nmiss,reset,STATUS_PTR)
 #define astSlaIsEmpty(this) astINVOKE(V,astSlaIsEmpty_(astCheckSlaMap(this),STATUS_PTR))
 #endif
 
@@ -248,6 +248,12 @@ typedef struct FrameDef {
    double vuser[3];   /* Used-defined velocity as a FK5 J2000 vector */
    double dvh[3];     /* Earth-sun velocity */
    double dvb[3];     /* Barycentre-sun velocity */
+   double pvobs[6];   /* Observer position and velocity w.r.t. the earth */
+   double factor;     /* Frequency correction factor for a single position */
+   double *fcorr;     /* Pointer to cached frequency correction factor */
+   int sign;          /* Sign for velocity correction */
+   double (* velfunc)( double, double, double[3], struct FrameDef *, int * );
+                      /* Function returning frame velocity */
 } FrameDef;
 
 /* External Interface Function Prototypes. */
@@ -261,26 +267,26 @@ AstSpecMap *astSpecMapId_( int, int, const char *, ... );
 /* ======================================== */
 static AstPointSet *Transform( AstMapping *, AstPointSet *, int, AstPointSet *, int * );
 static const char *CvtString( int, const char **, int *, int *, int *, int *, const char *[ MAX_ARGS ], int * );
-static double BaryVel( double, double, FrameDef *, int * );
-static double GalVel( double, double, FrameDef *, int * );
-static double GeoVel( double, double, FrameDef *, int * );
-static double LgVel( double, double, FrameDef *, int * );
-static double LsrdVel( double, double, FrameDef *, int * );
-static double LsrkVel( double, double, FrameDef *, int * );
+static double BaryVel( double, double, double[3], FrameDef *, int * );
+static double GalVel( double, double, double[3], FrameDef *, int * );
+static double GeoVel( double, double, double[3], FrameDef *, int * );
+static double LgVel( double, double, double[3], FrameDef *, int * );
+static double LsrdVel( double, double, double[3], FrameDef *, int * );
+static double LsrkVel( double, double, double[3], FrameDef *, int * );
 static double Rate( AstMapping *, double *, int, int, int * );
 static double Refrac( double, int * );
-static double Rverot( double, double, double, double, double, int * );
-static double TopoVel( double, double, FrameDef *, int * );
-static double UserVel( double, double, FrameDef *, int * );
+static double TopoVel( double, double, double[3], FrameDef *, int * );
+static double UserVel( double, double, double[3], FrameDef *, int * );
 static int CvtCode( const char *, int * );
 static int Equal( AstObject *, AstObject *, int * );
-static int FrameChange( int, int, double *, double *, double *, double *, int, int * );
 static int MapMerge( AstMapping *, int, int, int *, AstMapping ***, int **, int * );
+static int SetFrameDef( int, double *, int, FrameDef *, int * );
 static int SystemChange( int, int, double *, double *, int, int * );
 static void AddSpecCvt( AstSpecMap *, int, int, const double *, int * );
 static void Copy( const AstObject *, AstObject *, int * );
 static void Delete( AstObject *, int * );
 static void Dump( AstObject *, AstChannel *, int * );
+static void FrameChange( int, FrameDef *, int, double *, double *, double *, int, int * );
 static void SpecAdd( AstSpecMap *, const char *, int, const double[], int * );
 
 static int GetObjSize( AstObject *, int * );
@@ -704,7 +710,8 @@ static void AddSpecCvt( AstSpecMap *this, int cvttype, int narg,
    }
 }
 
-static double BaryVel( double ra, double dec, FrameDef *def, int *status ) {
+static double BaryVel( double ra, double dec, double v[3],
+                       FrameDef *def, int *status ) {
 /*
 *  Name:
 *     BaryVel
@@ -717,7 +724,8 @@ static double BaryVel( double ra, double dec, FrameDef *def, int *status ) {
 
 *  Synopsis:
 *     #include "specmap.h"
-*     double BaryVel( double ra, double dec, FrameDef *def, int *status )
+*     double BaryVel( double ra, double dec, double v[3],
+*                     FrameDef *def, int *status )
 
 *  Class Membership:
 *     SpecMap method.
@@ -732,6 +740,9 @@ static double BaryVel( double ra, double dec, FrameDef *def, int *status ) {
 *        The RA (rads, FK5 J2000) of the source.
 *     dec
 *        The Dec (rads, FK5 J2000) of the source.
+*     v
+*        The Cartesian unit vector (FK5 J2000) towards the source, as
+*        returned by palDcs2c for "ra" and "dec".
 *     def
 *        Pointer to a FrameDef structure which holds the parameters which
 *        define the frame, together with cached intermediate results.
@@ -745,34 +756,12 @@ static double BaryVel( double ra, double dec, FrameDef *def, int *status ) {
 
 */
 
-/* Local Variables: */
-   double dpb[ 3 ];          /* Barycentric earth position vector */
-   double dph[ 3 ];          /* Heliocentric earth position vector */
-   double dvh[ 3 ];          /* Heliocentric earth velocity vector */
-   double v[ 3 ];            /* Source direction vector */
-
 /* Check the global error status. */
    if ( !astOK ) return 0.0;
 
-/* Get the Cartesian vector towards the source, in the Cartesian FK5
-   J2000 system. */
-   palDcs2c( ra, dec, v );
-
-/* If not already done so, get the Earth/Sun velocity and position vectors in
-   the same system. Speed is returned in units of AU/s. Store in the supplied
-   frame definition structure. */
-   if( def->dvb[ 0 ] == AST__BAD ) {
-      palEvp( def->epoch, 2000.0, def->dvb, dpb, dvh, dph );
-
-/* Change the barycentric velocity of the earth into the heliocentric
-   velocity of the barycentre. */
-      def->dvb[ 0 ] = dvh[ 0 ] - def->dvb[ 0 ];
-      def->dvb[ 1 ] = dvh[ 1 ] - def->dvb[ 1 ];
-      def->dvb[ 2 ] = dvh[ 2 ] - def->dvb[ 2 ];
-   }
-
 /* Return the component away from the source, of the velocity of the
-   barycentre relative to the sun (in m/s). */
+   barycentre relative to the sun (in m/s). The heliocentric velocity of
+   the barycentre is found by SetFrameDef. */
    return -palDvdv( v, def->dvb )*149.597870E9;
 
 }
@@ -1370,36 +1359,39 @@ static const char *CvtString( int cvt_code, const char **comment,
    return result;
 }
 
-static int FrameChange( int cvt_code, int np, double *ra, double *dec, double *freq,
-                        double *args, int forward, int *status ){
+static void FrameChange( int nstep, FrameDef *defs, int np, double *ra,
+                         double *dec, double *freq, int forward, int *status ){
 /*
 *  Name:
 *     FrameChange
 
 *  Purpose:
-*     Apply a doppler shift caused by a change of reference frame.
+*     Apply the doppler shifts caused by a sequence of reference frame changes.
 
 *  Type:
 *     Private function.
 
 *  Synopsis:
 *     #include "specmap.h"
-*     int FrameChange( int cvt_code, int np, double *ra, double *dec,
-*                      double *freq, double *args, int forward, int *status )
+*     void FrameChange( int nstep, FrameDef *defs, int np, double *ra,
+*                       double *dec, double *freq, int forward, int *status )
 
 *  Class Membership:
 *     SpecMap method.
 
 *  Description:
 *     This function modifies the supplied frequency values in order to
-*     apply a doppler shift caused by a change of the observers rest-frame.
+*     apply the doppler shifts caused by one or more consecutive changes
+*     of the observers rest-frame. All the changes are applied to each
+*     frequency in a single pass through the supplied arrays.
 
 *  Parameters:
-*     cvt_code
-*        A code indicating the conversion to be applied. If the code does
-*        not correspond to a change of rest-frame, then the supplied
-*        frequencies are left unchanged and zero is returned as the
-*        function value.
+*     nstep
+*        The number of rest-frame changes to apply.
+*     defs
+*        Pointer to an array of "nstep" FrameDef structures, in the order
+*        in which the changes are to be applied. Each one should have been
+*        initialised using SetFrameDef.
 *     np
 *        The number of frequency values to transform.
 *     ra
@@ -1416,303 +1408,115 @@ static int FrameChange( int cvt_code, int np, double *ra, double *dec, double *f
 *        Pointer to an array of "np" frequency values, measured in the
 *        input rest-frame. These are modified on return to hold the
 *        corresponding values measured in the output rest-frame.
-*     args
-*        Pointer to an array holding the conversion arguments. The number
-*        of arguments expected depends on the particular conversion being
-*        used.
 *     forward
-*        Should the conversion be applied in the forward or inverse
+*        Should the changes be applied in the forward or inverse
 *        direction? Non-zero for forward, zero for inverse.
 *     status
 *        Pointer to the inherited status variable.
 
-*  Returned Value:
-*     Non-zero if the supplied conversion code corresponds to a change of
-*     reference frame. Zoer otherwise  (in which case the upplied values
-*     will not have been changed).
-
-*  Notes:
-*     - The "args" array contains RA and DEC values which give the "source"
-*     position (FK5 J2000). If a NULL value is supplied for the "ra"
-*     parameter, then these args define the position of all the frequency
-*     values. In addition they also define the direction of motion of
-*     the "user-defined" rest-frame (see "veluser"). Thus they should still
-*     be supplied even if "ra" is NULL.
-
 */
 
 /* Local Variables: */
-   FrameDef def;      /* Structure holding frame parameters */
-   double (* cvtFunc)( double, double, FrameDef *, int * ); /* Pointer to conversion function */
-   double *fcorr;     /* Pointer to frequency correction factor */
+   FrameDef *def;     /* Pointer to next frame definition */
    double *pdec;      /* Pointer to next Dec value */
    double *pf;        /* Pointer to next frequency value */
    double *pra;       /* Pointer to next RA value */
-   double factor;     /* Frequency correction factor */
+   double f0;         /* First correction factor */
+   double f1;         /* Second correction factor */
+   double f;          /* Corrected frequency */
    double s;          /* Velocity correction (m/s) */
+   double v[ 3 ];     /* Source direction vector */
+   int bad;           /* Are any correction factors un-physical? */
    int i;             /* Loop index */
-   int result;        /* Returned value */
-   int sign;          /* Sign for velocity correction */
+   int istep;         /* Index of next rest-frame change */
 
 /* Check inherited status. */
-   if( !astOK ) return 0;
-
-/* Initialise */
-   cvtFunc = NULL;
-   fcorr = NULL;
-   sign = 0;
-
-/* Set the return value to indicate that the supplied conversion code
-   represents a change of rest-frame. */
-   result = 1;
-
-/* Initialise a structure which stores parameters which define the
-   transformation. */
-   def.obsalt = AST__BAD;
-   def.obslat = AST__BAD;
-   def.obslon = AST__BAD;
-   def.epoch = AST__BAD;
-   def.refdec = AST__BAD;
-   def.refra = AST__BAD;
-   def.veluser = AST__BAD;
-   def.last = AST__BAD;
-   def.amprms[ 0 ] = AST__BAD;
-   def.vuser[ 0 ] = AST__BAD;
-   def.dvh[ 0 ] = AST__BAD;
-   def.dvb[ 0 ] = AST__BAD;
-
-/* Test for each rest-frame code value in turn and assign the appropriate
-   values. */
-   switch ( cvt_code ) {
-
-   case AST__USF2HL:
-      cvtFunc = UserVel;
-      def.veluser = args[ 0 ];
-      def.refra = args[ 1 ];
-      def.refdec = args[ 2 ];
-      fcorr = args + 3;
-      sign = -1;
-      break;
-
-   case AST__HLF2US:
-      cvtFunc = UserVel;
-      def.veluser = args[ 0 ];
-      def.refra = args[ 1 ];
-      def.refdec = args[ 2 ];
-      fcorr = args + 3;
-      sign = +1;
-      break;
-
-   case AST__TPF2HL:
-      cvtFunc = TopoVel;
-      def.obslon = args[ 0 ];
-      def.obslat = args[ 1 ];
-      def.obsalt = args[ 2 ];
-      def.epoch = args[ 3 ];
-      def.refra = args[ 4 ];
-      def.refdec = args[ 5 ];
-      fcorr = args + 6;
-      sign = -1;
-      break;
-
-   case AST__HLF2TP:
-      cvtFunc = TopoVel;
-      def.obslon = args[ 0 ];
-      def.obslat = args[ 1 ];
-      def.obsalt = args[ 2 ];
-      def.epoch = args[ 3 ];
-      def.refra = args[ 4 ];
-      def.refdec = args[ 5 ];
-      fcorr = args + 6;
-      sign = +1;
-      break;
-
-   case AST__GEF2HL:
-      cvtFunc = GeoVel;
-      def.epoch = args[ 0 ];
-      def.refra = args[ 1 ];
-      def.refdec = args[ 2 ];
-      fcorr = args + 3;
-      sign = -1;
-      break;
-
-   case AST__HLF2GE:
-      cvtFunc = GeoVel;
-      def.epoch = args[ 0 ];
-      def.refra = args[ 1 ];
-      def.refdec = args[ 2 ];
-      fcorr = args + 3;
-      sign = +1;
-      break;
-
-   case AST__BYF2HL:
-      cvtFunc = BaryVel;
-      def.epoch = args[ 0 ];
-      def.refra = args[ 1 ];
-      def.refdec = args[ 2 ];
-      fcorr = args + 3;
-      sign = -1;
-      break;
-
-   case AST__HLF2BY:
-      cvtFunc = BaryVel;
-      def.epoch = args[ 0 ];
-      def.refra = args[ 1 ];
-      def.refdec = args[ 2 ];
-      fcorr = args + 3;
-      sign = +1;
-      break;
-
-   case AST__LKF2HL:
-      cvtFunc = LsrkVel;
-      def.refra = args[ 0 ];
-      def.refdec = args[ 1 ];
-      fcorr = args + 2;
-      sign = -1;
-      break;
-
-   case AST__HLF2LK:
-      cvtFunc = LsrkVel;
-      def.refra = args[ 0 ];
-      def.refdec = args[ 1 ];
-      fcorr = args + 2;
-      sign = +1;
-      break;
-
-   case AST__LDF2HL:
-      cvtFunc = LsrdVel;
-      def.refra = args[ 0 ];
-      def.refdec = args[ 1 ];
-      fcorr = args + 2;
-      sign = -1;
-      break;
-
-   case AST__HLF2LD:
-      cvtFunc = LsrdVel;
-      def.refra = args[ 0 ];
-      def.refdec = args[ 1 ];
-      fcorr = args + 2;
-      sign = +1;
-      break;
-
-   case AST__LGF2HL:
-      cvtFunc = LgVel;
-      def.refra = args[ 0 ];
-      def.refdec = args[ 1 ];
-      fcorr = args + 2;
-      sign = -1;
-      break;
-
-   case AST__HLF2LG:
-      cvtFunc = LgVel;
-      def.refra = args[ 0 ];
-      def.refdec = args[ 1 ];
-      fcorr = args + 2;
-      sign = +1;
-      break;
-
-   case AST__GLF2HL:
-      cvtFunc = GalVel;
-      def.refra = args[ 0 ];
-      def.refdec = args[ 1 ];
-      fcorr = args + 2;
-      sign = -1;
-      break;
-
-   case AST__HLF2GL:
-      cvtFunc = GalVel;
-      def.refra = args[ 0 ];
-      def.refdec = args[ 1 ];
-      fcorr = args + 2;
-      sign = +1;
-      break;
-
-/* If the supplied code does not represent a change of rest-frame, clear
-   the returned flag. */
-   default:
-      result = 0;
-   }
-
-/* Check we have a rest-frame code. */
-   if( result ) {
+   if( !astOK ) return;
 
 /* First deal with cases where we have a single source position (given by
-   refra and refdec). */
-      if( !ra ) {
-
-/* If the frequency correction factor has not been found, find it now. */
-         if( *fcorr == AST__BAD ) {
-
-/* Get the velocity correction. This is the component of the velocity of the
-   output system, away from the source, as measured in the input system. */
-            s = sign*cvtFunc( def.refra, def.refdec, &def, status );
-
-/* Find the factor by which to correct supplied frequencies. If the
-   velocity correction is positive, the output frequency wil be lower than
-   the input frequency. */
-            if( s < AST__C && s > -AST__C ) {
-               *fcorr = sqrt( ( AST__C - s )/( AST__C + s ) );
-            }
+   refra and refdec). The frequency correction factor for each change will
+   have been found by SetFrameDef. Store the factor by which to multiply
+   the frequencies, and note if any of the factors are un-physical. */
+   if( !ra ) {
+      bad = 0;
+      for( istep = 0; istep < nstep; istep++ ) {
+         def = defs + istep;
+         if( *(def->fcorr) != AST__BAD && *(def->fcorr) != 0.0 ) {
+            def->factor = forward ? *(def->fcorr) : 1.0 / *(def->fcorr);
+         } else {
+            bad = 1;
          }
+      }
 
-/* Correct each supplied frequency. */
-         if( *fcorr != AST__BAD && *fcorr != 0.0 ) {
-            factor = forward ? *fcorr : 1.0 / ( *fcorr );
+/* Correct each supplied frequency, applying the factors in turn. The
+   factors are applied two at a time so that a typical run (e.g. LSRK to
+   heliocentric to barycentric) needs only a single pass through the
+   frequencies. A missing second factor is replaced by unity, which leaves
+   the frequency unchanged. */
+      if( !bad ) {
+         for( istep = 0; istep < nstep; istep += 2 ) {
+            f0 = defs[ istep ].factor;
+            f1 = ( istep + 1 < nstep ) ? defs[ istep + 1 ].factor : 1.0;
             pf = freq;
             for( i = 0; i < np; i++, pf++ ) {
-               if( *pf != AST__BAD ) *pf *= factor;
+               if( *pf != AST__BAD ) *pf = ( *pf * f0 )*f1;
             }
-
-/* Set returned values bad if the velocity correction is un-physical. */
-         } else {
-            pf = freq;
-            for( i = 0; i < np; i++ ) *(pf++) = AST__BAD;
          }
 
-/* Now deal with cases where each frequency value has its own source
-   position. */
+/* Set returned values bad if any velocity correction is un-physical. */
       } else {
+         pf = freq;
+         for( i = 0; i < np; i++ ) *(pf++) = AST__BAD;
+      }
 
-/* Invert the sign if we are doing a inverse transformation. */
-         if( !forward ) sign = -sign;
+/* Now deal with cases where each frequency value has its own source
+   position. */
+   } else {
 
 /* Loop round each value. */
-         pf = freq;
-         pra = ra;
-         pdec = dec;
-         for( i = 0; i < np; i++ ) {
+      pf = freq;
+      pra = ra;
+      pdec = dec;
+      for( i = 0; i < np; i++ ) {
 
 /* If the ra or dec is bad, store a bad frequency. */
-            if( *pra == AST__BAD || *pdec == AST__BAD || *pf == AST__BAD ) {
-               *pf = AST__BAD;
+         if( *pra == AST__BAD || *pdec == AST__BAD || *pf == AST__BAD ) {
+            *pf = AST__BAD;
 
-/* Otherwise, produce a corrected frequency. */
-            } else {
+/* Otherwise, get the Cartesian vector towards the source, in the Cartesian
+   FK5 J2000 system. This is shared by all the rest-frame changes. */
+         } else {
+            palDcs2c( *pra, *pdec, v );
 
-/* Get the velocity correction. */
-               s = sign*cvtFunc( *pra, *pdec, &def, status );
+/* Apply each change in turn. Get the velocity correction, inverting the
+   sign if we are doing an inverse transformation. Correct the frequency,
+   if possible. Otherwise set it bad and skip any remaining changes. */
+            f = *pf;
+            for( istep = 0; istep < nstep; istep++ ) {
+               def = defs + istep;
+               s = def->sign*def->velfunc( *pra, *pdec, v, def, status );
+               if( !forward ) s = -s;
 
-/* Correct this frequency, if possible. Otherwise set bad. */
                if( s < AST__C && s > -AST__C ) {
-                  *pf *= sqrt( ( AST__C - s )/( AST__C + s ) );
+                  f *= sqrt( ( AST__C - s )/( AST__C + s ) );
                } else {
-                  *pf = AST__BAD;
+                  f = AST__BAD;
+                  break;
                }
             }
+            *pf = f;
+         }
 
 /* Move on to the next position. */
-            pf++;
-            pra++;
-            pdec++;
-         }
+         pf++;
+         pra++;
+         pdec++;
       }
    }
-
-/* Return the result. */
-   return result;
 }
 
-static double GalVel( double ra, double dec, FrameDef *def, int *status ) {
+static double GalVel( double ra, double dec, double v[3],
+                      FrameDef *def, int *status ) {
 /*
 *  Name:
 *     GalVel
@@ -1725,7 +1529,8 @@ static double GalVel( double ra, double dec, FrameDef *def, int *status ) {
 
 *  Synopsis:
 *     #include "specmap.h"
-*     double GalVel( double ra, double dec, FrameDef *def, int *status )
+*     double GalVel( double ra, double dec, double v[3],
+*                    FrameDef *def, int *status )
 
 *  Class Membership:
 *     SpecMap method.
@@ -1740,6 +1545,9 @@ static double GalVel( double ra, double dec, FrameDef *def, int *status ) {
 *        The RA (rads, FK5 J2000) of the source.
 *     dec
 *        The Dec (rads, FK5 J2000) of the source.
+*     v
+*        The Cartesian unit vector (FK5 J2000) towards the source, as
+*        returned by palDcs2c for "ra" and "dec".
 *     def
 *        Pointer to a FrameDef structure which holds the parameters which
 *        define the frame, together with cached intermediate results.
@@ -1772,7 +1580,8 @@ static double GalVel( double ra, double dec, FrameDef *def, int *status ) {
    return -1000.0*( s1 + s2 );
 }
 
-static double GeoVel( double ra, double dec, FrameDef *def, int *status ) {
+static double GeoVel( double ra, double dec, double v[3],
+                      FrameDef *def, int *status ) {
 /*
 *  Name:
 *     GeoVel
@@ -1785,7 +1594,8 @@ static double GeoVel( double ra, double dec, FrameDef *def, int *status ) {
 
 *  Synopsis:
 *     #include "specmap.h"
-*     double GeoVel( double ra, double dec, FrameDef *def, int *status )
+*     double GeoVel( double ra, double dec, double v[3],
+*                    FrameDef *def, int *status )
 
 *  Class Membership:
 *     SpecMap method.
@@ -1800,6 +1610,9 @@ static double GeoVel( double ra, double dec, FrameDef *def, int *status ) {
 *        The RA (rads, FK5 J2000) of the source.
 *     dec
 *        The Dec (rads, FK5 J2000) of the source.
+*     v
+*        The Cartesian unit vector (FK5 J2000) towards the source, as
+*        returned by palDcs2c for "ra" and "dec".
 *     def
 *        Pointer to a FrameDef structure which holds the parameters which
 *        define the frame, together with cached intermediate results.
@@ -1813,27 +1626,12 @@ static double GeoVel( double ra, double dec, FrameDef *def, int *status ) {
 
 */
 
-/* Local Variables: */
-   double dpb[ 3 ];          /* Barycentric earth position vector */
-   double dph[ 3 ];          /* Heliocentric earth position vector */
-   double dvb[ 3 ];          /* Barycentric earth velocity vector */
-   double v[ 3 ];            /* Source direction vector */
-
 /* Check the global error status. */
    if ( !astOK ) return 0.0;
 
-/* Get the Cartesian vector towards the source, in the Cartesian FK5
-   J2000 system. */
-   palDcs2c( ra, dec, v );
-
-/* If not already done so, get the Earth/Sun velocity and position vectors in
-   the same system. Speed is returned in units of AU/s. Store in the supplied
-   frame definition structure. */
-   if( def->dvh[ 0 ] == AST__BAD ) palEvp( def->epoch, 2000.0, dvb, dpb,
-                                           def->dvh, dph );
-
 /* Return the component away from the source, of the velocity of the earths
-   centre relative to the sun (in m/s). */
+   centre relative to the sun (in m/s). The Earth/Sun velocity (in AU/s) is
+   found by SetFrameDef. */
    return -palDvdv( v, def->dvh )*149.597870E9;
 }
 
@@ -1935,7 +1733,8 @@ void astInitSpecMapVtab_(  AstSpecMapVtab *vtab, const char *name, int *status )
    }
 }
 
-static double LgVel( double ra, double dec, FrameDef *def, int *status ) {
+static double LgVel( double ra, double dec, double v[3],
+                     FrameDef *def, int *status ) {
 /*
 *  Name:
 *     LgVel
@@ -1948,7 +1747,8 @@ static double LgVel( double ra, double dec, FrameDef *def, int *status ) {
 
 *  Synopsis:
 *     #include "specmap.h"
-*     double LgVel( double ra, double dec, FrameDef *def, int *status )
+*     double LgVel( double ra, double dec, double v[3],
+*                   FrameDef *def, int *status )
 
 *  Class Membership:
 *     SpecMap method.
@@ -1962,6 +1762,9 @@ static double LgVel( double ra, double dec, FrameDef *def, int *status ) {
 *        The RA (rads, FK5 J2000) of the source.
 *     dec
 *        The Dec (rads, FK5 J2000) of the source.
+*     v
+*        The Cartesian unit vector (FK5 J2000) towards the source, as
+*        returned by palDcs2c for "ra" and "dec".
 *     def
 *        Pointer to a FrameDef structure which holds the parameters which
 *        define the frame, together with cached intermediate results.
@@ -1980,7 +1783,8 @@ static double LgVel( double ra, double dec, FrameDef *def, int *status ) {
    return -1000.0*palRvlg( (float) ra, (float) dec );
 }
 
-static double LsrdVel( double ra, double dec, FrameDef *def, int *status ) {
+static double LsrdVel( double ra, double dec, double v[3],
+                       FrameDef *def, int *status ) {
 /*
 *  Name:
 *     LsrdVel
@@ -1993,7 +1797,8 @@ static double LsrdVel( double ra, double dec, FrameDef *def, int *status ) {
 
 *  Synopsis:
 *     #include "specmap.h"
-*     double LsrdVel( double ra, double dec, FrameDef *def, int *status )
+*     double LsrdVel( double ra, double dec, double v[3],
+*                     FrameDef *def, int *status )
 
 *  Class Membership:
 *     SpecMap method.
@@ -2008,6 +1813,9 @@ static double LsrdVel( double ra, double dec, FrameDef *def, int *status ) {
 *        The RA (rads, FK5 J2000) of the source.
 *     dec
 *        The Dec (rads, FK5 J2000) of the source.
+*     v
+*        The Cartesian unit vector (FK5 J2000) towards the source, as
+*        returned by palDcs2c for "ra" and "dec".
 *     def
 *        Pointer to a FrameDef structure which holds the parameters which
 *        define the frame, together with cached intermediate results.
@@ -2030,7 +1838,8 @@ static double LsrdVel( double ra, double dec, FrameDef *def, int *status ) {
    return -1000.0*palRvlsrd( (float) ra, (float) dec );
 }
 
-static double LsrkVel( double ra, double dec, FrameDef *def, int *status ) {
+static double LsrkVel( double ra, double dec, double v[3],
+                       FrameDef *def, int *status ) {
 /*
 *  Name:
 *     LsrkVel
@@ -2043,7 +1852,8 @@ static double LsrkVel( double ra, double dec, FrameDef *def, int *status ) {
 
 *  Synopsis:
 *     #include "specmap.h"
-*     double LsrkVel( double ra, double dec, FrameDef *def, int *status )
+*     double LsrkVel( double ra, double dec, double v[3],
+*                     FrameDef *def, int *status )
 
 *  Class Membership:
 *     SpecMap method.
@@ -2058,6 +1868,9 @@ static double LsrkVel( double ra, double dec, FrameDef *def, int *status ) {
 *        The RA (rads, FK5 J2000) of the source.
 *     dec
 *        The Dec (rads, FK5 J2000) of the source.
+*     v
+*        The Cartesian unit vector (FK5 J2000) towards the source, as
+*        returned by palDcs2c for "ra" and "dec".
 *     def
 *        Pointer to a FrameDef structure which holds the parameters which
 *        define the frame, together with cached intermediate results.
@@ -2776,70 +2589,314 @@ static double Refrac( double wavelen, int *status ){
    return 1.0 + 1.0E-6*( 287.6155 + 1.62887*w2 + 0.01360*w2*w2 );
 }
 
-static double Rverot( double phi, double h, double ra, double da,
-                      double st, int *status ) {
+static int SetFrameDef( int cvt_code, double *args, int map3d,
+                        FrameDef *def, int *status ){
 /*
 *  Name:
-*     Rverot
+*     SetFrameDef
 
 *  Purpose:
-*     Find the velocity component in a given direction due to Earth rotation.
+*     Initialise a FrameDef structure for a change of reference frame.
 
 *  Type:
 *     Private function.
 
 *  Synopsis:
 *     #include "specmap.h"
-*     double Rverot( double phi, double h, double ra, double da,
-*                    double st, int *status )
+*     int SetFrameDef( int cvt_code, double *args, int map3d,
+*                      FrameDef *def, int *status )
 
 *  Class Membership:
 *     SpecMap method.
 
 *  Description:
-*     This function is like slaRverot, except that it takes account of the
-*     observers height (h), and does all calculations in double precision.
+*     This function stores the parameters that define a change of the
+*     observers rest-frame in the supplied FrameDef structure. It also
+*     finds all the quantities needed by the change that depend on the
+*     epoch and observer position, but not on the source position (e.g.
+*     the velocity of the earth, the mean to apparent parameters and the
+*     velocity of the observer). These are then re-used for every point
+*     transformed by FrameChange.
 
 *  Parameters:
-*     phi
-*        The geodetic latitude of the observer (radians, IAU 1976).
-*     h
-*        The geodetic height above the reference spheroid of the observer
-*        (metres, IAU 1976).
-*     ra
-*        The geocentric apparent RA (rads) of the source.
-*     da
-*        The geocentric apparent Dec (rads) of the source.
-*     st
-*        The local apparent sidereal time (radians).
+*     cvt_code
+*        A code indicating the conversion to be applied. If the code does
+*        not correspond to a change of rest-frame, then zero is returned as
+*        the function value.
+*     args
+*        Pointer to an array holding the conversion arguments. The number
+*        of arguments expected depends on the particular conversion being
+*        used. If "map3d" is zero, the frequency correction factor is
+*        calculated and stored in the element following the user-supplied
+*        arguments, if this has not already been done.
+*     map3d
+*        Should be non-zero if each frequency transformed by FrameChange
+*        will have its own source position. If zero, the epoch and
+*        observer dependent quantities are found only if they are needed
+*        to calculate the frequency correction factor.
+*     def
+*        Pointer to the FrameDef structure to be initialised.
 *     status
 *        Pointer to the inherited status variable.
 
-*  Returns:
-*     The component of the Earth rotation in direction [RA,DA] (km/s).
-*     The result is positive when the observer is receding from the
-*     given point on the sky. Zero is returned if an error has already
-*     occurred.
+*  Returned Value:
+*     Non-zero if the supplied conversion code corresponds to a change of
+*     reference frame. Zero otherwise.
+
+*  Notes:
+*     - The "args" array contains RA and DEC values which give the "source"
+*     position (FK5 J2000). If "map3d" is zero, then these args define the
+*     position of all the frequency values. In addition they also define
+*     the direction of motion of the "user-defined" rest-frame (see
+*     "veluser"). Thus they should still be supplied even if "map3d" is
+*     non-zero.
 
 */
 
 /* Local Variables: */
-   double pv[ 6 ];           /* Observer position and velocity */
-   double v[ 3 ];            /* Source direction vector */
+   double dpb[ 3 ];   /* Barycentric earth position vector */
+   double dph[ 3 ];   /* Heliocentric earth position vector */
+   double dvb[ 3 ];   /* Barycentric earth velocity vector */
+   double dvh[ 3 ];   /* Heliocentric earth velocity vector */
+   double s;          /* Velocity correction (m/s) */
+   double v[ 3 ];     /* Source direction vector */
+   int result;        /* Returned value */
 
-/* Check the global error status. */
-   if ( !astOK ) return 0.0;
+/* Check inherited status. */
+   if( !astOK ) return 0;
 
-/* Get the Cartesian coordinates of the unit vector pointing towards the
-   given sky position. */
-   palDcs2c( ra, da, v );
+/* Set the return value to indicate that the supplied conversion code
+   represents a change of rest-frame. */
+   result = 1;
 
-/* Get velocity and position of the observer. */
-   palPvobs( phi, h, st, pv );
+/* Initialise the structure. */
+   def->obsalt = AST__BAD;
+   def->obslat = AST__BAD;
+   def->obslon = AST__BAD;
+   def->epoch = AST__BAD;
+   def->refdec = AST__BAD;
+   def->refra = AST__BAD;
+   def->veluser = AST__BAD;
+   def->last = AST__BAD;
+   def->amprms[ 0 ] = AST__BAD;
+   def->vuser[ 0 ] = AST__BAD;
+   def->dvh[ 0 ] = AST__BAD;
+   def->dvb[ 0 ] = AST__BAD;
+   def->pvobs[ 0 ] = AST__BAD;
+   def->factor = AST__BAD;
+   def->fcorr = NULL;
+   def->sign = 0;
+   def->velfunc = NULL;
 
-/* Return the component of the observer's velocity away from the sky
-   position, and convert from AU/s to km/s. */
-   return -palDvdv( v, pv + 3 )*149.597870E6;
+/* Test for each rest-frame code value in turn and assign the appropriate
+   values. */
+   switch ( cvt_code ) {
+
+   case AST__USF2HL:
+      def->velfunc = UserVel;
+      def->veluser = args[ 0 ];
+      def->refra = args[ 1 ];
+      def->refdec = args[ 2 ];
+      def->fcorr = args + 3;
+      def->sign = -1;
+      break;
+
+   case AST__HLF2US:
+      def->velfunc = UserVel;
+      def->veluser = args[ 0 ];
+      def->refra = args[ 1 ];
+      def->refdec = args[ 2 ];
+      def->fcorr = args + 3;
+      def->sign = +1;
+      break;
+
+   case AST__TPF2HL:
+      def->velfunc = TopoVel;
+      def->obslon = args[ 0 ];
+      def->obslat = args[ 1 ];
+      def->obsalt = args[ 2 ];
+      def->epoch = args[ 3 ];
+      def->refra = args[ 4 ];
+      def->refdec = args[ 5 ];
+      def->fcorr = args + 6;
+      def->sign = -1;
+      break;
+
+   case AST__HLF2TP:
+      def->velfunc = TopoVel;
+      def->obslon = args[ 0 ];
+      def->obslat = args[ 1 ];
+      def->obsalt = args[ 2 ];
+      def->epoch = args[ 3 ];
+      def->refra = args[ 4 ];
+      def->refdec = args[ 5 ];
+      def->fcorr = args + 6;
+      def->sign = +1;
+      break;
+
+   case AST__GEF2HL:
+      def->velfunc = GeoVel;
+      def->epoch = args[ 0 ];
+      def->refra = args[ 1 ];
+      def->refdec = args[ 2 ];
+      def->fcorr = args + 3;
+      def->sign = -1;
+      break;
+
+   case AST__HLF2GE:
+      def->velfunc = GeoVel;
+      def->epoch = args[ 0 ];
+      def->refra = args[ 1 ];
+      def->refdec = args[ 2 ];
+      def->fcorr = args + 3;
+      def->sign = +1;
+      break;
+
+   case AST__BYF2HL:
+      def->velfunc = BaryVel;
+      def->epoch = args[ 0 ];
+      def->refra = args[ 1 ];
+      def->refdec = args[ 2 ];
+      def->fcorr = args + 3;
+      def->sign = -1;
+      break;
+
+   case AST__HLF2BY:
+      def->velfunc = BaryVel;
+      def->epoch = args[ 0 ];
+      def->refra = args[ 1 ];
+      def->refdec = args[ 2 ];
+      def->fcorr = args + 3;
+      def->sign = +1;
+      break;
+
+   case AST__LKF2HL:
+      def->velfunc = LsrkVel;
+      def->refra = args[ 0 ];
+      def->refdec = args[ 1 ];
+      def->fcorr = args + 2;
+      def->sign = -1;
+      break;
+
+   case AST__HLF2LK:
+      def->velfunc = LsrkVel;
+      def->refra = args[ 0 ];
+      def->refdec = args[ 1 ];
+      def->fcorr = args + 2;
+      def->sign = +1;
+      break;
+
+   case AST__LDF2HL:
+      def->velfunc = LsrdVel;
+      def->refra = args[ 0 ];
+      def->refdec = args[ 1 ];
+      def->fcorr = args + 2;
+      def->sign = -1;
+      break;
+
+   case AST__HLF2LD:
+      def->velfunc = LsrdVel;
+      def->refra = args[ 0 ];
+      def->refdec = args[ 1 ];
+      def->fcorr = args + 2;
+      def->sign = +1;
+      break;
+
+   case AST__LGF2HL:
+      def->velfunc = LgVel;
+      def->refra = args[ 0 ];
+      def->refdec = args[ 1 ];
+      def->fcorr = args + 2;
+      def->sign = -1;
+      break;
+
+   case AST__HLF2LG:
+      def->velfunc = LgVel;
+      def->refra = args[ 0 ];
+      def->refdec = args[ 1 ];
+      def->fcorr = args + 2;
+      def->sign = +1;
+      break;
+
+   case AST__GLF2HL:
+      def->velfunc = GalVel;
+      def->refra = args[ 0 ];
+      def->refdec = args[ 1 ];
+      def->fcorr = args + 2;
+      def->sign = -1;
+      break;
+
+   case AST__HLF2GL:
+      def->velfunc = GalVel;
+      def->refra = args[ 0 ];
+      def->refdec = args[ 1 ];
+      def->fcorr = args + 2;
+      def->sign = +1;
+      break;
+
+/* If the supplied code does not represent a change of rest-frame, clear
+   the returned flag. */
+   default:
+      result = 0;
+   }
+
+/* The remaining quantities are only needed if the frequency correction
+   factor is to be found for each point, or if the factor for the single
+   source position has not yet been found. */
+   if( result && ( map3d || *(def->fcorr) == AST__BAD ) ) {
+
+/* Express the user velocity in the form of a J2000.0 x,y,z vector. */
+      if( def->velfunc == UserVel ) {
+         def->vuser[ 0 ] = def->veluser*cos( def->refra )*cos( def->refdec );
+         def->vuser[ 1 ] = def->veluser*sin( def->refra )*cos( def->refdec );
+         def->vuser[ 2 ] = def->veluser*sin( def->refdec );
+
+/* Get the Earth/Sun velocity vector in the Cartesian FK5 J2000 system.
+   Speed is returned in units of AU/s. */
+      } else if( def->velfunc == GeoVel || def->velfunc == TopoVel ) {
+         palEvp( def->epoch, 2000.0, dvb, dpb, def->dvh, dph );
+
+/* For topocentric frames, also get the parameters defining the
+   transformation of mean ra and dec to apparent ra and dec, the local
+   apparent siderial time (in radians), and the position and velocity of
+   the observer relative to the centre of the earth. */
+         if( def->velfunc == TopoVel ) {
+            palMappa( 2000.0, def->epoch, def->amprms );
+            def->last = palGmst( def->epoch ) + palEqeqx( def->epoch ) +
+                        def->obslon;
+            palPvobs( def->obslat, def->obsalt, def->last, def->pvobs );
+         }
+
+/* Get the Earth/Sun and Earth/barycentre velocity vectors, and change the
+   barycentric velocity of the earth into the heliocentric velocity of the
+   barycentre. */
+      } else if( def->velfunc == BaryVel ) {
+         palEvp( def->epoch, 2000.0, def->dvb, dpb, dvh, dph );
+         def->dvb[ 0 ] = dvh[ 0 ] - def->dvb[ 0 ];
+         def->dvb[ 1 ] = dvh[ 1 ] - def->dvb[ 1 ];
+         def->dvb[ 2 ] = dvh[ 2 ] - def->dvb[ 2 ];
+      }
+
+/* If all frequencies are at the single source position, find the
+   frequency correction factor and store it in the arguments array so that
+   it can be re-used on subsequent calls. Get the velocity correction. This
+   is the component of the velocity of the output system, away from the
+   source, as measured in the input system. */
+      if( !map3d ) {
+         palDcs2c( def->refra, def->refdec, v );
+         s = def->sign*def->velfunc( def->refra, def->refdec, v, def, status );
+
+/* Find the factor by which to correct supplied frequencies. If the
+   velocity correction is positive, the output frequency wil be lower than
+   the input frequency. */
+         if( s < AST__C && s > -AST__C ) {
+            *(def->fcorr) = sqrt( ( AST__C - s )/( AST__C + s ) );
+         }
+      }
+   }
+
+/* Return the result. */
+   return result;
 }
 
 static void SpecAdd( AstSpecMap *this, const char *cvt, int narg,
@@ -3509,7 +3566,8 @@ static int SystemChange( int cvt_code, int np, double *values, double *args,
    return result;
 }
 
-static double TopoVel( double ra, double dec, FrameDef *def, int *status ) {
+static double TopoVel( double ra, double dec, double v[3],
+                       FrameDef *def, int *status ) {
 /*
 *  Name:
 *     TopoVel
@@ -3522,7 +3580,8 @@ static double TopoVel( double ra, double dec, FrameDef *def, int *status ) {
 
 *  Synopsis:
 *     #include "specmap.h"
-*     double TopoVel( double ra, double dec, FrameDef *def, int *status )
+*     double TopoVel( double ra, double dec, double v[3],
+*                     FrameDef *def, int *status )
 
 *  Class Membership:
 *     SpecMap method.
@@ -3537,6 +3596,9 @@ static double TopoVel( double ra, double dec, FrameDef *def, int *status ) {
 *        The RA (rads, FK5 J2000) of the source.
 *     dec
 *        The Dec (rads, FK5 J2000) of the source.
+*     v
+*        The Cartesian unit vector (FK5 J2000) towards the source, as
+*        returned by palDcs2c for "ra" and "dec".
 *     def
 *        Pointer to a FrameDef structure which holds the parameters which
 *        define the frame, together with cached intermediate results.
@@ -3553,35 +3615,28 @@ static double TopoVel( double ra, double dec, FrameDef *def, int *status ) {
 /* Local Variables: */
    double deca;              /* Apparent DEC */
    double raa;               /* Apparent RA */
+   double va[ 3 ];           /* Apparent source direction vector */
    double vobs;              /* Velocity of observer relative to earth */
    double vearth;            /* Velocity of earth realtive to sun */
 
 /* Check the global error status. */
    if ( !astOK ) return 0.0;
 
-/* If not already done so, get the parameters defining the transformation
-   of mean ra and dec to apparent ra and dec, and store in the supplied frame
-   definition structure. */
-   if( def->amprms[ 0 ] == AST__BAD ) palMappa( 2000.0, def->epoch,
-                                                def->amprms );
-
-/* Convert the source position from mean ra and dec to apparent ra and dec. */
+/* Convert the source position from mean ra and dec to apparent ra and dec,
+   using the mean to apparent parameters found by SetFrameDef, and get the
+   Cartesian unit vector towards the apparent position. */
    palMapqkz( ra, dec, def->amprms, &raa, &deca );
-
-/* If not already done so, get the local apparent siderial time (in radians)
-   and store in the supplied frame definition structure. */
-   if( def->last == AST__BAD ) def->last = palGmst( def->epoch ) +
-                                           palEqeqx( def->epoch ) +
-                                           def->obslon;
+   palDcs2c( raa, deca, va );
 
 /* Get the component away from the source, of the velocity of the observer
-   relative to the centre of the earth (in m/s). */
-   vobs = 1000.0*Rverot( def->obslat, def->obsalt, raa, deca, def->last,
-                         status );
+   relative to the centre of the earth. The observer's velocity (in AU/s)
+   depends only on the observer's position and the local apparent sidereal
+   time, and so is found once by SetFrameDef. Convert from AU/s to m/s. */
+   vobs = 1000.0*( -palDvdv( va, def->pvobs + 3 )*149.597870E6 );
 
 /* Get the component away from the source, of the velocity of the earth's
    centre relative to the Sun, in m/s. */
-   vearth = GeoVel( ra, dec, def, status );
+   vearth = GeoVel( ra, dec, v, def, status );
 
 /* Return the total velocity of the observer away from the source in the
    frame of the sun. */
@@ -3647,6 +3702,7 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
 /* Local Variables: */
    AstPointSet *result;          /* Pointer to output PointSet */
    AstSpecMap *map;              /* Pointer to SpecMap to be applied */
+   FrameDef *defs;               /* Definitions of rest-frame changes */
    double **ptr_in;              /* Pointer to input coordinate data */
    double **ptr_out;             /* Pointer to output coordinate data */
    double *spec;                 /* Pointer to output spectral axis value array */
@@ -3658,6 +3714,7 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
    int map3d;                    /* Is the SpecMap 3-dimensional? */
    int ncoord_in;                /* Number of coordinates per input point */
    int npoint;                   /* Number of points */
+   int nstep;                    /* Number of consecutive rest-frame changes */
    int start;                    /* Starting index for conversion loop */
 
 /* Check the global error status. */
@@ -3721,19 +3778,42 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
       end = forward ? map->ncvt : -1;
       inc = forward ? 1 : -1;
 
+/* Allocate workspace to hold the definitions of a sequence of consecutive
+   changes of rest-frame. */
+      defs = astMalloc( sizeof( FrameDef )*(size_t) ( map->ncvt ? map->ncvt : 1 ) );
+
 /* Loop through the coordinate conversions in the required order. */
-      for ( cvt = start; cvt != end; cvt += inc ) {
+      cvt = start;
+      while( cvt != end && astOK ) {
+
+/* Set up each conversion in the run of consecutive changes of rest-frame
+   (if any) that starts at the current conversion. This finds all the
+   quantities that do not depend on the source position once, before
+   any points are transformed. */
+         nstep = 0;
+         while( cvt != end && SetFrameDef( map->cvttype[ cvt ],
+                                           map->cvtargs[ cvt ], map3d,
+                                           defs + nstep, status ) ) {
+            nstep++;
+            cvt += inc;
+         }
 
-/* Process conversions which correspond to changes of reference frames. */
-         if( !FrameChange( map->cvttype[ cvt ], npoint, alpha, beta, spec,
-                          map->cvtargs[ cvt ], forward, status ) ) {
+/* If the run is not empty, apply all the changes of rest-frame in it in a
+   single pass through the points. */
+         if( nstep > 0 ) {
+            FrameChange( nstep, defs, npoint, alpha, beta, spec, forward,
+                         status );
 
-/* If this conversion was not a change of reference frame, it must be a
-   change of system. */
+/* Otherwise, the conversion must be a change of system. */
+         } else {
             SystemChange( map->cvttype[ cvt ], npoint, spec,
                           map->cvtargs[ cvt ], forward, status );
+            cvt += inc;
          }
       }
+
+/* Free the workspace. */
+      defs = astFree( defs );
    }
 
 /* If an error has occurred and a new PointSet may have been created, then
@@ -3749,7 +3829,8 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
 
 }
 
-static double UserVel( double ra, double dec, FrameDef *def, int *status ) {
+static double UserVel( double ra, double dec, double v[3],
+                       FrameDef *def, int *status ) {
 /*
 *  Name:
 *     UserVel
@@ -3763,7 +3844,8 @@ static double UserVel( double ra, double dec, FrameDef *def, int *status ) {
 
 *  Synopsis:
 *     #include "specmap.h"
-*     double UserVel( double ra, double dec, FrameDef *def, int *status )
+*     double UserVel( double ra, double dec, double v[3],
+*                     FrameDef *def, int *status )
 
 *  Class Membership:
 *     SpecMap method.
@@ -3780,6 +3862,9 @@ static double UserVel( double ra, double dec, FrameDef *def, int *status ) {
 *        The RA (rads, FK5 J2000) of the source.
 *     dec
 *        The Dec (rads, FK5 J2000) of the source.
+*     v
+*        The Cartesian unit vector (FK5 J2000) towards the source, as
+*        returned by palDcs2c for "ra" and "dec".
 *     def
 *        Pointer to a FrameDef structure which holds the parameters which
 *        define the frame, together with cached intermediate results.
@@ -3800,27 +3885,14 @@ static double UserVel( double ra, double dec, FrameDef *def, int *status ) {
 
 */
 
-/* Local Variables: */
-   double vb[ 3 ];          /* Source position vector */
-
 /* Check the global error status. */
    if ( !astOK ) return 0.0;
 
-/* If not already done so, express the user velocity in the form of a
-   J2000.0 x,y,z vector. */
-   if( def->vuser[ 0 ] == AST__BAD ) {
-      def->vuser[ 0 ] = def->veluser*cos( def->refra )*cos( def->refdec );
-      def->vuser[ 1 ] = def->veluser*sin( def->refra )*cos( def->refdec );
-      def->vuser[ 2 ] = def->veluser*sin( def->refdec );
-   }
-
-/* Convert given J2000 RA,Dec to x,y,z. */
-   palDcs2c( ra, dec, vb );
-
-/* Return the dot product with the user velocity. Invert it to get the
+/* Return the dot product of the source vector with the user velocity
+   (expressed as a J2000 x,y,z vector by SetFrameDef). Invert it to get the
    velocity towards the observer (the def->veluser value is supposed to be
    positive if the source is moving away from the observer). */
-   return -palDvdv( def->vuser, vb );
+   return -palDvdv( def->vuser, v );
 }
 
 /* Copy constructor. */
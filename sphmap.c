@@ -137,6 +137,7 @@ static int class_check;
 
 /* Pointers to parent class methods which are extended by this class. */
 static AstPointSet *(* parent_transform)( AstMapping *, AstPointSet *, int, AstPointSet *, int * );
+static double (* parent_rate)( AstMapping *, double *, int, int, int * );
 static const char *(* parent_getattrib)( AstObject *, const char *, int * );
 static int (* parent_testattrib)( AstObject *, const char *, int * );
 static void (* parent_clearattrib)( AstObject *, const char *, int * );
@@ -194,6 +195,8 @@ static void ClearPolarLong( AstSphMap *, int * );
 static void SetPolarLong( AstSphMap *, double, int * );
 
 static AstPointSet *Transform( AstMapping *, AstPointSet *, int, AstPointSet *, int * );
+static double Rate( AstMapping *, double *, int, int, int * );
+static int RateIsExact( AstMapping *, int * );
 static const char *GetAttrib( AstObject *, const char *, int * );
 static int Equal( AstObject *, AstObject *, int * );
 static int MapMerge( AstMapping *, int, int, int *, AstMapping ***, int **, int * );
@@ -552,6 +555,10 @@ void astInitSphMapVtab_(  AstSphMapVtab *vtab, const char *name, int *status ) {
    parent_transform = mapping->Transform;
    mapping->Transform = Transform;
 
+   parent_rate = mapping->Rate;
+   mapping->Rate = Rate;
+   mapping->RateIsExact = RateIsExact;
+
 /* Store replacement pointers for methods which will be over-ridden by
    new member functions implemented here. */
    object->Equal = Equal;
@@ -956,6 +963,180 @@ static int MapMerge( AstMapping *this, int where, int series, int *nmap,
    return result;
 }
 
+static double Rate( AstMapping *this, double *at, int ax1, int ax2, int *status ){
+/*
+*  Name:
+*     Rate
+
+*  Purpose:
+*     Calculate the rate of change of a Mapping output.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "sphmap.h"
+*     result = Rate( AstMapping *this, double *at, int ax1, int ax2, int *status )
+
+*  Class Membership:
+*     SphMap member function (overrides the astRate method inherited
+*     from the Mapping class ).
+
+*  Description:
+*     This function returns the rate of change of a specified output of
+*     the supplied Mapping with respect to a specified input, at a
+*     specified input position. The rate is found analytically, except
+*     at the poles of the spherical coordinate system where the longitude
+*     is not a continuous function of the Cartesian coordinates. The
+*     numerical estimate provided by the parent class is returned in that
+*     case.
+
+*  Parameters:
+*     this
+*        Pointer to the Mapping to be applied.
+*     at
+*        The address of an array holding the axis values at the position
+*        at which the rate of change is to be evaluated. The number of
+*        elements in this array should equal the number of inputs to the
+*        Mapping.
+*     ax1
+*        The index of the Mapping output for which the rate of change is to
+*        be found (output numbering starts at 0 for the first output).
+*     ax2
+*        The index of the Mapping input which is to be varied in order to
+*        find the rate of change (input numbering starts at 0 for the first
+*        input).
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The rate of change of Mapping output "ax1" with respect to input
+*     "ax2", evaluated at "at", or AST__BAD if the value cannot be
+*     calculated.
+
+*/
+
+/* Local Variables: */
+   double cosa;
+   double cosb;
+   double mxerr;
+   double r2;
+   double result;
+   double rxy;
+   double rxy2;
+   double sina;
+   double sinb;
+
+/* Check inherited status */
+   if( !astOK ) return AST__BAD;
+
+/* Initialise. */
+   result = AST__BAD;
+
+/* First deal with the forward mapping from Cartesian (x,y,z) to Spherical
+   (longitude,latitude). Return a bad value if any input is bad. */
+   if( !astGetInvert( this ) ) {
+      if( at[ 0 ] != AST__BAD && at[ 1 ] != AST__BAD && at[ 2 ] != AST__BAD ) {
+
+/* Use the numerical estimate at either pole (see Transform). */
+         mxerr = fabs( 1000.0*at[ 2 ] )*DBL_EPSILON;
+         if( fabs( at[ 0 ] ) < mxerr && fabs( at[ 1 ] ) < mxerr ) {
+            result = (*parent_rate)( this, at, ax1, ax2, status );
+
+/* Otherwise, differentiate "longitude = atan2( y, x )" and
+   "latitude = atan2( z, sqrt( x*x + y*y ) )". */
+         } else {
+            rxy2 = at[ 0 ]*at[ 0 ] + at[ 1 ]*at[ 1 ];
+            if( ax1 == 0 ) {
+               if( ax2 == 0 ) {
+                  result = -at[ 1 ]/rxy2;
+               } else if( ax2 == 1 ) {
+                  result = at[ 0 ]/rxy2;
+               } else {
+                  result = 0.0;
+               }
+            } else {
+               rxy = sqrt( rxy2 );
+               r2 = rxy2 + at[ 2 ]*at[ 2 ];
+               if( ax2 == 2 ) {
+                  result = rxy/r2;
+               } else {
+                  result = -at[ ax2 ]*at[ 2 ]/( r2*rxy );
+               }
+            }
+         }
+      }
+
+/* Now deal with the inverse mapping from Spherical (longitude,latitude)
+   to a Cartesian unit vector (x,y,z). */
+   } else if( at[ 0 ] != AST__BAD && at[ 1 ] != AST__BAD ) {
+      sina = sin( at[ 0 ] );
+      cosa = cos( at[ 0 ] );
+      sinb = sin( at[ 1 ] );
+      cosb = cos( at[ 1 ] );
+
+/* x = cos(lat)*cos(lon) */
+      if( ax1 == 0 ) {
+         result = ( ax2 == 0 ) ? -cosb*sina : -sinb*cosa;
+
+/* y = cos(lat)*sin(lon) */
+      } else if( ax1 == 1 ) {
+         result = ( ax2 == 0 ) ? cosb*cosa : -sinb*sina;
+
+/* z = sin(lat) */
+      } else {
+         result = ( ax2 == 0 ) ? 0.0 : cosb;
+      }
+   }
+
+/* Return the result. */
+   return result;
+}
+
+static int RateIsExact( AstMapping *this, int *status ) {
+/*
+*  Name:
+*     RateIsExact
+
+*  Purpose:
+*     Check if the astRate method of a Mapping is exact.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "sphmap.h"
+*     int RateIsExact( AstMapping *this, int *status )
+
+*  Class Membership:
+*     SphMap member function (over-rides the protected astRateIsExact
+*     method inherited from the Mapping class).
+
+*  Description:
+*     This function returns a flag indicating if the astRate method of
+*     the supplied Mapping evaluates the rate of change analytically.
+*     The rates of change of a SphMap are found analytically, except at
+*     the poles, which are ignored here.
+
+*  Parameters:
+*     this
+*        Pointer to the Mapping.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Non-zero if the astRate method of the supplied Mapping is exact, and
+*     zero otherwise.
+
+*/
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* The rates of change are found analytically away from the poles. */
+   return 1;
+}
+
 static void SetAttrib( AstObject *this_object, const char *setting, int *status ) {
 /*
 *  Name:
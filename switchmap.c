@@ -153,6 +153,23 @@ f     The SwitchMap class does not define any new routines beyond those
 #include <string.h>
 #include <stdio.h>
 
+/* Type definitions. */
+/* ================= */
+
+/* A structure that describes a job that transforms the points that use
+   one route Mapping. The jobs for each route are run in parallel using
+   astRunJobs. */
+typedef struct RouteJob {
+   AstMapping *map;     /* Private copy of the route Mapping */
+   double **in;         /* Pointers to the input axis values */
+   double **out;        /* Pointers to the output axis values */
+   const int *idx;      /* Indices of the points that use the route */
+   int npoint;          /* Number of points that use the route */
+   int ncin;            /* Number of input axes */
+   int ncout;           /* Number of output axes */
+   int forward;         /* Use the forward transformation? */
+} RouteJob;
+
 /* Module Variables. */
 /* ================= */
 
@@ -216,6 +233,7 @@ static void Delete( AstObject *, int * );
 static void Dump( AstObject *, AstChannel *, int * );
 static AstMapping *GetSelector( AstSwitchMap *, int, int *, int * );
 static AstMapping *GetRoute( AstSwitchMap *, double, int *, int * );
+static void TransformRoute( void *, int * );
 
 #if defined(THREAD_SAFE)
 static int ManageLock( AstObject *, int, int, AstObject **, int * );
@@ -1612,6 +1630,10 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
 *     PointSet and transforms the points so as to apply the required Mapping.
 *     This implies applying each of the SwitchMap's component Mappings in turn,
 *     either in series or in parallel.
+*
+*     If astRunJobs can use more than one thread, and there are enough
+*     points, the points that use each route Mapping are transformed by a
+*     separate job using a private copy of the route Mapping.
 
 *  Parameters:
 *     this
@@ -1642,24 +1664,33 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
 *     result. Any excess space will be ignored.
 */
 
+/* Local Constants: */
+#define MINPOINT 10000        /* Min. no. of points for parallel routes */
+
 /* Local Variables: */
    AstMapping *rmap;
    AstMapping *selmap;
    AstPointSet *ps1;
-   AstPointSet *ps1a;
    AstPointSet *ps2;
-   AstPointSet *ps2a;
    AstPointSet *result;
    AstPointSet *selps;
    AstSwitchMap *map;
+   RouteJob *jobs;
    double **in_ptr;
    double **out_ptr;
    double **ptr1;
    double **ptr2;
    double **sel_ptr;
+   double *inv;
    double *outv;
    double *sel;
+   int *idx;
+   int *order;
    int *popmap;
+   int *pstart;
+   int *rlist;
+   int *rpoint;
+   int i;
    int iroute;
    int ipoint;
    int j;
@@ -1669,6 +1700,9 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
    int ncout;
    int npoint;
    int nroute;
+   int nthread;
+   int nused;
+   int pop;
    int rindex;
    int rinv;
    int selinv;
@@ -1715,30 +1749,69 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
    out_ptr = astGetPoints( result );
    npoint = astGetNpoint( result );
 
-/* We now count how many positions are to be tranformed by each of the
-   route Mappings. */
+/* Allocate work arrays. "rpoint" holds the index of the route Mapping
+   used by each point (-1 if none), "order" holds the indices of the points
+   sorted into groups that use the same route Mapping, "popmap" holds the
+   number of points using each route Mapping, "pstart" holds the index
+   within "order" of the first point using each route Mapping, and
+   "rlist" holds the indices of the route Mappings that are used. */
    nroute = map->nroute;
    popmap = astMalloc( sizeof( int )*nroute );
+   pstart = astMalloc( sizeof( int )*nroute );
+   rlist = astMalloc( sizeof( int )*nroute );
+   rpoint = astMalloc( sizeof( int )*npoint );
+   order = astMalloc( sizeof( int )*npoint );
    if( astOK ) {
+
+/* Find the route Mapping used by each point, and count how many
+   positions are to be tranformed by each of the route Mappings. This is
+   the only pass through the selector values. */
       for( iroute = 0; iroute < nroute; iroute++ ) popmap[ iroute ] = 0;
 
       sel = sel_ptr[ 0 ];
       for( ipoint = 0; ipoint < npoint; ipoint++,sel++ ) {
+         rindex = -1;
          if( *sel != AST__BAD ) {
             rindex = (int)( *sel + 0.5 ) - 1;
-            if( rindex >= 0 && rindex < nroute ) ( popmap[ rindex ] )++;
+            if( rindex >= 0 && rindex < nroute ) {
+               ( popmap[ rindex ] )++;
+            } else {
+               rindex = -1;
+            }
          }
+         rpoint[ ipoint ] = rindex;
       }
 
-/* Find the number of points transformed by the most popular route Mapping.
-   Also find the total number of points transformed by any route Mapping. */
+/* Find the offset within "order" at which the points for each route
+   Mapping start, the number of points transformed by the most popular
+   route Mapping, and the total number of points transformed by any route
+   Mapping. Also form a list of the route Mappings that are used, sorted
+   into order of decreasing population. */
       totpop = 0;
       maxpop = 0;
+      nused = 0;
       for( iroute = 0; iroute < nroute; iroute++ ) {
-         if( popmap[ iroute ] > maxpop ) maxpop = popmap[ iroute ];
-         totpop += popmap[ iroute ];
+         pstart[ iroute ] = totpop;
+         pop = popmap[ iroute ];
+         if( pop > maxpop ) maxpop = pop;
+         totpop += pop;
+
+         if( pop > 0 ) {
+            for( i = nused; i > 0 && popmap[ rlist[ i - 1 ] ] < pop; i-- ) {
+               rlist[ i ] = rlist[ i - 1 ];
+            }
+            rlist[ i ] = iroute;
+            nused++;
+         }
+      }
+
+/* Partition the point indices into groups that use the same route
+   Mapping, preserving the original order within each group. "pstart" is
+   left holding the offset of the end of each group. */
+      for( ipoint = 0; ipoint < npoint; ipoint++ ) {
+         rindex = rpoint[ ipoint ];
+         if( rindex >= 0 ) order[ ( pstart[ rindex ] )++ ] = ipoint;
       }
-      if( maxpop == 0 ) maxpop = 1;
 
 /* If some of the points are not transformed by any route Mapping.
    Initialise the whole output array to hold AST__BAD at every point. */
@@ -1749,87 +1822,114 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
          }
       }
 
-/* Create a PointSet large enough to hold all the supplied positions
-   which are to be transformed by the most popular route Mapping. */
-      ps1 = astPointSet( maxpop, ncin, "", status );
-      ptr1 = astGetPoints( ps1 );
+/* If astRunJobs can use more than one thread, and more than one route
+   Mapping is used by a worthwhile number of points, transform the points
+   for each route Mapping in a separate job. Each job is given its own
+   copy of the route Mapping, which is unlocked so that it can be locked
+   by the thread that runs the job. Each job writes only the output
+   values for its own points. The jobs are created in order of
+   decreasing population so that the largest jobs are started first. */
+      nthread = ( nused > 1 && totpop >= MINPOINT ) ? astGetNThread() : 1;
+      if( nthread > 1 ) {
+         jobs = astCalloc( nused, sizeof( RouteJob ) );
+         for( i = 0; i < nused && astOK; i++ ) {
+            iroute = rlist[ i ];
+            pop = popmap[ iroute ];
+            rmap = GetRoute( map, (double)( iroute + 1 ), &rinv, status );
+            jobs[ i ].map = astCopy( rmap );
+            astSetInvert( rmap, rinv );
+            astManageLock( jobs[ i ].map, AST__UNLOCK, 1, NULL );
+
+            jobs[ i ].in = in_ptr;
+            jobs[ i ].out = out_ptr;
+            jobs[ i ].idx = order + pstart[ iroute ] - pop;
+            jobs[ i ].npoint = pop;
+            jobs[ i ].ncin = ncin;
+            jobs[ i ].ncout = ncout;
+            jobs[ i ].forward = forward;
+         }
 
-/* Create a PointSet large enough to hold all the output positions
-   created by the most popular route Mapping. */
-      ps2 = astPointSet( maxpop, ncout, "", status );
-      ptr2 = astGetPoints( ps2 );
-      if( astOK ) {
+/* Run the jobs. */
+         astRunJobs( nused, TransformRoute, jobs, sizeof( RouteJob ) );
 
-/* Loop round each route Mapping which is used by at least 1 point. */
-         for( iroute = 0; iroute < nroute; iroute++ ) {
-            if( popmap[ iroute ] >0 ) {
-               rmap = GetRoute( map, (double)( iroute + 1 ), &rinv, status );
-
-/* Construct two PointSets of the correct size to hold the input and
-   output points to be processed with the current route Mapping. We
-   re-use the memory allocated for the largest route Mapping's PointSet. */
-               if( popmap[ iroute ] != maxpop ) {
-                  ps1a = astPointSet( popmap[ iroute ], ncin, "", status );
-                  astSetPoints( ps1a, ptr1 );
-                  ps2a = astPointSet( popmap[ iroute ], ncout, "", status );
-                  astSetPoints( ps2a, ptr2 );
-               } else {
-                  ps1a = astClone( ps1 );
-                  ps2a = astClone( ps2 );
+/* Lock and annul the copies of the route Mappings. */
+         if( jobs ) {
+            for( i = 0; i < nused; i++ ) {
+               if( jobs[ i ].map ) {
+                  astManageLock( jobs[ i ].map, AST__LOCK, 1, NULL );
+                  jobs[ i ].map = astAnnul( jobs[ i ].map );
                }
+            }
+            jobs = astFree( jobs );
+         }
 
-/* Fill the input PointSet with the input positions which are to be
-   transformed using the current route Mapping. */
-               sel = sel_ptr[ 0 ];
-               k = 0;
-               for( ipoint = 0; ipoint < npoint; ipoint++,sel++ ) {
-                  if( *sel != AST__BAD ) {
-                     rindex = (int)( *sel + 0.5 ) - 1;
-                     if( rindex == iroute ) {
-                        for( j = 0; j < ncin; j++ ) {
-                           ptr1[ j ][ k ] = in_ptr[ j ][ ipoint ];
-                        }
-                        k++;
-                     }
-                  }
-               }
+/* Otherwise, if any points are to be transformed, create a pair of
+   PointSets large enough to hold all the input and output positions for the most popular
+   route Mapping. These are re-used for all route Mappings. Since the route
+   Mappings are processed in order of decreasing population, the PointSets
+   only ever need to be shrunk (using astSetNpoint) to fit the next route
+   Mapping. */
+      } else if( nused > 0 ) {
+         ps1 = astPointSet( maxpop, ncin, "", status );
+         ptr1 = astGetPoints( ps1 );
+         ps2 = astPointSet( maxpop, ncout, "", status );
+         ptr2 = astGetPoints( ps2 );
 
-/* Use the route Mapping to transform this PointSet. */
-               (void) astTransform( rmap, ps1a, forward, ps2a );
-
-/* Copy the axis values from the resulting PointSet back into the results
-   array. */
-               sel = sel_ptr[ 0 ];
-               k = 0;
-               for( ipoint = 0; ipoint < npoint; ipoint++,sel++ ) {
-                  if( *sel != AST__BAD ) {
-                     rindex = (int)( *sel + 0.5 ) - 1;
-                     if( rindex == iroute ) {
-                        for( j = 0; j < ncout; j++ ) {
-                           out_ptr[ j ][ ipoint ] = ptr2[ j ][ k ];
-                        }
-                        k++;
-                     }
-                  }
+/* Loop round each route Mapping which is used by at least 1 point. */
+         for( i = 0; i < nused && astOK; i++ ) {
+            iroute = rlist[ i ];
+            pop = popmap[ iroute ];
+            rmap = GetRoute( map, (double)( iroute + 1 ), &rinv, status );
+
+/* Get a pointer to the indices of the points that use this route
+   Mapping. */
+            idx = order + pstart[ iroute ] - pop;
+
+/* Shrink the PointSets if required. */
+            if( pop != astGetNpoint( ps1 ) ) {
+               astSetNpoint( ps1, pop );
+               astSetNpoint( ps2, pop );
+            }
+
+/* Gather the input positions which are to be transformed using the
+   current route Mapping. */
+            if( astOK ) {
+               for( j = 0; j < ncin; j++ ) {
+                  inv = in_ptr[ j ];
+                  outv = ptr1[ j ];
+                  for( k = 0; k < pop; k++ ) outv[ k ] = inv[ idx[ k ] ];
                }
+            }
 
-/* Free resources. */
-               ps1a = astAnnul( ps1a );
-               ps2a = astAnnul( ps2a );
+/* Use the route Mapping to transform them. */
+            (void) astTransform( rmap, ps1, forward, ps2 );
 
-/* Re-instate the Invert flag for the route Mapping. */
-               astSetInvert( rmap, rinv );
+/* Scatter the axis values from the resulting PointSet back into the
+   results array. */
+            if( astOK ) {
+               for( j = 0; j < ncout; j++ ) {
+                  inv = ptr2[ j ];
+                  outv = out_ptr[ j ];
+                  for( k = 0; k < pop; k++ ) outv[ idx[ k ] ] = inv[ k ];
+               }
             }
+
+/* Re-instate the Invert flag for the route Mapping. */
+            astSetInvert( rmap, rinv );
          }
-      }
 
 /* Free resources. */
-      ps1 = astAnnul( ps1 );
-      ps2 = astAnnul( ps2 );
+         ps1 = astAnnul( ps1 );
+         ps2 = astAnnul( ps2 );
+      }
    }
 
    selps = astAnnul( selps );
    popmap = astFree( popmap );
+   pstart = astFree( pstart );
+   rlist = astFree( rlist );
+   rpoint = astFree( rpoint );
+   order = astFree( order );
 
 /* Re-instate the Invert flag of the selector Mapping. */
    astSetInvert( selmap, selinv );
@@ -1843,6 +1943,96 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
 
 /* Return a pointer to the output PointSet. */
    return result;
+
+/* Undefine local constants. */
+#undef MINPOINT
+}
+
+static void TransformRoute( void *data, int *status ) {
+/*
+*  Name:
+*     TransformRoute
+
+*  Purpose:
+*     Transform the points that use one route Mapping.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "switchmap.h"
+*     void TransformRoute( void *data, int *status )
+
+*  Class Membership:
+*     SwitchMap member function
+
+*  Description:
+*     This function is run by astRunJobs to transform the points that use
+*     one route Mapping, for the Transform function. It gathers the input
+*     positions into a new PointSet, transforms them using the route
+*     Mapping, and scatters the results back into the output arrays.
+
+*  Parameters:
+*     data
+*        Pointer to a RouteJob structure describing the job.
+*     status
+*        Pointer to the inherited status variable.
+
+*/
+
+/* Local Variables: */
+   AstPointSet *ps1;             /* Input positions for the route */
+   AstPointSet *ps2;             /* Output positions for the route */
+   RouteJob *job;                /* Pointer to description of job */
+   double **ptr1;                /* Pointers to input axis values */
+   double **ptr2;                /* Pointers to output axis values */
+   double *inv;                  /* Pointer to next input axis value */
+   double *outv;                 /* Pointer to next output axis value */
+   int j;                        /* Axis index */
+   int k;                        /* Point index within the route */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Lock the private copy of the route Mapping for use by this thread. */
+   job = (RouteJob *) data;
+   astManageLock( job->map, AST__LOCK, 1, NULL );
+
+/* Create PointSets to hold the input and output positions for the route
+   Mapping. */
+   ps1 = astPointSet( job->npoint, job->ncin, "", status );
+   ptr1 = astGetPoints( ps1 );
+   ps2 = astPointSet( job->npoint, job->ncout, "", status );
+   ptr2 = astGetPoints( ps2 );
+
+/* Gather the input positions which are to be transformed using the
+   route Mapping. */
+   if( astOK ) {
+      for( j = 0; j < job->ncin; j++ ) {
+         inv = job->in[ j ];
+         outv = ptr1[ j ];
+         for( k = 0; k < job->npoint; k++ ) outv[ k ] = inv[ job->idx[ k ] ];
+      }
+   }
+
+/* Use the route Mapping to transform them. */
+   (void) astTransform( job->map, ps1, job->forward, ps2 );
+
+/* Scatter the axis values from the resulting PointSet back into the
+   results array. */
+   if( astOK ) {
+      for( j = 0; j < job->ncout; j++ ) {
+         inv = ptr2[ j ];
+         outv = job->out[ j ];
+         for( k = 0; k < job->npoint; k++ ) outv[ job->idx[ k ] ] = inv[ k ];
+      }
+   }
+
+/* Free resources, and unlock the route Mapping so that the calling
+   thread can annul it. */
+   ps1 = astAnnul( ps1 );
+   ps2 = astAnnul( ps2 );
+   astManageLock( job->map, AST__UNLOCK, 1, NULL );
 }
 
 /* Copy constructor. */
@@ -164,6 +164,12 @@ f     - AST_TIMEADD: Add a time coordinate conversion to an TimeMap
 #define P0 6.55E-5
 #define TTOFF 32.184
 
+/* The width (in days) of the longest interval within which TDB-TT is
+   found by interpolation, and the minimum number of time values for
+   which interpolation is used (see function AddRcc). */
+#define RCC_SPAN 0.01
+#define RCC_MINRUN 8
+
 /* Include files. */
 /* ============== */
 /* Interface definitions. */
@@ -189,9 +195,22 @@ f     - AST_TIMEADD: Add a time coordinate conversion to an TimeMap
 #include <ctype.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <math.h>
 
+/* Type definitions. */
+/* ================= */
+
+/* A structure describing an entry in the table of TAI-UTC values. */
+typedef struct LeapEntry {
+   double mjd;                   /* UTC MJD at which entry comes into effect */
+   double dat;                   /* TAI-UTC (s) at reference MJD */
+   double refmjd;                /* Reference MJD */
+   double rate;                  /* Rate of change of TAI-UTC (s/day) */
+   double tai;                   /* TAI MJD at which entry comes into effect */
+} LeapEntry;
+
 /* Module Variables. */
 /* ================= */
 
@@ -204,6 +223,71 @@ static int (* parent_getobjsize)( AstObject *, int * );
 static AstPointSet *(* parent_transform)( AstMapping *, AstPointSet *, int, AstPointSet *, int * );
 static double (* parent_rate)( AstMapping *, double *, int, int, int * );
 
+/* The built-in table of TAI-UTC values (see function LeapTable). Each
+   entry holds the UTC MJD at which the entry comes into effect, the
+   TAI-UTC value at a reference MJD, the reference MJD, the rate of change
+   of TAI-UTC (seconds per day), and the TAI at which the entry comes into
+   effect (calculated when the table is first used). The values are from
+   the USNO file "tai-utc.dat", except that the first entry gives the
+   values used before 1961 January 1 (see 2.58.1 (p87) of the 1992
+   Explanatory Supplement). The table must be updated on each occasion
+   that a leap second is announced (latest leap second: 2017 January 1). */
+static LeapEntry default_leap_table[] = {
+   { 36934.0, 1.4178180, 37300.0, 0.001296, 0.0 },  /* 1960 January 1 */
+   { 37300.0, 1.4228180, 37300.0, 0.001296, 0.0 },  /* 1961 January 1 */
+   { 37512.0, 1.3728180, 37300.0, 0.001296, 0.0 },  /* 1961 August 1 */
+   { 37665.0, 1.8458580, 37665.0, 0.0011232, 0.0 }, /* 1962 January 1 */
+   { 38334.0, 1.9458580, 37665.0, 0.0011232, 0.0 }, /* 1963 November 1 */
+   { 38395.0, 3.2401300, 38761.0, 0.001296, 0.0 },  /* 1964 January 1 */
+   { 38486.0, 3.3401300, 38761.0, 0.001296, 0.0 },  /* 1964 April 1 */
+   { 38639.0, 3.4401300, 38761.0, 0.001296, 0.0 },  /* 1964 September 1 */
+   { 38761.0, 3.5401300, 38761.0, 0.001296, 0.0 },  /* 1965 January 1 */
+   { 38820.0, 3.6401300, 38761.0, 0.001296, 0.0 },  /* 1965 March 1 */
+   { 38942.0, 3.7401300, 38761.0, 0.001296, 0.0 },  /* 1965 July 1 */
+   { 39004.0, 3.8401300, 38761.0, 0.001296, 0.0 },  /* 1965 September 1 */
+   { 39126.0, 4.3131700, 39126.0, 0.002592, 0.0 },  /* 1966 January 1 */
+   { 39887.0, 4.2131700, 39126.0, 0.002592, 0.0 },  /* 1968 February 1 */
+   { 41317.0, 10.0, 0.0, 0.0, 0.0 },                /* 1972 January 1 */
+   { 41499.0, 11.0, 0.0, 0.0, 0.0 },                /* 1972 July 1 */
+   { 41683.0, 12.0, 0.0, 0.0, 0.0 },                /* 1973 January 1 */
+   { 42048.0, 13.0, 0.0, 0.0, 0.0 },                /* 1974 January 1 */
+   { 42413.0, 14.0, 0.0, 0.0, 0.0 },                /* 1975 January 1 */
+   { 42778.0, 15.0, 0.0, 0.0, 0.0 },                /* 1976 January 1 */
+   { 43144.0, 16.0, 0.0, 0.0, 0.0 },                /* 1977 January 1 */
+   { 43509.0, 17.0, 0.0, 0.0, 0.0 },                /* 1978 January 1 */
+   { 43874.0, 18.0, 0.0, 0.0, 0.0 },                /* 1979 January 1 */
+   { 44239.0, 19.0, 0.0, 0.0, 0.0 },                /* 1980 January 1 */
+   { 44786.0, 20.0, 0.0, 0.0, 0.0 },                /* 1981 July 1 */
+   { 45151.0, 21.0, 0.0, 0.0, 0.0 },                /* 1982 July 1 */
+   { 45516.0, 22.0, 0.0, 0.0, 0.0 },                /* 1983 July 1 */
+   { 46247.0, 23.0, 0.0, 0.0, 0.0 },                /* 1985 July 1 */
+   { 47161.0, 24.0, 0.0, 0.0, 0.0 },                /* 1988 January 1 */
+   { 47892.0, 25.0, 0.0, 0.0, 0.0 },                /* 1990 January 1 */
+   { 48257.0, 26.0, 0.0, 0.0, 0.0 },                /* 1991 January 1 */
+   { 48804.0, 27.0, 0.0, 0.0, 0.0 },                /* 1992 July 1 */
+   { 49169.0, 28.0, 0.0, 0.0, 0.0 },                /* 1993 July 1 */
+   { 49534.0, 29.0, 0.0, 0.0, 0.0 },                /* 1994 July 1 */
+   { 50083.0, 30.0, 0.0, 0.0, 0.0 },                /* 1996 January 1 */
+   { 50630.0, 31.0, 0.0, 0.0, 0.0 },                /* 1997 July 1 */
+   { 51179.0, 32.0, 0.0, 0.0, 0.0 },                /* 1999 January 1 */
+   { 53736.0, 33.0, 0.0, 0.0, 0.0 },                /* 2006 January 1 */
+   { 54832.0, 34.0, 0.0, 0.0, 0.0 },                /* 2009 January 1 */
+   { 56109.0, 35.0, 0.0, 0.0, 0.0 },                /* 2012 July 1 */
+   { 57204.0, 36.0, 0.0, 0.0, 0.0 },                /* 2015 July 1 */
+   { 57754.0, 37.0, 0.0, 0.0, 0.0 }                 /* 2017 January 1 */
+};
+
+/* The table of TAI-UTC values in use. This is shared by all threads, and
+   is created when first needed. */
+static LeapEntry *leap_table = NULL;
+static int leap_ntable = 0;
+
+/* The error code and message describing any failure to read the file
+   named by AST_LEAP_SECONDS. These are recorded when the table is
+   created so that the error can be reported on every call to LeapTable. */
+static int leap_error = 0;
+static char leap_errmsg[ 300 ];
+
 
 
 #ifdef THREAD_SAFE
@@ -221,6 +305,9 @@ astMAKE_INITGLOBALS(TimeMap)
 
 #include <pthread.h>
 
+static pthread_mutex_t mutex1 = PTHREAD_MUTEX_INITIALIZER;
+#define LOCK_MUTEX1 pthread_mutex_lock( &mutex1 );
+#define UNLOCK_MUTEX1 pthread_mutex_unlock( &mutex1 );
 
 #else
 
@@ -230,6 +317,9 @@ astMAKE_INITGLOBALS(TimeMap)
 static AstTimeMapVtab class_vtab;   /* Virtual function table */
 static int class_init = 0;       /* Virtual function table initialised? */
 
+#define LOCK_MUTEX1
+#define UNLOCK_MUTEX1
+
 #endif
 
 /* External Interface Function Prototypes. */
@@ -243,6 +333,9 @@ AstTimeMap *astTimeMapId_( int, const char *, ... );
 /* ======================================== */
 static AstPointSet *Transform( AstMapping *, AstPointSet *, int, AstPointSet *, int * );
 static const char *CvtString( int, const char **, int *, int *, const char *[ MAX_ARGS ], int **order, int * );
+static const LeapEntry *LeapTable( int *, int * );
+static void AddRcc( int, double *, const double *, double, const LeapEntry *, int, int *, int * );
+static double Dat( const LeapEntry *, int, double, int, int * );
 static double Gmsta( double, double, int, int * );
 static double Rate( AstMapping *, double *, int, int, int * );
 static double Rcc( double, double, double, double, double, int * );
@@ -1336,392 +1429,321 @@ double astDat_( double in, int forward, int *status ){
 *     within a leap second.  Though in most cases UTC can include the
 *     fractional part, correct behaviour on the day of a leap second
 *     can only be guaranteed up to the end of the second 23:59:59.
-*     - For epochs from 1961 January 1 onwards, the expressions from the
-*     file ftp://maia.usno.navy.mil/ser7/tai-utc.dat are used.
-*     - The 5ms time step at 1961 January 1 is taken from 2.58.1 (p87) of
-*     the 1992 Explanatory Supplement.
+*     - The values are obtained from the table of leap seconds returned
+*     by LeapTable (see that function for details).
 *     - UTC began at 1960 January 1.0 (JD 2436934.5) and it is improper
 *     to call the routine with an earlier epoch.  However, if this
 *     is attempted, the TAI-UTC expression for the year 1960 is used.
 
 *  Implementation Details:
 *     - This function is based on SLA_DAT by P.T.Wallace.
-*     - This routine must be updated on each occasion that a leap second is
-*     announced
-*     - Latest leap second:  2017 January 1
 
 *-
 */
 
 /* Local Variables: */
-   double result;
+   const LeapEntry *table;       /* Table of leap seconds */
+   int ntable;                   /* Number of entries in table */
 
 /* Initialise the returned value. */
    if( in == AST__BAD ) return AST__BAD;
 
-/* First do TAI-UTC at a given UTC
-   ------------------------------- */
-   if( forward ) {
-
-/* 2017 January 1 */
-      if ( in >= 57754.0 ) {
-         result = 37.0;
-
-/* 2015 July 1 */
-      } else if ( in >= 57204.0 ) {
-         result = 36.0;
-
-/* 2012 July 1 */
-      } else if ( in >= 56109.0 ) {
-         result = 35.0;
-
-/* 2009 January 1 */
-      } else if ( in >= 54832.0 ) {
-         result = 34.0;
-
-/* 2006 January 1 */
-      } else if( in >= 53736.0 ) {
-         result = 33.0;
-
-/* 1999 January 1 */
-      } else if( in >= 51179.0 ){
-         result = 32.0;
-
-/* 1997 July 1 */
-      } else if( in >= 50630.0 ){
-         result = 31.0;
-
-/* 1996 January 1 */
-      } else if( in >= 50083.0 ){
-         result = 30.0;
-
-/* 1994 July 1 */
-      } else if( in >= 49534.0 ){
-         result = 29.0;
-
-/* 1993 July 1 */
-      } else if( in >= 49169.0 ){
-         result = 28.0;
-
-/* 1992 July 1 */
-      } else if( in >= 48804.0 ){
-         result = 27.0;
-
-/* 1991 January 1 */
-      } else if( in >= 48257.0 ){
-         result = 26.0;
-
-/* 1990 January 1 */
-      } else if( in >= 47892.0 ){
-         result = 25.0;
-
-/* 1988 January 1 */
-      } else if( in >= 47161.0 ){
-         result = 24.0;
-
-/* 1985 July 1 */
-      } else if( in >= 46247.0 ){
-         result = 23.0;
-
-/* 1983 July 1 */
-      } else if( in >= 45516.0 ){
-         result = 22.0;
-
-/* 1982 July 1 */
-      } else if( in >= 45151.0 ){
-         result = 21.0;
+/* Get the table of leap seconds, and find the value. */
+   table = LeapTable( &ntable, status );
+   return Dat( table, ntable, in, forward, NULL );
+}
 
-/* 1981 July 1 */
-      } else if( in >= 44786.0 ){
-         result = 20.0;
+static double Dat( const LeapEntry *table, int ntable, double in,
+                   int forward, int *hint ){
+/*
+*  Name:
+*     Dat
 
-/* 1980 January 1 */
-      } else if( in >= 44239.0 ){
-         result = 19.0;
+*  Purpose:
+*     Convert between UTC and TAI using a table of leap seconds.
 
-/* 1979 January 1 */
-      } else if( in >= 43874.0 ){
-         result = 18.0;
+*  Type:
+*     Private function.
 
-/* 1978 January 1 */
-      } else if( in >= 43509.0 ){
-         result = 17.0;
+*  Synopsis:
+*     #include "timemap.h"
+*     double Dat( const LeapEntry *table, int ntable, double in,
+*                 int forward, int *hint )
 
-/* 1977 January 1 */
-      } else if( in >= 43144.0 ){
-         result = 16.0;
+*  Class Membership:
+*     TimeMap member function
 
-/* 1976 January 1 */
-      } else if( in >= 42778.0 ){
-         result = 15.0;
+*  Description:
+*     This function returns the difference between Coordinated Universal
+*     Time (UTC) and International Atomic Time (TAI), at a given epoch,
+*     as described by the supplied table of leap seconds. The table entry
+*     in which the epoch falls is found by binary search, unless the epoch
+*     falls in the same entry as the previous epoch (as recorded in
+*     "*hint"), which will usually be the case when a series of time
+*     stamps is converted.
 
-/* 1975 January 1 */
-      } else if( in >= 42413.0 ){
-         result = 14.0;
+*  Parameters:
+*     table
+*        Pointer to the table, as returned by LeapTable.
+*     ntable
+*        The number of entries in the table.
+*     in
+*        UTC date or TAI time (as selected by "forward"), as an absolute
+*        MJD. Must not be AST__BAD.
+*     forward
+*        If non-zero, "in" should be a UTC value, and the returned value
+*        is TAI-UTC. If zero, "in" should be a TAI value, and the returned
+*        value is UTC-TAI.
+*     hint
+*        Pointer to an int holding the index of the table entry used on
+*        the previous invocation. It should be initialised to -1 before
+*        the first invocation, and is updated on exit to hold the index
+*        of the entry used. May be NULL.
 
-/* 1974 January 1 */
-      } else if( in >= 42048.0 ){
-         result = 13.0;
+*  Returned Value:
+*     Either UTC-TAI or TAI-UTC (as indicated by "forward") in units of
+*     seconds.
+*/
 
-/* 1973 January 1 */
-      } else if( in >= 41683.0 ){
-         result = 12.0;
+/* Local Variables: */
+   const LeapEntry *entry;       /* Table entry containing the epoch */
+   double result;                /* Returned value */
+   int hi;                       /* Upper limit of binary search */
+   int ihint;                    /* Index of previously used entry */
+   int lo;                       /* Lower limit of binary search */
+   int mid;                      /* Mid point of binary search */
+
+/* Define a macro giving the epoch at which a table entry starts, in the
+   time scale of "in". */
+#define START(i) ( forward ? table[ i ].mjd : table[ i ].tai )
+
+/* See if the epoch falls within the entry used previously. */
+   ihint = hint ? *hint : -1;
+   if( ihint >= 0 && ihint < ntable &&
+       ( ihint == 0 || in >= START( ihint ) ) &&
+       ( ihint == ntable - 1 || in < START( ihint + 1 ) ) ) {
+      lo = ihint;
+
+/* If not, find the last entry which starts at or before the epoch, using
+   a binary search. Epochs before the start of the table use the first
+   entry. */
+   } else {
+      lo = 0;
+      hi = ntable - 1;
+      while( lo < hi ) {
+         mid = ( lo + hi + 1 )/2;
+         if( in >= START( mid ) ) {
+            lo = mid;
+         } else {
+            hi = mid - 1;
+         }
+      }
+      if( hint ) *hint = lo;
+   }
+#undef START
 
-/* 1972 July 1 */
-      } else if( in >= 41499.0 ){
-         result = 11.0;
+/* TAI-UTC at a given UTC is given directly by the linear expression
+   stored in the table entry. */
+   entry = table + lo;
+   if( forward ) {
+      result = entry->dat + ( in - entry->refmjd )*entry->rate;
 
-/* 1972 January 1 */
-      } else if( in >= 41317.0 ){
-         result = 10.0;
+/* UTC-TAI at a given TAI is found by inverting the above expression. */
+   } else {
+      result = -( entry->dat + ( in - entry->refmjd )*entry->rate )/
+                ( 1.0 + entry->rate/SPD );
+   }
 
-/* 1968 February 1 */
-      } else if( in >= 39887.0 ){
-         result = 4.2131700 + ( in - 39126.0 )*0.002592;
+/* Return the result */
+   return result;
+}
 
-/* 1966 January 1 */
-      } else if( in >= 39126.0 ){
-         result = 4.3131700 + ( in - 39126.0 )*0.002592;
+static const LeapEntry *LeapTable( int *ntable, int *status ){
+/*
+*  Name:
+*     LeapTable
 
-/* 1965 September 1 */
-      } else if( in >= 39004.0 ){
-         result = 3.8401300 + ( in - 38761.0 )*0.001296;
+*  Purpose:
+*     Get the table of leap seconds.
 
-/* 1965 July 1 */
-      } else if( in >= 38942.0 ){
-         result = 3.7401300 + ( in - 38761.0 )*0.001296;
+*  Type:
+*     Private function.
 
-/* 1965 March 1 */
-      } else if( in >= 38820.0 ){
-         result = 3.6401300 + ( in - 38761.0 )*0.001296;
+*  Synopsis:
+*     #include "timemap.h"
+*     const LeapEntry *LeapTable( int *ntable, int *status )
 
-/* 1965 January 1 */
-      } else if( in >= 38761.0 ){
-         result = 3.5401300 + ( in - 38761.0 )*0.001296;
+*  Class Membership:
+*     TimeMap member function
 
-/* 1964 September 1 */
-      } else if( in >= 38639.0 ){
-         result = 3.4401300 + ( in - 38761.0 )*0.001296;
+*  Description:
+*     This function returns a pointer to the table describing the value
+*     of TAI-UTC as a function of UTC. Each entry gives the UTC at which
+*     the entry comes into effect, and an expression of the form
+*     "dat + ( MJD - refmjd )*rate" for TAI-UTC (in seconds). Since 1972
+*     "rate" is zero and each entry corresponds to a leap second. The
+*     entries are sorted into increasing order of UTC.
+*
+*     The table is created when this function is first called. If the
+*     environment variable AST_LEAP_SECONDS is defined, it should hold
+*     the path to a text file in the format used by the USNO file
+*     "tai-utc.dat", and the table is read from that file. For instance,
+*     the line describing the leap second of 2017 January 1 is:
+*
+*      2017 JAN  1 =JD 2457754.5  TAI-UTC=  37.0       S + (MJD - 41317.) X 0.0      S
+*
+*     Lines that are not in this format are ignored. If the environment
+*     variable is not defined, a table built into AST is used, which
+*     includes all leap seconds up to 2017 January 1.
 
-/* 1964 April 1 */
-      } else if( in >= 38486.0 ){
-         result = 3.3401300 + ( in - 38761.0 )*0.001296;
+*  Parameters:
+*     ntable
+*        Pointer to an int in which to return the number of entries in
+*        the table.
+*     status
+*        Pointer to the inherited status variable.
 
-/* 1964 January 1 */
-      } else if( in >= 38395.0 ){
-         result = 3.2401300 + ( in - 38761.0 )*0.001296;
+*  Returned Value:
+*     A pointer to the first entry in the table. The table should not be
+*     modified or freed.
 
-/* 1963 November 1 */
-      } else if( in >= 38334.0 ){
-         result = 1.9458580 + ( in - 37665.0 )*0.0011232;
+*  Notes:
+*     - If the file named by AST_LEAP_SECONDS cannot be opened, or does
+*     not contain a valid table, the built-in table is used instead, and
+*     an error is reported on every call to this function (not just the
+*     first). The built-in table is still returned in this case so that
+*     callers can continue if they choose to annul the error.
+*     - The file is read within a private error context, so any error
+*     condition that exists when the table is first needed does not
+*     prevent the file from being read.
+*/
 
-/* 1962 January 1 */
-      } else if( in >= 37665.0 ){
-         result = 1.8458580 + ( in - 37665.0 )*0.0011232;
+/* Local Variables: */
+   AstErrorContext error_context;/* Error context for reading the file */
+   FILE *fd;                     /* File descriptor */
+   LeapEntry *entry;             /* Pointer to new table entry */
+   LeapEntry *new;               /* Pointer to table read from file */
+   char line[ 200 ];             /* Buffer for line read from file */
+   const char *path;             /* Path to leap second file */
+   double dat;                   /* TAI-UTC at the reference MJD */
+   double jd;                    /* Julian date at start of entry */
+   double rate;                  /* Rate of change of TAI-UTC */
+   double refmjd;                /* Reference MJD */
+   int i;                        /* Entry index */
+   int nnew;                     /* Number of entries read from file */
+
+/* Create the table if this has not already been done. */
+   LOCK_MUTEX1
+   if( !leap_table ) {
+
+/* If the AST_LEAP_SECONDS environment variable is defined, attempt to
+   read the table from the file it names. Do this in a new error context
+   so that the file is read even if an error has already been reported.
+   Any failure is recorded in leap_error and leap_errmsg rather than
+   being reported here, so that it can be reported below on each call. */
+      path = getenv( "AST_LEAP_SECONDS" );
+      if( path ) {
+         astErrorBegin( &error_context );
+
+         fd = fopen( path, "r" );
+         if( !fd ) {
+            leap_error = AST__RDERR;
+            sprintf( leap_errmsg, "Cannot open the leap second file "
+                     "\"%.150s\" specified by environment variable "
+                     "AST_LEAP_SECONDS.", path );
+         } else {
 
-/* 1961 August 1 */
-      } else if( in >= 37512.0 ){
-         result = 1.3728180 + ( in - 37300.0 )*0.001296;
+/* Read each line, and extend the table to hold a new entry for each line
+   that has the expected format. The table is permanent, so use permanent
+   memory. */
+            new = NULL;
+            nnew = 0;
+            astBeginPM;
+            while( astOK && !leap_error && fgets( line, sizeof( line ), fd ) ) {
+               if( sscanf( line, "%*d %*s %*d =JD %lf TAI-UTC= %lf S + "
+                           "(MJD - %lf ) X %lf", &jd, &dat, &refmjd,
+                           &rate ) == 4 ) {
+                  new = astGrow( new, nnew + 1, sizeof( LeapEntry ) );
+                  if( astOK ) {
+                     entry = new + nnew;
+                     entry->mjd = jd - 2400000.5;
+                     entry->dat = dat;
+                     entry->refmjd = refmjd;
+                     entry->rate = rate;
+
+/* Check the entries are in increasing order of UTC. */
+                     if( nnew > 0 && entry->mjd <= entry[ -1 ].mjd ) {
+                        leap_error = AST__BADIN;
+                        sprintf( leap_errmsg, "The leap second file "
+                                 "\"%.150s\" specified by environment "
+                                 "variable AST_LEAP_SECONDS is not in "
+                                 "chronological order.", path );
+                     }
+                     nnew++;
+                  }
+               }
+            }
+            astEndPM;
+            fclose( fd );
+
+/* Record an error if no entries were found, or if memory could not be
+   allocated for the table. */
+            if( !astOK && !leap_error ) {
+               leap_error = astStatus;
+               sprintf( leap_errmsg, "Failed to read the leap second file "
+                        "\"%.150s\" specified by environment variable "
+                        "AST_LEAP_SECONDS.", path );
+
+            } else if( !leap_error && nnew == 0 ) {
+               leap_error = AST__BADIN;
+               sprintf( leap_errmsg, "The leap second file \"%.150s\" "
+                        "specified by environment variable AST_LEAP_SECONDS "
+                        "does not contain any entries in the format of the "
+                        "USNO \"tai-utc.dat\" file.", path );
+            }
 
-/* 1961 January 1 */
-      } else if( in >= 37300.0 ){
-         result = 1.4228180 + ( in - 37300.0 )*0.001296;
+/* Use the new table if it is valid. */
+            if( !leap_error ) {
+               leap_table = new;
+               leap_ntable = nnew;
+            } else {
+               astClearStatus;
+               new = astFree( new );
+            }
+         }
 
-/* Before that */
-      } else {
-         result = 1.4178180 + ( in - 37300.0 )*0.001296;
+/* Discard any deferred error messages (the failure is described by
+   leap_errmsg) and end the error context, re-instating any error that
+   existed on entry. */
+         astClearStatus;
+         astErrorEnd( &error_context );
       }
 
-/* Now do UTC-TAI at a given TAI.
-   ------------------------------  */
-   } else {
-
-
-/* 2017 January 1 */
-      if ( in >= 57754.0 + 37.0/SPD ) {
-         result = -37.0;
-
-/* 2015 July 1 */
-      } else if ( in >= 57204.0 + 36.0/SPD ) {
-         result = -36.0;
-
-/* 2012 July 1 */
-      } else if( in >= 56109.0 + 35.0/SPD ) {
-         result = -35.0;
-
-/* 2009 January 1 */
-      } else if( in >= 54832.0 + 34.0/SPD ) {
-         result = -34.0;
-
-/* 2006 January 1 */
-      } else if( in >= 53736.0 + 33.0/SPD ){
-         result = -33.0;
-
-/* 1999 January 1 */
-      } else if( in >= 51179.0 + 32.0/SPD ){
-         result = -32.0;
-
-/* 1997 July 1 */
-      } else if( in >= 50630.0 + 31.0/SPD ){
-         result = -31.0;
-
-/* 1996 January 1 */
-      } else if( in >= 50083.0 + 30.0/SPD ){
-         result = -30.0;
-
-/* 1994 July 1 */
-      } else if( in >= 49534.0 + 29.0/SPD ){
-         result = -29.0;
-
-/* 1993 July 1 */
-      } else if( in >= 49169.0 + 28.0/SPD ){
-         result = -28.0;
-
-/* 1992 July 1 */
-      } else if( in >= 48804.0 + 27.0/SPD ){
-         result = -27.0;
-
-/* 1991 January 1 */
-      } else if( in >= 48257.0 + 26.0/SPD ){
-         result = -26.0;
-
-/* 1990 January 1 */
-      } else if( in >= 47892.0 + 25.0/SPD ){
-         result = -25.0;
+/* Otherwise, use the built-in table. */
+      if( !leap_table ) {
+         leap_table = (LeapEntry *) default_leap_table;
+         leap_ntable = sizeof( default_leap_table )/sizeof( LeapEntry );
+      }
 
-/* 1988 January 1 */
-      } else if( in >= 47161.0 + 24.0/SPD ){
-         result = -24.0;
-
-/* 1985 July 1 */
-      } else if( in >= 46247.0 + 23.0/SPD ){
-         result = -23.0;
-
-/* 1983 July 1 */
-      } else if( in >= 45516.0 + 22.0/SPD ){
-         result = -22.0;
-
-/* 1982 July 1 */
-      } else if( in >= 45151.0 + 21.0/SPD ){
-         result = -21.0;
-
-/* 1981 July 1 */
-      } else if( in >= 44786.0 + 20.0/SPD ){
-         result = -20.0;
-
-/* 1980 January 1 */
-      } else if( in >= 44239.0 + 19.0/SPD ){
-         result = -19.0;
-
-/* 1979 January 1 */
-      } else if( in >= 43874.0 + 18.0/SPD ){
-         result = -18.0;
-
-/* 1978 January 1 */
-      } else if( in >= 43509.0 + 17.0/SPD ){
-         result = -17.0;
-
-/* 1977 January 1 */
-      } else if( in >= 43144.0 + 16.0/SPD ){
-         result = -16.0;
-
-/* 1976 January 1 */
-      } else if( in >= 42778.0 + 15.0/SPD ){
-         result = -15.0;
-
-/* 1975 January 1 */
-      } else if( in >= 42413.0 + 14.0/SPD ){
-         result = -14.0;
-
-/* 1974 January 1 */
-      } else if( in >= 42048.0 + 13.0/SPD ){
-         result = -13.0;
-
-/* 1973 January 1 */
-      } else if( in >= 41683.0 + 12.0/SPD ){
-         result = -12.0;
-
-/* 1972 July 1 */
-      } else if( in >= 41499.0 + 11.0/SPD ){
-         result = -11.0;
-
-/* 1972 January 1 */
-      } else if( in >= 41317.0 + 10.0/SPD ){
-         result = -10.0;
-
-/* 1968 February 1 */
-      } else if( in >= 39887.0 + ( 4.2131700
-                                  + ( 39887.0 - 39126.0 )*0.002592 )/SPD ){
-         result = -( 4.2131700 + ( in - 39126.0 )*0.002592 )/1.02592;
-
-/* 1966 January 1 */
-      } else if( in >= 39126.0 + ( 4.3131700
-                                  + ( 39126.0 - 39126.0 )*0.002592 )/SPD ){
-         result = -( 4.2131700 + ( in - 39126.0 )*0.002592 )/1.02592;
-
-/* 1965 September 1 */
-      } else if( in >= 39004.0 + ( 3.8401300
-                                  + ( 39004.0 - 38761.0 )*0.001296 )/SPD ){
-         result = -( 3.8401300 + ( in - 38761.0 )*0.001296 )/1.001296;
-
-/* 1965 July 1 */
-      } else if( in >= 38942.0 + ( 3.7401300
-                                  + ( 38942.0 - 38761.0 )*0.001296 )/SPD ){
-         result = -( 3.7401300 + ( in - 38761.0 )*0.001296 )/1.01296;
-
-/* 1965 March 1 */
-      } else if( in >= 38820.0 + ( 3.6401300
-                                  + ( 38820.0 - 38761.0 )*0.001296 )/SPD ){
-         result = -( 3.6401300 + ( in - 38761.0 )*0.001296 )/1.001296;
-
-/* 1965 January 1 */
-      } else if( in >= 38761.0 + ( 3.5401300
-                                   + ( 38761.0 - 38761.0 )*0.001296 )/SPD ){
-         result = -( 3.5401300 + ( in - 38761.0 )*0.001296 )/1.001296;
-
-/* 1964 September 1 */
-      } else if( in >= 38639.0 + ( 3.4401300
-                                   + ( 38639.0 - 38761.0 )*0.001296 )/SPD ){
-         result = -( 3.4401300 + ( in - 38761.0 )*0.001296 )/1.001296;
-
-/* 1964 April 1 */
-      } else if( in >= 38486.0 + ( 3.3401300
-                                   + ( 38486.0 - 38761.0 )*0.001296 )/SPD ){
-         result = -( 3.3401300 + ( in - 38761.0 )*0.001296 )/1.001296;
-
-/* 1964 January 1 */
-      } else if( in >= 38395.0 + ( 3.2401300
-                                   + ( 38395.0 - 38761.0 )*0.001296 )/SPD ){
-         result = -( 3.2401300 + ( in - 38761.0 )*0.001296 )/1.001296;
-
-/* 1963 November 1 */
-      } else if( in >= 38334.0 + ( 1.9458580
-                                   + ( 38334.0 - 37665.0 )*0.0011232 )/SPD ){
-         result = -( 1.9458580 + ( in - 37665.0 )*0.0011232 )/1.0011232;
-
-/* 1962 January 1 */
-      } else if( in >= 37665.0 + ( 1.8458580
-                                   + ( 37665.0 - 37665.0 )*0.0011232 )/SPD ){
-         result = -( 1.8458580 + ( in - 37665.0 )*0.0011232 )/1.0011232;
-
-/* 1961 August 1 */
-      } else if( in >= 37512.0 + ( 1.3728180
-                                   + ( 37512.0 - 37300.0 )*0.001296 )/SPD ){
-         result = -( 1.3728180 + ( in - 37300.0 )*0.001296 )/1.001296;
-
-/* 1961 January 1 */
-      } else if( in >= 37300.0 + ( 1.4228180
-                                   + ( 37300.0 - 37300.0 )*0.001296 )/SPD ){
-         result = -( 1.4228180 + ( in - 37300.0 )*0.001296 )/1.001296;
-
-/* Before that */
-      } else {
-         result = -( 1.4178180 + ( in - 37300.0 )*0.001296 )/1.001296;
+/* Store the TAI at which each entry comes into effect. */
+      for( i = 0; i < leap_ntable; i++ ) {
+         entry = leap_table + i;
+         entry->tai = entry->mjd + ( entry->dat + ( entry->mjd -
+                                     entry->refmjd )*entry->rate )/SPD;
       }
    }
+   UNLOCK_MUTEX1
 
-/* Return the result */
-   return result;
+/* If the file could not be used, report an error. This is done on every
+   call, so that the failure is not hidden by any earlier call having
+   annulled the error. */
+   if( leap_error && astOK ) {
+      astError( leap_error, "astDat: %s", status, leap_errmsg );
+   }
+
+/* Return the table. */
+   *ntable = leap_ntable;
+   return leap_table;
 }
 
 static double Gmsta( double in, double off, int forward, int *status ){
@@ -2565,6 +2587,154 @@ static double Rate( AstMapping *this, double *at, int ax1, int ax2, int *status
    return result;
 }
 
+static void AddRcc( int npoint, double *time, const double *args,
+                    double sign, const LeapEntry *table, int ntable,
+                    int *hint, int *status ){
+/*
+*  Name:
+*     AddRcc
+
+*  Purpose:
+*     Add or subtract TDB-TT to or from an array of time values.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "timemap.h"
+*     void AddRcc( int npoint, double *time, const double *args,
+*                  double sign, const LeapEntry *table, int ntable,
+*                  int *hint, int *status )
+
+*  Class Membership:
+*     TimeMap member function
+
+*  Description:
+*     This function implements the TTTOTDB and TDBTOTT conversions. It
+*     modifies each supplied time value by adding (or subtracting) the
+*     value of TDB-TT returned by function Rcc.
+*
+*     Evaluating Rcc is expensive, and so when a run of consecutive
+*     time values all fall within a short interval (RCC_SPAN days), Rcc
+*     is evaluated only at the start, middle and end of the interval, and
+*     values for each time within the run are found by quadratic
+*     interpolation. The fastest varying significant term in TDB-TT is
+*     the diurnal term, with amplitude 2 microseconds, and so the
+*     interpolation error is below 1E-11 seconds - much smaller than the
+*     uncertainty in the model itself. A run is only used if it contains
+*     at least RCC_MINRUN values and does not span a leap second.
+
+*  Parameters:
+*     npoint
+*        The number of time values.
+*     time
+*        Pointer to the array of time values, as offsets from the MJD
+*        given by "args[0]". Modified on exit.
+*     args
+*        Pointer to the arguments for the conversion (see astTimeAdd).
+*     sign
+*        +1.0 if TDB-TT is to be added to each time value, and -1.0 if it
+*        is to be subtracted.
+*     table
+*        Pointer to the table of leap seconds, as returned by LeapTable.
+*     ntable
+*        The number of entries in the table.
+*     hint
+*        Pointer to an int holding the index of a table entry (see
+*        function Dat).
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Variables: */
+   double f[ 3 ];                /* TDB-TT at start, middle and end of run */
+   double h;                     /* Half the width of the run */
+   double lo;                    /* Lowest time within run */
+   double hi;                    /* Highest time within run */
+   double t;                     /* Normalised offset from middle of run */
+   double utc;                   /* Absolute UTC value (in days) */
+   double x;                     /* Absolute TT or TDB value (in days) */
+   int end;                      /* Index of first point after run */
+   int i;                        /* Node index */
+   int ientry;                   /* Table entry at start of run */
+   int interp;                   /* Use interpolation within run? */
+   int point;                    /* Loop counter for points */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Define a macro that calculates the UTC corresponding to a TT or TDB
+   value "x". For the purpose of estimating TDB-TT, we assume UTC is a
+   good approximation to UT1, and that TT is a good approximation to TDB. */
+#define UTC(x) ( (x) - (TTOFF/SPD) + ( (args[ 4 ] == AST__BAD) \
+               ? Dat( table, ntable, (x) - (TTOFF/SPD), 0, hint ) \
+               : -args[ 4 ] )/SPD )
+
+/* Loop round all points. */
+   point = 0;
+   while( point < npoint ) {
+
+/* Find the run of good time values, starting at the current point, that
+   fall within an interval no wider than RCC_SPAN. */
+      lo = hi = time[ point ];
+      for( end = point; end < npoint; end++ ) {
+         x = time[ end ];
+         if( x == AST__BAD ) break;
+         if( x < lo ) {
+            if( hi - x > RCC_SPAN ) break;
+            lo = x;
+         } else if( x > hi ) {
+            if( x - lo > RCC_SPAN ) break;
+            hi = x;
+         }
+      }
+
+/* If the run is long enough, see if it spans a leap second by comparing
+   the table entries used at the start and end of the run. */
+      interp = 0;
+      if( end - point >= RCC_MINRUN ) {
+         lo += args[ 0 ];
+         hi += args[ 0 ];
+         utc = UTC( lo );
+         ientry = *hint;
+         utc = UTC( hi );
+         interp = ( *hint == ientry );
+      }
+
+/* If not, evaluate TDB-TT at the start, middle and end of the run, and
+   then use quadratic interpolation to get the value at each point in the
+   run. */
+      if( interp ) {
+         h = 0.5*( hi - lo );
+         for( i = 0; i < 3; i++ ) {
+            x = lo + i*h;
+            utc = UTC( x );
+            f[ i ] = Rcc( x, utc, args[ 1 ], args[ 5 ], args[ 6 ], status );
+         }
+
+         for( ; point < end; point++ ) {
+            t = ( h > 0.0 ) ? ( time[ point ] + args[ 0 ] - lo - h )/h : 0.0;
+            time[ point ] += sign*( f[ 1 ] + 0.5*t*( f[ 2 ] - f[ 0 ] ) +
+                             0.5*t*t*( f[ 0 ] + f[ 2 ] - 2.0*f[ 1 ] ) )/SPD;
+         }
+
+/* Otherwise, evaluate TDB-TT for each good point in the run, and skip
+   over the following bad point (if any). */
+      } else {
+         if( end == point ) end++;
+         for( ; point < end; point++ ) {
+            if( time[ point ] != AST__BAD ) {
+               x = time[ point ] + args[ 0 ];
+               utc = UTC( x );
+               time[ point ] += sign*Rcc( x, utc, args[ 1 ], args[ 5 ],
+                                          args[ 6 ], status )/SPD;
+            }
+         }
+      }
+   }
+#undef UTC
+}
+
 static double Rcc( double tdb, double ut1, double wl, double u, double v, int *status ){
 /*
 *  Name:
@@ -3688,6 +3858,14 @@ c     - This function does not check to ensure that the sequence of
 f     - This routine does not check to ensure that the sequence of
 *     coordinate conversions added to a TimeMap is physically
 *     meaningful.
+*     - The values of TAI-UTC used by the conversions between TAI and UTC
+*     are taken from a table of leap seconds built into AST, which
+*     includes all leap seconds up to 2017 January 1. A different table
+*     may be used by setting the environment variable AST_LEAP_SECONDS
+*     to the path of a text file in the format of the USNO file
+*     "tai-utc.dat". This allows new leap seconds to be used without
+*     re-building AST. The file is read when the first leap second is
+*     needed.
 
 *  Available Conversions:
 *     The following strings (which are case-insensitive) may be supplied
@@ -3840,20 +4018,20 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
 /* Local Variables: */
    AstPointSet *result;          /* Pointer to output PointSet */
    AstTimeMap *map;              /* Pointer to TimeMap to be applied */
+   const LeapEntry *table;       /* Table of leap seconds */
    double **ptr_in;              /* Pointer to input coordinate data */
    double **ptr_out;             /* Pointer to output coordinate data */
    double *args;                 /* Pointer to argument list for conversion */
    double *time;                 /* Pointer to output time axis value array */
    double gmstx;                 /* GMST offset (in days) */
-   double tai;                   /* Absolute TAI value (in days) */
    double tdb;                   /* Absolute TDB value (in days) */
-   double tt;                    /* Absolute TT value (in days) */
-   double utc;                   /* Absolute UTC value (in days) */
    int ct;                       /* Conversion type */
    int cvt;                      /* Loop counter for conversions */
    int end;                      /* Termination index for conversion loop */
+   int hint;                     /* Index of most recently used leap second */
    int inc;                      /* Increment for conversion loop */
    int npoint;                   /* Number of points */
+   int ntable;                   /* Number of entries in leap second table */
    int point;                    /* Loop counter for points */
    int start;                    /* Starting index for conversion loop */
 
@@ -3895,6 +4073,12 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
          (void) memcpy( time, ptr_in[ 0 ], sizeof( double ) * (size_t) npoint );
       }
 
+/* Get the table of leap seconds. The index of the table entry used for
+   the previous time value is remembered in "hint", since consecutive time
+   values usually lie between the same pair of leap seconds. */
+      table = LeapTable( &ntable, status );
+      hint = -1;
+
 /* We will loop to apply each time coordinate conversion in turn to the
    (time) array. However, if the inverse transformation was requested,
    we must loop through these transformations in reverse order, so set up
@@ -4045,7 +4229,8 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
                   for ( point = 0; point < npoint; point++ ) {
                      if ( time[ point ] != AST__BAD ) {
                         time[ point ] += ( (args[ 1 ] == AST__BAD)
-                            ? astDat( time[ point ] + args[ 0 ], 0 )
+                            ? Dat( table, ntable, time[ point ] + args[ 0 ],
+                                   0, &hint )
                             : - args[ 1 ] )/SPD;
                      }
                   }
@@ -4053,7 +4238,8 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
                   for ( point = 0; point < npoint; point++ ) {
                      if ( time[ point ] != AST__BAD ) {
                         time[ point ] += ( (args[ 1 ] == AST__BAD)
-                            ? astDat( time[ point ] + args[ 0 ], 1 )
+                            ? Dat( table, ntable, time[ point ] + args[ 0 ],
+                                   1, &hint )
                             : args[ 1 ] )/SPD;
                      }
                   }
@@ -4067,7 +4253,8 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
                   for ( point = 0; point < npoint; point++ ) {
                      if ( time[ point ] != AST__BAD ) {
                         time[ point ] += ( (args[ 1 ] == AST__BAD)
-                            ? astDat( time[ point ] + args[ 0 ], 1 )
+                            ? Dat( table, ntable, time[ point ] + args[ 0 ],
+                                   1, &hint )
                             : args[ 1 ] )/SPD;
                      }
                   }
@@ -4075,7 +4262,8 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
                   for ( point = 0; point < npoint; point++ ) {
                      if ( time[ point ] != AST__BAD ) {
                         time[ point ] += ( (args[ 1 ] == AST__BAD)
-                            ? astDat( time[ point ] + args[ 0 ], 0 )
+                            ? Dat( table, ntable, time[ point ] + args[ 0 ],
+                                   0, &hint )
                             : - args[ 1 ] )/SPD;
                      }
                   }
@@ -4126,62 +4314,17 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
    cases, but for completeness we handle the difference between TAI and
    UTC (i.e. leap seconds) here. */
             case AST__TTTOTDB:
-               if ( forward ) {
-                  for ( point = 0; point < npoint; point++ ) {
-                     if ( time[ point ] != AST__BAD ) {
-                        tt = time[ point ] + args[ 0 ];
-                        tai = tt - (TTOFF/SPD);
-                        utc = tai + ( (args[ 4 ] == AST__BAD) ? astDat( tai, 0 )
-                                                              : -args[ 4 ] )/SPD;
-                        time[ point ] += Rcc( tt, utc, args[ 1 ], args[ 5 ],
-                                              args[ 6 ], status )/SPD;
-                     }
-                  }
-               } else {
-                  for ( point = 0; point < npoint; point++ ) {
-                     if ( time[ point ] != AST__BAD ) {
-                        tdb = time[ point ] + args[ 0 ];
-                        tai = tdb - (TTOFF/SPD);
-                        utc = tai + ( (args[ 4 ] == AST__BAD) ? astDat( tai, 0 )
-                                                              : -args[ 4 ] )/SPD;
-                        time[ point ] -= Rcc( tdb, utc, args[ 1 ], args[ 5 ],
-                                              args[ 6 ], status )/SPD;
-                     }
-                  }
-               }
+               AddRcc( npoint, time, args, forward ? 1.0 : -1.0, table,
+                       ntable, &hint, status );
                break;
 
 /* TDB to TT. */
 /* ---------- */
-/* For the purpose of estimating TDB-TT, we assume UTC is a good approximation
-   to UT1, and that TT is a good approximation to TDB. In fact, TAI is
-   probably a good enough approximation to UTC for the vast majority of
-   cases, but for completeness we handle the difference between TAI and
-   UTC (i.e. leap seconds) here. */
+/* This is the same as above, but with the forward and inverse cases
+   transposed. */
             case AST__TDBTOTT:
-               if ( forward ) {
-                  for ( point = 0; point < npoint; point++ ) {
-                     if ( time[ point ] != AST__BAD ) {
-                        tdb = time[ point ] + args[ 0 ];
-                        tai = tdb - (TTOFF/SPD);
-                        utc = tai + ( (args[ 4 ] == AST__BAD) ? astDat( tai, 0 )
-                                                              : -args[ 4 ] )/SPD;
-                        time[ point ] -= Rcc( tdb, utc, args[ 1 ], args[ 5 ],
-                                              args[ 6 ], status )/SPD;
-                     }
-                  }
-               } else {
-                  for ( point = 0; point < npoint; point++ ) {
-                     if ( time[ point ] != AST__BAD ) {
-                        tt = time[ point ] + args[ 0 ];
-                        tai = tt - (TTOFF/SPD);
-                        utc = tai + ( (args[ 4 ] == AST__BAD) ? astDat( tai, 0 )
-                                                              : -args[ 4 ] )/SPD;
-                        time[ point ] += Rcc( tt, utc, args[ 1 ], args[ 5 ],
-                                              args[ 6 ], status )/SPD;
-                     }
-                  }
-               }
+               AddRcc( npoint, time, args, forward ? -1.0 : 1.0, table,
+                       ntable, &hint, status );
                break;
 
 /* TT to TCG. */
@@ -391,3 +391,108 @@ struct AstPrjPrm *prj;
    return 0;
 }
 
+
+/*--------------------------------------------------------------------------*/
+
+int astTPNs2x(prj, n, phi, theta, xx, yy, stat)
+
+struct AstPrjPrm *prj;
+const int n;
+const double phi[], theta[];
+double xx[], yy[];
+int stat[];
+
+{
+   double cphi, cthe, r, s, sphi;
+   int i, strict;
+
+   if (abs(prj->flag) != TPN ) {
+      if (astTPNset(prj)) return 1;
+   }
+
+   /* With polynomial corrections, the Newton iteration dominates the
+      cost, so each point is passed to the scalar routine. */
+   if( prj->w[ 0 ] != 0.0 ){
+      for (i = 0; i < n; i++) {
+         if (stat[i]) continue;
+         stat[i] = astTPNfwd(phi[i], theta[i], prj, xx + i, yy + i);
+      }
+
+   /* Simple tan */
+   } else if( prj->n ) {
+      strict = (prj->flag > 0);
+      for (i = 0; i < n; i++) {
+         if (stat[i]) continue;
+
+         astSinCosd(theta[i], &s, &cthe);
+         if (strict && s < 0.0) {
+            stat[i] = 2;
+            continue;
+         }
+         r =  prj->r0*cthe/s;
+         astSinCosd(phi[i], &sphi, &cphi);
+         xx[i] =  r*sphi;
+         yy[i] = -r*cphi;
+      }
+
+   /* Identity */
+   } else {
+      for (i = 0; i < n; i++) {
+         if (stat[i]) continue;
+         xx[i] = phi[i];
+         yy[i] = theta[i];
+      }
+   }
+
+   return 0;
+}
+
+/*--------------------------------------------------------------------------*/
+
+int astTPNx2s(prj, n, x, y, phi, theta, stat)
+
+struct AstPrjPrm *prj;
+const int n;
+const double x[], y[];
+double phi[], theta[];
+int stat[];
+
+{
+   double r;
+   int i;
+
+   if (abs(prj->flag) != TPN ) {
+      if (astTPNset(prj)) return 1;
+   }
+
+   /* Tan with polynomial corrections. */
+   if( prj->w[ 0 ] != 0.0 ){
+      for (i = 0; i < n; i++) {
+         if (stat[i]) continue;
+         stat[i] = astTPNrev(x[i], y[i], prj, phi + i, theta + i);
+      }
+
+   /* Simple tan */
+   } else if( prj->n ) {
+      for (i = 0; i < n; i++) {
+         if (stat[i]) continue;
+         r = sqrt(x[i]*x[i] + y[i]*y[i]);
+         if (r == 0.0) {
+            phi[i] = 0.0;
+         } else {
+            phi[i] = astATan2d(x[i], -y[i]);
+         }
+         theta[i] = astATan2d(prj->r0, r);
+      }
+
+   /* Identity */
+   } else {
+      for (i = 0; i < n; i++) {
+         if (stat[i]) continue;
+         phi[i] = x[i];
+         theta[i] = y[i];
+      }
+   }
+
+   return 0;
+}
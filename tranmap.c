@@ -165,6 +165,7 @@ AstTranMap *astTranMapId_( void *, void *, const char *, ... );
 static AstMapping *RemoveRegions( AstMapping *, int * );
 static AstPointSet *Transform( AstMapping *, AstPointSet *, int, AstPointSet *, int * );
 static double Rate( AstMapping *, double *, int, int, int * );
+static int RateIsExact( AstMapping *, int * );
 static int *MapSplit( AstMapping *, int, const int *, AstMapping **, int * );
 static int Equal( AstObject *, AstObject *, int * );
 static int MapMerge( AstMapping *, int, int, int *, AstMapping ***, int **, int * );
@@ -543,6 +544,7 @@ void astInitTranMapVtab_(  AstTranMapVtab *vtab, const char *name, int *status )
    mapping->Decompose = Decompose;
    mapping->MapMerge = MapMerge;
    mapping->Rate = Rate;
+   mapping->RateIsExact = RateIsExact;
 
 /* Declare the copy constructor, destructor and class dump function. */
    astSetCopy( vtab, Copy );
@@ -1277,6 +1279,55 @@ static double Rate( AstMapping *this, double *at, int ax1, int ax2, int *status
    return result;
 }
 
+static int RateIsExact( AstMapping *this, int *status ) {
+/*
+*  Name:
+*     RateIsExact
+
+*  Purpose:
+*     Check if the astRate method of a Mapping is exact.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "tranmap.h"
+*     int RateIsExact( AstMapping *this, int *status )
+
+*  Class Membership:
+*     TranMap member function (over-rides the protected astRateIsExact
+*     method inherited from the Mapping class).
+
+*  Description:
+*     This function returns a flag indicating if the astRate method of
+*     the supplied Mapping evaluates the rate of change analytically.
+*     A TranMap uses the astRate method of the component Mapping that
+*     defines its forward transformation, and so is exact only if that
+*     component has an exact astRate method.
+
+*  Parameters:
+*     this
+*        Pointer to the Mapping.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Non-zero if the astRate method of the supplied Mapping is exact, and
+*     zero otherwise.
+
+*/
+
+/* Local Variables: */
+   AstTranMap *map;
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* Check the component Mapping used by the Rate method. */
+   map = (AstTranMap *) this;
+   return astRateIsExact( astGetInvert( this ) ? map->map2 : map->map1 );
+}
+
 static AstMapping *RemoveRegions( AstMapping *this_mapping, int *status ) {
 /*
 *  Name:
@@ -231,6 +231,10 @@ f     The WcsMap class does not define any new routines beyond those
 #define MAX(aa,bb) ((aa)>(bb)?(aa):(bb))
 #define MIN(aa,bb) ((aa)<(bb)?(aa):(bb))
 
+/* The number of points passed to the WCSLIB projection functions in
+   each call by the Map function. */
+#define MAP_BLOCK 128
+
 /* Macros to check for equality of floating point values. We cannot
    compare bad values directory because of the danger of floating point
    exceptions, so bad values are dealt with explicitly. */
@@ -652,6 +656,10 @@ typedef struct PrjData {
                                 /* Pointer to forward projection function */
    int (* WcsRev)(double, double, struct AstPrjPrm *, double *, double *);
                                 /* Pointer to reverse projection function */
+   int (* WcsS2x)(struct AstPrjPrm *, int, const double[], const double[], double[], double[], int[]);
+                                /* Pointer to array forward function, or NULL */
+   int (* WcsX2s)(struct AstPrjPrm *, int, const double[], const double[], double[], double[], int[]);
+                                /* Pointer to array reverse function, or NULL */
    double theta0;               /* Default native latitude of fiducial point */
 } PrjData;
 
@@ -667,6 +675,7 @@ static int (* parent_getobjsize)( AstObject *, int * );
 static AstPointSet *(* parent_transform)( AstMapping *, AstPointSet *, int, AstPointSet *, int * );
 static const char *(* parent_getattrib)( AstObject *, const char *, int * );
 static int (* parent_testattrib)( AstObject *, const char *, int * );
+static double (* parent_rate)( AstMapping *, double *, int, int, int * );
 static void (* parent_clearattrib)( AstObject *, const char *, int * );
 static void (* parent_setattrib)( AstObject *, const char *, int * );
 static int *(* parent_mapsplit)( AstMapping *, int, const int *, AstMapping **, int * );
@@ -675,38 +684,38 @@ static int *(* parent_mapsplit)( AstMapping *, int, const int *, AstMapping **,
    projections. The last entry in the list should be for the AST__WCSBAD
    projection. This marks the end of the list. */
 static PrjData PrjInfo[] = {
-   { AST__AZP,  2, 4, "zenithal perspective", "-AZP", astAZPfwd, astAZPrev, AST__DPIBY2 },
-   { AST__SZP,  3, 4, "slant zenithal perspective", "-SZP", astSZPfwd, astSZPrev, AST__DPIBY2 },
-   { AST__TAN,  0, 4, "gnomonic", "-TAN",  astTANfwd, astTANrev, AST__DPIBY2 },
-   { AST__STG,  0, 4, "stereographic", "-STG",  astSTGfwd, astSTGrev, AST__DPIBY2 },
-   { AST__SIN,  2, 4, "orthographic", "-SIN",  astSINfwd, astSINrev, AST__DPIBY2 },
-   { AST__ARC,  0, 4, "zenithal equidistant", "-ARC",  astARCfwd, astARCrev, AST__DPIBY2 },
-   { AST__ZPN,  WCSLIB_MXPAR, 4, "zenithal polynomial", "-ZPN",  astZPNfwd, astZPNrev, AST__DPIBY2 },
-   { AST__ZEA,  0, 4, "zenithal equal area", "-ZEA",  astZEAfwd, astZEArev, AST__DPIBY2 },
-   { AST__AIR,  1, 4, "Airy", "-AIR",  astAIRfwd, astAIRrev, AST__DPIBY2 },
-   { AST__CYP,  2, 4, "cylindrical perspective", "-CYP",  astCYPfwd, astCYPrev, 0.0 },
-   { AST__CEA,  1, 4, "cylindrical equal area", "-CEA",  astCEAfwd, astCEArev, 0.0 },
-   { AST__CAR,  0, 4, "Cartesian", "-CAR",  astCARfwd, astCARrev, 0.0 },
-   { AST__MER,  0, 4, "Mercator", "-MER",  astMERfwd, astMERrev, 0.0 },
-   { AST__SFL,  0, 4, "Sanson-Flamsteed", "-SFL",  astSFLfwd, astSFLrev, 0.0 },
-   { AST__PAR,  0, 4, "parabolic", "-PAR",  astPARfwd, astPARrev, 0.0 },
-   { AST__MOL,  0, 4, "Mollweide", "-MOL",  astMOLfwd, astMOLrev, 0.0 },
-   { AST__AIT,  0, 4, "Hammer-Aitoff", "-AIT",  astAITfwd, astAITrev, 0.0 },
-   { AST__COP,  2, 4, "conical perspective", "-COP",  astCOPfwd, astCOPrev, AST__BAD },
-   { AST__COE,  2, 4, "conical equal area", "-COE",  astCOEfwd, astCOErev, AST__BAD },
-   { AST__COD,  2, 4, "conical equidistant", "-COD",  astCODfwd, astCODrev, AST__BAD },
-   { AST__COO,  2, 4, "conical orthomorphic", "-COO",  astCOOfwd, astCOOrev, AST__BAD },
-   { AST__BON,  1, 4, "Bonne's equal area", "-BON",  astBONfwd, astBONrev, 0.0 },
-   { AST__PCO,  0, 4, "polyconic", "-PCO",  astPCOfwd, astPCOrev, 0.0 },
-   { AST__TSC,  0, 4, "tangential spherical cube", "-TSC",  astTSCfwd, astTSCrev, 0.0 },
-   { AST__CSC,  0, 4, "cobe quadrilateralized spherical cube", "-CSC", astCSCfwd, astCSCrev, 0.0 },
-   { AST__QSC,  0, 4, "quadrilateralized spherical cube", "-QSC",  astQSCfwd, astQSCrev, 0.0 },
-   { AST__NCP,  2, 4, "AIPS north celestial pole", "-NCP",  NULL,   NULL, 0.0 },
-   { AST__GLS,  0, 4, "sinusoidal", "-GLS",  astSFLfwd, astSFLrev, 0.0 },
-   { AST__HPX,  2, 4, "HEALPix", "-HPX",  astHPXfwd, astHPXrev, 0.0 },
-   { AST__XPH,  0, 4, "polar HEALPix", "-XPH",  astXPHfwd, astXPHrev, AST__DPIBY2 },
-   { AST__TPN,  WCSLIB_MXPAR, WCSLIB_MXPAR, "gnomonic polynomial", "-TPN",  astTPNfwd, astTPNrev, AST__DPIBY2 },
-   { AST__WCSBAD, 0, 4, "<null>",   "    ",  NULL,   NULL, 0.0 } };
+   { AST__AZP,  2, 4, "zenithal perspective", "-AZP", astAZPfwd, astAZPrev, NULL, NULL, AST__DPIBY2 },
+   { AST__SZP,  3, 4, "slant zenithal perspective", "-SZP", astSZPfwd, astSZPrev, NULL, NULL, AST__DPIBY2 },
+   { AST__TAN,  0, 4, "gnomonic", "-TAN",  astTANfwd, astTANrev, astTANs2x, astTANx2s, AST__DPIBY2 },
+   { AST__STG,  0, 4, "stereographic", "-STG",  astSTGfwd, astSTGrev, NULL, NULL, AST__DPIBY2 },
+   { AST__SIN,  2, 4, "orthographic", "-SIN",  astSINfwd, astSINrev, astSINs2x, astSINx2s, AST__DPIBY2 },
+   { AST__ARC,  0, 4, "zenithal equidistant", "-ARC",  astARCfwd, astARCrev, astARCs2x, astARCx2s, AST__DPIBY2 },
+   { AST__ZPN,  WCSLIB_MXPAR, 4, "zenithal polynomial", "-ZPN",  astZPNfwd, astZPNrev, astZPNs2x, astZPNx2s, AST__DPIBY2 },
+   { AST__ZEA,  0, 4, "zenithal equal area", "-ZEA",  astZEAfwd, astZEArev, astZEAs2x, astZEAx2s, AST__DPIBY2 },
+   { AST__AIR,  1, 4, "Airy", "-AIR",  astAIRfwd, astAIRrev, NULL, NULL, AST__DPIBY2 },
+   { AST__CYP,  2, 4, "cylindrical perspective", "-CYP",  astCYPfwd, astCYPrev, NULL, NULL, 0.0 },
+   { AST__CEA,  1, 4, "cylindrical equal area", "-CEA",  astCEAfwd, astCEArev, NULL, NULL, 0.0 },
+   { AST__CAR,  0, 4, "Cartesian", "-CAR",  astCARfwd, astCARrev, astCARs2x, astCARx2s, 0.0 },
+   { AST__MER,  0, 4, "Mercator", "-MER",  astMERfwd, astMERrev, NULL, NULL, 0.0 },
+   { AST__SFL,  0, 4, "Sanson-Flamsteed", "-SFL",  astSFLfwd, astSFLrev, NULL, NULL, 0.0 },
+   { AST__PAR,  0, 4, "parabolic", "-PAR",  astPARfwd, astPARrev, NULL, NULL, 0.0 },
+   { AST__MOL,  0, 4, "Mollweide", "-MOL",  astMOLfwd, astMOLrev, NULL, NULL, 0.0 },
+   { AST__AIT,  0, 4, "Hammer-Aitoff", "-AIT",  astAITfwd, astAITrev, astAITs2x, astAITx2s, 0.0 },
+   { AST__COP,  2, 4, "conical perspective", "-COP",  astCOPfwd, astCOPrev, NULL, NULL, AST__BAD },
+   { AST__COE,  2, 4, "conical equal area", "-COE",  astCOEfwd, astCOErev, NULL, NULL, AST__BAD },
+   { AST__COD,  2, 4, "conical equidistant", "-COD",  astCODfwd, astCODrev, NULL, NULL, AST__BAD },
+   { AST__COO,  2, 4, "conical orthomorphic", "-COO",  astCOOfwd, astCOOrev, NULL, NULL, AST__BAD },
+   { AST__BON,  1, 4, "Bonne's equal area", "-BON",  astBONfwd, astBONrev, NULL, NULL, 0.0 },
+   { AST__PCO,  0, 4, "polyconic", "-PCO",  astPCOfwd, astPCOrev, NULL, NULL, 0.0 },
+   { AST__TSC,  0, 4, "tangential spherical cube", "-TSC",  astTSCfwd, astTSCrev, NULL, NULL, 0.0 },
+   { AST__CSC,  0, 4, "cobe quadrilateralized spherical cube", "-CSC", astCSCfwd, astCSCrev, NULL, NULL, 0.0 },
+   { AST__QSC,  0, 4, "quadrilateralized spherical cube", "-QSC",  astQSCfwd, astQSCrev, NULL, NULL, 0.0 },
+   { AST__NCP,  2, 4, "AIPS north celestial pole", "-NCP",  NULL,   NULL, NULL, NULL, 0.0 },
+   { AST__GLS,  0, 4, "sinusoidal", "-GLS",  astSFLfwd, astSFLrev, NULL, NULL, 0.0 },
+   { AST__HPX,  2, 4, "HEALPix", "-HPX",  astHPXfwd, astHPXrev, astHPXs2x, astHPXx2s, 0.0 },
+   { AST__XPH,  0, 4, "polar HEALPix", "-XPH",  astXPHfwd, astXPHrev, NULL, NULL, AST__DPIBY2 },
+   { AST__TPN,  WCSLIB_MXPAR, WCSLIB_MXPAR, "gnomonic polynomial", "-TPN",  astTPNfwd, astTPNrev, astTPNs2x, astTPNx2s, AST__DPIBY2 },
+   { AST__WCSBAD, 0, 4, "<null>",   "    ",  NULL,   NULL, NULL, NULL, 0.0 } };
 
 /* Define macros for accessing each item of thread specific global data. */
 #ifdef THREAD_SAFE
@@ -779,9 +788,12 @@ static int CanSwap( AstMapping *, AstMapping *, int, int, int *, int * );
 static int Equal( AstObject *, AstObject *, int * );
 static int GetNP( AstWcsMap *, int, int * );
 static int IsZenithal( AstWcsMap *, int * );
+static int Jacobian( AstWcsMap *, double, double, double[ 2 ][ 2 ], int * );
 static int LongRange( const PrjData *, struct AstPrjPrm *, double *, double *, int * );
 static int Map( AstWcsMap *, int, int, double *, double *, double *, double *, int * );
 static int MapMerge( AstMapping *, int, int, int *, AstMapping ***, int **, int * );
+static double Rate( AstMapping *, double *, int, int, int * );
+static int RateIsExact( AstMapping *, int * );
 static int TestAttrib( AstObject *, const char *, int * );
 static void ClearAttrib( AstObject *, const char *, int * );
 static void Copy( const AstObject *, AstObject *, int * );
@@ -791,7 +803,9 @@ static void Dump( AstObject *, AstChannel *, int * );
 static void FreePV( AstWcsMap *, int * );
 static void InitPrjPrm( AstWcsMap *, int * );
 static void PermGet( AstPermMap *, int **, int **, double **, int * );
+static void ReportMapStatus( AstWcsMap *, int, int * );
 static void SetAttrib( AstObject *, const char *, int * );
+static void SkyRotate( const double *, double, int, const double *, const double *, double *, double *, int * );
 static void WcsPerm( AstMapping **, int *, int, int * );
 static int *MapSplit( AstMapping *, int, const int *, AstMapping **, int * );
 
@@ -2442,6 +2456,10 @@ void astInitWcsMapVtab_(  AstWcsMapVtab *vtab, const char *name, int *status ) {
    parent_mapsplit = mapping->MapSplit;
    mapping->MapSplit = MapSplit;
 
+   parent_rate = mapping->Rate;
+   mapping->Rate = Rate;
+   mapping->RateIsExact = RateIsExact;
+
 /* Store replacement pointers for methods which will be over-ridden by
    new member functions implemented here. */
    object->Equal = Equal;
@@ -2550,6 +2568,134 @@ static int IsZenithal( AstWcsMap *this, int *status ){
    return ret;
 }
 
+static int Jacobian( AstWcsMap *this, double phi, double theta,
+                     double jac[ 2 ][ 2 ], int *status ){
+/*
+*  Name:
+*     Jacobian
+
+*  Purpose:
+*     Find the Jacobian of a projection at a given sky position.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "wcsmap.h"
+*     int Jacobian( AstWcsMap *this, double phi, double theta,
+*                   double jac[ 2 ][ 2 ], int *status )
+
+*  Class Membership:
+*     WcsMap internal utility function.
+
+*  Description:
+*     This function returns the partial derivatives of the projection
+*     plane coordinates (x,y) with respect to the native spherical
+*     coordinates (phi,theta), at a given native spherical position. It
+*     uses closed-form expressions derived from the WCSLIB projection
+*     functions in "proj.c", and is only available for the TAN, SIN, ARC,
+*     ZEA, CAR, CEA and MER projections. All values are in radians.
+
+*  Parameters:
+*     this
+*        Pointer to the WcsMap.
+*     phi
+*        The native longitude, in radians.
+*     theta
+*        The native latitude, in radians. It should be in the range
+*        [-pi/2,pi/2].
+*     jac
+*        Returned holding the derivatives. jac[0][0] and jac[0][1] are
+*        the derivatives of x with respect to phi and theta, and jac[1][0]
+*        and jac[1][1] are the derivatives of y.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Non-zero if the derivatives were found, and zero if the projection
+*     is not one of those listed above, or if the derivatives are
+*     undefined at the given position.
+
+*/
+
+/* Local Variables: */
+   double *p;                    /* Latitude projection parameters */
+   double cphi;                  /* cos( phi ) */
+   double cthe;                  /* cos( theta ) */
+   double dr;                    /* Derivative of "r" with respect to theta */
+   double r;                     /* Distance from the native pole */
+   double sphi;                  /* sin( phi ) */
+   double sthe;                  /* sin( theta ) */
+   int type;                     /* Projection type */
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* Initialise. */
+   r = 0.0;
+   dr = 0.0;
+
+   type = astGetWcsType( this );
+   p = this->params.p;
+   cphi = cos( phi );
+   sphi = sin( phi );
+   cthe = cos( theta );
+   sthe = sin( theta );
+
+/* The zenithal projections have the form x = r(theta)*sin(phi),
+   y = -r(theta)*cos(phi). Find r and its derivative. */
+   if( type == AST__TAN ) {
+      if( sthe == 0.0 ) return 0;
+      r = cthe/sthe;
+      dr = -1.0/( sthe*sthe );
+
+   } else if( type == AST__ARC ) {
+      r = 0.5*AST__DPI - theta;
+      dr = -1.0;
+
+   } else if( type == AST__ZEA ) {
+      r = 2.0*sin( 0.25*AST__DPI - 0.5*theta );
+      dr = -cos( 0.25*AST__DPI - 0.5*theta );
+
+/* SIN: x = cos(theta)*sin(phi) + xi*( 1 - sin(theta) ),
+        y = -cos(theta)*cos(phi) + eta*( 1 - sin(theta) ),
+   where xi and eta are projection parameters 1 and 2. */
+   } else if( type == AST__SIN ) {
+      jac[ 0 ][ 0 ] = cthe*cphi;
+      jac[ 0 ][ 1 ] = -sthe*sphi - p[ 1 ]*cthe;
+      jac[ 1 ][ 0 ] = cthe*sphi;
+      jac[ 1 ][ 1 ] = sthe*cphi - p[ 2 ]*cthe;
+      return 1;
+
+/* The cylindrical projections have x = phi, and y a function of theta
+   only: y = theta (CAR), y = sin(theta)/lambda (CEA), where lambda is
+   projection parameter 1, and y = ln( tan( pi/4 + theta/2 ) ) (MER). */
+   } else if( type == AST__CAR || type == AST__CEA || type == AST__MER ) {
+      jac[ 0 ][ 0 ] = 1.0;
+      jac[ 0 ][ 1 ] = 0.0;
+      jac[ 1 ][ 0 ] = 0.0;
+      if( type == AST__CAR ) {
+         jac[ 1 ][ 1 ] = 1.0;
+      } else if( type == AST__CEA ) {
+         jac[ 1 ][ 1 ] = cthe/p[ 1 ];
+      } else {
+         if( cthe == 0.0 ) return 0;
+         jac[ 1 ][ 1 ] = 1.0/cthe;
+      }
+      return 1;
+
+   } else {
+      return 0;
+   }
+
+/* Form the Jacobian of a zenithal projection. */
+   jac[ 0 ][ 0 ] = r*cphi;
+   jac[ 0 ][ 1 ] = dr*sphi;
+   jac[ 1 ][ 0 ] = r*sphi;
+   jac[ 1 ][ 1 ] = -dr*cphi;
+   return 1;
+}
+
 static int LongRange( const PrjData *prjdata, struct AstPrjPrm *params,
                        double *high, double *low, int *status ){
 /*
@@ -2707,17 +2853,26 @@ static int Map( AstWcsMap *this, int forward, int npoint, double *in0,
 
 /* Local Variables: */
    const PrjData *prjdata;       /* Information about the projection */
+   double aa[ MAP_BLOCK ];       /* Longitude or X values in degrees */
+   double bb[ MAP_BLOCK ];       /* Latitude or Y values in degrees */
+   double cc[ MAP_BLOCK ];       /* X or longitude values in degrees */
+   double dd[ MAP_BLOCK ];       /* Y or latitude values in degrees */
    double factor;                /* Factor that scales input into radians. */
    double latitude;              /* Latitude value in degrees */
    double longhi;                /* Upper longitude limit in degrees */
    double longitude;             /* Longitude value in degrees */
    double longlo;                /* Lower longitude limit in degrees */
-   double x;                     /* X Cartesian coordinate in degrees */
-   double y;                     /* Y Cartesian coordinate in degrees */
+   int (* kernel)( struct AstPrjPrm *, int, const double[], const double[],
+                   double[], double[], int[] ); /* Array projection function */
    int cyclic;                   /* Is sky->xy transformation cyclic? */
    int i;                        /* Loop count */
+   int j;                        /* Index of point within block */
+   int nblock;                   /* Number of points in current block */
+   int ngood;                    /* Number of good input points in block */
    int plen;                     /* Length of proj par array */
    int point;                    /* Loop counter for points */
+   int start;                    /* Index of first point in block */
+   int stat[ MAP_BLOCK ];        /* Status for each point in block */
    int type;                     /* Projection type */
    int wcs_status;               /* Status from WCSLIB functions */
    struct AstPrjPrm *params;     /* Pointer to structure holding WCSLIB info */
@@ -2759,24 +2914,36 @@ static int Map( AstWcsMap *this, int forward, int npoint, double *in0,
    the factor that scales the WcsMap input into radians. */
    factor = astGetTPNTan( this ) ? 1.0 : AST__DD2R;
 
-/* Loop to apply the projection to each point in turn, checking for
-   (and propagating) bad values in the process. */
-   for ( point = 0; point < npoint; point++ ) {
-       if ( in0[ point ] == AST__BAD ||
-           in1[ point ] == AST__BAD ){
-          out0[ point ] = AST__BAD;
-          out1[ point ] = AST__BAD;
-       } else {
-
-/* First deal with forward projection calls */
-         if ( forward ){
-
-/* The input coordinates are assumed to be longitude and latitude, in
-   radians or degrees (as specified by the TPNTan attribute). Convert them
-   to degrees ensuring that the longitude value is in the range [-180,180]
-   and the latitude is in the range [-90,90] (as required by the WCSLIB
-   library). Any point with a latitude outside the range [-90,90] is
-   converted to the equivalent point on the complementary meridian. */
+/* Some projections have WCSLIB functions that transform an array of
+   points in a single call. Note which one (if any) is to be used. */
+   kernel = forward ? prjdata->WcsS2x : prjdata->WcsX2s;
+
+/* Process the points in blocks. The input values in each block are first
+   converted to degrees, the projection is then applied to the whole
+   block, and finally the results are converted back and stored. A
+   non-zero "stat" value marks a bad input point. */
+   for( start = 0; start < npoint; start += MAP_BLOCK ) {
+      nblock = npoint - start;
+      if( nblock > MAP_BLOCK ) nblock = MAP_BLOCK;
+
+      ngood = 0;
+      for( j = 0; j < nblock; j++ ) {
+         point = start + j;
+         if ( in0[ point ] == AST__BAD ||
+              in1[ point ] == AST__BAD ){
+            stat[ j ] = -1;
+
+/* For forward projections, the input coordinates are assumed to be
+   longitude and latitude, in radians or degrees (as specified by the
+   TPNTan attribute). Convert them to degrees ensuring that the longitude
+   value is in the range [-180,180] and the latitude is in the range
+   [-90,90] (as required by the WCSLIB library). Any point with a latitude
+   outside the range [-90,90] is converted to the equivalent point on the
+   complementary meridian. */
+         } else if ( forward ){
+            stat[ j ] = 0;
+            ngood++;
+
             latitude = AST__DR2D*palDrange(  factor*in1[ point ] );
             if ( latitude > 90.0 ){
                latitude = 180.0 - latitude;
@@ -2790,36 +2957,64 @@ static int Map( AstWcsMap *this, int forward, int npoint, double *in0,
                longitude = AST__DR2D*palDrange( factor*in0[ point ] );
             }
 
-/* Call the relevant WCSLIB forward projection function. */
-            wcs_status = prjdata->WcsFwd( longitude, latitude, params, &x, &y );
+            aa[ j ] = longitude;
+            bb[ j ] = latitude;
 
-/* Store the returned Cartesian coordinates, converting them from degrees
-   to radians. If the position could not be projected, use the value
-   AST__BAD.  Abort for any other bad status. */
-            if( wcs_status == 0 ){
-               out0[ point ] = (AST__DD2R/factor)*x;
-               out1[ point ] = (AST__DD2R/factor)*y;
+/* For reverse projections, convert the supplied Cartesian coordinates
+   from radians to degrees. */
+         } else {
+            stat[ j ] = 0;
+            ngood++;
 
-            } else if( wcs_status == 1 ){
-               return 2;
+            aa[ j ] = (AST__DR2D*factor)*in0[ point ];
+            bb[ j ] = (AST__DR2D*factor)*in1[ point ];
+         }
+      }
 
-            } else if( wcs_status == 2 ){
-               out0[ point ] = AST__BAD;
-               out1[ point ] = AST__BAD;
+/* Call the relevant WCSLIB projection function(s). If an array-oriented
+   function is available, use it to transform the whole block. Otherwise,
+   call the scalar function for each good point. Abort if the projection
+   parameters were unusable. */
+      if( ngood ) {
+         if( kernel ) {
+            if( kernel( params, nblock, aa, bb, cc, dd, stat ) ) return 2;
 
-            } else {
-               return wcs_status;
+         } else {
+            for( j = 0; j < nblock; j++ ) {
+               if( stat[ j ] ) continue;
+               if( forward ) {
+                  wcs_status = prjdata->WcsFwd( aa[ j ], bb[ j ], params,
+                                                cc + j, dd + j );
+               } else {
+                  wcs_status = prjdata->WcsRev( aa[ j ], bb[ j ], params,
+                                                cc + j, dd + j );
+               }
+               if( wcs_status == 1 ) return 2;
+               stat[ j ] = wcs_status;
             }
+         }
+      }
 
-/* Now deal with reverse projection calls */
-         } else {
+/* Store the results, propagating bad input values. */
+      for( j = 0; j < nblock; j++ ) {
+         point = start + j;
+         wcs_status = stat[ j ];
 
-/* Convert the supplied Cartesian coordinates from radians to degrees. */
-            x = (AST__DR2D*factor)*in0[ point ];
-            y = (AST__DR2D*factor)*in1[ point ];
+/* Bad input values, and positions that could not be projected, give
+   AST__BAD output values. */
+         if( wcs_status == -1 || wcs_status == 2 ){
+            out0[ point ] = AST__BAD;
+            out1[ point ] = AST__BAD;
 
-/* Call the relevant WCSLIB reverse projection function. */
-            wcs_status = prjdata->WcsRev( x, y, params, &longitude, &latitude );
+/* Abort if projection parameters were not supplied. */
+         } else if( wcs_status != 0 ){
+            return ( wcs_status == 1 ) ? 2 : wcs_status;
+
+/* Store the returned Cartesian coordinates, converting them from degrees
+   to radians. */
+         } else if( forward ){
+            out0[ point ] = (AST__DD2R/factor)*cc[ j ];
+            out1[ point ] = (AST__DD2R/factor)*dd[ j ];
 
 /* Store the returned longitude and latitude, converting them from degrees
    to radians. Many projections (ARC, AIT, ZPN, etc) are not cyclic (i.e.
@@ -2827,37 +3022,22 @@ static int Map( AstWcsMap *this, int forward, int npoint, double *in0,
    [long,lat]=[360,0] ). Only accept values in the primary longitude or
    latitude ranges. This avoids (x,y) points outside the physical domain
    of the mapping being assigned valid (long,lat) values. */
-            if( wcs_status == 0 ){
-               if( ( cyclic || ( longitude < longhi &&
-                                 longitude >= longlo ) ) &&
-                   fabs( latitude ) <= 90.0 ){
-
-                  out0[ point ] = (AST__DD2R/factor)*longitude;
-                  out1[ point ] = (AST__DD2R/factor)*latitude;
-
-               } else {
-                  out0[ point ] = AST__BAD;
-                  out1[ point ] = AST__BAD;
-               }
+         } else {
+            longitude = cc[ j ];
+            latitude = dd[ j ];
+            if( ( cyclic || ( longitude < longhi &&
+                              longitude >= longlo ) ) &&
+                fabs( latitude ) <= 90.0 ){
 
-/* Abort if projection parameters were unusable. */
-            } else if( wcs_status == 1 ){
-               return 2;
+               out0[ point ] = (AST__DD2R/factor)*longitude;
+               out1[ point ] = (AST__DD2R/factor)*latitude;
 
-/* If the position could not be projected, use the value AST__BAD. */
-            } else if( wcs_status == 2 ){
+            } else {
                out0[ point ] = AST__BAD;
                out1[ point ] = AST__BAD;
-
-/* Abort if projection parameters were not supplied. */
-            } else {
-               return wcs_status;
             }
-
          }
-
       }
-
    }
 
    return 0;
@@ -3662,6 +3842,272 @@ static void PermGet( AstPermMap *map, int **outperm, int **inperm,
    return;
 }
 
+static double Rate( AstMapping *this, double *at, int ax1, int ax2, int *status ){
+/*
+*  Name:
+*     Rate
+
+*  Purpose:
+*     Calculate the rate of change of a Mapping output.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "wcsmap.h"
+*     result = Rate( AstMapping *this, double *at, int ax1, int ax2, int *status )
+
+*  Class Membership:
+*     WcsMap member function (overrides the astRate method inherited
+*     from the Mapping class ).
+
+*  Description:
+*     This function returns the rate of change of a specified output of
+*     the supplied Mapping with respect to a specified input, at a
+*     specified input position. For the TAN, SIN, ARC, ZEA, CAR, CEA and
+*     MER projections the rate is found analytically. The rates of the
+*     inverse projection are found by inverting the Jacobian of the
+*     forward projection at the transformed position. The numerical
+*     estimate provided by the parent class is returned for all other
+*     projections, and at positions where the Jacobian is singular (such
+*     as the native pole of a zenithal projection).
+
+*  Parameters:
+*     this
+*        Pointer to the Mapping to be applied.
+*     at
+*        The address of an array holding the axis values at the position
+*        at which the rate of change is to be evaluated. The number of
+*        elements in this array should equal the number of inputs to the
+*        Mapping.
+*     ax1
+*        The index of the Mapping output for which the rate of change is to
+*        be found (output numbering starts at 0 for the first output).
+*     ax2
+*        The index of the Mapping input which is to be varied in order to
+*        find the rate of change (input numbering starts at 0 for the first
+*        input).
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The rate of change of Mapping output "ax1" with respect to input
+*     "ax2", evaluated at "at", or AST__BAD if the value cannot be
+*     calculated.
+
+*/
+
+/* Local Variables: */
+   AstWcsMap *map;               /* Pointer to the WcsMap */
+   double det;                   /* Determinant of the Jacobian */
+   double factor;                /* Factor that scales values into radians */
+   double in0;                   /* Input longitude or X value */
+   double in1;                   /* Input latitude or Y value */
+   double jac[ 2 ][ 2 ];         /* Jacobian of the forward projection */
+   double out0;                  /* Output X or longitude value */
+   double out1;                  /* Output Y or latitude value */
+   double phi;                   /* Native longitude */
+   double result;                /* Returned rate */
+   double theta;                 /* Native latitude */
+   int forward;                  /* Apply the forward projection? */
+   int i1;                       /* Jacobian row for the output */
+   int i2;                       /* Jacobian column for the input */
+   int latax;                    /* Index of latitude axis */
+   int lonax;                    /* Index of longitude axis */
+
+/* Check inherited status */
+   if( !astOK ) return AST__BAD;
+
+/* Use the numerical estimate if the rates cannot be found analytically. */
+   if( !astRateIsExact( this ) ) return (*parent_rate)( this, at, ax1, ax2,
+                                                         status );
+
+/* Initialise. */
+   result = AST__BAD;
+   map = (AstWcsMap *) this;
+
+/* Axes other than the longitude and latitude axes are copied from input
+   to output. */
+   lonax = astGetWcsAxis( map, 0 );
+   latax = astGetWcsAxis( map, 1 );
+   if( ( ax1 != lonax && ax1 != latax ) || ( ax2 != lonax && ax2 != latax ) ) {
+      if( at[ ax2 ] != AST__BAD ) result = ( ax1 == ax2 ) ? 1.0 : 0.0;
+      return result;
+   }
+
+/* Transform the position, so that the native spherical coordinates are
+   known in either direction. Use the numerical estimate (which will
+   report an error) if the projection cannot be applied. */
+   if( at[ lonax ] == AST__BAD || at[ latax ] == AST__BAD ) return result;
+   forward = !astGetInvert( map );
+   in0 = at[ lonax ];
+   in1 = at[ latax ];
+   if( Map( map, forward, 1, &in0, &in1, &out0, &out1, status ) ) {
+      return (*parent_rate)( this, at, ax1, ax2, status );
+   }
+   if( out0 == AST__BAD || out1 == AST__BAD ) return result;
+
+/* WcsMap values are normally in radians, but are in degrees if the
+   TPNTan attribute has been cleared (see Map). Since input and output
+   values are scaled by the same factor, the rate is the rate between
+   radian values. */
+   factor = astGetTPNTan( map ) ? 1.0 : AST__DD2R;
+   if( forward ) {
+      phi = factor*in0;
+      theta = palDrange( factor*in1 );
+   } else {
+      phi = factor*out0;
+      theta = palDrange( factor*out1 );
+   }
+
+/* Latitudes outside [-pi/2,pi/2] are moved onto the complementary
+   meridian by Map, which changes the sign of the rates. Use the numerical
+   estimate for these, and if the Jacobian is undefined. */
+   if( fabs( theta ) > 0.5*AST__DPI ||
+       !Jacobian( map, phi, theta, jac, status ) ) {
+      return (*parent_rate)( this, at, ax1, ax2, status );
+   }
+
+/* Select the required element of the Jacobian, or of its inverse. */
+   i1 = ( ax1 == lonax ) ? 0 : 1;
+   i2 = ( ax2 == lonax ) ? 0 : 1;
+   if( forward ) {
+      result = jac[ i1 ][ i2 ];
+   } else {
+      det = jac[ 0 ][ 0 ]*jac[ 1 ][ 1 ] - jac[ 0 ][ 1 ]*jac[ 1 ][ 0 ];
+      if( det == 0.0 ) return (*parent_rate)( this, at, ax1, ax2, status );
+      if( i1 == i2 ) {
+         result = jac[ 1 - i1 ][ 1 - i2 ]/det;
+      } else {
+         result = -jac[ i1 ][ i2 ]/det;
+      }
+   }
+
+/* Return the result. */
+   return result;
+}
+
+static int RateIsExact( AstMapping *this, int *status ) {
+/*
+*  Name:
+*     RateIsExact
+
+*  Purpose:
+*     Check if the astRate method of a Mapping is exact.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "wcsmap.h"
+*     int RateIsExact( AstMapping *this, int *status )
+
+*  Class Membership:
+*     WcsMap member function (over-rides the protected astRateIsExact
+*     method inherited from the Mapping class).
+
+*  Description:
+*     This function returns a flag indicating if the astRate method of
+*     the supplied Mapping evaluates the rate of change analytically.
+*     This is the case for the TAN, SIN, ARC, ZEA, CAR, CEA and MER
+*     projections, except at singular points, which are ignored here.
+
+*  Parameters:
+*     this
+*        Pointer to the Mapping.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Non-zero if the astRate method of the supplied Mapping is exact, and
+*     zero otherwise.
+
+*/
+
+/* Local Variables: */
+   int type;                     /* Projection type */
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* Only some projections have analytic rates. */
+   type = astGetWcsType( (AstWcsMap *) this );
+   return ( type == AST__TAN || type == AST__SIN || type == AST__ARC ||
+            type == AST__ZEA || type == AST__CAR || type == AST__CEA ||
+            type == AST__MER );
+}
+
+static void ReportMapStatus( AstWcsMap *this, int status_value,
+                             int *status ){
+/*
+*  Name:
+*     ReportMapStatus
+
+*  Purpose:
+*     Report an error for a status value returned by the Map function.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "wcsmap.h"
+*     void ReportMapStatus( AstWcsMap *this, int status_value, int *status )
+
+*  Class Membership:
+*     WcsMap member function
+
+*  Description:
+*     This function reports an error describing a non-zero status value
+*     returned by the Map function.
+
+*  Parameters:
+*     this
+*        Pointer to the WcsMap.
+*     status_value
+*        The status value returned by Map.
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Variables: */
+   int latax;                    /* Latitude axis index */
+   int lonax;                    /* Longitude axis index */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Get the indices of the longitude and latitude axes. */
+   lonax = astGetWcsAxis( this, 0 );
+   latax = astGetWcsAxis( this, 1 );
+
+/* Report an error if the projection type was unrecognised. */
+   if ( status_value == 1 ) {
+      astError( AST__WCSTY, "astTransform(%s): The %s specifies an "
+                "illegal projection type ('%s').", status, astClass( this ),
+                astClass( this ), FindPrjData( this->type, status )->desc  );
+
+/* Report an error if the projection parameters were invalid. */
+   } else if ( status_value == 2 ) {
+      astError( AST__WCSPA, "astTransform(%s): The %s projection "
+                "parameter values in this %s are unusable.", status,
+                astClass( this ), FindPrjData( this->type, status )->desc,
+                astClass( this )  );
+
+/* Report an error if required projection parameters were not supplied. */
+   } else if ( status_value >= 400 ) {
+      astError( AST__WCSPA, "astTransform(%s): Required projection "
+                "parameter PV%d_%d was not supplied for a %s "
+                "projection.", status, astClass( this ), latax+1, status_value - 400,
+                FindPrjData( this->type, status )->desc  );
+
+   } else if ( status_value >= 100 ) {
+      astError( AST__WCSPA, "astTransform(%s): Required projection "
+                "parameter PV%d_%d was not supplied for a %s "
+                "projection.", status, astClass( this ), lonax+1, status_value - 100,
+                FindPrjData( this->type, status )->desc  );
+   }
+}
+
 static void SetAttrib( AstObject *this_object, const char *setting, int *status ) {
 /*
 *  Name:
@@ -3929,6 +4375,124 @@ static void SetTPNTan( AstWcsMap *this, int val, int *status ) {
    InitPrjPrm( this, status );
 }
 
+static void SkyRotate( const double *matrix, double polarlong, int npoint,
+                       const double *in0, const double *in1, double *out0,
+                       double *out1, int *status ){
+/*
+*  Name:
+*     SkyRotate
+
+*  Purpose:
+*     Rotate a set of spherical positions.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "wcsmap.h"
+*     void SkyRotate( const double *matrix, double polarlong, int npoint,
+*                     const double *in0, const double *in1, double *out0,
+*                     double *out1, int *status )
+
+*  Class Membership:
+*     WcsMap member function
+
+*  Description:
+*     This function transforms a set of spherical (longitude,latitude)
+*     positions in the same way as an inverted SphMap, followed by a
+*     3x3 MatrixMap, followed by a SphMap. The arithmetic (including the
+*     handling of bad values and poles) is identical to that of the
+*     Transform functions of those classes, but each Cartesian vector is
+*     held in local variables rather than being stored in a PointSet.
+
+*  Parameters:
+*     matrix
+*        Pointer to the 9 elements of the rotation matrix, in row order.
+*     polarlong
+*        The PolarLong attribute of the final SphMap.
+*     npoint
+*        The number of points to transform.
+*     in0
+*        The input longitude values, in radians.
+*     in1
+*        The input latitude values, in radians.
+*     out0
+*        Returned holding the output longitude values, in radians.
+*     out1
+*        Returned holding the output latitude values, in radians.
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Variables: */
+   const double *row;            /* Pointer to current matrix row */
+   double mxerr;                 /* Largest value which is effectively zero */
+   double sum;                   /* Partial output value */
+   double v[ 3 ];                /* Cartesian vector before rotation */
+   double w[ 3 ];                /* Cartesian vector after rotation */
+   int in_coord;                 /* Index of input Cartesian axis */
+   int out_coord;                /* Index of output Cartesian axis */
+   int point;                    /* Loop counter for points */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Loop round every point. */
+   for( point = 0; point < npoint; point++ ){
+
+/* Convert the spherical position to a Cartesian unit vector. */
+      if( in0[ point ] != AST__BAD && in1[ point ] != AST__BAD ){
+         palDcs2c( in0[ point ], in1[ point ], v );
+      } else {
+         v[ 0 ] = AST__BAD;
+         v[ 1 ] = AST__BAD;
+         v[ 2 ] = AST__BAD;
+      }
+
+/* Multiply it by the matrix. A bad input value gives a bad output value
+   unless the corresponding matrix element is zero. */
+      row = matrix;
+      for( out_coord = 0; out_coord < 3; out_coord++ ) {
+         sum = 0.0;
+         for( in_coord = 0; in_coord < 3; in_coord++ ) {
+            if( ( v[ in_coord ] == AST__BAD && row[ in_coord ] != 0.0 ) ||
+                row[ in_coord ] == AST__BAD ) {
+               sum = AST__BAD;
+               break;
+            } else if( v[ in_coord ] != AST__BAD ) {
+               sum += v[ in_coord ]*row[ in_coord ];
+            }
+         }
+         w[ out_coord ] = sum;
+         row += 3;
+      }
+
+/* Convert the rotated vector back to spherical coordinates. At either
+   pole, return the longitude given by "polarlong". */
+      if( w[ 0 ] != AST__BAD && w[ 1 ] != AST__BAD && w[ 2 ] != AST__BAD ){
+         mxerr = fabs( 1000.0*w[ 2 ] )*DBL_EPSILON;
+         if( fabs( w[ 0 ] ) < mxerr && fabs( w[ 1 ] ) < mxerr ) {
+            if( w[ 2 ] < 0.0 ) {
+               out0[ point ] = polarlong;
+               out1[ point ] = -AST__DPIBY2;
+            } else if( w[ 2 ] > 0.0 ) {
+               out0[ point ] = polarlong;
+               out1[ point ] = AST__DPIBY2;
+            } else {
+               out0[ point ] = AST__BAD;
+               out1[ point ] = AST__BAD;
+            }
+         } else {
+            palDcc2s( w, out0 + point, out1 + point );
+         }
+
+      } else {
+         out0[ point ] = AST__BAD;
+         out1[ point ] = AST__BAD;
+      }
+   }
+}
+
 static int TestAttrib( AstObject *this_object, const char *attrib, int *status ) {
 /*
 *  Name:
@@ -4204,32 +4768,8 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
       status_value = Map( map, forward, npoint, ptr_in[ lonax ], ptr_in[ latax ],
                           ptr_out[ lonax ], ptr_out[ latax ], status );
 
-/* Report an error if the projection type was unrecognised. */
-      if ( status_value == 1 ) {
-         astError( AST__WCSTY, "astTransform(%s): The %s specifies an "
-                   "illegal projection type ('%s').", status, astClass( this ),
-                   astClass( this ), FindPrjData( map->type, status )->desc  );
-
-/* Report an error if the projection parameters were invalid. */
-       } else if ( status_value == 2 ) {
-          astError( AST__WCSPA, "astTransform(%s): The %s projection "
-                    "parameter values in this %s are unusable.", status,
-                    astClass( this ), FindPrjData( map->type, status )->desc,
-                    astClass( this )  );
-
-/* Report an error if required projection parameters were not supplied. */
-       } else if ( status_value >= 400 ) {
-          astError( AST__WCSPA, "astTransform(%s): Required projection "
-                    "parameter PV%d_%d was not supplied for a %s "
-                    "projection.", status, astClass( this ), latax+1, status_value - 400,
-                    FindPrjData( map->type, status )->desc  );
-
-       } else if ( status_value >= 100 ) {
-          astError( AST__WCSPA, "astTransform(%s): Required projection "
-                    "parameter PV%d_%d was not supplied for a %s "
-                    "projection.", status, astClass( this ), lonax+1, status_value - 100,
-                    FindPrjData( map->type, status )->desc  );
-       }
+/* Report an error if the projection failed. */
+      if( status_value ) ReportMapStatus( map, status_value, status );
 
 /* Copy the remaining axes (i.e. all axes except the longitude and latitude
    axes) from the input to the output. */
@@ -4408,6 +4948,130 @@ const char *astWcsPrjDesc_( int type, int *status ){
    return data->desc;
 }
 
+void astWcsSkyRot_( AstWcsMap *this, int forward, const double *matrix,
+                    double polarlong, AstPointSet *in, AstPointSet *out,
+                    int *status ){
+/*
+*+
+*  Name:
+*     astWcsSkyRot
+
+*  Purpose:
+*     Apply a WcsMap combined with a rotation of the sky.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "wcsmap.h"
+*     void astWcsSkyRot( AstWcsMap *this, int forward, const double *matrix,
+*                        double polarlong, AstPointSet *in, AstPointSet *out )
+
+*  Class Membership:
+*     WcsMap protected function
+
+*  Description:
+*     This function transforms a set of points using a two-dimensional
+*     WcsMap combined with a rotation of the celestial sphere. The rotation
+*     is the one described by an inverted SphMap, followed by a 3x3
+*     MatrixMap, followed by a SphMap, which is how celestial coordinate
+*     rotations are represented within Mappings created by the FitsChan
+*     class.
+*
+*     If the WcsMap is used to de-project (i.e. to go from (x,y) to
+*     native spherical coordinates), the rotation is applied after the
+*     WcsMap. If the WcsMap is used to project (i.e. to go from native
+*     spherical coordinates to (x,y)), the rotation is applied before the
+*     WcsMap. The points are processed in small blocks so that the
+*     intermediate values remain in cache, and no intermediate PointSets
+*     are needed. The results are identical to those produced by
+*     applying the individual Mappings in turn.
+
+*  Parameters:
+*     this
+*        Pointer to the WcsMap. It must have two axes.
+*     forward
+*        A non-zero value indicates that the forward transformation of the
+*        WcsMap should be used. A zero value requests the inverse
+*        transformation. As with astTransform, the WcsMap's Invert
+*        attribute is taken into account.
+*     matrix
+*        Pointer to the 9 elements (in row order) of the matrix used to
+*        rotate the Cartesian vectors.
+*     polarlong
+*        The longitude (in radians) to return for positions at either pole
+*        of the rotated coordinate system (the PolarLong attribute of the
+*        final SphMap).
+*     in
+*        Pointer to the PointSet holding the input coordinate data.
+*     out
+*        Pointer to the PointSet which is to receive the transformed
+*        coordinate data. It may be the same as "in".
+*-
+*/
+
+/* Local Variables: */
+   double **ptr_in;              /* Pointer to input coordinate data */
+   double **ptr_out;             /* Pointer to output coordinate data */
+   double sph[ 2 ][ MAP_BLOCK ]; /* Spherical coordinates for one block */
+   int latax;                    /* Latitude axis index */
+   int lonax;                    /* Longitude axis index */
+   int nblock;                   /* Number of points in current block */
+   int npoint;                   /* Number of points */
+   int start;                    /* Index of first point in block */
+   int status_value;             /* Status from Map function */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Get the number of points, and pointers to the coordinate data. */
+   npoint = astGetNpoint( in );
+   ptr_in = astGetPoints( in );
+   ptr_out = astGetPoints( out );
+
+/* Determine whether to apply the forward or inverse mapping, according to
+   the direction specified and whether the mapping has been inverted. */
+   if ( astGetInvert( this ) ) forward = !forward;
+
+/* Get the indices of the longitude and latitude axes. */
+   lonax = astGetWcsAxis( this, 0 );
+   latax = astGetWcsAxis( this, 1 );
+
+/* Process the points in blocks. The "sph" array holds the spherical
+   coordinates passed between the WcsMap and the rotation, indexed by
+   WcsMap axis. */
+   status_value = 0;
+   for( start = 0; start < npoint && astOK; start += MAP_BLOCK ) {
+      nblock = npoint - start;
+      if( nblock > MAP_BLOCK ) nblock = MAP_BLOCK;
+
+/* Rotate the supplied sky positions, then project them. */
+      if( forward ) {
+         SkyRotate( matrix, polarlong, nblock, ptr_in[ 0 ] + start,
+                    ptr_in[ 1 ] + start, sph[ 0 ], sph[ 1 ], status );
+         status_value = Map( this, 1, nblock, sph[ lonax ], sph[ latax ],
+                             ptr_out[ lonax ] + start,
+                             ptr_out[ latax ] + start, status );
+
+/* De-project the supplied (x,y) positions, then rotate them. */
+      } else {
+         status_value = Map( this, 0, nblock, ptr_in[ lonax ] + start,
+                             ptr_in[ latax ] + start, sph[ lonax ],
+                             sph[ latax ], status );
+         if( !status_value ) {
+            SkyRotate( matrix, polarlong, nblock, sph[ 0 ], sph[ 1 ],
+                       ptr_out[ 0 ] + start, ptr_out[ 1 ] + start, status );
+         }
+      }
+
+/* Report an error if the projection failed. */
+      if( status_value ) {
+         ReportMapStatus( this, status_value, status );
+         break;
+      }
+   }
+}
+
 static void WcsPerm( AstMapping **maps, int *inverts, int iwm, int *status ){
 /*
 *  Name:
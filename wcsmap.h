@@ -116,6 +116,8 @@
 *           Return a textual description for a given projection type.
 *        astWcsPrjType
 *           Return the projection type given a FITS CTYPE keyword value.
+*        astWcsSkyRot
+*           Apply a WcsMap combined with a rotation of the sky.
 
 *  Other Class Functions:
 *     Public:
@@ -472,6 +474,7 @@ void astInitWcsMapGlobals_( AstWcsMapGlobals * );
    int astIsZenithal_( AstWcsMap *, int * );
    void astClearPV_( AstWcsMap *, int, int, int * );
    void astSetPV_( AstWcsMap *, int, int, double, int * );
+   void astWcsSkyRot_( AstWcsMap *, int, const double *, double, AstPointSet *, AstPointSet *, int * );
 
    int astGetFITSProj_( AstWcsMap *, int * );
    int astTestFITSProj_( AstWcsMap *, int * );
@@ -536,6 +539,8 @@ astINVOKE(O,astLoadWcsMap_(mem,size,vtab,name,astCheckChannel(channel),STATUS_PT
 #define astWcsPrjType(ctype) astWcsPrjType_(ctype,STATUS_PTR)
 #define astWcsPrjName(type) astWcsPrjName_(type,STATUS_PTR)
 #define astWcsPrjDesc(type) astWcsPrjDesc_(type,STATUS_PTR)
+#define astWcsSkyRot(this,forward,matrix,polarlong,in,out) \
+astWcsSkyRot_(astCheckWcsMap(this),forward,matrix,polarlong,astCheckPointSet(in),astCheckPointSet(out),STATUS_PTR)
 
 #define astClearPV(this,i,j) \
 astINVOKE(V,astClearPV_(astCheckWcsMap(this),i,j,STATUS_PTR))
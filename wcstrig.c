@@ -33,6 +33,8 @@
 *     -  Support for non-ANSI C "const" class removed
 *     -  Changed names of projection functions and degrees trig functions
 *        to avoid clashes with wcslib.
+*     -  Added astSinCosd, which returns the sine and cosine of an angle
+*        in a single call.
 *=============================================================================
 *
 *   The functions defined herein are trigonometric or inverse trigonometric
@@ -91,6 +93,65 @@ const double angle;
 
 /*--------------------------------------------------------------------------*/
 
+void astSinCosd(angle, s, c)
+
+const double angle;
+double *s, *c;
+
+{
+   double cosine, resid, sine;
+   int cexact, sexact;
+
+   /* The special values below can only arise for angles which are whole
+      numbers of degrees, so skip the checks for any other angle. */
+   if (fabs(angle) < 1.0e15 && angle != floor(angle)) {
+      sine = sin(angle*D2R);
+      cosine = cos(angle*D2R);
+      *s = sine;
+      *c = cosine;
+      return;
+   }
+
+   sexact = 1;
+   resid = fmod(angle-90.0,360.0);
+   if (resid == 0.0) {
+      *s = 1.0;
+   } else if (resid == 90.0) {
+      *s = 0.0;
+   } else if (resid == 180.0) {
+      *s = -1.0;
+   } else if (resid == 270.0) {
+      *s = 0.0;
+   } else {
+      sexact = 0;
+   }
+
+   cexact = 1;
+   resid = fabs(fmod(angle,360.0));
+   if (resid == 0.0) {
+      *c = 1.0;
+   } else if (resid == 90.0) {
+      *c = 0.0;
+   } else if (resid == 180.0) {
+      *c = -1.0;
+   } else if (resid == 270.0) {
+      *c = 0.0;
+   } else {
+      cexact = 0;
+   }
+
+   /* Evaluate both functions together so that the compiler can use a
+      single combined sine/cosine evaluation. */
+   if (!sexact || !cexact) {
+      sine = sin(angle*D2R);
+      cosine = cos(angle*D2R);
+      if (!sexact) *s = sine;
+      if (!cexact) *c = cosine;
+   }
+}
+
+/*--------------------------------------------------------------------------*/
+
 double astTand(angle)
 
 const double angle;
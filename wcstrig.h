@@ -52,6 +52,7 @@ double astACosd(const double);
 double astASind(const double);
 double astATand(const double);
 double astATan2d(const double, const double);
+void astSinCosd(const double, double *, double *);
 
 /* Domain tolerance for asin and acos functions. */
 #define WCSTRIG_TOL 1e-10